@@ -0,0 +1,82 @@
+// SPDX-License-Identifier: Apache-2.0
+//-------------------------------------------------------------------------------
+// Top100 — Your Personal Movie List
+//
+// File: bench/export_render_bench.cpp
+// Purpose: Image export drawing speed against the number of band workers.
+// Language: C++17 (CMake build)
+//
+// Usage: top100_export_render_bench [rounds] [dpi]
+//   Exports the 100-movie grid at the given resolution (default 384 dpi, a
+//   3920-pixel-wide image) with 1, 2, 4 ... hardware threads as the export's
+//   worker pool, which draws the bands and compresses the PNG; the calling
+//   thread comes on top, feeding the encoder and writing the file. Posters are
+//   synthesized by the loopback fixture server and their thumbnails made by
+//   a warm-up export, so the timings are band drawing and PNG encoding.
+//-------------------------------------------------------------------------------
+#include "Movie.h"
+#include "fixture_server.h"
+#include "image_export.h"
+#include "poster_cache.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+int main(int argc, char** argv) {
+    const int rounds = argc > 1 ? std::atoi(argv[1]) : 3;
+    const double dpi = argc > 2 ? std::atof(argv[2]) : 384;
+    if (rounds <= 0 || dpi <= 0) {
+        std::cerr << "Usage: top100_export_render_bench [rounds>0] [dpi>0]\n";
+        return 2;
+    }
+
+    FixtureServer server;
+    if (!server.ok()) {
+        std::cerr << "Fixture server: " << server.error() << "\n";
+        return 1;
+    }
+    auto cache = std::make_shared<PosterCache>(std::string(), PosterCacheOptions());
+    setPosterCache(cache);
+    const auto ids = server.synthesize(100, 300);
+    std::vector<Movie> movies(ids.size());
+    for (size_t i = 0; i < movies.size(); ++i) {
+        movies[i].imdbID = ids[i];
+        movies[i].posterUrl = server.posterUrl(ids[i] + ".png");
+        movies[i].title = "Benchmark Title " + std::to_string(i + 1);
+        movies[i].year = 1950 + static_cast<int>(i % 70);
+    }
+
+    const std::string out = (fs::temp_directory_path() / "top100_export_render_bench.png").string();
+    const size_t hw = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<size_t> threadCounts{1};
+    for (size_t t = 2; t < hw; t *= 2) threadCounts.push_back(t);
+    if (hw > 1) threadCounts.push_back(hw);
+
+    ImageExportOptions opts;
+    opts.dpi = dpi;
+    bool ok = exportTop100Image(movies, out, "Benchmark", opts);   // downloads posters, makes thumbnails
+    std::error_code ec;
+    std::cout << "dpi=" << dpi << " png=" << fs::file_size(out, ec) << " bytes rounds=" << rounds << "\n";
+    double single = 0;
+    for (size_t threads : threadCounts) {
+        opts.threads = threads;
+        ok = exportTop100Image(movies, out, "Benchmark", opts) && ok;   // warm-up
+        const auto t0 = std::chrono::steady_clock::now();
+        for (int r = 0; r < rounds; ++r) ok = exportTop100Image(movies, out, "Benchmark", opts) && ok;
+        const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count() / rounds;
+        if (threads == 1) single = ms;
+        const double speedup = single / ms;
+        std::cout << "workers=" << threads << " (+1 calling): " << ms << " ms/export, speedup " << speedup << "x, efficiency "
+                  << 100.0 * speedup / threads << "%\n";
+    }
+    fs::remove(out, ec);
+    if (!ok) std::cerr << "Export failed\n";
+    return ok ? 0 : 1;
+}
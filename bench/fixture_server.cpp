@@ -0,0 +1,85 @@
+// SPDX-License-Identifier: Apache-2.0
+//-------------------------------------------------------------------------------
+// Top100 — Your Personal Movie List
+//
+// File: bench/fixture_server.cpp
+// Purpose: Stand-alone loopback OMDb / poster / BlueSky / Mastodon server.
+// Language: C++17 (CMake build)
+//
+// Usage: top100_fixture_server [--port N] [--corpus DIR] [--synthesize N]
+//          [--poster-width PX] [--latency MS] [--jitter MS] [--bandwidth BYTES/S]
+//          [--error-rate F] [--error-status CODE] [--rate-limit RPS] [--burst N]
+//          [--daily-limit N] [--omdb-key KEY]
+//   Point the apps at it with TOP100_OMDB_BASE_URL=<url>/ and by using <url>
+//   as the BlueSky service and Mastodon instance. Ctrl+C prints the counters.
+//-------------------------------------------------------------------------------
+#include "fixture_server.h"
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+
+static std::atomic<bool> gStop{false};
+
+static void onSignal(int) {
+    gStop = true;
+}
+
+static int usage() {
+    std::cerr << "Usage: top100_fixture_server [--port N] [--corpus DIR] [--synthesize N] [--poster-width PX]\n"
+                 "         [--latency MS] [--jitter MS] [--bandwidth BYTES/S] [--error-rate F]\n"
+                 "         [--error-status CODE] [--rate-limit RPS] [--burst N] [--daily-limit N] [--omdb-key KEY]\n";
+    return 2;
+}
+
+int main(int argc, char** argv) {
+    FixtureServerOptions opts;
+    std::string corpus;
+    size_t synthetic = 0;
+    int posterWidth = 300;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (i + 1 >= argc) return usage();
+        const char* v = argv[++i];
+        if (arg == "--port") opts.port = static_cast<uint16_t>(std::atoi(v));
+        else if (arg == "--corpus") corpus = v;
+        else if (arg == "--synthesize") synthetic = std::strtoul(v, nullptr, 10);
+        else if (arg == "--poster-width") posterWidth = std::atoi(v);
+        else if (arg == "--latency") opts.faults.latencyMs = std::atoi(v);
+        else if (arg == "--jitter") opts.faults.jitterMs = std::atoi(v);
+        else if (arg == "--bandwidth") opts.faults.bytesPerSecond = std::atof(v);
+        else if (arg == "--error-rate") opts.faults.errorRate = std::atof(v);
+        else if (arg == "--error-status") opts.faults.errorStatus = std::atoi(v);
+        else if (arg == "--rate-limit") opts.faults.rateLimitPerSecond = std::atof(v);
+        else if (arg == "--burst") opts.faults.rateLimitBurst = std::atof(v);
+        else if (arg == "--daily-limit") opts.faults.omdbDailyLimit = std::strtoull(v, nullptr, 10);
+        else if (arg == "--omdb-key") opts.omdbApiKey = v;
+        else return usage();
+    }
+
+    FixtureServer server(opts);
+    if (!server.ok()) {
+        std::cerr << server.error() << "\n";
+        return 1;
+    }
+    size_t loaded = corpus.empty() ? 0 : server.loadCorpus(corpus);
+    if (synthetic > 0) loaded += server.synthesize(synthetic, posterWidth).size();
+    std::cout << "Serving " << loaded << " fixtures at " << server.baseUrl() << "\n"
+              << "  TOP100_OMDB_BASE_URL=" << server.omdbUrl() << "\n"
+              << "  BlueSky service / Mastodon instance: " << server.baseUrl() << " (token "
+              << opts.accessToken << ")\n" << std::flush;
+
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+    while (!gStop) std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    const FixtureStats s = server.stats();
+    std::cout << "\nrequests=" << s.requests << " connections=" << s.connections << " omdb=" << s.omdb
+              << " posters=" << s.posters << " bluesky=" << s.blueSky << " mastodon=" << s.mastodon
+              << " notModified=" << s.notModified << " injectedErrors=" << s.injectedErrors
+              << " rateLimited=" << s.rateLimited << " bytesSent=" << s.bytesSent << "\n";
+    return 0;
+}
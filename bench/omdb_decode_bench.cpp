@@ -0,0 +1,256 @@
+// SPDX-License-Identifier: Apache-2.0
+//-------------------------------------------------------------------------------
+// Top100 — Your Personal Movie List
+//
+// File: bench/omdb_decode_bench.cpp
+// Purpose: Streaming OMDb decoding vs. the DOM + stringstream path it replaced.
+// Language: C++17 (CMake build)
+//
+// Usage: top100_omdb_decode_bench [rounds] [corpus-dir]
+//   Without a directory a synthetic corpus of detail and search responses is
+//   used; with one, every *.json file in it is decoded (recorded responses).
+//-------------------------------------------------------------------------------
+#include "omdb_decode.h"
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <nlohmann/json.hpp>
+#include <random>
+#include <sstream>
+#include <vector>
+
+namespace {
+
+// --- The previous decoding path, kept here as the reference ---
+
+int domYear(const std::string& y) {
+    try { return std::stoi(y.substr(0, 4)); } catch (...) { return 0; }
+}
+
+std::vector<std::string> domSplit(const std::string& s, size_t limit = SIZE_MAX) {
+    std::vector<std::string> out;
+    std::stringstream ss(s);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        size_t start = item.find_first_not_of(" \t\n\r");
+        size_t end = item.find_last_not_of(" \t\n\r");
+        std::string trimmed = (start == std::string::npos) ? std::string() : item.substr(start, end - start + 1);
+        if (!trimmed.empty()) out.push_back(trimmed);
+        if (out.size() >= limit) break;
+    }
+    return out;
+}
+
+bool domDetail(const std::string& body, Movie& m, std::string& plot) {
+    auto j = nlohmann::json::parse(body, nullptr, false);
+    if (j.is_discarded() || !j.is_object() || j.value("Response", "True") == "False") return false;
+    m.title = j.value("Title", "");
+    m.year = domYear(j.value("Year", "0"));
+    m.director = j.value("Director", "");
+    m.imdbID = j.value("imdbID", "");
+    m.actors = domSplit(j.value("Actors", ""), 10);
+    m.genres = domSplit(j.value("Genre", ""));
+    try { m.runtimeMinutes = std::stoi(j.value("Runtime", "0")); } catch (...) { m.runtimeMinutes = 0; }
+    m.countries = domSplit(j.value("Country", ""));
+    m.posterUrl = j.value("Poster", "");
+    const std::string ir = j.value("imdbRating", "0");
+    try { m.imdbRating = ir == "N/A" ? 0.0 : std::stod(ir); } catch (...) { m.imdbRating = 0.0; }
+    const std::string ms = j.value("Metascore", "0");
+    try { m.metascore = ms == "N/A" ? 0 : std::stoi(ms); } catch (...) { m.metascore = 0; }
+    m.rottenTomatoes = 0;
+    if (j.contains("Ratings") && j["Ratings"].is_array()) {
+        for (const auto& r : j["Ratings"]) {
+            if (r.value("Source", "") != "Rotten Tomatoes") continue;
+            const std::string v = r.value("Value", "0%");
+            try { m.rottenTomatoes = v == "N/A" ? 0 : std::stoi(v); } catch (...) { m.rottenTomatoes = 0; }
+            break;
+        }
+    }
+    plot = j.value("Plot", std::string());
+    if (plot == "N/A") plot.clear();
+    return true;
+}
+
+OmdbSearchPage domSearch(const std::string& body) {
+    OmdbSearchPage out;
+    auto j = nlohmann::json::parse(body, nullptr, false);
+    if (j.is_discarded() || !j.contains("Search")) return out;
+    for (const auto& item : j["Search"]) {
+        OmdbSearchResult s;
+        s.title = item.value("Title", "");
+        s.year = domYear(item.value("Year", "0"));
+        s.imdbID = item.value("imdbID", "");
+        s.type = item.value("Type", "");
+        out.results.push_back(std::move(s));
+    }
+    out.totalResults = static_cast<size_t>(std::max(0L, std::strtol(j.value("totalResults", "0").c_str(), nullptr, 10)));
+    return out;
+}
+
+// --- Corpus ---
+
+struct Sample {
+    std::string body;
+    bool search = false;
+};
+
+std::vector<Sample> syntheticCorpus() {
+    static const char* kWords[] = {"Dark", "Night", "Return", "King", "Star", "Lost", "City", "Last", "Blue", "Road"};
+    static const char* kPeople[] = {"Christopher Nolan", "Sofia Coppola", "Akira Kurosawa", "Greta Gerwig",
+                                    "Denis Villeneuve", "Agnes Varda", "Bong Joon Ho", "Kathryn Bigelow"};
+    static const char* kGenres[] = {"Action", "Drama", "Sci-Fi", "Comedy", "Crime", "Thriller", "Romance"};
+    std::mt19937 rng(38);
+    auto pick = [&rng](const auto& arr) { return arr[rng() % (sizeof(arr) / sizeof(arr[0]))]; };
+    auto list = [&](const auto& arr, int n) {
+        std::string s;
+        for (int i = 0; i < n; ++i) s += std::string(i ? ", " : "") + pick(arr);
+        return s;
+    };
+    std::vector<Sample> out;
+    for (int i = 0; i < 400; ++i) {
+        nlohmann::json d;
+        d["Title"] = std::string(pick(kWords)) + " " + pick(kWords);
+        d["Year"] = i % 9 == 0 ? "2005–2007" : std::to_string(1950 + i % 70);
+        d["Rated"] = "PG-13";
+        d["Released"] = "14 Jul 2008";
+        d["Runtime"] = i % 11 == 0 ? "N/A" : std::to_string(80 + i % 90) + " min";
+        d["Genre"] = list(kGenres, 1 + i % 3);
+        d["Director"] = i % 13 == 0 ? "N/A" : pick(kPeople);
+        d["Writer"] = list(kPeople, 2);
+        d["Actors"] = list(kPeople, 3 + i % 12);
+        d["Plot"] = i % 17 == 0 ? "N/A" : std::string(300 + i % 400, 'x');
+        d["Language"] = "English, French";
+        d["Country"] = "United States, United Kingdom";
+        d["Awards"] = "Won 2 Oscars. 159 wins & 163 nominations total";
+        d["Poster"] = "https://m.media-amazon.com/images/M/poster" + std::to_string(i) + ".jpg";
+        d["Ratings"] = nlohmann::json::array(
+            {{{"Source", "Internet Movie Database"}, {"Value", "9.0/10"}},
+             {{"Source", "Rotten Tomatoes"}, {"Value", i % 7 == 0 ? "N/A" : std::to_string(i % 101) + "%"}},
+             {{"Source", "Metacritic"}, {"Value", "84/100"}}});
+        d["Metascore"] = i % 5 == 0 ? "N/A" : std::to_string(i % 101);
+        d["imdbRating"] = i % 5 == 0 ? "N/A" : std::to_string(1 + i % 9) + "." + std::to_string(i % 10);
+        d["imdbVotes"] = "2,345,678";
+        d["imdbID"] = "tt" + std::to_string(1000000 + i);
+        d["Type"] = "movie";
+        d["Response"] = "True";
+        out.push_back({d.dump(), false});
+    }
+    for (int i = 0; i < 100; ++i) {
+        nlohmann::json s;
+        s["Search"] = nlohmann::json::array();
+        for (int k = 0; k < 10; ++k) {
+            s["Search"].push_back({{"Title", std::string(pick(kWords)) + " " + pick(kWords)},
+                                   {"Year", std::to_string(1950 + (i + k) % 70)},
+                                   {"imdbID", "tt" + std::to_string(2000000 + i * 10 + k)},
+                                   {"Type", k % 4 ? "movie" : "series"},
+                                   {"Poster", "https://m.media-amazon.com/images/M/p.jpg"}});
+        }
+        s["totalResults"] = std::to_string(10 + i * 3);
+        s["Response"] = "True";
+        out.push_back({s.dump(), true});
+    }
+    out.push_back({R"({"Response":"False","Error":"Movie not found!"})", false});
+    return out;
+}
+
+std::vector<Sample> recordedCorpus(const std::string& dir) {
+    std::vector<Sample> out;
+    std::error_code ec;
+    for (const auto& e : std::filesystem::directory_iterator(dir, ec)) {
+        if (e.path().extension() != ".json") continue;
+        std::ifstream in(e.path(), std::ios::binary);
+        std::stringstream ss;
+        ss << in.rdbuf();
+        Sample s;
+        s.body = ss.str();
+        s.search = s.body.find("\"Search\"") != std::string::npos;
+        out.push_back(std::move(s));
+    }
+    return out;
+}
+
+bool sameMovie(const Movie& a, const Movie& b) {
+    return a.title == b.title && a.year == b.year && a.director == b.director && a.imdbID == b.imdbID &&
+           a.actors == b.actors && a.genres == b.genres && a.countries == b.countries &&
+           a.runtimeMinutes == b.runtimeMinutes && a.posterUrl == b.posterUrl && a.imdbRating == b.imdbRating &&
+           a.metascore == b.metascore && a.rottenTomatoes == b.rottenTomatoes;
+}
+
+bool samePage(const OmdbSearchPage& a, const OmdbSearchPage& b) {
+    if (a.totalResults != b.totalResults || a.results.size() != b.results.size()) return false;
+    for (size_t i = 0; i < a.results.size(); ++i) {
+        const auto& x = a.results[i];
+        const auto& y = b.results[i];
+        if (x.title != y.title || x.year != y.year || x.imdbID != y.imdbID || x.type != y.type) return false;
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const int rounds = argc > 1 ? std::atoi(argv[1]) : 50;
+    if (rounds <= 0) {
+        std::cerr << "Usage: top100_omdb_decode_bench [rounds>0] [corpus-dir]\n";
+        return 2;
+    }
+    const std::vector<Sample> corpus = argc > 2 ? recordedCorpus(argv[2]) : syntheticCorpus();
+    if (corpus.empty()) {
+        std::cerr << "No *.json responses in " << argv[2] << "\n";
+        return 1;
+    }
+    size_t bytes = 0;
+    for (const auto& s : corpus) bytes += s.body.size();
+
+    // Both paths must agree before their timings mean anything
+    size_t mismatches = 0;
+    for (const auto& s : corpus) {
+        if (s.search) {
+            if (!samePage(domSearch(s.body), omdbDecodeSearch(s.body).page)) ++mismatches;
+            continue;
+        }
+        Movie a;
+        std::string plotA;
+        const bool okA = domDetail(s.body, a, plotA);
+        const OmdbDecodedDetail b = omdbDecodeDetail(s.body);
+        if (okA != (b.response == OmdbResponse::Ok) || (okA && (!sameMovie(a, b.movie) || plotA != b.plot))) {
+            ++mismatches;
+        }
+    }
+
+    using clock = std::chrono::steady_clock;
+    size_t sink = 0;
+    auto t0 = clock::now();
+    for (int r = 0; r < rounds; ++r) {
+        for (const auto& s : corpus) {
+            if (s.search) {
+                sink += domSearch(s.body).results.size();
+            } else {
+                Movie m;
+                std::string plot;
+                sink += domDetail(s.body, m, plot) ? m.actors.size() : 0;
+            }
+        }
+    }
+    const double domMs = std::chrono::duration<double, std::milli>(clock::now() - t0).count();
+
+    t0 = clock::now();
+    for (int r = 0; r < rounds; ++r) {
+        for (const auto& s : corpus) {
+            sink += s.search ? omdbDecodeSearch(s.body).page.results.size() : omdbDecodeDetail(s.body).movie.actors.size();
+        }
+    }
+    const double saxMs = std::chrono::duration<double, std::milli>(clock::now() - t0).count();
+
+    const double n = static_cast<double>(corpus.size()) * rounds;
+    std::cout << "responses=" << corpus.size() << " bytes=" << bytes << " rounds=" << rounds << "\n"
+              << "dom + stringstream: " << domMs * 1e6 / n << " ns/response, "
+              << (bytes * rounds / 1e6) / (domMs / 1e3) << " MB/s\n"
+              << "sax decoder:        " << saxMs * 1e6 / n << " ns/response, "
+              << (bytes * rounds / 1e6) / (saxMs / 1e3) << " MB/s\n"
+              << "speedup: " << domMs / saxMs << "x\n"
+              << "mismatches: " << mismatches << " (checksum " << sink << ")\n";
+    return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,112 @@
+// SPDX-License-Identifier: Apache-2.0
+//-------------------------------------------------------------------------------
+// Top100 — Your Personal Movie List
+//
+// File: bench/png_encode_bench.cpp
+// Purpose: PNG encoding speed and file size per compression level and thread count.
+// Language: C++17 (CMake build)
+//
+// Usage: top100_png_encode_bench [rounds] [dpi]
+//   Encodes an image shaped like the Top 100 export (white background, flat
+//   placeholders, text-like marks and photo-like posters; 20 grid rows) at
+//   the given resolution (default 192 dpi) with PngWriter, at several zlib
+//   levels on one thread and on every hardware thread.
+//-------------------------------------------------------------------------------
+#include "png_writer.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// One grid row of the export: five cells with an index, a poster (or a grey
+// placeholder) and a title, on white, as premultiplied ARGB32
+std::vector<uint32_t> gridRow(int w, int h, double s, unsigned seed) {
+    std::vector<uint32_t> px(static_cast<size_t>(w) * h, 0xFFFFFFFFu);
+    auto fill = [&](double x0, double y0, double x1, double y1, uint32_t c) {
+        for (int y = std::max(0, int(y0 * s)); y < std::min(h, int(y1 * s)); ++y)
+            for (int x = std::max(0, int(x0 * s)); x < std::min(w, int(x1 * s)); ++x) px[size_t(y) * w + x] = c;
+    };
+    for (int c = 0; c < 5; ++c) {
+        const double x0 = 40 + c * 180.0;
+        fill(x0 + 80, 6, x0 + 100, 20, 0xFF000000u);            // "12."
+        if (c == 3) {
+            fill(x0 + 5, 28, x0 + 175, 198, 0xFFE6E6E6u);       // placeholder
+        } else {
+            for (int y = int(28 * s); y < std::min(h, int(198 * s)); ++y)
+                for (int x = int((x0 + 27) * s); x < std::min(w, int((x0 + 153) * s)); ++x) {
+                    seed = seed * 1103515245u + 12345u;
+                    const int noise = static_cast<int>((seed >> 16) & 15);
+                    const auto r = uint32_t(std::clamp(int(128 + 90 * std::sin(x * 0.02 + c)) + noise, 0, 255));
+                    const auto g = uint32_t(std::clamp(int(128 + 90 * std::sin(y * 0.03)) + noise, 0, 255));
+                    const auto b = uint32_t(std::clamp(int(128 + 90 * std::cos((x + y) * 0.01)) + noise, 0, 255));
+                    px[size_t(y) * w + x] = 0xFF000000u | (r << 16) | (g << 8) | b;
+                }
+        }
+        for (double x = x0 + 20; x < x0 + 160; x += 8) fill(x, 221, x + 6, 232, 0xFF000000u);   // title glyphs
+    }
+    return px;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const int rounds = argc > 1 ? std::atoi(argv[1]) : 3;
+    const double dpi = argc > 2 ? std::atof(argv[2]) : 192;
+    if (rounds <= 0 || dpi <= 0) {
+        std::cerr << "Usage: top100_png_encode_bench [rounds>0] [dpi>0]\n";
+        return 2;
+    }
+    if (!PngWriter::available()) {
+        std::cerr << "PNG writing needs zlib\n";
+        return 1;
+    }
+    const double s = dpi / 96.0;
+    const int w = static_cast<int>(std::lround(980 * s)), rowH = static_cast<int>(std::lround(240 * s));
+    const int rows = 20, h = rowH * rows;
+    std::vector<std::vector<uint32_t>> bands;
+    for (unsigned i = 0; i < 4; ++i) bands.push_back(gridRow(w, rowH, s, i + 1));
+    const double rawMB = double(w) * h * 3 / 1048576.0;
+
+    const std::string out = (fs::temp_directory_path() / "top100_png_encode_bench.png").string();
+    const size_t hw = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<size_t> threadCounts{1};
+    if (hw > 1) threadCounts.push_back(hw);
+    std::cout << "image=" << w << "x" << h << " raw=" << rawMB << " MB rounds=" << rounds << "\n";
+
+    bool ok = true;
+    for (int level : {0, 1, 3, 6, 9}) {
+        for (size_t threads : threadCounts) {
+            PngWriterOptions opts;
+            opts.dpi = dpi;
+            opts.level = level;
+            opts.threads = threads;
+            const auto t0 = std::chrono::steady_clock::now();
+            for (int r = 0; r < rounds && ok; ++r) {
+                PngWriter png;
+                ok = png.open(out, w, h, opts);
+                for (int b = 0; b < rows && ok; ++b) {
+                    const auto& band = bands[static_cast<size_t>(b) % bands.size()];
+                    ok = png.writeRows(reinterpret_cast<const unsigned char*>(band.data()), rowH, w * 4);
+                }
+                ok = ok && png.finish();
+                if (!ok) std::cerr << png.error() << "\n";
+            }
+            const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count() / rounds;
+            std::error_code ec;
+            const double fileMB = double(fs::file_size(out, ec)) / 1048576.0;
+            std::cout << "level=" << level << " threads=" << threads << ": " << ms << " ms, " << rawMB / (ms / 1000.0)
+                      << " MB/s, " << fileMB << " MB (" << 100.0 * fileMB / rawMB << "% of raw)\n";
+        }
+    }
+    std::error_code ec;
+    fs::remove(out, ec);
+    return ok ? 0 : 1;
+}
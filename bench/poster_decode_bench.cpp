@@ -0,0 +1,267 @@
+// SPDX-License-Identifier: Apache-2.0
+//-------------------------------------------------------------------------------
+// Top100 — Your Personal Movie List
+//
+// File: bench/poster_decode_bench.cpp
+// Purpose: Decode throughput and peak memory of each poster decoding backend.
+// Language: C++17 (CMake build)
+//
+// Usage: top100_poster_decode_bench [rounds] [poster-dir]
+//   Without a directory a synthetic corpus is used (BMP always, JPEG with
+//   libjpeg, PNG with Cairo); with one, its *.jpg / *.png / *.gif / *.bmp
+//   files are. Each backend decodes the images it handles, in a child process
+//   on POSIX systems so its peak resident size can be reported separately.
+//-------------------------------------------------------------------------------
+#include "poster_image.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <vector>
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#define TOP100_BENCH_FORK 1
+#endif
+#if TOP100_HAVE_JPEG
+#include <cstdio>
+extern "C" {
+#include <jpeglib.h>
+}
+#endif
+#if TOP100_HAVE_CAIRO
+#include <cairo/cairo.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// Smooth poster-like gradient with a little noise, as 8-bit RGB
+std::vector<unsigned char> gradient(int w, int h, unsigned seed) {
+    std::vector<unsigned char> rgb(static_cast<size_t>(w) * h * 3);
+    for (int y = 0; y < h; ++y)
+        for (int x = 0; x < w; ++x) {
+            unsigned char* p = rgb.data() + (static_cast<size_t>(y) * w + x) * 3;
+            seed = seed * 1103515245u + 12345u;
+            const int noise = static_cast<int>((seed >> 16) & 7);
+            p[0] = static_cast<unsigned char>(128 + 90 * std::sin(x * 0.011 + y * 0.003) + noise);
+            p[1] = static_cast<unsigned char>(128 + 90 * std::sin(y * 0.017) + noise);
+            p[2] = static_cast<unsigned char>(128 + 90 * std::cos((x + y) * 0.007) + noise);
+        }
+    return rgb;
+}
+
+std::string bmp(int w, int h, const std::vector<unsigned char>& rgb) {
+    const size_t stride = (static_cast<size_t>(w) * 3 + 3) & ~size_t(3);
+    const size_t size = 54 + stride * h;
+    std::string out(size, '\0');
+    auto put = [&](size_t at, uint32_t v, int n) {
+        for (int i = 0; i < n; ++i) out[at + i] = static_cast<char>((v >> (8 * i)) & 0xFF);
+    };
+    out[0] = 'B';
+    out[1] = 'M';
+    put(2, static_cast<uint32_t>(size), 4);
+    put(10, 54, 4);
+    put(14, 40, 4);
+    put(18, static_cast<uint32_t>(w), 4);
+    put(22, static_cast<uint32_t>(h), 4);
+    put(26, 1, 2);
+    put(28, 24, 2);
+    for (int y = 0; y < h; ++y) {   // bottom-up, BGR
+        const unsigned char* src = rgb.data() + static_cast<size_t>(h - 1 - y) * w * 3;
+        char* dst = &out[54 + stride * y];
+        for (int x = 0; x < w; ++x) {
+            dst[3 * x] = static_cast<char>(src[3 * x + 2]);
+            dst[3 * x + 1] = static_cast<char>(src[3 * x + 1]);
+            dst[3 * x + 2] = static_cast<char>(src[3 * x]);
+        }
+    }
+    return out;
+}
+
+#if TOP100_HAVE_JPEG
+std::string jpeg(int w, int h, const std::vector<unsigned char>& rgb) {
+    jpeg_compress_struct cinfo;
+    jpeg_error_mgr err;
+    cinfo.err = jpeg_std_error(&err);
+    jpeg_create_compress(&cinfo);
+    unsigned char* buf = nullptr;
+    unsigned long size = 0;
+    jpeg_mem_dest(&cinfo, &buf, &size);
+    cinfo.image_width = static_cast<JDIMENSION>(w);
+    cinfo.image_height = static_cast<JDIMENSION>(h);
+    cinfo.input_components = 3;
+    cinfo.in_color_space = JCS_RGB;
+    jpeg_set_defaults(&cinfo);
+    jpeg_set_quality(&cinfo, 85, TRUE);
+    jpeg_start_compress(&cinfo, TRUE);
+    while (cinfo.next_scanline < cinfo.image_height) {
+        JSAMPROW row = const_cast<unsigned char*>(rgb.data()) + static_cast<size_t>(cinfo.next_scanline) * w * 3;
+        jpeg_write_scanlines(&cinfo, &row, 1);
+    }
+    jpeg_finish_compress(&cinfo);
+    std::string out(reinterpret_cast<const char*>(buf), size);
+    jpeg_destroy_compress(&cinfo);
+    std::free(buf);
+    return out;
+}
+#endif
+
+#if TOP100_HAVE_CAIRO
+std::string png(int w, int h, const std::vector<unsigned char>& rgb) {
+    cairo_surface_t* s = cairo_image_surface_create(CAIRO_FORMAT_RGB24, w, h);
+    cairo_surface_flush(s);
+    unsigned char* data = cairo_image_surface_get_data(s);
+    const int stride = cairo_image_surface_get_stride(s);
+    for (int y = 0; y < h; ++y) {
+        uint32_t* row = reinterpret_cast<uint32_t*>(data + static_cast<size_t>(y) * stride);
+        const unsigned char* src = rgb.data() + static_cast<size_t>(y) * w * 3;
+        for (int x = 0; x < w; ++x, src += 3) row[x] = (uint32_t(src[0]) << 16) | (uint32_t(src[1]) << 8) | src[2];
+    }
+    cairo_surface_mark_dirty(s);
+    std::string out;
+    cairo_surface_write_to_png_stream(
+        s,
+        [](void* closure, const unsigned char* bytes, unsigned int n) {
+            static_cast<std::string*>(closure)->append(reinterpret_cast<const char*>(bytes), n);
+            return CAIRO_STATUS_SUCCESS;
+        },
+        &out);
+    cairo_surface_destroy(s);
+    return out;
+}
+#endif
+
+std::vector<std::string> synthesize() {
+    std::vector<std::string> out;
+    // OMDb's SX300 posters, and a larger scan
+    for (int w : {300, 600}) {
+        const int h = w * 3 / 2;
+        for (unsigned seed = 1; seed <= 4; ++seed) {
+            const auto rgb = gradient(w, h, seed);
+            out.push_back(bmp(w, h, rgb));
+#if TOP100_HAVE_JPEG
+            out.push_back(jpeg(w, h, rgb));
+#endif
+#if TOP100_HAVE_CAIRO
+            out.push_back(png(w, h, rgb));
+#endif
+        }
+    }
+    return out;
+}
+
+std::vector<std::string> readDir(const std::string& dir) {
+    std::vector<std::string> out;
+    std::error_code ec;
+    for (const auto& e : fs::directory_iterator(dir, ec)) {
+        std::string ext = e.path().extension().string();
+        std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return std::tolower(c); });
+        if (ext != ".jpg" && ext != ".jpeg" && ext != ".png" && ext != ".gif" && ext != ".bmp") continue;
+        std::ifstream in(e.path(), std::ios::binary);
+        std::ostringstream bytes;
+        bytes << in.rdbuf();
+        if (!bytes.str().empty()) out.push_back(bytes.str());
+    }
+    return out;
+}
+
+// Decode every image the backend handles, rounds times; prints one line
+void measure(const std::string& label, const PosterDecoder* decoder, const std::vector<std::string>& corpus,
+             int rounds) {
+    std::map<std::string, size_t> formats;
+    size_t images = 0, inBytes = 0, outBytes = 0, failed = 0;
+    std::vector<const std::string*> mine;
+    for (const auto& bytes : corpus) {
+        const std::string mime = posterMimeOf(bytes);
+        if (decoder && !decoder->decodes(mime)) continue;
+        mine.push_back(&bytes);
+        ++formats[mime.substr(mime.find('/') + 1)];
+    }
+    const auto t0 = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; ++r) {
+        for (const std::string* bytes : mine) {
+            auto bitmap = decoder ? decoder->decode(*bytes, 0, 0) : decodePosterImage(*bytes);
+            ++images;
+            inBytes += bytes->size();
+            if (bitmap) outBytes += bitmap->byteSize();
+            else ++failed;
+        }
+    }
+    const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    std::cout << label << ":";
+    for (const auto& f : formats) std::cout << " " << f.first << "=" << f.second;
+    if (images == 0) {
+        std::cout << " (nothing to decode)\n";
+        return;
+    }
+    std::cout << "  " << ms / images << " ms/image, " << (inBytes / 1048576.0) / (ms / 1000.0) << " MB/s in, "
+              << (outBytes / 1048576.0) / (ms / 1000.0) << " MB/s out";
+    if (failed) std::cout << ", " << failed / rounds << " failed";
+    std::cout << "\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const int rounds = argc > 1 ? std::atoi(argv[1]) : 20;
+    if (rounds <= 0) {
+        std::cerr << "Usage: top100_poster_decode_bench [rounds>0] [poster-dir]\n";
+        return 2;
+    }
+    const std::vector<std::string> corpus = argc > 2 ? readDir(argv[2]) : synthesize();
+    if (corpus.empty()) {
+        std::cerr << "No images to decode\n";
+        return 1;
+    }
+    size_t bytes = 0;
+    for (const auto& c : corpus) bytes += c.size();
+    std::cout << "images=" << corpus.size() << " bytes=" << bytes << " rounds=" << rounds << "\n";
+
+    std::vector<std::string> labels{"(baseline)"};
+    for (const auto& name : posterDecoderNames()) labels.push_back(name);
+    labels.push_back("auto");
+    for (const std::string& label : labels) {
+        auto run = [&] {
+            if (label == "(baseline)") {
+                std::cout << label << ": corpus loaded, nothing decoded\n";
+                return;
+            }
+            const auto decoder = label == "auto" ? nullptr : makePosterDecoder(label);
+            measure(label, decoder.get(), corpus, rounds);
+        };
+#if TOP100_BENCH_FORK
+        // One child per backend: its peak RSS is that backend's alone
+        std::cout.flush();
+        const pid_t pid = fork();
+        if (pid == 0) {
+            run();
+            std::cout.flush();
+            _exit(0);
+        }
+        int status = 0;
+        rusage usage{};
+        if (pid > 0 && wait4(pid, &status, 0, &usage) == pid) {
+#if defined(__APPLE__)
+            const double peakMB = usage.ru_maxrss / 1048576.0;   // bytes
+#else
+            const double peakMB = usage.ru_maxrss / 1024.0;      // KiB
+#endif
+            std::cout << "  peak RSS " << peakMB << " MB\n";
+        } else {
+            run();
+        }
+#else
+        run();
+#endif
+    }
+    return 0;
+}
@@ -0,0 +1,126 @@
+// SPDX-License-Identifier: Apache-2.0
+//-------------------------------------------------------------------------------
+// Top100 — Your Personal Movie List
+//
+// File: bench/poster_export_bench.cpp
+// Purpose: End-to-end image export time, one decode/downscale thread vs. many.
+// Language: C++17 (CMake build)
+//
+// Usage: top100_poster_export_bench [rounds] [poster-dir]
+//   Exports a 100-movie grid whose posters are already in a memory-only cache
+//   (kept encoded and without thumbnails, so every export decodes them
+//   again). Without a directory the posters are synthesized by the loopback
+//   fixture server; with one, its *.jpg / *.png files are used in turn.
+//-------------------------------------------------------------------------------
+#include "Movie.h"
+#include "fixture_server.h"
+#include "image_export.h"
+#include "poster_cache.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+std::vector<std::string> posterFiles(const std::string& dir) {
+    std::vector<std::string> out;
+    std::error_code ec;
+    for (const auto& e : fs::directory_iterator(dir, ec)) {
+        std::string ext = e.path().extension().string();
+        std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return std::tolower(c); });
+        if (ext != ".jpg" && ext != ".jpeg" && ext != ".png") continue;
+        std::ifstream in(e.path(), std::ios::binary);
+        std::ostringstream bytes;
+        bytes << in.rdbuf();
+        if (!bytes.str().empty()) out.push_back(bytes.str());
+    }
+    return out;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const int rounds = argc > 1 ? std::atoi(argv[1]) : 5;
+    if (rounds <= 0) {
+        std::cerr << "Usage: top100_poster_export_bench [rounds>0] [poster-dir]\n";
+        return 2;
+    }
+
+    // Encoded posters and no stored thumbnails: decoding and scaling are what is measured
+    PosterCacheOptions copts;
+    copts.decode = false;
+    copts.thumbnails = false;
+    auto cache = std::make_shared<PosterCache>(std::string(), copts);
+    setPosterCache(cache);
+
+    std::vector<Movie> movies(100);
+    for (size_t i = 0; i < movies.size(); ++i) {
+        movies[i].imdbID = "tt" + std::to_string(9000000 + i);
+        movies[i].title = "Benchmark Title " + std::to_string(i + 1);
+        movies[i].year = 1950 + static_cast<int>(i % 70);
+    }
+
+    std::unique_ptr<FixtureServer> server;
+    size_t bytes = 0;
+    if (argc > 2) {
+        const auto files = posterFiles(argv[2]);
+        if (files.empty()) {
+            std::cerr << "No *.jpg / *.png posters in " << argv[2] << "\n";
+            return 1;
+        }
+        for (size_t i = 0; i < movies.size(); ++i) {
+            movies[i].posterUrl = "bench://" + std::to_string(i);
+            cache->put(movies[i].imdbID, movies[i].posterUrl, files[i % files.size()]);
+        }
+    } else {
+        server = std::make_unique<FixtureServer>();
+        if (!server->ok()) {
+            std::cerr << "Fixture server: " << server->error() << "\n";
+            return 1;
+        }
+        const auto ids = server->synthesize(movies.size(), 300);
+        std::vector<PosterRequest> wanted;
+        for (size_t i = 0; i < movies.size(); ++i) {
+            movies[i].imdbID = ids[i];
+            movies[i].posterUrl = server->posterUrl(ids[i] + ".png");
+            wanted.push_back(PosterRequest{movies[i].imdbID, movies[i].posterUrl});
+        }
+        cache->getAll(wanted);
+    }
+    for (const auto& m : movies) {
+        if (auto p = cache->peek(m.imdbID, m.posterUrl)) bytes += p->bytes.size();
+    }
+
+    const std::string out = (fs::temp_directory_path() / "top100_poster_export_bench.png").string();
+    const size_t hw = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<size_t> threadCounts{1};
+    for (size_t t = 2; t < hw; t *= 2) threadCounts.push_back(t);
+    if (hw > 1) threadCounts.push_back(hw);
+
+    std::cout << "posters=" << movies.size() << " bytes=" << bytes << " rounds=" << rounds << "\n";
+    double single = 0;
+    bool ok = true;
+    for (size_t threads : threadCounts) {
+        ImageExportOptions opts;
+        opts.threads = threads;
+        ok = exportTop100Image(movies, out, "Benchmark", opts) && ok;   // warm-up
+        const auto t0 = std::chrono::steady_clock::now();
+        for (int r = 0; r < rounds; ++r) ok = exportTop100Image(movies, out, "Benchmark", opts) && ok;
+        const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count() / rounds;
+        if (threads == 1) single = ms;
+        std::cout << "threads=" << threads << ": " << ms << " ms/export, speedup " << single / ms << "x\n";
+    }
+    fs::remove(out);
+    if (!ok) std::cerr << "Export failed\n";
+    return ok ? 0 : 1;
+}
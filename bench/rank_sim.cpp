@@ -0,0 +1,356 @@
+// SPDX-License-Identifier: Apache-2.0
+//-------------------------------------------------------------------------------
+// Top100 — Your Personal Movie List
+//
+// File: bench/rank_sim.cpp
+// Purpose: Headless ranking convergence simulator and strategy benchmark.
+// Language: C++17 (CMake build)
+//
+// Summary:
+// Generates a hidden ground-truth order, answers comparisons through a noisy
+// simulated user and drives the same pair selection / applyComparison path the
+// CLI uses. After each comparison the estimated ranking is scored against the
+// truth (Kendall tau, Spearman footrule). Sessions run in parallel and the
+// per-step means/standard deviations are written as CSV or JSON.
+//-------------------------------------------------------------------------------
+#include "Movie.h"
+#include "preference_graph.h"
+#include "ranking.h"
+#include "thread_pool.h"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct NoiseModel {
+    enum Kind { None, Flip, Logistic } kind = None;
+    double param = 0.0;   // Flip: error probability; Logistic: temperature
+    std::string label = "none";
+};
+
+struct RatingModel {
+    std::string name;
+    double k = 32.0;      // Elo K-factor passed to applyComparison
+    bool closure = false; // order by implied wins first, Elo score second
+};
+
+struct Combo {
+    std::string strategy;
+    RatingModel model;
+    NoiseModel noise;
+};
+
+struct Options {
+    size_t movies = 100;
+    size_t sessions = 1000;
+    size_t comparisons = 1000;
+    size_t every = 1;
+    size_t threads = 0;
+    unsigned seed = 12345;
+    std::vector<std::string> strategies = pairStrategyNames();
+    std::vector<std::string> models = {"elo32", "closure"};
+    std::vector<std::string> noises = {"logistic:0.3"};
+    std::string format = "csv";
+    std::string out;
+};
+
+// Running sums for one combo; one instance per worker, merged at the end.
+struct Accumulator {
+    std::vector<double> tau, tau2, foot, foot2;
+    size_t converged = 0;
+    double convergedSteps = 0.0;
+
+    explicit Accumulator(size_t samples = 0) : tau(samples), tau2(samples), foot(samples), foot2(samples) {}
+
+    void add(size_t sample, double t, double f) {
+        tau[sample] += t;
+        tau2[sample] += t * t;
+        foot[sample] += f;
+        foot2[sample] += f * f;
+    }
+
+    void merge(const Accumulator& o) {
+        for (size_t i = 0; i < tau.size(); ++i) {
+            tau[i] += o.tau[i];
+            tau2[i] += o.tau2[i];
+            foot[i] += o.foot[i];
+            foot2[i] += o.foot2[i];
+        }
+        converged += o.converged;
+        convergedSteps += o.convergedSteps;
+    }
+};
+
+std::vector<std::string> splitList(const std::string& s) {
+    std::vector<std::string> out;
+    std::stringstream ss(s);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (!item.empty()) out.push_back(item);
+    }
+    return out;
+}
+
+bool parseNoise(const std::string& spec, NoiseModel& out) {
+    out.label = spec;
+    if (spec == "none") { out.kind = NoiseModel::None; return true; }
+    const auto colon = spec.find(':');
+    if (colon == std::string::npos) return false;
+    const std::string kind = spec.substr(0, colon);
+    try { out.param = std::stod(spec.substr(colon + 1)); } catch (...) { return false; }
+    if (kind == "flip" && out.param >= 0.0 && out.param <= 1.0) { out.kind = NoiseModel::Flip; return true; }
+    if (kind == "logistic" && out.param > 0.0) { out.kind = NoiseModel::Logistic; return true; }
+    return false;
+}
+
+bool parseModel(const std::string& spec, RatingModel& out) {
+    out.name = spec;
+    if (spec == "closure") { out.closure = true; return true; }
+    if (spec.rfind("elo", 0) == 0) {
+        try { out.k = std::stod(spec.substr(3)); } catch (...) { return false; }
+        return out.k > 0.0;
+    }
+    return false;
+}
+
+void usage() {
+    std::cerr <<
+        "Usage: top100_rank_sim [options]\n"
+        "  --movies N        movies per session (default 100)\n"
+        "  --sessions N      simulated sessions per combination (default 1000)\n"
+        "  --comparisons N   answers per session (default 1000)\n"
+        "  --every N         record metrics every N answers (default 1)\n"
+        "  --threads N       worker threads (default: all cores)\n"
+        "  --seed N          base random seed (default 12345)\n"
+        "  --strategies L    comma list: random,random-skip,active,insertion\n"
+        "  --models L        comma list: eloK (e.g. elo32, elo16), closure\n"
+        "  --noise L         comma list: none, flip:P, logistic:T (default logistic:0.3)\n"
+        "  --format F        csv or json (default csv)\n"
+        "  --out FILE        write results to FILE instead of stdout\n";
+}
+
+bool parseArgs(int argc, char** argv, Options& o) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") return false;
+        if (i + 1 >= argc) { std::cerr << "Missing value for " << arg << "\n"; return false; }
+        const std::string val = argv[++i];
+        try {
+            if (arg == "--movies") o.movies = std::stoul(val);
+            else if (arg == "--sessions") o.sessions = std::stoul(val);
+            else if (arg == "--comparisons") o.comparisons = std::stoul(val);
+            else if (arg == "--every") o.every = std::max<size_t>(1, std::stoul(val));
+            else if (arg == "--threads") o.threads = std::stoul(val);
+            else if (arg == "--seed") o.seed = static_cast<unsigned>(std::stoul(val));
+            else if (arg == "--strategies") o.strategies = splitList(val);
+            else if (arg == "--models") o.models = splitList(val);
+            else if (arg == "--noise") o.noises = splitList(val);
+            else if (arg == "--format") o.format = val;
+            else if (arg == "--out") o.out = val;
+            else { std::cerr << "Unknown option " << arg << "\n"; return false; }
+        } catch (...) {
+            std::cerr << "Invalid value for " << arg << ": " << val << "\n";
+            return false;
+        }
+    }
+    if (o.movies < 2) { std::cerr << "--movies must be at least 2\n"; return false; }
+    if (o.format != "csv" && o.format != "json") { std::cerr << "--format must be csv or json\n"; return false; }
+    return true;
+}
+
+// Fill rank[i] with the position of movie i under the rating model (0 = best).
+void estimateRanks(const std::vector<Movie>& movies, const PreferenceGraph& prefs, const RatingModel& model,
+                   std::vector<size_t>& order, std::vector<size_t>& wins, std::vector<size_t>& rank) {
+    const size_t n = movies.size();
+    std::iota(order.begin(), order.end(), size_t{0});
+    if (model.closure) {
+        for (size_t i = 0; i < n; ++i) wins[i] = prefs.beatsCount(prefs.idOf(comparisonKey(movies[i])));
+        std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+            if (wins[a] != wins[b]) return wins[a] > wins[b];
+            if (movies[a].userScore != movies[b].userScore) return movies[a].userScore > movies[b].userScore;
+            return a < b;
+        });
+    } else {
+        std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+            if (movies[a].userScore != movies[b].userScore) return movies[a].userScore > movies[b].userScore;
+            return a < b;
+        });
+    }
+    for (size_t k = 0; k < n; ++k) rank[order[k]] = k;
+}
+
+void runSession(const Options& o, const Combo& combo, size_t session, Accumulator& acc) {
+    const size_t n = o.movies;
+    // Same seed per session across combos so strategies face identical users
+    std::seed_seq seq{o.seed, static_cast<unsigned>(session), static_cast<unsigned>(static_cast<unsigned long long>(session) >> 32)};
+    std::mt19937 rng(seq);
+
+    std::normal_distribution<double> quality(0.0, 1.0);
+    std::vector<double> q(n);
+    for (auto& v : q) v = quality(rng);
+    std::vector<size_t> truth(n), order(n), wins(n), est(n);
+    std::iota(order.begin(), order.end(), size_t{0});
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return q[a] > q[b]; });
+    for (size_t k = 0; k < n; ++k) truth[order[k]] = k;
+
+    std::vector<Movie> movies(n);
+    for (size_t i = 0; i < n; ++i) {
+        char id[16];
+        std::snprintf(id, sizeof(id), "tt%07zu", i);
+        movies[i].title = id;
+        movies[i].year = 2000;
+        movies[i].imdbID = id;
+    }
+
+    PreferenceGraph prefs;
+    auto strategy = makePairStrategy(combo.strategy);
+    std::uniform_real_distribution<double> coin(0.0, 1.0);
+
+    const size_t samples = acc.tau.size();
+    double tau = 0.0, foot = 0.0;
+    auto record = [&](size_t sample) {
+        estimateRanks(movies, prefs, combo.model, order, wins, est);
+        tau = kendallTau(est, truth);
+        foot = spearmanFootrule(est, truth);
+        acc.add(sample, tau, foot);
+    };
+    record(0);
+
+    size_t step = 1;
+    for (; step <= o.comparisons; ++step) {
+        auto pair = strategy->nextPair(movies, prefs, rng);
+        if (!pair) {
+            estimateRanks(movies, prefs, combo.model, order, wins, est);
+            tau = kendallTau(est, truth);
+            foot = spearmanFootrule(est, truth);
+            ++acc.converged;
+            acc.convergedSteps += static_cast<double>(step - 1);
+            break;
+        }
+        const size_t i = pair->first, j = pair->second;
+        bool iWins = q[i] > q[j];
+        switch (combo.noise.kind) {
+        case NoiseModel::None: break;
+        case NoiseModel::Flip: if (coin(rng) < combo.noise.param) iWins = !iWins; break;
+        case NoiseModel::Logistic:
+            iWins = coin(rng) < 1.0 / (1.0 + std::exp(-(q[i] - q[j]) / combo.noise.param));
+            break;
+        }
+        if (iWins) applyComparison(movies, prefs, i, j, combo.model.k);
+        else applyComparison(movies, prefs, j, i, combo.model.k);
+        if (step % o.every == 0) record(step / o.every);
+    }
+    // A converged session keeps its final score for the remaining samples
+    for (size_t s = step / o.every + (step % o.every == 0 ? 0 : 1); s < samples; ++s) acc.add(s, tau, foot);
+}
+
+double mean(double sum, size_t n) { return n ? sum / static_cast<double>(n) : 0.0; }
+
+double stddev(double sum, double sum2, size_t n) {
+    if (n < 2) return 0.0;
+    const double m = sum / static_cast<double>(n);
+    return std::sqrt(std::max(0.0, sum2 / static_cast<double>(n) - m * m));
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options o;
+    if (!parseArgs(argc, argv, o)) { usage(); return 2; }
+
+    std::vector<Combo> combos;
+    for (const auto& s : o.strategies) {
+        if (!makePairStrategy(s)) { std::cerr << "Unknown strategy " << s << "\n"; return 2; }
+        for (const auto& m : o.models) {
+            RatingModel model;
+            if (!parseModel(m, model)) { std::cerr << "Unknown rating model " << m << "\n"; return 2; }
+            for (const auto& nz : o.noises) {
+                NoiseModel noise;
+                if (!parseNoise(nz, noise)) { std::cerr << "Invalid noise model " << nz << "\n"; return 2; }
+                combos.push_back({s, model, noise});
+            }
+        }
+    }
+
+    const size_t samples = o.comparisons / o.every + 1;
+    ThreadPool pool(o.threads);
+    std::vector<std::vector<Accumulator>> perWorker(pool.threadCount(),
+                                                    std::vector<Accumulator>(combos.size(), Accumulator(samples)));
+    const auto start = std::chrono::steady_clock::now();
+    pool.parallelFor(o.sessions * combos.size(), [&](size_t item, size_t worker) {
+        const size_t c = item % combos.size();
+        runSession(o, combos[c], item / combos.size(), perWorker[worker][c]);
+    });
+    const double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::vector<Accumulator> totals(combos.size(), Accumulator(samples));
+    for (const auto& w : perWorker)
+        for (size_t c = 0; c < combos.size(); ++c) totals[c].merge(w[c]);
+
+    std::ofstream file;
+    if (!o.out.empty()) {
+        file.open(o.out);
+        if (!file) { std::cerr << "Cannot write " << o.out << "\n"; return 1; }
+    }
+    std::ostream& out = o.out.empty() ? std::cout : file;
+    const size_t n = o.sessions;
+
+    if (o.format == "csv") {
+        out << "strategy,model,noise,step,sessions,tau_mean,tau_sd,footrule_mean,footrule_sd\n";
+        for (size_t c = 0; c < combos.size(); ++c) {
+            const auto& a = totals[c];
+            for (size_t s = 0; s < samples; ++s) {
+                out << combos[c].strategy << ',' << combos[c].model.name << ',' << combos[c].noise.label << ','
+                    << s * o.every << ',' << n << ',' << mean(a.tau[s], n) << ',' << stddev(a.tau[s], a.tau2[s], n)
+                    << ',' << mean(a.foot[s], n) << ',' << stddev(a.foot[s], a.foot2[s], n) << '\n';
+            }
+        }
+    } else {
+        nlohmann::json doc;
+        doc["movies"] = o.movies;
+        doc["sessions"] = n;
+        doc["comparisons"] = o.comparisons;
+        doc["every"] = o.every;
+        doc["seed"] = o.seed;
+        doc["series"] = nlohmann::json::array();
+        for (size_t c = 0; c < combos.size(); ++c) {
+            const auto& a = totals[c];
+            nlohmann::json series;
+            series["strategy"] = combos[c].strategy;
+            series["model"] = combos[c].model.name;
+            series["noise"] = combos[c].noise.label;
+            series["converged"] = a.converged;
+            series["meanStepsToConverge"] = mean(a.convergedSteps, a.converged);
+            nlohmann::json points = nlohmann::json::array();
+            for (size_t s = 0; s < samples; ++s) {
+                points.push_back({{"step", s * o.every},
+                                  {"tauMean", mean(a.tau[s], n)},
+                                  {"tauSd", stddev(a.tau[s], a.tau2[s], n)},
+                                  {"footruleMean", mean(a.foot[s], n)},
+                                  {"footruleSd", stddev(a.foot[s], a.foot2[s], n)}});
+            }
+            series["points"] = std::move(points);
+            doc["series"].push_back(std::move(series));
+        }
+        out << doc.dump(2) << '\n';
+    }
+
+    std::cerr << combos.size() * n << " sessions on " << pool.threadCount() << " threads in " << secs << " s\n";
+    for (size_t c = 0; c < combos.size(); ++c) {
+        const auto& a = totals[c];
+        std::cerr << "  " << combos[c].strategy << '/' << combos[c].model.name << '/' << combos[c].noise.label
+                  << ": final tau " << mean(a.tau[samples - 1], n) << ", converged " << a.converged << '/' << n;
+        if (a.converged) std::cerr << " after " << mean(a.convergedSteps, a.converged) << " answers";
+        std::cerr << '\n';
+    }
+    return 0;
+}
@@ -19,7 +19,7 @@
 #include <string>
 #include "dup_policy.h"
 
-void addFromOmdb(Top100& top100, const std::string& apiKey) {
+void addFromOmdb(Top100& top100, const std::string& apiKey, const OmdbDetailOptions& opts) {
     std::cout << "Enter a title to search: ";
     std::string query;
     std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
@@ -43,7 +43,7 @@ void addFromOmdb(Top100& top100, const std::string& apiKey) {
         return;
     }
 
-    auto full = omdbGetById(apiKey, results[choice - 1].imdbID);
+    auto full = omdbGetById(apiKey, results[choice - 1].imdbID, opts);
     if (!full) {
         std::cout << "Failed to fetch details.\n";
         return;
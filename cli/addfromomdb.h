@@ -11,5 +11,6 @@
 //-------------------------------------------------------------------------------
 #pragma once
 #include "top100.h"
+#include "omdb.h"
 
-void addFromOmdb(Top100& top100, const std::string& apiKey);
+void addFromOmdb(Top100& top100, const std::string& apiKey, const OmdbDetailOptions& opts = OmdbDetailOptions{});
@@ -15,16 +15,6 @@
 #include <random>
 #include <chrono>
 
-static void updateElo(double& a, double& b, double scoreA, double k = 32.0) {
-    // scoreA: 1.0 if A wins, 0.0 if A loses
-    const double qa = std::pow(10.0, a / 400.0);
-    const double qb = std::pow(10.0, b / 400.0);
-    const double ea = qa / (qa + qb);
-    const double eb = qb / (qa + qb);
-    a = a + k * (scoreA - ea);
-    b = b + k * ((1.0 - scoreA) - eb);
-}
-
 void compareMovies(Top100& top100) {
     auto seed = static_cast<unsigned>(std::chrono::steady_clock::now().time_since_epoch().count());
     std::mt19937 rng(seed);
@@ -36,10 +26,14 @@ void compareMovies(Top100& top100) {
             return;
         }
 
-        std::uniform_int_distribution<size_t> dist(0, movies.size() - 1);
-        size_t i = dist(rng);
-        size_t j = dist(rng);
-        while (j == i) j = dist(rng);
+        // Skip pairs whose outcome already follows from earlier answers
+        auto pair = pickComparisonPair(movies, top100.preferences(), rng);
+        if (!pair) {
+            std::cout << "Every pair is already ordered by your previous answers.\n";
+            return;
+        }
+        size_t i = pair->first;
+        size_t j = pair->second;
 
         const Movie& A = movies[i];
         const Movie& B = movies[j];
@@ -56,21 +50,13 @@ void compareMovies(Top100& top100) {
             continue;
         }
 
-        Movie mA = A;
-        Movie mB = B;
-        if (choice == '1') {
-            updateElo(mA.userScore, mB.userScore, 1.0);
-        } else {
-            updateElo(mA.userScore, mB.userScore, 0.0);
-        }
-
-        // Write back and recompute ranks
-        if (!top100.updateMovie(i, mA)) return;
-        if (!top100.updateMovie(j, mB)) return;
-        top100.recomputeRanks();
+        // Elo update, history append and rank recompute happen in the core list
+        bool ok = (choice == '1') ? top100.recordComparison(i, j) : top100.recordComparison(j, i);
+        if (!ok) return;
 
+        auto updated = top100.getMovies();
         std::cout << "Updated scores: \n";
-        std::cout << mA.title << ": " << static_cast<int>(mA.userScore) << "\n";
-        std::cout << mB.title << ": " << static_cast<int>(mB.userScore) << "\n";
+        std::cout << updated[i].title << ": " << static_cast<int>(updated[i].userScore) << "\n";
+        std::cout << updated[j].title << ": " << static_cast<int>(updated[j].userScore) << "\n";
     }
 }
@@ -39,6 +39,7 @@ void displayMenu(bool omdbEnabled, bool blueSkyEnabled, bool mastodonEnabled)
     std::cout << "7. Compare two movies (rank)\n";
     if (omdbEnabled) {
         std::cout << "u. Update a movie from OMDb by IMDb ID\n";
+        std::cout << "r. Refresh stale movies from OMDb\n";
     }
     if (blueSkyEnabled) {
         std::cout << "8. Post a movie to BlueSky\n";
@@ -0,0 +1,77 @@
+// SPDX-License-Identifier: Apache-2.0
+//-------------------------------------------------------------------------------
+// Top100 — Your Personal Movie List
+//
+// File: cli/imdb_import.cpp
+// Purpose: Build the offline title index from the IMDb dataset dumps.
+// Language: C++17 (CMake build)
+//
+// Usage: top100_imdb_import <dataset-dir> [index-file]
+//   <dataset-dir> holds title.basics.tsv.gz, title.ratings.tsv.gz,
+//   title.principals.tsv.gz and name.basics.tsv.gz (https://datasets.imdbws.com/).
+//   The index defaults to imdb_titles.idx beside the movie database and is
+//   recorded as omdbLocalIndexPath in the config.
+//-------------------------------------------------------------------------------
+#include "config.h"
+#include "title_index.h"
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <filesystem>
+#include <iostream>
+
+static std::atomic<bool> gCancel{false};
+
+static void onInterrupt(int) {
+    gCancel = true;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "Usage: top100_imdb_import <dataset-dir> [index-file]\n";
+        return 2;
+    }
+    AppConfig cfg = loadConfig();
+    const std::string indexPath = argc > 2
+        ? std::string(argv[2])
+        : (std::filesystem::path(cfg.dataFile).parent_path() / "imdb_titles.idx").string();
+
+    ImdbImportOptions opts = imdbImportOptionsForDir(argv[1]);
+    if (opts.basicsPath.empty()) {
+        std::cerr << "title.basics.tsv(.gz) not found in " << argv[1] << "\n";
+        return 1;
+    }
+    if (opts.principalsPath.empty() || opts.namesPath.empty()) {
+        std::cerr << "Note: title.principals and name.basics are both needed for directors and cast.\n";
+    }
+    opts.cancel = &gCancel;
+    std::string lastStage;
+    opts.onProgress = [&lastStage](const ImdbImportProgress& p) {
+        if (p.stage != lastStage) {
+            if (!lastStage.empty()) std::cerr << "\n";
+            lastStage = p.stage;
+        }
+        std::cerr << "\r" << p.stage;
+        if (p.bytesTotal > 0) std::cerr << "  " << (100 * p.bytesRead / p.bytesTotal) << "%";
+        std::cerr << "  " << p.rows << " rows   " << std::flush;
+    };
+    std::signal(SIGINT, onInterrupt);
+
+    const auto start = std::chrono::steady_clock::now();
+    const ImdbImportResult r = importImdbDatasets(opts, indexPath);
+    std::signal(SIGINT, SIG_DFL);
+    std::cerr << "\n";
+    if (!r.ok) {
+        std::cerr << "Import failed: " << r.error << "\n";
+        return 1;
+    }
+    const double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Indexed " << r.titles << " titles (" << r.rated << " rated, " << r.credited
+              << " with credits) in " << secs << " s\n" << "Index: " << indexPath << "\n";
+    if (cfg.omdbLocalIndexPath != indexPath) {
+        cfg.omdbLocalIndexPath = indexPath;
+        saveConfig(cfg);
+        std::cout << "Saved omdbLocalIndexPath in " << getConfigPath() << "\n";
+    }
+    return 0;
+}
@@ -4,7 +4,7 @@
 // Top100 — Your Personal Movie List
 //
 // File: cli/listmovies.cpp
-// Purpose: CLI listing and sorting (default, by year/title/rank/score).
+// Purpose: CLI listing and sorting (default, by year/title/rank/score/composite).
 // Language: C++17 (CMake build)
 //
 // Author: Andy McCall, mailme@andymccall.co.uk
@@ -14,8 +14,9 @@
 #include <iostream>
 #include <vector>
 #include "Movie.h"
+#include "rank_bootstrap.h"
 
-void listMovies(const Top100& top100) {
+void listMovies(Top100& top100) {
     char input = 0;
     SortOrder order = SortOrder::DEFAULT;
 
@@ -25,6 +26,7 @@ void listMovies(const Top100& top100) {
     std::cout << "3. List alphabetically by title\n";
     std::cout << "4. List by my rank (best first)\n";
     std::cout << "5. List by my score (Elo)\n";
+    std::cout << "6. List by combined score (mine + critics)\n";
     std::cout << "Enter your choice: ";
     std::cin >> input;
 
@@ -44,19 +46,24 @@ void listMovies(const Top100& top100) {
         case '5':
             order = SortOrder::BY_USER_SCORE;
             break;
+        case '6':
+            order = SortOrder::COMPOSITE;
+            break;
         default:
             std::cout << "Invalid option, defaulting to insertion order.\n";
             order = SortOrder::DEFAULT;
             break;
     }
 
+    // Rank intervals from the comparison history, e.g. "#12 (9-15)"
+    top100.estimateRankIntervals();
     std::vector<Movie> movies = top100.getMovies(order);
     if (movies.empty()) {
         std::cout << "\nNo movies in your list." << std::endl;
     } else {
         std::cout << "\n--- Your Top Movies ---\n";
         for (const auto& movie : movies) {
-            std::cout << (movie.userRank > 0 ? ("#" + std::to_string(movie.userRank) + " ") : "")
+            std::cout << rankLabel(movie)
                       << "Title: " << movie.title 
                       << ", Year: " << movie.year 
                       << ", Director: " << movie.director
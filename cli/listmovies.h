@@ -14,4 +14,4 @@
 #include "top100.h"
 #include <vector>
 #include <string>
-void listMovies(const Top100& top100);
+void listMovies(Top100& top100);
@@ -18,22 +18,37 @@
 #include "comparemovies.h"
 #include "config.h"
 #include "omdb.h"
+#include "omdb_refresh.h"
 #include "config_utils.h"
 #include "bluesky.h"
 #include "mastodon.h"
 #include <cpr/cpr.h>
 #include "posting.h"
+#include "shared_services.h"
 #include <limits>
+#include <atomic>
+#include <csignal>
 #include "image_export.h"
 
+// Set by Ctrl+C while a bulk refresh runs
+static std::atomic<bool> gRefreshCancel{false};
+
+static void onRefreshInterrupt(int) {
+    gRefreshCancel = true;
+}
+
 int main()
 {
     // Load or create configuration
     AppConfig cfg = loadConfig();
+    for (const std::string& error : initSharedServices(cfg)) std::cerr << "Warning: " << error << std::endl;
 
     Top100 top100(cfg.dataFile);
     // Ensure ranks exist on startup (for legacy data)
     top100.recomputeRanks();
+    top100.setCompositeWeights(makeCompositeWeights(cfg.sortWeightUserScore, cfg.sortWeightImdbRating,
+                                                    cfg.sortWeightMetascore, cfg.sortWeightRottenTomatoes,
+                                                    cfg.sortNormalisation));
     char input;
 
     do
@@ -62,7 +77,7 @@ int main()
                     std::cout << "List full, remove a movie first\n";
                     break;
                 }
-                addFromOmdb(top100, cfg.omdbApiKey);
+                addFromOmdb(top100, cfg.omdbApiKey, OmdbDetailOptions{cfg.omdbFetchShortPlot});
             } else {
                 // Configure OMDb API key
                 std::cout << "Enter OMDb API key: ";
@@ -91,6 +106,8 @@ int main()
                     // Reopen Top100 with new path
                     top100 = Top100(cfg.dataFile);
                     top100.recomputeRanks();
+                    for (const std::string& error : initSharedServices(cfg))
+                        std::cerr << "Warning: " << error << std::endl;
                 } else {
                     std::cout << "Invalid path, not updated.\n";
                 }
@@ -109,7 +126,9 @@ int main()
                 std::cout << "Enter IMDb ID to update (e.g., tt1375666): ";
                 std::string imdb; std::cin >> imdb;
                 try {
-                    auto maybe = omdbGetById(cfg.omdbApiKey, imdb);
+                    OmdbDetailOptions opts{cfg.omdbFetchShortPlot};
+                    opts.revalidate = true;
+                    auto maybe = omdbGetById(cfg.omdbApiKey, imdb, opts);
                     if (!maybe) {
                         std::cout << "Not found on OMDb.\n";
                     } else {
@@ -126,6 +145,39 @@ int main()
                 }
             }
             break;
+        case 'r':
+            if (cfg.omdbEnabled) {
+                const long long maxAge = static_cast<long long>(cfg.omdbRefreshMaxAgeDays) * 24 * 3600;
+                const size_t stale = top100.staleImdbIds(maxAge).size();
+                if (stale == 0) {
+                    std::cout << "All movies were refreshed within the last " << cfg.omdbRefreshMaxAgeDays << " days.\n";
+                    break;
+                }
+                std::cout << "Refreshing " << stale << " movies from OMDb (Ctrl+C to stop)...\n";
+                OmdbRefreshOptions opts = omdbRefreshOptions(cfg);
+                gRefreshCancel = false;
+                opts.cancel = &gRefreshCancel;
+                opts.onProgress = [](const OmdbRefreshProgress& p) {
+                    std::cout << "\r  " << p.done << "/" << p.total;
+                    if (p.failed > 0) std::cout << " (" << p.failed << " failed)";
+                    std::cout << std::flush;
+                };
+                auto previous = std::signal(SIGINT, onRefreshInterrupt);
+                OmdbRefreshResult result;
+                try {
+                    result = refreshStaleMovies(top100, cfg.omdbApiKey, maxAge, opts);
+                } catch (...) {
+                    std::cout << "\nRefresh failed due to an error.\n";
+                }
+                std::signal(SIGINT, previous);
+                std::cout << "\nUpdated " << result.merged << " movies";
+                if (!result.failed.empty()) std::cout << ", " << result.failed.size() << " failed";
+                std::cout << ".\n";
+                if (result.cancelled) std::cout << "Refresh cancelled; run it again to continue.\n";
+                if (result.stoppedBy == OmdbError::QuotaExceeded) std::cout << "OMDb request limit reached; try again later.\n";
+                if (result.stoppedBy == OmdbError::InvalidKey) std::cout << "OMDb rejected the API key.\n";
+            }
+            break;
         case '8':
             if (cfg.blueSkyEnabled) {
                 // Select a movie to post
@@ -54,15 +54,21 @@ struct Movie {
     /** Rotten Tomatoes 0-100 from OMDb Ratings[Source=="Rotten Tomatoes"] */
     int rottenTomatoes = 0;
     // Provenance and IDs
-    /** Source tag: "manual" or "omdb" (optional; default empty) */
+    /** Source tag: "manual", "omdb" or "imdb" (offline title index); optional, default empty */
     std::string source;
     /** IMDb identifier (e.g., tt0133093); empty for manual entries */
     std::string imdbID;
+    /** Unix time the metadata was last fetched from OMDb; 0 = never */
+    long long updatedAt = 0;
     // User ranking fields
     /** Elo-like score for pairwise ranking */
     double userScore = 1500.0;
     /** 1-based rank; -1 means unranked */
     int userRank = -1;
+    /** Bootstrap rank interval (inclusive, 1-based); 0 = not estimated. Not persisted. */
+    int userRankLow = 0;
+    /** Upper end of the bootstrap rank interval; 0 = not estimated. Not persisted. */
+    int userRankHigh = 0;
 };
 
 /**
@@ -85,6 +91,7 @@ inline void to_json(nlohmann::json& j, const Movie& m) {
     if (m.rottenTomatoes > 0) j["rottenTomatoes"] = m.rottenTomatoes;
     if (!m.source.empty()) j["source"] = m.source;
     if (!m.imdbID.empty()) j["imdbID"] = m.imdbID;
+    if (m.updatedAt > 0) j["updatedAt"] = m.updatedAt;
     // Always persist ranking fields for stability across sessions
     j["userScore"] = m.userScore;
     j["userRank"] = m.userRank;
@@ -115,6 +122,7 @@ inline void from_json(const nlohmann::json& j, Movie& m) {
     m.rottenTomatoes = j.value("rottenTomatoes", 0);
     m.source = j.value("source", "");
     m.imdbID = j.value("imdbID", "");
+    m.updatedAt = j.value("updatedAt", 0LL);
     // User ranking fields (default for legacy files)
     m.userScore = j.value("userScore", 1500.0);
     m.userRank = j.value("userRank", -1);
@@ -0,0 +1,433 @@
+// SPDX-License-Identifier: Apache-2.0
+//-------------------------------------------------------------------------------
+// Top100 — Your Personal Movie List
+//
+// File: lib/async.h
+// Purpose: Futures with continuations and cancellation tokens for non-blocking calls.
+// Language: C++17 (header)
+//-------------------------------------------------------------------------------
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Thrown by Future::get() when the operation was cancelled.
+ * @ingroup core
+ */
+class OperationCancelled : public std::runtime_error {
+public:
+    OperationCancelled() : std::runtime_error("operation cancelled") {}
+};
+
+class CancelSource;
+
+/**
+ * @brief Read side of a cancellation flag, passed to asynchronous calls.
+ *
+ * A default-constructed token can never be cancelled. Copies share the flag of
+ * the CancelSource they came from.
+ *
+ * @ingroup core
+ */
+class CancelToken {
+public:
+    CancelToken() = default;
+
+    /** @return true once the source has been cancelled. */
+    bool cancelled() const { return state_ && state_->flag.load(); }
+
+    /** @return true if this token is tied to a CancelSource. */
+    bool canBeCancelled() const { return state_ != nullptr; }
+
+    /**
+     * @brief Run @p fn when the source is cancelled (at once if it already is).
+     * @param fn Callback; runs on the cancelling thread, so keep it short
+     * @return Registration id for forget() (0 if @p fn already ran or can never run)
+     */
+    size_t onCancel(std::function<void()> fn) const {
+        if (!state_) return 0;
+        {
+            std::lock_guard<std::mutex> lock(state_->mutex);
+            if (!state_->flag.load()) {
+                const size_t id = state_->nextId++;
+                state_->callbacks.emplace_back(id, std::move(fn));
+                return id;
+            }
+        }
+        fn();
+        return 0;
+    }
+
+    /** @brief Drop a callback registered with onCancel().
+     *  @param id Registration id */
+    void forget(size_t id) const {
+        if (!state_ || id == 0) return;
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        auto& cbs = state_->callbacks;
+        for (auto it = cbs.begin(); it != cbs.end(); ++it) {
+            if (it->first == id) {
+                cbs.erase(it);
+                return;
+            }
+        }
+    }
+
+private:
+    friend class CancelSource;
+    struct State {
+        std::atomic<bool> flag{false};
+        std::mutex mutex;
+        size_t nextId = 1;
+        std::vector<std::pair<size_t, std::function<void()>>> callbacks;
+    };
+    explicit CancelToken(std::shared_ptr<State> state) : state_(std::move(state)) {}
+
+    std::shared_ptr<State> state_;
+};
+
+/**
+ * @brief Owner of a cancellation flag.
+ *
+ * Hand token() to one or more asynchronous calls; cancel() stops the ones still
+ * running. A typical use is one source per "current" request (e.g. the search
+ * box): cancel it and start a new one whenever the request is superseded.
+ *
+ * @ingroup core
+ */
+class CancelSource {
+public:
+    CancelSource() : state_(std::make_shared<CancelToken::State>()) {}
+
+    /** @return Token observing this source. */
+    CancelToken token() const { return CancelToken(state_); }
+
+    /** @return true once cancel() has been called. */
+    bool cancelled() const { return state_->flag.load(); }
+
+    /** @brief Set the flag and run the registered callbacks (once; later calls are no-ops). */
+    void cancel() {
+        std::vector<std::pair<size_t, std::function<void()>>> cbs;
+        {
+            std::lock_guard<std::mutex> lock(state_->mutex);
+            if (state_->flag.exchange(true)) return;
+            cbs.swap(state_->callbacks);
+        }
+        for (auto& cb : cbs) cb.second();
+    }
+
+private:
+    std::shared_ptr<CancelToken::State> state_;
+};
+
+template <class T> class Future;
+template <class T> class Promise;
+
+namespace async_detail {
+
+template <class T>
+struct State {
+    enum class Status { Pending, Value, Error, Cancelled };
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    Status status = Status::Pending;
+    std::optional<T> value;
+    std::exception_ptr error;
+    std::vector<std::function<void()>> continuations;
+
+    // First completion wins; continuations run on the completing thread
+    template <class Set>
+    bool complete(Status s, Set&& set) {
+        std::vector<std::function<void()>> next;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (status != Status::Pending) return false;
+            set();
+            status = s;
+            next.swap(continuations);
+        }
+        cv.notify_all();
+        for (auto& fn : next) fn();
+        return true;
+    }
+
+    void whenDone(std::function<void()> fn) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (status == Status::Pending) {
+                continuations.push_back(std::move(fn));
+                return;
+            }
+        }
+        fn();
+    }
+};
+
+template <class R> struct IsFuture : std::false_type {};
+template <class U> struct IsFuture<Future<U>> : std::true_type {};
+
+}  // namespace async_detail
+
+/**
+ * @brief Result of an asynchronous operation.
+ *
+ * Completes exactly once with a value, an exception or a cancellation. Results
+ * are consumed either by blocking (get(), wait()) or by attaching
+ * continuations with then(). Copies share the same result. @p T must not be
+ * void.
+ *
+ * @ingroup core
+ */
+template <class T>
+class Future {
+public:
+    using value_type = T;
+
+    Future() = default;
+
+    /** @return true if this future refers to an operation. */
+    bool valid() const { return state_ != nullptr; }
+
+    /** @return true once the operation has completed (any outcome). */
+    bool ready() const {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        return state_->status != State::Status::Pending;
+    }
+
+    /** @return true if the operation completed by being cancelled. */
+    bool cancelled() const {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        return state_->status == State::Status::Cancelled;
+    }
+
+    /** @brief Block until the operation completes. */
+    void wait() const {
+        std::unique_lock<std::mutex> lock(state_->mutex);
+        state_->cv.wait(lock, [this]() { return state_->status != State::Status::Pending; });
+    }
+
+    /**
+     * @brief Block for at most @p timeout.
+     * @param timeout Longest wait
+     * @return true if the operation completed
+     */
+    template <class Rep, class Period>
+    bool waitFor(const std::chrono::duration<Rep, Period>& timeout) const {
+        std::unique_lock<std::mutex> lock(state_->mutex);
+        return state_->cv.wait_for(lock, timeout, [this]() { return state_->status != State::Status::Pending; });
+    }
+
+    /**
+     * @brief Block for the result.
+     * @return The value
+     * @throws The operation's exception, or OperationCancelled
+     * @note Never call this from a continuation: continuations run on the thread
+     *       that completes futures, which would then wait for itself.
+     */
+    T get() const {
+        wait();
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        if (state_->status == State::Status::Error) std::rethrow_exception(state_->error);
+        if (state_->status == State::Status::Cancelled) throw OperationCancelled();
+        return *state_->value;
+    }
+
+    /**
+     * @brief Attach a continuation.
+     *
+     * @p f receives the value and runs on the thread that completes this future
+     * (for network calls, the HTTP event-loop thread), or immediately if the
+     * future is already complete; keep it short and hand UI work to the UI
+     * thread. If this future fails or is cancelled, @p f is skipped and the
+     * outcome passes to the returned future. A continuation returning a Future
+     * is flattened, so steps chain without nesting.
+     *
+     * @param f Callable taking const T&
+     * @return Future for @p f's result
+     */
+    template <class F>
+    auto then(F&& f) const {
+        using R = std::invoke_result_t<std::decay_t<F>, const T&>;
+        if constexpr (async_detail::IsFuture<R>::value) {
+            using U = typename R::value_type;
+            Promise<U> next;
+            Future<U> out = next.future();
+            auto state = state_;
+            state_->whenDone([state, next, f = std::forward<F>(f)]() mutable {
+                if (!forwardFailure(*state, next)) return;
+                try {
+                    R inner = f(*state->value);
+                    inner.state_->whenDone([inner, next]() mutable {
+                        if (!R::forwardFailure(*inner.state_, next)) return;
+                        next.setValue(*inner.state_->value);
+                    });
+                } catch (...) {
+                    next.setError(std::current_exception());
+                }
+            });
+            return out;
+        } else {
+            Promise<R> next;
+            Future<R> out = next.future();
+            auto state = state_;
+            state_->whenDone([state, next, f = std::forward<F>(f)]() mutable {
+                if (!forwardFailure(*state, next)) return;
+                try {
+                    next.setValue(f(*state->value));
+                } catch (...) {
+                    next.setError(std::current_exception());
+                }
+            });
+            return out;
+        }
+    }
+
+    /**
+     * @brief Run @p f once the future completes, whatever the outcome.
+     *
+     * Same threading as then(). Use it where every outcome needs handling (e.g.
+     * to report failure and cancellation too).
+     *
+     * @param f Callable taking the completed future (query it with cancelled() or get())
+     */
+    template <class F>
+    void onComplete(F&& f) const {
+        Future self = *this;
+        state_->whenDone([self, f = std::forward<F>(f)]() mutable { f(self); });
+    }
+
+private:
+    using State = async_detail::State<T>;
+    template <class> friend class Future;
+    template <class> friend class Promise;
+    template <class U> friend Future<std::vector<U>> whenAll(const std::vector<Future<U>>& futures);
+
+    explicit Future(std::shared_ptr<State> state) : state_(std::move(state)) {}
+
+    // Pass an error or cancellation on; @return true if @p s holds a value
+    template <class P>
+    static bool forwardFailure(State& s, P& next) {
+        if (s.status == State::Status::Error) {
+            next.setError(s.error);
+            return false;
+        }
+        if (s.status == State::Status::Cancelled) {
+            next.cancel();
+            return false;
+        }
+        return true;
+    }
+
+    std::shared_ptr<State> state_;
+};
+
+/**
+ * @brief Write side of a Future.
+ *
+ * Copies share the same result; the first setValue(), setError() or cancel()
+ * wins and later ones return false.
+ *
+ * @ingroup core
+ */
+template <class T>
+class Promise {
+public:
+    Promise() : state_(std::make_shared<async_detail::State<T>>()) {}
+
+    /** @return Future observing this promise. */
+    Future<T> future() const { return Future<T>(state_); }
+
+    /** @brief Complete with a value.
+     *  @param value Result
+     *  @return false if already completed */
+    bool setValue(T value) const {
+        return state_->complete(State::Status::Value, [&]() { state_->value.emplace(std::move(value)); });
+    }
+
+    /** @brief Complete with an exception.
+     *  @param error Exception to rethrow from Future::get()
+     *  @return false if already completed */
+    bool setError(std::exception_ptr error) const {
+        return state_->complete(State::Status::Error, [&]() { state_->error = std::move(error); });
+    }
+
+    /** @brief Complete as cancelled.
+     *  @return false if already completed */
+    bool cancel() const {
+        return state_->complete(State::Status::Cancelled, []() {});
+    }
+
+private:
+    using State = async_detail::State<T>;
+    std::shared_ptr<State> state_;
+};
+
+/**
+ * @brief A future that already holds @p value.
+ * @param value Result
+ * @return Completed future
+ * @ingroup core
+ */
+template <class T>
+Future<std::decay_t<T>> readyFuture(T&& value) {
+    Promise<std::decay_t<T>> p;
+    p.setValue(std::forward<T>(value));
+    return p.future();
+}
+
+/**
+ * @brief Combine futures into one that completes when all of them have.
+ *
+ * Fails with the first error, or is cancelled if any input was cancelled
+ * (after every input has completed).
+ *
+ * @param futures Inputs
+ * @return Values in input order
+ * @ingroup core
+ */
+template <class T>
+Future<std::vector<T>> whenAll(const std::vector<Future<T>>& futures) {
+    if (futures.empty()) return readyFuture(std::vector<T>());
+    struct Join {
+        std::mutex mutex;
+        size_t remaining = 0;
+        Promise<std::vector<T>> promise;
+    };
+    auto join = std::make_shared<Join>();
+    join->remaining = futures.size();
+    auto inputs = std::make_shared<std::vector<Future<T>>>(futures);
+    for (const auto& f : futures) {
+        f.state_->whenDone([join, inputs]() {
+            {
+                std::lock_guard<std::mutex> lock(join->mutex);
+                if (--join->remaining > 0) return;
+            }
+            // Last one in: every input is complete, so no locking is needed to read them
+            std::vector<T> values;
+            values.reserve(inputs->size());
+            bool cancelled = false;
+            for (const auto& in : *inputs) {
+                if (in.state_->status == async_detail::State<T>::Status::Error) {
+                    join->promise.setError(in.state_->error);
+                    return;
+                }
+                if (in.state_->status == async_detail::State<T>::Status::Cancelled) cancelled = true;
+                else if (!cancelled) values.push_back(*in.state_->value);
+            }
+            if (cancelled) join->promise.cancel();
+            else join->promise.setValue(std::move(values));
+        });
+    }
+    return join->promise.future();
+}
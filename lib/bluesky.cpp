@@ -14,7 +14,8 @@
  */
 #include "bluesky.h"
 #include "Movie.h"
-#include <cpr/cpr.h>
+#include "http.h"
+#include "poster_cache.h"
 #include <nlohmann/json.hpp>
 #include <sstream>
 #include <iomanip>
@@ -37,13 +38,20 @@ static std::string nowIso8601() {
     return oss.str();
 }
 
-std::optional<BlueSkySession> bskyCreateSession(const std::string& serviceBase,
-                                                const std::string& identifier,
-                                                const std::string& appPassword) {
-    json body{{"identifier", identifier}, {"password", appPassword}};
-    auto r = cpr::Post(cpr::Url{serviceBase + "/xrpc/com.atproto.server.createSession"},
-                       cpr::Header{{"Content-Type", "application/json"}},
-                       cpr::Body{body.dump()});
+// Each call is a request builder plus a response parser, shared by the
+// blocking and the asynchronous variants.
+
+static HttpRequest sessionRequest(const std::string& serviceBase, const std::string& identifier,
+                                  const std::string& appPassword) {
+    HttpRequest req;
+    req.method = HttpRequest::Method::Post;
+    req.url = serviceBase + "/xrpc/com.atproto.server.createSession";
+    req.body = json{{"identifier", identifier}, {"password", appPassword}}.dump();
+    req.header = cpr::Header{{"Content-Type", "application/json"}};
+    return req;
+}
+
+static std::optional<BlueSkySession> sessionOf(const cpr::Response& r) {
     if (r.status_code != 200) return std::nullopt;
     auto j = json::parse(r.text, nullptr, false);
     if (j.is_discarded()) return std::nullopt;
@@ -54,24 +62,26 @@ std::optional<BlueSkySession> bskyCreateSession(const std::string& serviceBase,
     return s;
 }
 
-std::optional<std::string> bskyUploadImage(const std::string& serviceBase,
-                                           const std::string& accessJwt,
-                                           const std::vector<unsigned char>& bytes,
-                                           const std::string& contentType) {
-    auto r = cpr::Post(cpr::Url{serviceBase + "/xrpc/com.atproto.repo.uploadBlob"},
-                       cpr::Header{{"Content-Type", contentType}, {"Authorization", std::string("Bearer ") + accessJwt}},
-                       cpr::Body{std::string(reinterpret_cast<const char*>(bytes.data()), bytes.size())});
+static HttpRequest uploadRequest(const std::string& serviceBase, const std::string& accessJwt,
+                                 const std::vector<unsigned char>& bytes, const std::string& contentType) {
+    HttpRequest req;
+    req.method = HttpRequest::Method::Post;
+    req.url = serviceBase + "/xrpc/com.atproto.repo.uploadBlob";
+    req.body = std::string(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+    req.header = cpr::Header{{"Content-Type", contentType}, {"Authorization", std::string("Bearer ") + accessJwt}};
+    return req;
+}
+
+static std::optional<std::string> blobOf(const cpr::Response& r) {
     if (r.status_code != 200) return std::nullopt;
     auto j = json::parse(r.text, nullptr, false);
     if (j.is_discarded() || !j.contains("blob")) return std::nullopt;
     return j["blob"].dump();
 }
 
-bool bskyCreatePost(const std::string& serviceBase,
-                    const std::string& accessJwt,
-                    const std::string& repoDid,
-                    const std::string& text,
-                    const std::optional<std::string>& imageBlobJson) {
+static HttpRequest postRequest(const std::string& serviceBase, const std::string& accessJwt,
+                               const std::string& repoDid, const std::string& text,
+                               const std::optional<std::string>& imageBlobJson) {
     json record = {
         {"$type", "app.bsky.feed.post"},
         {"text", text},
@@ -90,10 +100,60 @@ bool bskyCreatePost(const std::string& serviceBase,
         {"record", record}
     };
 
-    auto r = cpr::Post(cpr::Url{serviceBase + "/xrpc/com.atproto.repo.createRecord"},
-                       cpr::Header{{"Content-Type", "application/json"}, {"Authorization", std::string("Bearer ") + accessJwt}},
-                       cpr::Body{body.dump()});
-    return r.status_code == 200;
+    HttpRequest req;
+    req.method = HttpRequest::Method::Post;
+    req.url = serviceBase + "/xrpc/com.atproto.repo.createRecord";
+    req.body = body.dump();
+    req.header = cpr::Header{{"Content-Type", "application/json"}, {"Authorization", std::string("Bearer ") + accessJwt}};
+    return req;
+}
+
+std::optional<BlueSkySession> bskyCreateSession(const std::string& serviceBase,
+                                                const std::string& identifier,
+                                                const std::string& appPassword) {
+    return sessionOf(httpClient().perform(sessionRequest(serviceBase, identifier, appPassword)));
+}
+
+Future<std::optional<BlueSkySession>> bskyCreateSessionAsync(const std::string& serviceBase,
+                                                             const std::string& identifier,
+                                                             const std::string& appPassword,
+                                                             CancelToken cancel) {
+    return httpClient().performAsync(sessionRequest(serviceBase, identifier, appPassword), std::move(cancel))
+        .then(sessionOf);
+}
+
+std::optional<std::string> bskyUploadImage(const std::string& serviceBase,
+                                           const std::string& accessJwt,
+                                           const std::vector<unsigned char>& bytes,
+                                           const std::string& contentType) {
+    return blobOf(httpClient().perform(uploadRequest(serviceBase, accessJwt, bytes, contentType)));
+}
+
+Future<std::optional<std::string>> bskyUploadImageAsync(const std::string& serviceBase,
+                                                        const std::string& accessJwt,
+                                                        const std::vector<unsigned char>& bytes,
+                                                        const std::string& contentType,
+                                                        CancelToken cancel) {
+    return httpClient().performAsync(uploadRequest(serviceBase, accessJwt, bytes, contentType), std::move(cancel))
+        .then(blobOf);
+}
+
+bool bskyCreatePost(const std::string& serviceBase,
+                    const std::string& accessJwt,
+                    const std::string& repoDid,
+                    const std::string& text,
+                    const std::optional<std::string>& imageBlobJson) {
+    return httpClient().perform(postRequest(serviceBase, accessJwt, repoDid, text, imageBlobJson)).status_code == 200;
+}
+
+Future<bool> bskyCreatePostAsync(const std::string& serviceBase,
+                                 const std::string& accessJwt,
+                                 const std::string& repoDid,
+                                 const std::string& text,
+                                 const std::optional<std::string>& imageBlobJson,
+                                 CancelToken cancel) {
+    return httpClient().performAsync(postRequest(serviceBase, accessJwt, repoDid, text, imageBlobJson), std::move(cancel))
+        .then([](const cpr::Response& r) { return r.status_code == 200; });
 }
 
 bool bskyPostMovie(const std::string& serviceBase,
@@ -113,15 +173,11 @@ bool bskyPostMovie(const std::string& serviceBase,
 
     std::optional<std::string> blob;
     if (!movie.posterUrl.empty() && movie.posterUrl != "N/A") {
-        auto img = cpr::Get(cpr::Url{movie.posterUrl});
-        if (img.status_code == 200 && !img.text.empty()) {
-            // Try to detect content type; fallback to jpeg
-            std::string contentType = "image/jpeg";
-            auto it = img.header.find("content-type");
-            if (it != img.header.end() && !it->second.empty()) {
-                contentType = it->second;
-            }
-            std::vector<unsigned char> bytes(img.text.begin(), img.text.end());
+        auto img = posterCache()->get(movie.imdbID, movie.posterUrl);
+        if (img && !img->bytes.empty()) {
+            // Sniffed content type; fallback to jpeg
+            std::string contentType = img->mime.compare(0, 6, "image/") == 0 ? img->mime : "image/jpeg";
+            std::vector<unsigned char> bytes(img->bytes.begin(), img->bytes.end());
             blob = bskyUploadImage(serviceBase, session->accessJwt, bytes, contentType);
         }
     }
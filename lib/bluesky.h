@@ -14,6 +14,7 @@
 #include <string>
 #include <optional>
 #include <vector>
+#include "async.h"
 
 struct Movie;
 
@@ -74,6 +75,54 @@ bool bskyCreatePost(const std::string& serviceBase,
                     const std::string& text,
                     const std::optional<std::string>& imageBlobJson);
 
+/**
+ * @brief Non-blocking bskyCreateSession().
+ * @param serviceBase Base URL (e.g., https://bsky.social)
+ * @param identifier Handle or email
+ * @param appPassword App password
+ * @param cancel Cancels the request
+ * @return Future session (std::nullopt on failure)
+ * @ingroup services
+ */
+Future<std::optional<BlueSkySession>> bskyCreateSessionAsync(const std::string& serviceBase,
+                                                             const std::string& identifier,
+                                                             const std::string& appPassword,
+                                                             CancelToken cancel = {});
+
+/**
+ * @brief Non-blocking bskyUploadImage().
+ * @param serviceBase Base URL of the BlueSky service
+ * @param accessJwt Access token returned by bskyCreateSession
+ * @param bytes Raw image bytes
+ * @param contentType MIME type
+ * @param cancel Cancels the upload
+ * @return Future blob JSON (std::nullopt on failure)
+ * @ingroup services
+ */
+Future<std::optional<std::string>> bskyUploadImageAsync(const std::string& serviceBase,
+                                                        const std::string& accessJwt,
+                                                        const std::vector<unsigned char>& bytes,
+                                                        const std::string& contentType,
+                                                        CancelToken cancel = {});
+
+/**
+ * @brief Non-blocking bskyCreatePost().
+ * @param serviceBase Base URL of the BlueSky service
+ * @param accessJwt Access token returned by bskyCreateSession
+ * @param repoDid DID of the repository
+ * @param text Post body text
+ * @param imageBlobJson Optional JSON blob returned by bskyUploadImage
+ * @param cancel Cancels the request
+ * @return Future success flag
+ * @ingroup services
+ */
+Future<bool> bskyCreatePostAsync(const std::string& serviceBase,
+                                 const std::string& accessJwt,
+                                 const std::string& repoDid,
+                                 const std::string& text,
+                                 const std::optional<std::string>& imageBlobJson,
+                                 CancelToken cancel = {});
+
 /**
  * @brief High-level helper: login, optionally upload poster, and post a movie.
  *
@@ -0,0 +1,117 @@
+// SPDX-License-Identifier: Apache-2.0
+//-------------------------------------------------------------------------------
+// Top100 — Your Personal Movie List
+//
+// File: lib/composite_sort.cpp
+// Purpose: Weighted multi-criteria ordering over user and critic scores.
+// Language: C++17 (CMake build)
+//-------------------------------------------------------------------------------
+#include "composite_sort.h"
+#include "Movie.h"
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+CompositeWeights makeCompositeWeights(double user, double imdb, double meta, double rt,
+                                      const std::string& normalisation) {
+    CompositeWeights w;
+    w.userScore = user;
+    w.imdbRating = imdb;
+    w.metascore = meta;
+    w.rottenTomatoes = rt;
+    w.normalisation = normalisation == "minmax" ? ScoreNormalisation::MinMax : ScoreNormalisation::ZScore;
+    return w;
+}
+
+void CompositeIndex::assign(const std::vector<Movie>& movies, ScoreNormalisation norm) {
+    const size_t n = movies.size();
+    const float missing = std::numeric_limits<float>::quiet_NaN();
+    for (auto& c : raw_) c.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        const Movie& m = movies[i];
+        raw_[0][i] = static_cast<float>(m.userScore);
+        raw_[1][i] = m.imdbRating > 0.0 ? static_cast<float>(m.imdbRating) : missing;
+        raw_[2][i] = m.metascore > 0 ? static_cast<float>(m.metascore) : missing;
+        raw_[3][i] = m.rottenTomatoes > 0 ? static_cast<float>(m.rottenTomatoes) : missing;
+    }
+    normalise(norm);
+}
+
+void CompositeIndex::normalise(ScoreNormalisation norm) {
+    norm_ = norm;
+    const size_t n = size();
+    for (size_t c = 0; c < kColumns; ++c) {
+        const std::vector<float>& raw = raw_[c];
+        std::vector<float>& col = cols_[c];
+        col.assign(n, 0.0f);
+        double sum = 0.0, sum2 = 0.0;
+        float lo = std::numeric_limits<float>::infinity(), hi = -lo;
+        size_t present = 0;
+        for (float v : raw) {
+            if (std::isnan(v)) continue;
+            sum += v;
+            sum2 += static_cast<double>(v) * v;
+            lo = std::min(lo, v);
+            hi = std::max(hi, v);
+            ++present;
+        }
+        if (present == 0) continue;
+        const double mean = sum / static_cast<double>(present);
+        float offset, scale;
+        if (norm == ScoreNormalisation::ZScore) {
+            const double var = sum2 / static_cast<double>(present) - mean * mean;
+            const double sd = var > 0.0 ? std::sqrt(var) : 0.0;
+            if (sd == 0.0) continue;           // constant column carries no signal
+            offset = static_cast<float>(mean);
+            scale = static_cast<float>(1.0 / sd);
+        } else {
+            if (hi <= lo) continue;
+            offset = lo;
+            scale = 1.0f / (hi - lo);
+        }
+        const float neutral = (static_cast<float>(mean) - offset) * scale;
+        for (size_t i = 0; i < n; ++i) col[i] = std::isnan(raw[i]) ? neutral : (raw[i] - offset) * scale;
+    }
+}
+
+void CompositeIndex::score(const CompositeWeights& w, std::vector<float>& out) {
+    if (w.normalisation != norm_) normalise(w.normalisation);
+    const size_t n = size();
+    out.resize(n);
+    const float w0 = static_cast<float>(w.userScore), w1 = static_cast<float>(w.imdbRating);
+    const float w2 = static_cast<float>(w.metascore), w3 = static_cast<float>(w.rottenTomatoes);
+    const float* c0 = cols_[0].data();
+    const float* c1 = cols_[1].data();
+    const float* c2 = cols_[2].data();
+    const float* c3 = cols_[3].data();
+    float* o = out.data();
+    for (size_t i = 0; i < n; ++i) o[i] = w0 * c0[i] + w1 * c1[i] + w2 * c2[i] + w3 * c3[i];
+}
+
+void CompositeIndex::order(const CompositeWeights& w, std::vector<uint32_t>& out) {
+    score(w, scores_);
+    const size_t n = scores_.size();
+    // Key: descending-sortable float bits in the high half, index in the low half
+    keys_.resize(n);
+    tmp_.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        uint32_t bits;
+        float f = scores_[i];
+        if (f == 0.0f) f = 0.0f;  // fold -0 into +0
+        std::memcpy(&bits, &f, sizeof(bits));
+        const uint32_t ascending = (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+        keys_[i] = (static_cast<uint64_t>(~ascending) << 32) | static_cast<uint32_t>(i);
+    }
+    // Stable LSD radix sort on the 32 key bits (3 passes of 11 bits); the input
+    // is already in index order, so equal scores keep snapshot order.
+    for (int shift = 32; shift < 64; shift += 11) {
+        size_t counts[2048] = {0};
+        for (uint64_t k : keys_) ++counts[(k >> shift) & 2047u];
+        size_t pos = 0;
+        for (size_t& c : counts) { const size_t cnt = c; c = pos; pos += cnt; }
+        for (uint64_t k : keys_) tmp_[counts[(k >> shift) & 2047u]++] = k;
+        keys_.swap(tmp_);
+    }
+    out.resize(n);
+    for (size_t i = 0; i < n; ++i) out[i] = static_cast<uint32_t>(keys_[i]);
+}
@@ -0,0 +1,107 @@
+// SPDX-License-Identifier: Apache-2.0
+//-------------------------------------------------------------------------------
+// Top100 — Your Personal Movie List
+//
+// File: lib/composite_sort.h
+// Purpose: Weighted multi-criteria ordering over user and critic scores.
+// Language: C++17 (header)
+//-------------------------------------------------------------------------------
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct Movie;
+
+/**
+ * @brief How each score column is put on a common scale before weighting.
+ * @ingroup core
+ */
+enum class ScoreNormalisation {
+    ZScore,   ///< (x - mean) / stddev over movies that have the score
+    MinMax    ///< (x - min) / (max - min) over movies that have the score
+};
+
+/**
+ * @brief Weights for SortOrder::COMPOSITE.
+ *
+ * Each column is normalised first, so weights express relative importance
+ * regardless of scale (Elo ~1500, IMDb 0-10, Metascore/RT 0-100). A missing
+ * critic score (0) counts as that column's average, i.e. it is neutral.
+ *
+ * @ingroup core
+ */
+struct CompositeWeights {
+    /** Weight of userScore (Elo) */
+    double userScore = 1.0;
+    /** Weight of imdbRating */
+    double imdbRating = 1.0;
+    /** Weight of metascore */
+    double metascore = 1.0;
+    /** Weight of rottenTomatoes */
+    double rottenTomatoes = 1.0;
+    /** Column normalisation */
+    ScoreNormalisation normalisation = ScoreNormalisation::ZScore;
+};
+
+/**
+ * @brief Build weights from persisted settings.
+ * @param user Weight of userScore
+ * @param imdb Weight of imdbRating
+ * @param meta Weight of metascore
+ * @param rt Weight of rottenTomatoes
+ * @param normalisation "zscore" (default) or "minmax"
+ * @return Weights
+ * @ingroup core
+ */
+CompositeWeights makeCompositeWeights(double user, double imdb, double meta, double rt,
+                                      const std::string& normalisation);
+
+/**
+ * @brief Column-oriented snapshot of the sortable scores of a movie list.
+ *
+ * assign() extracts and normalises the four score columns into contiguous float
+ * arrays once. order() then only evaluates a weighted sum over those arrays and
+ * radix-sorts the result, so re-weighting (e.g. from a slider) stays far below a
+ * frame even for 100k movies. Changing the normalisation re-normalises in place.
+ *
+ * @ingroup core
+ */
+class CompositeIndex {
+public:
+    /**
+     * @brief Snapshot the score columns of @p movies.
+     * @param movies Movies (order() returns indices into this vector)
+     * @param norm Initial normalisation
+     */
+    void assign(const std::vector<Movie>& movies, ScoreNormalisation norm = ScoreNormalisation::ZScore);
+
+    /** @return Number of movies in the snapshot. */
+    size_t size() const { return raw_[0].size(); }
+
+    /**
+     * @brief Weighted composite score per movie.
+     * @param w Weights (normalisation is applied first if it changed)
+     * @param out Receives one score per movie, higher is better
+     */
+    void score(const CompositeWeights& w, std::vector<float>& out);
+
+    /**
+     * @brief Movie indices ordered best first; ties keep snapshot order.
+     * @param w Weights
+     * @param out Receives a permutation of [0, size())
+     */
+    void order(const CompositeWeights& w, std::vector<uint32_t>& out);
+
+private:
+    static constexpr size_t kColumns = 4;
+    void normalise(ScoreNormalisation norm);
+
+    std::array<std::vector<float>, kColumns> raw_;   // raw values, NaN = missing
+    std::array<std::vector<float>, kColumns> cols_;  // normalised, missing = column mean
+    ScoreNormalisation norm_ = ScoreNormalisation::ZScore;
+    std::vector<float> scores_;
+    std::vector<uint64_t> keys_, tmp_;
+};
@@ -42,6 +42,18 @@ std::string getDefaultDataPath() {
 static void to_json(json& j, const AppConfig& c) {
     j = json{{"dataFile", c.dataFile}, {"omdbEnabled", c.omdbEnabled}};
     if (!c.omdbApiKey.empty()) j["omdbApiKey"] = c.omdbApiKey;
+    j["omdbFetchShortPlot"] = c.omdbFetchShortPlot;
+    j["omdbCacheEnabled"] = c.omdbCacheEnabled;
+    j["omdbCacheRatingsTtlHours"] = c.omdbCacheRatingsTtlHours;
+    j["omdbCacheMetadataTtlDays"] = c.omdbCacheMetadataTtlDays;
+    j["omdbCacheStaleWhileRevalidate"] = c.omdbCacheStaleWhileRevalidate;
+    j["omdbRefreshMaxAgeDays"] = c.omdbRefreshMaxAgeDays;
+    j["omdbRequestsPerSecond"] = c.omdbRequestsPerSecond;
+    j["omdbRefreshConcurrency"] = c.omdbRefreshConcurrency;
+    if (!c.omdbLocalIndexPath.empty()) j["omdbLocalIndexPath"] = c.omdbLocalIndexPath;
+    j["omdbLocalIndexMode"] = c.omdbLocalIndexMode;
+    j["posterCacheMemoryMB"] = c.posterCacheMemoryMB;
+    j["posterCacheDatabaseMB"] = c.posterCacheDatabaseMB;
     // BlueSky fields
     j["blueSkyEnabled"] = c.blueSkyEnabled;
     if (!c.blueSkyIdentifier.empty()) j["blueSkyIdentifier"] = c.blueSkyIdentifier;
@@ -56,12 +68,29 @@ static void to_json(json& j, const AppConfig& c) {
     if (!c.mastodonAccessToken.empty()) j["mastodonAccessToken"] = c.mastodonAccessToken;
     // UI prefs
     j["uiSortOrder"] = c.uiSortOrder;
+    j["sortWeightUserScore"] = c.sortWeightUserScore;
+    j["sortWeightImdbRating"] = c.sortWeightImdbRating;
+    j["sortWeightMetascore"] = c.sortWeightMetascore;
+    j["sortWeightRottenTomatoes"] = c.sortWeightRottenTomatoes;
+    j["sortNormalisation"] = c.sortNormalisation;
 }
 
 static void from_json(const json& j, AppConfig& c) {
     c.dataFile = j.value("dataFile", getDefaultDataPath());
     c.omdbEnabled = j.value("omdbEnabled", false);
     c.omdbApiKey = j.value("omdbApiKey", std::string());
+    c.omdbFetchShortPlot = j.value("omdbFetchShortPlot", true);
+    c.omdbCacheEnabled = j.value("omdbCacheEnabled", true);
+    c.omdbCacheRatingsTtlHours = j.value("omdbCacheRatingsTtlHours", 24);
+    c.omdbCacheMetadataTtlDays = j.value("omdbCacheMetadataTtlDays", 30);
+    c.omdbCacheStaleWhileRevalidate = j.value("omdbCacheStaleWhileRevalidate", true);
+    c.omdbRefreshMaxAgeDays = j.value("omdbRefreshMaxAgeDays", 7);
+    c.omdbRequestsPerSecond = j.value("omdbRequestsPerSecond", 10.0);
+    c.omdbRefreshConcurrency = j.value("omdbRefreshConcurrency", 6);
+    c.omdbLocalIndexPath = j.value("omdbLocalIndexPath", std::string());
+    c.omdbLocalIndexMode = j.value("omdbLocalIndexMode", std::string("fallback"));
+    c.posterCacheMemoryMB = j.value("posterCacheMemoryMB", 64);
+    c.posterCacheDatabaseMB = j.value("posterCacheDatabaseMB", 256);
     // BlueSky fields with sensible defaults
     c.blueSkyEnabled = j.value("blueSkyEnabled", false);
     c.blueSkyIdentifier = j.value("blueSkyIdentifier", std::string());
@@ -76,6 +105,11 @@ static void from_json(const json& j, AppConfig& c) {
     c.mastodonAccessToken = j.value("mastodonAccessToken", std::string());
     // UI prefs
     c.uiSortOrder = j.value("uiSortOrder", 0);
+    c.sortWeightUserScore = j.value("sortWeightUserScore", 1.0);
+    c.sortWeightImdbRating = j.value("sortWeightImdbRating", 1.0);
+    c.sortWeightMetascore = j.value("sortWeightMetascore", 1.0);
+    c.sortWeightRottenTomatoes = j.value("sortWeightRottenTomatoes", 1.0);
+    c.sortNormalisation = j.value("sortNormalisation", std::string("zscore"));
 }
 
 AppConfig loadConfig() {
@@ -24,7 +24,12 @@
  *
  * Field defaults (on first run):
  * - dataFile: "$HOME/top100/top100.db" (directories created automatically, SQLite database)
- * - omdbEnabled: false; omdbApiKey: ""
+ * - omdbEnabled: false; omdbApiKey: ""; omdbFetchShortPlot: true
+ * - omdbCacheEnabled: true; omdbCacheRatingsTtlHours: 24; omdbCacheMetadataTtlDays: 30;
+ *   omdbCacheStaleWhileRevalidate: true
+ * - omdbRefreshMaxAgeDays: 7; omdbRequestsPerSecond: 10; omdbRefreshConcurrency: 6
+ * - omdbLocalIndexPath: "" (no offline index); omdbLocalIndexMode: "fallback"
+ * - posterCacheMemoryMB: 64; posterCacheDatabaseMB: 256
  * - blueSkyEnabled: false; blueSkyService: "https://bsky.social"
  * - mastodonEnabled: false; mastodonInstance: "https://mastodon.social"
  * - postHeaderText: "I’d like to share one of my top 100 #movies!"
@@ -40,6 +45,26 @@ struct AppConfig {
     std::string dataFile;                 ///< Absolute path to your movie database (SQLite .db)
     bool        omdbEnabled = false;      ///< Whether OMDb features are enabled in the UI
     std::string omdbApiKey;               ///< OMDb API key (empty if not configured)
+    bool        omdbFetchShortPlot = true; ///< Fetch OMDb's short plot too (false: derive it from the full plot)
+
+    // OMDb response cache (stored in the data file)
+    bool        omdbCacheEnabled = true;               ///< Cache OMDb responses in the SQLite database
+    int         omdbCacheRatingsTtlHours = 24;         ///< Lifetime of details carrying ratings
+    int         omdbCacheMetadataTtlDays = 30;         ///< Lifetime of searches and short plots
+    bool        omdbCacheStaleWhileRevalidate = true;  ///< Answer from stale entries while refreshing in the background
+
+    // Bulk metadata refresh
+    int         omdbRefreshMaxAgeDays = 7;             ///< Bulk refresh skips movies fetched more recently than this
+    double      omdbRequestsPerSecond = 10.0;          ///< OMDb request rate limit for bulk refresh (<= 0: unlimited)
+    int         omdbRefreshConcurrency = 6;            ///< Lookups in flight during bulk refresh
+
+    // Offline title index built from the IMDb datasets (see top100_imdb_import)
+    std::string omdbLocalIndexPath;                    ///< Index file; empty = none
+    std::string omdbLocalIndexMode = "fallback";       ///< "fallback": when OMDb fails or finds nothing; "prefer": before OMDb
+
+    // Poster cache (decoded posters in memory, image blobs in the data file)
+    int         posterCacheMemoryMB = 64;              ///< Memory budget for decoded posters
+    int         posterCacheDatabaseMB = 256;           ///< Size limit of the posters table; least recently used go first
 
     // BlueSky integration
     bool        blueSkyEnabled = false;   ///< Whether BlueSky posting is enabled
@@ -58,6 +83,13 @@ struct AppConfig {
 
     // UI preferences
     int         uiSortOrder = 0;          ///< Persisted sort order (matches SortOrder enum values)
+
+    // Composite sort (SortOrder::COMPOSITE) weights
+    double      sortWeightUserScore = 1.0;      ///< Weight of your Elo score
+    double      sortWeightImdbRating = 1.0;     ///< Weight of the IMDb rating
+    double      sortWeightMetascore = 1.0;      ///< Weight of the Metascore
+    double      sortWeightRottenTomatoes = 1.0; ///< Weight of the Rotten Tomatoes score
+    std::string sortNormalisation = "zscore";   ///< Column normalisation: "zscore" or "minmax"
 };
 
 /**
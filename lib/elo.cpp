@@ -0,0 +1,73 @@
+// SPDX-License-Identifier: Apache-2.0
+//-------------------------------------------------------------------------------
+// Top100 — Your Personal Movie List
+//
+// File: lib/elo.cpp
+// Purpose: Batched Elo updates scheduled into conflict-free waves.
+// Language: C++17 (CMake build)
+//-------------------------------------------------------------------------------
+#include "elo.h"
+
+void EloBatch::apply(std::vector<double>& scores, const std::vector<EloPair>& pairs, double k) {
+    const size_t movies = scores.size();
+    const size_t count = pairs.size();
+    waves_ = 0;
+    if (count == 0) return;
+
+    // Assign each pair the first wave after every earlier pair touching its movies
+    nextWave_.assign(movies, 0);
+    pairWave_.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        const EloPair& p = pairs[i];
+        if (p.winner >= movies || p.loser >= movies || p.winner == p.loser) {
+            pairWave_[i] = UINT32_MAX;
+            continue;
+        }
+        const uint32_t wave = std::max(nextWave_[p.winner], nextWave_[p.loser]);
+        pairWave_[i] = wave;
+        nextWave_[p.winner] = nextWave_[p.loser] = wave + 1;
+        waves_ = std::max<size_t>(waves_, wave + 1);
+    }
+
+    // Counting sort of pair indices by wave
+    waveStart_.assign(waves_ + 1, 0);
+    for (size_t i = 0; i < count; ++i)
+        if (pairWave_[i] != UINT32_MAX) ++waveStart_[pairWave_[i] + 1];
+    for (size_t w = 0; w < waves_; ++w) waveStart_[w + 1] += waveStart_[w];
+    order_.resize(waveStart_[waves_]);
+    nextWave_.assign(waves_, 0);  // reused as per-wave fill cursor
+    for (size_t i = 0; i < count; ++i) {
+        const uint32_t w = pairWave_[i];
+        if (w == UINT32_MAX) continue;
+        order_[waveStart_[w] + nextWave_[w]++] = static_cast<uint32_t>(i);
+    }
+
+    // Movies within a wave are disjoint, so gather → compute → scatter is exact
+    double* s = scores.data();
+    for (size_t w = 0; w < waves_; ++w) {
+        const uint32_t* lane = order_.data() + waveStart_[w];
+        const size_t width = waveStart_[w + 1] - waveStart_[w];
+        laneA_.resize(std::max(laneA_.size(), width));
+        laneB_.resize(std::max(laneB_.size(), width));
+        double* a = laneA_.data();
+        double* b = laneB_.data();
+        for (size_t j = 0; j < width; ++j) {
+            a[j] = s[pairs[lane[j]].winner];
+            b[j] = s[pairs[lane[j]].loser];
+        }
+        for (size_t j = 0; j < width; ++j) {
+            const double delta = k * (1.0 - eloExpectedFast(a[j], b[j]));
+            a[j] += delta;
+            b[j] -= delta;
+        }
+        for (size_t j = 0; j < width; ++j) {
+            s[pairs[lane[j]].winner] = a[j];
+            s[pairs[lane[j]].loser] = b[j];
+        }
+    }
+}
+
+void eloUpdateBatch(std::vector<double>& scores, const std::vector<EloPair>& pairs, double k) {
+    EloBatch batch;
+    batch.apply(scores, pairs, k);
+}
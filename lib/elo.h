@@ -0,0 +1,125 @@
+// SPDX-License-Identifier: Apache-2.0
+//-------------------------------------------------------------------------------
+// Top100 — Your Personal Movie List
+//
+// File: lib/elo.h
+// Purpose: Elo-style score updates (scalar and batched) shared by the CLI, UIs and core list.
+// Language: C++17 (header)
+//-------------------------------------------------------------------------------
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+/**
+ * @brief Apply one Elo update to a pair of scores.
+ * @param a Score of the first movie (updated in place)
+ * @param b Score of the second movie (updated in place)
+ * @param scoreA 1.0 if the first movie won, 0.0 if it lost
+ * @param k K-factor (step size); 32 matches the historic CLI behaviour
+ * @ingroup core
+ */
+inline void eloUpdate(double& a, double& b, double scoreA, double k = 32.0) {
+    const double qa = std::pow(10.0, a / 400.0);
+    const double qb = std::pow(10.0, b / 400.0);
+    const double ea = qa / (qa + qb);
+    const double eb = qb / (qa + qb);
+    a = a + k * (scoreA - ea);
+    b = b + k * ((1.0 - scoreA) - eb);
+}
+
+/**
+ * @brief Expected score of @p a against @p b without calling std::pow.
+ *
+ * Evaluates 1 / (1 + 10^((b - a) / 400)) as 1 / (1 + 2^n · 2^f) with n rounded
+ * and f in [-0.5, 0.5], using a degree-10 polynomial for 2^f and building 2^n
+ * directly in the exponent bits. The code is branch-free so loops over it
+ * vectorise. Absolute error against the std::pow form is below 1e-12.
+ *
+ * @param a Score of the first movie
+ * @param b Score of the second movie
+ * @return Probability that the first movie wins
+ * @ingroup core
+ */
+inline double eloExpectedFast(double a, double b) {
+    double y = (b - a) * (3.321928094887362347870 / 400.0); // log2(10) / 400
+    y = std::min(std::max(y, -1000.0), 1000.0);
+    const double n = std::floor(y + 0.5);
+    const double f = (y - n) * 0.693147180559945309417;     // ln 2
+    double p = 1.0 / 3628800.0;
+    p = p * f + 1.0 / 362880.0;
+    p = p * f + 1.0 / 40320.0;
+    p = p * f + 1.0 / 5040.0;
+    p = p * f + 1.0 / 720.0;
+    p = p * f + 1.0 / 120.0;
+    p = p * f + 1.0 / 24.0;
+    p = p * f + 1.0 / 6.0;
+    p = p * f + 0.5;
+    p = p * f + 1.0;
+    p = p * f + 1.0;
+    const int64_t bits = (static_cast<int64_t>(n) + 1023) << 52;
+    double scale;
+    std::memcpy(&scale, &bits, sizeof(scale));
+    return 1.0 / (1.0 + p * scale);
+}
+
+/**
+ * @brief One answer in a batch: indices into the score array.
+ * @ingroup core
+ */
+struct EloPair {
+    /** Index of the preferred movie */
+    uint32_t winner;
+    /** Index of the other movie */
+    uint32_t loser;
+};
+
+/**
+ * @brief Reusable workspace for batched Elo updates.
+ *
+ * apply() gives the same result as calling eloUpdate(winner, loser, 1.0, k) for
+ * each pair in order (up to the eloExpectedFast() error). Pairs are scheduled
+ * into waves: a pair goes into the first wave after every earlier pair that
+ * shares one of its movies, so each wave touches disjoint movies. Within a wave
+ * the scores are gathered into contiguous lanes, the expected scores are
+ * computed in one vectorisable loop, and the results are scattered back.
+ *
+ * Keep one instance per thread and reuse it; buffers grow but are not freed.
+ *
+ * @ingroup core
+ */
+class EloBatch {
+public:
+    /**
+     * @brief Apply a sequence of answers to @p scores.
+     * @param scores Score per movie (updated in place)
+     * @param pairs Answers in chronological order; pairs with winner == loser
+     *              or out-of-range indices are ignored
+     * @param k K-factor
+     */
+    void apply(std::vector<double>& scores, const std::vector<EloPair>& pairs, double k = 32.0);
+
+    /** @return Number of waves used by the last apply() (its sequential depth). */
+    size_t waveCount() const { return waves_; }
+
+private:
+    std::vector<uint32_t> nextWave_;   // per movie: first wave it is free in
+    std::vector<uint32_t> pairWave_;   // per pair: assigned wave
+    std::vector<uint32_t> waveStart_;  // counting-sort offsets, waves_ + 1 entries
+    std::vector<uint32_t> order_;      // pair indices grouped by wave
+    std::vector<double> laneA_, laneB_;
+    size_t waves_ = 0;
+};
+
+/**
+ * @brief Convenience wrapper around EloBatch with a temporary workspace.
+ * @param scores Score per movie (updated in place)
+ * @param pairs Answers in chronological order
+ * @param k K-factor
+ * @ingroup core
+ */
+void eloUpdateBatch(std::vector<double>& scores, const std::vector<EloPair>& pairs, double k = 32.0);
@@ -0,0 +1,916 @@
+// SPDX-License-Identifier: Apache-2.0
+//-------------------------------------------------------------------------------
+// Top100 — Your Personal Movie List
+//
+// File: lib/fixture_server.cpp
+// Purpose: Loopback stand-in for OMDb, poster hosts, BlueSky and Mastodon.
+// Language: C++17 (CMake build)
+//-------------------------------------------------------------------------------
+#include "fixture_server.h"
+#include "rate_limit.h"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <list>
+#include <map>
+#include <mutex>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <nlohmann/json.hpp>
+#include <random>
+#include <set>
+#include <sstream>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+namespace {
+
+using json = nlohmann::json;
+namespace fs = std::filesystem;
+
+std::string lower(std::string s) {
+    for (char& c : s) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    return s;
+}
+
+// "  The   MATRIX " -> "the matrix", as the OMDb cache keys searches
+std::string normalizeQuery(const std::string& q) {
+    std::string out;
+    for (char c : q) {
+        if (std::isspace(static_cast<unsigned char>(c))) {
+            if (!out.empty() && out.back() != ' ') out += ' ';
+        } else {
+            out += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        }
+    }
+    if (!out.empty() && out.back() == ' ') out.pop_back();
+    return out;
+}
+
+std::string urlDecode(const std::string& s) {
+    std::string out;
+    out.reserve(s.size());
+    for (size_t i = 0; i < s.size(); ++i) {
+        if (s[i] == '+') {
+            out += ' ';
+        } else if (s[i] == '%' && i + 2 < s.size() && std::isxdigit(static_cast<unsigned char>(s[i + 1])) &&
+                   std::isxdigit(static_cast<unsigned char>(s[i + 2]))) {
+            out += static_cast<char>(std::strtol(s.substr(i + 1, 2).c_str(), nullptr, 16));
+            i += 2;
+        } else {
+            out += s[i];
+        }
+    }
+    return out;
+}
+
+using Params = std::vector<std::pair<std::string, std::string>>;
+
+// Query strings and urlencoded forms; repeated keys (media_ids[]) are kept
+void parseParams(const std::string& text, Params& out) {
+    size_t start = 0;
+    while (start < text.size()) {
+        size_t end = text.find('&', start);
+        if (end == std::string::npos) end = text.size();
+        const std::string pair = text.substr(start, end - start);
+        const size_t eq = pair.find('=');
+        if (!pair.empty()) {
+            out.emplace_back(urlDecode(pair.substr(0, eq)), eq == std::string::npos ? std::string() : urlDecode(pair.substr(eq + 1)));
+        }
+        start = end + 1;
+    }
+}
+
+std::string paramOf(const Params& params, const std::string& key) {
+    for (const auto& [k, v] : params) {
+        if (k == key) return v;
+    }
+    return std::string();
+}
+
+std::string etagOf(const std::string& body) {
+    uint64_t h = 1469598103934665603ull;   // FNV-1a
+    for (unsigned char c : body) h = (h ^ c) * 1099511628211ull;
+    std::ostringstream out;
+    out << "\"" << std::hex << h << "\"";
+    return out.str();
+}
+
+// OMDb's short plot is roughly the first sentence of the full one
+std::string firstSentence(const std::string& plot) {
+    const size_t end = plot.find(". ");
+    return end == std::string::npos ? plot : plot.substr(0, end + 1);
+}
+
+std::string contentTypeOf(const fs::path& p) {
+    const std::string ext = lower(p.extension().string());
+    if (ext == ".jpg" || ext == ".jpeg") return "image/jpeg";
+    if (ext == ".png") return "image/png";
+    if (ext == ".webp") return "image/webp";
+    return "application/octet-stream";
+}
+
+const char* reasonOf(int status) {
+    switch (status) {
+    case 100: return "Continue";
+    case 200: return "OK";
+    case 304: return "Not Modified";
+    case 400: return "Bad Request";
+    case 401: return "Unauthorized";
+    case 404: return "Not Found";
+    case 422: return "Unprocessable Entity";
+    case 429: return "Too Many Requests";
+    case 500: return "Internal Server Error";
+    case 502: return "Bad Gateway";
+    case 503: return "Service Unavailable";
+    case 504: return "Gateway Timeout";
+    default: return "Status";
+    }
+}
+
+// --- PNG posters (stored deflate blocks, so no zlib is needed) ---
+
+uint32_t crc32Of(const unsigned char* data, size_t n, uint32_t crc = 0) {
+    static const auto table = []() {
+        std::vector<uint32_t> t(256);
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; ++k) c = (c & 1u) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            t[i] = c;
+        }
+        return t;
+    }();
+    crc = ~crc;
+    for (size_t i = 0; i < n; ++i) crc = table[(crc ^ data[i]) & 0xFFu] ^ (crc >> 8);
+    return ~crc;
+}
+
+void putBE32(std::string& out, uint32_t v) {
+    for (int shift = 24; shift >= 0; shift -= 8) out += static_cast<char>((v >> shift) & 0xFFu);
+}
+
+void pngChunk(std::string& out, const char* type, const std::string& data) {
+    putBE32(out, static_cast<uint32_t>(data.size()));
+    const std::string typed = std::string(type, 4) + data;
+    out += typed;
+    putBE32(out, crc32Of(reinterpret_cast<const unsigned char*>(typed.data()), typed.size()));
+}
+
+std::string posterPng(int width, int height, unsigned tint) {
+    std::string raw;
+    raw.reserve(static_cast<size_t>(height) * (1 + 3 * static_cast<size_t>(width)));
+    for (int y = 0; y < height; ++y) {
+        raw += '\0';   // filter: none
+        for (int x = 0; x < width; ++x) {
+            raw += static_cast<char>((x * 255 / width + tint * 37u) & 0xFFu);
+            raw += static_cast<char>((y * 255 / height + tint * 91u) & 0xFFu);
+            raw += static_cast<char>((tint * 53u + static_cast<unsigned>(x ^ y)) & 0xFFu);
+        }
+    }
+    std::string z("\x78\x01", 2);
+    uint32_t a = 1, b = 0;
+    for (unsigned char c : raw) {
+        a = (a + c) % 65521u;
+        b = (b + a) % 65521u;
+    }
+    for (size_t pos = 0; pos < raw.size(); pos += 65535) {
+        const size_t len = std::min<size_t>(65535, raw.size() - pos);
+        z += static_cast<char>(pos + len >= raw.size() ? 1 : 0);
+        z += static_cast<char>(len & 0xFFu);
+        z += static_cast<char>(len >> 8);
+        z += static_cast<char>(~len & 0xFFu);
+        z += static_cast<char>((~len >> 8) & 0xFFu);
+        z.append(raw, pos, len);
+    }
+    putBE32(z, (b << 16) | a);
+
+    std::string ihdr;
+    putBE32(ihdr, static_cast<uint32_t>(width));
+    putBE32(ihdr, static_cast<uint32_t>(height));
+    ihdr += std::string("\x08\x02\x00\x00\x00", 5);   // 8-bit RGB
+    std::string png("\x89PNG\r\n\x1a\n", 8);
+    pngChunk(png, "IHDR", ihdr);
+    pngChunk(png, "IDAT", z);
+    pngChunk(png, "IEND", std::string());
+    return png;
+}
+
+struct Request {
+    std::string method;
+    std::string path;
+    Params query;
+    std::map<std::string, std::string> headers;   // lower-case names
+    std::string body;
+    bool keepAlive = true;
+    size_t wireBytes = 0;
+
+    std::string header(const std::string& name) const {
+        auto it = headers.find(name);
+        return it == headers.end() ? std::string() : it->second;
+    }
+};
+
+struct Response {
+    int status = 200;
+    std::string contentType = "application/json";
+    std::string body;
+    Params headers;
+};
+
+Response jsonResponse(int status, const json& j) {
+    Response r;
+    r.status = status;
+    r.body = j.dump();
+    return r;
+}
+
+Response omdbFailure(int status, const char* error) {
+    return jsonResponse(status, json{{"Response", "False"}, {"Error", error}});
+}
+
+// 200 with an ETag, or 304 when the client already holds this body
+Response conditional(const Request& req, const std::string& body, const std::string& etag,
+                     const std::string& contentType, uint64_t& notModified) {
+    Response r;
+    r.contentType = contentType;
+    r.headers.emplace_back("ETag", etag);
+    if (req.header("if-none-match") == etag) {
+        ++notModified;
+        r.status = 304;
+        return r;
+    }
+    r.body = body;
+    return r;
+}
+
+} // namespace
+
+struct FixtureServer::Impl {
+    struct Detail {
+        std::string full, brief, etagFull, etagBrief;
+        std::string title;   // lower-case, for searches
+        json hit;            // entry in search answers
+    };
+    struct Poster {
+        std::shared_ptr<const std::string> bytes;
+        std::string contentType, etag;
+    };
+    struct Connection {
+        int fd = -1;
+        std::thread thread;
+        bool done = false;
+    };
+
+    FixtureServerOptions opts;
+    int listenFd = -1;
+    uint16_t port = 0;
+    std::string error;
+    std::atomic<bool> stopping{false};
+    std::thread acceptor;
+
+    mutable std::mutex mutex;
+    std::list<Connection> connections;
+    std::map<std::string, Detail> details;       // by lower-case imdbID
+    std::vector<std::string> detailOrder;        // insertion order, for searches
+    std::map<std::string, std::string> searches; // "<query>\n<page>"
+    std::map<std::string, Poster> posters;
+    std::set<std::string> mediaIds;
+    FixtureFaults faults;
+    std::shared_ptr<TokenBucket> bucket;
+    std::mt19937 rng;
+    FixtureStats stats;
+    std::vector<FixturePost> posts;
+    uint64_t omdbServed = 0;
+    uint64_t nextId = 1;
+    size_t synthesized = 0;
+
+    std::string baseUrl() const { return "http://127.0.0.1:" + std::to_string(port); }
+
+    void applyFaults(const FixtureFaults& f) {
+        faults = f;
+        bucket = f.rateLimitPerSecond > 0.0 ? std::make_shared<TokenBucket>(f.rateLimitPerSecond, f.rateLimitBurst) : nullptr;
+    }
+
+    // Caller holds the mutex
+    bool addDetail(json j) {
+        if (!j.is_object() || !j.contains("imdbID") || !j["imdbID"].is_string()) return false;
+        if (j.value("Response", "True") == "False") return false;
+        const std::string id = lower(j["imdbID"].get<std::string>());
+        Detail d;
+        d.full = j.dump();
+        if (j.contains("Plot") && j["Plot"].is_string()) j["Plot"] = firstSentence(j["Plot"].get<std::string>());
+        d.brief = j.dump();
+        d.etagFull = etagOf(d.full);
+        d.etagBrief = etagOf(d.brief);
+        d.title = lower(j.value("Title", ""));
+        d.hit = json{{"Title", j.value("Title", "")}, {"Year", j.value("Year", "")}, {"imdbID", j["imdbID"]},
+                     {"Type", j.value("Type", "movie")}, {"Poster", j.value("Poster", "N/A")}};
+        if (details.find(id) == details.end()) detailOrder.push_back(id);
+        details[id] = std::move(d);
+        return true;
+    }
+
+    // --- Connections ---
+
+    bool sleepMs(double ms) {
+        const auto until = std::chrono::steady_clock::now() +
+                           std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double, std::milli>(ms));
+        while (!stopping) {
+            const auto now = std::chrono::steady_clock::now();
+            if (now >= until) return true;
+            std::this_thread::sleep_for(std::min<std::chrono::steady_clock::duration>(until - now, std::chrono::milliseconds(20)));
+        }
+        return false;
+    }
+
+    void acceptLoop() {
+        for (;;) {
+            const int fd = ::accept(listenFd, nullptr, nullptr);
+            if (fd < 0) {
+                if (stopping) return;
+                continue;
+            }
+            int on = 1;
+            ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+#ifdef SO_NOSIGPIPE
+            ::setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+#endif
+            std::list<Connection> finished;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                ++stats.connections;
+                for (auto it = connections.begin(); it != connections.end();) {
+                    auto next = std::next(it);
+                    if (it->done) finished.splice(finished.end(), connections, it);
+                    it = next;
+                }
+                connections.emplace_back();
+                Connection* c = &connections.back();
+                c->fd = fd;
+                c->thread = std::thread([this, c]() { serve(c); });
+            }
+            for (auto& c : finished) {
+                c.thread.join();
+                ::close(c.fd);
+            }
+        }
+    }
+
+    void serve(Connection* c) {
+        std::string buf;
+        Request req;
+        while (!stopping && readRequest(c->fd, buf, req)) {
+            if (!answer(c->fd, req) || !req.keepAlive) break;
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        c->done = true;
+    }
+
+    bool sendAll(int fd, const char* data, size_t n) {
+        while (n > 0) {
+            const ssize_t sent = ::send(fd, data, n, MSG_NOSIGNAL);
+            if (sent <= 0) return false;
+            data += sent;
+            n -= static_cast<size_t>(sent);
+        }
+        return true;
+    }
+
+    bool readRequest(int fd, std::string& buf, Request& req) {
+        char chunk[16384];
+        auto more = [&]() {
+            const ssize_t n = ::recv(fd, chunk, sizeof(chunk), 0);
+            if (n <= 0) return false;
+            buf.append(chunk, static_cast<size_t>(n));
+            return true;
+        };
+        size_t headerEnd;
+        while ((headerEnd = buf.find("\r\n\r\n")) == std::string::npos) {
+            if (buf.size() > 65536 || !more()) return false;
+        }
+        req = Request();
+        std::istringstream head(buf.substr(0, headerEnd));
+        std::string line, target, version;
+        std::getline(head, line);
+        std::istringstream first(line);
+        first >> req.method >> target >> version;
+        while (std::getline(head, line)) {
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            const size_t colon = line.find(':');
+            if (colon == std::string::npos) continue;
+            const size_t v = line.find_first_not_of(' ', colon + 1);
+            req.headers[lower(line.substr(0, colon))] = v == std::string::npos ? std::string() : line.substr(v);
+        }
+        const size_t q = target.find('?');
+        req.path = target.substr(0, q);
+        if (q != std::string::npos) parseParams(target.substr(q + 1), req.query);
+        const std::string connection = lower(req.header("connection"));
+        req.keepAlive = version == "HTTP/1.0" ? connection == "keep-alive" : connection != "close";
+
+        if (lower(req.header("expect")) == "100-continue") {
+            static const char kContinue[] = "HTTP/1.1 100 Continue\r\n\r\n";
+            if (!sendAll(fd, kContinue, sizeof(kContinue) - 1)) return false;
+        }
+        size_t pos = headerEnd + 4;
+        if (lower(req.header("transfer-encoding")).find("chunked") != std::string::npos) {
+            for (;;) {
+                size_t eol;
+                while ((eol = buf.find("\r\n", pos)) == std::string::npos) {
+                    if (!more()) return false;
+                }
+                const size_t len = std::strtoul(buf.substr(pos, eol - pos).c_str(), nullptr, 16);
+                pos = eol + 2;
+                if (len == 0) {
+                    // Trailers end with an empty line
+                    for (;;) {
+                        while ((eol = buf.find("\r\n", pos)) == std::string::npos) {
+                            if (!more()) return false;
+                        }
+                        const bool last = eol == pos;
+                        pos = eol + 2;
+                        if (last) break;
+                    }
+                    break;
+                }
+                while (buf.size() < pos + len + 2) {
+                    if (!more()) return false;
+                }
+                req.body.append(buf, pos, len);
+                pos += len + 2;
+            }
+        } else {
+            const size_t len = std::strtoul(req.header("content-length").c_str(), nullptr, 10);
+            while (buf.size() < pos + len) {
+                if (!more()) return false;
+            }
+            req.body = buf.substr(pos, len);
+            pos += len;
+        }
+        req.wireBytes = pos;
+        buf.erase(0, pos);
+        return true;
+    }
+
+    bool answer(int fd, const Request& req) {
+        FixtureFaults f;
+        std::shared_ptr<TokenBucket> limiter;
+        double delayMs = 0.0;
+        bool inject = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            ++stats.requests;
+            stats.bytesReceived += req.wireBytes;
+            f = faults;
+            limiter = bucket;
+            delayMs = f.latencyMs;
+            if (f.jitterMs > 0) delayMs += std::uniform_real_distribution<double>(0.0, f.jitterMs)(rng);
+            inject = f.errorRate > 0.0 && std::uniform_real_distribution<double>(0.0, 1.0)(rng) < f.errorRate;
+        }
+
+        Response resp;
+        const bool control = req.path == "/stats";
+        if (!control && limiter && !limiter->tryAcquire()) {
+            resp = jsonResponse(429, json{{"error", "RateLimitExceeded"}, {"message", "Too many requests"}});
+            resp.headers.emplace_back("Retry-After", "1");
+            std::lock_guard<std::mutex> lock(mutex);
+            ++stats.rateLimited;
+        } else if (!control && inject) {
+            resp.status = f.errorStatus;
+            resp.contentType = "text/html";
+            resp.body = "<html><body>Injected failure</body></html>";
+            std::lock_guard<std::mutex> lock(mutex);
+            ++stats.injectedErrors;
+        } else {
+            std::lock_guard<std::mutex> lock(mutex);
+            resp = route(req);
+        }
+        if (delayMs > 0.0 && !sleepMs(delayMs)) return false;
+
+        std::ostringstream head;
+        head << "HTTP/1.1 " << resp.status << " " << reasonOf(resp.status) << "\r\n"
+             << "Content-Type: " << resp.contentType << "\r\n"
+             << "Content-Length: " << resp.body.size() << "\r\n";
+        for (const auto& [k, v] : resp.headers) head << k << ": " << v << "\r\n";
+        if (!req.keepAlive) head << "Connection: close\r\n";
+        head << "\r\n";
+        const std::string wire = head.str() + resp.body;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stats.bytesSent += wire.size();
+        }
+        if (f.bytesPerSecond <= 0.0) return sendAll(fd, wire.data(), wire.size());
+
+        // Throttled: small slices, each sent no earlier than the rate allows
+        const size_t slice = std::max<size_t>(512, static_cast<size_t>(f.bytesPerSecond / 50.0));
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t sent = 0; sent < wire.size();) {
+            const size_t n = std::min(slice, wire.size() - sent);
+            if (!sendAll(fd, wire.data() + sent, n)) return false;
+            sent += n;
+            const auto due = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                         std::chrono::duration<double>(static_cast<double>(sent) / f.bytesPerSecond));
+            const double waitMs = std::chrono::duration<double, std::milli>(due - std::chrono::steady_clock::now()).count();
+            if (sent < wire.size() && waitMs > 0.0 && !sleepMs(waitMs)) return false;
+        }
+        return true;
+    }
+
+    // --- Endpoints (caller holds the mutex) ---
+
+    Response route(const Request& req) {
+        const std::string& p = req.path;
+        if (p == "/" || p == "/omdb" || p == "/omdb/") return omdb(req);
+        if (p.rfind("/posters/", 0) == 0) return poster(req, urlDecode(p.substr(9)));
+        if (p.rfind("/xrpc/", 0) == 0) return blueSky(req);
+        if (p.rfind("/api/", 0) == 0) return mastodon(req);
+        if (p == "/stats") return statsAnswer();
+        Response r;
+        r.status = 404;
+        r.contentType = "text/plain";
+        r.body = "Not found";
+        return r;
+    }
+
+    Response omdb(const Request& req) {
+        ++stats.omdb;
+        const std::string key = paramOf(req.query, "apikey");
+        if (key.empty()) return omdbFailure(401, "No API key provided.");
+        if (!opts.omdbApiKey.empty() && key != opts.omdbApiKey) return omdbFailure(401, "Invalid API key!");
+        if (faults.omdbDailyLimit > 0 && omdbServed >= faults.omdbDailyLimit) return omdbFailure(401, "Request limit reached!");
+        ++omdbServed;
+
+        const std::string id = paramOf(req.query, "i");
+        const std::string query = paramOf(req.query, "s");
+        if (!id.empty()) {
+            auto it = details.find(lower(id));
+            if (it == details.end()) return omdbFailure(200, "Incorrect IMDb ID.");
+            const bool brief = paramOf(req.query, "plot") == "short";
+            const Detail& d = it->second;
+            return conditional(req, brief ? d.brief : d.full, brief ? d.etagBrief : d.etagFull, "application/json",
+                               stats.notModified);
+        }
+        if (query.empty()) return omdbFailure(200, "Incorrect IMDb ID.");
+
+        const int page = std::max(1, std::atoi(paramOf(req.query, "page").c_str()));
+        const std::string norm = normalizeQuery(query);
+        std::string body;
+        auto recorded = searches.find(norm + "\n" + std::to_string(page));
+        if (recorded != searches.end()) {
+            body = recorded->second;
+        } else {
+            // Page through the known titles that contain the query
+            json hits = json::array();
+            size_t total = 0;
+            const size_t first = static_cast<size_t>(page - 1) * 10;
+            for (const auto& id2 : detailOrder) {
+                const Detail& d = details[id2];
+                if (d.title.find(norm) == std::string::npos) continue;
+                if (total >= first && hits.size() < 10) hits.push_back(d.hit);
+                ++total;
+            }
+            if (hits.empty()) return omdbFailure(200, "Movie not found!");
+            body = json{{"Search", hits}, {"totalResults", std::to_string(total)}, {"Response", "True"}}.dump();
+        }
+        return conditional(req, body, etagOf(body), "application/json", stats.notModified);
+    }
+
+    Response poster(const Request& req, const std::string& name) {
+        ++stats.posters;
+        auto it = posters.find(name);
+        if (it == posters.end()) {
+            Response r;
+            r.status = 404;
+            r.contentType = "text/plain";
+            r.body = "Not found";
+            return r;
+        }
+        return conditional(req, *it->second.bytes, it->second.etag, it->second.contentType, stats.notModified);
+    }
+
+    bool authorized(const Request& req) const {
+        return req.header("authorization") == "Bearer " + opts.accessToken;
+    }
+
+    Response blueSky(const Request& req) {
+        ++stats.blueSky;
+        const std::string method = req.path.substr(6);
+        const json unauthorized = json{{"error", "AuthenticationRequired"}, {"message", "Invalid token"}};
+        if (method == "com.atproto.server.createSession") {
+            const json in = json::parse(req.body, nullptr, false);
+            if (in.is_discarded() || !in.is_object()) return jsonResponse(400, json{{"error", "InvalidRequest"}});
+            const std::string identifier = in.value("identifier", "");
+            const std::string password = in.value("password", "");
+            if (identifier.empty() || (!opts.blueSkyPassword.empty() && password != opts.blueSkyPassword)) {
+                return jsonResponse(401, json{{"error", "AuthenticationRequired"}, {"message", "Invalid identifier or password"}});
+            }
+            return jsonResponse(200, json{{"accessJwt", opts.accessToken}, {"refreshJwt", opts.accessToken},
+                                          {"did", "did:plc:fixture"}, {"handle", identifier}});
+        }
+        if (!authorized(req)) return jsonResponse(401, unauthorized);
+        if (method == "com.atproto.repo.uploadBlob") {
+            if (req.body.empty()) return jsonResponse(400, json{{"error", "InvalidRequest"}, {"message", "Empty blob"}});
+            const std::string link = "bafkfixture" + std::to_string(nextId++);
+            return jsonResponse(200, json{{"blob", {{"$type", "blob"}, {"ref", {{"$link", link}}},
+                                                    {"mimeType", req.header("content-type")}, {"size", req.body.size()}}}});
+        }
+        if (method == "com.atproto.repo.createRecord") {
+            const json in = json::parse(req.body, nullptr, false);
+            if (in.is_discarded() || !in.contains("record") || !in["record"].is_object()) {
+                return jsonResponse(400, json{{"error", "InvalidRequest"}});
+            }
+            const json& record = in["record"];
+            posts.push_back(FixturePost{"bluesky", record.value("text", ""), record.contains("embed")});
+            const std::string n = std::to_string(nextId++);
+            return jsonResponse(200, json{{"uri", "at://did:plc:fixture/app.bsky.feed.post/" + n}, {"cid", "bafyfixture" + n}});
+        }
+        return jsonResponse(404, json{{"error", "MethodNotImplemented"}});
+    }
+
+    Response mastodon(const Request& req) {
+        ++stats.mastodon;
+        if (!authorized(req)) return jsonResponse(401, json{{"error", "The access token is invalid"}});
+        if (req.path == "/api/v1/accounts/verify_credentials") {
+            return jsonResponse(200, json{{"id", "1"}, {"username", "fixture"}, {"acct", "fixture"}});
+        }
+        if (req.method == "POST" && (req.path == "/api/v1/media" || req.path == "/api/v2/media")) {
+            if (req.body.empty()) return jsonResponse(422, json{{"error", "Validation failed: File can't be blank"}});
+            const std::string id = std::to_string(nextId++);
+            mediaIds.insert(id);
+            return jsonResponse(200, json{{"id", id}, {"type", "image"}});
+        }
+        if (req.method == "POST" && req.path == "/api/v1/statuses") {
+            Params params = req.query;
+            if (lower(req.header("content-type")).rfind("application/x-www-form-urlencoded", 0) == 0) {
+                parseParams(req.body, params);
+            }
+            std::string status;
+            bool withMedia = false;
+            for (const auto& [k, v] : params) {
+                if (k == "status") status = v;
+                if (k == "media_ids[]") {
+                    if (!mediaIds.count(v)) return jsonResponse(422, json{{"error", "Unknown media id"}});
+                    withMedia = true;
+                }
+            }
+            if (status.empty() && !withMedia) return jsonResponse(422, json{{"error", "Validation failed: Text can't be blank"}});
+            posts.push_back(FixturePost{"mastodon", status, withMedia});
+            return jsonResponse(200, json{{"id", std::to_string(nextId++)}, {"content", status}});
+        }
+        return jsonResponse(404, json{{"error", "Record not found"}});
+    }
+
+    Response statsAnswer() const {
+        return jsonResponse(200, json{{"requests", stats.requests}, {"connections", stats.connections},
+                                      {"omdb", stats.omdb}, {"posters", stats.posters}, {"blueSky", stats.blueSky},
+                                      {"mastodon", stats.mastodon}, {"notModified", stats.notModified},
+                                      {"injectedErrors", stats.injectedErrors}, {"rateLimited", stats.rateLimited},
+                                      {"bytesSent", stats.bytesSent}, {"bytesReceived", stats.bytesReceived},
+                                      {"posts", posts.size()}});
+    }
+};
+
+FixtureServer::FixtureServer(FixtureServerOptions opts) : impl_(std::make_unique<Impl>()) {
+    Impl& s = *impl_;
+    s.opts = std::move(opts);
+    s.rng.seed(s.opts.seed);
+    s.applyFaults(s.opts.faults);
+
+    s.listenFd = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (s.listenFd < 0) {
+        s.error = "socket() failed";
+        return;
+    }
+    int on = 1;
+    ::setsockopt(s.listenFd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(s.opts.port);
+    if (::bind(s.listenFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || ::listen(s.listenFd, 128) != 0) {
+        s.error = "cannot listen on 127.0.0.1:" + std::to_string(s.opts.port);
+        ::close(s.listenFd);
+        s.listenFd = -1;
+        return;
+    }
+    socklen_t len = sizeof(addr);
+    ::getsockname(s.listenFd, reinterpret_cast<sockaddr*>(&addr), &len);
+    s.port = ntohs(addr.sin_port);
+    s.acceptor = std::thread([&s]() { s.acceptLoop(); });
+}
+
+FixtureServer::~FixtureServer() {
+    Impl& s = *impl_;
+    if (s.listenFd < 0) return;
+    s.stopping = true;
+    ::shutdown(s.listenFd, SHUT_RDWR);
+    ::close(s.listenFd);
+    s.acceptor.join();
+    std::list<Impl::Connection> all;
+    {
+        std::lock_guard<std::mutex> lock(s.mutex);
+        for (auto& c : s.connections) ::shutdown(c.fd, SHUT_RDWR);
+        all.splice(all.end(), s.connections);
+    }
+    for (auto& c : all) {
+        c.thread.join();
+        ::close(c.fd);
+    }
+}
+
+bool FixtureServer::ok() const {
+    return impl_->listenFd >= 0;
+}
+
+const std::string& FixtureServer::error() const {
+    return impl_->error;
+}
+
+uint16_t FixtureServer::port() const {
+    return impl_->port;
+}
+
+std::string FixtureServer::baseUrl() const {
+    return impl_->baseUrl();
+}
+
+std::string FixtureServer::omdbUrl() const {
+    return impl_->baseUrl() + "/";
+}
+
+std::string FixtureServer::posterUrl(const std::string& name) const {
+    return impl_->baseUrl() + "/posters/" + name;
+}
+
+void FixtureServer::setFaults(const FixtureFaults& faults) {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    impl_->applyFaults(faults);
+}
+
+FixtureFaults FixtureServer::faults() const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    return impl_->faults;
+}
+
+bool FixtureServer::addOmdbDetail(const std::string& body) {
+    json j = json::parse(body, nullptr, false);
+    if (j.is_discarded()) return false;
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    return impl_->addDetail(std::move(j));
+}
+
+void FixtureServer::addOmdbSearch(const std::string& query, int page, const std::string& body) {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    impl_->searches[normalizeQuery(query) + "\n" + std::to_string(std::max(1, page))] = body;
+}
+
+void FixtureServer::addPoster(const std::string& name, std::string bytes, const std::string& contentType) {
+    Impl::Poster p;
+    p.etag = etagOf(bytes);
+    p.bytes = std::make_shared<const std::string>(std::move(bytes));
+    p.contentType = contentType;
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    impl_->posters[name] = std::move(p);
+}
+
+size_t FixtureServer::loadCorpus(const std::string& dir) {
+    auto slurp = [](const fs::path& p) {
+        std::ifstream in(p, std::ios::binary);
+        std::ostringstream ss;
+        ss << in.rdbuf();
+        return ss.str();
+    };
+    std::error_code ec;
+    size_t loaded = 0;
+    std::set<std::string> posterNames;
+    for (const auto& e : fs::directory_iterator(fs::path(dir) / "posters", ec)) {
+        if (!e.is_regular_file()) continue;
+        const std::string name = e.path().filename().string();
+        addPoster(name, slurp(e.path()), contentTypeOf(e.path()));
+        posterNames.insert(name);
+        ++loaded;
+    }
+    for (const auto& e : fs::directory_iterator(fs::path(dir) / "omdb" / "search", ec)) {
+        if (!e.is_regular_file() || e.path().extension() != ".json") continue;
+        // "the_matrix.json" is page 1 of "the matrix", "the_matrix.2.json" page 2
+        std::string stem = e.path().stem().string();
+        int page = 1;
+        const size_t dot = stem.rfind('.');
+        if (dot != std::string::npos && dot + 1 < stem.size() &&
+            std::all_of(stem.begin() + static_cast<std::ptrdiff_t>(dot + 1), stem.end(), [](unsigned char c) { return std::isdigit(c); })) {
+            page = std::atoi(stem.c_str() + dot + 1);
+            stem.erase(dot);
+        }
+        std::replace(stem.begin(), stem.end(), '_', ' ');
+        addOmdbSearch(stem, page, slurp(e.path()));
+        ++loaded;
+    }
+    for (const auto& e : fs::directory_iterator(fs::path(dir) / "omdb", ec)) {
+        if (!e.is_regular_file() || e.path().extension() != ".json") continue;
+        json j = json::parse(slurp(e.path()), nullptr, false);
+        if (j.is_discarded() || !j.is_object()) continue;
+        // Recorded poster URLs point at the real hosts; serve our copies instead
+        if (j.contains("Poster") && j["Poster"].is_string()) {
+            const std::string url = j["Poster"].get<std::string>();
+            const std::string name = url.substr(url.rfind('/') + 1);
+            if (posterNames.count(name)) j["Poster"] = posterUrl(name);
+        }
+        std::lock_guard<std::mutex> lock(impl_->mutex);
+        if (impl_->addDetail(std::move(j))) ++loaded;
+    }
+    return loaded;
+}
+
+std::vector<std::string> FixtureServer::synthesize(size_t titles, int posterWidth) {
+    static const char* kWords[] = {"Dark", "Night", "Return", "King", "Star", "Lost", "City", "Last", "Blue",
+                                   "Road", "Silent", "Iron", "Garden", "River", "Ghost", "Empire"};
+    static const char* kPeople[] = {"Christopher Nolan", "Sofia Coppola", "Akira Kurosawa", "Greta Gerwig",
+                                    "Denis Villeneuve", "Agnes Varda", "Bong Joon Ho", "Kathryn Bigelow",
+                                    "Keanu Reeves", "Tilda Swinton", "Toshiro Mifune", "Frances McDormand"};
+    static const char* kGenres[] = {"Action", "Drama", "Sci-Fi", "Comedy", "Crime", "Thriller", "Romance"};
+    constexpr size_t kWordCount = sizeof(kWords) / sizeof(kWords[0]);
+    constexpr size_t kPeopleCount = sizeof(kPeople) / sizeof(kPeople[0]);
+    constexpr size_t kGenreCount = sizeof(kGenres) / sizeof(kGenres[0]);
+    constexpr unsigned kDistinctPosters = 16;
+
+    std::vector<std::shared_ptr<const std::string>> images;
+    if (posterWidth > 0) {
+        for (unsigned k = 0; k < kDistinctPosters && k < titles; ++k) {
+            images.push_back(std::make_shared<const std::string>(posterPng(posterWidth, posterWidth * 3 / 2, k)));
+        }
+    }
+    size_t base;
+    {
+        std::lock_guard<std::mutex> lock(impl_->mutex);
+        base = impl_->synthesized;
+        impl_->synthesized += titles;
+    }
+    std::vector<std::string> ids;
+    ids.reserve(titles);
+    for (size_t n = 0; n < titles; ++n) {
+        const size_t i = base + n;
+        const std::string id = "tt" + std::to_string(9000000 + i);
+        std::string actors;
+        for (size_t k = 0; k < 4; ++k) actors += std::string(k ? ", " : "") + kPeople[(i + 3 * k + 1) % kPeopleCount];
+        std::string poster = "N/A";
+        if (!images.empty()) {
+            const std::string name = id + ".png";
+            Impl::Poster p;
+            p.bytes = images[i % images.size()];
+            p.contentType = "image/png";
+            p.etag = etagOf(name);
+            std::lock_guard<std::mutex> lock(impl_->mutex);
+            impl_->posters[name] = std::move(p);
+            poster = posterUrl(name);
+        }
+        json j = {
+            {"Title", std::string(kWords[i % kWordCount]) + " " + kWords[(i / kWordCount + 7) % kWordCount] +
+                          (i >= kWordCount * kWordCount ? " " + std::to_string(i / (kWordCount * kWordCount) + 1) : "")},
+            {"Year", std::to_string(1950 + i % 75)},
+            {"Rated", "PG-13"},
+            {"Released", "14 Jul 2008"},
+            {"Runtime", std::to_string(85 + i % 90) + " min"},
+            {"Genre", std::string(kGenres[i % kGenreCount]) + ", " + kGenres[(i + 2) % kGenreCount]},
+            {"Director", kPeople[i % kPeopleCount]},
+            {"Writer", kPeople[(i + 5) % kPeopleCount]},
+            {"Actors", actors},
+            {"Plot", "A stranger arrives in a quiet town. Nothing is the same after that long and strange summer."},
+            {"Language", "English"},
+            {"Country", "United States, United Kingdom"},
+            {"Awards", "N/A"},
+            {"Poster", poster},
+            {"Ratings", json::array({json{{"Source", "Internet Movie Database"}, {"Value", "7.5/10"}},
+                                     json{{"Source", "Rotten Tomatoes"}, {"Value", std::to_string(i % 101) + "%"}},
+                                     json{{"Source", "Metacritic"}, {"Value", std::to_string(i % 100) + "/100"}}})},
+            {"Metascore", std::to_string(i % 100)},
+            {"imdbRating", std::to_string(1 + i % 9) + "." + std::to_string(i % 10)},
+            {"imdbVotes", std::to_string(1000 + i * 37)},
+            {"imdbID", id},
+            {"Type", "movie"},
+            {"Response", "True"},
+        };
+        std::lock_guard<std::mutex> lock(impl_->mutex);
+        impl_->addDetail(std::move(j));
+        ids.push_back(id);
+    }
+    return ids;
+}
+
+FixtureStats FixtureServer::stats() const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    return impl_->stats;
+}
+
+std::vector<FixturePost> FixtureServer::posts() const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    return impl_->posts;
+}
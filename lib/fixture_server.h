@@ -0,0 +1,216 @@
+// SPDX-License-Identifier: Apache-2.0
+//-------------------------------------------------------------------------------
+// Top100 — Your Personal Movie List
+//
+// File: lib/fixture_server.h
+// Purpose: Loopback stand-in for OMDb, poster hosts, BlueSky and Mastodon.
+// Language: C++17 (header)
+//-------------------------------------------------------------------------------
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Faults the fixture injects into its answers.
+ *
+ * All of them can be changed while the server runs (see FixtureServer::setFaults()).
+ *
+ * @ingroup services
+ */
+struct FixtureFaults {
+    /** Delay before every response, in milliseconds */
+    int latencyMs = 0;
+    /** Extra random delay of up to this many milliseconds */
+    int jitterMs = 0;
+    /** Response throughput per connection in bytes per second, 0 = unlimited */
+    double bytesPerSecond = 0.0;
+    /** Fraction of requests (0..1) answered with @c errorStatus */
+    double errorRate = 0.0;
+    /** Status of injected errors */
+    int errorStatus = 503;
+    /** Requests per second before answering 429, 0 = unlimited */
+    double rateLimitPerSecond = 0.0;
+    /** Requests allowed in a burst by the rate limit */
+    double rateLimitBurst = 1.0;
+    /** OMDb requests before "Request limit reached!", 0 = unlimited */
+    uint64_t omdbDailyLimit = 0;
+};
+
+/**
+ * @brief How a FixtureServer starts.
+ * @ingroup services
+ */
+struct FixtureServerOptions {
+    /** Port on 127.0.0.1; 0 picks a free one */
+    uint16_t port = 0;
+    /** OMDb key the server accepts; empty accepts any non-empty key */
+    std::string omdbApiKey;
+    /** Bearer token for BlueSky (returned as accessJwt) and Mastodon */
+    std::string accessToken = "fixture-token";
+    /** BlueSky app password; empty accepts any */
+    std::string blueSkyPassword;
+    /** Faults in effect from the start */
+    FixtureFaults faults;
+    /** Seed for jitter and error injection */
+    uint32_t seed = 1;
+};
+
+/**
+ * @brief Request counters.
+ * @ingroup services
+ */
+struct FixtureStats {
+    /** Requests received (all endpoints) */
+    uint64_t requests = 0;
+    /** Connections accepted; requests - connections were kept-alive reuses */
+    uint64_t connections = 0;
+    /** OMDb requests */
+    uint64_t omdb = 0;
+    /** Poster downloads */
+    uint64_t posters = 0;
+    /** BlueSky calls */
+    uint64_t blueSky = 0;
+    /** Mastodon calls */
+    uint64_t mastodon = 0;
+    /** 304 answers to If-None-Match */
+    uint64_t notModified = 0;
+    /** Answers replaced by an injected error */
+    uint64_t injectedErrors = 0;
+    /** 429 answers */
+    uint64_t rateLimited = 0;
+    /** Response bytes written (headers included) */
+    uint64_t bytesSent = 0;
+    /** Request bytes read (headers included) */
+    uint64_t bytesReceived = 0;
+};
+
+/**
+ * @brief A post the fixture accepted.
+ * @ingroup services
+ */
+struct FixturePost {
+    /** "bluesky" or "mastodon" */
+    std::string service;
+    /** Post text */
+    std::string text;
+    /** Whether an uploaded image was attached */
+    bool withMedia = false;
+};
+
+/**
+ * @brief HTTP/1.1 keep-alive server on 127.0.0.1 that answers like the real services.
+ *
+ * Endpoints, all relative to baseUrl():
+ * - @c /?apikey=&i=|s= — OMDb detail (plot=full|short) and search (page=) answers,
+ *   with ETags and 304 revalidation. Searches without a recorded answer match
+ *   titles of the known details.
+ * - @c /posters/<name> — poster images.
+ * - @c /xrpc/com.atproto.server.createSession, @c .repo.uploadBlob, @c .repo.createRecord — BlueSky.
+ * - @c /api/v1/accounts/verify_credentials, @c /api/v1/media, @c /api/v2/media, @c /api/v1/statuses — Mastodon.
+ * - @c /stats — FixtureStats as JSON.
+ *
+ * Point the clients at it with omdbSetBaseUrl(baseUrl()) and by using
+ * baseUrl() as the BlueSky service and Mastodon instance. Each connection is
+ * served by its own thread. Not available on Windows.
+ *
+ * @ingroup services
+ */
+class FixtureServer {
+public:
+    /**
+     * @brief Bind and start serving.
+     * @param opts Port, credentials and initial faults
+     */
+    explicit FixtureServer(FixtureServerOptions opts = FixtureServerOptions());
+    /** Stops the server and closes every connection. */
+    ~FixtureServer();
+    FixtureServer(const FixtureServer&) = delete;
+    FixtureServer& operator=(const FixtureServer&) = delete;
+
+    /** @return true if the socket is listening */
+    bool ok() const;
+    /** @return Why the server did not start (empty when ok()) */
+    const std::string& error() const;
+    /** @return Bound port */
+    uint16_t port() const;
+    /** @return "http://127.0.0.1:<port>" */
+    std::string baseUrl() const;
+    /** @return URL OMDb clients use ("<baseUrl>/") */
+    std::string omdbUrl() const;
+    /**
+     * @brief URL of a poster.
+     * @param name Poster name
+     * @return "<baseUrl>/posters/<name>"
+     */
+    std::string posterUrl(const std::string& name) const;
+
+    /**
+     * @brief Replace the injected faults.
+     * @param faults New faults (the rate limit bucket starts full)
+     */
+    void setFaults(const FixtureFaults& faults);
+    /** @return Faults in effect */
+    FixtureFaults faults() const;
+
+    /**
+     * @brief Serve an OMDb detail response.
+     *
+     * Keyed by its imdbID. The short-plot variant keeps the first sentence of
+     * "Plot".
+     *
+     * @param body Recorded response ({"Response":"True",...})
+     * @return false if @p body is not a detail response
+     */
+    bool addOmdbDetail(const std::string& body);
+    /**
+     * @brief Serve a recorded OMDb search response.
+     * @param query Search text (matched case- and space-insensitively)
+     * @param page Page number (1-based)
+     * @param body Recorded response
+     */
+    void addOmdbSearch(const std::string& query, int page, const std::string& body);
+    /**
+     * @brief Serve a poster.
+     * @param name Name under /posters/
+     * @param bytes Image data
+     * @param contentType e.g. "image/jpeg"
+     */
+    void addPoster(const std::string& name, std::string bytes, const std::string& contentType);
+
+    /**
+     * @brief Load recorded responses.
+     *
+     * Layout: @c omdb/<any>.json detail responses, @c omdb/search/<query>.json
+     * search responses (spaces as '_', @c <query>.<page>.json for later pages)
+     * and @c posters/<name> images. Poster URLs in the details whose file name
+     * is among the posters are rewritten to posterUrl().
+     *
+     * @param dir Corpus directory
+     * @return Number of files loaded
+     */
+    size_t loadCorpus(const std::string& dir);
+
+    /**
+     * @brief Generate detail responses for @p titles made-up movies.
+     *
+     * IDs are tt9000000, tt9000001, ... With @p posterWidth > 0 every title
+     * gets a PNG poster (width x 1.5 width; at most 16 distinct images).
+     *
+     * @param titles Number of movies
+     * @param posterWidth Poster width in pixels, 0 = no posters ("N/A")
+     * @return The generated IDs
+     */
+    std::vector<std::string> synthesize(size_t titles, int posterWidth = 0);
+
+    /** @return Counters since start */
+    FixtureStats stats() const;
+    /** @return Posts accepted so far, oldest first */
+    std::vector<FixturePost> posts() const;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
@@ -0,0 +1,492 @@
+// SPDX-License-Identifier: Apache-2.0
+//-------------------------------------------------------------------------------
+// Top100 — Your Personal Movie List
+//
+// File: lib/http.cpp
+// Purpose: Pooled keep-alive HTTP client shared by the network services.
+// Language: C++17 (CMake build)
+//-------------------------------------------------------------------------------
+#include "http.h"
+#include <algorithm>
+#include <cctype>
+#include <atomic>
+#include <curl/curl.h>
+#include <thread>
+
+// libcurl share handle: one DNS cache, TLS session cache and connection pool
+// for every session the client creates.
+struct HttpClient::Shared {
+    CURLSH* share = nullptr;
+    std::mutex locks[CURL_LOCK_DATA_LAST];
+
+    Shared() {
+        curl_global_init(CURL_GLOBAL_DEFAULT);
+        share = curl_share_init();
+        curl_share_setopt(share, CURLSHOPT_LOCKFUNC, &Shared::lock);
+        curl_share_setopt(share, CURLSHOPT_UNLOCKFUNC, &Shared::unlock);
+        curl_share_setopt(share, CURLSHOPT_USERDATA, this);
+        curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+        curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+        curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT);
+    }
+    ~Shared() {
+        curl_share_cleanup(share);
+        curl_global_cleanup();
+    }
+
+    static void lock(CURL*, curl_lock_data data, curl_lock_access, void* user) {
+        static_cast<Shared*>(user)->locks[data].lock();
+    }
+    static void unlock(CURL*, curl_lock_data data, void* user) {
+        static_cast<Shared*>(user)->locks[data].unlock();
+    }
+};
+
+// Sessions that carry a request body are pooled apart from GET sessions: cpr
+// keeps a body on the session and would otherwise send it with a later GET.
+static std::string poolKey(const std::string& host, HttpRequest::Method method) {
+    return (method == HttpRequest::Method::Post ? "POST " : "GET ") + host;
+}
+
+// Event loop behind performAsync(): one thread and one multi handle drive every
+// asynchronous transfer. Other threads only queue work and wake the loop.
+struct HttpClient::Loop : std::enable_shared_from_this<HttpClient::Loop> {
+    struct Transfer {
+        std::shared_ptr<cpr::Session> session;
+        std::string host;
+        std::string key;
+        Promise<cpr::Response> promise;
+        CancelToken cancel;
+        size_t cancelId = 0;
+    };
+
+    HttpClient& owner;
+    CURLM* multi = nullptr;
+    std::mutex mutex;
+    std::vector<Transfer> incoming;   // guarded by mutex
+    bool stopping = false;            // guarded by mutex
+    std::map<CURL*, Transfer> active; // loop thread only
+    std::atomic<size_t> pending{0};
+    std::thread thread;
+
+    explicit Loop(HttpClient& client) : owner(client), multi(curl_multi_init()) {}
+
+    ~Loop() {
+        stop();
+        curl_multi_cleanup(multi);
+    }
+
+    void start() {
+        thread = std::thread([this]() { run(); });
+    }
+
+    // Cancel everything still queued or in flight and join the thread
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        curl_multi_wakeup(multi);
+        if (thread.joinable() && thread.get_id() != std::this_thread::get_id()) thread.join();
+    }
+
+    void submit(Transfer t) {
+        bool accepted = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!stopping) {
+                // Wake the loop when the caller gives up, so the transfer stops promptly
+                std::weak_ptr<Loop> weak = shared_from_this();
+                t.cancelId = t.cancel.onCancel([weak]() {
+                    if (auto self = weak.lock()) curl_multi_wakeup(self->multi);
+                });
+                ++pending;
+                incoming.push_back(std::move(t));
+                accepted = true;
+            }
+        }
+        if (!accepted) {
+            t.promise.cancel();   // client shutting down
+            return;
+        }
+        curl_multi_wakeup(multi);
+    }
+
+    void finish(Transfer& t, cpr::Response* r) {
+        t.cancel.forget(t.cancelId);
+        --pending;
+        if (r) t.promise.setValue(std::move(*r));
+        else t.promise.cancel();
+    }
+
+    void run() {
+        for (;;) {
+            std::vector<Transfer> fresh;
+            bool stop;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                fresh.swap(incoming);
+                stop = stopping;
+            }
+            if (stop) {
+                for (auto& t : fresh) finish(t, nullptr);
+                for (auto& kv : active) {
+                    curl_multi_remove_handle(multi, kv.first);
+                    finish(kv.second, nullptr);
+                }
+                active.clear();
+                return;
+            }
+            for (auto& t : fresh) {
+                if (t.cancel.cancelled()) {
+                    finish(t, nullptr);
+                    continue;
+                }
+                CURL* handle = t.session->GetCurlHolder()->handle;
+                curl_multi_add_handle(multi, handle);
+                active.emplace(handle, std::move(t));
+            }
+            int running = 0;
+            curl_multi_perform(multi, &running);
+            int queued = 0;
+            while (CURLMsg* msg = curl_multi_info_read(multi, &queued)) {
+                if (msg->msg != CURLMSG_DONE) continue;
+                CURL* handle = msg->easy_handle;
+                const CURLcode code = msg->data.result;   // msg is invalid once the handle is removed
+                auto it = active.find(handle);
+                if (it == active.end()) continue;
+                Transfer t = std::move(it->second);
+                active.erase(it);
+                curl_multi_remove_handle(multi, handle);
+                cpr::Response r = t.session->Complete(code);
+                owner.record(t.host, *t.session, r);
+                if (!r.error) owner.release(t.key, t.session);
+                finish(t, &r);
+            }
+            // Superseded requests: abort the transfer; the connection is not reused
+            for (auto it = active.begin(); it != active.end();) {
+                if (!it->second.cancel.cancelled()) {
+                    ++it;
+                    continue;
+                }
+                curl_multi_remove_handle(multi, it->first);
+                Transfer t = std::move(it->second);
+                it = active.erase(it);
+                finish(t, nullptr);
+            }
+            curl_multi_poll(multi, nullptr, 0, 1000, nullptr);
+        }
+    }
+};
+
+HttpClient::HttpClient(HttpClientOptions opts) : opts_(opts), shared_(std::make_unique<Shared>()) {}
+
+HttpClient::~HttpClient() {
+    // Stop the event loop first: its transfers use pooled sessions and the share handle
+    std::shared_ptr<Loop> loop;
+    {
+        std::lock_guard<std::mutex> lock(loopMutex_);
+        loop.swap(loop_);
+    }
+    if (loop) loop->stop();
+    // Sessions must detach from the share handle before it is cleaned up
+    idle_.clear();
+    shared_.reset();
+}
+
+std::shared_ptr<HttpClient::Loop> HttpClient::loop() {
+    std::lock_guard<std::mutex> lock(loopMutex_);
+    if (!loop_) {
+        loop_ = std::make_shared<Loop>(*this);
+        loop_->start();
+    }
+    return loop_;
+}
+
+void HttpClient::setOptions(const HttpClientOptions& opts) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    opts_ = opts;
+    idle_.clear();
+}
+
+HttpClientOptions HttpClient::options() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return opts_;
+}
+
+std::string HttpClient::hostKey(const std::string& url) {
+    const size_t scheme = url.find("://");
+    if (scheme == std::string::npos) return std::string();
+    const size_t end = url.find_first_of("/?#", scheme + 3);
+    std::string key = url.substr(0, end);
+    std::transform(key.begin(), key.end(), key.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return key;
+}
+
+std::shared_ptr<cpr::Session> HttpClient::acquire(const std::string& key) {
+    HttpClientOptions opts;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto& idle = idle_[key];
+        if (!idle.empty()) {
+            auto s = std::move(idle.back());
+            idle.pop_back();
+            return s;
+        }
+        opts = opts_;
+        ++stats_[key.substr(key.find(' ') + 1)].sessions;
+    }
+    // Connection-level settings are fixed for the lifetime of a session
+    auto s = std::make_shared<cpr::Session>();
+    CURL* handle = s->GetCurlHolder()->handle;
+    curl_easy_setopt(handle, CURLOPT_SHARE, shared_->share);
+    curl_easy_setopt(handle, CURLOPT_TCP_KEEPALIVE, 1L);
+    if (opts.http2) {
+        s->SetHttpVersion(cpr::HttpVersion{cpr::HttpVersionCode::VERSION_2_0_TLS});
+        // Wait for a connection that can multiplex rather than opening another
+        curl_easy_setopt(handle, CURLOPT_PIPEWAIT, 1L);
+    }
+    if (opts.compressed) s->SetAcceptEncoding(cpr::AcceptEncoding{"gzip", "deflate"});
+    if (opts.connectTimeoutMs > 0) s->SetConnectTimeout(cpr::ConnectTimeout{opts.connectTimeoutMs});
+    return s;
+}
+
+void HttpClient::release(const std::string& key, std::shared_ptr<cpr::Session> session) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& idle = idle_[key];
+    if (idle.size() < opts_.maxIdlePerHost) idle.push_back(std::move(session));
+}
+
+void HttpClient::prepare(cpr::Session& s, const HttpRequest& req) const {
+    // Every per-request field is set on each use so nothing leaks between leases
+    s.SetUrl(cpr::Url{req.url});
+    s.SetParameters(req.parameters);
+    s.SetHeader(req.header);
+    std::int32_t timeout = req.timeoutMs;
+    if (timeout <= 0) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        timeout = opts_.timeoutMs;
+    }
+    s.SetTimeout(cpr::Timeout{std::max<std::int32_t>(timeout, 0)});
+    if (req.method == HttpRequest::Method::Post) {
+        if (req.multipart) s.SetMultipart(*req.multipart);
+        else s.SetBody(cpr::Body{req.body.value_or(std::string())});
+    }
+}
+
+void HttpClient::record(const std::string& host, cpr::Session& s, const cpr::Response& r) {
+    long connects = 0;
+    curl_easy_getinfo(s.GetCurlHolder()->handle, CURLINFO_NUM_CONNECTS, &connects);
+    std::lock_guard<std::mutex> lock(mutex_);
+    HttpHostStats& st = stats_[host];
+    ++st.requests;
+    if (r.status_code == 0) ++st.failures;
+    st.connections += static_cast<uint64_t>(connects);
+    st.totalSeconds += r.elapsed;
+    st.maxSeconds = std::max(st.maxSeconds, r.elapsed);
+}
+
+std::optional<std::string> HttpClient::flightKey(const HttpRequest& req) const {
+    if (req.method != HttpRequest::Method::Get) return std::nullopt;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!opts_.coalesce) return std::nullopt;
+    }
+    // Everything that can change the response: URL, query, headers and timeout
+    static thread_local cpr::CurlHolder holder;
+    std::string key = req.url;
+    key += '?';
+    key += req.parameters.GetContent(holder);
+    for (const auto& kv : req.header) {
+        key += '\n';
+        key += kv.first;
+        key += ':';
+        key += kv.second;
+    }
+    key += "\n#" + std::to_string(req.timeoutMs);
+    return key;
+}
+
+bool HttpClient::onLoopThread() const {
+    std::lock_guard<std::mutex> lock(loopMutex_);
+    return loop_ && loop_->thread.get_id() == std::this_thread::get_id();
+}
+
+void HttpClient::countCoalesced(const std::string& url) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++stats_[hostKey(url)].coalesced;
+}
+
+cpr::Response HttpClient::transfer(const HttpRequest& req) {
+    const std::string host = hostKey(req.url);
+    const std::string key = poolKey(host, req.method);
+    auto s = acquire(key);
+    prepare(*s, req);
+    cpr::Response r = req.method == HttpRequest::Method::Post ? s->Post() : s->Get();
+    record(host, *s, r);
+    // A transport error may leave the handle mid-state; don't pool it
+    if (!r.error) release(key, std::move(s));
+    return r;
+}
+
+cpr::Response HttpClient::perform(const HttpRequest& req) {
+    // A continuation blocking the event loop must not wait for a flight it drives
+    const auto key = onLoopThread() ? std::nullopt : flightKey(req);
+    if (!key) return transfer(req);
+    bool joined = false;
+    try {
+        cpr::Response r = flights_.run(*key, [&] { return transfer(req); }, &joined);
+        if (joined) countCoalesced(req.url);
+        return r;
+    } catch (const OperationCancelled&) {
+        // Joined an asynchronous flight whose callers all gave up; go on alone
+        return transfer(req);
+    }
+}
+
+std::vector<cpr::Response> HttpClient::performAll(const std::vector<HttpRequest>& reqs) {
+    if (reqs.empty()) return {};
+    if (reqs.size() == 1) return {perform(reqs.front())};
+
+    // Duplicates, within the batch or of a request already in flight, wait
+    // for the leader instead of being transferred
+    using Flight = SingleFlight<std::string, cpr::Response>::Flight;
+    std::vector<std::optional<std::string>> flightKeys(reqs.size());
+    std::vector<std::optional<Flight>> flights(reqs.size());
+    std::vector<size_t> leaders;
+    const bool coalesce = !onLoopThread();
+    for (size_t i = 0; i < reqs.size(); ++i) {
+        if (coalesce) flightKeys[i] = flightKey(reqs[i]);
+        if (flightKeys[i]) flights[i] = flights_.begin(*flightKeys[i]);
+        if (!flights[i] || flights[i]->leader()) leaders.push_back(i);
+    }
+
+    std::vector<cpr::Response> out(reqs.size());
+    if (leaders.size() == 1) {
+        out[leaders.front()] = transfer(reqs[leaders.front()]);
+    } else if (!leaders.empty()) {
+        std::vector<std::string> hosts, keys;
+        std::vector<std::shared_ptr<cpr::Session>> sessions;
+        std::vector<cpr::Response> done;
+        {
+            cpr::MultiPerform multi;
+            for (size_t i : leaders) {
+                const HttpRequest& req = reqs[i];
+                hosts.push_back(hostKey(req.url));
+                keys.push_back(poolKey(hosts.back(), req.method));
+                sessions.push_back(acquire(keys.back()));
+                prepare(*sessions.back(), req);
+                multi.AddSession(sessions.back(), req.method == HttpRequest::Method::Post
+                                                      ? cpr::MultiPerform::HttpMethod::POST_REQUEST
+                                                      : cpr::MultiPerform::HttpMethod::GET_REQUEST);
+            }
+            done = multi.Perform();
+        }
+        for (size_t j = 0; j < leaders.size(); ++j) {
+            record(hosts[j], *sessions[j], done[j]);
+            if (!done[j].error) release(keys[j], std::move(sessions[j]));
+            out[leaders[j]] = std::move(done[j]);
+        }
+    }
+    for (size_t i : leaders) {
+        if (flights[i]) flights_.finish(*flightKeys[i], *flights[i], out[i]);
+    }
+
+    for (size_t i = 0; i < reqs.size(); ++i) {
+        if (!flights[i] || flights[i]->leader()) continue;
+        try {
+            out[i] = flights[i]->future().get();
+            countCoalesced(reqs[i].url);
+        } catch (const OperationCancelled&) {
+            out[i] = transfer(reqs[i]);
+        }
+    }
+    return out;
+}
+
+Future<cpr::Response> HttpClient::transferAsync(const HttpRequest& req, CancelToken cancel) {
+    Loop::Transfer t;
+    t.host = hostKey(req.url);
+    t.key = poolKey(t.host, req.method);
+    t.cancel = std::move(cancel);
+    Future<cpr::Response> out = t.promise.future();
+    if (t.cancel.cancelled()) {
+        t.promise.cancel();
+        return out;
+    }
+    t.session = acquire(t.key);
+    prepare(*t.session, req);
+    if (req.method == HttpRequest::Method::Post) t.session->PreparePost();
+    else t.session->PrepareGet();
+    loop()->submit(std::move(t));
+    return out;
+}
+
+Future<cpr::Response> HttpClient::performAsync(const HttpRequest& req, CancelToken cancel) {
+    const auto key = flightKey(req);
+    if (!key) return transferAsync(req, std::move(cancel));
+    bool joined = false;
+    Future<cpr::Response> out =
+        flights_.runAsync(*key, std::move(cancel), [this, &req](CancelToken t) { return transferAsync(req, std::move(t)); },
+                          &joined);
+    if (joined) countCoalesced(req.url);
+    return out;
+}
+
+size_t HttpClient::inFlight() const {
+    std::lock_guard<std::mutex> lock(loopMutex_);
+    return loop_ ? loop_->pending.load() : 0;
+}
+
+cpr::Response HttpClient::get(const std::string& url, const cpr::Parameters& parameters,
+                              const cpr::Header& header) {
+    HttpRequest req;
+    req.url = url;
+    req.parameters = parameters;
+    req.header = header;
+    return perform(req);
+}
+
+cpr::Response HttpClient::post(const std::string& url, const std::string& body, const cpr::Header& header) {
+    HttpRequest req;
+    req.method = HttpRequest::Method::Post;
+    req.url = url;
+    req.header = header;
+    req.body = body;
+    return perform(req);
+}
+
+std::vector<HttpHostStats> HttpClient::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<HttpHostStats> out;
+    out.reserve(stats_.size());
+    for (const auto& kv : stats_) {
+        out.push_back(kv.second);
+        out.back().host = kv.first;
+    }
+    return out;
+}
+
+void HttpClient::resetStats() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats_.clear();
+    }
+    flights_.resetStats();
+}
+
+SingleFlightStats HttpClient::coalescing() const {
+    return flights_.stats();
+}
+
+size_t HttpClient::idleSessions() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t n = 0;
+    for (const auto& kv : idle_) n += kv.second.size();
+    return n;
+}
+
+HttpClient& httpClient() {
+    static HttpClient client;
+    return client;
+}
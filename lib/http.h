@@ -0,0 +1,237 @@
+// SPDX-License-Identifier: Apache-2.0
+//-------------------------------------------------------------------------------
+// Top100 — Your Personal Movie List
+//
+// File: lib/http.h
+// Purpose: Pooled keep-alive HTTP client shared by the network services.
+// Language: C++17 (header)
+//-------------------------------------------------------------------------------
+#pragma once
+
+#include "async.h"
+#include "single_flight.h"
+#include <cpr/cpr.h>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Client-wide transport settings.
+ * @ingroup services
+ */
+struct HttpClientOptions {
+    /** Connect (TCP + TLS) timeout in milliseconds, 0 = libcurl default */
+    std::int32_t connectTimeoutMs = 5000;
+    /** Whole-request timeout in milliseconds, 0 = none */
+    std::int32_t timeoutMs = 20000;
+    /** Idle sessions kept per host; extra sessions are closed on release */
+    size_t maxIdlePerHost = 6;
+    /** Negotiate HTTP/2 over TLS and multiplex concurrent requests per host */
+    bool http2 = true;
+    /** Ask for gzip/deflate response bodies */
+    bool compressed = true;
+    /** Identical GETs issued while one is in flight share its response */
+    bool coalesce = true;
+};
+
+/**
+ * @brief One request for HttpClient::perform().
+ * @ingroup services
+ */
+struct HttpRequest {
+    /** Request method */
+    enum class Method { Get, Post };
+    Method method = Method::Get;
+    /** Absolute URL */
+    std::string url;
+    /** Query parameters */
+    cpr::Parameters parameters{};
+    /** Extra request headers */
+    cpr::Header header{};
+    /** Raw POST body (Post only) */
+    std::optional<std::string> body;
+    /** multipart/form-data POST body (Post only; takes precedence over body) */
+    std::optional<cpr::Multipart> multipart;
+    /** Per-request timeout override in milliseconds, 0 = client default */
+    std::int32_t timeoutMs = 0;
+};
+
+/**
+ * @brief Latency and connection counters for one host.
+ * @ingroup services
+ */
+struct HttpHostStats {
+    /** scheme://host[:port] */
+    std::string host;
+    /** Completed requests (including failures) */
+    uint64_t requests = 0;
+    /** Requests that failed at the transport level (no HTTP status) */
+    uint64_t failures = 0;
+    /** GETs answered by an identical one already in flight (not counted in @c requests) */
+    uint64_t coalesced = 0;
+    /** New connections opened; requests - connections were served on a kept-alive one */
+    uint64_t connections = 0;
+    /** Sessions created for this host (idle ones are reused) */
+    uint64_t sessions = 0;
+    /** Sum of request latencies in seconds */
+    double totalSeconds = 0.0;
+    /** Slowest request in seconds */
+    double maxSeconds = 0.0;
+    /** @return Mean latency in milliseconds (0 when idle). */
+    double meanMs() const { return requests ? totalSeconds * 1000.0 / static_cast<double>(requests) : 0.0; }
+};
+
+/**
+ * @brief HTTP client that keeps connections alive between calls.
+ *
+ * Each host has a pool of idle cpr::Session objects. A request leases one,
+ * re-specifies every per-request field on it and returns it afterwards, so the
+ * next request to that host reuses the same easy handle and its open
+ * connection. All sessions also share libcurl's DNS, TLS-session and
+ * connection caches, which keeps connections alive across sessions and across
+ * the short-lived multi handles used by performAll().
+ *
+ * performAsync() hands requests to one event-loop thread per client, which
+ * drives every in-flight transfer through a libcurl multi handle. Results are
+ * delivered as Futures; a CancelToken aborts a transfer that is no longer
+ * wanted instead of letting it run to completion.
+ *
+ * Identical GETs (same URL, parameters and headers) issued while one is in
+ * flight are coalesced: the later callers receive the first one's response
+ * instead of making their own request, whichever of perform(), performAll()
+ * and performAsync() they use. Posts are never coalesced.
+ *
+ * Thread-safe: any number of threads may issue requests concurrently.
+ *
+ * @ingroup services
+ */
+class HttpClient {
+public:
+    /** @brief Create a client.
+     *  @param opts Transport settings */
+    explicit HttpClient(HttpClientOptions opts = {});
+    ~HttpClient();
+
+    HttpClient(const HttpClient&) = delete;
+    HttpClient& operator=(const HttpClient&) = delete;
+
+    /**
+     * @brief Replace the transport settings.
+     *
+     * Applies to sessions leased afterwards; idle sessions are dropped so they
+     * pick up the new settings.
+     * @param opts Transport settings
+     */
+    void setOptions(const HttpClientOptions& opts);
+
+    /** @return Current transport settings. */
+    HttpClientOptions options() const;
+
+    /**
+     * @brief Perform one request on a pooled session (blocking).
+     * @param req Request
+     * @return Response (status_code 0 and error set on transport failure)
+     */
+    cpr::Response perform(const HttpRequest& req);
+
+    /**
+     * @brief Perform several requests concurrently (blocking until all finish).
+     *
+     * Requests to the same host are multiplexed over one HTTP/2 connection when
+     * the server supports it.
+     * @param reqs Requests
+     * @return Responses, parallel to @p reqs
+     */
+    std::vector<cpr::Response> performAll(const std::vector<HttpRequest>& reqs);
+
+    /**
+     * @brief Start a request without blocking.
+     *
+     * The request runs on the client's event-loop thread (started on first
+     * use), multiplexed with every other asynchronous request. Continuations
+     * attached to the returned future run on that thread.
+     *
+     * @param req Request
+     * @param cancel Token; cancelling it aborts the transfer and cancels the future
+     * @return Future response (status_code 0 and error set on transport failure)
+     */
+    Future<cpr::Response> performAsync(const HttpRequest& req, CancelToken cancel = {});
+
+    /** @return Asynchronous requests queued or in flight. */
+    size_t inFlight() const;
+
+    /**
+     * @brief GET convenience wrapper.
+     * @param url Absolute URL
+     * @param parameters Query parameters
+     * @param header Extra request headers
+     * @return Response
+     */
+    cpr::Response get(const std::string& url, const cpr::Parameters& parameters = {},
+                      const cpr::Header& header = {});
+
+    /**
+     * @brief POST convenience wrapper with a raw body.
+     * @param url Absolute URL
+     * @param body Request body
+     * @param header Extra request headers (e.g. Content-Type)
+     * @return Response
+     */
+    cpr::Response post(const std::string& url, const std::string& body, const cpr::Header& header = {});
+
+    /** @return Per-host counters, sorted by host. */
+    std::vector<HttpHostStats> stats() const;
+
+    /** @brief Zero all counters. */
+    void resetStats();
+
+    /** @return Coalescing counters across all hosts. */
+    SingleFlightStats coalescing() const;
+
+    /** @return Number of idle pooled sessions across all hosts. */
+    size_t idleSessions() const;
+
+    /**
+     * @brief Host key of a URL: lower-cased scheme://host[:port].
+     * @param url Absolute URL
+     * @return Host key (empty if @p url has no scheme)
+     */
+    static std::string hostKey(const std::string& url);
+
+private:
+    struct Shared;
+    struct Loop;
+
+    std::shared_ptr<Loop> loop();
+
+    cpr::Response transfer(const HttpRequest& req);
+    Future<cpr::Response> transferAsync(const HttpRequest& req, CancelToken cancel);
+    std::optional<std::string> flightKey(const HttpRequest& req) const;
+    bool onLoopThread() const;
+    void countCoalesced(const std::string& url);
+
+    std::shared_ptr<cpr::Session> acquire(const std::string& host);
+    void release(const std::string& host, std::shared_ptr<cpr::Session> session);
+    void prepare(cpr::Session& session, const HttpRequest& req) const;
+    void record(const std::string& host, cpr::Session& session, const cpr::Response& r);
+
+    mutable std::mutex mutex_;
+    HttpClientOptions opts_;
+    std::map<std::string, std::vector<std::shared_ptr<cpr::Session>>> idle_;
+    std::map<std::string, HttpHostStats> stats_;
+    std::unique_ptr<Shared> shared_;
+    mutable std::mutex loopMutex_;
+    std::shared_ptr<Loop> loop_;   // stopped before the share handle goes away
+    SingleFlight<std::string, cpr::Response> flights_;
+};
+
+/**
+ * @brief Process-wide client used by the OMDb, BlueSky, Mastodon and export code.
+ * @return Shared client
+ * @ingroup services
+ */
+HttpClient& httpClient();
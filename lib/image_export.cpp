@@ -1,190 +1,333 @@
 // SPDX-License-Identifier: Apache-2.0
 //-------------------------------------------------------------------------------
 // Top100 — Your Personal Movie List
-// Export a PNG summary image with a heading and a 5x20 grid of movies.
+// Export a PNG summary image with a heading and a grid of movies, drawn in bands.
 //-------------------------------------------------------------------------------
 #include "image_export.h"
 #include "Movie.h"
-#include <cpr/cpr.h>
+#include "png_writer.h"
+#include "poster_cache.h"
+#include "text_fit.h"
+#include "thread_pool.h"
 #include <cairo/cairo.h>
-#include <cairo/cairo-pdf.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
 #include <filesystem>
-#include <cstring>
-#include <optional>
-#ifndef TOP100_NO_SQLITE
-#include <sqlite3.h>
-#endif
-#include "config.h"
-#include "top100.h"
-#if TOP100_HAVE_JPEG
-extern "C" {
-#include <jpeglib.h>
-}
-#endif
+#include <future>
+#include <mutex>
 #include <sstream>
+#include <unordered_map>
 
 namespace {
-struct Image {
+
+// Posters resolved and held in memory at a time
+constexpr int kTileWindow = 100;
+
+// Cairo view of a decoded tile; the tile stays alive while the surface is used
+struct TileSurface {
+    std::shared_ptr<const PosterBitmap> tile;
     cairo_surface_t* surface = nullptr;
-    int w = 0;
-    int h = 0;
-    Image() = default;
-    // Unique ownership of the cairo surface
-    Image(const Image&) = delete;
-    Image& operator=(const Image&) = delete;
-    Image(Image&& other) noexcept { surface = other.surface; w = other.w; h = other.h; other.surface = nullptr; other.w = other.h = 0; }
-    Image& operator=(Image&& other) noexcept {
-        if (this != &other) {
-            if (surface) cairo_surface_destroy(surface);
-            surface = other.surface; w = other.w; h = other.h;
-            other.surface = nullptr; other.w = other.h = 0;
-        }
-        return *this;
+    explicit TileSurface(std::shared_ptr<const PosterBitmap> t) : tile(std::move(t)) {
+        if (!tile) return;
+        surface = cairo_image_surface_create_for_data(
+            reinterpret_cast<unsigned char*>(const_cast<uint32_t*>(tile->pixels.data())), CAIRO_FORMAT_ARGB32,
+            tile->width, tile->height, tile->width * 4);
     }
-    ~Image() { if (surface) cairo_surface_destroy(surface); }
+    TileSurface(const TileSurface&) = delete;
+    TileSurface& operator=(const TileSurface&) = delete;
+    ~TileSurface() { if (surface) cairo_surface_destroy(surface); }
 };
 
-// Load image bytes into a Cairo surface. Try PNG via Cairo stream first; optionally JPEG via libjpeg.
-Image loadImageFromBytes(const std::vector<unsigned char>& bytes) {
-    Image img;
-    if (bytes.empty()) return img;
-    struct ReadCtx { const unsigned char* p; size_t n; size_t off; } ctx{bytes.data(), bytes.size(), 0};
-    auto read_cb = [](void* closure, unsigned char* data, unsigned int length) -> cairo_status_t {
-        ReadCtx* c = static_cast<ReadCtx*>(closure);
-        if (c->off + length > c->n) return CAIRO_STATUS_READ_ERROR;
-        memcpy(data, c->p + c->off, length);
-        c->off += length;
-        return CAIRO_STATUS_SUCCESS;
-    };
-    cairo_surface_t* s = cairo_image_surface_create_from_png_stream(read_cb, &ctx);
-    if (cairo_surface_status(s) == CAIRO_STATUS_SUCCESS) {
-        img.surface = s;
-        img.w = cairo_image_surface_get_width(s);
-        img.h = cairo_image_surface_get_height(s);
-        return img;
+// Poster fitted to its cell: the cache's thumbnail for the cell size (made and
+// stored on first use), else decoded here (JPEGs at reduced size)
+std::shared_ptr<const PosterBitmap> posterTile(PosterCache& cache, const PosterPtr& poster, int maxW, int maxH) {
+    if (!poster) return nullptr;
+    std::shared_ptr<const PosterBitmap> src = cache.thumbnail(poster->key, poster->url, maxW, maxH);
+    if (!src) src = poster->bitmap ? poster->bitmap : decodePosterImage(poster->bytes, maxW, maxH);
+    return src;
+}
+
+// A thumbnail that already fits the cell exactly is used as is
+std::shared_ptr<const PosterBitmap> fitTile(std::shared_ptr<const PosterBitmap> src, int maxW, int maxH) {
+    if (!src) return nullptr;
+    if (src->width <= maxW && src->height <= maxH && (src->width == maxW || src->height == maxH)) return src;
+    return scalePosterBitmap(*src, maxW, maxH);
+}
+
+// One size of one face, made once per export and shared read-only by every
+// band's context. Glyph advances are measured once per code point: all of
+// printable ASCII on first use, anything else one by one.
+class ScaledFont {
+public:
+    ScaledFont(cairo_font_face_t* face, double size, double scale) {
+        cairo_matrix_t fontMatrix, ctm;
+        cairo_matrix_init_scale(&fontMatrix, size, size);
+        cairo_matrix_init_scale(&ctm, scale, scale);
+        cairo_font_options_t* options = cairo_font_options_create();
+        font_ = cairo_scaled_font_create(face, &fontMatrix, &ctm, options);
+        cairo_font_options_destroy(options);
     }
-    if (s) cairo_surface_destroy(s);
-    #if TOP100_HAVE_JPEG
-    // Minimal libjpeg decode path (RGB -> BGRA copy)
-    struct jpeg_decompress_struct cinfo;
-    struct jpeg_error_mgr jerr;
-    cinfo.err = jpeg_std_error(&jerr);
-    jpeg_create_decompress(&cinfo);
-    jpeg_mem_src(&cinfo, const_cast<unsigned char*>(bytes.data()), bytes.size());
-    if (jpeg_read_header(&cinfo, TRUE) == JPEG_HEADER_OK) {
-        cinfo.out_color_space = JCS_RGB; // Standard RGB output
-        jpeg_start_decompress(&cinfo);
-        int w = static_cast<int>(cinfo.output_width);
-        int h = static_cast<int>(cinfo.output_height);
-        cairo_surface_t* js = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, w, h);
-        if (js && cairo_surface_status(js) == CAIRO_STATUS_SUCCESS) {
-            unsigned char* dst = cairo_image_surface_get_data(js);
-            int stride = cairo_image_surface_get_stride(js);
-            // Allocate a row buffer in RGB
-            JSAMPARRAY buffer;
-            int row_stride = w * 3;
-            buffer = (*cinfo.mem->alloc_sarray)((j_common_ptr)&cinfo, JPOOL_IMAGE, row_stride, 1);
-            while (cinfo.output_scanline < cinfo.output_height) {
-                jpeg_read_scanlines(&cinfo, buffer, 1);
-                unsigned char* src = buffer[0];
-                unsigned char* drow = dst + (cinfo.output_scanline - 1) * stride;
-                // Convert RGB -> BGRA with opaque alpha
-                for (int x = 0; x < w; ++x) {
-                    unsigned char r = src[x*3 + 0];
-                    unsigned char g = src[x*3 + 1];
-                    unsigned char b = src[x*3 + 2];
-                    drow[x*4+0] = b; drow[x*4+1] = g; drow[x*4+2] = r; drow[x*4+3] = 255;
-                }
-            }
-            cairo_surface_mark_dirty(js);
-            img.surface = js; img.w = w; img.h = h;
+    ScaledFont(const ScaledFont&) = delete;
+    ScaledFont& operator=(const ScaledFont&) = delete;
+    ~ScaledFont() { cairo_scaled_font_destroy(font_); }
+
+    cairo_scaled_font_t* get() const { return font_; }
+
+    // Ink extents of a whole string, in layout units
+    cairo_text_extents_t extents(const std::string& utf8) const {
+        cairo_text_extents_t ext{};
+        cairo_scaled_font_text_extents(font_, utf8.c_str(), &ext);
+        return ext;
+    }
+
+    double advance(char32_t c) const {
+        if (c >= 0x20 && c < 0x7F) {
+            std::call_once(asciiOnce_, [this]() {
+                for (char32_t a = 0x20; a < 0x7F; ++a) ascii_[a - 0x20] = measureAdvance(a);
+            });
+            return ascii_[c - 0x20];
         }
-        jpeg_finish_decompress(&cinfo);
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = other_.find(c);
+        if (it == other_.end()) it = other_.emplace(c, measureAdvance(c)).first;
+        return it->second;
+    }
+
+private:
+    double measureAdvance(char32_t c) const {
+        std::string s;
+        appendUtf8(s, c);
+        return extents(s).x_advance;
     }
-    jpeg_destroy_decompress(&cinfo);
-    if (img.surface) return img;
-    #endif
-    // Non-PNG input: skip image.
-    return img;
+
+    cairo_scaled_font_t* font_ = nullptr;
+    mutable std::once_flag asciiOnce_;
+    mutable std::array<double, 0x7F - 0x20> ascii_{};
+    mutable std::mutex mutex_;
+    mutable std::unordered_map<char32_t, double> other_;
+};
+
+// The export's fonts, made once per export (the scaled fonts keep their faces alive)
+struct ExportFonts {
+    cairo_font_face_t* regular = cairo_toy_font_face_create("Sans", CAIRO_FONT_SLANT_NORMAL, CAIRO_FONT_WEIGHT_NORMAL);
+    cairo_font_face_t* bold = cairo_toy_font_face_create("Sans", CAIRO_FONT_SLANT_NORMAL, CAIRO_FONT_WEIGHT_BOLD);
+    const ScaledFont heading, subtitle, number, title;
+
+    explicit ExportFonts(double scale)
+        : heading(bold, 28.0, scale), subtitle(regular, 14.0, scale), number(bold, 16.0, scale),
+          title(regular, 12.0, scale) {}
+    ExportFonts(const ExportFonts&) = delete;
+    ExportFonts& operator=(const ExportFonts&) = delete;
+    ~ExportFonts() {
+        cairo_font_face_destroy(regular);
+        cairo_font_face_destroy(bold);
+    }
+};
+
+// A line of text ready to draw, with its ink extents
+struct FittedText {
+    std::string text;
+    cairo_text_extents_t ext{};
+};
+
+// @p text followed by @p suffix, elided to @p maxWidth by glyph advances (see fitTextToWidth())
+FittedText fitText(const ScaledFont& font, const std::string& text, const std::string& suffix, double maxWidth) {
+    FittedText out;
+    // The last string measured is the one returned, so its extents are kept rather than measured again
+    out.text = fitTextToWidth(
+        text, suffix, maxWidth, [&font](char32_t c) { return font.advance(c); },
+        [&font, &out](const std::string& line) {
+            out.ext = font.extents(line);
+            return out.ext.width;
+        });
+    return out;
 }
 
-void drawCenteredText(cairo_t* cr, double cx, double y, const std::string& text, bool bold=false, double size=14.0) {
-    cairo_select_font_face(cr, "Sans", CAIRO_FONT_SLANT_NORMAL, bold ? CAIRO_FONT_WEIGHT_BOLD : CAIRO_FONT_WEIGHT_NORMAL);
-    cairo_set_font_size(cr, size);
-    cairo_text_extents_t ext; cairo_text_extents(cr, text.c_str(), &ext);
-    double x = cx - (ext.width / 2.0 + ext.x_bearing);
-    cairo_move_to(cr, x, y);
+void drawCenteredText(cairo_t* cr, const ScaledFont& font, double cx, double y, const std::string& text) {
+    cairo_set_scaled_font(cr, font.get());
+    const cairo_text_extents_t ext = font.extents(text);
+    cairo_move_to(cr, cx - (ext.width / 2.0 + ext.x_bearing), y);
     cairo_show_text(cr, text.c_str());
 }
 
-} // namespace
+// Grid geometry in layout units (1/96 inch at 96 dpi) and its extent in device pixels
+struct Layout {
+    int cols = 5, rows = 20;
+    int cellW = 180, cellH = 240;   // number + poster + title
+    int margin = 40;
+    int headingH = 110;             // heading and subtitle
+    int posterMaxW = 170, posterMaxH = 170;
+    double scale = 1.0;             // device pixels per layout unit
+    int width = 0, height = 0;      // image size, device pixels
+    int boxW = 0, boxH = 0;         // poster box, device pixels
 
-namespace {
+    Layout(const ImageExportOptions& opts, size_t slots) {
+        cols = std::max(1, opts.columns);
+        cellW = std::max(20, opts.cellWidth);
+        cellH = std::max(80, opts.cellHeight);
+        rows = static_cast<int>((slots + cols - 1) / cols);
+        posterMaxW = cellW - 10;
+        posterMaxH = cellH - 70;    // leave space for title
+        scale = opts.dpi > 0 ? opts.dpi / 96.0 : 1.0;
+        width = px(margin * 2.0 + double(cols) * cellW);
+        height = px(margin * 2.0 + headingH + double(rows) * cellH);
+        boxW = px(posterMaxW);
+        boxH = px(posterMaxH);
+    }
+
+    int px(double v) const { return static_cast<int>(std::lround(v * scale)); }
+    double rowTop(int r) const { return margin + headingH + double(r) * cellH; }
+
+    // Band 0 is the top margin and heading, band r+1 is grid row r (the last
+    // one also takes the bottom margin); bands meet at whole device pixels
+    int bands() const { return rows + 1; }
+    int bandTop(int b) const { return b == 0 ? 0 : px(rowTop(b - 1)); }
+    int bandBottom(int b) const { return b == rows ? height : px(rowTop(b)); }
+    int tallestBand() const {
+        int h = 0;
+        for (int b = 0; b < bands(); ++b) h = std::max(h, bandBottom(b) - bandTop(b));
+        return h;
+    }
+};
 
-#ifndef TOP100_NO_SQLITE
-// Ensure posters cache table exists
-void ensurePosterCache(sqlite3* db) {
-    static bool done = false; if (done) return; done = true;
-    const char* sql = R"SQL(
-        CREATE TABLE IF NOT EXISTS posters(
-            imdbID TEXT PRIMARY KEY,
-            mime TEXT,
-            data BLOB,
-            updatedAt INTEGER
-        );
-    )SQL";
-    sqlite3_exec(db, sql, nullptr, nullptr, nullptr);
+// Posters of movies [first, first + count) fitted to the poster box. Stored
+// thumbnails first; the rest resolved together (memory and database, then
+// the misses downloaded concurrently) and decoded and downscaled on the workers
+std::vector<std::shared_ptr<const PosterBitmap>> resolveTiles(PosterCache& cache, ThreadPool& pool,
+                                                              const std::vector<Movie>& movies, size_t first,
+                                                              size_t count, int boxW, int boxH) {
+    std::vector<std::shared_ptr<const PosterBitmap>> tiles(count);
+    pool.parallelFor(count, [&](size_t i, size_t) {
+        tiles[i] = cache.storedThumbnail(movies[first + i].imdbID, movies[first + i].posterUrl, boxW, boxH);
+    });
+    std::vector<size_t> missing;
+    std::vector<PosterRequest> wanted;
+    for (size_t i = 0; i < count; ++i) {
+        if (tiles[i]) continue;
+        missing.push_back(i);
+        wanted.push_back(PosterRequest{movies[first + i].imdbID, movies[first + i].posterUrl});
+    }
+    const std::vector<PosterPtr> posters = cache.getAll(wanted);
+    pool.parallelFor(missing.size(), [&](size_t j, size_t) {
+        tiles[missing[j]] = posterTile(cache, posters[j], boxW, boxH);
+    });
+    pool.parallelFor(count, [&](size_t i, size_t) { tiles[i] = fitTile(std::move(tiles[i]), boxW, boxH); });
+    return tiles;
 }
 
-// Read cached poster bytes by imdbID
-std::optional<std::vector<unsigned char>> readPoster(sqlite3* db, const std::string& imdbID) {
-    if (!db || imdbID.empty()) return std::nullopt;
-    ensurePosterCache(db);
-    const char* sel = "SELECT data FROM posters WHERE imdbID=?";
-    sqlite3_stmt* st = nullptr; if (sqlite3_prepare_v2(db, sel, -1, &st, nullptr) != SQLITE_OK) return std::nullopt;
-    sqlite3_bind_text(st, 1, imdbID.c_str(), -1, SQLITE_TRANSIENT);
-    std::optional<std::vector<unsigned char>> out;
-    if (sqlite3_step(st) == SQLITE_ROW) {
-        const void* blob = sqlite3_column_blob(st, 0);
-        int n = sqlite3_column_bytes(st, 0);
-        if (blob && n > 0) {
-            const unsigned char* p = static_cast<const unsigned char*>(blob);
-            out = std::vector<unsigned char>(p, p + n);
+// Surface and context one band is drawn on: its own pixels when streaming,
+// else a view of the band's rows in the whole image
+struct BandSlot {
+    cairo_surface_t* surface = nullptr;
+    cairo_t* cr = nullptr;
+    BandSlot(int width, int height) {
+        surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height);
+        if (cairo_surface_status(surface) == CAIRO_STATUS_SUCCESS) cr = cairo_create(surface);
+    }
+    BandSlot(cairo_surface_t* whole, int top, int height) {
+        const int stride = cairo_image_surface_get_stride(whole);
+        surface = cairo_image_surface_create_for_data(
+            cairo_image_surface_get_data(whole) + static_cast<size_t>(top) * stride, CAIRO_FORMAT_ARGB32,
+            cairo_image_surface_get_width(whole), height, stride);
+        if (cairo_surface_status(surface) == CAIRO_STATUS_SUCCESS) cr = cairo_create(surface);
+    }
+    BandSlot(const BandSlot&) = delete;
+    BandSlot& operator=(const BandSlot&) = delete;
+    ~BandSlot() {
+        if (cr) cairo_destroy(cr);
+        if (surface) cairo_surface_destroy(surface);
+    }
+    bool ok() const { return cr != nullptr; }
+};
+
+// Draws bands of the image; tiles holds the posters of movies [firstTile, ...)
+struct GridPainter {
+    const Layout& L;
+    const ExportFonts& fonts;
+    const std::string& heading;
+    const std::vector<Movie>& movies;
+    size_t count;
+    size_t firstTile = 0;
+    std::vector<std::shared_ptr<const PosterBitmap>> tiles;
+
+    // Band @p b onto @p cr, whose surface is the band (row 0 is device row bandTop(b)).
+    // Only reads shared state, so bands can be drawn concurrently on their own contexts.
+    void band(cairo_t* cr, int b) const {
+        const int originY = L.bandTop(b);
+        cairo_save(cr);
+        cairo_identity_matrix(cr);
+        cairo_translate(cr, 0, -originY);
+
+        // Background
+        cairo_set_source_rgb(cr, 1, 1, 1);
+        cairo_rectangle(cr, 0, L.bandTop(b), L.width, L.bandBottom(b) - L.bandTop(b));
+        cairo_fill(cr);
+
+        cairo_scale(cr, L.scale, L.scale);
+        if (b == 0) {
+            // Heading and subtitle
+            const double cx = (L.margin * 2.0 + double(L.cols) * L.cellW) / 2.0;
+            cairo_set_source_rgb(cr, 0, 0, 0);
+            const double titleY = L.margin + 44.0;
+            drawCenteredText(cr, fonts.heading, cx, titleY, sanitizeUtf8(heading));
+            const std::string subtitle = "Generated by Top 100 - https://github.com/andymccall/top100";
+            drawCenteredText(cr, fonts.subtitle, cx, titleY + 26.0, subtitle);
+        } else {
+            const size_t row = static_cast<size_t>(b - 1);
+            for (size_t i = row * L.cols; i < std::min(count, (row + 1) * L.cols); ++i) cell(cr, i, originY);
         }
+        cairo_restore(cr);
     }
-    sqlite3_finalize(st);
-    return out;
-}
 
-// Upsert poster bytes into cache
-void writePoster(sqlite3* db, const std::string& imdbID, const std::string& mime, const std::vector<unsigned char>& bytes) {
-    if (!db || imdbID.empty() || bytes.empty()) return; ensurePosterCache(db);
-    const char* ins = "INSERT INTO posters(imdbID,mime,data,updatedAt) VALUES(?,?,?,strftime('%s','now')) ON CONFLICT(imdbID) DO UPDATE SET mime=excluded.mime,data=excluded.data,updatedAt=excluded.updatedAt";
-    sqlite3_stmt* st = nullptr; if (sqlite3_prepare_v2(db, ins, -1, &st, nullptr) != SQLITE_OK) return;
-    sqlite3_bind_text(st, 1, imdbID.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(st, 2, mime.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_blob(st, 3, bytes.data(), static_cast<int>(bytes.size()), SQLITE_TRANSIENT);
-    sqlite3_step(st);
-    sqlite3_finalize(st);
-}
-#endif
-
-// Best-effort get SQLite handle from the current data file
-sqlite3* tryOpenDbFromConfig() {
-#ifdef TOP100_NO_SQLITE
-    return nullptr;
-#else
-    try {
-        AppConfig cfg = loadConfig();
-        sqlite3* db = nullptr;
-        if (sqlite3_open(cfg.dataFile.c_str(), &db) == SQLITE_OK) {
-            return db;
+    void cell(cairo_t* cr, size_t i, int originY) const {
+        const int r = static_cast<int>(i / L.cols);
+        const int c = static_cast<int>(i % L.cols);
+        const double x0 = L.margin + double(c) * L.cellW;
+        const double y0 = L.rowTop(r);
+
+        // Number label centered at top
+        std::ostringstream num; num << (i+1) << ".";
+        cairo_set_source_rgb(cr, 0, 0, 0);
+        drawCenteredText(cr, fonts.number, x0 + L.cellW/2.0, y0 + 18, num.str());
+
+        // Poster tile, centred in its box at whole device pixels so it is copied, not resampled
+        const double posterTop = y0 + 28;
+        TileSurface img(tiles[i - firstTile]);
+        if (img.surface) {
+            const int cellX = L.px(x0);
+            const int px = cellX + (L.px(x0 + L.cellW) - cellX - img.tile->width) / 2;
+            const int py = L.px(posterTop) + (L.boxH - img.tile->height) / 2;
+            cairo_save(cr);
+            cairo_identity_matrix(cr);
+            cairo_translate(cr, 0, -originY);
+            cairo_set_source_surface(cr, img.surface, px, py);
+            cairo_rectangle(cr, px, py, img.tile->width, img.tile->height);
+            cairo_fill(cr);
+            cairo_restore(cr);
+        } else {
+            // Draw placeholder rectangle
+            cairo_set_source_rgb(cr, 0.9, 0.9, 0.9);
+            cairo_rectangle(cr, x0 + 5, posterTop, L.posterMaxW, L.posterMaxH);
+            cairo_fill(cr);
+            cairo_set_source_rgb(cr, 0.7, 0.7, 0.7);
+            cairo_rectangle(cr, x0 + 5, posterTop, L.posterMaxW, L.posterMaxH);
+            cairo_stroke(cr);
         }
-        if (db) sqlite3_close(db);
-    } catch (...) {}
-    return nullptr;
-#endif
-}
+
+        // Title + (Year) centered near bottom, the title shortened to fit
+        std::ostringstream year; year << " (" << movies[i].year << ")";
+        const FittedText line = fitText(fonts.title, sanitizeUtf8(movies[i].title), year.str(), L.cellW - 8);
+        cairo_set_scaled_font(cr, fonts.title.get());
+        cairo_move_to(cr, x0 + (L.cellW/2.0) - (line.ext.width/2.0 + line.ext.x_bearing), y0 + L.cellH - 10);
+        cairo_set_source_rgb(cr, 0, 0, 0);
+        cairo_show_text(cr, line.text.c_str());
+    }
+};
+
+} // namespace
+
+namespace {
 
 // Determine default export path under ~/Pictures if available
 std::string defaultExportPath() {
@@ -203,129 +346,110 @@ bool exportTop100Image(const std::vector<Movie>& movies,
                        const std::string& outPath,
                        const std::string& heading)
 {
-    // Layout: 5 columns x 20 rows
-    const int cols = 5, rows = 20;
-    const int cellW = 180, cellH = 240; // allows number + image + title
-    const int margin = 40;
-    const int headingH = 110; // more space for subtitle
-    const int width = margin*2 + cols*cellW;
-    const int height = margin*2 + headingH + rows*cellH;
-
-    cairo_surface_t* surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height);
-    if (!surface || cairo_surface_status(surface) != CAIRO_STATUS_SUCCESS) return false;
-    cairo_t* cr = cairo_create(surface);
-
-    // Background
-    cairo_set_source_rgb(cr, 1, 1, 1);
-    cairo_paint(cr);
-
-    // Heading and subtitle
-    cairo_set_source_rgb(cr, 0, 0, 0);
-    const double titleY = margin + 44.0;
-    drawCenteredText(cr, width/2.0, titleY, heading, true, 28.0);
-    const std::string subtitle = "Generated by Top 100 - https://github.com/andymccall/top100";
-    drawCenteredText(cr, width/2.0, titleY + 26.0, subtitle, false, 14.0);
-
-    // For each movie cell
-    const size_t n = std::min<size_t>(movies.size(), 100);
-    for (size_t i = 0; i < n; ++i) {
-        int r = i / cols;
-        int c = i % cols;
-        double x0 = margin + c*cellW;
-    double y0 = margin + headingH + r*cellH;
+    return exportTop100Image(movies, outPath, heading, ImageExportOptions());
+}
 
-        // Number label centered at top
-        std::ostringstream num; num << (i+1) << ".";
-        drawCenteredText(cr, x0 + cellW/2.0, y0 + 18, num.str(), true, 16.0);
-
-        // Poster: fetch and scale to fit box
-        double posterTop = y0 + 28;
-        double posterMaxW = cellW - 10;
-        double posterMaxH = cellH - 70; // leave space for title
-
-    Image img;
-        const auto& url = movies[i].posterUrl;
-        const auto& imdb = movies[i].imdbID;
-        std::vector<unsigned char> posterBytes;
-#ifndef TOP100_NO_SQLITE
-        // Try cache first
-        sqlite3* db = tryOpenDbFromConfig();
-        if (db && !imdb.empty()) {
-            if (auto cached = readPoster(db, imdb)) {
-                posterBytes = *cached;
-            }
-        }
-#endif
-        // If cache miss, fetch
-        if (posterBytes.empty() && !url.empty() && url != "N/A") {
-            auto r = cpr::Get(cpr::Url{url});
-            if (r.status_code == 200 && !r.text.empty()) {
-                posterBytes.assign(r.text.begin(), r.text.end());
-#ifndef TOP100_NO_SQLITE
-                if (db && !imdb.empty()) {
-                    std::string mime;
-                    auto it = r.header.find("content-type");
-                    if (it != r.header.end()) mime = it->second;
-                    if (mime.empty()) {
-                        // naive mime by sniffing
-                        if (posterBytes.size() >= 8 && posterBytes[0]==0x89 && posterBytes[1]=='P' && posterBytes[2]=='N' && posterBytes[3]=='G') mime = "image/png";
-                        else if (posterBytes.size() > 2 && posterBytes[0]==0xFF && posterBytes[1]==0xD8) mime = "image/jpeg";
-                        else mime = "application/octet-stream";
-                    }
-                    writePoster(db, imdb, mime, posterBytes);
-                }
-#endif
-            }
-        }
-        if (!posterBytes.empty()) {
-            img = loadImageFromBytes(posterBytes); // move into our unique owner
+
+bool exportTop100Image(const std::vector<Movie>& movies,
+                       const std::string& outPath,
+                       const std::string& heading,
+                       const ImageExportOptions& opts)
+{
+    // Rows are reserved for maxMovies even when the list is shorter
+    const size_t n = opts.maxMovies ? std::min(movies.size(), opts.maxMovies) : movies.size();
+    const Layout layout(opts, opts.maxMovies ? opts.maxMovies : n);
+    const std::string out = outPath.empty() ? defaultExportPath() : outPath;
+
+    // One pool decodes posters, draws bands and compresses the PNG, so
+    // opts.threads is the number of workers running
+    ThreadPool pool(opts.threads);
+
+    // Streamed: bands are drawn into band-tall surfaces and handed to the PNG
+    // encoder in order. Without zlib they are views into one whole-image
+    // surface that Cairo saves at the end.
+    const bool streaming = PngWriter::available();
+    PngWriter png;
+    if (streaming) {
+        PngWriterOptions popts;
+        popts.dpi = opts.dpi;
+        popts.level = opts.pngLevel;
+        popts.pool = &pool;
+        if (!png.open(out, layout.width, layout.height, popts)) return false;
+    }
+    cairo_surface_t* whole = nullptr;
+    if (!streaming) {
+        whole = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, layout.width, layout.height);
+        if (!whole || cairo_surface_status(whole) != CAIRO_STATUS_SUCCESS) {
+            if (whole) cairo_surface_destroy(whole);
+            return false;
         }
+        cairo_surface_flush(whole);
+    }
 
-        if (img.surface) {
-            double iw = img.w, ih = img.h;
-            double scale = std::min(posterMaxW/iw, posterMaxH/ih);
-            double w = iw*scale, h = ih*scale;
-            double px = x0 + (cellW - w) / 2.0;
-            double py = posterTop + (posterMaxH - h) / 2.0;
-            cairo_save(cr);
-            cairo_translate(cr, px, py);
-            cairo_scale(cr, scale, scale);
-            cairo_set_source_surface(cr, img.surface, 0, 0);
-            cairo_rectangle(cr, 0, 0, iw, ih);
-            cairo_fill(cr);
-            cairo_restore(cr);
-        } else {
-            // Draw placeholder rectangle
-            cairo_set_source_rgb(cr, 0.9, 0.9, 0.9);
-            cairo_rectangle(cr, x0 + 5, posterTop, posterMaxW, posterMaxH);
-            cairo_fill(cr);
-            cairo_set_source_rgb(cr, 0.7, 0.7, 0.7);
-            cairo_rectangle(cr, x0 + 5, posterTop, posterMaxW, posterMaxH);
-            cairo_stroke(cr);
+    // One batch of bands is drawn on the workers, each with its own context,
+    // while this thread feeds the previous batch to the encoder; two sets of
+    // slots alternate
+    auto cache = posterCache();
+    const ExportFonts fonts(layout.scale);
+    GridPainter painter{layout, fonts, heading, movies, n, 0, {}};
+    const int batch = static_cast<int>(pool.threadCount());
+    std::vector<std::unique_ptr<BandSlot>> slots(2 * static_cast<size_t>(batch));
+    auto slotFor = [&](int b, size_t slot) -> BandSlot* {
+        auto& s = slots[slot];
+        if (!streaming)
+            s = std::make_unique<BandSlot>(whole, layout.bandTop(b), layout.bandBottom(b) - layout.bandTop(b));
+        else if (!s)
+            s = std::make_unique<BandSlot>(layout.width, layout.tallestBand());
+        return s->ok() ? s.get() : nullptr;
+    };
+    int pendingFirst = 0, pendingEnd = 0;
+    size_t pendingSet = 0;
+    auto encodePending = [&]() {
+        bool good = true;
+        for (int b = pendingFirst; b < pendingEnd && good && streaming; ++b) {
+            cairo_surface_t* s = slots[pendingSet * batch + (b - pendingFirst)]->surface;
+            cairo_surface_flush(s);
+            good = png.writeRows(cairo_image_surface_get_data(s), layout.bandBottom(b) - layout.bandTop(b),
+                                 cairo_image_surface_get_stride(s));
         }
+        pendingFirst = pendingEnd = 0;
+        return good;
+    };
+
+    // Posters are resolved a window of rows at a time and dropped once drawn,
+    // so memory does not grow with the list
+    const int windowRows = std::max(1, kTileWindow / layout.cols);
+    bool ok = true;
+    size_t set = 0;
+    for (int windowFirst = 0; windowFirst < layout.bands() && ok;) {
+        const int windowEnd = std::min(layout.bands(), std::max(windowFirst, 1) + windowRows);
+        const size_t first = std::min(n, static_cast<size_t>(std::max(windowFirst, 1) - 1) * layout.cols);
+        const size_t last = std::min(n, static_cast<size_t>(windowEnd - 1) * layout.cols);
+        painter.tiles.clear();
+        painter.firstTile = first;
+        painter.tiles = resolveTiles(*cache, pool, movies, first, last - first, layout.boxW, layout.boxH);
 
-        // Title + (Year) centered near bottom, elide if too long
-        std::ostringstream tt; tt << movies[i].title << " (" << movies[i].year << ")";
-        cairo_select_font_face(cr, "Sans", CAIRO_FONT_SLANT_NORMAL, CAIRO_FONT_WEIGHT_NORMAL);
-        cairo_set_font_size(cr, 12.0);
-        cairo_text_extents_t ext{}; cairo_text_extents(cr, tt.str().c_str(), &ext);
-        std::string t = tt.str();
-        // naive elide: trim until fits within cellW - 8
-        while (ext.width > cellW - 8 && t.size() > 4) {
-            t.pop_back();
-            if (!t.empty()) t.back() = '.'; // ensure something changes
-            cairo_text_extents(cr, t.c_str(), &ext);
+        for (int b0 = windowFirst; b0 < windowEnd && ok; b0 += batch) {
+            const int b1 = std::min(windowEnd, b0 + batch);
+            std::vector<std::future<void>> drawn;
+            for (int b = b0; b < b1 && ok; ++b) {
+                BandSlot* slot = slotFor(b, set * batch + (b - b0));
+                if (!slot) ok = false;
+                else drawn.push_back(pool.submit([&painter, slot, b]() { painter.band(slot->cr, b); }));
+            }
+            ok = encodePending() && ok;
+            for (auto& f : drawn) f.get();
+            pendingFirst = b0;
+            pendingEnd = b1;
+            pendingSet = set;
+            set ^= 1;
         }
-        double ty = y0 + cellH - 10;
-        double tx = x0 + (cellW/2.0) - (ext.width/2.0 + ext.x_bearing);
-        cairo_move_to(cr, tx, ty);
-        cairo_set_source_rgb(cr, 0, 0, 0);
-        cairo_show_text(cr, t.c_str());
+        windowFirst = windowEnd;
     }
-
-    cairo_destroy(cr);
-    std::string out = outPath.empty() ? defaultExportPath() : outPath;
-    cairo_status_t st = cairo_surface_write_to_png(surface, out.c_str());
-    cairo_surface_destroy(surface);
-    return st == CAIRO_STATUS_SUCCESS;
+    ok = ok && encodePending();
+    slots.clear();
+    if (streaming) return ok && png.finish();
+    if (ok) ok = cairo_surface_write_to_png(whole, out.c_str()) == CAIRO_STATUS_SUCCESS;
+    cairo_surface_destroy(whole);
+    return ok;
 }
@@ -8,17 +8,51 @@
 //-------------------------------------------------------------------------------
 #pragma once
 
+#include <cstddef>
 #include <string>
 #include <vector>
 
 struct Movie;
 
+/**
+ * @brief Tuning for exportTop100Image().
+ */
+struct ImageExportOptions {
+    /** Worker threads, shared by poster decoding and downscaling, band drawing and PNG compression
+     *  (0 = one per hardware thread); the calling thread comes on top */
+    size_t threads = 0;
+    /** Grid columns */
+    int columns = 5;
+    /** Cell width in layout units (1/96 inch); the poster box is 10 narrower */
+    int cellWidth = 180;
+    /** Cell height in layout units; the poster box is 70 shorter (number and title) */
+    int cellHeight = 240;
+    /** Output resolution: 96 draws one pixel per layout unit, 192 twice as many each way */
+    double dpi = 96;
+    /** Movies drawn, with rows reserved for that many (0 = the whole list) */
+    size_t maxMovies = 100;
+    /** PNG compression level, 0 (fastest, largest) to 9 (slowest, smallest) */
+    int pngLevel = 6;
+};
+
 /**
  * @brief Export a PNG image of the movie grid.
  *
- * The image contains a heading text, and a grid with up to 5x20 cells; each cell draws
- * a bold index number centered above a resized poster, and a single-line title with year.
- * Posters are fetched from Movie::posterUrl; when unavailable, a placeholder is drawn.
+ * The image contains a heading text, and a grid with up to 5x20 cells (see
+ * ImageExportOptions); each cell draws a bold index number centered above a resized
+ * poster, and a single-line title with year. Posters come from the shared poster
+ * cache (see posterCache()), resolved 100 at a time before those cells are drawn, so
+ * the ones not cached yet are downloaded concurrently; when a poster is unavailable,
+ * a placeholder is drawn.
+ *
+ * The image is drawn one band (the heading, then each grid row) at a time, and each
+ * band is compressed into the PNG file as soon as it is drawn (PngWriter), so peak
+ * memory does not depend on the number of movies or the resolution of the whole
+ * image. Decoding and downscaling posters, drawing bands and deflating the PNG all
+ * run on one pool of opts.threads workers; the calling thread resolves posters
+ * through the cache (downloads run on the HTTP client's threads), hands drawn
+ * bands to the encoder and writes the file.
+ * Builds without zlib draw the whole image and let Cairo save it.
  *
  * @param movies Source movies; only the first 100 are used.
  * @param outPath Output PNG file path.
@@ -28,3 +62,16 @@ struct Movie;
 bool exportTop100Image(const std::vector<Movie>& movies,
                        const std::string& outPath,
                        const std::string& heading = "My Top 100 Movies");
+
+/**
+ * @brief exportTop100Image() with explicit tuning.
+ * @param movies Source movies; only the first opts.maxMovies are used.
+ * @param outPath Output PNG file path.
+ * @param heading Heading text.
+ * @param opts Worker threads, grid geometry and resolution.
+ * @return true on success.
+ */
+bool exportTop100Image(const std::vector<Movie>& movies,
+                       const std::string& outPath,
+                       const std::string& heading,
+                       const ImageExportOptions& opts);
@@ -7,3 +7,7 @@ bool exportTop100Image(const std::vector<Movie>&, const std::string&, const std:
     // Not supported without Cairo; return false to signal failure.
     return false;
 }
+
+bool exportTop100Image(const std::vector<Movie>&, const std::string&, const std::string&, const ImageExportOptions&) {
+    return false;
+}
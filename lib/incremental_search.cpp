@@ -0,0 +1,404 @@
+// SPDX-License-Identifier: Apache-2.0
+//-------------------------------------------------------------------------------
+// Top100 — Your Personal Movie List
+//
+// File: lib/incremental_search.cpp
+// Purpose: Search-as-you-type over OMDb (debounce, cancellation, prefix reuse, prefetch).
+// Language: C++17 (CMake build)
+//-------------------------------------------------------------------------------
+#include "incremental_search.h"
+#include "omdb_cache.h"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <unordered_map>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Results of one query, page by page
+struct Entry {
+    std::vector<OmdbSearchResult> results;
+    std::vector<size_t> pageEnds;  // results.size() after each loaded page
+    size_t total = 0;
+    bool exhausted = false;        // a page came back empty
+    bool loading = false;          // a page request is in flight
+    CancelToken loadingToken;      // ...and the token it runs under
+    uint64_t loadingId = 0;
+
+    int pages() const { return static_cast<int>(pageEnds.size()); }
+    bool complete() const { return !pageEnds.empty() && (exhausted || results.size() >= total); }
+};
+
+std::string trim(const std::string& s) {
+    size_t b = 0, e = s.size();
+    while (b < e && std::isspace(static_cast<unsigned char>(s[b]))) ++b;
+    while (e > b && std::isspace(static_cast<unsigned char>(s[e - 1]))) --e;
+    return s.substr(b, e - b);
+}
+
+// Same normalisation as the persistent cache: lower case, single spaces
+std::string normalize(const std::string& s) {
+    return OmdbCache::searchKey(s).substr(std::string("search:").size());
+}
+
+std::vector<std::string> words(const std::string& key) {
+    std::vector<std::string> out;
+    size_t pos = 0;
+    while (pos < key.size()) {
+        size_t sp = key.find(' ', pos);
+        if (sp == std::string::npos) sp = key.size();
+        out.push_back(key.substr(pos, sp - pos));
+        pos = sp + 1;
+    }
+    return out;
+}
+
+// Hits whose title contains every word of @p key
+std::vector<OmdbSearchResult> narrow(const std::vector<OmdbSearchResult>& from, const std::string& key) {
+    const std::vector<std::string> ws = words(key);
+    std::vector<OmdbSearchResult> out;
+    for (const auto& r : from) {
+        const std::string title = normalize(r.title);
+        bool all = true;
+        for (const auto& w : ws) {
+            if (title.find(w) == std::string::npos) {
+                all = false;
+                break;
+            }
+        }
+        if (all) out.push_back(r);
+    }
+    return out;
+}
+
+}  // namespace
+
+struct IncrementalSearch::Impl {
+    std::string apiKey;
+    Listener listener;
+    IncrementalSearchOptions opts;
+
+    mutable std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<std::function<void()>> tasks;
+    std::optional<Clock::time_point> deadline;  // debounced first-page request
+    bool stopping = false;
+    std::thread worker;
+
+    // Current query
+    uint64_t generation = 0;
+    std::string key;
+    std::string text;
+    int shownPages = 0;
+    int wantPage = 0;  // page the listener is waiting for (0 = none)
+    bool wantPrefetched = false;  // ...which a prefetch already requested
+    CancelSource inflight;
+
+    // Most recently used first
+    std::list<std::pair<std::string, Entry>> lru;
+    std::unordered_map<std::string, std::list<std::pair<std::string, Entry>>::iterator> index;
+
+    std::atomic<size_t> requests{0};
+    uint64_t nextLoadId = 0;
+
+    Entry* find(const std::string& k) {
+        auto it = index.find(k);
+        if (it == index.end()) return nullptr;
+        lru.splice(lru.begin(), lru, it->second);
+        return &it->second->second;
+    }
+
+    Entry& findOrAdd(const std::string& k) {
+        if (Entry* e = find(k)) return *e;
+        lru.emplace_front(k, Entry());
+        index[k] = lru.begin();
+        // Evict from the cold end, sparing the current query and pending requests
+        auto it = lru.end();
+        while (lru.size() > std::max<size_t>(1, opts.cacheEntries) && it != lru.begin()) {
+            --it;
+            if (it->first == key || it->second.loading) continue;
+            index.erase(it->first);
+            it = lru.erase(it);
+        }
+        return lru.front().second;
+    }
+
+    void erase(const std::string& k) {
+        auto it = index.find(k);
+        if (it == index.end()) return;
+        lru.erase(it->second);
+        index.erase(it);
+    }
+
+    // Longest cached query that @p k extends. With @p wholeWords the
+    // extension must start a new word: OMDb matches whole words, so only then
+    // are the longer query's hits a subset of the shorter one's.
+    const Entry* broader(const std::string& k, bool wholeWords) {
+        const Entry* best = nullptr;
+        size_t bestLen = 0;
+        for (const auto& kv : lru) {
+            const std::string& c = kv.first;
+            if (c.size() >= k.size() || c.size() < bestLen || kv.second.pages() == 0) continue;
+            if (k.compare(0, c.size(), c) != 0) continue;
+            if (wholeWords && k[c.size()] != ' ') continue;
+            best = &kv.second;
+            bestLen = c.size();
+        }
+        return best;
+    }
+
+    static bool hasMore(const Entry& e) { return !e.exhausted && e.results.size() < e.total; }
+
+    SearchUpdate updateOf(const Entry& e, int pages) const {
+        SearchUpdate u;
+        u.query = text;
+        const size_t n = pages > 0 ? e.pageEnds[static_cast<size_t>(std::min(pages, e.pages())) - 1] : 0;
+        u.results.assign(e.results.begin(), e.results.begin() + static_cast<std::ptrdiff_t>(n));
+        u.totalResults = e.total;
+        u.hasMore = pages < e.pages() || hasMore(e);
+        return u;
+    }
+
+    // Queue a listener call; dropped if the query changes before it runs
+    void deliverLocked(SearchUpdate u) {
+        const uint64_t gen = generation;
+        tasks.emplace_back([this, u = std::move(u), gen]() {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (gen != generation) return;
+            }
+            if (listener) listener(u);
+        });
+        cv.notify_all();
+    }
+
+    // Issue a page request for the current query (lock released around the fetch,
+    // which may complete synchronously from the persistent cache)
+    void fetchPage(std::unique_lock<std::mutex>& lock, int page) {
+        Entry& e = findOrAdd(key);
+        // A request cancelled with an earlier query no longer counts
+        if (e.loading && !e.loadingToken.cancelled()) return;
+        const CancelToken token = inflight.token();
+        const uint64_t id = ++nextLoadId;
+        e.loading = true;
+        e.loadingToken = token;
+        e.loadingId = id;
+        const std::string k = key, q = text;
+        ++requests;
+        lock.unlock();
+        Future<OmdbSearchPage> f;
+        try {
+            f = opts.fetch ? opts.fetch(q, page, token) : omdbSearchPageAsync(apiKey, q, page, token);
+        } catch (...) {
+            Promise<OmdbSearchPage> failed;
+            failed.setError(std::current_exception());
+            f = failed.future();
+        }
+        std::weak_ptr<Impl> weak = self;
+        f.onComplete([weak, k, page, id](const Future<OmdbSearchPage>& done) {
+            if (auto impl = weak.lock()) {
+                impl->post([raw = impl.get(), k, page, id, done]() { raw->onPage(k, page, id, done); });
+            }
+        });
+        lock.lock();
+    }
+
+    void post(std::function<void()> fn) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (stopping) return;
+        tasks.push_back(std::move(fn));
+        cv.notify_all();
+    }
+
+    void onPage(const std::string& k, int page, uint64_t id, const Future<OmdbSearchPage>& done) {
+        std::unique_lock<std::mutex> lock(mutex);
+        Entry& e = findOrAdd(k);
+        if (e.loadingId == id) e.loading = false;
+        if (done.cancelled()) return;
+        OmdbSearchPage p;
+        try { p = done.get(); } catch (...) {}
+        if (page == e.pages() + 1) {
+            e.results.insert(e.results.end(), p.results.begin(), p.results.end());
+            e.pageEnds.push_back(e.results.size());
+            e.total = std::max(e.total, p.totalResults);
+            if (p.results.empty()) e.exhausted = true;
+        }
+        const bool current = k == key;
+        if (current && page == wantPage) {
+            wantPage = 0;
+            shownPages = page;
+            SearchUpdate u = updateOf(e, shownPages);
+            u.fromCache = wantPrefetched;
+            // An empty first page may be a failure rather than "no hits": retry next time
+            if (page == 1 && p.results.empty()) erase(k);
+            deliverLocked(std::move(u));
+        } else if (page == 1 && p.results.empty()) {
+            erase(k);
+        }
+        if (current) prefetchLocked(lock);
+    }
+
+    void prefetchLocked(std::unique_lock<std::mutex>& lock) {
+        if (!opts.prefetchNextPage || shownPages == 0) return;
+        Entry* e = find(key);
+        if (e && hasMore(*e) && e->pages() == shownPages) fetchPage(lock, shownPages + 1);
+    }
+
+    void run() {
+        std::unique_lock<std::mutex> lock(mutex);
+        for (;;) {
+            if (stopping) return;
+            if (!tasks.empty()) {
+                auto task = std::move(tasks.front());
+                tasks.pop_front();
+                lock.unlock();
+                task();
+                lock.lock();
+                continue;
+            }
+            if (deadline) {
+                if (Clock::now() >= *deadline) {
+                    deadline.reset();
+                    wantPage = 1;
+                    wantPrefetched = false;
+                    fetchPage(lock, 1);
+                } else {
+                    cv.wait_until(lock, *deadline);
+                }
+                continue;
+            }
+            cv.wait(lock);
+        }
+    }
+
+    std::weak_ptr<Impl> self;
+};
+
+IncrementalSearch::IncrementalSearch(std::string apiKey, Listener onUpdate, IncrementalSearchOptions opts)
+    : impl_(std::make_shared<Impl>()) {
+    impl_->apiKey = std::move(apiKey);
+    impl_->listener = std::move(onUpdate);
+    impl_->opts = std::move(opts);
+    impl_->self = impl_;
+    impl_->worker = std::thread([impl = impl_.get()]() { impl->run(); });
+}
+
+IncrementalSearch::~IncrementalSearch() {
+    {
+        std::lock_guard<std::mutex> lock(impl_->mutex);
+        impl_->stopping = true;
+        impl_->tasks.clear();
+        impl_->inflight.cancel();
+    }
+    impl_->cv.notify_all();
+    if (impl_->worker.joinable()) impl_->worker.join();
+}
+
+void IncrementalSearch::setQuery(const std::string& text) {
+    Impl& s = *impl_;
+    std::unique_lock<std::mutex> lock(s.mutex);
+    const std::string trimmed = trim(text);
+    const std::string k = normalize(trimmed);
+    if (s.generation > 0 && k == s.key) {
+        s.text = trimmed;
+        return;
+    }
+    ++s.generation;
+    s.key = k;
+    s.text = trimmed;
+    s.shownPages = 0;
+    s.wantPage = 0;
+    s.deadline.reset();
+    s.inflight.cancel();
+    s.inflight = CancelSource();
+
+    if (k.size() < s.opts.minQueryLength) {
+        SearchUpdate empty;
+        empty.query = trimmed;
+        s.deliverLocked(std::move(empty));
+        return;
+    }
+    if (Entry* e = s.find(k); e && e->pages() > 0) {
+        s.shownPages = 1;
+        SearchUpdate u = s.updateOf(*e, 1);
+        u.fromCache = true;
+        s.deliverLocked(std::move(u));
+        s.prefetchLocked(lock);
+        return;
+    }
+    if (const Entry* wide = s.broader(k, true); wide && wide->complete()) {
+        Entry narrowed;
+        narrowed.results = narrow(wide->results, k);
+        narrowed.pageEnds.push_back(narrowed.results.size());
+        narrowed.total = narrowed.results.size();
+        s.findOrAdd(k) = std::move(narrowed);
+        s.shownPages = 1;
+        SearchUpdate u = s.updateOf(*s.find(k), 1);
+        u.fromCache = true;
+        s.deliverLocked(std::move(u));
+        return;
+    }
+    if (const Entry* wide = s.broader(k, false)) {
+        SearchUpdate u;
+        u.query = trimmed;
+        u.results = narrow(wide->results, k);
+        u.provisional = true;
+        u.fromCache = true;
+        s.deliverLocked(std::move(u));
+    }
+    s.deadline = Clock::now() + std::chrono::milliseconds(std::max(0, s.opts.debounceMs));
+    s.cv.notify_all();
+}
+
+void IncrementalSearch::submit() {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    if (!impl_->deadline) return;
+    impl_->deadline = Clock::now();
+    impl_->cv.notify_all();
+}
+
+void IncrementalSearch::loadMore() {
+    Impl& s = *impl_;
+    std::unique_lock<std::mutex> lock(s.mutex);
+    if (s.shownPages == 0 || s.wantPage != 0) return;
+    Entry* e = s.find(s.key);
+    if (!e) return;
+    if (e->pages() > s.shownPages) {
+        ++s.shownPages;
+        SearchUpdate u = s.updateOf(*e, s.shownPages);
+        u.fromCache = true;
+        s.deliverLocked(std::move(u));
+        s.prefetchLocked(lock);
+    } else if (Impl::hasMore(*e)) {
+        // If the prefetch is still running, wait for it rather than asking again
+        s.wantPage = s.shownPages + 1;
+        s.wantPrefetched = e->loading && !e->loadingToken.cancelled();
+        s.fetchPage(lock, s.wantPage);
+    }
+}
+
+void IncrementalSearch::cancel() {
+    Impl& s = *impl_;
+    std::lock_guard<std::mutex> lock(s.mutex);
+    ++s.generation;
+    s.key.clear();
+    s.text.clear();
+    s.shownPages = 0;
+    s.wantPage = 0;
+    s.deadline.reset();
+    s.inflight.cancel();
+    s.inflight = CancelSource();
+}
+
+size_t IncrementalSearch::networkRequests() const {
+    return impl_->requests.load();
+}
@@ -0,0 +1,114 @@
+// SPDX-License-Identifier: Apache-2.0
+//-------------------------------------------------------------------------------
+// Top100 — Your Personal Movie List
+//
+// File: lib/incremental_search.h
+// Purpose: Search-as-you-type over OMDb (debounce, cancellation, prefix reuse, prefetch).
+// Language: C++17 (header)
+//-------------------------------------------------------------------------------
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "async.h"
+#include "omdb.h"
+
+/**
+ * @brief Results delivered to an IncrementalSearch listener.
+ * @ingroup services
+ */
+struct SearchUpdate {
+    /** The query answered, as passed to setQuery() (trimmed) */
+    std::string query;
+    /** Hits from every page shown so far */
+    std::vector<OmdbSearchResult> results;
+    /** Hits across all pages, as reported by OMDb (0 if unknown) */
+    size_t totalResults = 0;
+    /** Filtered from an earlier, broader query; the network answer follows */
+    bool provisional = false;
+    /** Answered without a new request */
+    bool fromCache = false;
+    /** loadMore() can show further pages */
+    bool hasMore = false;
+};
+
+/**
+ * @brief Tuning for IncrementalSearch.
+ * @ingroup services
+ */
+struct IncrementalSearchOptions {
+    /** Quiet period after the last keystroke before a request goes out */
+    int debounceMs = 250;
+    /** Shorter queries clear the results instead of searching */
+    size_t minQueryLength = 2;
+    /** Fetch the page after the one shown in the background */
+    bool prefetchNextPage = true;
+    /** Queries kept in the in-memory result cache */
+    size_t cacheEntries = 64;
+    /** Page fetcher; empty = omdbSearchPageAsync(). Tests substitute a fake. */
+    std::function<Future<OmdbSearchPage>(const std::string& query, int page, CancelToken cancel)> fetch;
+};
+
+/**
+ * @brief Search-as-you-type engine shared by the add dialogs.
+ *
+ * Feed it every keystroke with setQuery(). Requests wait for a pause in
+ * typing (debounce); a request still in flight is cancelled as soon as the
+ * query changes. Answers are kept per query:
+ * - a repeated query is answered at once from memory;
+ * - a query that only adds words to a query whose results are complete is
+ *   answered by filtering those results, without a request;
+ * - otherwise the filtered results of the longest cached prefix are shown
+ *   at once as a provisional answer while the request runs.
+ *
+ * After each page is shown, the next one is fetched in the background, so
+ * loadMore() is usually instant.
+ *
+ * The listener runs on the engine's own thread, one update at a time, and
+ * only for the current query (stale answers are dropped). Marshal to the UI
+ * thread from there. It may call back into the engine.
+ *
+ * @ingroup services
+ */
+class IncrementalSearch {
+public:
+    /** Receives result updates. */
+    using Listener = std::function<void(const SearchUpdate&)>;
+
+    /**
+     * @brief Start the engine thread.
+     * @param apiKey OMDb API key (unused when @c opts.fetch is set)
+     * @param onUpdate Listener for result updates
+     * @param opts Debounce, cache and prefetch settings
+     */
+    IncrementalSearch(std::string apiKey, Listener onUpdate, IncrementalSearchOptions opts = {});
+    /** @brief Cancel outstanding requests and stop the engine thread. */
+    ~IncrementalSearch();
+    IncrementalSearch(const IncrementalSearch&) = delete;
+    IncrementalSearch& operator=(const IncrementalSearch&) = delete;
+
+    /**
+     * @brief The search text changed.
+     * @param text Current contents of the search box
+     */
+    void setQuery(const std::string& text);
+
+    /** @brief Skip the rest of the debounce period (e.g. Enter or a Search button). */
+    void submit();
+
+    /** @brief Show the next page of the current query (no-op if there is none). */
+    void loadMore();
+
+    /** @brief Drop the current query and cancel its requests. */
+    void cancel();
+
+    /** @return Page requests issued so far (for diagnostics and tests). */
+    size_t networkRequests() const;
+
+private:
+    struct Impl;
+    std::shared_ptr<Impl> impl_;
+};
@@ -13,12 +13,16 @@
 // Date: September 18, 2025
 //-------------------------------------------------------------------------------
 #include "mastodon.h"
-#include <cpr/cpr.h>
+#include "http.h"
 #include <nlohmann/json.hpp>
 
 /** @brief Local alias for nlohmann::json used in Mastodon helpers. */
 using json = nlohmann::json;
 
+static cpr::Header bearer(const std::string& accessToken) {
+    return cpr::Header{{"Authorization", std::string("Bearer ") + accessToken}};
+}
+
 static std::string joinUrl(const std::string& base, const std::string& path) {
     if (base.empty()) return path;
     if (base.back() == '/' && !path.empty() && path.front() == '/') return base + path.substr(1);
@@ -26,11 +30,14 @@ static std::string joinUrl(const std::string& base, const std::string& path) {
     return base + path;
 }
 
-bool mastoVerify(const std::string& instanceBaseUrl, const std::string& accessToken)
-{
-    if (instanceBaseUrl.empty() || accessToken.empty()) return false;
-    auto url = joinUrl(instanceBaseUrl, "/api/v1/accounts/verify_credentials");
-    auto r = cpr::Get(cpr::Url{url}, cpr::Bearer{accessToken});
+static HttpRequest verifyRequest(const std::string& instanceBaseUrl, const std::string& accessToken) {
+    HttpRequest req;
+    req.url = joinUrl(instanceBaseUrl, "/api/v1/accounts/verify_credentials");
+    req.header = bearer(accessToken);
+    return req;
+}
+
+static bool verifiedBy(const cpr::Response& r) {
     if (r.status_code != 200) return false;
     try {
         auto j = json::parse(r.text);
@@ -40,17 +47,19 @@ bool mastoVerify(const std::string& instanceBaseUrl, const std::string& accessTo
     }
 }
 
-std::optional<std::string> mastoUploadMedia(const std::string& instanceBaseUrl,
-                                            const std::string& accessToken,
-                                            const std::vector<unsigned char>& bytes,
-                                            const std::string& filename,
-                                            const std::string& contentType)
-{
-    if (bytes.empty()) return std::nullopt;
-    auto url = joinUrl(instanceBaseUrl, "/api/v1/media");
+static HttpRequest mediaRequest(const std::string& instanceBaseUrl, const std::string& accessToken,
+                                const std::vector<unsigned char>& bytes, const std::string& filename,
+                                const std::string& contentType) {
     cpr::Buffer buf{bytes.begin(), bytes.end(), filename};
-    cpr::Multipart mp{ { cpr::Part{"file", buf, contentType} } };
-    auto r = cpr::Post(cpr::Url{url}, mp, cpr::Bearer{accessToken});
+    HttpRequest req;
+    req.method = HttpRequest::Method::Post;
+    req.url = joinUrl(instanceBaseUrl, "/api/v1/media");
+    req.header = bearer(accessToken);
+    req.multipart = cpr::Multipart{ { cpr::Part{"file", buf, contentType} } };
+    return req;
+}
+
+static std::optional<std::string> mediaIdOf(const cpr::Response& r) {
     if (r.status_code < 200 || r.status_code >= 300) return std::nullopt;
     try {
         auto j = json::parse(r.text);
@@ -60,19 +69,73 @@ std::optional<std::string> mastoUploadMedia(const std::string& instanceBaseUrl,
     return std::nullopt;
 }
 
+static HttpRequest statusRequest(const std::string& instanceBaseUrl, const std::string& accessToken,
+                                 const std::string& text, const std::optional<std::string>& mediaId) {
+    HttpRequest req;
+    req.method = HttpRequest::Method::Post;
+    req.url = joinUrl(instanceBaseUrl, "/api/v1/statuses");
+    req.parameters.Add({"status", text});
+    req.header = bearer(accessToken);
+    if (mediaId && !mediaId->empty()) {
+        // media_ids[] repeated parameter; cpr supports it by adding with same key
+        req.parameters.Add({"media_ids[]", *mediaId});
+    }
+    return req;
+}
+
+static bool posted(const cpr::Response& r) {
+    return r.status_code >= 200 && r.status_code < 300;
+}
+
+bool mastoVerify(const std::string& instanceBaseUrl, const std::string& accessToken)
+{
+    if (instanceBaseUrl.empty() || accessToken.empty()) return false;
+    return verifiedBy(httpClient().perform(verifyRequest(instanceBaseUrl, accessToken)));
+}
+
+Future<bool> mastoVerifyAsync(const std::string& instanceBaseUrl, const std::string& accessToken, CancelToken cancel)
+{
+    if (instanceBaseUrl.empty() || accessToken.empty()) return readyFuture(false);
+    return httpClient().performAsync(verifyRequest(instanceBaseUrl, accessToken), std::move(cancel)).then(verifiedBy);
+}
+
+std::optional<std::string> mastoUploadMedia(const std::string& instanceBaseUrl,
+                                            const std::string& accessToken,
+                                            const std::vector<unsigned char>& bytes,
+                                            const std::string& filename,
+                                            const std::string& contentType)
+{
+    if (bytes.empty()) return std::nullopt;
+    return mediaIdOf(httpClient().perform(mediaRequest(instanceBaseUrl, accessToken, bytes, filename, contentType)));
+}
+
+Future<std::optional<std::string>> mastoUploadMediaAsync(const std::string& instanceBaseUrl,
+                                                         const std::string& accessToken,
+                                                         const std::vector<unsigned char>& bytes,
+                                                         const std::string& filename,
+                                                         const std::string& contentType,
+                                                         CancelToken cancel)
+{
+    if (bytes.empty()) return readyFuture(std::optional<std::string>());
+    return httpClient()
+        .performAsync(mediaRequest(instanceBaseUrl, accessToken, bytes, filename, contentType), std::move(cancel))
+        .then(mediaIdOf);
+}
+
 bool mastoPostStatus(const std::string& instanceBaseUrl,
                      const std::string& accessToken,
                      const std::string& text,
                      const std::optional<std::string>& mediaId)
 {
-    auto url = joinUrl(instanceBaseUrl, "/api/v1/statuses");
-    cpr::Parameters params{};
-    params.Add({"status", text});
-    cpr::Header headers{{"Authorization", std::string("Bearer ") + accessToken}};
-    if (mediaId && !mediaId->empty()) {
-        // media_ids[] repeated parameter; cpr supports it by adding with same key
-        params.Add({"media_ids[]", *mediaId});
-    }
-    auto r = cpr::Post(cpr::Url{url}, params, headers);
-    return r.status_code >= 200 && r.status_code < 300;
+    return posted(httpClient().perform(statusRequest(instanceBaseUrl, accessToken, text, mediaId)));
+}
+
+Future<bool> mastoPostStatusAsync(const std::string& instanceBaseUrl,
+                                  const std::string& accessToken,
+                                  const std::string& text,
+                                  const std::optional<std::string>& mediaId,
+                                  CancelToken cancel)
+{
+    return httpClient().performAsync(statusRequest(instanceBaseUrl, accessToken, text, mediaId), std::move(cancel))
+        .then(posted);
 }
@@ -14,6 +14,7 @@
 #include <string>
 #include <optional>
 #include <vector>
+#include "async.h"
 
 /** @defgroup services External service clients */
 /** Minimal Mastodon client helpers @ingroup services */
@@ -59,3 +60,48 @@ bool mastoPostStatus(const std::string& instanceBaseUrl,
                      const std::string& accessToken,
                      const std::string& text,
                      const std::optional<std::string>& mediaId);
+
+/**
+ * @brief Non-blocking mastoVerify().
+ * @param instanceBaseUrl Base URL of the Mastodon instance
+ * @param accessToken Access token
+ * @param cancel Cancels the request
+ * @return Future validity flag
+ * @ingroup services
+ */
+Future<bool> mastoVerifyAsync(const std::string& instanceBaseUrl, const std::string& accessToken,
+                              CancelToken cancel = {});
+
+/**
+ * @brief Non-blocking mastoUploadMedia().
+ * @param instanceBaseUrl Base URL of the Mastodon instance
+ * @param accessToken Access token
+ * @param bytes Raw image bytes
+ * @param filename Suggested filename
+ * @param contentType MIME type
+ * @param cancel Cancels the upload
+ * @return Future media id (std::nullopt on failure)
+ * @ingroup services
+ */
+Future<std::optional<std::string>> mastoUploadMediaAsync(const std::string& instanceBaseUrl,
+                                                         const std::string& accessToken,
+                                                         const std::vector<unsigned char>& bytes,
+                                                         const std::string& filename,
+                                                         const std::string& contentType,
+                                                         CancelToken cancel = {});
+
+/**
+ * @brief Non-blocking mastoPostStatus().
+ * @param instanceBaseUrl Base URL of the Mastodon instance
+ * @param accessToken Access token
+ * @param text Status text
+ * @param mediaId Optional media id
+ * @param cancel Cancels the request
+ * @return Future success flag
+ * @ingroup services
+ */
+Future<bool> mastoPostStatusAsync(const std::string& instanceBaseUrl,
+                                  const std::string& accessToken,
+                                  const std::string& text,
+                                  const std::optional<std::string>& mediaId,
+                                  CancelToken cancel = {});
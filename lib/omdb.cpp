@@ -10,128 +10,387 @@
 // Date: September 18, 2025
 //-------------------------------------------------------------------------------
 #include "omdb.h"
-#include <cpr/cpr.h>
-#include <nlohmann/json.hpp>
-#include <sstream>
-
-static int parseYear(const std::string& y) {
-    try {
-        return std::stoi(y.substr(0, 4));
-    } catch (...) {
-        return 0;
+#include "http.h"
+#include "omdb_cache.h"
+#include "omdb_decode.h"
+#include "title_index.h"
+#include <algorithm>
+#include <cstdlib>
+#include <mutex>
+
+static std::mutex gCacheMutex;
+
+static std::shared_ptr<OmdbCache>& cacheSlot() {
+    // Construct the HTTP client first so it outlives the cache's background refreshes
+    httpClient();
+    static std::shared_ptr<OmdbCache> slot;
+    return slot;
+}
+
+void omdbSetCache(std::shared_ptr<OmdbCache> cache) {
+    std::lock_guard<std::mutex> lock(gCacheMutex);
+    cacheSlot() = std::move(cache);
+}
+
+std::shared_ptr<OmdbCache> omdbCache() {
+    std::lock_guard<std::mutex> lock(gCacheMutex);
+    return cacheSlot();
+}
+
+static std::string defaultBaseUrl() {
+    const char* env = std::getenv("TOP100_OMDB_BASE_URL");
+    return env && *env ? std::string(env) : std::string("https://www.omdbapi.com/");
+}
+
+static std::string gBaseUrl = defaultBaseUrl();
+
+void omdbSetBaseUrl(const std::string& url) {
+    std::lock_guard<std::mutex> lock(gCacheMutex);
+    gBaseUrl = url.empty() ? defaultBaseUrl() : url;
+}
+
+std::string omdbBaseUrl() {
+    std::lock_guard<std::mutex> lock(gCacheMutex);
+    return gBaseUrl;
+}
+
+struct LocalIndex {
+    std::shared_ptr<TitleIndex> index;
+    OmdbLocalIndexMode mode = OmdbLocalIndexMode::Fallback;
+};
+
+static LocalIndex gLocalIndex;
+
+void omdbSetLocalIndex(std::shared_ptr<TitleIndex> index, OmdbLocalIndexMode mode) {
+    std::lock_guard<std::mutex> lock(gCacheMutex);
+    gLocalIndex = LocalIndex{std::move(index), mode};
+}
+
+OmdbLocalIndexMode omdbLocalIndexModeOf(const std::string& mode) {
+    return mode == "prefer" ? OmdbLocalIndexMode::Prefer : OmdbLocalIndexMode::Fallback;
+}
+
+static LocalIndex localIndex() {
+    std::lock_guard<std::mutex> lock(gCacheMutex);
+    return gLocalIndex;
+}
+
+// OMDb pages hold 10 hits; the index is paged the same way
+static OmdbSearchPage localSearch(const LocalIndex& local, const std::string& query, int page) {
+    return local.index->search(query, static_cast<size_t>(std::max(1, page) - 1) * 10, 10);
+}
+
+// Prefer mode: the index's answer, if it has one
+static std::optional<OmdbSearchPage> localSearchFirst(const LocalIndex& local, const std::string& query, int page) {
+    if (!local.index || local.mode != OmdbLocalIndexMode::Prefer) return std::nullopt;
+    OmdbSearchPage hits = localSearch(local, query, page);
+    if (hits.results.empty()) return std::nullopt;
+    return hits;
+}
+
+// Fallback mode: the index's answer when OMDb had none
+static OmdbSearchPage localSearchAfter(const LocalIndex& local, OmdbSearchPage fromOmdb, const std::string& query,
+                                       int page) {
+    if (!fromOmdb.results.empty() || !local.index || local.mode != OmdbLocalIndexMode::Fallback) return fromOmdb;
+    return localSearch(local, query, page);
+}
+
+static std::optional<Movie> localGetFirst(const LocalIndex& local, const std::string& imdbID) {
+    if (!local.index || local.mode != OmdbLocalIndexMode::Prefer) return std::nullopt;
+    return local.index->get(imdbID);
+}
+
+static std::optional<Movie> localGetAfter(const LocalIndex& local, std::optional<Movie> fromOmdb,
+                                          const std::string& imdbID) {
+    if (fromOmdb || !local.index || local.mode != OmdbLocalIndexMode::Fallback) return fromOmdb;
+    return local.index->get(imdbID);
+}
+
+// One OMDb request resolved through the cache
+struct CachedFetch {
+    std::string key;
+    HttpRequest req;
+    int64_t ttl = 0;
+    std::optional<std::string> body;
+    /** HTTP status of the network answer (-1 = answered from the cache, 0 = transport error) */
+    long status = -1;
+    /** Response text when no body could be used (OMDb explains 401s in JSON) */
+    std::string failure;
+};
+
+// Only real answers are cached, not "Response":"False" errors (bad key, quota, not found)
+static bool cacheable(const std::string& text) {
+    return omdbResponseOf(text) == OmdbResponse::Ok;
+}
+
+static HttpRequest withValidators(HttpRequest req, const std::optional<OmdbCacheEntry>& prior) {
+    if (!prior) return req;
+    if (!prior->etag.empty()) req.header["If-None-Match"] = prior->etag;
+    if (!prior->lastModified.empty()) req.header["If-Modified-Since"] = prior->lastModified;
+    return req;
+}
+
+// Store a network answer and return the body to use. A 304 or a failed refetch
+// falls back to the cached body.
+static std::optional<std::string> remember(OmdbCache* cache, const std::string& key, const cpr::Response& r,
+                                           const std::optional<OmdbCacheEntry>& prior) {
+    if (r.status_code == 304 && prior) {
+        if (cache) cache->touch(key, OmdbCache::now());
+        return prior->body;
+    }
+    if (r.status_code != 200 || !cacheable(r.text)) {
+        if (prior) return prior->body;
+        if (r.status_code != 200) return std::nullopt;
+        return r.text;
+    }
+    if (cache) {
+        OmdbCacheEntry e;
+        e.body = r.text;
+        e.fetchedAt = OmdbCache::now();
+        auto it = r.header.find("ETag");
+        if (it != r.header.end()) e.etag = it->second;
+        it = r.header.find("Last-Modified");
+        if (it != r.header.end()) e.lastModified = it->second;
+        cache->store(key, e);
+    }
+    return r.text;
+}
+
+// Requests still needed after consulting the cache
+struct FetchPlan {
+    std::shared_ptr<OmdbCache> cache;
+    std::vector<std::optional<OmdbCacheEntry>> prior;
+    std::vector<size_t> pending;
+    std::vector<HttpRequest> reqs;
+};
+
+// Answer fresh entries from the cache, serve stale ones while a background
+// refresh runs (if enabled), and plan requests for the rest. @p revalidate
+// sends every request (conditionally, if an entry exists).
+static FetchPlan planFetches(std::vector<CachedFetch>& fetches, bool revalidate) {
+    FetchPlan plan;
+    plan.cache = omdbCache();
+    const auto& cache = plan.cache;
+    const int64_t now = OmdbCache::now();
+    plan.prior.resize(fetches.size());
+    for (size_t i = 0; i < fetches.size(); ++i) {
+        CachedFetch& f = fetches[i];
+        auto& prior = plan.prior[i];
+        if (cache) prior = cache->lookup(f.key);
+        if (prior && !revalidate) {
+            const int64_t age = now - prior->fetchedAt;
+            if (age >= 0 && age < f.ttl) {
+                f.body = prior->body;
+                continue;
+            }
+            const OmdbCacheOptions& o = cache->options();
+            if (o.staleWhileRevalidate && age < f.ttl + o.maxStaleSeconds) {
+                f.body = prior->body;
+                // The cache outlives its own refresh pool, so a raw pointer is safe here
+                OmdbCache* c = cache.get();
+                HttpRequest req = withValidators(f.req, prior);
+                cache->revalidateAsync(f.key, [c, key = f.key, req, entry = prior]() {
+                    remember(c, key, httpClient().perform(req), entry);
+                });
+                continue;
+            }
+        }
+        plan.reqs.push_back(withValidators(f.req, prior));
+        plan.pending.push_back(i);
     }
+    return plan;
 }
 
-static int parseRuntimeMinutes(const std::string& runtime) {
-    // e.g., "148 min" -> 148
-    try {
-        size_t pos = runtime.find(' ');
-        std::string num = (pos == std::string::npos) ? runtime : runtime.substr(0, pos);
-        return std::stoi(num);
-    } catch (...) {
-        return 0;
+// Store the network answers for the planned requests
+static void completeFetches(std::vector<CachedFetch>& fetches, const FetchPlan& plan,
+                            const std::vector<cpr::Response>& rs) {
+    for (size_t k = 0; k < plan.pending.size(); ++k) {
+        const size_t i = plan.pending[k];
+        fetches[i].body = remember(plan.cache.get(), fetches[i].key, rs[k], plan.prior[i]);
+        fetches[i].status = rs[k].status_code;
+        if (!fetches[i].body) fetches[i].failure = rs[k].text;
     }
 }
 
-static std::vector<std::string> splitCommaTrim(const std::string& s, size_t limit = SIZE_MAX) {
-    std::vector<std::string> out;
-    std::stringstream ss(s);
-    std::string item;
-    while (std::getline(ss, item, ',')) {
-        // trim leading/trailing spaces
-        size_t start = item.find_first_not_of(" \t\n\r");
-        size_t end = item.find_last_not_of(" \t\n\r");
-        std::string trimmed = (start == std::string::npos) ? std::string() : item.substr(start, end - start + 1);
-        if (!trimmed.empty()) out.push_back(trimmed);
-        if (out.size() >= limit) break;
+static void fetchThroughCache(std::vector<CachedFetch>& fetches, bool revalidate = false) {
+    FetchPlan plan = planFetches(fetches, revalidate);
+    if (plan.reqs.empty()) return;
+    completeFetches(fetches, plan, httpClient().performAll(plan.reqs));
+}
+
+// fetchThroughCache() on the HTTP event loop
+static Future<std::vector<CachedFetch>> fetchThroughCacheAsync(std::vector<CachedFetch> fetches, bool revalidate,
+                                                               const CancelToken& cancel) {
+    auto plan = std::make_shared<FetchPlan>(planFetches(fetches, revalidate));
+    if (plan->reqs.empty()) return readyFuture(std::move(fetches));
+    std::vector<Future<cpr::Response>> rs;
+    rs.reserve(plan->reqs.size());
+    for (const auto& req : plan->reqs) rs.push_back(httpClient().performAsync(req, cancel));
+    return whenAll(rs).then([fetches = std::move(fetches), plan](const std::vector<cpr::Response>& responses) mutable {
+        completeFetches(fetches, *plan, responses);
+        return fetches;
+    });
+}
+
+static int64_t ttlOf(int64_t OmdbCacheOptions::*field) {
+    auto cache = omdbCache();
+    return cache ? cache->options().*field : 0;
+}
+
+static CachedFetch searchFetch(const std::string& apiKey, const std::string& query, int page = 1) {
+    CachedFetch f;
+    f.key = OmdbCache::searchKey(query);
+    f.req.url = omdbBaseUrl();
+    f.req.parameters = cpr::Parameters{{"apikey", apiKey}, {"s", query}};
+    if (page > 1) {
+        f.key += "#" + std::to_string(page);
+        f.req.parameters.Add({"page", std::to_string(page)});
     }
-    return out;
+    f.ttl = ttlOf(&OmdbCacheOptions::searchTtlSeconds);
+    return f;
+}
+
+static OmdbSearchPage searchPageOf(const std::optional<std::string>& body) {
+    if (!body) return OmdbSearchPage{};
+    return omdbDecodeSearch(*body).page;
 }
 
 std::vector<OmdbSearchResult> omdbSearch(const std::string& apiKey, const std::string& query) {
-    std::vector<OmdbSearchResult> out;
-    auto r = cpr::Get(cpr::Url{"https://www.omdbapi.com/"},
-                      cpr::Parameters{{"apikey", apiKey}, {"s", query}});
-    if (r.status_code != 200) return out;
-    auto j = nlohmann::json::parse(r.text, nullptr, false);
-    if (j.is_discarded() || !j.contains("Search")) return out;
-    for (const auto& item : j["Search"]) {
-        OmdbSearchResult s;
-        s.title = item.value("Title", "");
-        s.year = parseYear(item.value("Year", "0"));
-        s.imdbID = item.value("imdbID", "");
-        s.type = item.value("Type", "");
-        out.push_back(std::move(s));
+    const LocalIndex local = localIndex();
+    if (auto hits = localSearchFirst(local, query, 1)) return hits->results;
+    std::vector<CachedFetch> fetch{searchFetch(apiKey, query)};
+    fetchThroughCache(fetch);
+    return localSearchAfter(local, searchPageOf(fetch[0].body), query, 1).results;
+}
+
+Future<std::vector<OmdbSearchResult>> omdbSearchAsync(const std::string& apiKey, const std::string& query,
+                                                      CancelToken cancel) {
+    return omdbSearchPageAsync(apiKey, query, 1, std::move(cancel))
+        .then([](const OmdbSearchPage& page) { return page.results; });
+}
+
+Future<OmdbSearchPage> omdbSearchPageAsync(const std::string& apiKey, const std::string& query, int page,
+                                           CancelToken cancel) {
+    const LocalIndex local = localIndex();
+    if (auto hits = localSearchFirst(local, query, page)) return readyFuture(std::move(*hits));
+    return fetchThroughCacheAsync({searchFetch(apiKey, query, std::max(1, page))}, false, cancel)
+        .then([local, query, page](const std::vector<CachedFetch>& fetch) {
+            return localSearchAfter(local, searchPageOf(fetch[0].body), query, page);
+        });
+}
+
+static CachedFetch detailFetch(const std::string& apiKey, const std::string& imdbID, const char* plot,
+                               int64_t ttl) {
+    CachedFetch f;
+    f.key = OmdbCache::detailKey(imdbID, plot);
+    f.req.url = omdbBaseUrl();
+    f.req.parameters = cpr::Parameters{{"apikey", apiKey}, {"i", imdbID}, {"plot", plot}};
+    f.ttl = ttl;
+    return f;
+}
+
+// Why a detail lookup produced no movie. OMDb reports most errors as
+// {"Response":"False","Error":"..."}, with HTTP 200 or 401.
+static OmdbError classifyFailure(const CachedFetch& f) {
+    const std::string& text = f.body ? *f.body : f.failure;
+    std::string err;
+    if (omdbResponseOf(text, &err) == OmdbResponse::Error) {
+        if (err.find("limit") != std::string::npos) return OmdbError::QuotaExceeded;
+        if (err.find("API key") != std::string::npos) return OmdbError::InvalidKey;
+        return OmdbError::NotFound;
     }
-    return out;
+    if (f.status == 401) return OmdbError::InvalidKey;
+    if (f.status == 404) return OmdbError::NotFound;
+    // Transport errors, throttling, server errors and unparseable answers may succeed later
+    return OmdbError::Transient;
 }
 
-std::optional<Movie> omdbGetById(const std::string& apiKey, const std::string& imdbID) {
-    // Fetch full plot first
-    auto rFull = cpr::Get(cpr::Url{"https://www.omdbapi.com/"},
-                          cpr::Parameters{{"apikey", apiKey}, {"i", imdbID}, {"plot", "full"}});
-    if (rFull.status_code != 200) return std::nullopt;
-    auto j = nlohmann::json::parse(rFull.text, nullptr, false);
-    if (j.is_discarded()) return std::nullopt;
-
-    Movie m;
-    m.title = j.value("Title", "");
-    m.year = parseYear(j.value("Year", "0"));
-    m.director = j.value("Director", "");
-    m.imdbID = j.value("imdbID", imdbID);
-    m.source = "omdb";
-    m.actors = splitCommaTrim(j.value("Actors", ""), 10);
-    m.genres = splitCommaTrim(j.value("Genre", ""));
-    m.runtimeMinutes = parseRuntimeMinutes(j.value("Runtime", "0"));
-    m.countries = splitCommaTrim(j.value("Country", ""));
-    m.posterUrl = j.value("Poster", "");
-    // Plot fields
-    m.plotFull = j.value("Plot", std::string());
-    // If you want to also store the short plot, fetch it too
-    auto rShort = cpr::Get(cpr::Url{"https://www.omdbapi.com/"},
-                           cpr::Parameters{{"apikey", apiKey}, {"i", imdbID}, {"plot", "short"}});
-    if (rShort.status_code == 200) {
-        auto js = nlohmann::json::parse(rShort.text, nullptr, false);
-        if (!js.is_discarded()) {
-            m.plotShort = js.value("Plot", std::string());
-        }
+// The full response carries the ratings, so it expires sooner than the
+// short-plot one. Variants that miss the cache go out together (multiplexed
+// on one pooled connection): one round-trip instead of two.
+static std::vector<CachedFetch> detailFetches(const std::string& apiKey, const std::string& imdbID,
+                                              const OmdbDetailOptions& opts) {
+    std::vector<CachedFetch> fetches{detailFetch(apiKey, imdbID, "full", ttlOf(&OmdbCacheOptions::ratingsTtlSeconds))};
+    if (opts.fetchShortPlot) {
+        fetches.push_back(detailFetch(apiKey, imdbID, "short", ttlOf(&OmdbCacheOptions::metadataTtlSeconds)));
     }
-    // Ratings
-    // imdbRating can be "N/A" or a string like "7.8"
-    {
-        std::string ir = j.value("imdbRating", "0");
-        try { m.imdbRating = (ir == "N/A" ? 0.0 : std::stod(ir)); } catch (...) { m.imdbRating = 0.0; }
+    return fetches;
+}
+
+static OmdbDetailResult detailResultOf(const std::vector<CachedFetch>& fetches, const std::string& imdbID,
+                                       const OmdbDetailOptions& opts) {
+    OmdbDetailResult result;
+    OmdbDecodedDetail full;
+    if (fetches[0].body) full = omdbDecodeDetail(*fetches[0].body, imdbID);
+    if (full.response != OmdbResponse::Ok) {
+        result.error = classifyFailure(fetches[0]);
+        return result;
     }
-    {
-        std::string ms = j.value("Metascore", "0");
-        try { m.metascore = (ms == "N/A" ? 0 : std::stoi(ms)); } catch (...) { m.metascore = 0; }
+    Movie& m = full.movie;
+    m.plotFull = std::move(full.plot);
+    if (fetches.size() > 1 && fetches[1].body) m.plotShort = omdbDecodeDetail(*fetches[1].body).plot;
+    if (m.plotShort.empty()) m.plotShort = deriveShortPlot(m.plotFull, opts.shortPlotChars);
+    m.updatedAt = OmdbCache::now();
+    result.movie = std::move(m);
+    return result;
+}
+
+OmdbDetailResult omdbFetchDetail(const std::string& apiKey, const std::string& imdbID,
+                                 const OmdbDetailOptions& opts) {
+    std::vector<CachedFetch> fetches = detailFetches(apiKey, imdbID, opts);
+    fetchThroughCache(fetches, opts.revalidate);
+    return detailResultOf(fetches, imdbID, opts);
+}
+
+Future<OmdbDetailResult> omdbFetchDetailAsync(const std::string& apiKey, const std::string& imdbID,
+                                              const OmdbDetailOptions& opts, CancelToken cancel) {
+    return fetchThroughCacheAsync(detailFetches(apiKey, imdbID, opts), opts.revalidate, cancel)
+        .then([imdbID, opts](const std::vector<CachedFetch>& fetches) { return detailResultOf(fetches, imdbID, opts); });
+}
+
+Future<std::optional<Movie>> omdbGetByIdAsync(const std::string& apiKey, const std::string& imdbID,
+                                              const OmdbDetailOptions& opts, CancelToken cancel) {
+    const LocalIndex local = localIndex();
+    if (auto m = localGetFirst(local, imdbID)) return readyFuture(std::move(m));
+    return omdbFetchDetailAsync(apiKey, imdbID, opts, std::move(cancel))
+        .then([local, imdbID](const OmdbDetailResult& r) { return localGetAfter(local, r.movie, imdbID); });
+}
+
+std::optional<Movie> omdbGetById(const std::string& apiKey, const std::string& imdbID,
+                                 const OmdbDetailOptions& opts) {
+    const LocalIndex local = localIndex();
+    if (auto m = localGetFirst(local, imdbID)) return m;
+    return localGetAfter(local, omdbFetchDetail(apiKey, imdbID, opts).movie, imdbID);
+}
+
+std::optional<Movie> omdbGetById(const std::string& apiKey, const std::string& imdbID) {
+    return omdbGetById(apiKey, imdbID, OmdbDetailOptions{});
+}
+
+std::string deriveShortPlot(const std::string& full, size_t maxChars) {
+    if (full.size() <= maxChars) return full;
+    // Longest prefix of whole sentences that fits
+    size_t cut = std::string::npos;
+    for (size_t i = 0; i < maxChars; ++i) {
+        const char c = full[i];
+        if ((c == '.' || c == '!' || c == '?') && (full[i + 1] == ' ' || full[i + 1] == '\n')) cut = i + 1;
     }
-    // Ratings array: find Rotten Tomatoes
-    if (j.contains("Ratings") && j["Ratings"].is_array()) {
-        for (const auto& r : j["Ratings"]) {
-            std::string src = r.value("Source", "");
-            if (src == "Rotten Tomatoes") {
-                std::string val = r.value("Value", "0%");
-                // Typically like "87%" or "N/A"
-                size_t pos = val.find('%');
-                std::string num = (pos == std::string::npos) ? val : val.substr(0, pos);
-                try { m.rottenTomatoes = (val == "N/A" ? 0 : std::stoi(num)); } catch (...) { m.rottenTomatoes = 0; }
-                break;
-            }
-        }
+    if (cut != std::string::npos) return full.substr(0, cut);
+    // Otherwise the last word boundary, leaving room for the ellipsis
+    const size_t limit = maxChars > 3 ? maxChars - 3 : 0;
+    size_t end = full.find_last_of(' ', limit);
+    if (end == std::string::npos || end == 0) {
+        end = limit;
+        while (end > 0 && (static_cast<unsigned char>(full[end]) & 0xC0u) == 0x80u) --end;
     }
-    return m;
+    while (end > 0 && (full[end - 1] == ' ' || full[end - 1] == ',' || full[end - 1] == ';')) --end;
+    return full.substr(0, end) + "...";
 }
 
 // Simple API key verification: perform a benign query and check for valid JSON
 bool omdbVerifyKey(const std::string& apiKey) {
-    auto r = cpr::Get(cpr::Url{"https://www.omdbapi.com/"},
-                      cpr::Parameters{{"apikey", apiKey}, {"s", "test"}});
+    auto r = httpClient().get(omdbBaseUrl(), cpr::Parameters{{"apikey", apiKey}, {"s", "test"}});
     if (r.status_code != 200) return false;
-    auto j = nlohmann::json::parse(r.text, nullptr, false);
-    if (j.is_discarded()) return false;
     // OMDb returns { "Response":"False", "Error":"Invalid API key!" } for bad keys
-    std::string resp = j.value("Response", "");
-    if (resp == "False") return false;
-    return true;
+    return omdbResponseOf(r.text) == OmdbResponse::Ok;
 }
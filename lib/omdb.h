@@ -13,7 +13,12 @@
 #include <string>
 #include <vector>
 #include <optional>
+#include <memory>
 #include "Movie.h"
+#include "async.h"
+
+class OmdbCache;
+class TitleIndex;
 
 /**
  * @brief Basic OMDb search hit.
@@ -30,6 +35,86 @@ struct OmdbSearchResult {
     std::string type;
 };
 
+/**
+ * @brief One page (up to 10 hits) of an OMDb search.
+ * @ingroup services
+ */
+struct OmdbSearchPage {
+    /** Hits on this page */
+    std::vector<OmdbSearchResult> results;
+    /** Hits across all pages, as reported by OMDb (0 if none or on failure) */
+    size_t totalResults = 0;
+};
+
+/**
+ * @brief Route omdbSearch() and omdbGetById() through a persistent cache.
+ *
+ * Fresh entries are answered without a request; expired ones are revalidated
+ * (ETag / Last-Modified) or, in stale-while-revalidate mode, served at once
+ * while a background refresh runs. Pass nullptr to always go to the network.
+ *
+ * @param cache Cache (see openOmdbCache()), or nullptr
+ * @ingroup services
+ */
+void omdbSetCache(std::shared_ptr<OmdbCache> cache);
+
+/**
+ * @brief The cache set by omdbSetCache().
+ * @return Cache, or nullptr
+ * @ingroup services
+ */
+std::shared_ptr<OmdbCache> omdbCache();
+
+/**
+ * @brief Send OMDb requests to another server (a fixture, a proxy, a mirror).
+ *
+ * The default is https://www.omdbapi.com/, or the TOP100_OMDB_BASE_URL
+ * environment variable when set. Pass an empty string to restore it.
+ *
+ * @param url Base URL requests are made against, e.g. "http://127.0.0.1:8080/"
+ * @ingroup services
+ */
+void omdbSetBaseUrl(const std::string& url);
+
+/**
+ * @brief The URL OMDb requests go to.
+ * @return Base URL
+ * @ingroup services
+ */
+std::string omdbBaseUrl();
+
+/**
+ * @brief When the offline title index answers instead of OMDb.
+ * @ingroup services
+ */
+enum class OmdbLocalIndexMode {
+    /** Ask OMDb first; use the index when OMDb fails or finds nothing */
+    Fallback,
+    /** Ask the index first; go to OMDb only when it finds nothing */
+    Prefer
+};
+
+/**
+ * @brief Let searches and lookups by ID use an offline title index.
+ *
+ * Applies to omdbSearch(), omdbGetById() and their async variants. Titles from
+ * the index carry no plot or poster (source "imdb"). omdbFetchDetail(), used
+ * by refreshes, always goes to OMDb. Pass nullptr to stop using an index.
+ *
+ * @param index Index (see openTitleIndex()), or nullptr
+ * @param mode Whether the index backs up OMDb or is asked first
+ * @ingroup services
+ */
+void omdbSetLocalIndex(std::shared_ptr<TitleIndex> index, OmdbLocalIndexMode mode = OmdbLocalIndexMode::Fallback);
+
+/**
+ * @brief Parse the omdbLocalIndexMode setting.
+ * @param mode "prefer" or "fallback" (anything else)
+ * @return Mode
+ * @ingroup services
+ */
+OmdbLocalIndexMode omdbLocalIndexModeOf(const std::string& mode);
+
 /**
  * @brief Query OMDb by title keyword and return basic results.
  * @param apiKey OMDb API key
@@ -39,14 +124,145 @@ struct OmdbSearchResult {
  */
 std::vector<OmdbSearchResult> omdbSearch(const std::string& apiKey, const std::string& query);
 
+/**
+ * @brief Tuning for omdbGetById().
+ * @ingroup services
+ */
+struct OmdbDetailOptions {
+    /** Request OMDb's own short plot alongside the full one; when false the
+     *  short plot is derived locally from the full plot (one request only) */
+    bool fetchShortPlot = true;
+    /** Length limit for a locally derived short plot */
+    size_t shortPlotChars = 200;
+    /** Explicit refresh: revalidate with OMDb even if the cached answer is fresh */
+    bool revalidate = false;
+};
+
+/**
+ * @brief Why a detail lookup failed.
+ * @ingroup services
+ */
+enum class OmdbError {
+    None,           ///< Success
+    NotFound,       ///< OMDb has no such title (or rejected the ID)
+    Transient,      ///< Network error, throttling or server error; worth retrying
+    QuotaExceeded,  ///< Daily request limit reached; retrying won't help today
+    InvalidKey      ///< The API key was rejected
+};
+
+/**
+ * @brief Outcome of omdbFetchDetail().
+ * @ingroup services
+ */
+struct OmdbDetailResult {
+    /** Mapped movie (updatedAt set to the fetch time); empty on failure */
+    std::optional<Movie> movie;
+    /** Failure reason when @c movie is empty */
+    OmdbError error = OmdbError::None;
+};
+
+/**
+ * @brief omdbGetById() with the reason for a failure.
+ * @param apiKey OMDb API key
+ * @param imdbID IMDb identifier
+ * @param opts Plot variant options
+ * @return Movie, or the error class (see OmdbError)
+ * @ingroup services
+ */
+OmdbDetailResult omdbFetchDetail(const std::string& apiKey, const std::string& imdbID,
+                                 const OmdbDetailOptions& opts = {});
+
 /**
  * @brief Fetch full details for a movie by imdbID and map to Movie.
+ *
+ * The plot=full and plot=short variants are requested concurrently, multiplexed
+ * over one HTTP/2 connection where the server supports it, so a lookup costs a
+ * single round-trip. If the short request fails the short plot is derived from
+ * the full one.
+ *
+ * @param apiKey OMDb API key
+ * @param imdbID IMDb identifier
+ * @param opts Plot variant options
+ * @return Movie on success
+ * @ingroup services
+ */
+std::optional<Movie> omdbGetById(const std::string& apiKey, const std::string& imdbID,
+                                 const OmdbDetailOptions& opts);
+
+/**
+ * @brief Fetch full details for a movie by imdbID with default options.
  * @param apiKey OMDb API key
  * @param imdbID IMDb identifier
  * @return Movie on success
  * @ingroup services
  */
 std::optional<Movie> omdbGetById(const std::string& apiKey, const std::string& imdbID);
+
+/**
+ * @brief Non-blocking omdbSearch().
+ *
+ * Cache hits complete at once; misses go out on the shared HTTP event loop
+ * without occupying a thread.
+ *
+ * @param apiKey OMDb API key
+ * @param query Title search text
+ * @param cancel Cancels the request (the future then completes as cancelled)
+ * @return Future for the results (empty on failure)
+ * @ingroup services
+ */
+Future<std::vector<OmdbSearchResult>> omdbSearchAsync(const std::string& apiKey, const std::string& query,
+                                                      CancelToken cancel = {});
+
+/**
+ * @brief Non-blocking fetch of one page of search results.
+ * @param apiKey OMDb API key
+ * @param query Title search text
+ * @param page 1-based page number
+ * @param cancel Cancels the request
+ * @return Future page (empty on failure)
+ * @ingroup services
+ */
+Future<OmdbSearchPage> omdbSearchPageAsync(const std::string& apiKey, const std::string& query, int page,
+                                           CancelToken cancel = {});
+
+/**
+ * @brief Non-blocking omdbFetchDetail().
+ * @param apiKey OMDb API key
+ * @param imdbID IMDb identifier
+ * @param opts Plot variant options
+ * @param cancel Cancels the outstanding requests
+ * @return Future for the movie or the error class
+ * @ingroup services
+ */
+Future<OmdbDetailResult> omdbFetchDetailAsync(const std::string& apiKey, const std::string& imdbID,
+                                              const OmdbDetailOptions& opts = {}, CancelToken cancel = {});
+
+/**
+ * @brief Non-blocking omdbGetById().
+ * @param apiKey OMDb API key
+ * @param imdbID IMDb identifier
+ * @param opts Plot variant options
+ * @param cancel Cancels the outstanding requests
+ * @return Future for the movie (empty optional on failure)
+ * @ingroup services
+ */
+Future<std::optional<Movie>> omdbGetByIdAsync(const std::string& apiKey, const std::string& imdbID,
+                                              const OmdbDetailOptions& opts = {}, CancelToken cancel = {});
+
+/**
+ * @brief Shorten a full plot to at most @p maxChars characters.
+ *
+ * Keeps as many whole sentences as fit; if even the first sentence is too long,
+ * cuts at the last word boundary and appends "...". Never splits a UTF-8
+ * sequence.
+ *
+ * @param full Full plot text
+ * @param maxChars Length limit in bytes
+ * @return Short plot (the input unchanged if it already fits)
+ * @ingroup services
+ */
+std::string deriveShortPlot(const std::string& full, size_t maxChars = 200);
+
 /**
  * @brief Verify OMDb API key by issuing a simple request.
  * @param apiKey OMDb API key
@@ -0,0 +1,185 @@
+// SPDX-License-Identifier: Apache-2.0
+//-------------------------------------------------------------------------------
+// Top100 — Your Personal Movie List
+//
+// File: lib/omdb_cache.cpp
+// Purpose: Persistent OMDb response cache (SQLite) with TTLs and revalidation.
+// Language: C++17 (CMake build)
+//-------------------------------------------------------------------------------
+#include "omdb_cache.h"
+#include "config.h"
+#include "thread_pool.h"
+#include <cctype>
+#include <chrono>
+#ifndef TOP100_NO_SQLITE
+#include <sqlite3.h>
+#endif
+
+OmdbCache::OmdbCache(const std::string& dbPath, OmdbCacheOptions opts)
+    : opts_(opts), refresher_(std::make_unique<ThreadPool>(2)) {
+#ifndef TOP100_NO_SQLITE
+    if (dbPath.empty()) return;
+    sqlite3* db = nullptr;
+    const int flags = SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_FULLMUTEX;
+    if (sqlite3_open_v2(dbPath.c_str(), &db, flags, nullptr) != SQLITE_OK) {
+        if (db) sqlite3_close(db);
+        return;
+    }
+    // Other front ends may hold the database briefly
+    sqlite3_busy_timeout(db, 2000);
+    const char* sql = R"SQL(
+        CREATE TABLE IF NOT EXISTS omdb_cache(
+            key TEXT PRIMARY KEY,
+            body TEXT NOT NULL,
+            fetchedAt INTEGER NOT NULL,
+            etag TEXT,
+            lastModified TEXT
+        );
+    )SQL";
+    if (sqlite3_exec(db, sql, nullptr, nullptr, nullptr) != SQLITE_OK) {
+        sqlite3_close(db);
+        return;
+    }
+    db_ = db;
+#else
+    (void)dbPath;
+#endif
+}
+
+OmdbCache::~OmdbCache() {
+    refresher_.reset();
+#ifndef TOP100_NO_SQLITE
+    if (db_) sqlite3_close(db_);
+#endif
+}
+
+std::optional<OmdbCacheEntry> OmdbCache::lookup(const std::string& key) const {
+#ifndef TOP100_NO_SQLITE
+    if (!db_) return std::nullopt;
+    std::lock_guard<std::mutex> lock(mutex_);
+    sqlite3_stmt* st = nullptr;
+    const char* sel = "SELECT body, fetchedAt, etag, lastModified FROM omdb_cache WHERE key=?";
+    if (sqlite3_prepare_v2(db_, sel, -1, &st, nullptr) != SQLITE_OK) return std::nullopt;
+    sqlite3_bind_text(st, 1, key.c_str(), -1, SQLITE_TRANSIENT);
+    std::optional<OmdbCacheEntry> out;
+    if (sqlite3_step(st) == SQLITE_ROW) {
+        auto text = [&](int col) {
+            const unsigned char* p = sqlite3_column_text(st, col);
+            return p ? std::string(reinterpret_cast<const char*>(p), static_cast<size_t>(sqlite3_column_bytes(st, col)))
+                     : std::string();
+        };
+        OmdbCacheEntry e;
+        e.body = text(0);
+        e.fetchedAt = sqlite3_column_int64(st, 1);
+        e.etag = text(2);
+        e.lastModified = text(3);
+        out = std::move(e);
+    }
+    sqlite3_finalize(st);
+    return out;
+#else
+    (void)key;
+    return std::nullopt;
+#endif
+}
+
+void OmdbCache::store(const std::string& key, const OmdbCacheEntry& entry) {
+#ifndef TOP100_NO_SQLITE
+    if (!db_) return;
+    std::lock_guard<std::mutex> lock(mutex_);
+    sqlite3_stmt* st = nullptr;
+    const char* ins = "INSERT INTO omdb_cache(key, body, fetchedAt, etag, lastModified) VALUES(?,?,?,?,?) "
+                      "ON CONFLICT(key) DO UPDATE SET body=excluded.body, fetchedAt=excluded.fetchedAt, "
+                      "etag=excluded.etag, lastModified=excluded.lastModified";
+    if (sqlite3_prepare_v2(db_, ins, -1, &st, nullptr) != SQLITE_OK) return;
+    sqlite3_bind_text(st, 1, key.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(st, 2, entry.body.c_str(), static_cast<int>(entry.body.size()), SQLITE_TRANSIENT);
+    sqlite3_bind_int64(st, 3, entry.fetchedAt);
+    sqlite3_bind_text(st, 4, entry.etag.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(st, 5, entry.lastModified.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_step(st);
+    sqlite3_finalize(st);
+#else
+    (void)key;
+    (void)entry;
+#endif
+}
+
+void OmdbCache::touch(const std::string& key, int64_t fetchedAt) {
+#ifndef TOP100_NO_SQLITE
+    if (!db_) return;
+    std::lock_guard<std::mutex> lock(mutex_);
+    sqlite3_stmt* st = nullptr;
+    if (sqlite3_prepare_v2(db_, "UPDATE omdb_cache SET fetchedAt=? WHERE key=?", -1, &st, nullptr) != SQLITE_OK) return;
+    sqlite3_bind_int64(st, 1, fetchedAt);
+    sqlite3_bind_text(st, 2, key.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_step(st);
+    sqlite3_finalize(st);
+#else
+    (void)key;
+    (void)fetchedAt;
+#endif
+}
+
+void OmdbCache::clear() {
+#ifndef TOP100_NO_SQLITE
+    if (!db_) return;
+    std::lock_guard<std::mutex> lock(mutex_);
+    sqlite3_exec(db_, "DELETE FROM omdb_cache", nullptr, nullptr, nullptr);
+#endif
+}
+
+bool OmdbCache::revalidateAsync(const std::string& key, std::function<void()> refresh) {
+    {
+        std::lock_guard<std::mutex> lock(pendingMutex_);
+        if (!pending_.insert(key).second) return false;
+    }
+    refresher_->submit([this, key, refresh = std::move(refresh)]() {
+        try { refresh(); } catch (...) {}
+        std::lock_guard<std::mutex> lock(pendingMutex_);
+        pending_.erase(key);
+        idle_.notify_all();
+    });
+    return true;
+}
+
+void OmdbCache::waitIdle() {
+    std::unique_lock<std::mutex> lock(pendingMutex_);
+    idle_.wait(lock, [this]() { return pending_.empty(); });
+}
+
+int64_t OmdbCache::now() {
+    using namespace std::chrono;
+    return duration_cast<seconds>(system_clock::now().time_since_epoch()).count();
+}
+
+std::string OmdbCache::searchKey(const std::string& query) {
+    std::string key = "search:";
+    bool space = false;
+    for (unsigned char c : query) {
+        if (std::isspace(c)) { space = true; continue; }
+        if (space && key.size() > 7) key += ' ';
+        space = false;
+        key += static_cast<char>(std::tolower(c));
+    }
+    return key;
+}
+
+std::string OmdbCache::detailKey(const std::string& imdbID, const std::string& plot) {
+    std::string id;
+    for (unsigned char c : imdbID) {
+        if (!std::isspace(c)) id += static_cast<char>(std::tolower(c));
+    }
+    return "title:" + id + ":" + plot;
+}
+
+std::shared_ptr<OmdbCache> openOmdbCache(const AppConfig& cfg) {
+    if (!cfg.omdbCacheEnabled || cfg.dataFile.empty()) return nullptr;
+    OmdbCacheOptions opts;
+    opts.ratingsTtlSeconds = static_cast<int64_t>(cfg.omdbCacheRatingsTtlHours) * 3600;
+    opts.metadataTtlSeconds = static_cast<int64_t>(cfg.omdbCacheMetadataTtlDays) * 24 * 3600;
+    opts.searchTtlSeconds = opts.metadataTtlSeconds < 7 * 24 * 3600 ? opts.metadataTtlSeconds : 7 * 24 * 3600;
+    opts.staleWhileRevalidate = cfg.omdbCacheStaleWhileRevalidate;
+    auto cache = std::make_shared<OmdbCache>(cfg.dataFile, opts);
+    return cache->isOpen() ? cache : nullptr;
+}
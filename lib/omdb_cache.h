@@ -0,0 +1,158 @@
+// SPDX-License-Identifier: Apache-2.0
+//-------------------------------------------------------------------------------
+// Top100 — Your Personal Movie List
+//
+// File: lib/omdb_cache.h
+// Purpose: Persistent OMDb response cache (SQLite) with TTLs and revalidation.
+// Language: C++17 (header)
+//-------------------------------------------------------------------------------
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <string>
+
+struct AppConfig;
+struct sqlite3;
+class ThreadPool;
+
+/**
+ * @brief Freshness policy for OmdbCache.
+ * @ingroup services
+ */
+struct OmdbCacheOptions {
+    /** Search results: lifetime before a refetch */
+    int64_t searchTtlSeconds = 7 * 24 * 3600;
+    /** Slow-changing metadata (the short-plot detail variant) */
+    int64_t metadataTtlSeconds = 30 * 24 * 3600;
+    /** The full detail response, which also carries IMDb/Metascore/RT ratings */
+    int64_t ratingsTtlSeconds = 24 * 3600;
+    /** Serve an expired entry immediately and refresh it in the background */
+    bool staleWhileRevalidate = false;
+    /** How long past its TTL an entry may still be served stale */
+    int64_t maxStaleSeconds = 30 * 24 * 3600;
+};
+
+/**
+ * @brief One cached OMDb response.
+ * @ingroup services
+ */
+struct OmdbCacheEntry {
+    /** Raw JSON response body */
+    std::string body;
+    /** Fetch (or last successful revalidation) time, seconds since the epoch */
+    int64_t fetchedAt = 0;
+    /** ETag validator sent by the server, if any */
+    std::string etag;
+    /** Last-Modified validator sent by the server, if any */
+    std::string lastModified;
+};
+
+/**
+ * @brief OMDb responses stored in the list's SQLite database.
+ *
+ * Entries live in an @c omdb_cache table keyed by searchKey() or detailKey(),
+ * so every front end working on the same database shares them. The cache only
+ * stores responses and runs refreshes; omdbSearch() and omdbGetById() apply the
+ * TTLs and decide what to fetch. Background revalidations run on a small
+ * private pool and are de-duplicated per key.
+ *
+ * Thread-safe. Without SQLite support (TOP100_NO_SQLITE) the cache never opens
+ * and every lookup misses.
+ *
+ * @ingroup services
+ */
+class OmdbCache {
+public:
+    /**
+     * @brief Open (and create if needed) the cache table in @p dbPath.
+     * @param dbPath SQLite database file (usually AppConfig::dataFile)
+     * @param opts Freshness policy
+     */
+    explicit OmdbCache(const std::string& dbPath, OmdbCacheOptions opts = {});
+    ~OmdbCache();
+
+    OmdbCache(const OmdbCache&) = delete;
+    OmdbCache& operator=(const OmdbCache&) = delete;
+
+    /** @return true if the database could be opened. */
+    bool isOpen() const { return db_ != nullptr; }
+
+    /** @return Freshness policy. */
+    const OmdbCacheOptions& options() const { return opts_; }
+
+    /**
+     * @brief Look up an entry.
+     * @param key Cache key
+     * @return Entry, or nullopt on a miss
+     */
+    std::optional<OmdbCacheEntry> lookup(const std::string& key) const;
+
+    /**
+     * @brief Insert or replace an entry.
+     * @param key Cache key
+     * @param entry Response and validators
+     */
+    void store(const std::string& key, const OmdbCacheEntry& entry);
+
+    /**
+     * @brief Mark an entry as just revalidated (HTTP 304).
+     * @param key Cache key
+     * @param fetchedAt New fetch time
+     */
+    void touch(const std::string& key, int64_t fetchedAt);
+
+    /** @brief Remove every entry. */
+    void clear();
+
+    /**
+     * @brief Run @p refresh for @p key in the background unless one is already running.
+     * @param key Cache key being refreshed
+     * @param refresh Fetch-and-store routine
+     * @return true if a refresh was scheduled
+     */
+    bool revalidateAsync(const std::string& key, std::function<void()> refresh);
+
+    /** @brief Block until all scheduled background refreshes have finished. */
+    void waitIdle();
+
+    /** @return Current time in seconds since the epoch. */
+    static int64_t now();
+
+    /**
+     * @brief Key for a title search: trimmed, lower-cased, whitespace collapsed.
+     * @param query Search text
+     * @return Cache key
+     */
+    static std::string searchKey(const std::string& query);
+
+    /**
+     * @brief Key for a detail response.
+     * @param imdbID IMDb identifier
+     * @param plot "full" or "short"
+     * @return Cache key
+     */
+    static std::string detailKey(const std::string& imdbID, const std::string& plot);
+
+private:
+    OmdbCacheOptions opts_;
+    sqlite3* db_ = nullptr;
+    mutable std::mutex mutex_;
+    std::mutex pendingMutex_;
+    std::condition_variable idle_;
+    std::set<std::string> pending_;
+    std::unique_ptr<ThreadPool> refresher_;   // destroyed first: joins before db_ closes
+};
+
+/**
+ * @brief Open a cache for @p cfg's database using the omdbCache* settings.
+ * @param cfg Application configuration
+ * @return Cache, or nullptr when caching is disabled or the database can't be opened
+ * @ingroup services
+ */
+std::shared_ptr<OmdbCache> openOmdbCache(const AppConfig& cfg);
@@ -0,0 +1,258 @@
+// SPDX-License-Identifier: Apache-2.0
+//-------------------------------------------------------------------------------
+// Top100 — Your Personal Movie List
+//
+// File: lib/omdb_decode.cpp
+// Purpose: SAX handler that fills Movie / OmdbSearchResult while parsing.
+// Language: C++17 (CMake build)
+//-------------------------------------------------------------------------------
+#include "omdb_decode.h"
+#include <algorithm>
+#include <cstdlib>
+#include <nlohmann/json.hpp>
+
+namespace {
+
+using json = nlohmann::json;
+
+// Leading integer as std::stoi reads it (spaces, sign, digits); 0 if none.
+// At most @p maxDigits digits are used ("2005–2007" -> 2005 with 4).
+int leadingInt(const std::string& s, size_t maxDigits = 9) {
+    size_t i = 0;
+    while (i < s.size() && (s[i] == ' ' || s[i] == '\t' || s[i] == '\n' || s[i] == '\r')) ++i;
+    bool negative = false;
+    if (i < s.size() && (s[i] == '-' || s[i] == '+')) negative = s[i++] == '-';
+    int v = 0;
+    for (size_t n = 0; i < s.size() && n < maxDigits && s[i] >= '0' && s[i] <= '9'; ++i, ++n) v = v * 10 + (s[i] - '0');
+    return negative ? -v : v;
+}
+
+enum class Field : unsigned char {
+    Other, Response, Error, Title, Year, ImdbID, Type, Director, Actors, Genre, Runtime, Country,
+    Poster, ImdbRating, Metascore, Plot, Ratings, Search, TotalResults, Source, Value
+};
+
+Field fieldOf(const std::string& key) {
+    // OMDb's field names; everything else is skipped
+    static const struct { const char* name; Field field; } kFields[] = {
+        {"Title", Field::Title}, {"Year", Field::Year}, {"imdbID", Field::ImdbID}, {"Type", Field::Type},
+        {"Director", Field::Director}, {"Actors", Field::Actors}, {"Genre", Field::Genre},
+        {"Runtime", Field::Runtime}, {"Country", Field::Country}, {"Poster", Field::Poster},
+        {"imdbRating", Field::ImdbRating}, {"Metascore", Field::Metascore}, {"Plot", Field::Plot},
+        {"Ratings", Field::Ratings}, {"Search", Field::Search}, {"totalResults", Field::TotalResults},
+        {"Source", Field::Source}, {"Value", Field::Value}, {"Response", Field::Response}, {"Error", Field::Error},
+    };
+    for (const auto& f : kFields) {
+        if (key == f.name) return f.field;
+    }
+    return Field::Other;
+}
+
+// One pass over the body. Top-level fields sit at depth 1; items of the
+// "Ratings" and "Search" arrays are objects at depth 3.
+class OmdbSax {
+public:
+    enum class Mode { Classify, Detail, Search };
+
+    OmdbSax(Mode mode, Movie* movie, std::string* plot, OmdbSearchPage* page)
+        : mode_(mode), movie_(movie), plot_(plot), page_(page) {}
+
+    OmdbResponse response() const {
+        if (!rootObject_) return OmdbResponse::Invalid;
+        return responseFalse_ ? OmdbResponse::Error : OmdbResponse::Ok;
+    }
+    std::string& error() { return error_; }
+
+    // --- nlohmann::json SAX interface ---
+    bool null() { return scalar(); }
+    bool boolean(bool) { return scalar(); }
+    bool number_integer(json::number_integer_t) { return scalar(); }
+    bool number_unsigned(json::number_unsigned_t) { return scalar(); }
+    bool number_float(json::number_float_t, const json::string_t&) { return scalar(); }
+    bool binary(json::binary_t&) { return scalar(); }
+
+    bool string(json::string_t& v) {
+        if (depth_ == 0) return false;
+        if (depth_ == 1) topValue(top_, v);
+        else if (depth_ == 3 && list_ != Field::Other) itemValue(item_, v);
+        return true;
+    }
+
+    bool start_object(std::size_t) {
+        if (depth_ == 0) rootObject_ = true;
+        ++depth_;
+        if (depth_ == 3 && list_ != Field::Other) {
+            item_ = Field::Other;
+            source_.clear();
+            value_.clear();
+            hit_ = OmdbSearchResult{};
+        }
+        return true;
+    }
+
+    bool key(json::string_t& k) {
+        if (depth_ == 1) top_ = fieldOf(k);
+        else if (depth_ == 3 && list_ != Field::Other) item_ = fieldOf(k);
+        return true;
+    }
+
+    bool end_object() {
+        if (depth_ == 3 && list_ != Field::Other) endItem();
+        --depth_;
+        return true;
+    }
+
+    bool start_array(std::size_t) {
+        if (depth_ == 0) return false;
+        if (depth_ == 1 && (top_ == Field::Ratings || top_ == Field::Search)) list_ = top_;
+        ++depth_;
+        return true;
+    }
+
+    bool end_array() {
+        --depth_;
+        if (depth_ == 1) list_ = Field::Other;
+        return true;
+    }
+
+    bool parse_error(std::size_t, const std::string&, const nlohmann::detail::exception&) {
+        rootObject_ = false;
+        return false;
+    }
+
+private:
+    bool scalar() { return depth_ > 0; }
+
+    void topValue(Field f, std::string& v) {
+        if (f == Field::Response) {
+            responseFalse_ = v == "False";
+            return;
+        }
+        if (f == Field::Error) {
+            error_ = std::move(v);
+            return;
+        }
+        if (mode_ == Mode::Search) {
+            if (f == Field::TotalResults) page_->totalResults = static_cast<size_t>(std::max(0L, std::strtol(v.c_str(), nullptr, 10)));
+            return;
+        }
+        if (mode_ != Mode::Detail) return;
+        Movie& m = *movie_;
+        switch (f) {
+        case Field::Title: m.title = std::move(v); break;
+        case Field::Year: m.year = leadingInt(v, 4); break;
+        case Field::ImdbID: m.imdbID = std::move(v); break;
+        case Field::Director: m.director = std::move(v); break;
+        case Field::Actors: omdbSplitList(v, m.actors, 10); break;
+        case Field::Genre: omdbSplitList(v, m.genres); break;
+        case Field::Runtime: m.runtimeMinutes = leadingInt(v); break;      // "148 min"
+        case Field::Country: omdbSplitList(v, m.countries); break;
+        case Field::Poster: m.posterUrl = std::move(v); break;
+        case Field::ImdbRating: m.imdbRating = v == "N/A" ? 0.0 : std::strtod(v.c_str(), nullptr); break;
+        case Field::Metascore: m.metascore = v == "N/A" ? 0 : leadingInt(v); break;
+        case Field::Plot:
+            if (plot_ && v != "N/A") *plot_ = std::move(v);
+            break;
+        default: break;
+        }
+    }
+
+    void itemValue(Field f, std::string& v) {
+        if (list_ == Field::Ratings && mode_ == Mode::Detail) {
+            if (f == Field::Source) source_ = std::move(v);
+            else if (f == Field::Value) value_ = std::move(v);
+        } else if (list_ == Field::Search && mode_ == Mode::Search) {
+            switch (f) {
+            case Field::Title: hit_.title = std::move(v); break;
+            case Field::Year: hit_.year = leadingInt(v, 4); break;
+            case Field::ImdbID: hit_.imdbID = std::move(v); break;
+            case Field::Type: hit_.type = std::move(v); break;
+            default: break;
+            }
+        }
+    }
+
+    void endItem() {
+        if (list_ == Field::Ratings && mode_ == Mode::Detail) {
+            // The first Rotten Tomatoes entry counts, e.g. "87%"
+            if (!rtSeen_ && source_ == "Rotten Tomatoes") {
+                rtSeen_ = true;
+                movie_->rottenTomatoes = value_ == "N/A" ? 0 : leadingInt(value_);
+            }
+        } else if (list_ == Field::Search && mode_ == Mode::Search) {
+            page_->results.push_back(std::move(hit_));
+        }
+    }
+
+    Mode mode_;
+    Movie* movie_;
+    std::string* plot_;
+    OmdbSearchPage* page_;
+    int depth_ = 0;
+    bool rootObject_ = false;
+    bool responseFalse_ = false;
+    bool rtSeen_ = false;
+    Field top_ = Field::Other;
+    Field list_ = Field::Other;   // array being walked at depth 2
+    Field item_ = Field::Other;
+    std::string error_;
+    std::string source_, value_;  // current Ratings entry
+    OmdbSearchResult hit_{};      // current Search entry
+};
+
+bool parse(std::string_view body, OmdbSax& sax) {
+    return json::sax_parse(body.data(), body.data() + body.size(), &sax);
+}
+
+} // namespace
+
+void omdbSplitList(std::string_view list, std::vector<std::string>& out, size_t limit) {
+    const auto space = [](char c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r'; };
+    size_t start = 0;
+    while (start <= list.size() && out.size() < limit) {
+        size_t end = list.find(',', start);
+        if (end == std::string_view::npos) end = list.size();
+        size_t b = start, e = end;
+        while (b < e && space(list[b])) ++b;
+        while (e > b && space(list[e - 1])) --e;
+        if (e > b) out.emplace_back(list.substr(b, e - b));
+        start = end + 1;
+    }
+}
+
+OmdbDecodedDetail omdbDecodeDetail(std::string_view body, const std::string& imdbID) {
+    OmdbDecodedDetail out;
+    out.movie.year = 0;
+    OmdbSax sax(OmdbSax::Mode::Detail, &out.movie, &out.plot, nullptr);
+    const bool parsed = parse(body, sax);
+    out.response = parsed ? sax.response() : OmdbResponse::Invalid;
+    if (out.response == OmdbResponse::Ok) {
+        if (out.movie.imdbID.empty()) out.movie.imdbID = imdbID;
+        out.movie.source = "omdb";
+    } else {
+        if (out.response == OmdbResponse::Error) out.error = std::move(sax.error());
+        out.movie = Movie{};
+        out.movie.year = 0;
+        out.plot.clear();
+    }
+    return out;
+}
+
+OmdbDecodedSearch omdbDecodeSearch(std::string_view body) {
+    OmdbDecodedSearch out;
+    OmdbSax sax(OmdbSax::Mode::Search, nullptr, nullptr, &out.page);
+    const bool parsed = parse(body, sax);
+    out.response = parsed ? sax.response() : OmdbResponse::Invalid;
+    if (out.response != OmdbResponse::Ok) {
+        if (out.response == OmdbResponse::Error) out.error = std::move(sax.error());
+        out.page = OmdbSearchPage{};
+    }
+    return out;
+}
+
+OmdbResponse omdbResponseOf(std::string_view body, std::string* error) {
+    OmdbSax sax(OmdbSax::Mode::Classify, nullptr, nullptr, nullptr);
+    const OmdbResponse r = parse(body, sax) ? sax.response() : OmdbResponse::Invalid;
+    if (error && r == OmdbResponse::Error) *error = std::move(sax.error());
+    return r;
+}
@@ -0,0 +1,96 @@
+// SPDX-License-Identifier: Apache-2.0
+//-------------------------------------------------------------------------------
+// Top100 — Your Personal Movie List
+//
+// File: lib/omdb_decode.h
+// Purpose: Streaming (SAX) decoding of OMDb responses straight into Movie.
+// Language: C++17 (header)
+//-------------------------------------------------------------------------------
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Movie.h"
+#include "omdb.h"
+
+/**
+ * @brief What kind of answer an OMDb body is.
+ * @ingroup services
+ */
+enum class OmdbResponse {
+    /** Not a JSON object (truncated, HTML error page, ...) */
+    Invalid,
+    /** A real answer */
+    Ok,
+    /** {"Response":"False","Error":"..."} */
+    Error
+};
+
+/**
+ * @brief A decoded detail (?i=) response.
+ * @ingroup services
+ */
+struct OmdbDecodedDetail {
+    /** Kind of answer; the other fields are set only for Ok */
+    OmdbResponse response = OmdbResponse::Invalid;
+    /** OMDb's message when response == Error */
+    std::string error;
+    /** Movie fields (source "omdb"; plots are left to the caller) */
+    Movie movie{};
+    /** The "Plot" field ("N/A" becomes empty) */
+    std::string plot;
+};
+
+/**
+ * @brief A decoded search (?s=) response.
+ * @ingroup services
+ */
+struct OmdbDecodedSearch {
+    /** Kind of answer */
+    OmdbResponse response = OmdbResponse::Invalid;
+    /** OMDb's message when response == Error (e.g., "Movie not found!") */
+    std::string error;
+    /** Hits and total (empty unless Ok) */
+    OmdbSearchPage page;
+};
+
+/**
+ * @brief Decode a detail response in one pass, without building a JSON tree.
+ * @param body Response body
+ * @param imdbID ID to use if the body has none
+ * @return Decoded fields
+ * @ingroup services
+ */
+OmdbDecodedDetail omdbDecodeDetail(std::string_view body, const std::string& imdbID = std::string());
+
+/**
+ * @brief Decode a search response in one pass, without building a JSON tree.
+ * @param body Response body
+ * @return Decoded hits
+ * @ingroup services
+ */
+OmdbDecodedSearch omdbDecodeSearch(std::string_view body);
+
+/**
+ * @brief Classify a body without keeping any of its other fields.
+ * @param body Response body
+ * @param error Receives OMDb's message for an Error answer (optional)
+ * @return Kind of answer
+ * @ingroup services
+ */
+OmdbResponse omdbResponseOf(std::string_view body, std::string* error = nullptr);
+
+/**
+ * @brief Append the items of an OMDb list ("Action, Sci-Fi") to @p out.
+ *
+ * Items are trimmed and empty ones skipped. Only the kept items allocate.
+ *
+ * @param list Comma-separated text
+ * @param out Destination
+ * @param limit Stop once @p out holds this many items
+ * @ingroup services
+ */
+void omdbSplitList(std::string_view list, std::vector<std::string>& out, size_t limit = SIZE_MAX);
@@ -0,0 +1,116 @@
+// SPDX-License-Identifier: Apache-2.0
+//-------------------------------------------------------------------------------
+// Top100 — Your Personal Movie List
+//
+// File: lib/omdb_refresh.cpp
+// Purpose: Bulk, rate-limited OMDb metadata refresh for the whole list.
+// Language: C++17 (CMake build)
+//-------------------------------------------------------------------------------
+#include "omdb_refresh.h"
+#include "config.h"
+#include "rate_limit.h"
+#include "thread_pool.h"
+#include "top100.h"
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <thread>
+
+static bool cancelled(const std::atomic<bool>* flag) {
+    return flag && flag->load();
+}
+
+// Sleep in short slices; @return false if the wait was cut short by a stop
+static bool sleepUnlessStopped(int ms, const std::atomic<bool>* cancel, const std::atomic<bool>& stop) {
+    const auto until = std::chrono::steady_clock::now() + std::chrono::milliseconds(ms);
+    while (std::chrono::steady_clock::now() < until) {
+        if (cancelled(cancel) || stop.load()) return false;
+        std::this_thread::sleep_for(std::min<std::chrono::steady_clock::duration>(
+            until - std::chrono::steady_clock::now(), std::chrono::milliseconds(50)));
+    }
+    return true;
+}
+
+// Full jitter: uniform in [0, min(cap, base * 2^retry)]
+static int backoffMs(const OmdbRefreshOptions& opts, int retry, std::mt19937& rng) {
+    long long ceiling = std::max(0, opts.baseBackoffMs);
+    for (int i = 0; i < retry && ceiling < opts.maxBackoffMs; ++i) ceiling *= 2;
+    ceiling = std::min<long long>(ceiling, std::max(0, opts.maxBackoffMs));
+    return static_cast<int>(std::uniform_int_distribution<long long>(0, ceiling)(rng));
+}
+
+OmdbRefreshResult omdbFetchMany(const std::string& apiKey, const std::vector<std::string>& imdbIDs,
+                                const OmdbRefreshOptions& opts) {
+    OmdbRefreshResult result;
+    if (imdbIDs.empty()) return result;
+    std::function<OmdbDetailResult(const std::string&)> fetch = opts.fetch;
+    if (!fetch) fetch = [&apiKey, &opts](const std::string& id) { return omdbFetchDetail(apiKey, id, opts.detail); };
+    // A lookup with the short plot costs OMDb two requests
+    const int cost = (!opts.fetch && opts.detail.fetchShortPlot) ? 2 : 1;
+    TokenBucket bucket(opts.requestsPerSecond, std::max<double>(opts.burst, cost));
+    std::vector<std::optional<Movie>> fetched(imdbIDs.size());
+    std::atomic<bool> stop{false};
+    std::atomic<int> stoppedBy{static_cast<int>(OmdbError::None)};
+    std::mutex progressMutex;
+    OmdbRefreshProgress progress;
+    progress.total = imdbIDs.size();
+
+    const size_t workers = std::max<size_t>(1, std::min(opts.concurrency, imdbIDs.size()));
+    std::vector<std::mt19937> rngs;
+    std::random_device seed;
+    for (size_t w = 0; w < workers; ++w) rngs.emplace_back(seed());
+
+    ThreadPool pool(workers);
+    pool.parallelFor(imdbIDs.size(), [&](size_t i, size_t worker) {
+        const std::string& id = imdbIDs[i];
+        for (int attempt = 0; attempt < std::max(1, opts.maxAttempts); ++attempt) {
+            if (attempt > 0 && !sleepUnlessStopped(backoffMs(opts, attempt - 1, rngs[worker]), opts.cancel, stop)) break;
+            bool admitted = true;
+            for (int t = 0; t < cost && admitted; ++t) admitted = bucket.acquire(opts.cancel);
+            if (!admitted || stop.load()) break;
+            OmdbDetailResult r = fetch(id);
+            if (r.movie) {
+                fetched[i] = std::move(r.movie);
+                break;
+            }
+            if (r.error == OmdbError::QuotaExceeded || r.error == OmdbError::InvalidKey) {
+                int none = static_cast<int>(OmdbError::None);
+                stoppedBy.compare_exchange_strong(none, static_cast<int>(r.error));
+                stop = true;
+                break;
+            }
+            if (r.error != OmdbError::Transient) break;
+        }
+        std::lock_guard<std::mutex> lock(progressMutex);
+        ++progress.done;
+        if (!fetched[i]) ++progress.failed;
+        progress.imdbID = id;
+        if (opts.onProgress) opts.onProgress(progress);
+    });
+
+    for (size_t i = 0; i < imdbIDs.size(); ++i) {
+        if (fetched[i]) result.movies.push_back(std::move(*fetched[i]));
+        else result.failed.push_back(imdbIDs[i]);
+    }
+    result.cancelled = cancelled(opts.cancel);
+    result.stoppedBy = static_cast<OmdbError>(stoppedBy.load());
+    return result;
+}
+
+OmdbRefreshResult refreshStaleMovies(Top100& list, const std::string& apiKey, long long maxAgeSeconds,
+                                     const OmdbRefreshOptions& opts) {
+    OmdbRefreshResult result = omdbFetchMany(apiKey, list.staleImdbIds(maxAgeSeconds), opts);
+    result.merged = list.mergeFromOmdb(result.movies);
+    return result;
+}
+
+OmdbRefreshOptions omdbRefreshOptions(const AppConfig& cfg) {
+    OmdbRefreshOptions opts;
+    opts.concurrency = static_cast<size_t>(std::max(1, cfg.omdbRefreshConcurrency));
+    opts.requestsPerSecond = cfg.omdbRequestsPerSecond;
+    opts.burst = std::max(1.0, cfg.omdbRequestsPerSecond);
+    opts.detail.fetchShortPlot = cfg.omdbFetchShortPlot;
+    return opts;
+}
@@ -0,0 +1,121 @@
+// SPDX-License-Identifier: Apache-2.0
+//-------------------------------------------------------------------------------
+// Top100 — Your Personal Movie List
+//
+// File: lib/omdb_refresh.h
+// Purpose: Bulk, rate-limited OMDb metadata refresh for the whole list.
+// Language: C++17 (header)
+//-------------------------------------------------------------------------------
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+#include "omdb.h"
+
+struct AppConfig;
+class Top100;
+
+/**
+ * @brief Progress snapshot passed to OmdbRefreshOptions::onProgress.
+ * @ingroup services
+ */
+struct OmdbRefreshProgress {
+    /** IDs finished so far (successes and failures) */
+    size_t done = 0;
+    /** IDs in the run */
+    size_t total = 0;
+    /** IDs that failed so far */
+    size_t failed = 0;
+    /** The ID that just finished */
+    std::string imdbID;
+};
+
+/**
+ * @brief Tuning for omdbFetchMany() and refreshStaleMovies().
+ * @ingroup services
+ */
+struct OmdbRefreshOptions {
+    /** Lookups in flight at once */
+    size_t concurrency = 6;
+    /** Sustained OMDb request rate shared by all workers (<= 0 = unlimited) */
+    double requestsPerSecond = 10.0;
+    /** Requests allowed back-to-back after an idle period */
+    double burst = 10.0;
+    /** Tries per ID for transient failures (network, 429, 5xx) */
+    int maxAttempts = 4;
+    /** Backoff before the first retry; doubles per attempt, full jitter */
+    int baseBackoffMs = 250;
+    /** Backoff ceiling */
+    int maxBackoffMs = 4000;
+    /** Detail options for each lookup (revalidates by default: this is an explicit refresh) */
+    OmdbDetailOptions detail{true, 200, true};
+    /** Called after each ID finishes; serialised, but on a worker thread */
+    std::function<void(const OmdbRefreshProgress&)> onProgress;
+    /** Set to true (from any thread) to stop; lookups in flight finish first */
+    const std::atomic<bool>* cancel = nullptr;
+    /** Lookup routine; empty = omdbFetchDetail(). Tests substitute a fake. */
+    std::function<OmdbDetailResult(const std::string& imdbID)> fetch;
+};
+
+/**
+ * @brief Outcome of a bulk fetch.
+ * @ingroup services
+ */
+struct OmdbRefreshResult {
+    /** Fetched movies, in the order of the requested IDs */
+    std::vector<Movie> movies;
+    /** IDs that could not be fetched (not found, out of retries, or skipped after a stop) */
+    std::vector<std::string> failed;
+    /** Movies merged into the list (refreshStaleMovies() only) */
+    size_t merged = 0;
+    /** The run was cancelled through OmdbRefreshOptions::cancel */
+    bool cancelled = false;
+    /** QuotaExceeded or InvalidKey if OMDb refused further requests; None otherwise */
+    OmdbError stoppedBy = OmdbError::None;
+};
+
+/**
+ * @brief Fetch details for many IDs concurrently.
+ *
+ * Lookups run on a private pool of @c concurrency workers. Every request takes
+ * a token from a shared bucket, so the whole run respects
+ * @c requestsPerSecond however many workers there are. Transient failures are
+ * retried with exponential backoff and full jitter; a quota or API-key error
+ * stops the run, since every further request would fail the same way.
+ *
+ * @param apiKey OMDb API key
+ * @param imdbIDs IDs to fetch
+ * @param opts Concurrency, rate, retry, progress and cancellation settings
+ * @return Fetched movies and failures
+ * @ingroup services
+ */
+OmdbRefreshResult omdbFetchMany(const std::string& apiKey, const std::vector<std::string>& imdbIDs,
+                                const OmdbRefreshOptions& opts = {});
+
+/**
+ * @brief Refresh every movie whose metadata is older than @p maxAgeSeconds.
+ *
+ * Fetches Top100::staleImdbIds() with omdbFetchMany() and merges the results
+ * with Top100::mergeFromOmdb(), so the list is written once, in one
+ * transaction. On cancellation the movies fetched so far are still merged.
+ *
+ * @param list List to refresh
+ * @param apiKey OMDb API key
+ * @param maxAgeSeconds Refresh movies last fetched at least this long ago (0 = all)
+ * @param opts Fetch settings
+ * @return Fetch outcome, with @c merged set
+ * @ingroup services
+ */
+OmdbRefreshResult refreshStaleMovies(Top100& list, const std::string& apiKey, long long maxAgeSeconds,
+                                     const OmdbRefreshOptions& opts = {});
+
+/**
+ * @brief Refresh settings from the omdbRefresh* / omdbRequestsPerSecond config fields.
+ * @param cfg Application configuration
+ * @return Options (progress, cancellation and fetch left unset)
+ * @ingroup services
+ */
+OmdbRefreshOptions omdbRefreshOptions(const AppConfig& cfg);
@@ -0,0 +1,473 @@
+// SPDX-License-Identifier: Apache-2.0
+//-------------------------------------------------------------------------------
+// Top100 — Your Personal Movie List
+//
+// File: lib/png_writer.cpp
+// Purpose: Streaming PNG encoder on zlib.
+// Language: C++17 (CMake build)
+//-------------------------------------------------------------------------------
+#include "png_writer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#if TOP100_HAVE_ZLIB
+#include "thread_pool.h"
+#include <deque>
+#include <future>
+#include <thread>
+#include <zlib.h>
+#endif
+
+#if TOP100_HAVE_ZLIB
+namespace {
+
+// Compressed bytes gathered before an IDAT chunk is written (one thread)
+constexpr size_t kChunkBytes = 64 * 1024;
+// Filtered bytes per chunk deflated on a worker, and the history each chunk is primed with
+constexpr size_t kParallelChunkBytes = 256 * 1024;
+constexpr size_t kWindowBytes = 32 * 1024;
+
+void putU32(unsigned char* p, uint32_t v) {
+    p[0] = static_cast<unsigned char>(v >> 24);
+    p[1] = static_cast<unsigned char>(v >> 16);
+    p[2] = static_cast<unsigned char>(v >> 8);
+    p[3] = static_cast<unsigned char>(v);
+}
+
+// Premultiplied ARGB32 row to PNG's RGB / straight-alpha RGBA bytes
+void convertRow(const uint32_t* src, int width, bool alpha, unsigned char* dst) {
+    for (int x = 0; x < width; ++x) {
+        const uint32_t p = src[x];
+        uint32_t r = (p >> 16) & 0xFF, g = (p >> 8) & 0xFF, b = p & 0xFF;
+        if (!alpha) {
+            *dst++ = static_cast<unsigned char>(r);
+            *dst++ = static_cast<unsigned char>(g);
+            *dst++ = static_cast<unsigned char>(b);
+            continue;
+        }
+        const uint32_t a = p >> 24;
+        if (a != 0 && a != 255) {
+            r = (r * 255 + a / 2) / a;
+            g = (g * 255 + a / 2) / a;
+            b = (b * 255 + a / 2) / a;
+        }
+        *dst++ = static_cast<unsigned char>(r);
+        *dst++ = static_cast<unsigned char>(g);
+        *dst++ = static_cast<unsigned char>(b);
+        *dst++ = static_cast<unsigned char>(a);
+    }
+}
+
+int paeth(int a, int b, int c) {
+    const int p = a + b - c;
+    const int pa = std::abs(p - a), pb = std::abs(p - b), pc = std::abs(p - c);
+    if (pa <= pb && pa <= pc) return a;
+    return pb <= pc ? b : c;
+}
+
+// Filter bytes [from, to) of a row with one filter type (1-4; 0 copies)
+template <int Type>
+void filterSpan(const unsigned char* cur, const unsigned char* prev, size_t from, size_t to, size_t bpp,
+                unsigned char* out) {
+    auto predict = [](int a, int b, int c) {
+        if (Type == 1) return a;
+        if (Type == 2) return b;
+        if (Type == 3) return (a + b) >> 1;
+        if (Type == 4) return paeth(a, b, c);
+        return 0;
+    };
+    size_t i = from;
+    for (; i < std::min(to, bpp); ++i)   // first pixel: nothing to the left
+        out[i - from] = static_cast<unsigned char>(cur[i] - predict(0, prev[i], 0));
+    // Branch-free so the compiler can vectorise it
+    for (; i < to; ++i)
+        out[i - from] = static_cast<unsigned char>(cur[i] - predict(cur[i - bpp], prev[i], prev[i - bpp]));
+}
+
+void filterSpan(int type, const unsigned char* cur, const unsigned char* prev, size_t from, size_t to, size_t bpp,
+                unsigned char* out) {
+    switch (type) {
+    case 1: filterSpan<1>(cur, prev, from, to, bpp, out); break;
+    case 2: filterSpan<2>(cur, prev, from, to, bpp, out); break;
+    case 3: filterSpan<3>(cur, prev, from, to, bpp, out); break;
+    case 4: filterSpan<4>(cur, prev, from, to, bpp, out); break;
+    default: filterSpan<0>(cur, prev, from, to, bpp, out); break;
+    }
+}
+
+// Sum of the row filtered with @p type, bytes read as signed values (libpng's
+// cost); stops counting once it reaches @p limit
+uint64_t filterCost(int type, const unsigned char* cur, const unsigned char* prev, size_t n, size_t bpp,
+                    uint64_t limit) {
+    unsigned char block[512];
+    uint64_t cost = 0;
+    for (size_t i = 0; i < n && cost < limit; i += sizeof block) {
+        const size_t end = std::min(n, i + sizeof block);
+        filterSpan(type, cur, prev, i, end, bpp, block);
+        uint32_t sum = 0;
+        for (size_t j = 0; j < end - i; ++j) {
+            const int v = static_cast<signed char>(block[j]);
+            sum += static_cast<uint32_t>(v < 0 ? -v : v);
+        }
+        cost += sum;
+    }
+    return cost;
+}
+
+// Filter one row (previous row @p prev, zeros for the first) into out[0..n]
+void filterRow(const unsigned char* cur, const unsigned char* prev, size_t n, size_t bpp, unsigned char* out) {
+    // Flat UI backgrounds: a row repeating the one above is all zeros as Up,
+    // a single-colour row all zeros after its first pixel as Sub
+    if (std::memcmp(cur, prev, n) == 0) {
+        out[0] = 2;
+        std::memset(out + 1, 0, n);
+        return;
+    }
+    if (std::memcmp(cur, cur + bpp, n - bpp) == 0) {
+        out[0] = 1;
+        std::memcpy(out + 1, cur, bpp);
+        std::memset(out + 1 + bpp, 0, n - bpp);
+        return;
+    }
+    int best = 0;
+    uint64_t bestCost = UINT64_MAX;
+    for (int type = 0; type <= 4; ++type) {
+        const uint64_t cost = filterCost(type, cur, prev, n, bpp, bestCost);
+        if (cost < bestCost) {
+            bestCost = cost;
+            best = type;
+        }
+    }
+    out[0] = static_cast<unsigned char>(best);
+    filterSpan(best, cur, prev, 0, n, bpp, out + 1);
+}
+
+// Rows compressed together on a worker when several threads are used
+struct Chunk {
+    std::vector<unsigned char> raw;         // converted rows
+    std::vector<unsigned char> above;       // raw row above the first one
+    std::vector<unsigned char> filtered;
+    std::vector<unsigned char> out;         // deflate data; zlib header on the first chunk
+    std::promise<void> filteredPromise;
+    std::shared_future<void> filteredReady = filteredPromise.get_future().share();
+    std::future<void> done;
+    uLong adler = 0;
+    bool last = false;
+    bool ok = true;
+};
+
+// Worker side of one chunk: filter its rows, then deflate them as raw deflate
+// data primed with the end of the previous chunk, ending on a byte boundary
+// (sync flush) so the chunks concatenate into one stream
+void compressChunk(const std::shared_ptr<Chunk>& c, std::shared_ptr<Chunk> before,
+                   size_t rowBytes, size_t bpp, int level, bool first) {
+    const size_t rows = c->raw.size() / rowBytes;
+    c->filtered.resize(rows * (rowBytes + 1));
+    const unsigned char* prev = c->above.data();
+    for (size_t r = 0; r < rows; ++r) {
+        const unsigned char* cur = c->raw.data() + r * rowBytes;
+        filterRow(cur, prev, rowBytes, bpp, c->filtered.data() + r * (rowBytes + 1));
+        prev = cur;
+    }
+    c->adler = adler32(1L, c->filtered.data(), static_cast<uInt>(c->filtered.size()));
+    c->filteredPromise.set_value();
+
+    z_stream z{};
+    if (deflateInit2(&z, level, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        c->ok = false;
+        return;
+    }
+    if (before) {
+        before->filteredReady.wait();
+        const size_t have = std::min(kWindowBytes, before->filtered.size());
+        deflateSetDictionary(&z, before->filtered.data() + before->filtered.size() - have, static_cast<uInt>(have));
+        before.reset();
+    }
+    size_t at = 0;
+    c->out.resize(deflateBound(&z, static_cast<uLong>(c->filtered.size())) + 64);
+    if (first) {
+        // CMF: deflate, 32K window; FLG: the level hint, check bits make it a multiple of 31
+        const unsigned flevel = level < 2 ? 0 : level < 6 ? 1 : level == 6 ? 2 : 3;
+        const unsigned header = (0x78u << 8) | (flevel << 6);
+        c->out[0] = 0x78;
+        c->out[1] = static_cast<unsigned char>((flevel << 6) | (31 - header % 31));
+        at = 2;
+    }
+    z.next_in = c->filtered.data();
+    z.avail_in = static_cast<uInt>(c->filtered.size());
+    for (;;) {
+        z.next_out = c->out.data() + at;
+        z.avail_out = static_cast<uInt>(c->out.size() - at);
+        const int rc = deflate(&z, c->last ? Z_FINISH : Z_SYNC_FLUSH);
+        at = c->out.size() - z.avail_out;
+        if (rc == Z_STREAM_ERROR) {
+            c->ok = false;
+            break;
+        }
+        if (z.avail_out != 0 || rc == Z_STREAM_END) break;
+        c->out.resize(c->out.size() * 2);
+    }
+    c->out.resize(at);
+    deflateEnd(&z);
+    std::vector<unsigned char>().swap(c->raw);
+    std::vector<unsigned char>().swap(c->above);
+}
+
+} // namespace
+
+struct PngWriter::Stream {
+    // One thread: a single deflate stream
+    z_stream z{};
+    bool live = false;
+    // Several: chunks compressed on the pool (ours or the caller's), written in order
+    std::unique_ptr<ThreadPool> ownPool;
+    ThreadPool* pool = nullptr;
+    std::deque<std::shared_ptr<Chunk>> chunks;   // submitted, not yet written
+    std::shared_ptr<Chunk> filling;              // gathering rows
+    std::shared_ptr<Chunk> lastSubmitted;        // dictionary for the next one
+    size_t chunkRows = 1;
+    int level = 6;
+    uLong adler = 1;
+    ~Stream() { if (live) deflateEnd(&z); }
+};
+#else
+struct PngWriter::Stream {};
+#endif
+
+PngWriter::PngWriter() = default;
+
+PngWriter::~PngWriter() { close(false); }
+
+bool PngWriter::available() { return TOP100_HAVE_ZLIB != 0; }
+
+bool PngWriter::fail(const std::string& why) {
+    error_ = why;
+    return false;
+}
+
+void PngWriter::close(bool keep) {
+    z_.reset();
+    if (!file_) return;
+    std::fclose(file_);
+    file_ = nullptr;
+    if (!keep) {
+        std::error_code ec;
+        std::filesystem::remove(path_, ec);
+    }
+}
+
+bool PngWriter::writeChunk(const char type[4], const unsigned char* data, size_t size) {
+#if TOP100_HAVE_ZLIB
+    unsigned char head[8];
+    putU32(head, static_cast<uint32_t>(size));
+    std::copy(type, type + 4, head + 4);
+    uLong crc = crc32(0L, head + 4, 4);
+    if (size) crc = crc32(crc, data, static_cast<uInt>(size));
+    unsigned char tail[4];
+    putU32(tail, static_cast<uint32_t>(crc));
+    if (std::fwrite(head, 1, 8, file_) != 8 || (size && std::fwrite(data, 1, size, file_) != size) ||
+        std::fwrite(tail, 1, 4, file_) != 4)
+        return fail("Cannot write " + path_);
+    return true;
+#else
+    (void)type;
+    (void)data;
+    (void)size;
+    return fail("PNG writing needs zlib");
+#endif
+}
+
+bool PngWriter::open(const std::string& path, int width, int height, const PngWriterOptions& opts) {
+    close(false);
+    error_.clear();
+    row_ = 0;
+#if TOP100_HAVE_ZLIB
+    if (width <= 0 || height <= 0) return fail("Invalid image size");
+    path_ = path;
+    width_ = width;
+    height_ = height;
+    bpp_ = opts.alpha ? 4 : 3;
+    file_ = std::fopen(path.c_str(), "wb");
+    if (!file_) return fail("Cannot create " + path);
+
+    static const unsigned char signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    if (std::fwrite(signature, 1, 8, file_) != 8) {
+        close(false);
+        return fail("Cannot write " + path);
+    }
+    unsigned char ihdr[13] = {};
+    putU32(ihdr, static_cast<uint32_t>(width));
+    putU32(ihdr + 4, static_cast<uint32_t>(height));
+    ihdr[8] = 8;                        // bits per channel
+    ihdr[9] = opts.alpha ? 6 : 2;       // RGBA / RGB; compression, filter, interlace 0
+    bool ok = writeChunk("IHDR", ihdr, sizeof ihdr);
+    if (ok && opts.dpi > 0) {
+        unsigned char phys[9] = {};
+        const auto ppm = static_cast<uint32_t>(std::lround(opts.dpi / 0.0254));
+        putU32(phys, ppm);
+        putU32(phys + 4, ppm);
+        phys[8] = 1;                    // unit: metre
+        ok = writeChunk("pHYs", phys, sizeof phys);
+    }
+    if (!ok) {
+        close(false);
+        return false;
+    }
+
+    z_ = std::make_unique<Stream>();
+    z_->level = std::clamp(opts.level, 0, 9);
+    const size_t rowBytes = static_cast<size_t>(width) * bpp_;
+    prev_.assign(rowBytes, 0);
+    const size_t threads = opts.pool ? opts.pool->threadCount()
+                         : opts.threads ? opts.threads : std::max(1u, std::thread::hardware_concurrency());
+    if (threads > 1) {
+        if (opts.pool) {
+            z_->pool = opts.pool;
+        } else {
+            z_->ownPool = std::make_unique<ThreadPool>(threads);
+            z_->pool = z_->ownPool.get();
+        }
+        z_->chunkRows = std::max<size_t>(1, kParallelChunkBytes / (rowBytes + 1));
+        return true;
+    }
+    if (deflateInit(&z_->z, z_->level) != Z_OK) {
+        close(false);
+        return fail("Cannot start the compressor");
+    }
+    z_->live = true;
+    cur_.assign(rowBytes, 0);
+    filtered_.assign(rowBytes + 1, 0);
+    out_.resize(kChunkBytes);
+    z_->z.next_out = out_.data();
+    z_->z.avail_out = static_cast<uInt>(out_.size());
+    return true;
+#else
+    (void)path;
+    (void)width;
+    (void)height;
+    (void)opts;
+    return fail("PNG writing needs zlib");
+#endif
+}
+
+// Write out full IDAT buffers; when finishing, flush the rest of the stream
+bool PngWriter::drain(bool finishing) {
+#if TOP100_HAVE_ZLIB
+    for (;;) {
+        const int rc = deflate(&z_->z, finishing ? Z_FINISH : Z_NO_FLUSH);
+        if (rc == Z_STREAM_ERROR) return fail("Compressor error");
+        const size_t used = out_.size() - z_->z.avail_out;
+        const bool full = z_->z.avail_out == 0;
+        if (full || (finishing && used)) {
+            if (!writeChunk("IDAT", out_.data(), used)) return false;
+            z_->z.next_out = out_.data();
+            z_->z.avail_out = static_cast<uInt>(out_.size());
+        }
+        if (finishing ? rc == Z_STREAM_END : (!full && z_->z.avail_in == 0)) return true;
+    }
+#else
+    (void)finishing;
+    return false;
+#endif
+}
+
+// Hand the rows gathered so far to the pool (the last chunk may be empty)
+bool PngWriter::submitChunk(bool last) {
+#if TOP100_HAVE_ZLIB
+    std::shared_ptr<Chunk> c = std::move(z_->filling);
+    if (!c) c = std::make_shared<Chunk>();
+    if (!c->raw.empty()) prev_.assign(c->raw.end() - static_cast<std::ptrdiff_t>(prev_.size()), c->raw.end());
+    c->last = last;
+    std::shared_ptr<Chunk> before = z_->lastSubmitted;
+    const bool first = !before;
+    const size_t rowBytes = prev_.size(), bpp = bpp_;
+    const int level = z_->level;
+    c->done = z_->pool->submit([c, before, rowBytes, bpp, level, first]() {
+        compressChunk(c, before, rowBytes, bpp, level, first);
+    });
+    z_->lastSubmitted = c;
+    z_->chunks.push_back(c);
+    return writeFinished(2 * z_->pool->threadCount());
+#else
+    (void)last;
+    return false;
+#endif
+}
+
+// Write compressed chunks in order until at most @p keep are in flight
+bool PngWriter::writeFinished(size_t keep) {
+#if TOP100_HAVE_ZLIB
+    while (z_->chunks.size() > keep) {
+        std::shared_ptr<Chunk> c = std::move(z_->chunks.front());
+        z_->chunks.pop_front();
+        c->done.get();
+        if (!c->ok) return fail("Compressor error");
+        z_->adler = adler32_combine(z_->adler, c->adler, static_cast<z_off_t>(c->filtered.size()));
+        if (c->last) {
+            unsigned char trailer[4];
+            putU32(trailer, static_cast<uint32_t>(z_->adler));
+            c->out.insert(c->out.end(), trailer, trailer + 4);
+        }
+        if (!writeChunk("IDAT", c->out.data(), c->out.size())) return false;
+    }
+    return true;
+#else
+    (void)keep;
+    return false;
+#endif
+}
+
+bool PngWriter::writeRows(const unsigned char* data, int rows, int stride) {
+#if TOP100_HAVE_ZLIB
+    if (!file_) return fail("PNG file is not open");
+    if (rows < 0 || rows > height_ - row_) return fail("More rows than the image height");
+    const size_t rowBytes = prev_.size();
+    for (int y = 0; y < rows; ++y) {
+        const auto* src = reinterpret_cast<const uint32_t*>(data + static_cast<size_t>(y) * stride);
+        ++row_;
+        if (z_->pool) {
+            if (!z_->filling) {
+                z_->filling = std::make_shared<Chunk>();
+                z_->filling->above = prev_;
+                z_->filling->raw.reserve(z_->chunkRows * rowBytes);
+            }
+            std::vector<unsigned char>& raw = z_->filling->raw;
+            raw.resize(raw.size() + rowBytes);
+            convertRow(src, width_, bpp_ == 4, raw.data() + raw.size() - rowBytes);
+            if (raw.size() == z_->chunkRows * rowBytes && !submitChunk(false)) return false;
+            continue;
+        }
+        convertRow(src, width_, bpp_ == 4, cur_.data());
+        filterRow(cur_.data(), prev_.data(), rowBytes, bpp_, filtered_.data());
+        z_->z.next_in = filtered_.data();
+        z_->z.avail_in = static_cast<uInt>(filtered_.size());
+        if (!drain(false)) return false;
+        prev_.swap(cur_);
+    }
+    return true;
+#else
+    (void)data;
+    (void)rows;
+    (void)stride;
+    return fail("PNG writing needs zlib");
+#endif
+}
+
+bool PngWriter::finish() {
+#if TOP100_HAVE_ZLIB
+    if (!file_) return fail("PNG file is not open");
+    if (row_ != height_) {
+        close(false);
+        return fail("Image has " + std::to_string(row_) + " of " + std::to_string(height_) + " rows");
+    }
+    const bool flushed = z_->pool ? submitChunk(true) && writeFinished(0) : drain(true);
+    const bool ok = flushed && writeChunk("IEND", nullptr, 0) && std::fflush(file_) == 0;
+    close(ok);
+    if (!ok && error_.empty()) error_ = "Cannot write " + path_;
+    return ok;
+#else
+    return fail("PNG writing needs zlib");
+#endif
+}
@@ -0,0 +1,117 @@
+// SPDX-License-Identifier: Apache-2.0
+//-------------------------------------------------------------------------------
+// Top100 — Your Personal Movie List
+//
+// File: lib/png_writer.h
+// Purpose: Streaming PNG encoder fed row by row (image export bands).
+// Language: C++17 (header)
+//-------------------------------------------------------------------------------
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+class ThreadPool;
+
+/**
+ * @brief Settings of a PngWriter.
+ * @ingroup services
+ */
+struct PngWriterOptions {
+    /** Keep the alpha channel (RGBA); otherwise RGB is written and alpha ignored */
+    bool alpha = false;
+    /** Resolution recorded in the file (pHYs chunk); 0 records none */
+    double dpi = 0;
+    /** zlib compression level, 0 (stored) to 9 (smallest) */
+    int level = 6;
+    /** Threads compressing (1 = the calling thread only, 0 = one per hardware thread); ignored with @ref pool */
+    size_t threads = 1;
+    /** Compress on this pool instead of starting one (it must outlive the writer); one with a single worker
+     *  leaves compression on the calling thread */
+    ThreadPool* pool = nullptr;
+};
+
+/**
+ * @brief PNG encoder that writes the file while rows are still being produced.
+ *
+ * Rows are premultiplied ARGB32 pixels in native byte order, the layout of
+ * Cairo's CAIRO_FORMAT_ARGB32 surfaces and of PosterBitmap. Each row gets a
+ * filter type: a row repeating the one above is sent as Up and a single-colour
+ * row as Sub without trying the others (flat backgrounds cost next to
+ * nothing), any other row gets the type with the smallest sum of absolute
+ * differences, as libpng does. Compressed data is written in IDAT chunks as it
+ * is produced, so memory use does not depend on the image height.
+ *
+ * With more than one thread, rows are gathered into chunks of about 256 KiB
+ * that are filtered and deflated on a worker pool, each primed with the last
+ * 32 KiB of the chunk before it, and joined into one zlib stream (as pigz
+ * does); the file is valid to every PNG reader and barely larger than a
+ * single-threaded one. Needs zlib (TOP100_HAVE_ZLIB); without it open() fails.
+ *
+ * @ingroup services
+ */
+class PngWriter {
+public:
+    PngWriter();
+    /** Closes the file; one that was not finish()ed is removed */
+    ~PngWriter();
+    PngWriter(const PngWriter&) = delete;
+    PngWriter& operator=(const PngWriter&) = delete;
+
+    /** @return true if this build can write PNGs (zlib was found) */
+    static bool available();
+
+    /**
+     * @brief Create @p path and write the PNG header.
+     * @param path Output file, replaced if it exists.
+     * @param width Image width in pixels (> 0).
+     * @param height Image height in pixels (> 0).
+     * @param opts Colour type, resolution, compression level and threads.
+     * @return false if the file cannot be created or the size is invalid (see error()).
+     */
+    bool open(const std::string& path, int width, int height, const PngWriterOptions& opts = PngWriterOptions());
+
+    /**
+     * @brief Append rows to the image.
+     * @param data First pixel of the first row (premultiplied ARGB32).
+     * @param rows Number of rows.
+     * @param stride Bytes from one row to the next.
+     * @return false on a write error or when more rows than the height are given.
+     */
+    bool writeRows(const unsigned char* data, int rows, int stride);
+
+    /**
+     * @brief Flush the compressor and write the trailing chunks.
+     * @return false unless exactly height rows were written and the file was saved.
+     */
+    bool finish();
+
+    /** @return Rows written so far. */
+    int rowsWritten() const { return row_; }
+    /** @return Why the last call failed (empty when none did). */
+    const std::string& error() const { return error_; }
+
+private:
+    struct Stream;
+
+    bool fail(const std::string& why);
+    bool writeChunk(const char type[4], const unsigned char* data, size_t size);
+    bool drain(bool finishing);
+    bool submitChunk(bool last);
+    bool writeFinished(size_t keep);
+    void close(bool keep);
+
+    std::string path_;
+    std::FILE* file_ = nullptr;
+    std::unique_ptr<Stream> z_;
+    int width_ = 0;
+    int height_ = 0;
+    int row_ = 0;
+    size_t bpp_ = 3;
+    std::vector<unsigned char> prev_, cur_, filtered_, out_;
+    std::string error_;
+};
@@ -0,0 +1,922 @@
+// SPDX-License-Identifier: Apache-2.0
+//-------------------------------------------------------------------------------
+// Top100 — Your Personal Movie List
+//
+// File: lib/poster_cache.cpp
+// Purpose: Poster cache shared by every front end (memory, SQLite, network).
+// Language: C++17 (CMake build)
+//-------------------------------------------------------------------------------
+#include "poster_cache.h"
+#include "config.h"
+#include "http.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstring>
+#include <vector>
+#ifndef TOP100_NO_SQLITE
+#include <sqlite3.h>
+#endif
+
+// JPEG quality of stored thumbnails: no visible loss at list and cell sizes
+static const int kThumbnailQuality = 85;
+
+static int64_t nowMs() {
+    using namespace std::chrono;
+    return duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count();
+}
+
+PosterCache::PosterCache(const std::string& dbPath, PosterCacheOptions opts) : opts_(opts) {
+#ifndef TOP100_NO_SQLITE
+    if (dbPath.empty()) return;
+    sqlite3* db = nullptr;
+    const int flags = SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_FULLMUTEX;
+    if (sqlite3_open_v2(dbPath.c_str(), &db, flags, nullptr) != SQLITE_OK) {
+        if (db) sqlite3_close(db);
+        return;
+    }
+    // Other front ends may hold the database briefly
+    sqlite3_busy_timeout(db, 2000);
+    // Same table the image exporter has always filled; url, usedAt and the size
+    // were added later. poster_thumbnails holds each poster's thumbnails as JPEG;
+    // poster_thumbs, which held them as raw pixels, is dropped.
+    const char* sql = R"SQL(
+        CREATE TABLE IF NOT EXISTS posters(
+            imdbID TEXT PRIMARY KEY,
+            mime TEXT,
+            data BLOB,
+            updatedAt INTEGER
+        );
+        CREATE TABLE IF NOT EXISTS poster_thumbnails(
+            imdbID TEXT,
+            size INTEGER,
+            width INTEGER,
+            height INTEGER,
+            data BLOB,
+            PRIMARY KEY(imdbID, size)
+        );
+        DROP TABLE IF EXISTS poster_thumbs;
+    )SQL";
+    if (sqlite3_exec(db, sql, nullptr, nullptr, nullptr) != SQLITE_OK) {
+        sqlite3_close(db);
+        return;
+    }
+    bool hasUrl = false, hasUsedAt = false, hasSize = false;
+    sqlite3_stmt* st = nullptr;
+    if (sqlite3_prepare_v2(db, "PRAGMA table_info(posters)", -1, &st, nullptr) == SQLITE_OK) {
+        while (sqlite3_step(st) == SQLITE_ROW) {
+            const unsigned char* name = sqlite3_column_text(st, 1);
+            const std::string col = name ? reinterpret_cast<const char*>(name) : "";
+            hasUrl = hasUrl || col == "url";
+            hasUsedAt = hasUsedAt || col == "usedAt";
+            hasSize = hasSize || col == "width";
+        }
+        sqlite3_finalize(st);
+    }
+    if (!hasUrl) sqlite3_exec(db, "ALTER TABLE posters ADD COLUMN url TEXT", nullptr, nullptr, nullptr);
+    if (!hasUsedAt) sqlite3_exec(db, "ALTER TABLE posters ADD COLUMN usedAt INTEGER", nullptr, nullptr, nullptr);
+    if (!hasSize) {
+        sqlite3_exec(db, "ALTER TABLE posters ADD COLUMN width INTEGER", nullptr, nullptr, nullptr);
+        sqlite3_exec(db, "ALTER TABLE posters ADD COLUMN height INTEGER", nullptr, nullptr, nullptr);
+    }
+    st = nullptr;
+    const char* totals = "SELECT (SELECT COALESCE(SUM(length(data)), 0) FROM posters) + "
+                         "(SELECT COALESCE(SUM(length(data)), 0) FROM poster_thumbnails), "
+                         "(SELECT COALESCE(MAX(usedAt), 0) FROM posters)";
+    if (sqlite3_prepare_v2(db, totals, -1, &st, nullptr) == SQLITE_OK) {
+        if (sqlite3_step(st) == SQLITE_ROW) {
+            dbBytes_ = sqlite3_column_int64(st, 0);
+            lastUse_ = sqlite3_column_int64(st, 1);
+        }
+        sqlite3_finalize(st);
+    }
+    db_ = db;
+#else
+    (void)dbPath;
+#endif
+}
+
+PosterCache::~PosterCache() {
+#ifndef TOP100_NO_SQLITE
+    if (db_) sqlite3_close(db_);
+#endif
+}
+
+std::string PosterCache::keyOf(const std::string& imdbID, const std::string& url) {
+    std::string id;
+    for (unsigned char c : imdbID) {
+        if (!std::isspace(c)) id += static_cast<char>(c);
+    }
+    if (!id.empty()) return id;
+    return downloadable(url) ? url : std::string();
+}
+
+bool PosterCache::downloadable(const std::string& url) {
+    return !url.empty() && url != "N/A";
+}
+
+PosterPtr PosterCache::lookupMemory(const std::string& key, const std::string& url, bool countHit) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = memory_.find(key);
+    if (it == memory_.end()) return nullptr;
+    const PosterPtr& p = it->second->poster;
+    if (downloadable(url) && !p->url.empty() && p->url != url) {
+        // The movie's poster changed: forget the old one
+        memoryBytes_ -= it->second->cost;
+        lru_.erase(it->second);
+        memory_.erase(it);
+        return nullptr;
+    }
+    lru_.splice(lru_.begin(), lru_, it->second);
+    if (countHit) ++stats_.memoryHits;
+    return it->second->poster;
+}
+
+PosterPtr PosterCache::remember(const std::string& key, const std::string& url, std::string bytes, std::string mime,
+                                PosterTier tier) {
+    auto p = std::make_shared<Poster>();
+    p->key = key;
+    p->url = url;
+    p->bytes = std::move(bytes);
+    p->mime = std::move(mime);
+    p->tier = tier;
+    if (opts_.decode) p->bitmap = decodePosterImage(p->bytes);
+    return insertMemory(key, std::move(p));
+}
+
+PosterPtr PosterCache::insertMemory(const std::string& key, PosterPtr p) {
+    const size_t cost = key.size() + p->url.size() + p->bytes.size() + (p->bitmap ? p->bitmap->byteSize() : 0);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = memory_.find(key);
+    if (it != memory_.end()) {
+        memoryBytes_ -= it->second->cost;
+        lru_.erase(it->second);
+        memory_.erase(it);
+    }
+    if (cost > opts_.memoryBytes) return p;   // larger than the whole tier: pass through
+    lru_.push_front(Slot{key, p, cost});
+    memory_[key] = lru_.begin();
+    memoryBytes_ += cost;
+    while (memoryBytes_ > opts_.memoryBytes && lru_.size() > 1) {
+        memoryBytes_ -= lru_.back().cost;
+        memory_.erase(lru_.back().key);
+        lru_.pop_back();
+        ++stats_.memoryEvictions;
+    }
+    return p;
+}
+
+PosterPtr PosterCache::loadStored(const std::string& key, const std::string& url) {
+    return storedPoster(key, url, readStored(key));
+}
+
+PosterPtr PosterCache::storedPoster(const std::string& key, const std::string& url, std::optional<Stored> stored) {
+    if (!stored) return nullptr;
+    // Rows written before URLs were recorded are trusted
+    if (downloadable(url) && !stored->url.empty() && stored->url != url) return nullptr;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++stats_.databaseHits;
+    }
+    return remember(key, stored->url.empty() ? url : stored->url, std::move(stored->bytes), std::move(stored->mime),
+                    PosterTier::Database);
+}
+
+PosterPtr PosterCache::downloaded(const std::string& key, const std::string& url, int status, const std::string& body,
+                                  const std::string& contentType) {
+    if (status != 200 || body.empty()) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++stats_.failures;
+        return nullptr;
+    }
+    // Trust the bytes over the header; poster hosts often say octet-stream
+    std::string mime = posterMimeOf(body);
+    if (mime == "application/octet-stream" && contentType.compare(0, 6, "image/") == 0)
+        mime = contentType.substr(0, contentType.find(';'));
+    writeStored(key, url, mime, body);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++stats_.downloads;
+    }
+    return remember(key, url, body, mime, PosterTier::Network);
+}
+
+PosterPtr PosterCache::loadBlocking(const std::string& key, const std::string& url) {
+    if (auto p = loadStored(key, url)) return p;
+    if (!downloadable(url)) return nullptr;
+    HttpRequest req;
+    req.url = url;
+    req.timeoutMs = opts_.timeoutMs;
+    cpr::Response r = httpClient().perform(req);
+    return downloaded(key, url, static_cast<int>(r.status_code), r.text, r.header["Content-Type"]);
+}
+
+Future<PosterPtr> PosterCache::loadAsync(const std::string& key, const std::string& url, CancelToken cancel) {
+    Promise<PosterPtr> promise;
+    Future<PosterPtr> out = promise.future();
+    auto self = shared_from_this();
+    // Database reads and decoding stay off the caller's (often the GUI) thread
+    sharedThreadPool().submit([self, key, url, cancel, promise]() {
+        if (cancel.cancelled()) {
+            promise.cancel();
+            return;
+        }
+        try {
+            if (auto p = self->loadStored(key, url)) {
+                promise.setValue(p);
+                return;
+            }
+            if (!downloadable(url)) {
+                promise.setValue(nullptr);
+                return;
+            }
+            HttpRequest req;
+            req.url = url;
+            req.timeoutMs = self->opts_.timeoutMs;
+            httpClient().performAsync(req, cancel).onComplete([self, key, url, promise](const Future<cpr::Response>& f) {
+                if (f.cancelled()) {
+                    promise.cancel();
+                    return;
+                }
+                try {
+                    auto r = std::make_shared<cpr::Response>(f.get());
+                    // Leave the event loop before decoding
+                    sharedThreadPool().submit([self, key, url, promise, r]() {
+                        try {
+                            promise.setValue(self->downloaded(key, url, static_cast<int>(r->status_code), r->text,
+                                                              r->header["Content-Type"]));
+                        } catch (...) {
+                            promise.setError(std::current_exception());
+                        }
+                    });
+                } catch (...) {
+                    promise.setError(std::current_exception());
+                }
+            });
+        } catch (...) {
+            promise.setError(std::current_exception());
+        }
+    });
+    return out;
+}
+
+PosterPtr PosterCache::get(const std::string& imdbID, const std::string& url) {
+    const std::string key = keyOf(imdbID, url);
+    if (key.empty()) return nullptr;
+    if (auto p = lookupMemory(key, url, true)) return p;
+    bool joined = false;
+    try {
+        PosterPtr p = flights_.run(key, [&] { return loadBlocking(key, url); }, &joined);
+        if (joined) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            ++stats_.joined;
+        }
+        return p;
+    } catch (const OperationCancelled&) {
+        // Joined an asynchronous load whose callers all gave up
+        return loadBlocking(key, url);
+    }
+}
+
+Future<PosterPtr> PosterCache::getAsync(const std::string& imdbID, const std::string& url, CancelToken cancel) {
+    const std::string key = keyOf(imdbID, url);
+    if (key.empty()) return readyFuture(PosterPtr());
+    if (auto p = lookupMemory(key, url, true)) return readyFuture(p);
+    bool joined = false;
+    auto self = shared_from_this();
+    Future<PosterPtr> out = flights_.runAsync(
+        key, std::move(cancel), [self, key, url](CancelToken t) { return self->loadAsync(key, url, std::move(t)); },
+        &joined);
+    if (joined) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++stats_.joined;
+    }
+    return out;
+}
+
+std::vector<PosterPtr> PosterCache::getAll(const std::vector<PosterRequest>& requests) {
+    std::vector<PosterPtr> out(requests.size());
+    std::vector<std::string> keys(requests.size());
+
+    // 1. Memory; the same poster asked for twice is loaded once
+    std::unordered_map<std::string, size_t> firstOf;
+    std::vector<size_t> missing;
+    for (size_t i = 0; i < requests.size(); ++i) {
+        keys[i] = keyOf(requests[i].imdbID, requests[i].url);
+        if (keys[i].empty()) continue;
+        if ((out[i] = lookupMemory(keys[i], requests[i].url, true))) continue;
+        if (firstOf.emplace(keys[i], i).second) missing.push_back(i);
+    }
+
+    // 2. Database, in one pass
+    std::vector<std::string> missingKeys;
+    missingKeys.reserve(missing.size());
+    for (size_t i : missing) missingKeys.push_back(keys[i]);
+    auto stored = readStoredMany(missingKeys);
+    // Database hits are decoded on the shared pool, unless this is one of its
+    // workers: waiting there on tasks queued behind it could deadlock, so the
+    // work is then done on this thread instead
+    const bool onPool = sharedThreadPool().onWorker();
+    auto decodeStored = [&](size_t j, size_t) {
+        const size_t i = missing[j];
+        out[i] = storedPoster(keys[i], requests[i].url, std::move(stored[j]));
+    };
+    if (onPool) {
+        for (size_t j = 0; j < missing.size(); ++j) decodeStored(j, 0);
+    } else {
+        sharedThreadPool().parallelFor(missing.size(), decodeStored);
+    }
+    std::vector<size_t> download;
+    for (size_t i : missing) {
+        if (!out[i] && downloadable(requests[i].url)) download.push_back(i);
+    }
+    if (onPool) {
+        // Downloaded posters are decoded on the pool too: fetch them one by one here
+        for (size_t i : download) out[i] = get(requests[i].imdbID, requests[i].url);
+        download.clear();
+    }
+
+    // 3. Network, at most maxDownloads at a time; joins loads already in flight
+    struct Window {
+        std::mutex mutex;
+        std::condition_variable cv;
+        size_t inFlight = 0;
+    };
+    auto window = std::make_shared<Window>();
+    const size_t limit = std::max<size_t>(1, opts_.maxDownloads);
+    auto self = shared_from_this();
+    std::vector<std::pair<size_t, Future<PosterPtr>>> pending;
+    for (size_t i : download) {
+        const std::string key = keys[i], url = requests[i].url;
+        auto flight = flights_.begin(key);
+        pending.emplace_back(i, flight.future());
+        if (!flight.leader()) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            ++stats_.joined;
+            continue;
+        }
+        {
+            std::unique_lock<std::mutex> lock(window->mutex);
+            window->cv.wait(lock, [&] { return window->inFlight < limit; });
+            ++window->inFlight;
+        }
+        HttpRequest req;
+        req.url = url;
+        req.timeoutMs = opts_.timeoutMs;
+        httpClient().performAsync(req).onComplete([self, window, key, url, flight](const Future<cpr::Response>& f) {
+            {
+                std::lock_guard<std::mutex> lock(window->mutex);
+                --window->inFlight;
+            }
+            window->cv.notify_one();
+            if (f.cancelled()) {
+                self->flights_.fail(key, flight, std::make_exception_ptr(OperationCancelled()));
+                return;
+            }
+            try {
+                auto r = std::make_shared<cpr::Response>(f.get());
+                // Leave the event loop before decoding
+                sharedThreadPool().submit([self, key, url, flight, r]() {
+                    try {
+                        self->flights_.finish(key, flight,
+                                              self->downloaded(key, url, static_cast<int>(r->status_code), r->text,
+                                                               r->header["Content-Type"]));
+                    } catch (...) {
+                        self->flights_.fail(key, flight, std::current_exception());
+                    }
+                });
+            } catch (...) {
+                self->flights_.fail(key, flight, std::current_exception());
+            }
+        });
+    }
+    for (auto& p : pending) {
+        try {
+            out[p.first] = p.second.get();
+        } catch (const OperationCancelled&) {
+            // Joined an asynchronous load whose callers all gave up
+            out[p.first] = loadBlocking(keys[p.first], requests[p.first].url);
+        } catch (...) {
+            out[p.first] = nullptr;
+        }
+    }
+
+    // Repeated requests share the first one's poster
+    for (size_t i = 0; i < requests.size(); ++i) {
+        if (out[i] || keys[i].empty()) continue;
+        auto it = firstOf.find(keys[i]);
+        if (it != firstOf.end() && it->second != i) out[i] = out[it->second];
+    }
+    return out;
+}
+
+PosterPtr PosterCache::peek(const std::string& imdbID, const std::string& url) {
+    const std::string key = keyOf(imdbID, url);
+    return key.empty() ? nullptr : lookupMemory(key, url, true);
+}
+
+int PosterCache::thumbnailSizeFor(int width, int height, int boxWidth, int boxHeight) {
+    if (width <= 0 || height <= 0 || boxWidth <= 0 || boxHeight <= 0) return 0;
+    const double fit = std::min({1.0, static_cast<double>(boxWidth) / width, static_cast<double>(boxHeight) / height});
+    const int longest = std::max(width, height);
+    const long needed = std::lround(longest * fit);
+    for (int size : kPosterThumbnailSizes) {
+        if (size >= longest) return 0;   // not smaller than the poster itself
+        if (size >= needed) return size;
+    }
+    return 0;
+}
+
+std::string PosterCache::thumbnailKey(const std::string& key, int size) {
+    // Tabs appear in neither IMDb IDs nor URLs
+    return key + '\t' + std::to_string(size);
+}
+
+std::optional<PosterCache::Dims> PosterCache::knownDims(const std::string& key, const std::string& url,
+                                                       bool readDatabase) {
+    auto matches = [&](const std::string& stored) { return !downloadable(url) || stored.empty() || stored == url; };
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = dims_.find(key);
+        if (it != dims_.end()) {
+            if (matches(it->second.url)) return it->second;
+            dims_.erase(it);
+        }
+        // A decoded poster in memory knows its size
+        auto m = memory_.find(key);
+        if (m != memory_.end()) {
+            const PosterPtr& p = m->second->poster;
+            if (p->bitmap && matches(p->url)) return Dims{p->url, p->bitmap->width, p->bitmap->height};
+        }
+    }
+    if (!readDatabase) return std::nullopt;
+    std::optional<Dims> d = readDims(key);
+    if (!d || !matches(d->url)) return std::nullopt;
+    std::lock_guard<std::mutex> lock(mutex_);
+    dims_[key] = *d;
+    return d;
+}
+
+std::shared_ptr<const PosterBitmap> PosterCache::cachedThumbnail(const std::string& key, const std::string& url,
+                                                                 int boxWidth, int boxHeight, bool readDatabase) {
+    const std::optional<Dims> dims = knownDims(key, url, readDatabase);
+    if (!dims) return nullptr;
+    const int size = thumbnailSizeFor(dims->width, dims->height, boxWidth, boxHeight);
+    if (size == 0) {
+        // Only the full poster will do
+        PosterPtr p = lookupMemory(key, url, true);
+        return p ? p->bitmap : nullptr;
+    }
+    if (!opts_.thumbnails) return nullptr;
+    if (PosterPtr t = lookupMemory(thumbnailKey(key, size), url, false)) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++stats_.thumbnailHits;
+        return t->bitmap;
+    }
+    if (!readDatabase) return nullptr;
+    std::shared_ptr<const PosterBitmap> bitmap = readThumbnail(key, size);
+    if (!bitmap) return nullptr;
+    auto t = std::make_shared<Poster>();
+    t->key = thumbnailKey(key, size);
+    t->url = dims->url;
+    t->bitmap = bitmap;
+    t->tier = PosterTier::Database;
+    insertMemory(t->key, t);
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++stats_.thumbnailHits;
+    return bitmap;
+}
+
+std::shared_ptr<const PosterBitmap> PosterCache::makeThumbnail(const std::string& key, const PosterPtr& poster,
+                                                               int boxWidth, int boxHeight) {
+    if (!poster) return nullptr;
+    const bool keep = opts_.thumbnails;
+    // Thumbnails that aren't kept may come from a reduced-size decode; kept ones record the real size
+    std::shared_ptr<const PosterBitmap> full = poster->bitmap;
+    if (!full) full = decodePosterImage(poster->bytes, keep ? 0 : boxWidth, keep ? 0 : boxHeight);
+    if (!full) return nullptr;
+    if (keep) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            dims_[key] = Dims{poster->url, full->width, full->height};
+        }
+        writeDims(key, full->width, full->height);
+    }
+    const int size = thumbnailSizeFor(full->width, full->height, boxWidth, boxHeight);
+    if (size == 0) return full;
+    auto scale = [&]() {
+        auto t = std::make_shared<Poster>();
+        t->key = thumbnailKey(key, size);
+        t->url = poster->url;
+        t->bitmap = scalePosterBitmap(*full, size, size);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            ++stats_.thumbnailsMade;
+        }
+        if (!keep || !t->bitmap) return PosterPtr(t);
+        writeThumbnail(key, size, *t->bitmap);
+        return insertMemory(t->key, t);
+    };
+    if (!keep) return scale()->bitmap;
+    // Views of the same size asking at once scale the poster once
+    const std::string tkey = thumbnailKey(key, size);
+    if (PosterPtr t = lookupMemory(tkey, poster->url, false)) return t->bitmap;
+    PosterPtr t = flights_.run(tkey, scale);
+    return t ? t->bitmap : nullptr;
+}
+
+std::shared_ptr<const PosterBitmap> PosterCache::thumbnail(const std::string& imdbID, const std::string& url,
+                                                           int boxWidth, int boxHeight) {
+    const std::string key = keyOf(imdbID, url);
+    if (key.empty()) return nullptr;
+    if (auto t = cachedThumbnail(key, url, boxWidth, boxHeight, true)) return t;
+    return makeThumbnail(key, get(imdbID, url), boxWidth, boxHeight);
+}
+
+std::shared_ptr<const PosterBitmap> PosterCache::storedThumbnail(const std::string& imdbID, const std::string& url,
+                                                                 int boxWidth, int boxHeight) {
+    const std::string key = keyOf(imdbID, url);
+    return key.empty() ? nullptr : cachedThumbnail(key, url, boxWidth, boxHeight, true);
+}
+
+Future<std::shared_ptr<const PosterBitmap>> PosterCache::thumbnailAsync(const std::string& imdbID,
+                                                                        const std::string& url, int boxWidth,
+                                                                        int boxHeight, CancelToken cancel) {
+    using BitmapPtr = std::shared_ptr<const PosterBitmap>;
+    const std::string key = keyOf(imdbID, url);
+    if (key.empty()) return readyFuture(BitmapPtr());
+    if (auto t = cachedThumbnail(key, url, boxWidth, boxHeight, false)) return readyFuture(t);
+    Promise<BitmapPtr> promise;
+    Future<BitmapPtr> out = promise.future();
+    auto self = shared_from_this();
+    sharedThreadPool().submit([self, key, imdbID, url, boxWidth, boxHeight, cancel, promise]() {
+        if (cancel.cancelled()) {
+            promise.cancel();
+            return;
+        }
+        try {
+            if (auto t = self->cachedThumbnail(key, url, boxWidth, boxHeight, true)) {
+                promise.setValue(t);
+                return;
+            }
+            self->getAsync(imdbID, url, cancel)
+                .onComplete([self, key, boxWidth, boxHeight, promise](const Future<PosterPtr>& f) {
+                    if (f.cancelled()) {
+                        promise.cancel();
+                        return;
+                    }
+                    PosterPtr poster;
+                    try {
+                        poster = f.get();
+                    } catch (...) {
+                        promise.setError(std::current_exception());
+                        return;
+                    }
+                    // Scaling stays off the event loop
+                    sharedThreadPool().submit([self, key, poster, boxWidth, boxHeight, promise]() {
+                        try {
+                            promise.setValue(self->makeThumbnail(key, poster, boxWidth, boxHeight));
+                        } catch (...) {
+                            promise.setError(std::current_exception());
+                        }
+                    });
+                });
+        } catch (...) {
+            promise.setError(std::current_exception());
+        }
+    });
+    return out;
+}
+
+PosterPtr PosterCache::put(const std::string& imdbID, const std::string& url, const std::string& bytes) {
+    const std::string key = keyOf(imdbID, url);
+    if (key.empty() || bytes.empty()) return nullptr;
+    const std::string mime = posterMimeOf(bytes);
+    writeStored(key, url, mime, bytes);
+    return remember(key, url, bytes, mime, PosterTier::Network);
+}
+
+void PosterCache::clearMemory() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    lru_.clear();
+    memory_.clear();
+    dims_.clear();
+    memoryBytes_ = 0;
+}
+
+PosterCacheStats PosterCache::stats() const {
+    PosterCacheStats out;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        out = stats_;
+        out.memoryEntries = lru_.size();
+        out.memoryBytes = memoryBytes_;
+    }
+    std::lock_guard<std::mutex> lock(dbMutex_);
+    out.databaseBytes = dbBytes_;
+    return out;
+}
+
+std::optional<PosterCache::Stored> PosterCache::readStored(const std::string& key) {
+    return std::move(readStoredMany({key}).front());
+}
+
+std::vector<std::optional<PosterCache::Stored>> PosterCache::readStoredMany(const std::vector<std::string>& keys) {
+    std::vector<std::optional<Stored>> out(keys.size());
+#ifndef TOP100_NO_SQLITE
+    if (!db_ || keys.empty()) return out;
+    std::lock_guard<std::mutex> lock(dbMutex_);
+    sqlite3_stmt* st = nullptr;
+    if (sqlite3_prepare_v2(db_, "SELECT data, mime, url FROM posters WHERE imdbID=?", -1, &st, nullptr) != SQLITE_OK)
+        return out;
+    bool any = false;
+    for (size_t i = 0; i < keys.size(); ++i) {
+        sqlite3_bind_text(st, 1, keys[i].c_str(), -1, SQLITE_TRANSIENT);
+        if (sqlite3_step(st) == SQLITE_ROW) {
+            const void* blob = sqlite3_column_blob(st, 0);
+            const int n = sqlite3_column_bytes(st, 0);
+            if (blob && n > 0) {
+                auto text = [&](int col) {
+                    const unsigned char* p = sqlite3_column_text(st, col);
+                    return p ? std::string(reinterpret_cast<const char*>(p)) : std::string();
+                };
+                Stored s;
+                s.bytes.assign(static_cast<const char*>(blob), static_cast<size_t>(n));
+                s.mime = text(1);
+                s.url = text(2);
+                out[i] = std::move(s);
+                any = true;
+            }
+        }
+        sqlite3_reset(st);
+    }
+    sqlite3_finalize(st);
+    if (!any || sqlite3_prepare_v2(db_, "UPDATE posters SET usedAt=? WHERE imdbID=?", -1, &st, nullptr) != SQLITE_OK)
+        return out;
+    // One transaction for every touched row
+    sqlite3_exec(db_, "BEGIN", nullptr, nullptr, nullptr);
+    for (size_t i = 0; i < keys.size(); ++i) {
+        if (!out[i]) continue;
+        sqlite3_bind_int64(st, 1, nextUse());
+        sqlite3_bind_text(st, 2, keys[i].c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_step(st);
+        sqlite3_reset(st);
+    }
+    sqlite3_finalize(st);
+    sqlite3_exec(db_, "COMMIT", nullptr, nullptr, nullptr);
+#else
+    (void)keys;
+#endif
+    return out;
+}
+
+void PosterCache::writeStored(const std::string& key, const std::string& url, const std::string& mime,
+                              const std::string& bytes) {
+#ifndef TOP100_NO_SQLITE
+    if (!db_) return;
+    std::lock_guard<std::mutex> lock(dbMutex_);
+    sqlite3_stmt* st = nullptr;
+    int64_t previous = 0;
+    // The poster and the thumbnails made from it, which it replaces
+    const char* old = "SELECT length(data) + (SELECT COALESCE(SUM(length(t.data)), 0) FROM poster_thumbnails t "
+                      "WHERE imdbID=?1) FROM posters WHERE imdbID=?1";
+    if (sqlite3_prepare_v2(db_, old, -1, &st, nullptr) == SQLITE_OK) {
+        sqlite3_bind_text(st, 1, key.c_str(), -1, SQLITE_TRANSIENT);
+        if (sqlite3_step(st) == SQLITE_ROW) previous = sqlite3_column_int64(st, 0);
+        sqlite3_finalize(st);
+    }
+    const char* ins = "INSERT INTO posters(imdbID, mime, data, updatedAt, url, usedAt) "
+                      "VALUES(?,?,?,strftime('%s','now'),?,?) "
+                      "ON CONFLICT(imdbID) DO UPDATE SET mime=excluded.mime, data=excluded.data, "
+                      "updatedAt=excluded.updatedAt, url=excluded.url, usedAt=excluded.usedAt, "
+                      "width=NULL, height=NULL";
+    if (sqlite3_prepare_v2(db_, ins, -1, &st, nullptr) != SQLITE_OK) return;
+    sqlite3_bind_text(st, 1, key.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(st, 2, mime.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_blob(st, 3, bytes.data(), static_cast<int>(bytes.size()), SQLITE_TRANSIENT);
+    sqlite3_bind_text(st, 4, url.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_int64(st, 5, nextUse());
+    const bool ok = sqlite3_step(st) == SQLITE_DONE;
+    sqlite3_finalize(st);
+    if (!ok) return;
+    if (previous > 0 && sqlite3_prepare_v2(db_, "DELETE FROM poster_thumbnails WHERE imdbID=?", -1, &st, nullptr) == SQLITE_OK) {
+        sqlite3_bind_text(st, 1, key.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_step(st);
+        sqlite3_finalize(st);
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        dims_.erase(key);
+    }
+    dbBytes_ += static_cast<int64_t>(bytes.size()) - previous;
+    if (dbBytes_ > opts_.databaseBytes) trimDatabase(key);
+#else
+    (void)key;
+    (void)url;
+    (void)mime;
+    (void)bytes;
+#endif
+}
+
+std::optional<PosterCache::Dims> PosterCache::readDims(const std::string& key) {
+#ifndef TOP100_NO_SQLITE
+    if (!db_) return std::nullopt;
+    std::lock_guard<std::mutex> lock(dbMutex_);
+    sqlite3_stmt* st = nullptr;
+    if (sqlite3_prepare_v2(db_, "SELECT width, height, url FROM posters WHERE imdbID=? AND width > 0 AND height > 0",
+                           -1, &st, nullptr) != SQLITE_OK)
+        return std::nullopt;
+    sqlite3_bind_text(st, 1, key.c_str(), -1, SQLITE_TRANSIENT);
+    std::optional<Dims> out;
+    if (sqlite3_step(st) == SQLITE_ROW) {
+        const unsigned char* url = sqlite3_column_text(st, 2);
+        out = Dims{url ? reinterpret_cast<const char*>(url) : "", sqlite3_column_int(st, 0), sqlite3_column_int(st, 1)};
+    }
+    sqlite3_finalize(st);
+    return out;
+#else
+    (void)key;
+    return std::nullopt;
+#endif
+}
+
+void PosterCache::writeDims(const std::string& key, int width, int height) {
+#ifndef TOP100_NO_SQLITE
+    if (!db_) return;
+    std::lock_guard<std::mutex> lock(dbMutex_);
+    sqlite3_stmt* st = nullptr;
+    if (sqlite3_prepare_v2(db_, "UPDATE posters SET width=?, height=? WHERE imdbID=?", -1, &st, nullptr) != SQLITE_OK)
+        return;
+    sqlite3_bind_int(st, 1, width);
+    sqlite3_bind_int(st, 2, height);
+    sqlite3_bind_text(st, 3, key.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_step(st);
+    sqlite3_finalize(st);
+#else
+    (void)key;
+    (void)width;
+    (void)height;
+#endif
+}
+
+std::shared_ptr<const PosterBitmap> PosterCache::readThumbnail(const std::string& key, int size) {
+#ifndef TOP100_NO_SQLITE
+    if (!db_) return nullptr;
+    std::lock_guard<std::mutex> lock(dbMutex_);
+    sqlite3_stmt* st = nullptr;
+    if (sqlite3_prepare_v2(db_, "SELECT width, height, data FROM poster_thumbnails WHERE imdbID=? AND size=?", -1, &st,
+                           nullptr) != SQLITE_OK)
+        return nullptr;
+    sqlite3_bind_text(st, 1, key.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_int(st, 2, size);
+    int w = 0, h = 0;
+    std::string bytes;
+    if (sqlite3_step(st) == SQLITE_ROW) {
+        w = sqlite3_column_int(st, 0);
+        h = sqlite3_column_int(st, 1);
+        const void* blob = sqlite3_column_blob(st, 2);
+        const int n = sqlite3_column_bytes(st, 2);
+        if (blob && n > 0) bytes.assign(static_cast<const char*>(blob), static_cast<size_t>(n));
+    }
+    sqlite3_finalize(st);
+    std::shared_ptr<const PosterBitmap> out = bytes.empty() ? nullptr : decodePosterImage(bytes);
+    if (out && (out->width != w || out->height != h)) out = nullptr;
+    // Showing a thumbnail is a use of its poster
+    if (out && sqlite3_prepare_v2(db_, "UPDATE posters SET usedAt=? WHERE imdbID=?", -1, &st, nullptr) == SQLITE_OK) {
+        sqlite3_bind_int64(st, 1, nextUse());
+        sqlite3_bind_text(st, 2, key.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_step(st);
+        sqlite3_finalize(st);
+    }
+    return out;
+#else
+    (void)key;
+    (void)size;
+    return nullptr;
+#endif
+}
+
+void PosterCache::writeThumbnail(const std::string& key, int size, const PosterBitmap& bitmap) {
+#ifndef TOP100_NO_SQLITE
+    if (!db_) return;
+    // Compressed like the poster (a few KB instead of width x height x 4 bytes), encoded
+    // before taking the lock. Builds without libjpeg, and posters with transparency,
+    // keep their thumbnails in memory only.
+    const std::string jpeg = encodePosterJpeg(bitmap, kThumbnailQuality);
+    if (jpeg.empty()) return;
+    std::lock_guard<std::mutex> lock(dbMutex_);
+    sqlite3_stmt* st = nullptr;
+    int64_t previous = 0;
+    if (sqlite3_prepare_v2(db_, "SELECT length(data) FROM poster_thumbnails WHERE imdbID=? AND size=?", -1, &st,
+                           nullptr) == SQLITE_OK) {
+        sqlite3_bind_text(st, 1, key.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_int(st, 2, size);
+        if (sqlite3_step(st) == SQLITE_ROW) previous = sqlite3_column_int64(st, 0);
+        sqlite3_finalize(st);
+    }
+    // Only for posters that are stored
+    const char* ins = "INSERT OR REPLACE INTO poster_thumbnails(imdbID, size, width, height, data) "
+                      "SELECT ?1, ?2, ?3, ?4, ?5 WHERE EXISTS(SELECT 1 FROM posters WHERE imdbID=?1)";
+    if (sqlite3_prepare_v2(db_, ins, -1, &st, nullptr) != SQLITE_OK) return;
+    sqlite3_bind_text(st, 1, key.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_int(st, 2, size);
+    sqlite3_bind_int(st, 3, bitmap.width);
+    sqlite3_bind_int(st, 4, bitmap.height);
+    sqlite3_bind_blob(st, 5, jpeg.data(), static_cast<int>(jpeg.size()), SQLITE_TRANSIENT);
+    const bool ok = sqlite3_step(st) == SQLITE_DONE && sqlite3_changes(db_) > 0;
+    sqlite3_finalize(st);
+    if (!ok) return;
+    dbBytes_ += static_cast<int64_t>(jpeg.size()) - previous;
+    if (dbBytes_ > opts_.databaseBytes) trimDatabase(key);
+#else
+    (void)key;
+    (void)size;
+    (void)bitmap;
+#endif
+}
+
+int64_t PosterCache::nextUse() {
+    // Strictly increasing, so the eviction order is exact even within a millisecond
+    lastUse_ = std::max(lastUse_ + 1, nowMs());
+    return lastUse_;
+}
+
+void PosterCache::trimDatabase(const std::string& keep) {
+#ifndef TOP100_NO_SQLITE
+    // Caller holds dbMutex_ (always taken before mutex_). Rows from before usedAt
+    // existed count as used when they were written.
+    std::vector<std::pair<std::string, int64_t>> victims;
+    sqlite3_stmt* st = nullptr;
+    const char* sel = "SELECT imdbID, length(data) + (SELECT COALESCE(SUM(length(t.data)), 0) FROM poster_thumbnails t "
+                      "WHERE t.imdbID = posters.imdbID) FROM posters ORDER BY COALESCE(usedAt, updatedAt * 1000, 0)";
+    if (sqlite3_prepare_v2(db_, sel, -1, &st, nullptr) != SQLITE_OK) return;
+    int64_t bytes = dbBytes_;
+    while (bytes > opts_.databaseBytes && sqlite3_step(st) == SQLITE_ROW) {
+        const unsigned char* id = sqlite3_column_text(st, 0);
+        std::string key = id ? reinterpret_cast<const char*>(id) : "";
+        if (key == keep) continue;
+        const int64_t n = sqlite3_column_int64(st, 1);
+        victims.emplace_back(std::move(key), n);
+        bytes -= n;
+    }
+    sqlite3_finalize(st);
+    if (victims.empty()) return;
+    sqlite3_exec(db_, "BEGIN", nullptr, nullptr, nullptr);
+    sqlite3_stmt* thumbs = nullptr;
+    sqlite3_prepare_v2(db_, "DELETE FROM poster_thumbnails WHERE imdbID=?", -1, &thumbs, nullptr);
+    if (sqlite3_prepare_v2(db_, "DELETE FROM posters WHERE imdbID=?", -1, &st, nullptr) == SQLITE_OK) {
+        for (const auto& v : victims) {
+            sqlite3_bind_text(st, 1, v.first.c_str(), -1, SQLITE_TRANSIENT);
+            if (sqlite3_step(st) == SQLITE_DONE) {
+                if (thumbs) {
+                    sqlite3_bind_text(thumbs, 1, v.first.c_str(), -1, SQLITE_TRANSIENT);
+                    sqlite3_step(thumbs);
+                    sqlite3_reset(thumbs);
+                }
+                dbBytes_ -= v.second;
+                std::lock_guard<std::mutex> lock(mutex_);
+                ++stats_.databaseEvictions;
+            }
+            sqlite3_reset(st);
+        }
+        sqlite3_finalize(st);
+    }
+    sqlite3_finalize(thumbs);
+    sqlite3_exec(db_, "COMMIT", nullptr, nullptr, nullptr);
+#else
+    (void)keep;
+#endif
+}
+
+std::shared_ptr<PosterCache> openPosterCache(const AppConfig& cfg) {
+    PosterCacheOptions opts;
+    opts.memoryBytes = static_cast<size_t>(std::max(1, cfg.posterCacheMemoryMB)) << 20;
+    opts.databaseBytes = static_cast<int64_t>(std::max(1, cfg.posterCacheDatabaseMB)) << 20;
+    return std::make_shared<PosterCache>(cfg.dataFile, opts);
+}
+
+static std::mutex gPosterCacheMutex;
+
+static std::shared_ptr<PosterCache>& posterCacheSlot() {
+    // Construct the HTTP client and pool first so they outlive loads still running at exit
+    httpClient();
+    sharedThreadPool();
+    static std::shared_ptr<PosterCache> slot;
+    return slot;
+}
+
+void setPosterCache(std::shared_ptr<PosterCache> cache) {
+    std::lock_guard<std::mutex> lock(gPosterCacheMutex);
+    posterCacheSlot() = std::move(cache);
+}
+
+std::shared_ptr<PosterCache> posterCache() {
+    std::lock_guard<std::mutex> lock(gPosterCacheMutex);
+    auto& slot = posterCacheSlot();
+    if (!slot) slot = std::make_shared<PosterCache>(std::string());
+    return slot;
+}
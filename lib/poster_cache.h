@@ -0,0 +1,385 @@
+// SPDX-License-Identifier: Apache-2.0
+//-------------------------------------------------------------------------------
+// Top100 — Your Personal Movie List
+//
+// File: lib/poster_cache.h
+// Purpose: Poster cache shared by every front end (memory, SQLite, network).
+// Language: C++17 (header)
+//-------------------------------------------------------------------------------
+#pragma once
+
+#include "async.h"
+#include "poster_image.h"
+#include "single_flight.h"
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+struct AppConfig;
+struct sqlite3;
+
+/**
+ * @brief Size limits of a PosterCache.
+ * @ingroup services
+ */
+struct PosterCacheOptions {
+    /** Memory tier budget (encoded bytes plus decoded pixels) */
+    size_t memoryBytes = 64u << 20;
+    /** Database tier budget (stored image bytes); least recently used posters go first */
+    int64_t databaseBytes = int64_t(256) << 20;
+    /** Decode posters when they enter the memory tier */
+    bool decode = true;
+    /** Download timeout in milliseconds */
+    std::int32_t timeoutMs = 8000;
+    /** Downloads in flight at once during getAll() */
+    size_t maxDownloads = 8;
+    /** Keep the thumbnails thumbnail() makes (memory and database); off = make them every time */
+    bool thumbnails = true;
+};
+
+/**
+ * @brief Longest edge, in pixels, of the thumbnails a PosterCache keeps.
+ *
+ * A list icon, the export grid cell and the details pane, each also at twice
+ * the size for HiDPI screens.
+ *
+ * @ingroup services
+ */
+inline constexpr int kPosterThumbnailSizes[] = {48, 96, 170, 240, 340, 480};
+
+/**
+ * @brief One poster wanted by PosterCache::getAll().
+ * @ingroup services
+ */
+struct PosterRequest {
+    /** IMDb identifier (may be empty) */
+    std::string imdbID;
+    /** Poster URL */
+    std::string url;
+};
+
+/**
+ * @brief Where a poster was found.
+ * @ingroup services
+ */
+enum class PosterTier { Memory, Database, Network };
+
+/**
+ * @brief A cached poster.
+ * @ingroup services
+ */
+struct Poster {
+    /** Cache key (see PosterCache::keyOf()) */
+    std::string key;
+    /** URL it was downloaded from */
+    std::string url;
+    /** Encoded image as downloaded */
+    std::string bytes;
+    /** MIME type, e.g. "image/jpeg" */
+    std::string mime;
+    /** Decoded pixels; nullptr if decoding is off or the format can't be decoded here */
+    std::shared_ptr<const PosterBitmap> bitmap;
+    /** Tier that answered the lookup that loaded it into memory */
+    PosterTier tier = PosterTier::Network;
+};
+
+/** Shared, immutable poster; nullptr when there is none. */
+using PosterPtr = std::shared_ptr<const Poster>;
+
+/**
+ * @brief PosterCache counters.
+ * @ingroup services
+ */
+struct PosterCacheStats {
+    /** Lookups answered from memory */
+    uint64_t memoryHits = 0;
+    /** Lookups answered from the database */
+    uint64_t databaseHits = 0;
+    /** Posters downloaded */
+    uint64_t downloads = 0;
+    /** Downloads that failed (transport error, non-200, empty body) */
+    uint64_t failures = 0;
+    /** Lookups that joined a load already in progress */
+    uint64_t joined = 0;
+    /** Posters dropped from memory to stay within budget */
+    uint64_t memoryEvictions = 0;
+    /** Posters deleted from the database to stay within budget */
+    uint64_t databaseEvictions = 0;
+    /** Thumbnails answered from memory or the database */
+    uint64_t thumbnailHits = 0;
+    /** Thumbnails made by scaling a poster */
+    uint64_t thumbnailsMade = 0;
+    /** Posters in memory */
+    size_t memoryEntries = 0;
+    /** Bytes held in memory */
+    size_t memoryBytes = 0;
+    /** Image bytes stored in the database */
+    int64_t databaseBytes = 0;
+};
+
+/**
+ * @brief Three-tier poster cache: decoded images in memory, blobs in SQLite, then the network.
+ *
+ * Posters are keyed by IMDb ID (or by URL for movies without one). A lookup
+ * tries an LRU of decoded posters bounded by PosterCacheOptions::memoryBytes,
+ * then the @c posters table of the list's database, then downloads the URL and
+ * stores the result in both tiers. The database tier is bounded too: when it
+ * grows past PosterCacheOptions::databaseBytes the least recently used posters
+ * are deleted. A stored poster whose URL no longer matches the movie's is
+ * downloaded again.
+ *
+ * Each poster also gets thumbnails at the kPosterThumbnailSizes, made the
+ * first time a view of that size asks for one and stored next to the poster,
+ * so later views neither rescale it nor decode the full poster. Stored
+ * thumbnails are JPEG-compressed (a few KB each) and count towards
+ * databaseBytes with their poster; without libjpeg, or for posters with
+ * transparency, they are kept in memory only.
+ *
+ * Concurrent lookups of the same poster, blocking or asynchronous, share one
+ * load. Install one cache per process with setPosterCache() so every window,
+ * dialog and service reuses the same downloads.
+ *
+ * Thread-safe. Must be owned by a std::shared_ptr (asynchronous loads keep
+ * it alive). Without SQLite support (TOP100_NO_SQLITE) or a database path
+ * only the memory tier is used.
+ *
+ * @ingroup services
+ */
+class PosterCache : public std::enable_shared_from_this<PosterCache> {
+public:
+    /**
+     * @brief Open (and create if needed) the posters table in @p dbPath.
+     * @param dbPath SQLite database file (usually AppConfig::dataFile); empty = memory only
+     * @param opts Size limits
+     */
+    explicit PosterCache(const std::string& dbPath, PosterCacheOptions opts = {});
+    ~PosterCache();
+
+    PosterCache(const PosterCache&) = delete;
+    PosterCache& operator=(const PosterCache&) = delete;
+
+    /** @return true if the database tier is available. */
+    bool hasDatabase() const { return db_ != nullptr; }
+
+    /** @return Size limits. */
+    const PosterCacheOptions& options() const { return opts_; }
+
+    /**
+     * @brief Look a poster up, downloading it on a miss (blocking).
+     * @param imdbID IMDb identifier (may be empty)
+     * @param url Poster URL; empty or "N/A" means the poster can only come from a cache tier
+     * @return Poster, or nullptr if there is none
+     */
+    PosterPtr get(const std::string& imdbID, const std::string& url);
+
+    /**
+     * @brief Look a poster up without blocking.
+     *
+     * Memory hits complete at once. Database reads and decoding run on the
+     * shared thread pool, downloads on the HTTP client's event loop; the
+     * future completes on one of those threads.
+     *
+     * @param imdbID IMDb identifier (may be empty)
+     * @param url Poster URL
+     * @param cancel Token; cancelling it completes the future as cancelled
+     * @return Future poster (nullptr if there is none)
+     */
+    Future<PosterPtr> getAsync(const std::string& imdbID, const std::string& url, CancelToken cancel = {});
+
+    /**
+     * @brief Look many posters up at once, downloading the misses concurrently (blocking).
+     *
+     * Memory hits are taken first, then every remaining poster is read from the
+     * database in one pass (and decoded on the shared thread pool), then the
+     * misses are downloaded with at most
+     * PosterCacheOptions::maxDownloads in flight. A cold batch therefore costs
+     * about one round-trip per maxDownloads posters. Posters already loading
+     * elsewhere are waited for, not downloaded twice.
+     *
+     * Called from a sharedThreadPool() worker, it does not wait on tasks
+     * queued behind it there: posters are decoded and downloaded on the
+     * calling thread, one at a time. Prefer calling it from elsewhere.
+     *
+     * @param requests Posters wanted
+     * @return One poster per request, in order (nullptr where there is none)
+     */
+    std::vector<PosterPtr> getAll(const std::vector<PosterRequest>& requests);
+
+    /**
+     * @brief The poster scaled for a box: the nearest stored thumbnail at least as large (blocking).
+     *
+     * Picks the smallest of kPosterThumbnailSizes that covers the poster fitted
+     * to the box (see thumbnailSizeFor()) and returns that thumbnail from
+     * memory or the database. If it doesn't exist yet it is made from the
+     * poster (loaded like get()) and stored. When no standard size fits
+     * between the box and the poster, the full poster is returned. The
+     * result may still be slightly larger than the box; it is never smaller
+     * than the poster fitted to it.
+     *
+     * @param imdbID IMDb identifier (may be empty)
+     * @param url Poster URL
+     * @param boxWidth Width available, in device pixels
+     * @param boxHeight Height available, in device pixels
+     * @return Decoded, premultiplied pixels, or nullptr if there is no poster or it can't be decoded
+     */
+    std::shared_ptr<const PosterBitmap> thumbnail(const std::string& imdbID, const std::string& url, int boxWidth,
+                                                  int boxHeight);
+
+    /**
+     * @brief thumbnail(), but only if it is already made: never downloads, decodes or scales.
+     * @param imdbID IMDb identifier (may be empty)
+     * @param url Poster URL
+     * @param boxWidth Width available, in device pixels
+     * @param boxHeight Height available, in device pixels
+     * @return Thumbnail from memory or the database (or the full poster when that is what the box needs and it is in memory), else nullptr
+     */
+    std::shared_ptr<const PosterBitmap> storedThumbnail(const std::string& imdbID, const std::string& url,
+                                                        int boxWidth, int boxHeight);
+
+    /**
+     * @brief thumbnail() without blocking.
+     *
+     * Memory hits complete at once. Database reads and scaling run on the
+     * shared thread pool, a missing poster is loaded like getAsync().
+     *
+     * @param imdbID IMDb identifier (may be empty)
+     * @param url Poster URL
+     * @param boxWidth Width available, in device pixels
+     * @param boxHeight Height available, in device pixels
+     * @param cancel Token; cancelling it completes the future as cancelled
+     * @return Future bitmap (nullptr if there is none)
+     */
+    Future<std::shared_ptr<const PosterBitmap>> thumbnailAsync(const std::string& imdbID, const std::string& url,
+                                                               int boxWidth, int boxHeight, CancelToken cancel = {});
+
+    /**
+     * @brief Thumbnail size serving a poster shown in a box.
+     * @param width Poster width
+     * @param height Poster height
+     * @param boxWidth Box width
+     * @param boxHeight Box height
+     * @return Smallest of kPosterThumbnailSizes not below the longest edge of the
+     *         poster fitted to the box, or 0 if the full poster is needed
+     *         (no such size, or it wouldn't be smaller than the poster)
+     */
+    static int thumbnailSizeFor(int width, int height, int boxWidth, int boxHeight);
+
+    /**
+     * @brief Memory tier only: never blocks.
+     * @param imdbID IMDb identifier (may be empty)
+     * @param url Poster URL
+     * @return Poster if it is in memory, else nullptr
+     */
+    PosterPtr peek(const std::string& imdbID, const std::string& url);
+
+    /**
+     * @brief Store poster bytes obtained elsewhere in every tier.
+     * @param imdbID IMDb identifier (may be empty)
+     * @param url URL the bytes came from
+     * @param bytes Encoded image
+     * @return The cached poster, or nullptr if there is no key or no bytes
+     */
+    PosterPtr put(const std::string& imdbID, const std::string& url, const std::string& bytes);
+
+    /** @brief Drop every poster from memory (the database tier is kept). */
+    void clearMemory();
+
+    /** @return Counters and current sizes. */
+    PosterCacheStats stats() const;
+
+    /**
+     * @brief Key a poster is stored under.
+     * @param imdbID IMDb identifier (may be empty)
+     * @param url Poster URL
+     * @return imdbID if set, else the URL; empty if neither is usable
+     */
+    static std::string keyOf(const std::string& imdbID, const std::string& url);
+
+private:
+    struct Stored {
+        std::string bytes;
+        std::string mime;
+        std::string url;
+    };
+    struct Dims {
+        std::string url;
+        int width = 0;
+        int height = 0;
+    };
+    struct Slot {
+        std::string key;
+        PosterPtr poster;
+        size_t cost = 0;
+    };
+
+    static bool downloadable(const std::string& url);
+    PosterPtr lookupMemory(const std::string& key, const std::string& url, bool countHit);
+    PosterPtr remember(const std::string& key, const std::string& url, std::string bytes, std::string mime,
+                       PosterTier tier);
+    PosterPtr insertMemory(const std::string& key, PosterPtr poster);
+    PosterPtr loadStored(const std::string& key, const std::string& url);
+    PosterPtr storedPoster(const std::string& key, const std::string& url, std::optional<Stored> stored);
+    PosterPtr loadBlocking(const std::string& key, const std::string& url);
+    Future<PosterPtr> loadAsync(const std::string& key, const std::string& url, CancelToken cancel);
+    PosterPtr downloaded(const std::string& key, const std::string& url, int status, const std::string& body,
+                         const std::string& contentType);
+
+    static std::string thumbnailKey(const std::string& key, int size);
+    std::optional<Dims> knownDims(const std::string& key, const std::string& url, bool readDatabase);
+    std::shared_ptr<const PosterBitmap> cachedThumbnail(const std::string& key, const std::string& url, int boxWidth,
+                                                        int boxHeight, bool readDatabase);
+    std::shared_ptr<const PosterBitmap> makeThumbnail(const std::string& key, const PosterPtr& poster, int boxWidth,
+                                                      int boxHeight);
+
+    std::optional<Stored> readStored(const std::string& key);
+    std::vector<std::optional<Stored>> readStoredMany(const std::vector<std::string>& keys);
+    void writeStored(const std::string& key, const std::string& url, const std::string& mime, const std::string& bytes);
+    std::optional<Dims> readDims(const std::string& key);
+    void writeDims(const std::string& key, int width, int height);
+    std::shared_ptr<const PosterBitmap> readThumbnail(const std::string& key, int size);
+    void writeThumbnail(const std::string& key, int size, const PosterBitmap& bitmap);
+    int64_t nextUse();
+    void trimDatabase(const std::string& keep);
+
+    PosterCacheOptions opts_;
+    sqlite3* db_ = nullptr;
+    mutable std::mutex dbMutex_;
+    int64_t dbBytes_ = 0;                 // guarded by dbMutex_
+    int64_t lastUse_ = 0;                 // guarded by dbMutex_
+
+    mutable std::mutex mutex_;
+    std::list<Slot> lru_;                 // most recently used first
+    std::unordered_map<std::string, std::list<Slot>::iterator> memory_;
+    size_t memoryBytes_ = 0;
+    std::unordered_map<std::string, Dims> dims_;   // full poster sizes seen, by key
+    PosterCacheStats stats_;
+    SingleFlight<std::string, PosterPtr> flights_;
+};
+
+/**
+ * @brief Open a poster cache for @p cfg's database using the posterCache* settings.
+ * @param cfg Application configuration
+ * @return Cache (memory only if the database can't be opened)
+ * @ingroup services
+ */
+std::shared_ptr<PosterCache> openPosterCache(const AppConfig& cfg);
+
+/**
+ * @brief Install the process-wide poster cache.
+ * @param cache Cache (see openPosterCache()), or nullptr for a memory-only default
+ * @ingroup services
+ */
+void setPosterCache(std::shared_ptr<PosterCache> cache);
+
+/**
+ * @brief The process-wide poster cache used by the front ends, posting and image export.
+ * @return Installed cache, or a memory-only one if none was installed
+ * @ingroup services
+ */
+std::shared_ptr<PosterCache> posterCache();
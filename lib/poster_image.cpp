@@ -0,0 +1,455 @@
+// SPDX-License-Identifier: Apache-2.0
+//-------------------------------------------------------------------------------
+// Top100 — Your Personal Movie List
+//
+// File: lib/poster_image.cpp
+// Purpose: Decoded poster pixels and the decoders that produce them.
+// Language: C++17 (CMake build)
+//-------------------------------------------------------------------------------
+#include "poster_image.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#if TOP100_HAVE_CAIRO
+#include <cairo/cairo.h>
+#endif
+#if TOP100_HAVE_JPEG
+#include <csetjmp>
+#include <cstdio>
+#include <cstdlib>
+extern "C" {
+#include <jpeglib.h>
+}
+// Vector kernels assume 0xAARRGGBB is B, G, R, A in memory
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#define TOP100_RGB_NEON 1
+#elif (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define TOP100_RGB_SSSE3 1
+#endif
+#endif
+#endif
+
+static bool startsWith(const std::string& bytes, const char* magic, size_t n, size_t at = 0) {
+    return bytes.size() >= at + n && std::memcmp(bytes.data() + at, magic, n) == 0;
+}
+
+std::string posterMimeOf(const std::string& bytes) {
+    if (startsWith(bytes, "\x89PNG\r\n\x1a\n", 8)) return "image/png";
+    if (startsWith(bytes, "\xff\xd8\xff", 3)) return "image/jpeg";
+    if (startsWith(bytes, "GIF8", 4)) return "image/gif";
+    if (startsWith(bytes, "BM", 2) && bytes.size() >= 26) return "image/bmp";
+    if (startsWith(bytes, "RIFF", 4) && startsWith(bytes, "WEBP", 4, 8)) return "image/webp";
+    return "application/octet-stream";
+}
+
+#if TOP100_HAVE_CAIRO
+// PNG through Cairo's stream reader, copied out of the surface
+static std::shared_ptr<const PosterBitmap> decodePng(const std::string& bytes) {
+    struct ReadCtx { const unsigned char* p; size_t n; size_t off; } ctx{
+        reinterpret_cast<const unsigned char*>(bytes.data()), bytes.size(), 0};
+    auto read_cb = [](void* closure, unsigned char* data, unsigned int length) -> cairo_status_t {
+        ReadCtx* c = static_cast<ReadCtx*>(closure);
+        if (c->off + length > c->n) return CAIRO_STATUS_READ_ERROR;
+        memcpy(data, c->p + c->off, length);
+        c->off += length;
+        return CAIRO_STATUS_SUCCESS;
+    };
+    cairo_surface_t* s = cairo_image_surface_create_from_png_stream(read_cb, &ctx);
+    std::shared_ptr<PosterBitmap> out;
+    if (cairo_surface_status(s) == CAIRO_STATUS_SUCCESS) {
+        cairo_surface_flush(s);
+        const cairo_format_t format = cairo_image_surface_get_format(s);
+        if (format == CAIRO_FORMAT_ARGB32 || format == CAIRO_FORMAT_RGB24) {
+            out = std::make_shared<PosterBitmap>();
+            out->width = cairo_image_surface_get_width(s);
+            out->height = cairo_image_surface_get_height(s);
+            out->pixels.resize(static_cast<size_t>(out->width) * static_cast<size_t>(out->height));
+            const unsigned char* src = cairo_image_surface_get_data(s);
+            const int stride = cairo_image_surface_get_stride(s);
+            // RGB24 leaves the alpha byte undefined
+            const uint32_t opaque = format == CAIRO_FORMAT_RGB24 ? 0xFF000000u : 0u;
+            for (int y = 0; y < out->height; ++y) {
+                const uint32_t* row = reinterpret_cast<const uint32_t*>(src + static_cast<size_t>(y) * stride);
+                uint32_t* dst = out->pixels.data() + static_cast<size_t>(y) * out->width;
+                for (int x = 0; x < out->width; ++x) dst[x] = row[x] | opaque;
+            }
+        }
+    }
+    cairo_surface_destroy(s);
+    return out;
+}
+#endif
+
+#if TOP100_HAVE_JPEG
+// libjpeg reports fatal errors through error_exit, which must not return
+struct JpegError {
+    jpeg_error_mgr mgr;
+    std::jmp_buf jump;
+};
+
+static void jpegErrorExit(j_common_ptr cinfo) {
+    std::longjmp(reinterpret_cast<JpegError*>(cinfo->err)->jump, 1);
+}
+
+static void jpegSilent(j_common_ptr) {}
+
+// Packed RGB to opaque ARGB32 (premultiplication is a no-op at full alpha),
+// used when libjpeg can't write ARGB itself. GCC only auto-vectorises the
+// stride-3 loads with AVX2, so the common baselines get explicit kernels.
+static void rgbToArgbScalar(const unsigned char* src, uint32_t* dst, size_t n) {
+    for (size_t x = 0; x < n; ++x, src += 3)
+        dst[x] = 0xFF000000u | (uint32_t(src[0]) << 16) | (uint32_t(src[1]) << 8) | uint32_t(src[2]);
+}
+
+#if TOP100_RGB_SSSE3
+// 4 pixels per shuffle; each load reads 16 bytes for 12, so the tail goes scalar
+__attribute__((target("ssse3"))) static void rgbToArgbSsse3(const unsigned char* src, uint32_t* dst, size_t n) {
+    const __m128i order = _mm_setr_epi8(2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1);
+    const __m128i alpha = _mm_set1_epi32(static_cast<int>(0xFF000000u));
+    size_t x = 0;
+    for (; x + 6 <= n; x += 4, src += 12) {
+        const __m128i rgb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x), _mm_or_si128(_mm_shuffle_epi8(rgb, order), alpha));
+    }
+    rgbToArgbScalar(src, dst + x, n - x);
+}
+#endif
+
+static void rgbToArgb(const unsigned char* src, uint32_t* dst, size_t n) {
+#if TOP100_RGB_NEON
+    // vld3 de-interleaves R, G, B; vst4 writes B, G, R, A (0xAARRGGBB little-endian)
+    size_t x = 0;
+    for (; x + 16 <= n; x += 16, src += 48) {
+        const uint8x16x3_t rgb = vld3q_u8(src);
+        uint8x16x4_t bgra;
+        bgra.val[0] = rgb.val[2];
+        bgra.val[1] = rgb.val[1];
+        bgra.val[2] = rgb.val[0];
+        bgra.val[3] = vdupq_n_u8(0xFF);
+        vst4q_u8(reinterpret_cast<uint8_t*>(dst + x), bgra);
+    }
+    rgbToArgbScalar(src, dst + x, n - x);
+#elif TOP100_RGB_SSSE3
+    static const bool ssse3 = __builtin_cpu_supports("ssse3");
+    if (ssse3) rgbToArgbSsse3(src, dst, n);
+    else rgbToArgbScalar(src, dst, n);
+#else
+    rgbToArgbScalar(src, dst, n);
+#endif
+}
+
+// Smallest DCT scaling that still yields at least the size the poster will be
+// shown at, so the resampler only ever shrinks. libjpeg 6b can only do 1/8,
+// 1/4 and 1/2; version 7+ and libjpeg-turbo can do any M/8.
+static void chooseJpegScale(jpeg_decompress_struct& cinfo, int fitWidth, int fitHeight) {
+    if (fitWidth <= 0 || fitHeight <= 0) return;
+    const double w = cinfo.image_width, h = cinfo.image_height;
+    const double fit = std::min(fitWidth / w, fitHeight / h);
+    if (fit >= 1.0) return;
+    const long needW = std::lround(w * fit), needH = std::lround(h * fit);
+#if JPEG_LIB_VERSION >= 70 || defined(JCS_EXTENSIONS)
+    const unsigned nums[] = {1, 2, 3, 4, 5, 6, 7};
+#else
+    const unsigned nums[] = {1, 2, 4};
+#endif
+    for (unsigned num : nums) {
+        cinfo.scale_num = num;
+        cinfo.scale_denom = 8;
+        jpeg_calc_output_dimensions(&cinfo);
+        if (static_cast<long>(cinfo.output_width) >= needW && static_cast<long>(cinfo.output_height) >= needH) return;
+    }
+    cinfo.scale_num = 1;
+    cinfo.scale_denom = 1;
+}
+
+static std::shared_ptr<const PosterBitmap> decodeJpeg(const std::string& bytes, int fitWidth, int fitHeight) {
+    jpeg_decompress_struct cinfo;
+    JpegError err;
+    cinfo.err = jpeg_std_error(&err.mgr);
+    err.mgr.error_exit = jpegErrorExit;
+    err.mgr.output_message = jpegSilent;
+    // Allocated before setjmp so a longjmp cannot skip its destructor
+    auto out = std::make_shared<PosterBitmap>();
+    std::vector<unsigned char> rgb;
+    std::vector<JSAMPROW> rows;
+    if (setjmp(err.jump)) {
+        jpeg_destroy_decompress(&cinfo);
+        return nullptr;
+    }
+    jpeg_create_decompress(&cinfo);
+    jpeg_mem_src(&cinfo, reinterpret_cast<const unsigned char*>(bytes.data()), static_cast<unsigned long>(bytes.size()));
+    if (jpeg_read_header(&cinfo, TRUE) != JPEG_HEADER_OK) {
+        jpeg_destroy_decompress(&cinfo);
+        return nullptr;
+    }
+    chooseJpegScale(cinfo, fitWidth, fitHeight);
+    bool direct = false;
+#ifdef JCS_EXTENSIONS
+    // libjpeg-turbo writes 0xAARRGGBB words itself: B,G,R,A in memory on
+    // little-endian hosts, A,R,G,B on big-endian ones
+    if (cinfo.jpeg_color_space == JCS_YCbCr || cinfo.jpeg_color_space == JCS_RGB ||
+        cinfo.jpeg_color_space == JCS_GRAYSCALE) {
+        const uint32_t probe = 1;
+        const bool little = *reinterpret_cast<const unsigned char*>(&probe) == 1;
+        cinfo.out_color_space = little ? JCS_EXT_BGRA : JCS_EXT_ARGB;
+        direct = true;
+    }
+#endif
+    if (!direct) cinfo.out_color_space = JCS_RGB;
+    jpeg_start_decompress(&cinfo);
+    out->width = static_cast<int>(cinfo.output_width);
+    out->height = static_cast<int>(cinfo.output_height);
+    out->pixels.resize(static_cast<size_t>(out->width) * static_cast<size_t>(out->height));
+    // As many scanlines per call as the decoder produces at once
+    const size_t batch = std::max(1, cinfo.rec_outbuf_height);
+    rows.resize(batch);
+    if (!direct) {
+        rgb.resize(static_cast<size_t>(out->width) * 3 * batch);
+        for (size_t i = 0; i < batch; ++i) rows[i] = rgb.data() + i * static_cast<size_t>(out->width) * 3;
+    }
+    while (cinfo.output_scanline < cinfo.output_height) {
+        const size_t y = cinfo.output_scanline;
+        uint32_t* dst = out->pixels.data() + y * static_cast<size_t>(out->width);
+        if (direct) {
+            const size_t last = static_cast<size_t>(out->height) - 1 - y;
+            for (size_t i = 0; i < batch; ++i)
+                rows[i] = reinterpret_cast<JSAMPROW>(dst + std::min(i, last) * static_cast<size_t>(out->width));
+        }
+        const JDIMENSION got = jpeg_read_scanlines(&cinfo, rows.data(), static_cast<JDIMENSION>(batch));
+        if (!direct) {
+            for (JDIMENSION i = 0; i < got; ++i)
+                rgbToArgb(rows[i], dst + static_cast<size_t>(i) * out->width, static_cast<size_t>(out->width));
+        }
+    }
+    jpeg_finish_decompress(&cinfo);
+    jpeg_destroy_decompress(&cinfo);
+    return out;
+}
+#endif
+
+namespace {
+
+#if TOP100_HAVE_JPEG
+class LibjpegDecoder : public PosterDecoder {
+public:
+    std::string name() const override { return "libjpeg"; }
+    bool decodes(const std::string& mime) const override { return mime == "image/jpeg"; }
+    std::shared_ptr<const PosterBitmap> decode(const std::string& bytes, int fitWidth, int fitHeight) const override {
+        return decodeJpeg(bytes, fitWidth, fitHeight);
+    }
+};
+#endif
+
+#if TOP100_HAVE_CAIRO
+class CairoDecoder : public PosterDecoder {
+public:
+    std::string name() const override { return "cairo"; }
+    bool decodes(const std::string& mime) const override { return mime == "image/png"; }
+    std::shared_ptr<const PosterBitmap> decode(const std::string& bytes, int, int) const override {
+        return decodePng(bytes);
+    }
+};
+#endif
+
+// Backends in preference order, created once
+const std::vector<std::unique_ptr<PosterDecoder>>& decoders() {
+    static const std::vector<std::unique_ptr<PosterDecoder>> all = [] {
+        std::vector<std::unique_ptr<PosterDecoder>> out;
+        for (const std::string& name : posterDecoderNames()) out.push_back(makePosterDecoder(name));
+        return out;
+    }();
+    return all;
+}
+
+} // namespace
+
+#if TOP100_HAVE_STB_IMAGE
+// lib/poster_image_stb.cpp
+std::unique_ptr<PosterDecoder> makeStbPosterDecoder();
+#endif
+
+std::unique_ptr<PosterDecoder> makePosterDecoder(const std::string& name) {
+#if TOP100_HAVE_JPEG
+    if (name == "libjpeg") return std::make_unique<LibjpegDecoder>();
+#endif
+#if TOP100_HAVE_CAIRO
+    if (name == "cairo") return std::make_unique<CairoDecoder>();
+#endif
+#if TOP100_HAVE_STB_IMAGE
+    if (name == "stb_image") return makeStbPosterDecoder();
+#endif
+    (void)name;
+    return nullptr;
+}
+
+std::vector<std::string> posterDecoderNames() {
+    std::vector<std::string> out;
+#if TOP100_HAVE_JPEG
+    out.push_back("libjpeg");
+#endif
+#if TOP100_HAVE_CAIRO
+    out.push_back("cairo");
+#endif
+#if TOP100_HAVE_STB_IMAGE
+    out.push_back("stb_image");
+#endif
+    return out;
+}
+
+std::shared_ptr<const PosterBitmap> decodePosterImage(const std::string& bytes, int fitWidth, int fitHeight) {
+    const std::string mime = posterMimeOf(bytes);
+    for (const auto& decoder : decoders()) {
+        if (!decoder->decodes(mime)) continue;
+        // A backend that rejects the image (e.g. Cairo and a 16-bit PNG) leaves it to the next
+        if (auto bitmap = decoder->decode(bytes, fitWidth, fitHeight)) return bitmap;
+    }
+    return nullptr;
+}
+
+std::string encodePosterJpeg(const PosterBitmap& bitmap, int quality) {
+#if TOP100_HAVE_JPEG
+    if (bitmap.width <= 0 || bitmap.height <= 0 ||
+        bitmap.pixels.size() != static_cast<size_t>(bitmap.width) * static_cast<size_t>(bitmap.height))
+        return std::string();
+    // JPEG has no alpha: only opaque bitmaps survive the round trip
+    for (uint32_t p : bitmap.pixels) {
+        if ((p >> 24) != 0xFF) return std::string();
+    }
+    jpeg_compress_struct cinfo;
+    JpegError err;
+    cinfo.err = jpeg_std_error(&err.mgr);
+    err.mgr.error_exit = jpegErrorExit;
+    err.mgr.output_message = jpegSilent;
+    unsigned char* buffer = nullptr;
+    unsigned long size = 0;
+    std::vector<unsigned char> row(static_cast<size_t>(bitmap.width) * 3);
+    if (setjmp(err.jump)) {
+        jpeg_destroy_compress(&cinfo);
+        std::free(buffer);
+        return std::string();
+    }
+    jpeg_create_compress(&cinfo);
+    jpeg_mem_dest(&cinfo, &buffer, &size);
+    cinfo.image_width = static_cast<JDIMENSION>(bitmap.width);
+    cinfo.image_height = static_cast<JDIMENSION>(bitmap.height);
+    cinfo.input_components = 3;
+    cinfo.in_color_space = JCS_RGB;
+    jpeg_set_defaults(&cinfo);
+    jpeg_set_quality(&cinfo, std::clamp(quality, 1, 100), TRUE);
+    jpeg_start_compress(&cinfo, TRUE);
+    while (cinfo.next_scanline < cinfo.image_height) {
+        const uint32_t* src = bitmap.pixels.data() + static_cast<size_t>(cinfo.next_scanline) * bitmap.width;
+        for (int x = 0; x < bitmap.width; ++x) {
+            row[static_cast<size_t>(x) * 3] = static_cast<unsigned char>(src[x] >> 16);
+            row[static_cast<size_t>(x) * 3 + 1] = static_cast<unsigned char>(src[x] >> 8);
+            row[static_cast<size_t>(x) * 3 + 2] = static_cast<unsigned char>(src[x]);
+        }
+        JSAMPROW rows[1] = {row.data()};
+        jpeg_write_scanlines(&cinfo, rows, 1);
+    }
+    jpeg_finish_compress(&cinfo);
+    jpeg_destroy_compress(&cinfo);
+    std::string out(reinterpret_cast<const char*>(buffer), size);
+    std::free(buffer);
+    return out;
+#else
+    (void)bitmap;
+    (void)quality;
+    return std::string();
+#endif
+}
+
+namespace {
+
+// Source pixels feeding one target pixel along an axis, and their weights (summing to 1)
+struct Taps {
+    int first = 0;
+    std::vector<float> weights;
+};
+
+std::vector<Taps> resampleTaps(int srcSize, int dstSize) {
+    std::vector<Taps> out(static_cast<size_t>(dstSize));
+    const double scale = static_cast<double>(srcSize) / dstSize;   // source pixels per target pixel
+    for (int d = 0; d < dstSize; ++d) {
+        Taps& t = out[static_cast<size_t>(d)];
+        if (scale > 1.0) {
+            // Area: the overlap of [d, d + 1) mapped into the source with each source pixel
+            const double lo = d * scale, hi = std::min<double>(srcSize, (d + 1) * scale);
+            t.first = static_cast<int>(lo);
+            for (int s = t.first; s < srcSize && s < hi; ++s) {
+                const double cover = std::min<double>(s + 1, hi) - std::max<double>(s, lo);
+                t.weights.push_back(static_cast<float>(cover / scale));
+            }
+        } else {
+            // Linear between the two nearest source centres
+            const double c = std::clamp((d + 0.5) * scale - 0.5, 0.0, srcSize - 1.0);
+            t.first = std::min(static_cast<int>(c), std::max(0, srcSize - 2));
+            const float f = static_cast<float>(c - t.first);
+            t.weights.push_back(1.0f - f);
+            if (srcSize > 1) t.weights.push_back(f);
+        }
+    }
+    return out;
+}
+
+} // namespace
+
+std::shared_ptr<const PosterBitmap> scalePosterBitmap(const PosterBitmap& src, int maxWidth, int maxHeight) {
+    if (src.width <= 0 || src.height <= 0 || src.pixels.size() < static_cast<size_t>(src.width) * src.height)
+        return nullptr;
+    const double scale = std::min(static_cast<double>(std::max(1, maxWidth)) / src.width,
+                                  static_cast<double>(std::max(1, maxHeight)) / src.height);
+    auto out = std::make_shared<PosterBitmap>();
+    out->width = std::clamp(static_cast<int>(std::lround(src.width * scale)), 1, std::max(1, maxWidth));
+    out->height = std::clamp(static_cast<int>(std::lround(src.height * scale)), 1, std::max(1, maxHeight));
+    out->pixels.resize(static_cast<size_t>(out->width) * out->height);
+    if (out->width == src.width && out->height == src.height) {
+        out->pixels = src.pixels;
+        return out;
+    }
+
+    // Separable: rows first into a float buffer (4 channels), then columns
+    const std::vector<Taps> tx = resampleTaps(src.width, out->width);
+    const std::vector<Taps> ty = resampleTaps(src.height, out->height);
+    std::vector<float> rows(static_cast<size_t>(out->width) * src.height * 4);
+    for (int y = 0; y < src.height; ++y) {
+        const uint32_t* in = src.pixels.data() + static_cast<size_t>(y) * src.width;
+        float* dst = rows.data() + static_cast<size_t>(y) * out->width * 4;
+        for (int x = 0; x < out->width; ++x, dst += 4) {
+            const Taps& t = tx[static_cast<size_t>(x)];
+            float a = 0, r = 0, g = 0, b = 0;
+            for (size_t k = 0; k < t.weights.size(); ++k) {
+                const uint32_t p = in[t.first + static_cast<int>(k)];
+                const float w = t.weights[k];
+                a += w * (p >> 24);
+                r += w * ((p >> 16) & 0xFF);
+                g += w * ((p >> 8) & 0xFF);
+                b += w * (p & 0xFF);
+            }
+            dst[0] = a; dst[1] = r; dst[2] = g; dst[3] = b;
+        }
+    }
+    auto channel = [](float v) { return static_cast<uint32_t>(std::clamp(v + 0.5f, 0.0f, 255.0f)); };
+    std::vector<float> acc(static_cast<size_t>(out->width) * 4);
+    for (int y = 0; y < out->height; ++y) {
+        const Taps& t = ty[static_cast<size_t>(y)];
+        std::fill(acc.begin(), acc.end(), 0.0f);
+        for (size_t k = 0; k < t.weights.size(); ++k) {
+            const float* in = rows.data() + static_cast<size_t>(t.first + static_cast<int>(k)) * out->width * 4;
+            const float w = t.weights[k];
+            for (size_t i = 0; i < acc.size(); ++i) acc[i] += w * in[i];
+        }
+        uint32_t* dst = out->pixels.data() + static_cast<size_t>(y) * out->width;
+        for (int x = 0; x < out->width; ++x) {
+            const float* c = acc.data() + static_cast<size_t>(x) * 4;
+            const uint32_t a = channel(c[0]);
+            // Rounding must not leave a colour channel above alpha (invalid premultiplied)
+            dst[x] = (a << 24) | (std::min(a, channel(c[1])) << 16) | (std::min(a, channel(c[2])) << 8) |
+                     std::min(a, channel(c[3]));
+        }
+    }
+    return out;
+}
@@ -0,0 +1,139 @@
+// SPDX-License-Identifier: Apache-2.0
+//-------------------------------------------------------------------------------
+// Top100 — Your Personal Movie List
+//
+// File: lib/poster_image.h
+// Purpose: Decoded poster pixels and the decoders that produce them.
+// Language: C++17 (header)
+//-------------------------------------------------------------------------------
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @brief A decoded poster.
+ *
+ * Pixels are premultiplied ARGB32 in native byte order, row-major with no row
+ * padding: the layout of Cairo's CAIRO_FORMAT_ARGB32, Qt's
+ * QImage::Format_ARGB32_Premultiplied and Haiku's B_RGBA32, so front ends can
+ * wrap them without converting.
+ *
+ * @ingroup services
+ */
+struct PosterBitmap {
+    /** Width in pixels */
+    int width = 0;
+    /** Height in pixels */
+    int height = 0;
+    /** width * height pixels, 0xAARRGGBB */
+    std::vector<uint32_t> pixels;
+
+    /** @return Bytes held by the pixels. */
+    size_t byteSize() const { return pixels.size() * sizeof(uint32_t); }
+};
+
+/**
+ * @brief One image decoding backend.
+ *
+ * Backends are compiled in when their library is: "libjpeg" (JPEG,
+ * TOP100_HAVE_JPEG), "cairo" (PNG, TOP100_HAVE_CAIRO) and "stb_image"
+ * (JPEG, PNG, GIF and BMP, TOP100_HAVE_STB_IMAGE, no external dependency;
+ * off unless the build enables TOP100_STB_IMAGE).
+ * Every backend is thread-safe.
+ *
+ * @ingroup services
+ */
+class PosterDecoder {
+public:
+    virtual ~PosterDecoder() = default;
+
+    /** @return Backend name, as accepted by makePosterDecoder(). */
+    virtual std::string name() const = 0;
+
+    /**
+     * @brief Whether this backend decodes a format.
+     * @param mime MIME type from posterMimeOf()
+     * @return true if decode() handles it
+     */
+    virtual bool decodes(const std::string& mime) const = 0;
+
+    /**
+     * @brief Decode encoded bytes.
+     * @param bytes Encoded image
+     * @param fitWidth Box the image will be fitted to (0 = full size); backends may ignore it
+     * @param fitHeight Height of that box
+     * @return Bitmap, or nullptr if the image is corrupt or not a format this backend decodes
+     */
+    virtual std::shared_ptr<const PosterBitmap> decode(const std::string& bytes, int fitWidth,
+                                                       int fitHeight) const = 0;
+};
+
+/**
+ * @brief Create a decoding backend by name.
+ * @param name One of posterDecoderNames()
+ * @return Backend, or nullptr if it is unknown or not compiled in
+ * @ingroup services
+ */
+std::unique_ptr<PosterDecoder> makePosterDecoder(const std::string& name);
+
+/** @return Backends compiled in, in the order decodePosterImage() tries them. @ingroup services */
+std::vector<std::string> posterDecoderNames();
+
+/**
+ * @brief Decode PNG, JPEG, GIF or BMP poster bytes.
+ *
+ * The format is sniffed from the leading bytes, then the backends of
+ * posterDecoderNames() that handle it are tried in order (libjpeg and Cairo
+ * before the bundled stb_image), so a build without either library still
+ * decodes every poster when stb_image is enabled.
+ *
+ * When the poster is only going to be shown inside a box, pass that box:
+ * with libjpeg, JPEGs are then decoded at the smallest DCT scale (1/8, 2/8,
+ * ...) that is still at least as large as the poster fitted to the box,
+ * which skips most of the decoding work. Follow with scalePosterBitmap() for
+ * the exact size.
+ *
+ * @param bytes Encoded image
+ * @param fitWidth Width of the box the poster will be fitted to; 0 = full size
+ * @param fitHeight Height of that box; 0 = full size
+ * @return Bitmap, or nullptr if the format is unknown, unsupported in this build or corrupt
+ * @ingroup services
+ */
+std::shared_ptr<const PosterBitmap> decodePosterImage(const std::string& bytes, int fitWidth = 0, int fitHeight = 0);
+
+/**
+ * @brief Encode an opaque bitmap as a baseline JPEG (libjpeg, TOP100_HAVE_JPEG).
+ * @param bitmap Pixels to encode; every alpha byte must be 0xFF
+ * @param quality libjpeg quality, 1 to 100
+ * @return JPEG bytes, or empty if the bitmap has transparency, is empty, or the build has no libjpeg
+ * @ingroup services
+ */
+std::string encodePosterJpeg(const PosterBitmap& bitmap, int quality = 85);
+
+/**
+ * @brief Resample a poster to fit a box, keeping its aspect ratio.
+ *
+ * Shrinking averages every source pixel a target pixel covers (area
+ * filter), so fine detail doesn't alias the way a single bilinear tap
+ * does; enlarging interpolates linearly. Works on the premultiplied
+ * channels, which is what keeps edges against transparency clean.
+ *
+ * @param src Decoded poster
+ * @param maxWidth Box width in pixels (> 0)
+ * @param maxHeight Box height in pixels (> 0)
+ * @return Bitmap at most maxWidth x maxHeight (at least 1x1), or nullptr if @p src is empty
+ * @ingroup services
+ */
+std::shared_ptr<const PosterBitmap> scalePosterBitmap(const PosterBitmap& src, int maxWidth, int maxHeight);
+
+/**
+ * @brief MIME type of encoded image bytes, from their signature.
+ * @param bytes Encoded image
+ * @return "image/png", "image/jpeg", "image/gif", "image/bmp", "image/webp" or "application/octet-stream"
+ * @ingroup services
+ */
+std::string posterMimeOf(const std::string& bytes);
@@ -0,0 +1,62 @@
+// SPDX-License-Identifier: Apache-2.0
+//-------------------------------------------------------------------------------
+// Top100 — Your Personal Movie List
+//
+// File: lib/poster_image_stb.cpp
+// Purpose: Dependency-free poster decoding backend on the bundled stb_image.
+// Language: C++17 (CMake build)
+//-------------------------------------------------------------------------------
+#include "poster_image.h"
+
+// Built unless TOP100_STB_IMAGE=OFF (see CMakeLists.txt)
+#define STB_IMAGE_IMPLEMENTATION
+#define STB_IMAGE_STATIC
+#define STBI_NO_STDIO
+#define STBI_ONLY_JPEG
+#define STBI_ONLY_PNG
+#define STBI_ONLY_GIF
+#define STBI_ONLY_BMP
+#include "stb_image.h"
+
+namespace {
+
+class StbDecoder : public PosterDecoder {
+public:
+    std::string name() const override { return "stb_image"; }
+
+    bool decodes(const std::string& mime) const override {
+        return mime == "image/jpeg" || mime == "image/png" || mime == "image/gif" || mime == "image/bmp";
+    }
+
+    std::shared_ptr<const PosterBitmap> decode(const std::string& bytes, int, int) const override {
+        int w = 0, h = 0, channels = 0;
+        // RGBA bytes, straight alpha; GIFs give their first frame
+        unsigned char* rgba = stbi_load_from_memory(reinterpret_cast<const unsigned char*>(bytes.data()),
+                                                    static_cast<int>(bytes.size()), &w, &h, &channels, 4);
+        if (!rgba) return nullptr;
+        auto out = std::make_shared<PosterBitmap>();
+        out->width = w;
+        out->height = h;
+        out->pixels.resize(static_cast<size_t>(w) * static_cast<size_t>(h));
+        const unsigned char* src = rgba;
+        for (uint32_t& dst : out->pixels) {
+            const uint32_t a = src[3];
+            uint32_t r = src[0], g = src[1], b = src[2];
+            if (a != 255) {
+                r = (r * a + 127) / 255;
+                g = (g * a + 127) / 255;
+                b = (b * a + 127) / 255;
+            }
+            dst = (a << 24) | (r << 16) | (g << 8) | b;
+            src += 4;
+        }
+        stbi_image_free(rgba);
+        return out;
+    }
+};
+
+} // namespace
+
+std::unique_ptr<PosterDecoder> makeStbPosterDecoder() {
+    return std::make_unique<StbDecoder>();
+}
@@ -18,7 +18,7 @@
 #include "bluesky.h"
 #include "mastodon.h"
 #include <sstream>
-#include <cpr/cpr.h>
+#include "poster_cache.h"
 
 static size_t utf8_length(const std::string& s) {
     size_t count = 0;
@@ -118,44 +118,105 @@ std::string composePostBody(const AppConfig& cfg, const Movie& m, size_t limit)
     return finalBody;
 }
 
+// Poster bytes ready for upload
+struct PosterImage {
+    std::vector<unsigned char> bytes;
+    std::string contentType;
+};
+
+static bool hasPoster(const Movie& m) {
+    return !m.posterUrl.empty() && m.posterUrl != "N/A";
+}
+
+static std::optional<PosterImage> posterImageOf(const PosterPtr& poster) {
+    if (!poster || poster->bytes.empty()) return std::nullopt;
+    PosterImage out;
+    out.contentType = poster->mime.compare(0, 6, "image/") == 0 ? poster->mime : std::string("image/jpeg");
+    out.bytes.assign(poster->bytes.begin(), poster->bytes.end());
+    return out;
+}
+
+static std::string posterFilename(const std::string& contentType) {
+    std::string filename = "poster";
+    if (contentType.find("png") != std::string::npos) filename += ".png"; else filename += ".jpg";
+    return filename;
+}
+
+static Future<std::optional<PosterImage>> fetchPosterAsync(const Movie& m, const CancelToken& cancel) {
+    if (!hasPoster(m)) return readyFuture(std::optional<PosterImage>());
+    // Shared cache: a poster the UI already shows is not downloaded again
+    return posterCache()->getAsync(m.imdbID, m.posterUrl, cancel).then(posterImageOf);
+}
+
+static std::string blueSkyServiceOf(const AppConfig& cfg) {
+    return cfg.blueSkyService.empty() ? std::string("https://bsky.social") : cfg.blueSkyService;
+}
+
+static const size_t kBlueSkyLimit = 300;
+static const size_t kMastodonLimit = 500;
+
 bool postMovieToBlueSky(const AppConfig& cfg, const Movie& m)
 {
-    const size_t LIMIT = 300;
-    std::string service = cfg.blueSkyService.empty() ? std::string("https://bsky.social") : cfg.blueSkyService;
+    std::string service = blueSkyServiceOf(cfg);
     auto session = bskyCreateSession(service, cfg.blueSkyIdentifier, cfg.blueSkyAppPassword);
     if (!session) return false;
 
     std::optional<std::string> blob;
-    if (!m.posterUrl.empty() && m.posterUrl != "N/A") {
-        auto img = cpr::Get(cpr::Url{m.posterUrl});
-        if (img.status_code == 200 && !img.text.empty()) {
-            std::string contentType = "image/jpeg";
-            auto it = img.header.find("content-type");
-            if (it != img.header.end() && !it->second.empty()) contentType = it->second;
-            std::vector<unsigned char> bytes(img.text.begin(), img.text.end());
-            blob = bskyUploadImage(service, session->accessJwt, bytes, contentType);
+    if (hasPoster(m)) {
+        if (auto img = posterImageOf(posterCache()->get(m.imdbID, m.posterUrl))) {
+            blob = bskyUploadImage(service, session->accessJwt, img->bytes, img->contentType);
         }
     }
-    std::string body = composePostBody(cfg, m, LIMIT);
+    std::string body = composePostBody(cfg, m, kBlueSkyLimit);
     return bskyCreatePost(service, session->accessJwt, session->did, body, blob);
 }
 
+Future<bool> postMovieToBlueSkyAsync(const AppConfig& cfg, const Movie& m, CancelToken cancel)
+{
+    const std::string service = blueSkyServiceOf(cfg);
+    const std::string body = composePostBody(cfg, m, kBlueSkyLimit);
+    // Log in and download the poster at the same time
+    auto poster = fetchPosterAsync(m, cancel);
+    return bskyCreateSessionAsync(service, cfg.blueSkyIdentifier, cfg.blueSkyAppPassword, cancel)
+        .then([service, body, poster, cancel](const std::optional<BlueSkySession>& session) -> Future<bool> {
+            if (!session) return readyFuture(false);
+            const BlueSkySession s = *session;
+            return poster
+                .then([service, s, cancel](const std::optional<PosterImage>& img) -> Future<std::optional<std::string>> {
+                    if (!img) return readyFuture(std::optional<std::string>());
+                    return bskyUploadImageAsync(service, s.accessJwt, img->bytes, img->contentType, cancel);
+                })
+                .then([service, s, body, cancel](const std::optional<std::string>& blob) {
+                    return bskyCreatePostAsync(service, s.accessJwt, s.did, body, blob, cancel);
+                });
+        });
+}
+
 bool postMovieToMastodon(const AppConfig& cfg, const Movie& m)
 {
-    const size_t LIMIT = 500;
     std::optional<std::string> mediaId;
-    if (!m.posterUrl.empty() && m.posterUrl != "N/A") {
-        auto img = cpr::Get(cpr::Url{m.posterUrl});
-        if (img.status_code == 200 && !img.text.empty()) {
-            std::string contentType = "image/jpeg";
-            auto it = img.header.find("content-type");
-            if (it != img.header.end() && !it->second.empty()) contentType = it->second;
-            std::string filename = "poster";
-            if (contentType.find("png") != std::string::npos) filename += ".png"; else filename += ".jpg";
-            std::vector<unsigned char> bytes(img.text.begin(), img.text.end());
-            mediaId = mastoUploadMedia(cfg.mastodonInstance, cfg.mastodonAccessToken, bytes, filename, contentType);
+    if (hasPoster(m)) {
+        if (auto img = posterImageOf(posterCache()->get(m.imdbID, m.posterUrl))) {
+            mediaId = mastoUploadMedia(cfg.mastodonInstance, cfg.mastodonAccessToken, img->bytes,
+                                       posterFilename(img->contentType), img->contentType);
         }
     }
-    std::string body = composePostBody(cfg, m, LIMIT);
+    std::string body = composePostBody(cfg, m, kMastodonLimit);
     return mastoPostStatus(cfg.mastodonInstance, cfg.mastodonAccessToken, body, mediaId);
 }
+
+Future<bool> postMovieToMastodonAsync(const AppConfig& cfg, const Movie& m, CancelToken cancel)
+{
+    const std::string instance = cfg.mastodonInstance;
+    const std::string token = cfg.mastodonAccessToken;
+    const std::string body = composePostBody(cfg, m, kMastodonLimit);
+    return fetchPosterAsync(m, cancel)
+        .then([instance, token, cancel](const std::optional<PosterImage>& img) -> Future<std::optional<std::string>> {
+            if (!img) return readyFuture(std::optional<std::string>());
+            return mastoUploadMediaAsync(instance, token, img->bytes, posterFilename(img->contentType),
+                                         img->contentType, cancel);
+        })
+        .then([instance, token, body, cancel](const std::optional<std::string>& mediaId) {
+            return mastoPostStatusAsync(instance, token, body, mediaId, cancel);
+        });
+}
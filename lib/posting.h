@@ -13,6 +13,7 @@
 
 #include <string>
 #include <optional>
+#include "async.h"
 
 struct Movie;
 struct AppConfig;
@@ -57,3 +58,26 @@ bool postMovieToBlueSky(const AppConfig& cfg, const Movie& m);
  * \return true on successful post, false otherwise
  */
 bool postMovieToMastodon(const AppConfig& cfg, const Movie& m);
+
+/**
+ * @brief Non-blocking postMovieToBlueSky().
+ *
+ * Logs in and downloads the poster concurrently, then uploads and posts; every
+ * step runs on the shared HTTP event loop.
+ *
+ * \param cfg Application configuration (copied; need not outlive the call)
+ * \param m Movie to post
+ * \param cancel Cancels whichever step is in flight
+ * \return Future success flag (cancelled if @p cancel fires first)
+ */
+Future<bool> postMovieToBlueSkyAsync(const AppConfig& cfg, const Movie& m, CancelToken cancel = {});
+
+/**
+ * @brief Non-blocking postMovieToMastodon().
+ *
+ * \param cfg Application configuration (copied; need not outlive the call)
+ * \param m Movie to post
+ * \param cancel Cancels whichever step is in flight
+ * \return Future success flag (cancelled if @p cancel fires first)
+ */
+Future<bool> postMovieToMastodonAsync(const AppConfig& cfg, const Movie& m, CancelToken cancel = {});
@@ -0,0 +1,148 @@
+// SPDX-License-Identifier: Apache-2.0
+//-------------------------------------------------------------------------------
+// Top100 — Your Personal Movie List
+//
+// File: lib/preference_graph.cpp
+// Purpose: Incremental bitset transitive closure over pairwise preferences.
+// Language: C++17 (CMake build)
+//-------------------------------------------------------------------------------
+#include "preference_graph.h"
+#include "Movie.h"
+#include <algorithm>
+#include <bitset>
+
+std::string comparisonKey(const Movie& m) {
+    if (!m.imdbID.empty()) return m.imdbID;
+    return m.title + "|" + std::to_string(m.year);
+}
+
+int PreferenceGraph::idOf(const std::string& key) const {
+    auto it = ids_.find(key);
+    return it == ids_.end() ? -1 : it->second;
+}
+
+bool PreferenceGraph::prefers(const std::string& a, const std::string& b) const {
+    return prefersId(idOf(a), idOf(b));
+}
+
+bool PreferenceGraph::isImplied(const std::string& a, const std::string& b) const {
+    int ia = idOf(a), ib = idOf(b);
+    return prefersId(ia, ib) || prefersId(ib, ia);
+}
+
+size_t PreferenceGraph::beatsCount(int id) const {
+    if (id < 0) return 0;
+    const uint64_t* row = &closure_[static_cast<size_t>(id) * words_];
+    size_t count = 0;
+    for (size_t k = 0; k < words_; ++k) count += std::bitset<64>(row[k]).count();
+    return count;
+}
+
+void PreferenceGraph::clear() {
+    ids_.clear();
+    keys_.clear();
+    edges_.clear();
+    closure_.clear();
+    words_ = 0;
+    conflicts_ = 0;
+}
+
+void PreferenceGraph::ensureCapacity(size_t nodes) {
+    if (nodes <= words_ * 64) {
+        closure_.resize(nodes * words_, 0);
+        return;
+    }
+    size_t newWords = std::max<size_t>(1, words_);
+    while (newWords * 64 < nodes) newWords *= 2;
+    // Re-stride existing rows into the wider layout
+    std::vector<uint64_t> wider(nodes * newWords, 0);
+    const size_t rows = keys_.size();
+    for (size_t r = 0; r < rows && words_ > 0; ++r) {
+        std::copy_n(closure_.begin() + static_cast<std::ptrdiff_t>(r * words_), words_,
+                    wider.begin() + static_cast<std::ptrdiff_t>(r * newWords));
+    }
+    closure_.swap(wider);
+    words_ = newWords;
+}
+
+int PreferenceGraph::internKey(const std::string& key) {
+    auto it = ids_.find(key);
+    if (it != ids_.end()) return it->second;
+    int id = static_cast<int>(keys_.size());
+    ensureCapacity(keys_.size() + 1);
+    ids_.emplace(key, id);
+    keys_.push_back(key);
+    return id;
+}
+
+void PreferenceGraph::insertClosureEdge(int w, int l) {
+    // Everything that beats w (and w itself) now also beats l and everything below l.
+    const size_t n = keys_.size();
+    const uint64_t* lossRow = &closure_[static_cast<size_t>(l) * words_];
+    const size_t lWord = static_cast<size_t>(l) >> 6;
+    const uint64_t lBit = uint64_t{1} << (l & 63);
+    for (size_t u = 0; u < n; ++u) {
+        if (static_cast<int>(u) != w && !reaches(static_cast<int>(u), w)) continue;
+        uint64_t* row = &closure_[u * words_];
+        for (size_t k = 0; k < words_; ++k) row[k] |= lossRow[k];
+        row[lWord] |= lBit;
+    }
+}
+
+void PreferenceGraph::rebuildNewestFirst() {
+    std::fill(closure_.begin(), closure_.end(), 0);
+    conflicts_ = 0;
+    for (auto it = edges_.rbegin(); it != edges_.rend(); ++it) {
+        const int w = it->first, l = it->second;
+        if (reaches(w, l)) continue;              // already implied by newer answers
+        if (reaches(l, w)) { ++conflicts_; continue; } // contradicts newer answers; drop
+        insertClosureEdge(w, l);
+    }
+}
+
+bool PreferenceGraph::addPreference(const std::string& winner, const std::string& loser) {
+    if (winner == loser) return true;
+    const int w = internKey(winner);
+    const int l = internKey(loser);
+    edges_.emplace_back(w, l);
+    if (reaches(w, l)) return true;
+    if (reaches(l, w)) {
+        // Inconsistent answer: the newest one wins, older edges on the cycle are dropped
+        rebuildNewestFirst();
+        return false;
+    }
+    insertClosureEdge(w, l);
+    return true;
+}
+
+std::optional<std::pair<size_t, size_t>> pickComparisonPair(const std::vector<Movie>& movies,
+                                                            const PreferenceGraph& prefs,
+                                                            std::mt19937& rng) {
+    const size_t n = movies.size();
+    if (n < 2) return std::nullopt;
+    std::vector<int> ids(n);
+    for (size_t i = 0; i < n; ++i) ids[i] = prefs.idOf(comparisonKey(movies[i]));
+    auto open = [&](size_t i, size_t j) {
+        return !prefs.prefersId(ids[i], ids[j]) && !prefs.prefersId(ids[j], ids[i]);
+    };
+
+    // Random draws are cheap and keep the pairing varied while most pairs are open
+    std::uniform_int_distribution<size_t> dist(0, n - 1);
+    for (int attempt = 0; attempt < 32; ++attempt) {
+        size_t i = dist(rng), j = dist(rng);
+        if (i == j) continue;
+        if (open(i, j)) return std::make_pair(i, j);
+    }
+
+    // Near convergence most pairs are implied; scan from a random start instead
+    const size_t start = dist(rng);
+    for (size_t a = 0; a < n; ++a) {
+        const size_t i = (start + a) % n;
+        for (size_t j = 0; j < n; ++j) {
+            if (j == i || !open(i, j)) continue;
+            if (rng() & 1u) return std::make_pair(i, j);
+            return std::make_pair(j, i);
+        }
+    }
+    return std::nullopt;
+}
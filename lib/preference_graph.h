@@ -0,0 +1,128 @@
+// SPDX-License-Identifier: Apache-2.0
+//-------------------------------------------------------------------------------
+// Top100 — Your Personal Movie List
+//
+// File: lib/preference_graph.h
+// Purpose: Preference DAG with a bitset transitive closure and pair scheduling.
+// Language: C++17 (header)
+//-------------------------------------------------------------------------------
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+struct Movie;
+
+/**
+ * @brief Stable key identifying a movie in the comparison history.
+ *
+ * Uses the IMDb ID when present, otherwise "title|year" so manual entries can
+ * still be ranked.
+ * @param m Movie
+ * @return Key string
+ * @ingroup core
+ */
+std::string comparisonKey(const Movie& m);
+
+/**
+ * @brief Directed graph of pairwise preferences with a transitive closure index.
+ *
+ * Each answer "A beats B" adds an edge A→B. The closure is stored as one bit row
+ * per movie (row A has bit B set when A is known to beat B directly or through a
+ * chain), so prefers() is a single bit test. Adding an edge only ORs the loser's
+ * row into the rows of the winner and everything already above the winner, which
+ * keeps updates at O(n·n/64) worst case and much less in practice.
+ *
+ * Inconsistent answers (a new result that contradicts the closure) are resolved
+ * in favour of the most recent answers: the closure is rebuilt newest-first and
+ * any older edge that would close a cycle is dropped from the index (but kept in
+ * the history). conflictCount() reports how many edges are currently dropped.
+ *
+ * @ingroup core
+ */
+class PreferenceGraph {
+public:
+    /**
+     * @brief Record that @p winner is preferred over @p loser.
+     * @param winner Key of the preferred movie
+     * @param loser Key of the other movie
+     * @return false if the answer contradicted earlier ones (older edges were dropped)
+     */
+    bool addPreference(const std::string& winner, const std::string& loser);
+
+    /** @brief True if @p a is known (directly or transitively) to beat @p b.
+     *  @param a Key of the first movie
+     *  @param b Key of the second movie
+     *  @return true when a > b is implied */
+    bool prefers(const std::string& a, const std::string& b) const;
+
+    /** @brief True if the outcome of a vs b is already implied either way.
+     *  @param a Key of the first movie
+     *  @param b Key of the second movie
+     *  @return true when asking the user would add no information */
+    bool isImplied(const std::string& a, const std::string& b) const;
+
+    /** @brief Node id for a key, or -1 if the key has never been compared.
+     *  @param key Movie key
+     *  @return Node id */
+    int idOf(const std::string& key) const;
+
+    /** @brief Id-based variant of prefers() for hot loops (ids from idOf()).
+     *  @param a Node id of the first movie (may be -1)
+     *  @param b Node id of the second movie (may be -1)
+     *  @return true when a > b is implied */
+    bool prefersId(int a, int b) const {
+        if (a < 0 || b < 0) return false;
+        return (closure_[static_cast<size_t>(a) * words_ + (static_cast<size_t>(b) >> 6)] >> (b & 63)) & 1u;
+    }
+
+    /** @brief Number of movies @p id is known to beat (population count of its row).
+     *  @param id Node id (may be -1)
+     *  @return Count of implied wins */
+    size_t beatsCount(int id) const;
+
+    /** @return Number of distinct movies seen in the history. */
+    size_t size() const { return keys_.size(); }
+    /** @return Number of recorded answers (including dropped ones). */
+    size_t edgeCount() const { return edges_.size(); }
+    /** @return Number of older answers currently excluded to break cycles. */
+    size_t conflictCount() const { return conflicts_; }
+
+    /** @brief Remove all nodes and edges. */
+    void clear();
+
+private:
+    int internKey(const std::string& key);
+    void ensureCapacity(size_t nodes);
+    bool reaches(int a, int b) const { return prefersId(a, b); }
+    void insertClosureEdge(int w, int l);
+    void rebuildNewestFirst();
+
+    std::unordered_map<std::string, int> ids_;
+    std::vector<std::string> keys_;
+    std::vector<std::pair<int, int>> edges_;   // chronological (winner, loser)
+    std::vector<uint64_t> closure_;            // row-major bitset, words_ words per row
+    size_t words_ = 0;                         // words per row (capacity / 64)
+    size_t conflicts_ = 0;
+};
+
+/**
+ * @brief Pick a random pair of positions whose outcome is not yet implied.
+ *
+ * Tries a handful of random draws first, then falls back to a scan so that a
+ * pair is always found while one exists.
+ *
+ * @param movies Candidate movies (indices refer to this vector)
+ * @param prefs Preference closure built from the comparison history
+ * @param rng Random generator
+ * @return Pair of distinct indices, or std::nullopt when every pair is implied
+ * @ingroup core
+ */
+std::optional<std::pair<size_t, size_t>> pickComparisonPair(const std::vector<Movie>& movies,
+                                                            const PreferenceGraph& prefs,
+                                                            std::mt19937& rng);
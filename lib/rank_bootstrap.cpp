@@ -0,0 +1,115 @@
+// SPDX-License-Identifier: Apache-2.0
+//-------------------------------------------------------------------------------
+// Top100 — Your Personal Movie List
+//
+// File: lib/rank_bootstrap.cpp
+// Purpose: Bootstrap confidence intervals for user ranks.
+// Language: C++17 (CMake build)
+//-------------------------------------------------------------------------------
+#include "rank_bootstrap.h"
+#include "Movie.h"
+#include "elo.h"
+#include "thread_pool.h"
+#include "top100.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <unordered_map>
+
+namespace {
+
+// Per-worker scratch space, reused across every resample the worker runs
+struct Workspace {
+    EloBatch batch;
+    std::vector<uint32_t> counts;   // multiplicity of each history entry
+    std::vector<EloPair> sample;
+    std::vector<double> scores;
+    std::vector<uint32_t> order;
+};
+
+} // namespace
+
+std::vector<RankInterval> bootstrapRankIntervals(const std::vector<Movie>& movies,
+                                                 const std::vector<Comparison>& history,
+                                                 const RankBootstrapOptions& opts,
+                                                 ThreadPool& pool) {
+    const size_t n = movies.size();
+    std::vector<RankInterval> out(n, RankInterval{1, static_cast<int>(n)});
+    if (n == 0) return out;
+
+    // Resolve history keys to indices once; answers about removed movies are ignored
+    std::unordered_map<std::string, uint32_t> index;
+    for (size_t i = 0; i < n; ++i) index.emplace(comparisonKey(movies[i]), static_cast<uint32_t>(i));
+    std::vector<EloPair> answers;
+    answers.reserve(history.size());
+    std::vector<bool> seen(n, false);
+    for (const auto& c : history) {
+        auto w = index.find(c.winner), l = index.find(c.loser);
+        if (w == index.end() || l == index.end() || w->second == l->second) continue;
+        answers.push_back({w->second, l->second});
+        seen[w->second] = seen[l->second] = true;
+    }
+    if (answers.empty() || opts.resamples == 0) return out;
+
+    const size_t resamples = opts.resamples;
+    std::vector<uint32_t> ranks(resamples * n);   // row r = 0-based rank of each movie
+    std::vector<Workspace> spaces(pool.threadCount());
+    const size_t m = answers.size();
+
+    pool.parallelFor(resamples, [&](size_t r, size_t worker) {
+        Workspace& ws = spaces[worker];
+        std::seed_seq seq{opts.seed, static_cast<unsigned>(r)};
+        std::mt19937 rng(seq);
+        std::uniform_int_distribution<size_t> draw(0, m - 1);
+
+        // Multinomial counts keep the resample in chronological order for Elo replay
+        ws.counts.assign(m, 0);
+        for (size_t i = 0; i < m; ++i) ++ws.counts[draw(rng)];
+        ws.sample.clear();
+        for (size_t i = 0; i < m; ++i)
+            for (uint32_t c = 0; c < ws.counts[i]; ++c) ws.sample.push_back(answers[i]);
+
+        ws.scores.assign(n, 1500.0);
+        ws.batch.apply(ws.scores, ws.sample, opts.k);
+
+        ws.order.resize(n);
+        std::iota(ws.order.begin(), ws.order.end(), 0u);
+        std::sort(ws.order.begin(), ws.order.end(), [&](uint32_t a, uint32_t b) {
+            if (ws.scores[a] != ws.scores[b]) return ws.scores[a] > ws.scores[b];
+            return a < b;
+        });
+        uint32_t* row = &ranks[r * n];
+        for (size_t k = 0; k < n; ++k) row[ws.order[k]] = static_cast<uint32_t>(k);
+    });
+
+    // Quantiles per movie from a rank histogram (ranks are small integers)
+    const double tail = std::clamp((1.0 - opts.confidence) / 2.0, 0.0, 0.5);
+    const size_t lowCount = static_cast<size_t>(std::floor(tail * static_cast<double>(resamples)));
+    const size_t highCount = resamples - lowCount;
+    std::vector<uint32_t> hist(n);
+    for (size_t i = 0; i < n; ++i) {
+        if (!seen[i]) continue;
+        std::fill(hist.begin(), hist.end(), 0u);
+        for (size_t r = 0; r < resamples; ++r) ++hist[ranks[r * n + i]];
+        size_t cum = 0;
+        int low = -1, high = -1;
+        for (size_t k = 0; k < n; ++k) {
+            cum += hist[k];
+            if (low < 0 && cum > lowCount) low = static_cast<int>(k);
+            if (high < 0 && cum >= highCount) { high = static_cast<int>(k); break; }
+        }
+        out[i].low = low + 1;
+        out[i].high = (high < 0 ? static_cast<int>(n) - 1 : high) + 1;
+    }
+    return out;
+}
+
+std::string rankLabel(const Movie& m) {
+    if (m.userRank <= 0) return std::string();
+    std::string label = "#" + std::to_string(m.userRank);
+    if (m.userRankLow > 0 && m.userRankHigh > m.userRankLow) {
+        label += " (" + std::to_string(m.userRankLow) + "-" + std::to_string(m.userRankHigh) + ")";
+    }
+    return label + " ";
+}
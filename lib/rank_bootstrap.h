@@ -0,0 +1,79 @@
+// SPDX-License-Identifier: Apache-2.0
+//-------------------------------------------------------------------------------
+// Top100 — Your Personal Movie List
+//
+// File: lib/rank_bootstrap.h
+// Purpose: Bootstrap confidence intervals for user ranks.
+// Language: C++17 (header)
+//-------------------------------------------------------------------------------
+#pragma once
+
+#include <string>
+#include <vector>
+
+struct Movie;
+struct Comparison;
+class ThreadPool;
+
+/**
+ * @brief Tuning for bootstrapRankIntervals().
+ * @ingroup core
+ */
+struct RankBootstrapOptions {
+    /** Number of resampled histories */
+    size_t resamples = 200;
+    /** Central coverage of the interval (0.9 = 5th..95th percentile) */
+    double confidence = 0.9;
+    /** Elo K-factor used when re-fitting scores */
+    double k = 32.0;
+    /** Base seed; results are deterministic for a given seed and history */
+    unsigned seed = 0x7031u;
+};
+
+/**
+ * @brief Inclusive 1-based rank interval.
+ * @ingroup core
+ */
+struct RankInterval {
+    /** Best plausible rank */
+    int low = 0;
+    /** Worst plausible rank */
+    int high = 0;
+};
+
+/**
+ * @brief Estimate how certain each movie's rank is from the comparison history.
+ *
+ * Each resample draws history.size() answers with replacement, replays them in
+ * chronological order from 1500 with the batched Elo kernel, and ranks the
+ * movies by the re-fitted scores. The interval is the central @c confidence
+ * quantile range of those ranks. Movies that never appear in the history get
+ * the full range [1, n].
+ *
+ * Resamples run on @p pool; each worker reuses one workspace (sample buffer,
+ * Elo batch scheduler, score and order arrays) for all the resamples it takes.
+ * Don't call this from a task already running on @p pool.
+ *
+ * @param movies Movies (result is parallel to this vector)
+ * @param history Comparison history keyed by comparisonKey()
+ * @param opts Resample count, coverage, K-factor and seed
+ * @param pool Worker pool
+ * @return One interval per movie
+ * @ingroup core
+ */
+std::vector<RankInterval> bootstrapRankIntervals(const std::vector<Movie>& movies,
+                                                 const std::vector<Comparison>& history,
+                                                 const RankBootstrapOptions& opts,
+                                                 ThreadPool& pool);
+
+/**
+ * @brief List prefix for a movie's rank, e.g. "#12 " or "#12 (9-15) ".
+ *
+ * The interval is shown only when it has been estimated and spans more than one
+ * rank. Returns an empty string for unranked movies.
+ *
+ * @param m Movie
+ * @return Label including a trailing space, or empty
+ * @ingroup core
+ */
+std::string rankLabel(const Movie& m);
@@ -0,0 +1,176 @@
+// SPDX-License-Identifier: Apache-2.0
+//-------------------------------------------------------------------------------
+// Top100 — Your Personal Movie List
+//
+// File: lib/ranking.cpp
+// Purpose: Comparison application, pair-selection strategies and rank metrics.
+// Language: C++17 (CMake build)
+//-------------------------------------------------------------------------------
+#include "ranking.h"
+#include "Movie.h"
+#include "elo.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <numeric>
+
+void applyComparison(std::vector<Movie>& movies, PreferenceGraph& prefs, size_t winner, size_t loser, double k) {
+    eloUpdate(movies[winner].userScore, movies[loser].userScore, 1.0, k);
+    prefs.addPreference(comparisonKey(movies[winner]), comparisonKey(movies[loser]));
+}
+
+namespace {
+
+class RandomStrategy : public PairStrategy {
+public:
+    std::optional<std::pair<size_t, size_t>> nextPair(const std::vector<Movie>& movies, const PreferenceGraph&,
+                                                      std::mt19937& rng) override {
+        if (movies.size() < 2) return std::nullopt;
+        std::uniform_int_distribution<size_t> dist(0, movies.size() - 1);
+        size_t i = dist(rng), j = dist(rng);
+        while (j == i) j = dist(rng);
+        return std::make_pair(i, j);
+    }
+};
+
+class RandomSkipStrategy : public PairStrategy {
+public:
+    std::optional<std::pair<size_t, size_t>> nextPair(const std::vector<Movie>& movies, const PreferenceGraph& prefs,
+                                                      std::mt19937& rng) override {
+        return pickComparisonPair(movies, prefs, rng);
+    }
+};
+
+class ActiveStrategy : public PairStrategy {
+public:
+    std::optional<std::pair<size_t, size_t>> nextPair(const std::vector<Movie>& movies, const PreferenceGraph& prefs,
+                                                      std::mt19937& rng) override {
+        const size_t n = movies.size();
+        if (n < 2) return std::nullopt;
+        order_.resize(n);
+        ids_.resize(n);
+        std::iota(order_.begin(), order_.end(), size_t{0});
+        for (size_t i = 0; i < n; ++i) ids_[i] = prefs.idOf(comparisonKey(movies[i]));
+        std::sort(order_.begin(), order_.end(),
+                  [&](size_t a, size_t b) { return movies[a].userScore > movies[b].userScore; });
+
+        // Neighbours in score order are where the ranking is least certain; take the
+        // closest open one (ties broken uniformly at random).
+        double best = std::numeric_limits<double>::infinity();
+        std::optional<std::pair<size_t, size_t>> pick;
+        size_t ties = 0;
+        for (size_t k = 0; k + 1 < n; ++k) {
+            const size_t a = order_[k], b = order_[k + 1];
+            if (prefs.prefersId(ids_[a], ids_[b]) || prefs.prefersId(ids_[b], ids_[a])) continue;
+            const double gap = movies[a].userScore - movies[b].userScore;
+            if (gap < best) {
+                best = gap;
+                pick = std::make_pair(a, b);
+                ties = 1;
+            } else if (gap == best && std::uniform_int_distribution<size_t>(0, ties++)(rng) == 0) {
+                pick = std::make_pair(a, b);
+            }
+        }
+        if (pick) return pick;
+        return pickComparisonPair(movies, prefs, rng);
+    }
+
+private:
+    std::vector<size_t> order_;
+    std::vector<int> ids_;
+};
+
+class InsertionStrategy : public PairStrategy {
+public:
+    std::optional<std::pair<size_t, size_t>> nextPair(const std::vector<Movie>& movies, const PreferenceGraph& prefs,
+                                                      std::mt19937& rng) override {
+        if (!started_) {
+            pending_.resize(movies.size());
+            std::iota(pending_.begin(), pending_.end(), size_t{0});
+            std::shuffle(pending_.begin(), pending_.end(), rng);
+            started_ = true;
+        }
+        for (;;) {
+            if (!current_) {
+                if (pending_.empty()) break;
+                current_ = pending_.back();
+                pending_.pop_back();
+                lo_ = 0;
+                hi_ = sorted_.size();
+            }
+            const std::string cur = comparisonKey(movies[*current_]);
+            // Binary search against the sorted prefix; outcomes come from the closure,
+            // so the previous answer (and anything it implies) is picked up here.
+            while (lo_ < hi_) {
+                const size_t mid = lo_ + (hi_ - lo_) / 2;
+                const std::string other = comparisonKey(movies[sorted_[mid]]);
+                if (prefs.prefers(cur, other)) hi_ = mid;
+                else if (prefs.prefers(other, cur)) lo_ = mid + 1;
+                else return std::make_pair(*current_, sorted_[mid]);
+            }
+            sorted_.insert(sorted_.begin() + static_cast<std::ptrdiff_t>(lo_), *current_);
+            current_.reset();
+        }
+        // Every movie placed; noisy answers can leave gaps in the closure
+        return pickComparisonPair(movies, prefs, rng);
+    }
+
+private:
+    bool started_ = false;
+    std::vector<size_t> pending_;
+    std::vector<size_t> sorted_;   // best first
+    std::optional<size_t> current_;
+    size_t lo_ = 0, hi_ = 0;
+};
+
+// Merge sort that counts inversions in v (pairs i<j with v[i] > v[j]).
+unsigned long long countInversions(std::vector<size_t>& v, std::vector<size_t>& tmp, size_t lo, size_t hi) {
+    if (hi - lo < 2) return 0;
+    const size_t mid = lo + (hi - lo) / 2;
+    unsigned long long inv = countInversions(v, tmp, lo, mid) + countInversions(v, tmp, mid, hi);
+    size_t i = lo, j = mid, k = lo;
+    while (i < mid && j < hi) {
+        if (v[j] < v[i]) { inv += mid - i; tmp[k++] = v[j++]; }
+        else tmp[k++] = v[i++];
+    }
+    while (i < mid) tmp[k++] = v[i++];
+    while (j < hi) tmp[k++] = v[j++];
+    std::copy(tmp.begin() + static_cast<std::ptrdiff_t>(lo), tmp.begin() + static_cast<std::ptrdiff_t>(hi),
+              v.begin() + static_cast<std::ptrdiff_t>(lo));
+    return inv;
+}
+
+} // namespace
+
+std::unique_ptr<PairStrategy> makePairStrategy(const std::string& name) {
+    if (name == "random") return std::make_unique<RandomStrategy>();
+    if (name == "random-skip") return std::make_unique<RandomSkipStrategy>();
+    if (name == "active") return std::make_unique<ActiveStrategy>();
+    if (name == "insertion") return std::make_unique<InsertionStrategy>();
+    return nullptr;
+}
+
+std::vector<std::string> pairStrategyNames() {
+    return {"random", "random-skip", "active", "insertion"};
+}
+
+double kendallTau(const std::vector<size_t>& rankA, const std::vector<size_t>& rankB) {
+    const size_t n = rankA.size();
+    if (n < 2 || rankB.size() != n) return 1.0;
+    // Walk items in A's order; inversions in B's positions are discordant pairs
+    std::vector<size_t> seq(n), tmp(n);
+    for (size_t i = 0; i < n; ++i) seq[rankA[i]] = rankB[i];
+    const double pairs = static_cast<double>(n) * static_cast<double>(n - 1) / 2.0;
+    const double discordant = static_cast<double>(countInversions(seq, tmp, 0, n));
+    return 1.0 - 2.0 * discordant / pairs;
+}
+
+double spearmanFootrule(const std::vector<size_t>& rankA, const std::vector<size_t>& rankB) {
+    const size_t n = rankA.size();
+    if (n < 2 || rankB.size() != n) return 0.0;
+    unsigned long long sum = 0;
+    for (size_t i = 0; i < n; ++i) sum += rankA[i] > rankB[i] ? rankA[i] - rankB[i] : rankB[i] - rankA[i];
+    const double maxSum = static_cast<double>((n * n) / 2); // reached by reversing the order
+    return static_cast<double>(sum) / maxSum;
+}
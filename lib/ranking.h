@@ -0,0 +1,99 @@
+// SPDX-License-Identifier: Apache-2.0
+//-------------------------------------------------------------------------------
+// Top100 — Your Personal Movie List
+//
+// File: lib/ranking.h
+// Purpose: Comparison application, pair-selection strategies and rank metrics.
+// Language: C++17 (header)
+//-------------------------------------------------------------------------------
+#pragma once
+
+#include "preference_graph.h"
+#include <memory>
+#include <optional>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+struct Movie;
+
+/**
+ * @brief Apply one answer to in-memory ranking state.
+ *
+ * Updates both Elo scores and adds the preference to the closure. This is the
+ * part of Top100::recordComparison() that does not touch storage, so headless
+ * drivers (the convergence simulator) exercise exactly what the CLI does.
+ *
+ * @param movies Movie list (scores updated in place)
+ * @param prefs Preference closure
+ * @param winner Index of the preferred movie
+ * @param loser Index of the other movie
+ * @param k Elo K-factor
+ * @ingroup core
+ */
+void applyComparison(std::vector<Movie>& movies, PreferenceGraph& prefs, size_t winner, size_t loser,
+                     double k = 32.0);
+
+/**
+ * @brief Chooses which pair of movies to ask about next.
+ *
+ * Strategies may keep state between calls (insertion does), so use one instance
+ * per ranking session over a fixed movie vector. Answers are not passed back
+ * explicitly; strategies read them from the preference closure.
+ *
+ * @ingroup core
+ */
+class PairStrategy {
+public:
+    virtual ~PairStrategy() = default;
+
+    /**
+     * @brief Next pair to compare.
+     * @param movies Movies being ranked (indices refer to this vector)
+     * @param prefs Closure of the answers so far
+     * @param rng Random generator
+     * @return Pair of distinct indices, or std::nullopt when the strategy is done
+     */
+    virtual std::optional<std::pair<size_t, size_t>> nextPair(const std::vector<Movie>& movies,
+                                                              const PreferenceGraph& prefs,
+                                                              std::mt19937& rng) = 0;
+};
+
+/**
+ * @brief Create a pair strategy by name.
+ *
+ * - "random": uniform random pairs, repeats allowed (the original compareMovies)
+ * - "random-skip": random pairs skipping implied outcomes (compareMovies today)
+ * - "active": the adjacent-by-score pair with the smallest gap whose outcome is
+ *   still open, i.e. the comparison the current scores are least sure about
+ * - "insertion": binary insertion sort driven by the closure
+ *
+ * @param name Strategy name
+ * @return Strategy, or nullptr for an unknown name
+ * @ingroup core
+ */
+std::unique_ptr<PairStrategy> makePairStrategy(const std::string& name);
+
+/** @return Names accepted by makePairStrategy(). @ingroup core */
+std::vector<std::string> pairStrategyNames();
+
+/**
+ * @brief Kendall rank correlation between two rankings of the same items.
+ *
+ * Counts discordant pairs with a merge sort, O(n log n).
+ * @param rankA rankA[i] = position of item i in the first ranking (0 = best)
+ * @param rankB rankB[i] = position of item i in the second ranking
+ * @return tau in [-1, 1] (1 = identical order)
+ * @ingroup core
+ */
+double kendallTau(const std::vector<size_t>& rankA, const std::vector<size_t>& rankB);
+
+/**
+ * @brief Normalised Spearman footrule distance between two rankings.
+ * @param rankA rankA[i] = position of item i in the first ranking
+ * @param rankB rankB[i] = position of item i in the second ranking
+ * @return Sum of |rankA[i] - rankB[i]| divided by its maximum; 0 = identical
+ * @ingroup core
+ */
+double spearmanFootrule(const std::vector<size_t>& rankA, const std::vector<size_t>& rankB);
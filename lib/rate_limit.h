@@ -0,0 +1,93 @@
+// SPDX-License-Identifier: Apache-2.0
+//-------------------------------------------------------------------------------
+// Top100 — Your Personal Movie List
+//
+// File: lib/rate_limit.h
+// Purpose: Token-bucket rate limiter shared by concurrent request workers.
+// Language: C++17 (header)
+//-------------------------------------------------------------------------------
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+/**
+ * @brief Thread-safe token bucket.
+ *
+ * Tokens accrue at @c rate per second up to @c burst. Each acquire() takes one
+ * token, sleeping until one is available, so any number of workers together
+ * stay under the configured request rate while an idle bucket still allows a
+ * short burst.
+ *
+ * @ingroup services
+ */
+class TokenBucket {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief Create a full bucket.
+     * @param ratePerSecond Refill rate (<= 0 = unlimited)
+     * @param burst Capacity (at least 1)
+     */
+    TokenBucket(double ratePerSecond, double burst)
+        : rate_(ratePerSecond), burst_(std::max(1.0, burst)), tokens_(burst_), last_(Clock::now()) {}
+
+    /** @return Refill rate in tokens per second (<= 0 = unlimited). */
+    double rate() const { return rate_; }
+
+    /**
+     * @brief Take a token without waiting.
+     * @return true if a token was available
+     */
+    bool tryAcquire() {
+        if (rate_ <= 0.0) return true;
+        std::lock_guard<std::mutex> lock(mutex_);
+        refill(Clock::now());
+        if (tokens_ < 1.0) return false;
+        tokens_ -= 1.0;
+        return true;
+    }
+
+    /**
+     * @brief Take a token, waiting for one if the bucket is empty.
+     * @param cancel Optional flag; the wait gives up once it becomes true
+     * @return true if a token was taken, false if cancelled
+     */
+    bool acquire(const std::atomic<bool>* cancel = nullptr) {
+        if (rate_ <= 0.0) return !(cancel && cancel->load());
+        for (;;) {
+            if (cancel && cancel->load()) return false;
+            Clock::duration wait;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                const Clock::time_point now = Clock::now();
+                refill(now);
+                if (tokens_ >= 1.0) {
+                    tokens_ -= 1.0;
+                    return true;
+                }
+                wait = std::chrono::duration_cast<Clock::duration>(
+                    std::chrono::duration<double>((1.0 - tokens_) / rate_));
+            }
+            // Sleep in short slices so cancellation stays responsive
+            std::this_thread::sleep_for(std::min<Clock::duration>(wait, std::chrono::milliseconds(50)));
+        }
+    }
+
+private:
+    void refill(Clock::time_point now) {
+        const double elapsed = std::chrono::duration<double>(now - last_).count();
+        tokens_ = std::min(burst_, tokens_ + elapsed * rate_);
+        last_ = now;
+    }
+
+    const double rate_;
+    const double burst_;
+    double tokens_;
+    Clock::time_point last_;
+    std::mutex mutex_;
+};
@@ -0,0 +1,51 @@
+// SPDX-License-Identifier: Apache-2.0
+//-------------------------------------------------------------------------------
+// Top100 — Your Personal Movie List
+//
+// File: lib/shared_services.cpp
+// Purpose: One-call setup of the caches and index every front end shares.
+// Language: C++17 (CMake build)
+//-------------------------------------------------------------------------------
+#include "shared_services.h"
+#include "config.h"
+#include "omdb.h"
+#include "omdb_cache.h"
+#include "poster_cache.h"
+#include "title_index.h"
+#include <exception>
+
+std::vector<std::string> initSharedServices(const AppConfig& cfg) {
+    std::vector<std::string> errors;
+    try {
+        auto cache = openOmdbCache(cfg);
+        if (!cache && cfg.omdbCacheEnabled && !cfg.dataFile.empty())
+            errors.push_back("OMDb cache: cannot open " + cfg.dataFile);
+        omdbSetCache(cache);
+    } catch (const std::exception& e) {
+        errors.push_back(std::string("OMDb cache: ") + e.what());
+    }
+    try {
+        setPosterCache(openPosterCache(cfg));
+    } catch (const std::exception& e) {
+        errors.push_back(std::string("Poster cache: ") + e.what());
+    }
+    try {
+        auto index = openTitleIndex(cfg);
+        if (!index && !cfg.omdbLocalIndexPath.empty())
+            errors.push_back("Title index: cannot open " + cfg.omdbLocalIndexPath);
+        omdbSetLocalIndex(index, omdbLocalIndexModeOf(cfg.omdbLocalIndexMode));
+    } catch (const std::exception& e) {
+        errors.push_back(std::string("Title index: ") + e.what());
+    }
+    return errors;
+}
+
+std::vector<std::string> initSharedServices() {
+    AppConfig cfg;
+    try {
+        cfg = loadConfig();
+    } catch (const std::exception& e) {
+        return {std::string("Configuration: ") + e.what()};
+    }
+    return initSharedServices(cfg);
+}
@@ -0,0 +1,36 @@
+// SPDX-License-Identifier: Apache-2.0
+//-------------------------------------------------------------------------------
+// Top100 — Your Personal Movie List
+//
+// File: lib/shared_services.h
+// Purpose: One-call setup of the caches and index every front end shares.
+// Language: C++17 (header)
+//-------------------------------------------------------------------------------
+#pragma once
+
+#include <string>
+#include <vector>
+
+struct AppConfig;
+
+/**
+ * @brief Install the process-wide services for @p cfg.
+ *
+ * Opens the OMDb answer cache (omdbSetCache()), the poster cache
+ * (setPosterCache()) and the offline title index (omdbSetLocalIndex()), all
+ * shared with the other front ends using the same database. Each is set up
+ * on its own: one that fails is left unset and the others are still
+ * installed. Call once at startup, before any window or command uses them.
+ *
+ * @param cfg Application configuration
+ * @return One message per service that is configured but could not be opened; empty when all were
+ * @ingroup services
+ */
+std::vector<std::string> initSharedServices(const AppConfig& cfg);
+
+/**
+ * @brief initSharedServices() with the configuration from loadConfig().
+ * @return Messages as above, or the reason the configuration could not be loaded
+ * @ingroup services
+ */
+std::vector<std::string> initSharedServices();
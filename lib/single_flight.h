@@ -0,0 +1,257 @@
+// SPDX-License-Identifier: Apache-2.0
+//-------------------------------------------------------------------------------
+// Top100 — Your Personal Movie List
+//
+// File: lib/single_flight.h
+// Purpose: Share one in-flight operation between identical concurrent calls.
+// Language: C++17 (header)
+//-------------------------------------------------------------------------------
+#pragma once
+
+#include "async.h"
+#include <cstdint>
+#include <exception>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+/**
+ * @brief Counters of a SingleFlight.
+ * @ingroup core
+ */
+struct SingleFlightStats {
+    /** Operations actually started (one per flight) */
+    uint64_t started = 0;
+    /** Calls that joined a flight already in progress instead of starting one */
+    uint64_t joined = 0;
+    /** Flights in progress right now */
+    size_t inFlight = 0;
+};
+
+/**
+ * @brief Request coalescing: concurrent calls with the same key share one operation.
+ *
+ * The first caller for a key (the leader) runs the operation; callers arriving
+ * while it is in flight wait for the same result instead of starting their
+ * own. A flight ends when its result is delivered, so a later call starts a
+ * fresh one: nothing is cached.
+ *
+ * Blocking callers use run(), asynchronous ones runAsync(); both share the
+ * same flights. Code that starts operations itself (e.g. a batch) can use
+ * begin() / finish() directly.
+ *
+ * Thread-safe.
+ *
+ * @ingroup core
+ */
+template <class Key, class Value>
+class SingleFlight {
+    struct Entry {
+        Promise<Value> promise;
+        CancelSource source;   // cancels the shared operation
+        size_t waiters = 0;    // callers still interested
+    };
+    struct Shared {
+        std::mutex mutex;
+        std::map<Key, std::shared_ptr<Entry>> flights;
+        SingleFlightStats stats;
+    };
+
+public:
+    /**
+     * @brief A caller's place in a flight, from begin().
+     */
+    class Flight {
+    public:
+        /** @return true if this caller must run the operation and call finish() */
+        bool leader() const { return leader_; }
+        /** @return The shared result */
+        Future<Value> future() const { return entry_->promise.future(); }
+        /** @return Token for the shared operation (see runAsync()) */
+        CancelToken token() const { return entry_->source.token(); }
+
+    private:
+        friend class SingleFlight;
+        std::shared_ptr<Entry> entry_;
+        bool leader_ = false;
+    };
+
+    SingleFlight() : s_(std::make_shared<Shared>()) {}
+
+    SingleFlight(const SingleFlight&) = delete;
+    SingleFlight& operator=(const SingleFlight&) = delete;
+
+    /**
+     * @brief Join the flight for @p key, or open one with this caller as leader.
+     * @param key Operation identity
+     * @return Flight; a leader must end it with finish() or fail()
+     */
+    Flight begin(const Key& key) {
+        Flight f;
+        std::lock_guard<std::mutex> lock(s_->mutex);
+        auto it = s_->flights.find(key);
+        if (it != s_->flights.end()) {
+            f.entry_ = it->second;
+            ++s_->stats.joined;
+        } else {
+            f.entry_ = std::make_shared<Entry>();
+            f.leader_ = true;
+            s_->flights.emplace(key, f.entry_);
+            ++s_->stats.started;
+        }
+        ++f.entry_->waiters;
+        return f;
+    }
+
+    /**
+     * @brief Deliver the leader's result to every caller of the flight.
+     * @param key Key passed to begin()
+     * @param flight The leader's flight
+     * @param value Result
+     */
+    void finish(const Key& key, const Flight& flight, Value value) {
+        end(*s_, key, flight.entry_);
+        flight.entry_->promise.setValue(std::move(value));
+    }
+
+    /**
+     * @brief End the flight with an error (rethrown to every caller).
+     * @param key Key passed to begin()
+     * @param flight The leader's flight
+     * @param error Exception
+     */
+    void fail(const Key& key, const Flight& flight, std::exception_ptr error) {
+        end(*s_, key, flight.entry_);
+        flight.entry_->promise.setError(std::move(error));
+    }
+
+    /**
+     * @brief Run @p fn, unless the same operation is already in flight.
+     * @param key Operation identity
+     * @param fn Callable returning Value
+     * @param joined Set to true if another caller's result was returned (optional)
+     * @return The result
+     * @throws Whatever @p fn threw (for every caller of the flight), or
+     *         OperationCancelled if an asynchronous leader's operation was cancelled
+     */
+    template <class F>
+    Value run(const Key& key, F&& fn, bool* joined = nullptr) {
+        Flight f = begin(key);
+        if (joined) *joined = !f.leader();
+        if (!f.leader()) return f.future().get();
+        try {
+            Value v = fn();
+            finish(key, f, v);
+            return v;
+        } catch (...) {
+            fail(key, f, std::current_exception());
+            throw;
+        }
+    }
+
+    /**
+     * @brief Start @p start, unless the same operation is already in flight.
+     *
+     * Each caller gets its own future, cancelled through its own @p cancel.
+     * The shared operation receives a token that fires only once every caller
+     * has cancelled (blocking callers never do), so one caller giving up does
+     * not abort the others' result.
+     *
+     * @param key Operation identity
+     * @param cancel This caller's cancellation
+     * @param start Callable taking a CancelToken and returning Future<Value>
+     * @param joined Set to true if an operation in flight was joined (optional)
+     * @return This caller's view of the result
+     */
+    template <class F>
+    Future<Value> runAsync(const Key& key, CancelToken cancel, F&& start, bool* joined = nullptr) {
+        Promise<Value> mine;
+        Future<Value> out = mine.future();
+        if (cancel.cancelled()) {
+            mine.cancel();
+            return out;
+        }
+        Flight f = begin(key);
+        if (joined) *joined = !f.leader();
+
+        std::shared_ptr<Entry> entry = f.entry_;
+        size_t cancelId = 0;
+        if (cancel.canBeCancelled()) {
+            std::weak_ptr<Shared> weak = s_;
+            cancelId = cancel.onCancel([weak, key, entry, mine]() {
+                auto s = weak.lock();
+                bool last = false;
+                if (s) {
+                    std::lock_guard<std::mutex> lock(s->mutex);
+                    last = --entry->waiters == 0;
+                    if (last) unlink(*s, key, entry);
+                }
+                // The last caller is answered once the operation has stopped
+                if (last) entry->source.cancel();
+                else mine.cancel();
+            });
+        }
+        entry->promise.future().onComplete([mine, cancel, cancelId](const Future<Value>& done) {
+            cancel.forget(cancelId);
+            if (done.cancelled() || cancel.cancelled()) {
+                mine.cancel();
+                return;
+            }
+            try {
+                mine.setValue(done.get());
+            } catch (...) {
+                mine.setError(std::current_exception());
+            }
+        });
+
+        if (f.leader()) {
+            std::weak_ptr<Shared> weak = s_;
+            try {
+                start(entry->source.token()).onComplete([weak, key, entry](const Future<Value>& done) {
+                    if (auto s = weak.lock()) end(*s, key, entry);
+                    if (done.cancelled()) {
+                        entry->promise.cancel();
+                        return;
+                    }
+                    try {
+                        entry->promise.setValue(done.get());
+                    } catch (...) {
+                        entry->promise.setError(std::current_exception());
+                    }
+                });
+            } catch (...) {
+                fail(key, f, std::current_exception());
+            }
+        }
+        return out;
+    }
+
+    /** @return Counters since construction (or resetStats()). */
+    SingleFlightStats stats() const {
+        std::lock_guard<std::mutex> lock(s_->mutex);
+        SingleFlightStats out = s_->stats;
+        out.inFlight = s_->flights.size();
+        return out;
+    }
+
+    /** @brief Zero the counters. */
+    void resetStats() {
+        std::lock_guard<std::mutex> lock(s_->mutex);
+        s_->stats = SingleFlightStats();
+    }
+
+private:
+    // Remove @p entry if it is still the flight for @p key (caller holds the mutex)
+    static void unlink(Shared& s, const Key& key, const std::shared_ptr<Entry>& entry) {
+        auto it = s.flights.find(key);
+        if (it != s.flights.end() && it->second == entry) s.flights.erase(it);
+    }
+
+    static void end(Shared& s, const Key& key, const std::shared_ptr<Entry>& entry) {
+        std::lock_guard<std::mutex> lock(s.mutex);
+        unlink(s, key, entry);
+    }
+
+    std::shared_ptr<Shared> s_;
+};
@@ -0,0 +1,120 @@
+// SPDX-License-Identifier: Apache-2.0
+//-------------------------------------------------------------------------------
+// Top100 — Your Personal Movie List
+//
+// File: lib/text_fit.cpp
+// Purpose: UTF-8 walking and one-line text elision (image export titles).
+// Language: C++17 (CMake build)
+//-------------------------------------------------------------------------------
+#include "text_fit.h"
+#include <algorithm>
+#include <vector>
+
+char32_t nextCodepoint(const std::string& s, size_t& i) {
+    const auto b0 = static_cast<unsigned char>(s[i++]);
+    if (b0 < 0x80) return b0;
+    const int extra = b0 >= 0xF8 ? -1 : b0 >= 0xF0 ? 3 : b0 >= 0xE0 ? 2 : b0 >= 0xC0 ? 1 : -1;
+    if (extra < 0 || i + extra > s.size()) return 0xFFFD;
+    char32_t c = b0 & (0x3F >> extra);
+    for (int k = 0; k < extra; ++k) {
+        const auto b = static_cast<unsigned char>(s[i + k]);
+        if ((b & 0xC0) != 0x80) return 0xFFFD;
+        c = (c << 6) | (b & 0x3F);
+    }
+    // Overlong forms, UTF-16 surrogates and values past U+10FFFF are malformed too
+    static const char32_t least[] = {0, 0x80, 0x800, 0x10000};
+    if (c < least[extra] || (c >= 0xD800 && c <= 0xDFFF) || c > 0x10FFFF) return 0xFFFD;
+    i += extra;
+    return c;
+}
+
+void appendUtf8(std::string& out, char32_t c) {
+    if (c < 0x80) {
+        out += static_cast<char>(c);
+    } else if (c < 0x800) {
+        out += static_cast<char>(0xC0 | (c >> 6));
+        out += static_cast<char>(0x80 | (c & 0x3F));
+    } else if (c < 0x10000) {
+        out += static_cast<char>(0xE0 | (c >> 12));
+        out += static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (c & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | (c >> 18));
+        out += static_cast<char>(0x80 | ((c >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (c & 0x3F));
+    }
+}
+
+std::string sanitizeUtf8(const std::string& s) {
+    std::string out;
+    out.reserve(s.size());
+    for (size_t i = 0; i < s.size();) appendUtf8(out, nextCodepoint(s, i));
+    return out;
+}
+
+bool extendsCharacter(char32_t c) {
+    return (c >= 0x0300 && c <= 0x036F) || (c >= 0x1AB0 && c <= 0x1AFF) || (c >= 0x1DC0 && c <= 0x1DFF) ||
+           (c >= 0x20D0 && c <= 0x20FF) || (c >= 0xFE00 && c <= 0xFE0F) || (c >= 0xFE20 && c <= 0xFE2F) ||
+           (c >= 0x1F3FB && c <= 0x1F3FF) || c == 0x200D;
+}
+
+std::string fitTextToWidth(const std::string& text, const std::string& suffix, double maxWidth,
+                           const std::function<double(char32_t)>& advance,
+                           const std::function<double(const std::string&)>& measure) {
+    std::string line = text + suffix;
+    if (measure(line) <= maxWidth) return line;
+
+    auto advanceOf = [&](const std::string& s) {
+        double sum = 0;
+        for (size_t i = 0; i < s.size();) sum += advance(nextCodepoint(s, i));
+        return sum;
+    };
+    static const std::string ellipsis = "…";
+    // Suffix too wide on its own: cut the whole line instead
+    std::string body = text, tail = ellipsis + suffix;
+    double budget = maxWidth - advanceOf(tail);
+    if (budget < 0) {
+        body = line;
+        tail = ellipsis;
+        budget = maxWidth - advanceOf(tail);
+    }
+
+    // Byte end and running advance at each character boundary
+    std::vector<size_t> ends{0};
+    std::vector<double> widths{0};
+    for (size_t i = 0; i < body.size();) {
+        double w = advance(nextCodepoint(body, i));
+        bool joined = false;   // the code point after a zero-width joiner stays too
+        while (i < body.size()) {
+            size_t next = i;
+            const char32_t c = nextCodepoint(body, next);
+            if (!joined && !extendsCharacter(c)) break;
+            joined = c == 0x200D;
+            w += advance(c);
+            i = next;
+        }
+        ends.push_back(i);
+        widths.push_back(widths.back() + w);
+    }
+    size_t keep = static_cast<size_t>(std::upper_bound(widths.begin(), widths.end(), budget) - widths.begin());
+    keep = keep ? keep - 1 : 0;
+
+    auto trimmedEnd = [&](size_t n) {
+        size_t end = ends[n];
+        while (end > 0 && body[end - 1] == ' ') --end;
+        return end;
+    };
+    auto cut = [&](size_t n) {
+        line = body.substr(0, trimmedEnd(n)) + tail;
+        return measure(line);
+    };
+    // Kerning and bearings can leave the advance sum a little short: drop one
+    // more character (a space alone would leave the same line)
+    if (cut(keep) > maxWidth && keep > 0) {
+        size_t shorter = keep - 1;
+        while (shorter > 0 && trimmedEnd(shorter) == trimmedEnd(keep)) --shorter;
+        cut(shorter);
+    }
+    return line;
+}
@@ -0,0 +1,71 @@
+// SPDX-License-Identifier: Apache-2.0
+//-------------------------------------------------------------------------------
+// Top100 — Your Personal Movie List
+//
+// File: lib/text_fit.h
+// Purpose: UTF-8 walking and one-line text elision (image export titles).
+// Language: C++17 (header)
+//-------------------------------------------------------------------------------
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <string>
+
+/**
+ * @brief Decode the code point of @p s starting at byte @p i.
+ * @param s UTF-8 text
+ * @param i Byte offset (< s.size()); advanced past the code point
+ * @return The code point, or U+FFFD for a malformed byte, overlong form,
+ *         surrogate or value past U+10FFFF (@p i then moves one byte)
+ * @ingroup services
+ */
+char32_t nextCodepoint(const std::string& s, size_t& i);
+
+/**
+ * @brief Append @p c to @p out as UTF-8.
+ * @param out Destination
+ * @param c Code point (<= U+10FFFF)
+ * @ingroup services
+ */
+void appendUtf8(std::string& out, char32_t c);
+
+/**
+ * @brief Replace malformed UTF-8 with U+FFFD (Cairo draws nothing of an invalid string).
+ * @param s Text of unknown validity
+ * @return Valid UTF-8, unchanged if @p s already was
+ * @ingroup services
+ */
+std::string sanitizeUtf8(const std::string& s);
+
+/**
+ * @brief Whether @p c is drawn as part of the character before it.
+ *
+ * Combining marks, variation selectors, emoji skin tones and the zero-width
+ * joiner: fitTextToWidth() never cuts in front of one.
+ * @ingroup services
+ */
+bool extendsCharacter(char32_t c);
+
+/**
+ * @brief @p text followed by @p suffix, elided with "…" to fit @p maxWidth.
+ *
+ * When the whole line is too wide, @p text is cut at the last character
+ * boundary whose summed @p advance values leave room for "…" and the suffix
+ * (a binary search over the running sums, no measuring), trailing spaces
+ * dropped. The cut is measured and, since kerning and bearings can leave the
+ * advance sum a little short, moved back one character if it still overflows.
+ * A line takes one @p measure call when it fits and two or three when it does
+ * not. When the suffix alone leaves no room, the whole line is cut instead.
+ *
+ * @param text Valid UTF-8 (see sanitizeUtf8()) that may be cut
+ * @param suffix Valid UTF-8 kept whole when there is room (e.g. " (1999)")
+ * @param maxWidth Width available
+ * @param advance Advance width of one code point
+ * @param measure Exact width of a string; the last string it is called with is the one returned
+ * @return The line to draw
+ * @ingroup services
+ */
+std::string fitTextToWidth(const std::string& text, const std::string& suffix, double maxWidth,
+                           const std::function<double(char32_t)>& advance,
+                           const std::function<double(const std::string&)>& measure);
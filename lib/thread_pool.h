@@ -0,0 +1,138 @@
+// SPDX-License-Identifier: Apache-2.0
+//-------------------------------------------------------------------------------
+// Top100 — Your Personal Movie List
+//
+// File: lib/thread_pool.h
+// Purpose: Small fixed-size worker pool (task futures + indexed parallel-for).
+// Language: C++17 (header)
+//-------------------------------------------------------------------------------
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @brief Fixed-size pool of worker threads.
+ *
+ * submit() queues a callable and returns a std::future for its result.
+ * parallelFor() splits an index range across the workers and passes each call
+ * the worker slot it runs on (0..threadCount()-1), so callers can keep one
+ * scratch workspace per worker instead of allocating per item.
+ *
+ * @ingroup core
+ */
+class ThreadPool {
+public:
+    /** @brief Start @p threads workers (0 = one per hardware thread).
+     *  @param threads Worker count */
+    explicit ThreadPool(size_t threads = 0) {
+        if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+        workers_.reserve(threads);
+        for (size_t i = 0; i < threads; ++i) workers_.emplace_back([this]() { run(); });
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        cv_.notify_all();
+        for (auto& t : workers_) t.join();
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /** @return Number of worker threads. */
+    size_t threadCount() const { return workers_.size(); }
+
+    /** @return true when called from one of this pool's workers (waiting there on
+     *  tasks queued to the same pool can deadlock). */
+    bool onWorker() const { return currentPool() == this; }
+
+    /**
+     * @brief Queue a task.
+     * @param f Callable taking no arguments
+     * @return Future for the callable's result (exceptions are propagated)
+     */
+    template <class F>
+    auto submit(F&& f) -> std::future<std::invoke_result_t<std::decay_t<F>>> {
+        using R = std::invoke_result_t<std::decay_t<F>>;
+        auto task = std::make_shared<std::packaged_task<R()>>(std::forward<F>(f));
+        std::future<R> fut = task->get_future();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            queue_.emplace_back([task]() { (*task)(); });
+        }
+        cv_.notify_one();
+        return fut;
+    }
+
+    /**
+     * @brief Run body(index, worker) for every index in [0, count) and wait.
+     * @param count Number of items
+     * @param body Callable (size_t index, size_t worker); worker < threadCount()
+     * @note Items are handed out dynamically, so uneven item costs balance out.
+     */
+    template <class Body>
+    void parallelFor(size_t count, Body&& body) {
+        if (count == 0) return;
+        const size_t slots = std::min(count, threadCount());
+        auto next = std::make_shared<std::atomic<size_t>>(0);
+        std::vector<std::future<void>> done;
+        done.reserve(slots);
+        for (size_t w = 0; w < slots; ++w) {
+            done.push_back(submit([next, count, w, &body]() {
+                for (size_t i = next->fetch_add(1); i < count; i = next->fetch_add(1)) body(i, w);
+            }));
+        }
+        for (auto& f : done) f.get();
+    }
+
+private:
+    static const ThreadPool*& currentPool() {
+        static thread_local const ThreadPool* pool = nullptr;
+        return pool;
+    }
+
+    void run() {
+        currentPool() = this;
+        for (;;) {
+            std::function<void()> job;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                cv_.wait(lock, [this]() { return stopping_ || !queue_.empty(); });
+                if (stopping_ && queue_.empty()) return;
+                job = std::move(queue_.front());
+                queue_.pop_front();
+            }
+            job();
+        }
+    }
+
+    std::vector<std::thread> workers_;
+    std::deque<std::function<void()>> queue_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stopping_ = false;
+};
+
+/**
+ * @brief Process-wide pool sized to the hardware, created on first use.
+ * @return Shared pool
+ * @ingroup core
+ */
+inline ThreadPool& sharedThreadPool() {
+    static ThreadPool pool;
+    return pool;
+}
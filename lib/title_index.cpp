@@ -0,0 +1,853 @@
+// SPDX-License-Identifier: Apache-2.0
+//-------------------------------------------------------------------------------
+// Top100 — Your Personal Movie List
+//
+// File: lib/title_index.cpp
+// Purpose: IMDb dataset importer and the memory-mapped title index it writes.
+// Language: C++17 (CMake build)
+//-------------------------------------------------------------------------------
+#include "title_index.h"
+#include "config.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <sys/stat.h>
+#include <thread>
+#if TOP100_HAVE_ZLIB
+#include <zlib.h>
+#endif
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+// --- File layout -------------------------------------------------------------
+//
+// [FileHeader][TitleRecord x titleCount][GramRecord x gramCount]
+// [uint32 row x postingCount][string blob]
+//
+// Titles are sorted by numeric IMDb ID. Each gram record lists the rows whose
+// titles contain that trigram (ascending). Strings are NUL-terminated; offset 0
+// is the empty string. Integers are in host byte order (checked on open).
+
+namespace {
+
+constexpr char kMagic[8] = {'T', '1', '0', '0', 'T', 'I', 'X', '1'};
+constexpr uint32_t kVersion = 1;
+constexpr uint32_t kByteOrder = 0x01020304;
+constexpr char kListSep = '\x1f';  // between genres / cast members
+
+struct FileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint64_t titleCount;
+    uint64_t titlesOffset;
+    uint64_t gramCount;
+    uint64_t gramsOffset;
+    uint64_t postingCount;
+    uint64_t postingsOffset;
+    uint64_t stringsSize;
+    uint64_t stringsOffset;
+    int64_t builtAt;
+};
+
+struct TitleRecord {
+    uint32_t id;         // numeric part of the tconst
+    uint16_t year;
+    uint16_t runtime;    // minutes
+    uint32_t votes;
+    uint16_t rating;     // IMDb rating x10 (0 = unrated)
+    uint16_t grams;      // distinct trigrams of the titles, for scoring
+    uint32_t title;      // string offsets
+    uint32_t genres;
+    uint32_t directors;
+    uint32_t cast;
+};
+static_assert(sizeof(TitleRecord) == 32, "TitleRecord is part of the file format");
+
+struct GramRecord {
+    uint32_t gram;
+    uint32_t count;
+    uint64_t first;      // index of the first posting
+};
+static_assert(sizeof(GramRecord) == 16, "GramRecord is part of the file format");
+
+// --- Text helpers ------------------------------------------------------------
+
+// Lowercase ASCII letters and digits; everything else separates words. Bytes
+// of multi-byte UTF-8 characters are kept as they are. Padded with a space at
+// each end so word starts and ends make their own trigrams.
+std::string searchText(const std::string& s) {
+    std::string out(1, ' ');
+    for (unsigned char c : s) {
+        if (c >= 0x80 || std::isalnum(c)) {
+            out += static_cast<char>(c < 0x80 ? std::tolower(c) : c);
+        } else if (out.back() != ' ') {
+            out += ' ';
+        }
+    }
+    if (out.back() != ' ') out += ' ';
+    return out;
+}
+
+// Appends the trigrams of searchText() output; the caller sorts and dedupes
+void appendGrams(const std::string& text, std::vector<uint32_t>& out) {
+    for (size_t i = 0; i + 3 <= text.size(); ++i) {
+        const auto b = [&](size_t k) { return static_cast<uint32_t>(static_cast<unsigned char>(text[i + k])); };
+        out.push_back(b(0) << 16 | b(1) << 8 | b(2));
+    }
+}
+
+void sortUnique(std::vector<uint32_t>& v) {
+    std::sort(v.begin(), v.end());
+    v.erase(std::unique(v.begin(), v.end()), v.end());
+}
+
+// "tt0133093" / "nm0000206" -> 133093 / 206; 0 if malformed (also for the header row)
+uint32_t parseId(const char* b, const char* e, char p0, char p1) {
+    if (e - b < 3 || std::tolower(static_cast<unsigned char>(b[0])) != p0 ||
+        std::tolower(static_cast<unsigned char>(b[1])) != p1) return 0;
+    uint64_t v = 0;
+    for (const char* p = b + 2; p < e; ++p) {
+        if (*p < '0' || *p > '9') return 0;
+        v = v * 10 + static_cast<uint64_t>(*p - '0');
+        if (v > UINT32_MAX) return 0;
+    }
+    return static_cast<uint32_t>(v);
+}
+
+uint32_t parseId(const std::string& s, char p0, char p1) {
+    const size_t b = s.find_first_not_of(" \t\r\n");
+    const size_t e = s.find_last_not_of(" \t\r\n");
+    if (b == std::string::npos) return 0;
+    return parseId(s.data() + b, s.data() + e + 1, p0, p1);
+}
+
+// Unsigned decimal; \N (null) and junk give 0
+uint32_t parseUint(const char* b, const char* e) {
+    uint32_t v = 0;
+    for (const char* p = b; p < e; ++p) {
+        if (*p < '0' || *p > '9') return 0;
+        v = v * 10 + static_cast<uint32_t>(*p - '0');
+    }
+    return v;
+}
+
+// "7.8" -> 78
+uint16_t parseRating(const char* b, const char* e) {
+    uint32_t whole = 0, tenth = 0;
+    const char* p = b;
+    for (; p < e && *p >= '0' && *p <= '9'; ++p) whole = whole * 10 + static_cast<uint32_t>(*p - '0');
+    if (p < e && *p == '.' && p + 1 < e && p[1] >= '0' && p[1] <= '9') tenth = static_cast<uint32_t>(p[1] - '0');
+    return static_cast<uint16_t>(std::min<uint32_t>(whole * 10 + tenth, 100));
+}
+
+bool isNull(const char* b, const char* e) {
+    return e - b == 2 && b[0] == '\\' && b[1] == 'N';
+}
+
+// Splits one TSV line into at most N fields; @return fields found
+template <size_t N>
+size_t splitTsv(const char* b, const char* e, const char* (&fb)[N], const char* (&fe)[N]) {
+    size_t n = 0;
+    while (n < N) {
+        const char* tab = static_cast<const char*>(std::memchr(b, '\t', static_cast<size_t>(e - b)));
+        fb[n] = b;
+        fe[n] = tab ? tab : e;
+        ++n;
+        if (!tab) break;
+        b = tab + 1;
+    }
+    return n;
+}
+
+// Calls line(begin, end) for each line of a chunk (without '\n' / '\r')
+template <class Line>
+void forEachLine(const std::string& chunk, Line line) {
+    const char* p = chunk.data();
+    const char* end = p + chunk.size();
+    while (p < end) {
+        const char* nl = static_cast<const char*>(std::memchr(p, '\n', static_cast<size_t>(end - p)));
+        const char* e = nl ? nl : end;
+        line(p, (e > p && e[-1] == '\r') ? e - 1 : e);
+        p = nl ? nl + 1 : end;
+    }
+}
+
+std::vector<std::string> splitList(const char* s, char sep) {
+    std::vector<std::string> out;
+    if (!*s) return out;
+    for (const char* p = s;;) {
+        const char* q = std::strchr(p, sep);
+        if (!q) {
+            out.emplace_back(p);
+            return out;
+        }
+        out.emplace_back(p, q);
+        p = q + 1;
+    }
+}
+
+uint64_t fileSize(const std::string& path) {
+    struct stat st {};
+    return ::stat(path.c_str(), &st) == 0 ? static_cast<uint64_t>(st.st_size) : 0;
+}
+
+bool fileExists(const std::string& path) {
+    struct stat st {};
+    return ::stat(path.c_str(), &st) == 0;
+}
+
+// --- Streaming input ---------------------------------------------------------
+
+// Decompressed file contents in chunks that end on a line boundary
+class ChunkReader {
+public:
+    explicit ChunkReader(const std::string& path) : size_(fileSize(path)) {
+#if TOP100_HAVE_ZLIB
+        // gzread passes plain files through unchanged
+        file_ = gzopen(path.c_str(), "rb");
+        if (file_) gzbuffer(file_, 256 * 1024);
+#else
+        if (path.size() < 3 || path.compare(path.size() - 3, 3, ".gz") != 0) file_ = std::fopen(path.c_str(), "rb");
+#endif
+    }
+    ~ChunkReader() {
+#if TOP100_HAVE_ZLIB
+        if (file_) gzclose(file_);
+#else
+        if (file_) std::fclose(file_);
+#endif
+    }
+    ChunkReader(const ChunkReader&) = delete;
+    ChunkReader& operator=(const ChunkReader&) = delete;
+
+    bool isOpen() const { return file_ != nullptr; }
+    bool failed() const { return failed_; }
+    uint64_t size() const { return size_; }
+
+    /** @return Compressed bytes consumed so far */
+    uint64_t bytesRead() const {
+#if TOP100_HAVE_ZLIB
+        const auto off = gzoffset(file_);
+        return off > 0 ? static_cast<uint64_t>(off) : 0;
+#else
+        const long off = std::ftell(file_);
+        return off > 0 ? static_cast<uint64_t>(off) : 0;
+#endif
+    }
+
+    /**
+     * @brief Next run of whole lines, about @p bytes long.
+     * @return false at the end of the file or on a read error
+     */
+    bool next(std::string& chunk, size_t bytes) {
+        chunk.swap(carry_);
+        carry_.clear();
+        for (;;) {
+            const size_t have = chunk.size();
+            chunk.resize(have + bytes);
+            const long n = read(&chunk[have], bytes);
+            if (n < 0) {
+                failed_ = true;
+                chunk.clear();
+                return false;
+            }
+            chunk.resize(have + static_cast<size_t>(n));
+            if (n == 0) return !chunk.empty();  // last line without '\n'
+            const size_t nl = chunk.rfind('\n');
+            if (nl == std::string::npos) continue;  // line longer than a chunk
+            carry_.assign(chunk, nl + 1, std::string::npos);
+            chunk.resize(nl + 1);
+            return true;
+        }
+    }
+
+private:
+    long read(char* out, size_t bytes) {
+#if TOP100_HAVE_ZLIB
+        return gzread(file_, out, static_cast<unsigned>(std::min<size_t>(bytes, 1u << 30)));
+#else
+        const size_t n = std::fread(out, 1, bytes, file_);
+        return (n == 0 && std::ferror(file_)) ? -1 : static_cast<long>(n);
+#endif
+    }
+
+#if TOP100_HAVE_ZLIB
+    gzFile file_ = nullptr;
+#else
+    std::FILE* file_ = nullptr;
+#endif
+    uint64_t size_ = 0;
+    std::string carry_;
+    bool failed_ = false;
+};
+
+bool cancelled(const ImdbImportOptions& opts) {
+    return opts.cancel && opts.cancel->load();
+}
+
+// Read @p path on the calling thread and run parse(chunk) -> rows on the pool.
+// At most two chunks per worker are held at once. @return empty, or an error
+template <class Parse>
+std::string forEachChunk(const std::string& path, const char* stage, ThreadPool& pool,
+                         const ImdbImportOptions& opts, Parse parse) {
+    ChunkReader in(path);
+    if (!in.isOpen()) return "cannot open " + path;
+    std::mutex mutex;
+    std::condition_variable cv;
+    size_t inFlight = 0;
+    uint64_t rows = 0;
+    bool parseFailed = false;
+    const size_t maxInFlight = 2 * pool.threadCount();
+    ImdbImportProgress progress;
+    progress.stage = stage;
+    progress.bytesTotal = in.size();
+    std::string chunk;
+    while (!cancelled(opts) && in.next(chunk, std::max<size_t>(opts.chunkBytes, 4096))) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            cv.wait(lock, [&]() { return inFlight < maxInFlight; });
+            ++inFlight;
+            progress.rows = rows;
+        }
+        auto data = std::make_shared<std::string>(std::move(chunk));
+        chunk = std::string();
+        pool.submit([&, data]() {
+            size_t n = 0;
+            bool ok = true;
+            try { n = parse(*data); } catch (...) { ok = false; }
+            std::lock_guard<std::mutex> lock(mutex);
+            rows += n;
+            parseFailed = parseFailed || !ok;
+            --inFlight;
+            cv.notify_all();
+        });
+        progress.bytesRead = in.bytesRead();
+        if (opts.onProgress) opts.onProgress(progress);
+    }
+    std::unique_lock<std::mutex> lock(mutex);
+    cv.wait(lock, [&]() { return inFlight == 0; });
+    progress.rows = rows;
+    progress.bytesRead = in.bytesRead();
+    if (opts.onProgress && !cancelled(opts)) opts.onProgress(progress);
+    if (in.failed()) return "read error in " + path;
+    if (parseFailed) return "out of memory while parsing " + path;
+    return std::string();
+}
+
+// --- Import ------------------------------------------------------------------
+
+struct ImportTitle {
+    uint32_t id = 0;
+    uint16_t year = 0;
+    uint16_t runtime = 0;
+    std::string title;
+    std::string original;  // empty when equal to title
+    std::string genres;    // kListSep-separated
+};
+
+struct Credit {
+    uint32_t row;
+    uint32_t person;
+    uint16_t ordering;
+    bool director;
+};
+
+// Lower-bound position of @p id in a sorted id list, or npos if absent
+template <class T, class Id>
+size_t findSorted(const std::vector<T>& v, uint32_t id, Id idOf) {
+    auto it = std::lower_bound(v.begin(), v.end(), id, [&](const T& x, uint32_t k) { return idOf(x) < k; });
+    return (it != v.end() && idOf(*it) == id) ? static_cast<size_t>(it - v.begin()) : std::string::npos;
+}
+
+// Append-only string blob; offset 0 is the empty string
+class StringBlob {
+public:
+    StringBlob() : data_(1, '\0') {}
+    uint32_t add(const std::string& s) {
+        if (s.empty()) return 0;
+        const size_t off = data_.size();
+        if (off + s.size() + 1 > UINT32_MAX) {
+            overflow_ = true;
+            return 0;
+        }
+        data_ += s;
+        data_ += '\0';
+        return static_cast<uint32_t>(off);
+    }
+    const std::string& data() const { return data_; }
+    bool overflow() const { return overflow_; }
+
+private:
+    std::string data_;
+    bool overflow_ = false;
+};
+
+template <class T>
+void writeArray(std::ofstream& out, const std::vector<T>& v) {
+    if (!v.empty()) out.write(reinterpret_cast<const char*>(v.data()), static_cast<std::streamsize>(v.size() * sizeof(T)));
+}
+
+} // namespace
+
+ImdbImportResult importImdbDatasets(const ImdbImportOptions& opts, const std::string& indexPath) {
+    ImdbImportResult result;
+    if (opts.basicsPath.empty()) {
+        result.error = "title.basics is required";
+        return result;
+    }
+    ThreadPool pool(opts.threads);
+    std::mutex merge;
+
+    // 1) title.basics: tconst titleType primaryTitle originalTitle isAdult startYear endYear runtimeMinutes genres
+    std::vector<ImportTitle> titles;
+    std::string err = forEachChunk(opts.basicsPath, "title.basics", pool, opts, [&](const std::string& chunk) {
+        std::vector<ImportTitle> local;
+        size_t rows = 0;
+        forEachLine(chunk, [&](const char* b, const char* e) {
+            const char* fb[9];
+            const char* fe[9];
+            if (splitTsv(b, e, fb, fe) < 9) return;
+            ++rows;
+            const uint32_t id = parseId(fb[0], fe[0], 't', 't');
+            if (!id) return;
+            const std::string type(fb[1], fe[1]);
+            if (std::find(opts.titleTypes.begin(), opts.titleTypes.end(), type) == opts.titleTypes.end()) return;
+            if (!opts.includeAdult && fe[4] - fb[4] == 1 && *fb[4] == '1') return;
+            ImportTitle t;
+            t.id = id;
+            t.year = static_cast<uint16_t>(std::min<uint32_t>(parseUint(fb[5], fe[5]), UINT16_MAX));
+            t.runtime = static_cast<uint16_t>(std::min<uint32_t>(parseUint(fb[7], fe[7]), UINT16_MAX));
+            t.title.assign(fb[2], fe[2]);
+            if (!isNull(fb[3], fe[3]) && !std::equal(fb[3], fe[3], t.title.begin(), t.title.end())) t.original.assign(fb[3], fe[3]);
+            if (!isNull(fb[8], fe[8])) {
+                t.genres.assign(fb[8], fe[8]);
+                std::replace(t.genres.begin(), t.genres.end(), ',', kListSep);
+            }
+            local.push_back(std::move(t));
+        });
+        std::lock_guard<std::mutex> lock(merge);
+        titles.insert(titles.end(), std::make_move_iterator(local.begin()), std::make_move_iterator(local.end()));
+        return rows;
+    });
+    if (err.empty() && cancelled(opts)) err = "cancelled";
+    if (!err.empty()) {
+        result.error = err;
+        return result;
+    }
+    std::sort(titles.begin(), titles.end(), [](const ImportTitle& a, const ImportTitle& b) { return a.id < b.id; });
+    titles.erase(std::unique(titles.begin(), titles.end(),
+                             [](const ImportTitle& a, const ImportTitle& b) { return a.id == b.id; }),
+                 titles.end());
+    const auto titleId = [](const ImportTitle& t) { return t.id; };
+
+    // 2) title.ratings and title.principals, read side by side. Each tconst has
+    // one ratings row, so rows write distinct slots without locking.
+    std::vector<uint16_t> ratings(titles.size(), 0);
+    std::vector<uint32_t> votes(titles.size(), 0);
+    std::vector<Credit> credits;
+    const bool withCredits = !opts.principalsPath.empty() && !opts.namesPath.empty();
+    std::string ratingsErr, creditsErr;
+    std::thread principalsReader;
+    if (withCredits) {
+        principalsReader = std::thread([&]() {
+            // tconst ordering nconst category job characters
+            creditsErr = forEachChunk(opts.principalsPath, "title.principals", pool, opts, [&](const std::string& chunk) {
+                std::vector<Credit> local;
+                size_t rows = 0;
+                forEachLine(chunk, [&](const char* b, const char* e) {
+                    const char* fb[4];
+                    const char* fe[4];
+                    if (splitTsv(b, e, fb, fe) < 4) return;
+                    ++rows;
+                    const std::string category(fb[3], fe[3]);
+                    const bool director = category == "director";
+                    if (!director && category != "actor" && category != "actress") return;
+                    const size_t row = findSorted(titles, parseId(fb[0], fe[0], 't', 't'), titleId);
+                    const uint32_t person = parseId(fb[2], fe[2], 'n', 'm');
+                    if (row == std::string::npos || !person) return;
+                    const uint32_t ordering = std::min<uint32_t>(parseUint(fb[1], fe[1]), UINT16_MAX);
+                    local.push_back(Credit{static_cast<uint32_t>(row), person, static_cast<uint16_t>(ordering), director});
+                });
+                std::lock_guard<std::mutex> lock(merge);
+                credits.insert(credits.end(), local.begin(), local.end());
+                return rows;
+            });
+        });
+    }
+    if (!opts.ratingsPath.empty()) {
+        // tconst averageRating numVotes
+        ratingsErr = forEachChunk(opts.ratingsPath, "title.ratings", pool, opts, [&](const std::string& chunk) {
+            size_t rows = 0;
+            forEachLine(chunk, [&](const char* b, const char* e) {
+                const char* fb[3];
+                const char* fe[3];
+                if (splitTsv(b, e, fb, fe) < 3) return;
+                ++rows;
+                const size_t row = findSorted(titles, parseId(fb[0], fe[0], 't', 't'), titleId);
+                if (row == std::string::npos) return;
+                ratings[row] = parseRating(fb[1], fe[1]);
+                votes[row] = parseUint(fb[2], fe[2]);
+            });
+            return rows;
+        });
+    }
+    if (principalsReader.joinable()) principalsReader.join();
+    err = !ratingsErr.empty() ? ratingsErr : creditsErr;
+    if (err.empty() && cancelled(opts)) err = "cancelled";
+    if (!err.empty()) {
+        result.error = err;
+        return result;
+    }
+
+    // 3) name.basics, keeping only the people credited above: nconst primaryName ...
+    std::vector<uint32_t> people;
+    people.reserve(credits.size());
+    for (const Credit& c : credits) people.push_back(c.person);
+    sortUnique(people);
+    std::vector<std::string> names(people.size());
+    if (withCredits && !people.empty()) {
+        err = forEachChunk(opts.namesPath, "name.basics", pool, opts, [&](const std::string& chunk) {
+            size_t rows = 0;
+            forEachLine(chunk, [&](const char* b, const char* e) {
+                const char* fb[2];
+                const char* fe[2];
+                if (splitTsv(b, e, fb, fe) < 2) return;
+                ++rows;
+                const size_t i = findSorted(people, parseId(fb[0], fe[0], 'n', 'm'), [](uint32_t p) { return p; });
+                if (i != std::string::npos && !isNull(fb[1], fe[1])) names[i].assign(fb[1], fe[1]);
+            });
+            return rows;
+        });
+        if (err.empty() && cancelled(opts)) err = "cancelled";
+        if (!err.empty()) {
+            result.error = err;
+            return result;
+        }
+    }
+
+    // 4) Records and the trigram postings, built in parallel over row blocks
+    if (opts.onProgress) {
+        ImdbImportProgress progress;
+        progress.stage = "index";
+        progress.rows = titles.size();
+        opts.onProgress(progress);
+    }
+    std::sort(credits.begin(), credits.end(), [](const Credit& a, const Credit& b) {
+        if (a.row != b.row) return a.row < b.row;
+        if (a.director != b.director) return a.director;
+        return a.ordering < b.ordering;
+    });
+    std::vector<size_t> creditStart(titles.size() + 1, 0);
+    for (const Credit& c : credits) ++creditStart[c.row + 1];
+    for (size_t r = 0; r < titles.size(); ++r) creditStart[r + 1] += creditStart[r];
+
+    const auto nameOf = [&](uint32_t person) -> const std::string& {
+        static const std::string none;
+        const size_t i = findSorted(people, person, [](uint32_t p) { return p; });
+        return i == std::string::npos ? none : names[i];
+    };
+
+    std::vector<TitleRecord> records(titles.size());
+    std::vector<std::string> directorsOf(titles.size()), castOf(titles.size());
+    constexpr size_t kBlock = 4096;
+    const size_t blocks = (titles.size() + kBlock - 1) / kBlock;
+    std::vector<std::vector<uint64_t>> pairs(pool.threadCount());  // gram << 32 | row, per worker
+    pool.parallelFor(blocks, [&](size_t block, size_t worker) {
+        std::vector<uint32_t> grams;
+        const size_t end = std::min(titles.size(), (block + 1) * kBlock);
+        for (size_t r = block * kBlock; r < end; ++r) {
+            const ImportTitle& t = titles[r];
+            TitleRecord& rec = records[r];
+            rec.id = t.id;
+            rec.year = t.year;
+            rec.runtime = t.runtime;
+            rec.rating = ratings[r];
+            rec.votes = votes[r];
+            size_t actors = 0;
+            for (size_t i = creditStart[r]; i < creditStart[r + 1]; ++i) {
+                const std::string& name = nameOf(credits[i].person);
+                if (name.empty()) continue;
+                if (credits[i].director) {
+                    if (!directorsOf[r].empty()) directorsOf[r] += ", ";
+                    directorsOf[r] += name;
+                } else if (actors < opts.maxActors) {
+                    if (actors++) castOf[r] += kListSep;
+                    castOf[r] += name;
+                }
+            }
+            grams.clear();
+            appendGrams(searchText(t.title), grams);
+            if (!t.original.empty()) appendGrams(searchText(t.original), grams);
+            sortUnique(grams);
+            rec.grams = static_cast<uint16_t>(std::min<size_t>(grams.size(), UINT16_MAX));
+            for (uint32_t g : grams) pairs[worker].push_back(static_cast<uint64_t>(g) << 32 | r);
+        }
+    });
+    std::vector<uint64_t> all;
+    size_t total = 0;
+    for (const auto& p : pairs) total += p.size();
+    all.reserve(total);
+    for (auto& p : pairs) {
+        all.insert(all.end(), p.begin(), p.end());
+        std::vector<uint64_t>().swap(p);
+    }
+    std::sort(all.begin(), all.end());
+    std::vector<GramRecord> grams;
+    std::vector<uint32_t> postings(all.size());
+    for (size_t i = 0; i < all.size(); ++i) {
+        const uint32_t g = static_cast<uint32_t>(all[i] >> 32);
+        if (grams.empty() || grams.back().gram != g) grams.push_back(GramRecord{g, 0, i});
+        ++grams.back().count;
+        postings[i] = static_cast<uint32_t>(all[i]);
+    }
+    std::vector<uint64_t>().swap(all);
+
+    // Strings in row order (sequential, so the blob is deterministic)
+    StringBlob blob;
+    for (size_t r = 0; r < titles.size(); ++r) {
+        records[r].title = blob.add(titles[r].title);
+        records[r].genres = blob.add(titles[r].genres);
+        records[r].directors = blob.add(directorsOf[r]);
+        records[r].cast = blob.add(castOf[r]);
+        if (records[r].rating > 0) ++result.rated;
+        if (!directorsOf[r].empty() || !castOf[r].empty()) ++result.credited;
+    }
+    if (blob.overflow()) {
+        result.error = "too much text for one index file";
+        return result;
+    }
+
+    // 5) Write beside the target, then rename into place
+    FileHeader h{};
+    std::memcpy(h.magic, kMagic, sizeof(kMagic));
+    h.version = kVersion;
+    h.byteOrder = kByteOrder;
+    h.titleCount = records.size();
+    h.titlesOffset = sizeof(FileHeader);
+    h.gramCount = grams.size();
+    h.gramsOffset = h.titlesOffset + records.size() * sizeof(TitleRecord);
+    h.postingCount = postings.size();
+    h.postingsOffset = h.gramsOffset + grams.size() * sizeof(GramRecord);
+    h.stringsOffset = h.postingsOffset + postings.size() * sizeof(uint32_t);
+    h.stringsSize = blob.data().size();
+    h.builtAt = static_cast<int64_t>(std::time(nullptr));
+    const std::string tmp = indexPath + ".tmp";
+    {
+        std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            result.error = "cannot write " + tmp;
+            return result;
+        }
+        out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+        writeArray(out, records);
+        writeArray(out, grams);
+        writeArray(out, postings);
+        out.write(blob.data().data(), static_cast<std::streamsize>(blob.data().size()));
+        if (!out.flush()) {
+            result.error = "cannot write " + tmp;
+            std::remove(tmp.c_str());
+            return result;
+        }
+    }
+#if defined(_WIN32)
+    std::remove(indexPath.c_str());
+#endif
+    if (std::rename(tmp.c_str(), indexPath.c_str()) != 0) {
+        result.error = "cannot replace " + indexPath;
+        std::remove(tmp.c_str());
+        return result;
+    }
+    result.ok = true;
+    result.titles = records.size();
+    return result;
+}
+
+ImdbImportOptions imdbImportOptionsForDir(const std::string& dir) {
+    const auto find = [&dir](const char* name) {
+        const std::string base = dir.empty() ? std::string(name) : dir + "/" + name;
+        if (fileExists(base + ".gz")) return base + ".gz";
+        return fileExists(base) ? base : std::string();
+    };
+    ImdbImportOptions opts;
+    opts.basicsPath = find("title.basics.tsv");
+    opts.ratingsPath = find("title.ratings.tsv");
+    opts.principalsPath = find("title.principals.tsv");
+    opts.namesPath = find("name.basics.tsv");
+    return opts;
+}
+
+// --- Reading -----------------------------------------------------------------
+
+struct TitleIndex::Mapping {
+    const char* base = nullptr;
+    size_t size = 0;
+#if defined(_WIN32)
+    std::string data;  // read whole; no mmap here
+#endif
+    const FileHeader* header = nullptr;
+    const TitleRecord* titles = nullptr;
+    const GramRecord* grams = nullptr;
+    const uint32_t* postings = nullptr;
+    const char* strings = nullptr;
+
+    ~Mapping() {
+#if !defined(_WIN32)
+        if (base) ::munmap(const_cast<char*>(base), size);
+#endif
+    }
+
+    const char* str(uint32_t off) const { return off < header->stringsSize ? strings + off : ""; }
+};
+
+std::shared_ptr<TitleIndex> TitleIndex::open(const std::string& path) {
+    auto m = std::make_unique<Mapping>();
+#if defined(_WIN32)
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return nullptr;
+    m->data.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    m->base = m->data.data();
+    m->size = m->data.size();
+#else
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return nullptr;
+    struct stat st {};
+    if (::fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(FileHeader))) {
+        ::close(fd);
+        return nullptr;
+    }
+    void* p = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);  // the mapping keeps the file open
+    if (p == MAP_FAILED) return nullptr;
+    m->base = static_cast<const char*>(p);
+    m->size = static_cast<size_t>(st.st_size);
+#endif
+    if (m->size < sizeof(FileHeader)) return nullptr;
+    const auto* h = reinterpret_cast<const FileHeader*>(m->base);
+    const auto fits = [&](uint64_t off, uint64_t count, uint64_t each) {
+        return off <= m->size && (each == 0 || count <= (m->size - off) / each) && off % 4 == 0;
+    };
+    if (std::memcmp(h->magic, kMagic, sizeof(kMagic)) != 0 || h->version != kVersion || h->byteOrder != kByteOrder ||
+        !fits(h->titlesOffset, h->titleCount, sizeof(TitleRecord)) ||
+        !fits(h->gramsOffset, h->gramCount, sizeof(GramRecord)) ||
+        !fits(h->postingsOffset, h->postingCount, sizeof(uint32_t)) || h->stringsSize == 0 ||
+        h->stringsOffset > m->size || h->stringsSize > m->size - h->stringsOffset ||
+        m->base[h->stringsOffset + h->stringsSize - 1] != '\0') {
+        return nullptr;
+    }
+    m->header = h;
+    m->titles = reinterpret_cast<const TitleRecord*>(m->base + h->titlesOffset);
+    m->grams = reinterpret_cast<const GramRecord*>(m->base + h->gramsOffset);
+    m->postings = reinterpret_cast<const uint32_t*>(m->base + h->postingsOffset);
+    m->strings = m->base + h->stringsOffset;
+    for (uint64_t g = 0; g < h->gramCount; ++g) {
+        if (m->grams[g].first > h->postingCount || m->grams[g].count > h->postingCount - m->grams[g].first) return nullptr;
+    }
+    std::shared_ptr<TitleIndex> index(new TitleIndex());
+    index->map_ = std::move(m);
+    return index;
+}
+
+TitleIndex::~TitleIndex() = default;
+
+size_t TitleIndex::size() const {
+    return static_cast<size_t>(map_->header->titleCount);
+}
+
+long long TitleIndex::builtAt() const {
+    return map_->header->builtAt;
+}
+
+std::optional<Movie> TitleIndex::get(const std::string& imdbID) const {
+    const uint32_t id = parseId(imdbID, 't', 't');
+    if (!id) return std::nullopt;
+    const TitleRecord* begin = map_->titles;
+    const TitleRecord* end = begin + map_->header->titleCount;
+    const TitleRecord* rec = std::lower_bound(begin, end, id, [](const TitleRecord& r, uint32_t k) { return r.id < k; });
+    if (rec == end || rec->id != id) return std::nullopt;
+    char idText[16];
+    std::snprintf(idText, sizeof(idText), "tt%07u", static_cast<unsigned>(rec->id));
+    Movie m;
+    m.title = map_->str(rec->title);
+    m.year = rec->year;
+    m.director = map_->str(rec->directors);
+    m.actors = splitList(map_->str(rec->cast), kListSep);
+    m.genres = splitList(map_->str(rec->genres), kListSep);
+    m.runtimeMinutes = rec->runtime;
+    m.imdbRating = rec->rating / 10.0;
+    m.imdbID = idText;
+    m.source = "imdb";
+    return m;
+}
+
+OmdbSearchPage TitleIndex::search(const std::string& query, size_t offset, size_t limit) const {
+    OmdbSearchPage page;
+    std::vector<uint32_t> q;
+    appendGrams(searchText(query.substr(0, 200)), q);
+    sortUnique(q);
+    if (q.empty()) return page;
+
+    // Shared trigrams per title (queries are short, so a byte never overflows)
+    const size_t n = size();
+    std::vector<uint8_t> shared(n, 0);
+    std::vector<uint32_t> touched;
+    const GramRecord* gbegin = map_->grams;
+    const GramRecord* gend = gbegin + map_->header->gramCount;
+    for (uint32_t g : q) {
+        const GramRecord* rec = std::lower_bound(gbegin, gend, g, [](const GramRecord& r, uint32_t k) { return r.gram < k; });
+        if (rec == gend || rec->gram != g) continue;
+        const uint32_t* p = map_->postings + rec->first;
+        for (uint32_t i = 0; i < rec->count; ++i) {
+            if (p[i] >= n) continue;
+            if (shared[p[i]]++ == 0) touched.push_back(p[i]);
+        }
+    }
+
+    // A title matches when it has at least half of the query's trigrams.
+    // Score: query coverage first, then closeness in length (Dice), then popularity.
+    const size_t need = std::max<size_t>(1, (q.size() + 1) / 2);
+    std::vector<std::pair<double, uint32_t>> scored;
+    for (uint32_t r : touched) {
+        if (shared[r] < need) continue;
+        const TitleRecord& rec = map_->titles[r];
+        const double coverage = static_cast<double>(shared[r]) / q.size();
+        const double dice = 2.0 * shared[r] / (q.size() + std::max<size_t>(rec.grams, shared[r]));
+        scored.emplace_back(coverage + 0.5 * dice + 0.05 * std::log10(1.0 + rec.votes), r);
+    }
+    page.totalResults = scored.size();
+    if (offset >= scored.size()) return page;
+    const size_t stop = std::min(scored.size(), offset + limit);
+    const auto better = [this](const std::pair<double, uint32_t>& a, const std::pair<double, uint32_t>& b) {
+        if (a.first != b.first) return a.first > b.first;
+        return map_->titles[a.second].id < map_->titles[b.second].id;
+    };
+    std::partial_sort(scored.begin(), scored.begin() + static_cast<std::ptrdiff_t>(stop), scored.end(), better);
+    for (size_t i = offset; i < stop; ++i) {
+        const TitleRecord& rec = map_->titles[scored[i].second];
+        char idText[16];
+        std::snprintf(idText, sizeof(idText), "tt%07u", static_cast<unsigned>(rec.id));
+        OmdbSearchResult hit;
+        hit.title = map_->str(rec.title);
+        hit.year = rec.year;
+        hit.imdbID = idText;
+        hit.type = "movie";
+        page.results.push_back(std::move(hit));
+    }
+    return page;
+}
+
+std::shared_ptr<TitleIndex> openTitleIndex(const AppConfig& cfg) {
+    if (cfg.omdbLocalIndexPath.empty()) return nullptr;
+    return TitleIndex::open(cfg.omdbLocalIndexPath);
+}
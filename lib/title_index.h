@@ -0,0 +1,170 @@
+// SPDX-License-Identifier: Apache-2.0
+//-------------------------------------------------------------------------------
+// Top100 — Your Personal Movie List
+//
+// File: lib/title_index.h
+// Purpose: Offline title index built from the IMDb TSV dataset dumps.
+// Language: C++17 (header)
+//-------------------------------------------------------------------------------
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+#include "Movie.h"
+#include "omdb.h"
+
+struct AppConfig;
+
+/**
+ * @brief Progress of importImdbDatasets().
+ * @ingroup services
+ */
+struct ImdbImportProgress {
+    /** Dataset being read ("title.basics", ...) or "index" while writing */
+    std::string stage;
+    /** Compressed bytes read from the current file */
+    uint64_t bytesRead = 0;
+    /** Size of the current file on disk */
+    uint64_t bytesTotal = 0;
+    /** Rows parsed from the current file */
+    uint64_t rows = 0;
+};
+
+/**
+ * @brief Input files and tuning for importImdbDatasets().
+ *
+ * Files may be gzipped (as downloaded from datasets.imdbws.com) or plain TSV.
+ * title.principals names people by ID only; their names come from name.basics,
+ * so credits are imported only when both files are given.
+ *
+ * @ingroup services
+ */
+struct ImdbImportOptions {
+    /** title.basics.tsv[.gz] (required) */
+    std::string basicsPath;
+    /** title.ratings.tsv[.gz] (optional) */
+    std::string ratingsPath;
+    /** title.principals.tsv[.gz] (optional, needs namesPath) */
+    std::string principalsPath;
+    /** name.basics.tsv[.gz] (optional, needs principalsPath) */
+    std::string namesPath;
+    /** titleType values to keep */
+    std::vector<std::string> titleTypes{"movie", "tvMovie"};
+    /** Keep titles flagged isAdult */
+    bool includeAdult = false;
+    /** Cast members kept per title (Movie::actors holds up to 10) */
+    size_t maxActors = 10;
+    /** Parser threads (0 = one per hardware thread) */
+    size_t threads = 0;
+    /** Decompressed bytes handed to a parser at a time; bounds memory with the thread count */
+    size_t chunkBytes = 4u << 20;
+    /** Called from the reading thread after each chunk */
+    std::function<void(const ImdbImportProgress&)> onProgress;
+    /** Optional; set to stop the import early (nothing is written) */
+    const std::atomic<bool>* cancel = nullptr;
+};
+
+/**
+ * @brief Outcome of importImdbDatasets().
+ * @ingroup services
+ */
+struct ImdbImportResult {
+    /** The index file was written */
+    bool ok = false;
+    /** Why not, when !ok */
+    std::string error;
+    /** Titles in the index */
+    size_t titles = 0;
+    /** Titles with a rating */
+    size_t rated = 0;
+    /** Titles with a director or cast */
+    size_t credited = 0;
+};
+
+/**
+ * @brief Stream the IMDb datasets into a title index file.
+ *
+ * Each file is decompressed on one thread and parsed in chunks by a pool, so
+ * memory stays proportional to the kept titles, not to the multi-GB inputs.
+ * The index is written next to @p indexPath and renamed into place, so a
+ * running app keeps using the old file until it reopens it.
+ *
+ * @param opts Input files and tuning
+ * @param indexPath Output file
+ * @return Counts, or the error that stopped the import
+ * @ingroup services
+ */
+ImdbImportResult importImdbDatasets(const ImdbImportOptions& opts, const std::string& indexPath);
+
+/**
+ * @brief Options for the standard dataset file names found in @p dir.
+ * @param dir Directory holding title.basics.tsv.gz etc. (plain .tsv also accepted)
+ * @return Options with every file found filled in
+ * @ingroup services
+ */
+ImdbImportOptions imdbImportOptionsForDir(const std::string& dir);
+
+/**
+ * @brief Read-only, memory-mapped title index.
+ *
+ * Titles are sorted by IMDb ID for lookups by ID. Search is fuzzy: titles are
+ * scored on the character trigrams they share with the query, so typos and
+ * partial words still match, and popular titles win ties.
+ *
+ * Thread-safe: all methods are const and the file is never modified.
+ *
+ * @ingroup services
+ */
+class TitleIndex {
+public:
+    /**
+     * @brief Map an index written by importImdbDatasets().
+     * @param path Index file
+     * @return Index, or nullptr if the file is missing or not a valid index
+     */
+    static std::shared_ptr<TitleIndex> open(const std::string& path);
+    ~TitleIndex();
+    TitleIndex(const TitleIndex&) = delete;
+    TitleIndex& operator=(const TitleIndex&) = delete;
+
+    /** @return Number of titles. */
+    size_t size() const;
+
+    /** @return Unix time the index was built. */
+    long long builtAt() const;
+
+    /**
+     * @brief Look up a title.
+     * @param imdbID IMDb identifier (e.g., tt0133093)
+     * @return Movie with the dataset fields (no plot or poster), or std::nullopt
+     */
+    std::optional<Movie> get(const std::string& imdbID) const;
+
+    /**
+     * @brief Fuzzy title search, best matches first.
+     * @param query Title keywords
+     * @param offset Matches to skip (paging)
+     * @param limit Maximum hits returned
+     * @return Hits plus the number of matching titles
+     */
+    OmdbSearchPage search(const std::string& query, size_t offset = 0, size_t limit = 10) const;
+
+private:
+    TitleIndex() = default;
+    struct Mapping;
+    std::unique_ptr<Mapping> map_;
+};
+
+/**
+ * @brief Open the index named by @p cfg.
+ * @param cfg Application configuration (omdbLocalIndexPath)
+ * @return Index, or nullptr when none is configured or it can't be opened
+ * @ingroup services
+ */
+std::shared_ptr<TitleIndex> openTitleIndex(const AppConfig& cfg);
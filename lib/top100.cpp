@@ -10,7 +10,11 @@
 // Date: September 18, 2025
 //-------------------------------------------------------------------------------
 #include "top100.h"
+#include "ranking.h"
+#include "elo.h"
+#include "thread_pool.h"
 #include <algorithm>
+#include <ctime>
 #include <fstream>
 #include <filesystem>
 #include <nlohmann/json.hpp> // still used for Movie (de)serialization and JSON fallback
@@ -18,6 +22,7 @@
 #include <sqlite3.h>
 #endif
 #include <stdexcept>
+#include <unordered_map>
 #include <cstdio>
 
 Top100::Top100(const std::string& filename) : filename(filename) {
@@ -78,6 +83,14 @@ std::vector<Movie> Top100::getMovies(SortOrder order) const {
                 return a.title < b.title;
             });
             break;
+        case SortOrder::COMPOSITE: {
+            CompositeIndex index;
+            index.assign(movies, compositeWeights.normalisation);
+            std::vector<uint32_t> order;
+            index.order(compositeWeights, order);
+            for (size_t k = 0; k < order.size(); ++k) sorted_movies[k] = movies[order[k]];
+            break;
+        }
         case SortOrder::DEFAULT:
         default:
             // Do nothing, return in insertion order
@@ -123,11 +136,12 @@ CREATE TABLE IF NOT EXISTS movies(
     source TEXT,
     imdbID TEXT UNIQUE,
     userScore REAL NOT NULL,
-    userRank INTEGER
+    userRank INTEGER,
+    updatedAt INTEGER
 );)SQL";
                         sqlite3_exec(mdb, createSql, nullptr, nullptr, nullptr);
                         sqlite3_exec(mdb, "BEGIN TRANSACTION;", nullptr, nullptr, nullptr);
-                        const char* ins = "INSERT OR REPLACE INTO movies(title,year,director,plotShort,plotFull,actors,genres,runtimeMinutes,countries,posterUrl,imdbRating,metascore,rottenTomatoes,source,imdbID,userScore,userRank) VALUES(?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?);";
+                        const char* ins = "INSERT OR REPLACE INTO movies(title,year,director,plotShort,plotFull,actors,genres,runtimeMinutes,countries,posterUrl,imdbRating,metascore,rottenTomatoes,source,imdbID,userScore,userRank,updatedAt) VALUES(?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?);";
                         sqlite3_stmt* stmt = nullptr;
                         if (sqlite3_prepare_v2(mdb, ins, -1, &stmt, nullptr) == SQLITE_OK) {
                             for (const auto& item : legacy) {
@@ -150,6 +164,7 @@ CREATE TABLE IF NOT EXISTS movies(
                                 if (m.imdbID.empty()) sqlite3_bind_null(stmt, col++); else sqlite3_bind_text(stmt, col++, m.imdbID.c_str(), -1, SQLITE_TRANSIENT);
                                 sqlite3_bind_double(stmt, col++, m.userScore);
                                 if (m.userRank < 0) sqlite3_bind_null(stmt, col++); else sqlite3_bind_int(stmt, col++, m.userRank);
+                                sqlite3_bind_int64(stmt, col++, m.updatedAt);
                                 sqlite3_step(stmt); sqlite3_reset(stmt); sqlite3_clear_bindings(stmt);
                             }
                         }
@@ -188,7 +203,8 @@ CREATE TABLE IF NOT EXISTS movies(
             source TEXT,
             imdbID TEXT UNIQUE,
             userScore REAL NOT NULL,
-            userRank INTEGER
+            userRank INTEGER,
+            updatedAt INTEGER
         );
     )SQL";
     char* errMsg = nullptr;
@@ -197,7 +213,9 @@ CREATE TABLE IF NOT EXISTS movies(
         sqlite3_free(errMsg);
         throw std::runtime_error("Failed to create schema: " + msg);
     }
-    const char* selectSQL = "SELECT title,year,director,plotShort,plotFull,actors,genres,runtimeMinutes,countries,posterUrl,imdbRating,metascore,rottenTomatoes,source,imdbID,userScore,userRank FROM movies ORDER BY id ASC";
+    // Databases created before updatedAt existed: add the column (fails harmlessly if present)
+    sqlite3_exec(db, "ALTER TABLE movies ADD COLUMN updatedAt INTEGER;", nullptr, nullptr, nullptr);
+    const char* selectSQL = "SELECT title,year,director,plotShort,plotFull,actors,genres,runtimeMinutes,countries,posterUrl,imdbRating,metascore,rottenTomatoes,source,imdbID,userScore,userRank,updatedAt FROM movies ORDER BY id ASC";
     sqlite3_stmt* stmt = nullptr;
     if (sqlite3_prepare_v2(db, selectSQL, -1, &stmt, nullptr) != SQLITE_OK) {
         throw std::runtime_error("Failed to prepare select: " + std::string(sqlite3_errmsg(db)));
@@ -222,9 +240,33 @@ CREATE TABLE IF NOT EXISTS movies(
         if (const unsigned char* t = sqlite3_column_text(stmt, 14)) m.imdbID = reinterpret_cast<const char*>(t);
         m.userScore = sqlite3_column_double(stmt, 15);
         m.userRank = sqlite3_column_type(stmt, 16) == SQLITE_NULL ? -1 : sqlite3_column_int(stmt, 16);
+        m.updatedAt = sqlite3_column_int64(stmt, 17);
         movies.push_back(std::move(m));
     }
     sqlite3_finalize(stmt);
+    // Pairwise answer history (append-only; drives the preference closure)
+    const char* historySQL = R"SQL(
+        CREATE TABLE IF NOT EXISTS comparisons(
+            id INTEGER PRIMARY KEY AUTOINCREMENT,
+            winner TEXT NOT NULL,
+            loser TEXT NOT NULL,
+            createdAt INTEGER
+        );
+    )SQL";
+    sqlite3_exec(db, historySQL, nullptr, nullptr, nullptr);
+    comparisons.clear();
+    prefs.clear();
+    if (sqlite3_prepare_v2(db, "SELECT winner,loser,createdAt FROM comparisons ORDER BY id ASC", -1, &stmt, nullptr) == SQLITE_OK) {
+        while (sqlite3_step(stmt) == SQLITE_ROW) {
+            Comparison c;
+            c.winner = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+            c.loser = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
+            c.createdAt = sqlite3_column_int64(stmt, 2);
+            prefs.addPreference(c.winner, c.loser);
+            comparisons.push_back(std::move(c));
+        }
+        sqlite3_finalize(stmt);
+    }
 #else
     // JSON fallback (development environments without SQLite headers)
     std::ifstream file(filename);
@@ -241,8 +283,8 @@ void Top100::save() {
     if (sqlite3_exec(db, "BEGIN IMMEDIATE TRANSACTION;", nullptr, nullptr, &errMsg) != SQLITE_OK) { if (errMsg) sqlite3_free(errMsg); return; }
     if (sqlite3_exec(db, "DELETE FROM movies;", nullptr, nullptr, &errMsg) != SQLITE_OK) { if (errMsg) sqlite3_free(errMsg); sqlite3_exec(db, "ROLLBACK;", nullptr, nullptr, nullptr); return; }
     const char* insertSQL = R"SQL(
-        INSERT INTO movies(title,year,director,plotShort,plotFull,actors,genres,runtimeMinutes,countries,posterUrl,imdbRating,metascore,rottenTomatoes,source,imdbID,userScore,userRank)
-        VALUES (?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?);
+        INSERT INTO movies(title,year,director,plotShort,plotFull,actors,genres,runtimeMinutes,countries,posterUrl,imdbRating,metascore,rottenTomatoes,source,imdbID,userScore,userRank,updatedAt)
+        VALUES (?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?);
     )SQL";
     sqlite3_stmt* stmt = nullptr;
     if (sqlite3_prepare_v2(db, insertSQL, -1, &stmt, nullptr) != SQLITE_OK) { sqlite3_exec(db, "ROLLBACK;", nullptr, nullptr, nullptr); return; }
@@ -265,6 +307,7 @@ void Top100::save() {
         if (m.imdbID.empty()) sqlite3_bind_null(stmt, col++); else sqlite3_bind_text(stmt, col++, m.imdbID.c_str(), -1, SQLITE_TRANSIENT);
         sqlite3_bind_double(stmt, col++, m.userScore);
         if (m.userRank < 0) sqlite3_bind_null(stmt, col++); else sqlite3_bind_int(stmt, col++, m.userRank);
+        sqlite3_bind_int64(stmt, col++, m.updatedAt);
         sqlite3_step(stmt); sqlite3_reset(stmt); sqlite3_clear_bindings(stmt);
     }
     sqlite3_finalize(stmt);
@@ -321,11 +364,82 @@ void Top100::recomputeRanks() {
     }
 }
 
-bool Top100::mergeFromOmdbByImdbId(const Movie& omdbMovie) {
-    if (omdbMovie.imdbID.empty()) return false;
-    int idx = findIndexByImdbId(omdbMovie.imdbID);
-    if (idx < 0) return false;
-    Movie& dest = movies[static_cast<size_t>(idx)];
+bool Top100::recordComparison(size_t winnerIndex, size_t loserIndex) {
+    if (winnerIndex >= movies.size() || loserIndex >= movies.size() || winnerIndex == loserIndex) return false;
+    Comparison c;
+    c.winner = comparisonKey(movies[winnerIndex]);
+    c.loser = comparisonKey(movies[loserIndex]);
+    c.createdAt = static_cast<long long>(std::time(nullptr));
+    applyComparison(movies, prefs, winnerIndex, loserIndex);
+#ifndef TOP100_NO_SQLITE
+    // History rows are appended immediately; the movies table is synced by save()
+    sqlite3_stmt* stmt = nullptr;
+    if (db && sqlite3_prepare_v2(db, "INSERT INTO comparisons(winner,loser,createdAt) VALUES(?,?,?)", -1, &stmt, nullptr) == SQLITE_OK) {
+        sqlite3_bind_text(stmt, 1, c.winner.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_text(stmt, 2, c.loser.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_int64(stmt, 3, c.createdAt);
+        sqlite3_step(stmt);
+        sqlite3_finalize(stmt);
+    }
+#endif
+    comparisons.push_back(std::move(c));
+    recomputeRanks();
+    return true;
+}
+
+size_t Top100::importComparisons(const std::vector<Comparison>& batch) {
+    std::unordered_map<std::string, uint32_t> index;
+    for (size_t i = 0; i < movies.size(); ++i) index.emplace(comparisonKey(movies[i]), static_cast<uint32_t>(i));
+    const long long now = static_cast<long long>(std::time(nullptr));
+    std::vector<EloPair> pairs;
+    std::vector<Comparison> accepted;
+    pairs.reserve(batch.size());
+    accepted.reserve(batch.size());
+    for (const auto& c : batch) {
+        auto w = index.find(c.winner), l = index.find(c.loser);
+        if (w == index.end() || l == index.end() || w->second == l->second) continue;
+        pairs.push_back({w->second, l->second});
+        accepted.push_back(c);
+        if (accepted.back().createdAt == 0) accepted.back().createdAt = now;
+        prefs.addPreference(c.winner, c.loser);
+    }
+    if (pairs.empty()) return 0;
+
+    std::vector<double> scores(movies.size());
+    for (size_t i = 0; i < movies.size(); ++i) scores[i] = movies[i].userScore;
+    eloUpdateBatch(scores, pairs);
+    for (size_t i = 0; i < movies.size(); ++i) movies[i].userScore = scores[i];
+
+#ifndef TOP100_NO_SQLITE
+    sqlite3_stmt* stmt = nullptr;
+    if (db && sqlite3_exec(db, "BEGIN IMMEDIATE TRANSACTION;", nullptr, nullptr, nullptr) == SQLITE_OK) {
+        if (sqlite3_prepare_v2(db, "INSERT INTO comparisons(winner,loser,createdAt) VALUES(?,?,?)", -1, &stmt, nullptr) == SQLITE_OK) {
+            for (const auto& c : accepted) {
+                sqlite3_bind_text(stmt, 1, c.winner.c_str(), -1, SQLITE_TRANSIENT);
+                sqlite3_bind_text(stmt, 2, c.loser.c_str(), -1, SQLITE_TRANSIENT);
+                sqlite3_bind_int64(stmt, 3, c.createdAt);
+                sqlite3_step(stmt); sqlite3_reset(stmt); sqlite3_clear_bindings(stmt);
+            }
+            sqlite3_finalize(stmt);
+        }
+        sqlite3_exec(db, "COMMIT;", nullptr, nullptr, nullptr);
+    }
+#endif
+    comparisons.insert(comparisons.end(), accepted.begin(), accepted.end());
+    recomputeRanks();
+    return pairs.size();
+}
+
+void Top100::estimateRankIntervals(const RankBootstrapOptions& opts) {
+    auto intervals = bootstrapRankIntervals(movies, comparisons, opts, sharedThreadPool());
+    for (size_t i = 0; i < movies.size(); ++i) {
+        movies[i].userRankLow = intervals[i].low;
+        movies[i].userRankHigh = intervals[i].high;
+    }
+}
+
+// Copy OMDb metadata into a stored record, keeping its ranking fields
+static void mergeMetadata(Movie& dest, const Movie& omdbMovie, long long now) {
     // Preserve ranking fields
     double score = dest.userScore;
     int rank = dest.userRank;
@@ -345,10 +459,46 @@ bool Top100::mergeFromOmdbByImdbId(const Movie& omdbMovie) {
     dest.rottenTomatoes = omdbMovie.rottenTomatoes;
     dest.source = omdbMovie.source.empty() ? dest.source : omdbMovie.source;
     dest.imdbID = omdbMovie.imdbID; // same id
+    dest.updatedAt = omdbMovie.updatedAt > 0 ? omdbMovie.updatedAt : now;
     // Restore ranking
     dest.userScore = score;
     dest.userRank = rank;
+}
+
+bool Top100::mergeFromOmdbByImdbId(const Movie& omdbMovie) {
+    if (omdbMovie.imdbID.empty()) return false;
+    int idx = findIndexByImdbId(omdbMovie.imdbID);
+    if (idx < 0) return false;
+    mergeMetadata(movies[static_cast<size_t>(idx)], omdbMovie, static_cast<long long>(std::time(nullptr)));
     // Save immediately
     save();
     return true;
-}
\ No newline at end of file
+}
+
+size_t Top100::mergeFromOmdb(const std::vector<Movie>& batch) {
+    std::unordered_map<std::string, size_t> index;
+    for (size_t i = 0; i < movies.size(); ++i) {
+        if (!movies[i].imdbID.empty()) index.emplace(movies[i].imdbID, i);
+    }
+    const long long now = static_cast<long long>(std::time(nullptr));
+    size_t merged = 0;
+    for (const auto& m : batch) {
+        auto it = index.find(m.imdbID);
+        if (m.imdbID.empty() || it == index.end()) continue;
+        mergeMetadata(movies[it->second], m, now);
+        ++merged;
+    }
+    // One transaction for the whole batch
+    if (merged > 0) save();
+    return merged;
+}
+
+std::vector<std::string> Top100::staleImdbIds(long long maxAgeSeconds) const {
+    const long long now = static_cast<long long>(std::time(nullptr));
+    std::vector<std::string> out;
+    for (const auto& m : movies) {
+        if (m.imdbID.empty()) continue;
+        if (m.updatedAt <= 0 || now - m.updatedAt >= maxAgeSeconds) out.push_back(m.imdbID);
+    }
+    return out;
+}
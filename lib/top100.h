@@ -14,6 +14,9 @@
 #include <vector>
 #include <string>
 #include "Movie.h"
+#include "preference_graph.h"
+#include "rank_bootstrap.h"
+#include "composite_sort.h"
 
 // Forward declaration to avoid leaking sqlite3 header to dependents
 struct sqlite3;
@@ -30,7 +33,24 @@ enum class SortOrder {
     BY_YEAR,
     ALPHABETICAL,
     BY_USER_RANK,    // 1..N ascending (unranked last)
-    BY_USER_SCORE    // high to low
+    BY_USER_SCORE,   // high to low
+    COMPOSITE        // weighted user + critic scores, high to low (see CompositeWeights)
+};
+
+/**
+ * @brief One recorded pairwise answer ("winner beats loser").
+ *
+ * Movies are identified by comparisonKey() so history survives re-ordering and
+ * metadata refreshes.
+ * @ingroup core
+ */
+struct Comparison {
+    /** Key of the preferred movie */
+    std::string winner;
+    /** Key of the other movie */
+    std::string loser;
+    /** Unix time the answer was recorded (0 if unknown) */
+    long long createdAt = 0;
 };
 
 /**
@@ -69,6 +89,12 @@ public:
      */
     std::vector<Movie> getMovies(SortOrder order = SortOrder::DEFAULT) const;
 
+    /** @brief Weights used by SortOrder::COMPOSITE (in memory; callers load them from config).
+     *  @param weights Column weights and normalisation */
+    void setCompositeWeights(const CompositeWeights& weights) { compositeWeights = weights; }
+    /** @return Weights used by SortOrder::COMPOSITE. */
+    const CompositeWeights& getCompositeWeights() const { return compositeWeights; }
+
     // Duplicate handling helpers
     /** @brief Find by IMDb ID.
      *  @param imdbID IMDb identifier
@@ -105,10 +131,67 @@ public:
      */
     bool mergeFromOmdbByImdbId(const Movie& omdbMovie);
 
+    /**
+     * @brief Merge a batch of OMDb-sourced movies and save once.
+     *
+     * Same per-movie rules as mergeFromOmdbByImdbId(); entries whose IMDb ID
+     * isn't in the list are skipped. All rows are written in one transaction.
+     *
+     * @param batch OMDb-sourced movies
+     * @return Number of movies merged
+     */
+    size_t mergeFromOmdb(const std::vector<Movie>& batch);
+
+    /**
+     * @brief IMDb IDs whose metadata is older than @p maxAgeSeconds.
+     * @param maxAgeSeconds Age limit (0 = every movie with an IMDb ID)
+     * @return IDs in insertion order; never-fetched movies (updatedAt 0) included
+     */
+    std::vector<std::string> staleImdbIds(long long maxAgeSeconds) const;
+
     // Recompute 1-based userRank from userScore (descending). Unranked (-1) if list empty.
     /** @brief Recompute 1-based userRank from userScore descending. */
     void recomputeRanks();
 
+    /**
+     * @brief Record a pairwise answer: Elo update, history append, closure update.
+     * @param winnerIndex Index (insertion order) of the preferred movie
+     * @param loserIndex Index (insertion order) of the other movie
+     * @return false if either index is invalid or they are equal
+     * @note Ranks are recomputed; the history row is written immediately (SQLite backend only).
+     */
+    bool recordComparison(size_t winnerIndex, size_t loserIndex);
+
+    /**
+     * @brief Apply a batch of answers (e.g. history imported from another install).
+     *
+     * Entries whose keys don't match a movie in this list are skipped. Scores are
+     * updated with the batched Elo kernel, the closure is extended and all rows
+     * are appended to the history in one transaction.
+     *
+     * @param batch Answers in chronological order (createdAt 0 = now)
+     * @return Number of answers applied
+     */
+    size_t importComparisons(const std::vector<Comparison>& batch);
+
+    /**
+     * @brief Fill userRankLow/userRankHigh by bootstrapping the comparison history.
+     *
+     * Runs on sharedThreadPool(); see bootstrapRankIntervals(). The intervals are
+     * kept in memory only and show up in subsequent getMovies() copies.
+     *
+     * @param opts Resample count, coverage, K-factor and seed
+     */
+    void estimateRankIntervals(const RankBootstrapOptions& opts = RankBootstrapOptions());
+
+    /** @brief Comparison history in chronological order.
+     *  @return Copy of all recorded answers */
+    std::vector<Comparison> getComparisons() const { return comparisons; }
+
+    /** @brief Transitive closure of the comparison history.
+     *  @return Preference graph (valid until the next recordComparison) */
+    const PreferenceGraph& preferences() const { return prefs; }
+
 private:
     // Load all movies from the backing SQLite database (creating schema as needed)
     void load();
@@ -117,5 +200,8 @@ private:
 
     std::string filename;          // Path to SQLite database file (was JSON file)
     std::vector<Movie> movies;     // In‑memory working set (authoritative ordering = insertion)
+    std::vector<Comparison> comparisons; // Append-only answer history (persisted per answer)
+    PreferenceGraph prefs;         // Closure over comparisons, rebuilt on load
+    CompositeWeights compositeWeights; // Weights for SortOrder::COMPOSITE
     sqlite3* db = nullptr;         // Open database handle
 };
\ No newline at end of file
@@ -0,0 +1,166 @@
+// SPDX-License-Identifier: Apache-2.0
+//-------------------------------------------------------------------------------
+// Top100 — Your Personal Movie List
+//
+// File: tests/test_fixture_server.cpp
+// Purpose: The real service clients against the loopback fixture server.
+// Language: C++17 (Boost.Test)
+//-------------------------------------------------------------------------------
+#define BOOST_TEST_MODULE Top100FixtureServer
+#include <boost/test/included/unit_test.hpp>
+#include "bluesky.h"
+#include "fixture_server.h"
+#include "http.h"
+#include "mastodon.h"
+#include "omdb.h"
+#include <chrono>
+#include <string>
+
+// Fixture server with OMDb routed to it; restores the real OMDb afterwards
+struct ServerFixture {
+    FixtureServer server;
+    ServerFixture() : server(options()) {
+        BOOST_REQUIRE_MESSAGE(server.ok(), server.error());
+        omdbSetCache(nullptr);
+        omdbSetBaseUrl(server.omdbUrl());
+    }
+    ~ServerFixture() { omdbSetBaseUrl(std::string()); }
+
+    static FixtureServerOptions options() {
+        FixtureServerOptions o;
+        o.omdbApiKey = "good-key";
+        o.blueSkyPassword = "app-password";
+        return o;
+    }
+};
+
+static double elapsedMs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+BOOST_AUTO_TEST_SUITE(FixtureSuite)
+
+BOOST_FIXTURE_TEST_CASE(omdb_search_detail_and_posters, ServerFixture)
+{
+    const auto ids = server.synthesize(40, 24);
+    BOOST_REQUIRE_EQUAL(ids.size(), 40u);
+    server.addOmdbSearch("The Matrix", 1,
+                         R"({"Search":[{"Title":"The Matrix","Year":"1999","imdbID":"tt0133093","Type":"movie"}],)"
+                         R"("totalResults":"1","Response":"True"})");
+    BOOST_REQUIRE(server.addOmdbDetail(R"({"Title":"The Matrix","Year":"1999","imdbID":"tt0133093",)"
+                                       R"("Plot":"A hacker learns the truth. Then he fights.","Response":"True"})"));
+
+    // Recorded and synthesized searches, paged like OMDb
+    auto hits = omdbSearch("good-key", "  the MATRIX ");
+    BOOST_REQUIRE_EQUAL(hits.size(), 1u);
+    BOOST_CHECK_EQUAL(hits[0].imdbID, "tt0133093");
+    const OmdbSearchPage page = omdbSearchPageAsync("good-key", "dark", 1).get();
+    BOOST_CHECK_EQUAL(page.results.size(), 3u);   // "Dark Night", "Dark Return", ... among 40 titles
+    BOOST_CHECK_EQUAL(page.totalResults, 3u);
+    BOOST_CHECK(omdbSearch("good-key", "no such title").empty());
+
+    // Details with both plot variants
+    auto m = omdbGetById("good-key", "tt0133093");
+    BOOST_REQUIRE(m);
+    BOOST_CHECK_EQUAL(m->plotFull, "A hacker learns the truth. Then he fights.");
+    BOOST_CHECK_EQUAL(m->plotShort, "A hacker learns the truth.");
+    m = omdbGetById("good-key", ids[5]);
+    BOOST_REQUIRE(m);
+    BOOST_CHECK_EQUAL(m->posterUrl, server.posterUrl(ids[5] + ".png"));
+    BOOST_CHECK_EQUAL(m->actors.size(), 4u);
+    BOOST_CHECK_GT(m->imdbRating, 0.0);
+
+    // Posters, with ETag revalidation
+    cpr::Response poster = httpClient().get(m->posterUrl);
+    BOOST_CHECK_EQUAL(poster.status_code, 200);
+    BOOST_CHECK_EQUAL(poster.header["Content-Type"], "image/png");
+    BOOST_CHECK_EQUAL(poster.text.compare(1, 3, "PNG"), 0);
+    HttpRequest again;
+    again.url = m->posterUrl;
+    again.header = cpr::Header{{"If-None-Match", poster.header["ETag"]}};
+    BOOST_CHECK_EQUAL(httpClient().perform(again).status_code, 304);
+    BOOST_CHECK_EQUAL(httpClient().get(server.posterUrl("missing.png")).status_code, 404);
+
+    // Key checks and the daily quota
+    BOOST_CHECK(omdbFetchDetail("wrong-key", ids[0]).error == OmdbError::InvalidKey);
+    BOOST_CHECK(omdbFetchDetail("good-key", "tt0000000").error == OmdbError::NotFound);
+    FixtureFaults quota;
+    quota.omdbDailyLimit = 1;
+    server.setFaults(quota);
+    BOOST_CHECK(omdbFetchDetail("good-key", ids[1]).error == OmdbError::QuotaExceeded);
+
+    const FixtureStats s = server.stats();
+    BOOST_CHECK_EQUAL(s.posters, 3u);
+    BOOST_CHECK_EQUAL(s.notModified, 1u);
+    BOOST_CHECK_LT(s.connections, s.requests);   // kept-alive connections were reused
+}
+
+BOOST_FIXTURE_TEST_CASE(faults_are_injected, ServerFixture)
+{
+    const auto ids = server.synthesize(1, 200);   // ~180 KB poster
+    OmdbDetailOptions one;                         // one request per lookup
+    one.fetchShortPlot = false;
+    BOOST_REQUIRE(omdbFetchDetail("good-key", ids[0], one).movie);
+
+    FixtureFaults f;
+    f.errorRate = 1.0;
+    server.setFaults(f);
+    BOOST_CHECK(omdbFetchDetail("good-key", ids[0], one).error == OmdbError::Transient);
+    BOOST_CHECK_EQUAL(httpClient().get(server.posterUrl(ids[0] + ".png")).status_code, 503);
+    BOOST_CHECK_EQUAL(server.stats().injectedErrors, 2u);
+
+    f = FixtureFaults();
+    f.rateLimitPerSecond = 0.5;
+    f.rateLimitBurst = 1;
+    server.setFaults(f);
+    BOOST_CHECK(omdbFetchDetail("good-key", ids[0], one).movie);
+    BOOST_CHECK(omdbFetchDetail("good-key", ids[0], one).error == OmdbError::Transient);
+    BOOST_CHECK_EQUAL(server.stats().rateLimited, 1u);
+
+    f = FixtureFaults();
+    f.latencyMs = 150;
+    server.setFaults(f);
+    auto start = std::chrono::steady_clock::now();
+    BOOST_CHECK(omdbFetchDetail("good-key", ids[0], one).movie);
+    BOOST_CHECK_GE(elapsedMs(start), 140.0);
+
+    f = FixtureFaults();
+    f.bytesPerSecond = 400000.0;
+    server.setFaults(f);
+    start = std::chrono::steady_clock::now();
+    const cpr::Response poster = httpClient().get(server.posterUrl(ids[0] + ".png"));
+    BOOST_CHECK_EQUAL(poster.status_code, 200);
+    BOOST_CHECK_GT(poster.text.size(), 150000u);
+    BOOST_CHECK_GE(elapsedMs(start), 300.0);
+}
+
+BOOST_FIXTURE_TEST_CASE(social_endpoints, ServerFixture)
+{
+    const std::string base = server.baseUrl();
+    BOOST_CHECK(!bskyCreateSession(base, "me.bsky.social", "wrong"));
+    auto session = bskyCreateSession(base, "me.bsky.social", "app-password");
+    BOOST_REQUIRE(session);
+    const std::vector<unsigned char> image{0x89, 'P', 'N', 'G', 1, 2, 3};
+    auto blob = bskyUploadImage(base, session->accessJwt, image, "image/png");
+    BOOST_REQUIRE(blob);
+    BOOST_CHECK(bskyCreatePost(base, session->accessJwt, session->did, "Top 100: #1", blob));
+    BOOST_CHECK(!bskyUploadImage(base, "stale-token", image, "image/png"));
+
+    BOOST_CHECK(mastoVerify(base, "fixture-token"));
+    BOOST_CHECK(!mastoVerify(base, "wrong-token"));
+    auto media = mastoUploadMedia(base, "fixture-token", image, "poster.png", "image/png");
+    BOOST_REQUIRE(media);
+    BOOST_CHECK(mastoPostStatus(base, "fixture-token", "Top 100: #2 & more", media));
+    BOOST_CHECK(!mastoPostStatus(base, "fixture-token", "bad media", std::string("999")));
+
+    const auto posts = server.posts();
+    BOOST_REQUIRE_EQUAL(posts.size(), 2u);
+    BOOST_CHECK_EQUAL(posts[0].service, "bluesky");
+    BOOST_CHECK_EQUAL(posts[0].text, "Top 100: #1");
+    BOOST_CHECK(posts[0].withMedia);
+    BOOST_CHECK_EQUAL(posts[1].service, "mastodon");
+    BOOST_CHECK_EQUAL(posts[1].text, "Top 100: #2 & more");
+    BOOST_CHECK(posts[1].withMedia);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
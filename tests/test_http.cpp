@@ -0,0 +1,402 @@
+// SPDX-License-Identifier: Apache-2.0
+//-------------------------------------------------------------------------------
+// Top100 — Your Personal Movie List
+//
+// File: tests/test_http.cpp
+// Purpose: Unit tests for the pooled HTTP client against a loopback server.
+// Language: C++17 (Boost.Test)
+//-------------------------------------------------------------------------------
+#define BOOST_TEST_MODULE Top100Http
+#include <boost/test/included/unit_test.hpp>
+#include "http.h"
+#include <arpa/inet.h>
+#include <atomic>
+#include <chrono>
+#include <set>
+#include <mutex>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+
+// Minimal HTTP/1.1 keep-alive server on 127.0.0.1. Each response body is
+// "<METHOD> <target> <request body length>", so tests can see what was sent.
+// A target starting with "/hang" is never answered, one starting with "/slow"
+// is answered after 300 ms.
+class LoopbackServer {
+public:
+    LoopbackServer() {
+        listenFd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+        int on = 1;
+        ::setsockopt(listenFd_, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        ::bind(listenFd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+        ::listen(listenFd_, 16);
+        socklen_t len = sizeof(addr);
+        ::getsockname(listenFd_, reinterpret_cast<sockaddr*>(&addr), &len);
+        port_ = ntohs(addr.sin_port);
+        acceptor_ = std::thread([this]() { acceptLoop(); });
+    }
+    ~LoopbackServer() {
+        ::shutdown(listenFd_, SHUT_RDWR);
+        ::close(listenFd_);
+        acceptor_.join();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (int fd : clients_) ::shutdown(fd, SHUT_RDWR);
+        }
+        for (auto& t : handlers_) t.join();
+    }
+
+    std::string url(const std::string& path) const {
+        return "http://127.0.0.1:" + std::to_string(port_) + path;
+    }
+    int connections() const { return connections_.load(); }
+    int requests() const { return requests_.load(); }
+
+private:
+    void acceptLoop() {
+        for (;;) {
+            int fd = ::accept(listenFd_, nullptr, nullptr);
+            if (fd < 0) return;
+            ++connections_;
+            std::lock_guard<std::mutex> lock(mutex_);
+            clients_.push_back(fd);
+            handlers_.emplace_back([this, fd]() { serve(fd); });
+        }
+    }
+
+    void serve(int fd) {
+        std::string buf;
+        char chunk[4096];
+        for (;;) {
+            size_t headerEnd;
+            while ((headerEnd = buf.find("\r\n\r\n")) == std::string::npos) {
+                ssize_t n = ::recv(fd, chunk, sizeof(chunk), 0);
+                if (n <= 0) { ::close(fd); return; }
+                buf.append(chunk, static_cast<size_t>(n));
+            }
+            const std::string head = buf.substr(0, headerEnd);
+            size_t bodyLen = 0;
+            const size_t cl = head.find("Content-Length: ");
+            if (cl != std::string::npos) bodyLen = std::stoul(head.substr(cl + 16));
+            while (buf.size() < headerEnd + 4 + bodyLen) {
+                ssize_t n = ::recv(fd, chunk, sizeof(chunk), 0);
+                if (n <= 0) { ::close(fd); return; }
+                buf.append(chunk, static_cast<size_t>(n));
+            }
+            buf.erase(0, headerEnd + 4 + bodyLen);
+            ++requests_;
+            const size_t sp1 = head.find(' '), sp2 = head.find(' ', sp1 + 1);
+            if (head.compare(sp1 + 1, 5, "/hang") == 0) {
+                while (::recv(fd, chunk, sizeof(chunk), 0) > 0) {}
+                ::close(fd);
+                return;
+            }
+            if (head.compare(sp1 + 1, 5, "/slow") == 0) std::this_thread::sleep_for(std::chrono::milliseconds(300));
+            const std::string body = head.substr(0, sp2) + " " + std::to_string(bodyLen);
+            const std::string resp = "HTTP/1.1 200 OK\r\nContent-Type: text/plain\r\nContent-Length: " +
+                                     std::to_string(body.size()) + "\r\n\r\n" + body;
+            if (::send(fd, resp.data(), resp.size(), MSG_NOSIGNAL) < 0) { ::close(fd); return; }
+        }
+    }
+
+    int listenFd_ = -1;
+    uint16_t port_ = 0;
+    std::atomic<int> connections_{0};
+    std::atomic<int> requests_{0};
+    std::thread acceptor_;
+    std::mutex mutex_;
+    std::vector<int> clients_;
+    std::vector<std::thread> handlers_;
+};
+
+BOOST_AUTO_TEST_SUITE(HttpSuite)
+
+BOOST_AUTO_TEST_CASE(host_key)
+{
+    BOOST_CHECK_EQUAL(HttpClient::hostKey("https://www.OMDbAPI.com/?i=tt1"), "https://www.omdbapi.com");
+    BOOST_CHECK_EQUAL(HttpClient::hostKey("http://127.0.0.1:8080/x/y#z"), "http://127.0.0.1:8080");
+    BOOST_CHECK_EQUAL(HttpClient::hostKey("https://bsky.social"), "https://bsky.social");
+    BOOST_CHECK_EQUAL(HttpClient::hostKey("not a url"), "");
+}
+
+BOOST_AUTO_TEST_CASE(reuses_connections)
+{
+    LoopbackServer server;
+    {
+        HttpClient client;
+        for (int i = 0; i < 20; ++i) {
+            auto r = client.get(server.url("/movie"), cpr::Parameters{{"i", std::to_string(i)}});
+            BOOST_REQUIRE_EQUAL(r.status_code, 200);
+            BOOST_CHECK_EQUAL(r.text, "GET /movie?i=" + std::to_string(i) + " 0");
+        }
+        BOOST_CHECK_EQUAL(server.connections(), 1);
+
+        // A POST body must not follow the session into a later GET
+        auto p = client.post(server.url("/post"), "hello", cpr::Header{{"Content-Type", "text/plain"}});
+        BOOST_CHECK_EQUAL(p.text, "POST /post 5");
+        auto g = client.get(server.url("/after"));
+        BOOST_CHECK_EQUAL(g.text, "GET /after 0");
+
+        // Concurrent requests each need a connection over HTTP/1.1, then stay pooled
+        std::vector<HttpRequest> reqs(4);
+        for (size_t i = 0; i < reqs.size(); ++i) reqs[i].url = server.url("/batch/" + std::to_string(i));
+        auto rs = client.performAll(reqs);
+        BOOST_REQUIRE_EQUAL(rs.size(), 4u);
+        for (size_t i = 0; i < rs.size(); ++i) BOOST_CHECK_EQUAL(rs[i].text, "GET /batch/" + std::to_string(i) + " 0");
+        const int afterBatch = server.connections();
+        BOOST_CHECK_LE(afterBatch, 4);
+        rs = client.performAll(reqs);
+        BOOST_CHECK_EQUAL(server.connections(), afterBatch);
+
+        auto stats = client.stats();
+        BOOST_REQUIRE_EQUAL(stats.size(), 1u);
+        BOOST_CHECK_EQUAL(stats[0].host, server.url(""));
+        BOOST_CHECK_EQUAL(stats[0].requests, 30u);
+        BOOST_CHECK_EQUAL(stats[0].failures, 0u);
+        BOOST_CHECK_EQUAL(stats[0].connections, static_cast<uint64_t>(afterBatch));
+        BOOST_CHECK_GT(stats[0].meanMs(), 0.0);
+        BOOST_CHECK_GE(client.idleSessions(), 4u);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(transport_failure_is_counted)
+{
+    HttpClientOptions opts;
+    opts.connectTimeoutMs = 500;
+    HttpClient client(opts);
+    // Port 9 on loopback: nothing listens there in the test environment
+    auto r = client.get("http://127.0.0.1:9/");
+    BOOST_CHECK_EQUAL(r.status_code, 0);
+    BOOST_CHECK(r.error);
+    auto stats = client.stats();
+    BOOST_REQUIRE_EQUAL(stats.size(), 1u);
+    BOOST_CHECK_EQUAL(stats[0].failures, 1u);
+    BOOST_CHECK_EQUAL(client.idleSessions(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(future_continuations_and_cancel)
+{
+    // then() chains, flattens returned futures, and runs at once on a ready future
+    Promise<int> p;
+    auto doubled = p.future().then([](const int& v) { return v * 2; });
+    auto chained = doubled.then([](const int& v) { return readyFuture(std::to_string(v)); });
+    BOOST_CHECK(!chained.ready());
+    BOOST_CHECK(p.setValue(21));
+    BOOST_CHECK(!p.setValue(1));
+    BOOST_CHECK_EQUAL(doubled.get(), 42);
+    BOOST_CHECK_EQUAL(chained.get(), "42");
+    BOOST_CHECK_EQUAL(readyFuture(1).then([](const int& v) { return v + 1; }).get(), 2);
+
+    // Errors and cancellation skip continuations and propagate
+    int calls = 0;
+    Promise<int> failing;
+    auto afterError = failing.future().then([&calls](const int& v) { ++calls; return v; });
+    failing.setError(std::make_exception_ptr(std::runtime_error("boom")));
+    BOOST_CHECK_THROW(afterError.get(), std::runtime_error);
+    Promise<int> dropped;
+    auto afterCancel = dropped.future().then([&calls](const int& v) { ++calls; return v; });
+    dropped.cancel();
+    BOOST_CHECK(afterCancel.cancelled());
+    BOOST_CHECK_THROW(afterCancel.get(), OperationCancelled);
+    BOOST_CHECK_EQUAL(calls, 0);
+    // onComplete sees every outcome
+    bool sawCancel = false;
+    afterCancel.onComplete([&sawCancel](const Future<int>& f) { sawCancel = f.cancelled(); });
+    BOOST_CHECK(sawCancel);
+
+    // whenAll keeps input order and completes with the last input
+    std::vector<Promise<int>> ps(3);
+    std::vector<Future<int>> fs;
+    for (auto& q : ps) fs.push_back(q.future());
+    auto all = whenAll(fs);
+    ps[2].setValue(3);
+    ps[0].setValue(1);
+    BOOST_CHECK(!all.ready());
+    ps[1].setValue(2);
+    BOOST_CHECK((all.get() == std::vector<int>{1, 2, 3}));
+    std::vector<Future<int>> mixed{readyFuture(1), afterCancel};
+    BOOST_CHECK(whenAll(mixed).cancelled());
+
+    // Callbacks run once on cancel, immediately if registered late, never once forgotten
+    CancelSource source;
+    CancelToken token = source.token();
+    int fired = 0;
+    token.onCancel([&fired]() { ++fired; });
+    const size_t forgotten = token.onCancel([&fired]() { fired += 100; });
+    token.forget(forgotten);
+    BOOST_CHECK(!token.cancelled());
+    source.cancel();
+    source.cancel();
+    BOOST_CHECK(token.cancelled());
+    BOOST_CHECK_EQUAL(token.onCancel([&fired]() { fired += 10; }), 0u);
+    BOOST_CHECK_EQUAL(fired, 11);
+    BOOST_CHECK(!CancelToken().canBeCancelled());
+}
+
+BOOST_AUTO_TEST_CASE(async_requests_share_one_loop)
+{
+    LoopbackServer server;
+    HttpClient client;
+    std::mutex mutex;
+    std::set<std::thread::id> threads;
+    std::vector<Future<std::string>> fs;
+    for (int i = 0; i < 24; ++i) {
+        HttpRequest req;
+        req.url = server.url("/async/" + std::to_string(i));
+        fs.push_back(client.performAsync(req).then([&mutex, &threads](const cpr::Response& r) {
+            std::lock_guard<std::mutex> lock(mutex);
+            threads.insert(std::this_thread::get_id());
+            return r.text;
+        }));
+    }
+    auto texts = whenAll(fs).get();
+    BOOST_REQUIRE_EQUAL(texts.size(), 24u);
+    for (size_t i = 0; i < texts.size(); ++i) BOOST_CHECK_EQUAL(texts[i], "GET /async/" + std::to_string(i) + " 0");
+    // Transfers complete on the one event-loop thread (a continuation attached
+    // after its request already finished runs on the caller's)
+    threads.erase(std::this_thread::get_id());
+    BOOST_CHECK_LE(threads.size(), 1u);
+    BOOST_CHECK_EQUAL(client.inFlight(), 0u);
+
+    // Finished connections go back to the pool shared with the blocking calls
+    const int opened = server.connections();
+    BOOST_CHECK_EQUAL(client.get(server.url("/sync")).text, "GET /sync 0");
+    BOOST_CHECK_EQUAL(server.connections(), opened);
+
+    HttpRequest post;
+    post.method = HttpRequest::Method::Post;
+    post.url = server.url("/async-post");
+    post.body = "hello";
+    BOOST_CHECK_EQUAL(client.performAsync(post).get().text, "POST /async-post 5");
+}
+
+BOOST_AUTO_TEST_CASE(async_request_cancellation)
+{
+    LoopbackServer server;
+    HttpClient client;
+    CancelSource source;
+    HttpRequest req;
+    req.url = server.url("/hang");
+    bool continued = false;
+    auto hung = client.performAsync(req, source.token());
+    auto after = hung.then([&continued](const cpr::Response&) { continued = true; return 0; });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    BOOST_CHECK(!hung.ready());
+    BOOST_CHECK_EQUAL(client.inFlight(), 1u);
+
+    const auto start = std::chrono::steady_clock::now();
+    source.cancel();
+    BOOST_REQUIRE(after.waitFor(std::chrono::seconds(2)));
+    BOOST_CHECK_LT(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(), 1.0);
+    BOOST_CHECK(hung.cancelled());
+    BOOST_CHECK(after.cancelled());
+    BOOST_CHECK(!continued);
+    BOOST_CHECK_EQUAL(client.inFlight(), 0u);
+
+    // An already-cancelled token never reaches the network
+    const int opened = server.connections();
+    req.url = server.url("/never");
+    BOOST_CHECK(client.performAsync(req, source.token()).cancelled());
+    BOOST_CHECK_EQUAL(server.connections(), opened);
+
+    // The loop keeps serving other requests
+    req.url = server.url("/still-alive");
+    BOOST_CHECK_EQUAL(client.performAsync(req).get().text, "GET /still-alive 0");
+}
+
+BOOST_AUTO_TEST_CASE(coalesces_identical_gets)
+{
+    LoopbackServer server;
+    HttpClient client;
+
+    // Eight threads ask for the same resource while the first request is in flight
+    std::vector<std::string> texts(8);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < texts.size(); ++i)
+        threads.emplace_back([&, i]() { texts[i] = client.get(server.url("/slow/a")).text; });
+    for (auto& t : threads) t.join();
+    for (const auto& t : texts) BOOST_CHECK_EQUAL(t, "GET /slow/a 0");
+    BOOST_CHECK_EQUAL(server.requests(), 1);
+    auto stats = client.stats();
+    BOOST_REQUIRE_EQUAL(stats.size(), 1u);
+    BOOST_CHECK_EQUAL(stats[0].requests, 1u);
+    BOOST_CHECK_EQUAL(stats[0].coalesced, 7u);
+
+    // Duplicates within a batch; other parameters and posts are separate requests
+    std::vector<HttpRequest> reqs(4);
+    for (auto& r : reqs) r.url = server.url("/slow/b");
+    reqs[2].parameters = cpr::Parameters{{"page", "2"}};
+    reqs[3].method = HttpRequest::Method::Post;
+    auto rs = client.performAll(reqs);
+    BOOST_CHECK_EQUAL(rs[0].text, "GET /slow/b 0");
+    BOOST_CHECK_EQUAL(rs[1].text, "GET /slow/b 0");
+    BOOST_CHECK_EQUAL(rs[2].text, "GET /slow/b?page=2 0");
+    BOOST_CHECK_EQUAL(rs[3].text, "POST /slow/b 0");
+    BOOST_CHECK_EQUAL(server.requests(), 4);
+    BOOST_CHECK_EQUAL(client.stats()[0].coalesced, 8u);
+
+    // Flights end with their result: a later identical request goes out again
+    BOOST_CHECK_EQUAL(client.get(server.url("/slow/a")).text, "GET /slow/a 0");
+    BOOST_CHECK_EQUAL(server.requests(), 5);
+    const SingleFlightStats fl = client.coalescing();
+    BOOST_CHECK_EQUAL(fl.started, 4u);
+    BOOST_CHECK_EQUAL(fl.joined, 8u);
+    BOOST_CHECK_EQUAL(fl.inFlight, 0u);
+
+    // Switched off, every caller makes its own request
+    HttpClientOptions opts;
+    opts.coalesce = false;
+    client.setOptions(opts);
+    reqs.resize(2);
+    rs = client.performAll(reqs);
+    BOOST_CHECK_EQUAL(server.requests(), 7);
+}
+
+BOOST_AUTO_TEST_CASE(coalesced_async_cancellation)
+{
+    LoopbackServer server;
+    HttpClient client;
+    HttpRequest req;
+    req.url = server.url("/hang");
+
+    // One caller giving up leaves the shared transfer to the other
+    CancelSource first, second;
+    auto a = client.performAsync(req, first.token());
+    auto b = client.performAsync(req, second.token());
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    first.cancel();
+    BOOST_CHECK(a.cancelled());
+    BOOST_CHECK(!b.ready());
+    BOOST_CHECK_EQUAL(client.inFlight(), 1u);
+
+    // The last one aborts it
+    second.cancel();
+    BOOST_REQUIRE(b.waitFor(std::chrono::seconds(2)));
+    BOOST_CHECK(b.cancelled());
+    BOOST_CHECK_EQUAL(client.inFlight(), 0u);
+    BOOST_CHECK_EQUAL(client.coalescing().inFlight, 0u);
+
+    // Survivors of a cancelled joiner, blocking ones included, get the response
+    req.url = server.url("/slow/c");
+    CancelSource third;
+    auto c = client.performAsync(req, third.token());
+    auto d = client.performAsync(req);
+    auto e = client.performAsync(req, third.token());
+    std::string blocking;
+    std::thread t([&]() { blocking = client.perform(req).text; });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    third.cancel();
+    BOOST_CHECK(c.cancelled());
+    BOOST_CHECK(e.cancelled());
+    BOOST_CHECK_EQUAL(d.get().text, "GET /slow/c 0");
+    t.join();
+    BOOST_CHECK_EQUAL(blocking, "GET /slow/c 0");
+    BOOST_CHECK_EQUAL(client.stats()[0].coalesced, 4u);
+    BOOST_CHECK_EQUAL(server.requests(), 2);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,94 @@
+// SPDX-License-Identifier: Apache-2.0
+//-------------------------------------------------------------------------------
+// Top100 — Your Personal Movie List
+//
+// File: tests/test_list_model.cpp
+// Purpose: Shared Qt list model: rows on screen map to the movies they show.
+// Language: C++17 (Boost.Test)
+//-------------------------------------------------------------------------------
+#define BOOST_TEST_MODULE Top100ListModel
+#include <boost/test/included/unit_test.hpp>
+#include "Top100ListModel.h"
+#include <QCoreApplication>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+namespace {
+
+Movie makeMovie(const std::string& id, double imdb, int meta) {
+    Movie m;
+    m.title = "Movie " + id;
+    m.year = 2000;
+    m.imdbID = id;
+    m.imdbRating = imdb;
+    m.metascore = meta;
+    return m;
+}
+
+struct ModelFixture {
+    int argc = 1;
+    char arg0[16] = "test_list_model";
+    char* argv[1] = {arg0};
+    QCoreApplication app{argc, argv};
+    std::string cfgPath = "test_list_model.json";
+    std::string dataPath = "test_list_model.db";
+
+    ModelFixture() {
+        setenv("TOP100_CONFIG_PATH", cfgPath.c_str(), 1);
+        std::remove(cfgPath.c_str());
+        std::remove(dataPath.c_str());
+        AppConfig cfg = loadConfig();
+        cfg.dataFile = dataPath;
+        // Stored weights rank by IMDb rating alone
+        cfg.sortWeightUserScore = 0;
+        cfg.sortWeightImdbRating = 1;
+        cfg.sortWeightMetascore = 0;
+        cfg.sortWeightRottenTomatoes = 0;
+        saveConfig(cfg);
+        Top100 list(dataPath);
+        list.addMovie(makeMovie("tt0000001", 9.0, 10));
+        list.addMovie(makeMovie("tt0000002", 5.0, 90));
+        list.addMovie(makeMovie("tt0000003", 8.0, 60));
+    }
+    ~ModelFixture() {
+        std::remove(cfgPath.c_str());
+        std::remove(dataPath.c_str());
+        unsetenv("TOP100_CONFIG_PATH");
+    }
+};
+
+std::string imdbAt(const Top100ListModel& model, int row) {
+    return model.data(model.index(row), Top100ListModel::ImdbIdRole).toString().toStdString();
+}
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(ListModelSuite, ModelFixture)
+
+BOOST_AUTO_TEST_CASE(pairwise_result_goes_to_the_rows_shown)
+{
+    Top100ListModel model;
+    model.setSortOrder(static_cast<int>(SortOrder::COMPOSITE));
+    // On screen: Metascore alone, which neither the config nor a fresh list uses
+    model.setCompositeWeights(0, 0, 1, 0);
+    BOOST_REQUIRE_EQUAL(model.rowCount(), 3);
+    BOOST_REQUIRE_EQUAL(imdbAt(model, 0), "tt0000002");
+    BOOST_REQUIRE_EQUAL(imdbAt(model, 1), "tt0000003");
+
+    // The second row shown beats the first
+    BOOST_REQUIRE(model.recordPairwiseResult(1, 0, 1));
+
+    Top100 list(dataPath);
+    const auto comparisons = list.getComparisons();
+    BOOST_REQUIRE_EQUAL(comparisons.size(), 1u);
+    const auto movies = list.getMovies();
+    auto scoreOf = [&](const std::string& id) {
+        return movies[static_cast<size_t>(list.findIndexByImdbId(id))].userScore;
+    };
+    BOOST_CHECK_GT(scoreOf("tt0000003"), 1500.0);
+    BOOST_CHECK_LT(scoreOf("tt0000002"), 1500.0);
+    BOOST_CHECK_EQUAL(scoreOf("tt0000001"), 1500.0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -25,6 +25,7 @@ BOOST_AUTO_TEST_CASE(show_config_when_omdb_disabled)
     BOOST_CHECK(out.find("Configure OMDb API key") != std::string::npos);
     BOOST_CHECK(out.find("Set data file path") != std::string::npos);
     BOOST_CHECK(out.find("Search and add from OMDb") == std::string::npos);
+    BOOST_CHECK(out.find("Refresh stale movies from OMDb") == std::string::npos);
 }
 
 BOOST_AUTO_TEST_CASE(show_omdb_when_enabled)
@@ -36,6 +37,7 @@ BOOST_AUTO_TEST_CASE(show_omdb_when_enabled)
     auto out = oss.str();
     BOOST_CHECK(out.find("Search and add from OMDb") != std::string::npos);
     BOOST_CHECK(out.find("Disable OMDb") != std::string::npos);
+    BOOST_CHECK(out.find("Refresh stale movies from OMDb") != std::string::npos);
     BOOST_CHECK(out.find("Configure OMDb API key") == std::string::npos);
 }
 
@@ -0,0 +1,618 @@
+// SPDX-License-Identifier: Apache-2.0
+//-------------------------------------------------------------------------------
+// Top100 — Your Personal Movie List
+//
+// File: tests/test_omdb.cpp
+// Purpose: Unit tests for OMDb client helpers that run without the network.
+// Language: C++17 (Boost.Test)
+//-------------------------------------------------------------------------------
+#define BOOST_TEST_MODULE Top100Omdb
+#include <boost/test/included/unit_test.hpp>
+#include "omdb.h"
+#include "omdb_cache.h"
+#include "omdb_decode.h"
+#include "fixture_server.h"
+#include "incremental_search.h"
+#include "omdb_refresh.h"
+#include "rate_limit.h"
+#include "shared_services.h"
+#include "config.h"
+#include "poster_cache.h"
+#include "top100.h"
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <future>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+BOOST_AUTO_TEST_SUITE(OmdbSuite)
+
+BOOST_AUTO_TEST_CASE(derive_short_plot)
+{
+    // Fits already: unchanged
+    BOOST_CHECK_EQUAL(deriveShortPlot("A hacker learns the truth.", 200), "A hacker learns the truth.");
+    BOOST_CHECK_EQUAL(deriveShortPlot("", 200), "");
+
+    // Whole sentences up to the limit
+    const std::string plot = "Neo is a hacker. He meets Morpheus. Together they fight the machines for the future of humanity.";
+    BOOST_CHECK_EQUAL(deriveShortPlot(plot, 40), "Neo is a hacker. He meets Morpheus.");
+    BOOST_CHECK_EQUAL(deriveShortPlot(plot, 20), "Neo is a hacker.");
+
+    // First sentence too long: cut at a word boundary with an ellipsis
+    const std::string longSentence = "An insomniac office worker and a devil-may-care soap maker form an underground fight club";
+    std::string cut = deriveShortPlot(longSentence, 30);
+    BOOST_CHECK_LE(cut.size(), 30u);
+    BOOST_CHECK_EQUAL(cut, "An insomniac office worker...");
+
+    // No spaces at all: never split a UTF-8 sequence
+    std::string word;
+    for (int i = 0; i < 20; ++i) word += "\xC3\xA9";   // é
+    cut = deriveShortPlot(word, 10);
+    BOOST_CHECK_LE(cut.size(), 10u);
+    BOOST_CHECK_EQUAL(cut.size() % 2, 1u);            // whole 2-byte chars + "..."
+}
+
+BOOST_AUTO_TEST_CASE(decode_detail_and_search_responses)
+{
+    const std::string detail = R"({"Title":"The Matrix","Year":"1999","Runtime":"136 min",
+        "Genre":"Action, Sci-Fi","Director":"Lana Wachowski, Lilly Wachowski",
+        "Actors":"Keanu Reeves,  Laurence Fishburne ,, Carrie-Anne Moss","Plot":"A hacker learns the truth.",
+        "Country":"United States, Australia","Poster":"N/A",
+        "Ratings":[{"Source":"Internet Movie Database","Value":"8.7/10"},{"Source":"Rotten Tomatoes","Value":"83%"},
+                   {"Source":"Rotten Tomatoes","Value":"1%"}],
+        "Metascore":"N/A","imdbRating":"8.7","imdbVotes":{"nested":[1,2,{"Title":"ignored"}]},"imdbID":"tt0133093",
+        "Response":"True"})";
+    OmdbDecodedDetail d = omdbDecodeDetail(detail);
+    BOOST_REQUIRE(d.response == OmdbResponse::Ok);
+    BOOST_CHECK_EQUAL(d.movie.title, "The Matrix");
+    BOOST_CHECK_EQUAL(d.movie.year, 1999);
+    BOOST_CHECK_EQUAL(d.movie.runtimeMinutes, 136);
+    BOOST_CHECK_EQUAL(d.movie.director, "Lana Wachowski, Lilly Wachowski");
+    BOOST_CHECK_EQUAL(d.movie.actors.size(), 3u);
+    BOOST_CHECK_EQUAL(d.movie.actors[1], "Laurence Fishburne");
+    BOOST_CHECK_EQUAL(d.movie.genres.size(), 2u);
+    BOOST_CHECK_EQUAL(d.movie.countries.back(), "Australia");
+    BOOST_CHECK_EQUAL(d.movie.posterUrl, "N/A");
+    BOOST_CHECK_EQUAL(d.movie.metascore, 0);
+    BOOST_CHECK_CLOSE(d.movie.imdbRating, 8.7, 1e-9);
+    BOOST_CHECK_EQUAL(d.movie.rottenTomatoes, 83);       // first entry wins
+    BOOST_CHECK_EQUAL(d.movie.imdbID, "tt0133093");
+    BOOST_CHECK_EQUAL(d.movie.source, "omdb");
+    BOOST_CHECK_EQUAL(d.plot, "A hacker learns the truth.");
+
+    // Year ranges, missing IDs and "N/A" plots
+    d = omdbDecodeDetail(R"({"Title":"Show","Year":"2005–2007","Plot":"N/A"})", "tt0000001");
+    BOOST_REQUIRE(d.response == OmdbResponse::Ok);
+    BOOST_CHECK_EQUAL(d.movie.year, 2005);
+    BOOST_CHECK_EQUAL(d.movie.imdbID, "tt0000001");
+    BOOST_CHECK(d.plot.empty());
+
+    // Errors and garbage
+    d = omdbDecodeDetail(R"({"Response":"False","Error":"Incorrect IMDb ID.","Title":"x"})");
+    BOOST_CHECK(d.response == OmdbResponse::Error);
+    BOOST_CHECK_EQUAL(d.error, "Incorrect IMDb ID.");
+    BOOST_CHECK(d.movie.title.empty());
+    BOOST_CHECK(omdbDecodeDetail(R"({"Title":"cut off)").response == OmdbResponse::Invalid);
+    BOOST_CHECK(omdbDecodeDetail("<html>502</html>").response == OmdbResponse::Invalid);
+    BOOST_CHECK(omdbDecodeDetail(R"(["Title","x"])").response == OmdbResponse::Invalid);
+    std::string err;
+    BOOST_CHECK(omdbResponseOf(R"({"Response":"False","Error":"Request limit reached!"})", &err) == OmdbResponse::Error);
+    BOOST_CHECK_EQUAL(err, "Request limit reached!");
+    BOOST_CHECK(omdbResponseOf(detail) == OmdbResponse::Ok);
+
+    OmdbDecodedSearch s = omdbDecodeSearch(R"({"Search":[
+        {"Title":"The Matrix","Year":"1999","imdbID":"tt0133093","Type":"movie","Poster":"N/A"},
+        {"Title":"The Matrix Reloaded","Year":"2003","imdbID":"tt0234215","Type":"movie"}],
+        "totalResults":"42","Response":"True"})");
+    BOOST_REQUIRE(s.response == OmdbResponse::Ok);
+    BOOST_REQUIRE_EQUAL(s.page.results.size(), 2u);
+    BOOST_CHECK_EQUAL(s.page.results[1].title, "The Matrix Reloaded");
+    BOOST_CHECK_EQUAL(s.page.results[1].year, 2003);
+    BOOST_CHECK_EQUAL(s.page.results[0].type, "movie");
+    BOOST_CHECK_EQUAL(s.page.totalResults, 42u);
+    s = omdbDecodeSearch(R"({"Response":"False","Error":"Movie not found!"})");
+    BOOST_CHECK(s.response == OmdbResponse::Error);
+    BOOST_CHECK(s.page.results.empty());
+
+    // List splitting honours the limit and appends
+    std::vector<std::string> items{"kept"};
+    omdbSplitList(" a, b ,c,d ", items, 3);
+    BOOST_REQUIRE_EQUAL(items.size(), 3u);
+    BOOST_CHECK_EQUAL(items[2], "b");
+    items.clear();
+    omdbSplitList(" , ,", items);
+    BOOST_CHECK(items.empty());
+}
+
+// Fresh cache database per test, detached from the OMDb client afterwards
+struct CacheFixture {
+    std::string path = "test_omdb_cache.db";
+    CacheFixture() { std::remove(path.c_str()); }
+    ~CacheFixture() {
+        omdbSetCache(nullptr);
+        std::remove(path.c_str());
+    }
+};
+
+BOOST_FIXTURE_TEST_CASE(cache_store_lookup_and_keys, CacheFixture)
+{
+    BOOST_CHECK_EQUAL(OmdbCache::searchKey("  The   MATRIX\t"), "search:the matrix");
+    BOOST_CHECK_EQUAL(OmdbCache::detailKey(" TT0133093 ", "full"), "title:tt0133093:full");
+
+    OmdbCache cache(path);
+    BOOST_REQUIRE(cache.isOpen());
+    BOOST_CHECK(!cache.lookup("search:x"));
+    OmdbCacheEntry e;
+    e.body = "{\"Response\":\"True\"}";
+    e.fetchedAt = 1000;
+    e.etag = "\"abc\"";
+    cache.store("search:x", e);
+    auto got = cache.lookup("search:x");
+    BOOST_REQUIRE(got);
+    BOOST_CHECK_EQUAL(got->body, e.body);
+    BOOST_CHECK_EQUAL(got->fetchedAt, 1000);
+    BOOST_CHECK_EQUAL(got->etag, e.etag);
+    BOOST_CHECK(got->lastModified.empty());
+    cache.touch("search:x", 2000);
+    BOOST_CHECK_EQUAL(cache.lookup("search:x")->fetchedAt, 2000);
+
+    // Persisted in the database, visible to another handle (another front end)
+    OmdbCache other(path);
+    BOOST_CHECK(other.lookup("search:x"));
+    cache.clear();
+    BOOST_CHECK(!other.lookup("search:x"));
+}
+
+BOOST_FIXTURE_TEST_CASE(fresh_entries_skip_the_network, CacheFixture)
+{
+    auto cache = std::make_shared<OmdbCache>(path);
+    BOOST_REQUIRE(cache->isOpen());
+    const int64_t now = OmdbCache::now();
+    OmdbCacheEntry search;
+    search.body = R"({"Search":[{"Title":"The Matrix","Year":"1999","imdbID":"tt0133093","Type":"movie"}],"Response":"True"})";
+    search.fetchedAt = now;
+    cache->store(OmdbCache::searchKey("the matrix"), search);
+    OmdbCacheEntry full;
+    full.body = R"({"Title":"The Matrix","Year":"1999","Director":"Lana Wachowski, Lilly Wachowski","imdbID":"tt0133093",)"
+                R"("Plot":"A long plot.","imdbRating":"8.7","Metascore":"73","Response":"True"})";
+    full.fetchedAt = now;
+    cache->store(OmdbCache::detailKey("tt0133093", "full"), full);
+    OmdbCacheEntry brief;
+    brief.body = R"({"Title":"The Matrix","Plot":"Short.","Response":"True"})";
+    brief.fetchedAt = now;
+    cache->store(OmdbCache::detailKey("tt0133093", "short"), brief);
+    omdbSetCache(cache);
+
+    // No usable key and no server: only the cache can answer these
+    auto hits = omdbSearch("no-key", "  The  Matrix ");
+    BOOST_REQUIRE_EQUAL(hits.size(), 1u);
+    BOOST_CHECK_EQUAL(hits[0].imdbID, "tt0133093");
+    BOOST_CHECK_EQUAL(hits[0].year, 1999);
+
+    auto m = omdbGetById("no-key", "tt0133093");
+    BOOST_REQUIRE(m);
+    BOOST_CHECK_EQUAL(m->title, "The Matrix");
+    BOOST_CHECK_EQUAL(m->plotFull, "A long plot.");
+    BOOST_CHECK_EQUAL(m->plotShort, "Short.");
+    BOOST_CHECK_CLOSE(m->imdbRating, 8.7, 1e-9);
+    BOOST_CHECK_EQUAL(m->metascore, 73);
+}
+
+BOOST_FIXTURE_TEST_CASE(stale_entries_revalidate_in_the_background, CacheFixture)
+{
+    const int64_t now = OmdbCache::now();
+    OmdbCacheEntry full;
+    full.body = R"({"Title":"The Matrix","Year":"1999","Director":"Lana Wachowski, Lilly Wachowski","imdbID":"tt0133093",)"
+                R"("Plot":"A long plot.","imdbRating":"8.7","Metascore":"73","Response":"True"})";
+
+    // Stale-while-revalidate answers from an expired entry without waiting;
+    // the background refresh goes to a loopback stand-in for OMDb
+    FixtureServer server;
+    BOOST_REQUIRE(server.ok());
+    server.addOmdbDetail(R"({"Title":"The Matrix","Year":"1999","imdbID":"tt0133093","Plot":"Refreshed.","Response":"True"})");
+    omdbSetBaseUrl(server.omdbUrl());
+    OmdbCacheOptions swr;
+    swr.staleWhileRevalidate = true;
+    swr.ratingsTtlSeconds = 1;
+    auto swrCache = std::make_shared<OmdbCache>(path, swr);
+    full.fetchedAt = now - 3600;
+    swrCache->store(OmdbCache::detailKey("tt0133093", "full"), full);
+    omdbSetCache(swrCache);
+    OmdbDetailOptions noShort;
+    noShort.fetchShortPlot = false;
+    auto m = omdbGetById("no-key", "tt0133093", noShort);
+    BOOST_REQUIRE(m);
+    BOOST_CHECK_EQUAL(m->plotFull, "A long plot.");
+    BOOST_CHECK_EQUAL(m->plotShort, "A long plot.");
+    swrCache->waitIdle();
+    BOOST_CHECK_EQUAL(server.stats().omdb, 1u);
+    auto refreshed = swrCache->lookup(OmdbCache::detailKey("tt0133093", "full"));
+    BOOST_REQUIRE(refreshed);
+    BOOST_CHECK_NE(refreshed->body.find("Refreshed."), std::string::npos);
+    omdbSetBaseUrl(std::string());
+}
+
+BOOST_FIXTURE_TEST_CASE(revalidation_is_deduplicated, CacheFixture)
+{
+    OmdbCache cache(path);
+    std::promise<void> release;
+    std::shared_future<void> gate = release.get_future().share();
+    std::atomic<int> runs{0};
+    BOOST_CHECK(cache.revalidateAsync("k", [&]() { gate.wait(); ++runs; }));
+    BOOST_CHECK(!cache.revalidateAsync("k", [&]() { ++runs; }));
+    BOOST_CHECK(cache.revalidateAsync("other", [&]() { ++runs; }));
+    release.set_value();
+    cache.waitIdle();
+    BOOST_CHECK_EQUAL(runs.load(), 2);
+    BOOST_CHECK(cache.revalidateAsync("k", [&]() { ++runs; }));
+    cache.waitIdle();
+    BOOST_CHECK_EQUAL(runs.load(), 3);
+}
+
+BOOST_FIXTURE_TEST_CASE(shared_services_report_what_fails, CacheFixture)
+{
+    AppConfig cfg;
+    cfg.dataFile = path;
+    BOOST_CHECK(initSharedServices(cfg).empty());
+    BOOST_CHECK(omdbCache());
+    BOOST_CHECK(posterCache());
+
+    // A missing index is reported; the caches are still installed
+    cfg.omdbLocalIndexPath = "test_services_missing.idx";
+    const std::vector<std::string> errors = initSharedServices(cfg);
+    BOOST_REQUIRE_EQUAL(errors.size(), 1u);
+    BOOST_CHECK_EQUAL(errors[0].rfind("Title index:", 0), 0u);
+    BOOST_CHECK(omdbCache());
+
+    // Caching turned off is not an error
+    cfg.omdbLocalIndexPath.clear();
+    cfg.omdbCacheEnabled = false;
+    BOOST_CHECK(initSharedServices(cfg).empty());
+    BOOST_CHECK(!omdbCache());
+    setPosterCache(nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(token_bucket_limits_rate)
+{
+    TokenBucket bucket(50.0, 5.0);
+    // A full bucket allows a burst, then runs dry
+    for (int i = 0; i < 5; ++i) BOOST_CHECK(bucket.tryAcquire());
+    BOOST_CHECK(!bucket.tryAcquire());
+    // Ten more tokens at 50/s take about 200 ms
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < 10; ++i) BOOST_CHECK(bucket.acquire());
+    const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    BOOST_CHECK_GE(ms, 150);
+    BOOST_CHECK_LT(ms, 2000);
+
+    std::atomic<bool> cancel{true};
+    BOOST_CHECK(!bucket.acquire(&cancel));
+    TokenBucket unlimited(0.0, 1.0);
+    for (int i = 0; i < 100; ++i) BOOST_CHECK(unlimited.tryAcquire());
+}
+
+// Canned answers: "tt1".."tt20" succeed, "bad" is unknown, "flaky" needs two
+// retries, "quota" exhausts the daily limit.
+struct FakeOmdb {
+    std::mutex mutex;
+    std::map<std::string, int> calls;
+    std::atomic<int> inFlight{0}, maxInFlight{0};
+
+    OmdbDetailResult operator()(const std::string& id) {
+        const int now = ++inFlight;
+        int seen = maxInFlight.load();
+        while (now > seen && !maxInFlight.compare_exchange_weak(seen, now)) {}
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        int n;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            n = ++calls[id];
+        }
+        --inFlight;
+        OmdbDetailResult r;
+        if (id == "bad") r.error = OmdbError::NotFound;
+        else if (id == "quota") r.error = OmdbError::QuotaExceeded;
+        else if (id == "flaky" && n < 3) r.error = OmdbError::Transient;
+        else {
+            r.movie = Movie{"Title " + id, 2000, "Director"};
+            r.movie->imdbID = id;
+            r.movie->updatedAt = 42;
+        }
+        return r;
+    }
+};
+
+BOOST_AUTO_TEST_CASE(fetch_many_retries_and_reports)
+{
+    FakeOmdb fake;
+    std::vector<std::string> ids;
+    for (int i = 1; i <= 20; ++i) ids.push_back("tt" + std::to_string(i));
+    ids.push_back("bad");
+    ids.push_back("flaky");
+
+    OmdbRefreshOptions opts;
+    opts.concurrency = 4;
+    opts.requestsPerSecond = 0;   // unlimited
+    opts.baseBackoffMs = 5;
+    opts.maxBackoffMs = 20;
+    opts.fetch = std::ref(fake);
+    std::vector<size_t> done;
+    opts.onProgress = [&](const OmdbRefreshProgress& p) {
+        BOOST_CHECK_EQUAL(p.total, ids.size());
+        done.push_back(p.done);
+    };
+    auto result = omdbFetchMany("no-key", ids, opts);
+    BOOST_REQUIRE_EQUAL(result.movies.size(), 21u);
+    BOOST_CHECK_EQUAL(result.movies.front().imdbID, "tt1");     // request order kept
+    BOOST_CHECK_EQUAL(result.movies.back().imdbID, "flaky");
+    BOOST_REQUIRE_EQUAL(result.failed.size(), 1u);
+    BOOST_CHECK_EQUAL(result.failed[0], "bad");
+    BOOST_CHECK_EQUAL(fake.calls["flaky"], 3);
+    BOOST_CHECK_EQUAL(fake.calls["bad"], 1);                    // not-found is not retried
+    BOOST_CHECK_LE(fake.maxInFlight.load(), 4);
+    BOOST_CHECK_GT(fake.maxInFlight.load(), 1);
+    BOOST_REQUIRE_EQUAL(done.size(), ids.size());
+    for (size_t k = 0; k < done.size(); ++k) BOOST_CHECK_EQUAL(done[k], k + 1);
+    BOOST_CHECK(!result.cancelled);
+    BOOST_CHECK(result.stoppedBy == OmdbError::None);
+
+    // A quota error stops the run instead of burning through the rest
+    FakeOmdb limited;
+    opts.fetch = std::ref(limited);
+    opts.onProgress = nullptr;
+    opts.concurrency = 1;
+    result = omdbFetchMany("no-key", {"tt1", "quota", "tt2", "tt3"}, opts);
+    BOOST_CHECK(result.stoppedBy == OmdbError::QuotaExceeded);
+    BOOST_CHECK_EQUAL(result.movies.size(), 1u);
+    BOOST_CHECK_EQUAL(limited.calls.count("tt3"), 0u);
+
+    // Cancellation before the run: nothing is fetched
+    std::atomic<bool> cancel{true};
+    opts.cancel = &cancel;
+    FakeOmdb idle;
+    opts.fetch = std::ref(idle);
+    result = omdbFetchMany("no-key", ids, opts);
+    BOOST_CHECK(result.cancelled);
+    BOOST_CHECK(result.movies.empty());
+    BOOST_CHECK(idle.calls.empty());
+}
+
+BOOST_FIXTURE_TEST_CASE(refresh_merges_stale_movies, CacheFixture)
+{
+#ifndef TOP100_NO_SQLITE
+    const long long now = static_cast<long long>(OmdbCache::now());
+    {
+        Top100 list(path);
+        Movie fresh{"Fresh", 2001, "A"};
+        fresh.imdbID = "tt1";
+        fresh.updatedAt = now;
+        Movie stale{"Stale", 2002, "B"};
+        stale.imdbID = "tt2";
+        stale.updatedAt = now - 10 * 24 * 3600;
+        Movie never{"Never", 2003, "C"};
+        never.imdbID = "tt3";
+        never.userScore = 1600.0;
+        Movie manual{"Manual", 2004, "D"};
+        for (const auto& m : {fresh, stale, never, manual}) list.addMovie(m);
+        list.recomputeRanks();
+
+        const auto ids = list.staleImdbIds(7 * 24 * 3600);
+        BOOST_REQUIRE_EQUAL(ids.size(), 2u);
+        BOOST_CHECK_EQUAL(ids[0], "tt2");
+        BOOST_CHECK_EQUAL(ids[1], "tt3");
+        BOOST_CHECK_EQUAL(list.staleImdbIds(0).size(), 3u);
+
+        FakeOmdb fake;
+        OmdbRefreshOptions opts;
+        opts.requestsPerSecond = 0;
+        opts.fetch = std::ref(fake);
+        auto result = refreshStaleMovies(list, "no-key", 7 * 24 * 3600, opts);
+        BOOST_CHECK_EQUAL(result.merged, 2u);
+        BOOST_CHECK_EQUAL(fake.calls.count("tt1"), 0u);
+    }
+    // Merged metadata and timestamps persisted; ranking fields kept
+    Top100 reopened(path);
+    auto movies = reopened.getMovies();
+    BOOST_REQUIRE_EQUAL(movies.size(), 4u);
+    BOOST_CHECK_EQUAL(movies[0].title, "Fresh");
+    BOOST_CHECK_EQUAL(movies[0].updatedAt, now);
+    BOOST_CHECK_EQUAL(movies[1].title, "Title tt2");
+    BOOST_CHECK_EQUAL(movies[1].updatedAt, 42);
+    BOOST_CHECK_EQUAL(movies[2].title, "Title tt3");
+    BOOST_CHECK_CLOSE(movies[2].userScore, 1600.0, 1e-9);
+    BOOST_CHECK_EQUAL(movies[2].userRank, 1);
+    BOOST_CHECK_EQUAL(movies[3].updatedAt, 0);
+#else
+    BOOST_TEST_MESSAGE("SQLite not available; skipping DB-specific test (TOP100_NO_SQLITE defined)");
+#endif
+}
+
+// Collects listener updates so tests can wait for them
+struct UpdateLog {
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<SearchUpdate> updates;
+
+    IncrementalSearch::Listener listener() {
+        return [this](const SearchUpdate& u) {
+            std::lock_guard<std::mutex> lock(mutex);
+            updates.push_back(u);
+            cv.notify_all();
+        };
+    }
+    // Wait until there are @p n updates; @return the n-th
+    SearchUpdate wait(size_t n) {
+        std::unique_lock<std::mutex> lock(mutex);
+        BOOST_REQUIRE(cv.wait_for(lock, std::chrono::seconds(5), [&]() { return updates.size() >= n; }));
+        return updates[n - 1];
+    }
+    size_t size() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return updates.size();
+    }
+};
+
+// Search pages answered by the test, one pending promise per request
+struct ManualPages {
+    struct Call {
+        std::string query;
+        int page;
+        CancelToken cancel;
+        Promise<OmdbSearchPage> promise;
+    };
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<Call> calls;
+
+    Future<OmdbSearchPage> operator()(const std::string& q, int page, CancelToken cancel) {
+        std::lock_guard<std::mutex> lock(mutex);
+        calls.push_back(Call{q, page, cancel, Promise<OmdbSearchPage>()});
+        cv.notify_all();
+        return calls.back().promise.future();
+    }
+    bool waitCalls(size_t n, std::chrono::milliseconds timeout) {
+        std::unique_lock<std::mutex> lock(mutex);
+        return cv.wait_for(lock, timeout, [&]() { return calls.size() >= n; });
+    }
+    Call call(size_t i) {
+        std::lock_guard<std::mutex> lock(mutex);
+        return calls.at(i);
+    }
+};
+
+static OmdbSearchPage pageOf(std::initializer_list<const char*> titles, size_t total) {
+    OmdbSearchPage p;
+    for (const char* t : titles) p.results.push_back(OmdbSearchResult{t, 2000, std::string("tt-") + t, "movie"});
+    p.totalResults = total;
+    return p;
+}
+
+BOOST_AUTO_TEST_CASE(search_debounces_and_cancels)
+{
+    UpdateLog log;
+    auto pages = std::make_shared<ManualPages>();
+    IncrementalSearchOptions opts;
+    opts.debounceMs = 1000;
+    opts.fetch = [pages](const std::string& q, int page, CancelToken c) { return (*pages)(q, page, c); };
+    IncrementalSearch search("no-key", log.listener(), opts);
+
+    // Keystrokes inside the debounce window coalesce into one request
+    for (const char* q : {"ma", "mat", "matr", "matrix"}) search.setQuery(q);
+    BOOST_REQUIRE(pages->waitCalls(1, std::chrono::seconds(5)));
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    BOOST_CHECK_EQUAL(search.networkRequests(), 1u);
+    BOOST_CHECK_EQUAL(pages->call(0).query, "matrix");
+    BOOST_CHECK_EQUAL(pages->call(0).page, 1);
+
+    // A new query cancels the one in flight; submit() skips the debounce
+    const auto start = std::chrono::steady_clock::now();
+    search.setQuery("alien ");
+    search.submit();
+    BOOST_REQUIRE(pages->waitCalls(2, std::chrono::seconds(5)));
+    BOOST_CHECK_LT(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(), 0.5);
+    BOOST_CHECK(pages->call(0).cancel.cancelled());
+    BOOST_CHECK_EQUAL(pages->call(1).query, "alien");
+
+    // The superseded answer is dropped even if it arrives
+    pages->call(0).promise.setValue(pageOf({"The Matrix"}, 1));
+    pages->call(1).promise.setValue(pageOf({"Alien", "Aliens"}, 2));
+    SearchUpdate u = log.wait(1);
+    BOOST_CHECK_EQUAL(u.query, "alien");
+    BOOST_REQUIRE_EQUAL(u.results.size(), 2u);
+    BOOST_CHECK_EQUAL(u.results[1].title, "Aliens");
+    BOOST_CHECK(!u.provisional);
+    BOOST_CHECK(!u.hasMore);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    BOOST_CHECK_EQUAL(log.size(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(search_reuses_prefixes_and_prefetches)
+{
+    // 12 "Star Wars" and 13 "Star Trek" titles; OMDb-like whole-word matching, 10 per page
+    std::vector<std::string> titles;
+    for (int i = 1; i <= 12; ++i) titles.push_back("Star Wars " + std::to_string(i));
+    for (int i = 1; i <= 13; ++i) titles.push_back("Star Trek " + std::to_string(i));
+    std::atomic<int> served{0};
+    auto fetch = [&titles, &served](const std::string& q, int page, CancelToken) {
+        ++served;
+        std::vector<std::string> hits;
+        for (const auto& t : titles) {
+            std::string lower = t;
+            for (auto& c : lower) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+            bool all = true;
+            std::istringstream words(q);
+            for (std::string w; words >> w;) all = all && (" " + lower + " ").find(" " + w + " ") != std::string::npos;
+            if (all) hits.push_back(t);
+        }
+        OmdbSearchPage p;
+        p.totalResults = hits.size();
+        for (size_t i = static_cast<size_t>(page - 1) * 10; i < hits.size() && i < static_cast<size_t>(page) * 10; ++i) {
+            p.results.push_back(OmdbSearchResult{hits[i], 1977, "tt" + std::to_string(i), "movie"});
+        }
+        return readyFuture(std::move(p));
+    };
+
+    UpdateLog log;
+    IncrementalSearchOptions opts;
+    opts.debounceMs = 0;
+    opts.fetch = fetch;
+    IncrementalSearch search("no-key", log.listener(), opts);
+    search.setQuery("star");
+    SearchUpdate u = log.wait(1);
+    BOOST_CHECK_EQUAL(u.results.size(), 10u);
+    BOOST_CHECK_EQUAL(u.totalResults, 25u);
+    BOOST_CHECK(u.hasMore);
+    BOOST_CHECK(!u.fromCache);
+
+    // Page 2 was prefetched, so loadMore() answers without waiting for the network
+    for (int i = 0; i < 100 && search.networkRequests() < 2; ++i) std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    BOOST_CHECK_EQUAL(search.networkRequests(), 2u);
+    search.loadMore();
+    u = log.wait(2);
+    BOOST_CHECK_EQUAL(u.results.size(), 20u);
+    BOOST_CHECK(u.fromCache);
+    search.loadMore();
+    u = log.wait(3);
+    BOOST_CHECK_EQUAL(u.results.size(), 25u);
+    BOOST_CHECK(!u.hasMore);
+    const size_t afterStar = search.networkRequests();
+    BOOST_CHECK_EQUAL(afterStar, 3u);
+
+    // "star wars" narrows the complete "star" results: no request
+    search.setQuery("Star  Wars");
+    u = log.wait(4);
+    BOOST_CHECK_EQUAL(u.query, "Star  Wars");
+    BOOST_CHECK_EQUAL(u.results.size(), 12u);
+    BOOST_CHECK(u.fromCache);
+    BOOST_CHECK(!u.provisional);
+    // Going back is a cache hit too
+    search.setQuery("star");
+    u = log.wait(5);
+    BOOST_CHECK(u.fromCache);
+    BOOST_CHECK_EQUAL(u.results.size(), 10u);
+    BOOST_CHECK_EQUAL(search.networkRequests(), afterStar);
+
+    // With only page 1 of the broader query known, its filtered hits are shown
+    // provisionally while the real answer is fetched
+    UpdateLog partial;
+    opts.prefetchNextPage = false;
+    IncrementalSearch shallow("no-key", partial.listener(), opts);
+    shallow.setQuery("star");
+    BOOST_CHECK_EQUAL(partial.wait(1).results.size(), 10u);
+    shallow.setQuery("star trek");
+    u = partial.wait(2);
+    BOOST_CHECK(u.provisional);
+    BOOST_CHECK_EQUAL(u.results.size(), 0u);   // page 1 of "star" held only Star Wars titles
+    u = partial.wait(3);
+    BOOST_CHECK(!u.provisional);
+    BOOST_CHECK_EQUAL(u.results.size(), 10u);
+    BOOST_CHECK_EQUAL(u.totalResults, 13u);
+    BOOST_CHECK_EQUAL(shallow.networkRequests(), 2u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
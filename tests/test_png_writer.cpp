@@ -0,0 +1,260 @@
+// SPDX-License-Identifier: Apache-2.0
+//-------------------------------------------------------------------------------
+// Top100 — Your Personal Movie List
+//
+// File: tests/test_png_writer.cpp
+// Purpose: Streaming PNG encoder: chunk layout, pixel round trip and errors.
+// Language: C++17 (Boost.Test)
+//-------------------------------------------------------------------------------
+#define BOOST_TEST_MODULE Top100PngWriter
+#include <boost/test/included/unit_test.hpp>
+#include "png_writer.h"
+#include "thread_pool.h"
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+#if TOP100_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+namespace {
+
+#if TOP100_HAVE_ZLIB
+uint32_t be32(const std::string& s, size_t at) {
+    return (uint32_t(uint8_t(s[at])) << 24) | (uint32_t(uint8_t(s[at + 1])) << 16) |
+           (uint32_t(uint8_t(s[at + 2])) << 8) | uint32_t(uint8_t(s[at + 3]));
+}
+
+// A PNG read back by hand: chunk payloads (IDATs joined) and the unfiltered rows
+struct ReadPng {
+    std::map<std::string, std::string> chunks;
+    std::vector<std::string> order;
+    std::vector<std::vector<unsigned char>> rows;
+    std::vector<int> filters;
+    int idatCount = 0;
+};
+
+int paeth(int a, int b, int c) {
+    const int p = a + b - c;
+    const int pa = std::abs(p - a), pb = std::abs(p - b), pc = std::abs(p - c);
+    if (pa <= pb && pa <= pc) return a;
+    return pb <= pc ? b : c;
+}
+
+ReadPng readPng(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    std::ostringstream ss;
+    ss << in.rdbuf();
+    const std::string file = ss.str();
+    BOOST_REQUIRE(file.size() > 8);
+    BOOST_REQUIRE(file.compare(0, 8, std::string("\x89PNG\r\n\x1a\n", 8)) == 0);
+    ReadPng png;
+    for (size_t at = 8; at < file.size();) {
+        BOOST_REQUIRE(at + 12 <= file.size());
+        const uint32_t len = be32(file, at);
+        const std::string type = file.substr(at + 4, 4);
+        BOOST_REQUIRE(at + 12 + len <= file.size());
+        const uLong crc = crc32(0L, reinterpret_cast<const Bytef*>(file.data() + at + 4), len + 4);
+        BOOST_CHECK_EQUAL(crc, be32(file, at + 8 + len));
+        if (type == "IDAT") ++png.idatCount;
+        if (png.order.empty() || png.order.back() != type) png.order.push_back(type);
+        png.chunks[type] += file.substr(at + 8, len);
+        at += 12 + len;
+    }
+    const std::string& ihdr = png.chunks["IHDR"];
+    BOOST_REQUIRE_EQUAL(ihdr.size(), 13u);
+    const uint32_t w = be32(ihdr, 0), h = be32(ihdr, 4);
+    const size_t bpp = ihdr[9] == 6 ? 4 : 3;
+    const size_t rowBytes = w * bpp;
+    std::vector<unsigned char> raw(h * (rowBytes + 1));
+    uLongf rawSize = raw.size();
+    const std::string& idat = png.chunks["IDAT"];
+    BOOST_REQUIRE_EQUAL(uncompress(raw.data(), &rawSize, reinterpret_cast<const Bytef*>(idat.data()), idat.size()),
+                        Z_OK);
+    BOOST_REQUIRE_EQUAL(rawSize, raw.size());
+    std::vector<unsigned char> prev(rowBytes, 0);
+    for (uint32_t y = 0; y < h; ++y) {
+        const unsigned char* f = raw.data() + y * (rowBytes + 1);
+        png.filters.push_back(f[0]);
+        std::vector<unsigned char> row(rowBytes);
+        for (size_t i = 0; i < rowBytes; ++i) {
+            const int a = i >= bpp ? row[i - bpp] : 0, b = prev[i], c = i >= bpp ? prev[i - bpp] : 0;
+            const int pred = f[0] == 1 ? a : f[0] == 2 ? b : f[0] == 3 ? (a + b) / 2 : f[0] == 4 ? paeth(a, b, c) : 0;
+            row[i] = static_cast<unsigned char>(f[1 + i] + pred);
+        }
+        png.rows.push_back(row);
+        prev = row;
+    }
+    return png;
+}
+
+// Export-like test image: white rows, flat blocks, gradients and noise
+std::vector<uint32_t> sampleImage(int w, int h) {
+    std::vector<uint32_t> pixels(static_cast<size_t>(w) * h);
+    unsigned seed = 7;
+    for (int y = 0; y < h; ++y)
+        for (int x = 0; x < w; ++x) {
+            seed = seed * 1103515245u + 12345u;
+            const uint32_t r = y < 40 ? 255 : uint32_t(x + y) & 0xFF;
+            const uint32_t g = y < 40 ? 255 : uint32_t(x * 3) & 0xFF;
+            const uint32_t b = y < 40 ? 255 : y < 100 ? uint32_t(y) : (seed >> 16) & 0xFF;
+            pixels[static_cast<size_t>(y) * w + x] = 0xFF000000u | (r << 16) | (g << 8) | b;
+        }
+    return pixels;
+}
+
+bool sameRgb(const std::vector<uint32_t>& pixels, int w, const ReadPng& read) {
+    for (size_t y = 0; y < read.rows.size(); ++y)
+        for (int x = 0; x < w; ++x) {
+            const uint32_t p = pixels[y * w + x];
+            const unsigned char* q = read.rows[y].data() + x * 3;
+            if (q[0] != ((p >> 16) & 0xFF) || q[1] != ((p >> 8) & 0xFF) || q[2] != (p & 0xFF)) return false;
+        }
+    return true;
+}
+#endif
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(PngWriterSuite)
+
+BOOST_AUTO_TEST_CASE(rows_round_trip) {
+#if TOP100_HAVE_ZLIB
+    // Flat bands, gradients and noise, so every filter type gets picked somewhere
+    const int w = 203, h = 151;
+    const std::vector<uint32_t> pixels = sampleImage(w, h);
+    const std::string path = "test_png_writer.png";
+    PngWriter png;
+    PngWriterOptions opts;
+    opts.dpi = 300;
+    BOOST_REQUIRE_MESSAGE(png.open(path, w, h, opts), png.error());
+    // Uneven bands, the way the exporter hands them over
+    int y = 0;
+    for (int band : {1, 60, 17, 73}) {
+        BOOST_REQUIRE(png.writeRows(reinterpret_cast<const unsigned char*>(pixels.data() + size_t(y) * w), band, w * 4));
+        y += band;
+    }
+    BOOST_CHECK_EQUAL(png.rowsWritten(), h);
+    BOOST_REQUIRE_MESSAGE(png.finish(), png.error());
+
+    const ReadPng read = readPng(path);
+    BOOST_CHECK((read.order == std::vector<std::string>{"IHDR", "pHYs", "IDAT", "IEND"}));
+    const std::string& ihdr = read.chunks.at("IHDR");
+    BOOST_CHECK_EQUAL(be32(ihdr, 0), uint32_t(w));
+    BOOST_CHECK_EQUAL(be32(ihdr, 4), uint32_t(h));
+    BOOST_CHECK_EQUAL(int(ihdr[9]), 2);
+    BOOST_CHECK_EQUAL(be32(read.chunks.at("pHYs"), 0), 11811u);   // 300 dpi in pixels per metre
+    BOOST_REQUIRE_EQUAL(read.rows.size(), size_t(h));
+    BOOST_CHECK(sameRgb(pixels, w, read));
+    // White rows: the first single-colour one as Sub, the repeats as Up
+    BOOST_CHECK_EQUAL(read.filters[0], 1);
+    BOOST_CHECK_EQUAL(read.filters[1], 2);
+    BOOST_CHECK_EQUAL(read.filters[39], 2);
+    std::remove(path.c_str());
+#else
+    PngWriter png;
+    BOOST_CHECK(!PngWriter::available());
+    BOOST_CHECK(!png.open("test_png_writer.png", 4, 4));
+#endif
+}
+
+BOOST_AUTO_TEST_CASE(parallel_chunks_form_one_stream) {
+#if TOP100_HAVE_ZLIB
+    // Large enough for several 256 KiB chunks
+    const int w = 640, h = 700;
+    const std::vector<uint32_t> pixels = sampleImage(w, h);
+    const std::string path = "test_png_writer_parallel.png";
+    for (int level : {0, 1, 6, 9}) {
+        PngWriterOptions opts;
+        opts.level = level;
+        opts.threads = 4;
+        PngWriter png;
+        BOOST_REQUIRE(png.open(path, w, h, opts));
+        for (int y = 0; y < h; y += 50)
+            BOOST_REQUIRE(png.writeRows(reinterpret_cast<const unsigned char*>(pixels.data() + size_t(y) * w),
+                                        std::min(50, h - y), w * 4));
+        BOOST_REQUIRE_MESSAGE(png.finish(), png.error());
+        const ReadPng read = readPng(path);   // one zlib stream: inflates in one go, Adler-32 checked
+        BOOST_CHECK_GT(read.idatCount, 1);
+        BOOST_REQUIRE_EQUAL(read.rows.size(), size_t(h));
+        BOOST_CHECK_MESSAGE(sameRgb(pixels, w, read), "level " << level);
+    }
+
+    // On a pool the caller also runs other work on (image export)
+    ThreadPool pool(3);
+    PngWriterOptions opts;
+    opts.pool = &pool;
+    PngWriter png;
+    BOOST_REQUIRE(png.open(path, w, h, opts));
+    std::vector<std::future<int>> other;
+    for (int y = 0; y < h; y += 50) {
+        other.push_back(pool.submit([y]() { return y; }));
+        BOOST_REQUIRE(png.writeRows(reinterpret_cast<const unsigned char*>(pixels.data() + size_t(y) * w),
+                                    std::min(50, h - y), w * 4));
+    }
+    BOOST_REQUIRE_MESSAGE(png.finish(), png.error());
+    for (size_t i = 0; i < other.size(); ++i) BOOST_CHECK_EQUAL(other[i].get(), int(i) * 50);
+    const ReadPng read = readPng(path);
+    BOOST_CHECK_GT(read.idatCount, 1);
+    BOOST_REQUIRE_EQUAL(read.rows.size(), size_t(h));
+    BOOST_CHECK(sameRgb(pixels, w, read));
+    std::remove(path.c_str());
+#endif
+}
+
+BOOST_AUTO_TEST_CASE(alpha_is_unpremultiplied) {
+#if TOP100_HAVE_ZLIB
+    // Opaque, half-transparent and fully transparent pixels, premultiplied
+    const std::vector<uint32_t> pixels{0xFF102030u, 0x80400000u, 0x00000000u, 0x80808080u};
+    const std::string path = "test_png_writer_alpha.png";
+    PngWriter png;
+    PngWriterOptions opts;
+    opts.alpha = true;
+    opts.level = 9;
+    BOOST_REQUIRE(png.open(path, 2, 2, opts));
+    BOOST_REQUIRE(png.writeRows(reinterpret_cast<const unsigned char*>(pixels.data()), 2, 8));
+    BOOST_REQUIRE(png.finish());
+    const ReadPng read = readPng(path);
+    BOOST_CHECK_EQUAL(int(read.chunks.at("IHDR")[9]), 6);
+    BOOST_CHECK_EQUAL(read.chunks.count("pHYs"), 0u);
+    const std::vector<unsigned char> row0{0x10, 0x20, 0x30, 0xFF, 0x80, 0x00, 0x00, 0x80};
+    const std::vector<unsigned char> row1{0x00, 0x00, 0x00, 0x00, 0xFF, 0xFF, 0xFF, 0x80};
+    BOOST_CHECK(read.rows[0] == row0);
+    BOOST_CHECK(read.rows[1] == row1);
+    std::remove(path.c_str());
+#endif
+}
+
+BOOST_AUTO_TEST_CASE(incomplete_images_are_not_kept) {
+#if TOP100_HAVE_ZLIB
+    const std::string path = "test_png_writer_short.png";
+    const std::vector<uint32_t> row(10, 0xFFFFFFFFu);
+    {
+        PngWriter png;
+        BOOST_CHECK(!png.open(path, 0, 5));
+        BOOST_REQUIRE(png.open(path, 10, 3));
+        BOOST_CHECK(png.writeRows(reinterpret_cast<const unsigned char*>(row.data()), 1, 40));
+        BOOST_CHECK(!png.writeRows(reinterpret_cast<const unsigned char*>(row.data()), 3, 0));   // past the height
+        BOOST_CHECK(!png.error().empty());
+        BOOST_CHECK(!png.finish());
+        BOOST_CHECK(!std::filesystem::exists(path));
+    }
+    {
+        // Abandoned without finish()
+        PngWriter png;
+        BOOST_REQUIRE(png.open(path, 10, 3));
+        BOOST_CHECK(png.writeRows(reinterpret_cast<const unsigned char*>(row.data()), 2, 0));
+    }
+    BOOST_CHECK(!std::filesystem::exists(path));
+    PngWriter png;
+    BOOST_CHECK(!png.open("no_such_directory/out.png", 10, 3));
+    BOOST_CHECK(!png.error().empty());
+#endif
+}
+
+BOOST_AUTO_TEST_SUITE_END()
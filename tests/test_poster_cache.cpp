@@ -0,0 +1,527 @@
+// SPDX-License-Identifier: Apache-2.0
+//-------------------------------------------------------------------------------
+// Top100 — Your Personal Movie List
+//
+// File: tests/test_poster_cache.cpp
+// Purpose: Poster decoding and scaling, and the memory, database and network tiers of the poster cache.
+// Language: C++17 (Boost.Test)
+//-------------------------------------------------------------------------------
+#define BOOST_TEST_MODULE Top100PosterCache
+#include <boost/test/included/unit_test.hpp>
+#include "fixture_server.h"
+#include "poster_cache.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#if TOP100_HAVE_JPEG
+extern "C" {
+#include <jpeglib.h>
+}
+#endif
+
+// Fixture server with synthesized posters and a fresh cache database per test
+struct PosterFixture {
+    FixtureServer server;
+    std::vector<std::string> ids;
+    std::string path = "test_poster_cache.db";
+
+    PosterFixture() {
+        BOOST_REQUIRE_MESSAGE(server.ok(), server.error());
+        ids = server.synthesize(12, 24);
+        std::remove(path.c_str());
+    }
+    ~PosterFixture() { std::remove(path.c_str()); }
+
+    std::string url(size_t i) const { return server.posterUrl(ids[i] + ".png"); }
+};
+
+BOOST_AUTO_TEST_SUITE(PosterCacheSuite)
+
+static PosterBitmap solid(int w, int h, uint32_t argb) {
+    PosterBitmap b;
+    b.width = w;
+    b.height = h;
+    b.pixels.assign(static_cast<size_t>(w) * h, argb);
+    return b;
+}
+
+BOOST_AUTO_TEST_CASE(scaling_fits_and_averages)
+{
+    // Fits the box, keeping the aspect ratio
+    auto tall = scalePosterBitmap(solid(300, 450, 0xFF336699u), 170, 170);
+    BOOST_REQUIRE(tall);
+    BOOST_CHECK_EQUAL(tall->width, 113);
+    BOOST_CHECK_EQUAL(tall->height, 170);
+    BOOST_CHECK_EQUAL(tall->pixels[57 * 113 + 40], 0xFF336699u);
+
+    // Shrinking averages what each pixel covers: a checkerboard turns grey
+    PosterBitmap checker = solid(4, 4, 0);
+    for (int y = 0; y < 4; ++y)
+        for (int x = 0; x < 4; ++x) checker.pixels[y * 4 + x] = ((x + y) & 1) ? 0xFFFFFFFFu : 0xFF000000u;
+    auto grey = scalePosterBitmap(checker, 2, 2);
+    BOOST_REQUIRE(grey);
+    BOOST_REQUIRE_EQUAL(grey->pixels.size(), 4u);
+    for (uint32_t p : grey->pixels) BOOST_CHECK_EQUAL(p, 0xFF808080u);
+
+    // Premultiplied: half-covered pixels average with transparent ones
+    PosterBitmap edge = solid(2, 1, 0);
+    edge.pixels[0] = 0x80808080u;
+    auto half = scalePosterBitmap(edge, 1, 1);
+    BOOST_REQUIRE(half);
+    BOOST_CHECK_EQUAL(half->pixels[0], 0x40404040u);
+
+    // Enlarging, and nothing to scale
+    auto big = scalePosterBitmap(solid(1, 1, 0xFF102030u), 10, 20);
+    BOOST_REQUIRE(big);
+    BOOST_CHECK_EQUAL(big->width, 10);
+    BOOST_CHECK_EQUAL(big->height, 10);
+    BOOST_CHECK_EQUAL(big->pixels[55], 0xFF102030u);
+    BOOST_CHECK(!scalePosterBitmap(PosterBitmap(), 10, 10));
+}
+
+#if TOP100_HAVE_JPEG
+// Baseline JPEG of one colour
+static std::string encodeJpeg(int w, int h, unsigned char r, unsigned char g, unsigned char b) {
+    jpeg_compress_struct cinfo;
+    jpeg_error_mgr err;
+    cinfo.err = jpeg_std_error(&err);
+    jpeg_create_compress(&cinfo);
+    unsigned char* buf = nullptr;
+    unsigned long size = 0;
+    jpeg_mem_dest(&cinfo, &buf, &size);
+    cinfo.image_width = static_cast<JDIMENSION>(w);
+    cinfo.image_height = static_cast<JDIMENSION>(h);
+    cinfo.input_components = 3;
+    cinfo.in_color_space = JCS_RGB;
+    jpeg_set_defaults(&cinfo);
+    jpeg_set_quality(&cinfo, 95, TRUE);
+    jpeg_start_compress(&cinfo, TRUE);
+    std::vector<unsigned char> row(static_cast<size_t>(w) * 3);
+    for (int x = 0; x < w; ++x) { row[3 * x] = r; row[3 * x + 1] = g; row[3 * x + 2] = b; }
+    while (cinfo.next_scanline < cinfo.image_height) {
+        JSAMPROW rows[1] = {row.data()};
+        jpeg_write_scanlines(&cinfo, rows, 1);
+    }
+    jpeg_finish_compress(&cinfo);
+    std::string out(reinterpret_cast<const char*>(buf), size);
+    jpeg_destroy_compress(&cinfo);
+    std::free(buf);
+    return out;
+}
+#endif
+
+BOOST_AUTO_TEST_CASE(jpeg_decodes_near_the_target_size)
+{
+#if TOP100_HAVE_JPEG
+    const std::string bytes = encodeJpeg(800, 1200, 200, 40, 90);
+    BOOST_CHECK_EQUAL(posterMimeOf(bytes), "image/jpeg");
+    auto channelNear = [](uint32_t p, int shift, int want) { return std::abs(int((p >> shift) & 0xFF) - want) <= 3; };
+
+    // Full size, opaque, colour intact
+    auto full = decodePosterImage(bytes);
+    BOOST_REQUIRE(full);
+    BOOST_CHECK_EQUAL(full->width, 800);
+    BOOST_CHECK_EQUAL(full->height, 1200);
+    for (uint32_t p : {full->pixels.front(), full->pixels[600 * 800 + 400], full->pixels.back()}) {
+        BOOST_CHECK_EQUAL(p >> 24, 0xFFu);
+        BOOST_CHECK(channelNear(p, 16, 200));
+        BOOST_CHECK(channelNear(p, 8, 40));
+        BOOST_CHECK(channelNear(p, 0, 90));
+    }
+
+    // A 170x170 cell needs 113x170: 1/8 would give 100x150, so 2/8 (200x300)
+    auto reduced = decodePosterImage(bytes, 170, 170);
+    BOOST_REQUIRE(reduced);
+    BOOST_CHECK_LT(reduced->width, 800);
+    BOOST_CHECK_GE(reduced->width, 113);
+    BOOST_CHECK_GE(reduced->height, 170);
+    BOOST_CHECK_EQUAL(reduced->pixels.size(), size_t(reduced->width) * reduced->height);
+    BOOST_CHECK(channelNear(reduced->pixels[reduced->pixels.size() / 2], 16, 200));
+    auto tile = scalePosterBitmap(*reduced, 170, 170);
+    BOOST_REQUIRE(tile);
+    BOOST_CHECK_EQUAL(tile->width, 113);
+    BOOST_CHECK_EQUAL(tile->height, 170);
+
+    // Tiny targets stop at 1/8; boxes larger than the image decode at full size
+    auto eighth = decodePosterImage(bytes, 10, 10);
+    BOOST_REQUIRE(eighth);
+    BOOST_CHECK_EQUAL(eighth->width, 100);
+    BOOST_CHECK_EQUAL(eighth->height, 150);
+    auto whole = decodePosterImage(bytes, 2000, 2000);
+    BOOST_REQUIRE(whole);
+    BOOST_CHECK_EQUAL(whole->width, 800);
+
+    decodePosterImage(bytes.substr(0, bytes.size() / 2), 170, 170);   // truncated: libjpeg pads it, must not crash
+    BOOST_CHECK(!decodePosterImage(std::string("\xff\xd8\xff garbage")));
+#else
+    BOOST_TEST_MESSAGE("Built without libjpeg");
+#endif
+}
+
+BOOST_AUTO_TEST_CASE(decoders_are_picked_by_signature)
+{
+    BOOST_CHECK_EQUAL(posterMimeOf(std::string("BM") + std::string(40, '\0')), "image/bmp");
+    BOOST_CHECK_EQUAL(posterMimeOf("BM"), "application/octet-stream");
+    BOOST_CHECK_EQUAL(posterMimeOf(std::string("RIFF\0\0\0\0WEBPVP8 ", 16)), "image/webp");
+
+    // Every backend compiled in can be created by name, and nothing else
+    const auto names = posterDecoderNames();
+    for (const auto& name : names) {
+        auto decoder = makePosterDecoder(name);
+        BOOST_REQUIRE_MESSAGE(decoder, name);
+        BOOST_CHECK_EQUAL(decoder->name(), name);
+        BOOST_CHECK(!decoder->decodes("image/webp"));
+    }
+    BOOST_CHECK(!makePosterDecoder("no-such-decoder"));
+    BOOST_CHECK_EQUAL(std::count(names.begin(), names.end(), "libjpeg"), TOP100_HAVE_JPEG ? 1 : 0);
+    BOOST_CHECK_EQUAL(std::count(names.begin(), names.end(), "stb_image"), TOP100_HAVE_STB_IMAGE ? 1 : 0);
+#if TOP100_HAVE_STB_IMAGE
+    BOOST_CHECK_EQUAL(names.back(), "stb_image");   // the libraries go first
+
+    // stb_image alone: a 2x1 24-bit BMP (bottom-up BGR rows padded to 4 bytes)...
+    std::string bmp = "BM";
+    auto le32 = [](std::string& s, uint32_t v) { for (int i = 0; i < 4; ++i) s += char((v >> (8 * i)) & 0xFF); };
+    le32(bmp, 14 + 40 + 8); le32(bmp, 0); le32(bmp, 14 + 40);
+    le32(bmp, 40); le32(bmp, 2); le32(bmp, 1); le32(bmp, 1 | (24 << 16)); le32(bmp, 0);
+    le32(bmp, 8); le32(bmp, 2835); le32(bmp, 2835); le32(bmp, 0); le32(bmp, 0);
+    bmp += std::string("\x99\x66\x33\x00\xFF\x00", 6) + std::string(2, '\0');
+    const auto stb = makePosterDecoder("stb_image");
+    auto fromBmp = stb->decode(bmp, 0, 0);
+    BOOST_REQUIRE(fromBmp);
+    BOOST_CHECK_EQUAL(fromBmp->width, 2);
+    BOOST_CHECK_EQUAL(fromBmp->height, 1);
+    BOOST_CHECK_EQUAL(fromBmp->pixels[0], 0xFF336699u);
+    BOOST_CHECK_EQUAL(fromBmp->pixels[1], 0xFF00FF00u);
+
+    // ...and a 2x1 GIF whose second pixel is transparent, which premultiplies to 0
+    static const char gifBytes[] = "GIF89a\x02\x00\x01\x00\x80\x00\x00"
+                                   "\x33\x66\x99\xFF\xFF\xFF"                  // palette
+                                   "\x21\xF9\x04\x01\x00\x00\x01\x00"          // colour 1 is transparent
+                                   "\x2C\x00\x00\x00\x00\x02\x00\x01\x00\x00"  // image descriptor
+                                   "\x02\x02\x44\x0A\x00\x3B";                 // LZW: clear, 0, 1, end
+    const std::string gif(gifBytes, sizeof gifBytes - 1);
+    BOOST_CHECK_EQUAL(posterMimeOf(gif), "image/gif");
+    auto fromGif = decodePosterImage(gif);
+    BOOST_REQUIRE(fromGif);
+    BOOST_REQUIRE_EQUAL(fromGif->pixels.size(), 2u);
+    BOOST_CHECK_EQUAL(fromGif->pixels[0], 0xFF336699u);
+    BOOST_CHECK_EQUAL(fromGif->pixels[1], 0u);
+    BOOST_CHECK(!stb->decode(gif.substr(0, 20), 0, 0));
+#endif
+
+    // Formats nobody decodes give nothing rather than garbage
+    BOOST_CHECK(!decodePosterImage(std::string("RIFF\0\0\0\0WEBPVP8 ", 16)));
+    BOOST_CHECK(!decodePosterImage("not an image"));
+#if TOP100_HAVE_JPEG && TOP100_HAVE_STB_IMAGE
+    // Both backends decode JPEG to the same size
+    const std::string bytes = encodeJpeg(64, 96, 10, 120, 240);
+    auto viaLibjpeg = makePosterDecoder("libjpeg")->decode(bytes, 0, 0);
+    auto viaStb = makePosterDecoder("stb_image")->decode(bytes, 0, 0);
+    BOOST_REQUIRE(viaLibjpeg && viaStb);
+    BOOST_CHECK_EQUAL(viaStb->width, viaLibjpeg->width);
+    BOOST_CHECK_EQUAL(viaStb->height, viaLibjpeg->height);
+    for (uint32_t p : {viaStb->pixels.front(), viaStb->pixels.back()}) {
+        BOOST_CHECK_EQUAL(p >> 24, 0xFFu);
+        BOOST_CHECK_LE(std::abs(int((p >> 16) & 0xFF) - 10), 3);
+        BOOST_CHECK_LE(std::abs(int((p >> 8) & 0xFF) - 120), 3);
+        BOOST_CHECK_LE(std::abs(int(p & 0xFF) - 240), 3);
+    }
+#endif
+}
+
+BOOST_FIXTURE_TEST_CASE(thumbnails_are_stored_and_served_by_size, PosterFixture)
+{
+    // Smallest standard size covering the fitted poster; 0 = the full poster
+    BOOST_CHECK_EQUAL(PosterCache::thumbnailSizeFor(300, 450, 170, 170), 170);
+    BOOST_CHECK_EQUAL(PosterCache::thumbnailSizeFor(300, 450, 160, 160), 170);
+    BOOST_CHECK_EQUAL(PosterCache::thumbnailSizeFor(300, 450, 40, 40), 48);
+    BOOST_CHECK_EQUAL(PosterCache::thumbnailSizeFor(300, 450, 200, 300), 340);
+    BOOST_CHECK_EQUAL(PosterCache::thumbnailSizeFor(300, 450, 300, 450), 0);
+    BOOST_CHECK_EQUAL(PosterCache::thumbnailSizeFor(300, 450, 5000, 5000), 0);
+    BOOST_CHECK_EQUAL(PosterCache::thumbnailSizeFor(30, 45, 20, 20), 0);
+    BOOST_CHECK_EQUAL(PosterCache::thumbnailSizeFor(0, 45, 20, 20), 0);
+#if TOP100_HAVE_JPEG
+    const std::string posterUrl = "http://posters.invalid/tt1.jpg";
+    std::vector<uint32_t> made;
+    {
+        auto cache = std::make_shared<PosterCache>(path);
+        cache->put("tt1", posterUrl, encodeJpeg(300, 450, 30, 60, 200));
+        const int64_t posterBytes = cache->stats().databaseBytes;
+
+        // Made once from the poster, then served from memory for any box it covers
+        auto cell = cache->thumbnail("tt1", posterUrl, 170, 170);
+        BOOST_REQUIRE(cell);
+        BOOST_CHECK_EQUAL(cell->width, 113);
+        BOOST_CHECK_EQUAL(cell->height, 170);
+        BOOST_CHECK_LE(std::abs(int((cell->pixels[85 * 113 + 56] >> 16) & 0xFF) - 30), 3);
+        made = cell->pixels;
+        BOOST_CHECK_EQUAL(cache->thumbnail("tt1", posterUrl, 160, 165), cell);
+        BOOST_CHECK_EQUAL(cache->storedThumbnail("tt1", posterUrl, 170, 170), cell);
+        auto icon = cache->thumbnailAsync("tt1", posterUrl, 40, 40).get();
+        BOOST_REQUIRE(icon);
+        BOOST_CHECK_EQUAL(icon->width, 32);
+        BOOST_CHECK_EQUAL(icon->height, 48);
+        // Boxes the poster doesn't cover get the poster itself
+        auto full = cache->thumbnail("tt1", posterUrl, 1000, 1000);
+        BOOST_REQUIRE(full);
+        BOOST_CHECK_EQUAL(full->height, 450);
+        PosterCacheStats st = cache->stats();
+        BOOST_CHECK_EQUAL(st.thumbnailsMade, 2u);
+        BOOST_CHECK_EQUAL(st.thumbnailHits, 2u);
+        // Stored next to the poster as JPEG, counted in its budget at far less than raw pixels
+        BOOST_CHECK_GT(st.databaseBytes, posterBytes);
+        BOOST_CHECK_LT(st.databaseBytes, posterBytes + (113 * 170 + 32 * 48) * 4 / 8);
+    }
+
+    // A fresh process finds them in the database without loading the poster
+    {
+        auto cache = std::make_shared<PosterCache>(path);
+        BOOST_CHECK(!cache->storedThumbnail("tt1", posterUrl, 96, 96));   // size never made
+        auto cell = cache->storedThumbnail("tt1", posterUrl, 170, 170);
+        BOOST_REQUIRE(cell);
+        BOOST_CHECK_EQUAL(cell->width, 113);
+        BOOST_REQUIRE_EQUAL(cell->pixels.size(), made.size());
+        int worst = 0;
+        for (size_t i = 0; i < made.size(); ++i) {
+            for (int shift : {0, 8, 16, 24})
+                worst = std::max(worst, std::abs(int((cell->pixels[i] >> shift) & 0xFF) - int((made[i] >> shift) & 0xFF)));
+        }
+        BOOST_CHECK_LE(worst, 3);
+        PosterCacheStats st = cache->stats();
+        BOOST_CHECK_EQUAL(st.databaseHits, 0u);
+        BOOST_CHECK_EQUAL(st.thumbnailsMade, 0u);
+        BOOST_CHECK_EQUAL(st.thumbnailHits, 1u);
+
+        // A new poster for the movie replaces its thumbnails
+        cache->put("tt1", posterUrl + "?v2", encodeJpeg(400, 400, 220, 20, 20));
+        BOOST_CHECK(!cache->storedThumbnail("tt1", posterUrl + "?v2", 170, 170));
+        auto square = cache->thumbnail("tt1", posterUrl + "?v2", 170, 170);
+        BOOST_REQUIRE(square);
+        BOOST_CHECK_EQUAL(square->width, 170);
+        BOOST_CHECK_EQUAL(square->height, 170);
+        BOOST_CHECK_EQUAL(cache->stats().thumbnailsMade, 1u);
+    }
+
+    // Not kept when thumbnails are off
+    PosterCacheOptions opts;
+    opts.thumbnails = false;
+    auto uncached = std::make_shared<PosterCache>(std::string(), opts);
+    uncached->put("tt2", posterUrl, encodeJpeg(300, 450, 0, 0, 0));
+    auto once = uncached->thumbnail("tt2", posterUrl, 170, 170);
+    BOOST_REQUIRE(once);
+    BOOST_CHECK_EQUAL(once->height, 170);
+    BOOST_CHECK(!uncached->storedThumbnail("tt2", posterUrl, 170, 170));
+    BOOST_CHECK_EQUAL(uncached->stats().memoryEntries, 1u);
+#else
+    BOOST_TEST_MESSAGE("Built without libjpeg");
+#endif
+}
+
+BOOST_FIXTURE_TEST_CASE(tiers_answer_in_order, PosterFixture)
+{
+    BOOST_CHECK_EQUAL(PosterCache::keyOf(" tt0133093 ", "http://x/p.png"), "tt0133093");
+    BOOST_CHECK_EQUAL(PosterCache::keyOf("", "http://x/p.png"), "http://x/p.png");
+    BOOST_CHECK_EQUAL(PosterCache::keyOf("", "N/A"), "");
+
+    auto cache = std::make_shared<PosterCache>(path);
+    BOOST_REQUIRE(cache->hasDatabase());
+
+    // Network, then memory
+    PosterPtr first = cache->get(ids[0], url(0));
+    BOOST_REQUIRE(first);
+    BOOST_CHECK(first->tier == PosterTier::Network);
+    BOOST_CHECK_EQUAL(first->mime, "image/png");
+    BOOST_CHECK_EQUAL(first->bytes.compare(1, 3, "PNG"), 0);
+#if TOP100_HAVE_CAIRO
+    BOOST_REQUIRE(first->bitmap);
+    BOOST_CHECK_EQUAL(first->bitmap->width, 24);
+    BOOST_CHECK_EQUAL(first->bitmap->height, 36);
+#endif
+    BOOST_CHECK_EQUAL(cache->get(ids[0], url(0)), first);
+    BOOST_CHECK_EQUAL(cache->peek(ids[0], url(0)), first);
+
+    // Database, after memory is dropped and from another cache on the same file
+    cache->clearMemory();
+    BOOST_CHECK(!cache->peek(ids[0], url(0)));
+    PosterPtr stored = cache->get(ids[0], url(0));
+    BOOST_REQUIRE(stored);
+    BOOST_CHECK(stored->tier == PosterTier::Database);
+    BOOST_CHECK(stored->bytes == first->bytes);
+    auto other = std::make_shared<PosterCache>(path);
+    PosterPtr reopened = other->get(ids[0], std::string());
+    BOOST_REQUIRE(reopened);
+    BOOST_CHECK(reopened->tier == PosterTier::Database);
+    BOOST_CHECK_EQUAL(reopened->url, url(0));
+
+    auto st = cache->stats();
+    BOOST_CHECK_EQUAL(st.downloads, 1u);
+    BOOST_CHECK_EQUAL(st.memoryHits, 2u);
+    BOOST_CHECK_EQUAL(st.databaseHits, 1u);
+    BOOST_CHECK_EQUAL(st.databaseBytes, static_cast<int64_t>(first->bytes.size()));
+    BOOST_CHECK_EQUAL(server.stats().posters, 1u);
+
+    // A new poster URL for the same movie is downloaded again
+    PosterPtr changed = cache->get(ids[0], url(1));
+    BOOST_REQUIRE(changed);
+    BOOST_CHECK(changed->tier == PosterTier::Network);
+    BOOST_CHECK_EQUAL(changed->url, url(1));
+    BOOST_CHECK_EQUAL(server.stats().posters, 2u);
+
+    // Nothing to load, or nothing there
+    BOOST_CHECK(!cache->get(ids[2], "N/A"));
+    BOOST_CHECK(!cache->get("", ""));
+    BOOST_CHECK(!cache->get(ids[3], server.posterUrl("missing.png")));
+    BOOST_CHECK_EQUAL(cache->stats().failures, 1u);
+}
+
+BOOST_FIXTURE_TEST_CASE(tiers_stay_within_budget, PosterFixture)
+{
+    // Size one poster, then allow roughly two per tier
+    auto probe = std::make_shared<PosterCache>(std::string());
+    PosterPtr sample = probe->get(ids[0], url(0));
+    BOOST_REQUIRE(sample);
+    const size_t cost = probe->stats().memoryBytes;
+    PosterCacheOptions opts;
+    opts.memoryBytes = cost * 5 / 2;
+    opts.databaseBytes = static_cast<int64_t>(sample->bytes.size() * 5 / 2);
+
+    auto cache = std::make_shared<PosterCache>(path, opts);
+    for (size_t i = 0; i < 4; ++i) BOOST_REQUIRE(cache->get(ids[i], url(i)));
+    auto st = cache->stats();
+    BOOST_CHECK_LE(st.memoryBytes, opts.memoryBytes);
+    BOOST_CHECK_LT(st.memoryEntries, 4u);
+    BOOST_CHECK_GT(st.memoryEvictions, 0u);
+    BOOST_CHECK_LE(st.databaseBytes, opts.databaseBytes);
+    BOOST_CHECK_GT(st.databaseEvictions, 0u);
+
+    // The least recently used posters went first in both tiers
+    BOOST_CHECK(!cache->peek(ids[0], url(0)));
+    BOOST_CHECK(cache->peek(ids[3], url(3)));
+    auto reopened = std::make_shared<PosterCache>(path, opts);
+    BOOST_CHECK(reopened->get(ids[3], url(3))->tier == PosterTier::Database);
+    BOOST_CHECK(reopened->get(ids[0], url(0))->tier == PosterTier::Network);
+}
+
+BOOST_FIXTURE_TEST_CASE(concurrent_lookups_share_one_load, PosterFixture)
+{
+    FixtureFaults slow;
+    slow.latencyMs = 200;
+    server.setFaults(slow);
+    auto cache = std::make_shared<PosterCache>(path);
+
+    // Four asynchronous lookups and a blocking one: one download
+    std::vector<Future<PosterPtr>> futures;
+    for (int i = 0; i < 4; ++i) futures.push_back(cache->getAsync(ids[0], url(0)));
+    PosterPtr blocking = cache->get(ids[0], url(0));
+    BOOST_REQUIRE(blocking);
+    for (auto& f : futures) BOOST_CHECK_EQUAL(f.get(), blocking);
+    BOOST_CHECK_EQUAL(cache->stats().downloads, 1u);
+    BOOST_CHECK_EQUAL(cache->stats().joined, 4u);
+    BOOST_CHECK_EQUAL(server.stats().posters, 1u);
+
+    // Memory hits complete at once
+    Future<PosterPtr> hit = cache->getAsync(ids[0], url(0));
+    BOOST_CHECK(hit.ready());
+    BOOST_CHECK_EQUAL(hit.get(), blocking);
+
+    // One caller giving up leaves the other's load running
+    CancelSource gaveUp;
+    Future<PosterPtr> cancelled = cache->getAsync(ids[1], url(1), gaveUp.token());
+    Future<PosterPtr> kept = cache->getAsync(ids[1], url(1));
+    gaveUp.cancel();
+    BOOST_CHECK(cancelled.waitFor(std::chrono::seconds(5)));
+    BOOST_CHECK(cancelled.cancelled());
+    BOOST_REQUIRE(kept.get());
+    BOOST_CHECK(kept.get()->tier == PosterTier::Network);
+
+    // Everyone giving up stops the load before it is stored
+    CancelSource all;
+    Future<PosterPtr> dropped = cache->getAsync(ids[2], url(2), all.token());
+    all.cancel();
+    BOOST_CHECK(dropped.waitFor(std::chrono::seconds(5)));
+    BOOST_CHECK(dropped.cancelled());
+    BOOST_CHECK(!cache->peek(ids[2], url(2)));
+}
+
+BOOST_FIXTURE_TEST_CASE(batch_downloads_misses_concurrently, PosterFixture)
+{
+    PosterCacheOptions opts;
+    opts.maxDownloads = 4;
+    auto cache = std::make_shared<PosterCache>(path, opts);
+    // Two posters in the database only, one in memory
+    BOOST_REQUIRE(cache->get(ids[0], url(0)));
+    BOOST_REQUIRE(cache->get(ids[1], url(1)));
+    cache->clearMemory();
+    BOOST_REQUIRE(cache->get(ids[2], url(2)));
+
+    FixtureFaults slow;
+    slow.latencyMs = 200;
+    server.setFaults(slow);
+    std::vector<PosterRequest> wanted;
+    for (size_t i = 0; i < ids.size(); ++i) wanted.push_back(PosterRequest{ids[i], url(i)});
+    wanted.push_back(PosterRequest{ids[5], url(5)});   // asked twice
+    wanted.push_back(PosterRequest{"", "N/A"});         // nothing to load
+
+    const auto start = std::chrono::steady_clock::now();
+    const std::vector<PosterPtr> got = cache->getAll(wanted);
+    const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    BOOST_REQUIRE_EQUAL(got.size(), wanted.size());
+    for (size_t i = 0; i < ids.size(); ++i) {
+        BOOST_REQUIRE(got[i]);
+        BOOST_CHECK_EQUAL(got[i]->key, ids[i]);
+    }
+    BOOST_CHECK(got[0]->tier == PosterTier::Database);
+    BOOST_CHECK(got[2]->tier == PosterTier::Memory || got[2]->tier == PosterTier::Network);
+    BOOST_CHECK(got[3]->tier == PosterTier::Network);
+    BOOST_CHECK_EQUAL(got[ids.size()], got[5]);
+    BOOST_CHECK(!got.back());
+
+    // Nine misses, four at a time: three round-trips rather than nine
+    auto st = cache->stats();
+    BOOST_CHECK_EQUAL(st.downloads, 3u + 9u);
+    BOOST_CHECK_EQUAL(st.databaseHits, 2u);
+    BOOST_CHECK_EQUAL(server.stats().posters, 3u + 9u);
+    BOOST_CHECK_LT(ms, 9 * 200.0 * 0.7);
+}
+
+BOOST_AUTO_TEST_CASE(batch_lookups_from_every_pool_worker)
+{
+#if TOP100_HAVE_JPEG
+    const std::string path = "test_poster_cache_workers.db";
+    std::remove(path.c_str());
+    {
+        auto cache = std::make_shared<PosterCache>(path, PosterCacheOptions());
+        std::vector<PosterRequest> wanted;
+        for (int i = 0; i < 6; ++i) {
+            const std::string id = "tt" + std::to_string(i);
+            const std::string posterUrl = "https://example.invalid/" + id + ".jpg";
+            BOOST_REQUIRE(cache->put(id, posterUrl, encodeJpeg(60, 90, 10 * i, 20, 30)));
+            wanted.push_back(PosterRequest{id, posterUrl});
+        }
+        cache->clearMemory();
+
+        // Every worker busy in getAll(): decoding there would wait on tasks nobody runs
+        ThreadPool& pool = sharedThreadPool();
+        std::vector<std::future<size_t>> busy;
+        for (size_t w = 0; w < pool.threadCount(); ++w) {
+            busy.push_back(pool.submit([&cache, &wanted]() {
+                const auto got = cache->getAll(wanted);
+                return static_cast<size_t>(std::count_if(got.begin(), got.end(), [](const PosterPtr& p) { return p && p->bitmap; }));
+            }));
+        }
+        for (auto& f : busy) {
+            BOOST_REQUIRE(f.wait_for(std::chrono::seconds(10)) == std::future_status::ready);
+            BOOST_CHECK_EQUAL(f.get(), wanted.size());
+        }
+    }
+    std::remove(path.c_str());
+#else
+    BOOST_TEST_MESSAGE("Built without libjpeg");
+#endif
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,97 @@
+// SPDX-License-Identifier: Apache-2.0
+//-------------------------------------------------------------------------------
+// Top100 — Your Personal Movie List
+//
+// File: tests/test_preference_graph.cpp
+// Purpose: Unit tests for transitive inference and implied-pair skipping.
+// Language: C++17 (Boost.Test)
+//-------------------------------------------------------------------------------
+#define BOOST_TEST_MODULE Top100PreferenceGraph
+#include <boost/test/included/unit_test.hpp>
+#include "preference_graph.h"
+#include "top100.h"
+#include "Movie.h"
+#include <cstdio>
+
+struct PreferenceFixture {
+    std::string test_filename = "test_movies_preferences.db";
+    PreferenceFixture() { std::remove(test_filename.c_str()); }
+    ~PreferenceFixture() { std::remove(test_filename.c_str()); }
+};
+
+BOOST_FIXTURE_TEST_SUITE(PreferenceSuite, PreferenceFixture)
+
+BOOST_AUTO_TEST_CASE(transitive_inference)
+{
+    PreferenceGraph g;
+    BOOST_CHECK(g.addPreference("A", "B"));
+    BOOST_CHECK(g.addPreference("B", "C"));
+    BOOST_CHECK(g.prefers("A", "C"));
+    BOOST_CHECK(!g.prefers("C", "A"));
+    BOOST_CHECK(g.isImplied("C", "A"));
+    BOOST_CHECK(!g.isImplied("A", "D"));
+    BOOST_CHECK_EQUAL(g.conflictCount(), 0u);
+
+    // Long chain inserted bottom-up stays cheap and fully transitive
+    PreferenceGraph chain;
+    const int n = 2000;
+    for (int i = n - 2; i >= 0; --i) chain.addPreference("m" + std::to_string(i), "m" + std::to_string(i + 1));
+    BOOST_CHECK(chain.prefers("m0", "m" + std::to_string(n - 1)));
+    BOOST_CHECK(!chain.prefers("m" + std::to_string(n - 1), "m0"));
+    BOOST_CHECK_EQUAL(chain.size(), static_cast<size_t>(n));
+}
+
+BOOST_AUTO_TEST_CASE(inconsistent_answer_newest_wins)
+{
+    PreferenceGraph g;
+    g.addPreference("A", "B");
+    g.addPreference("B", "C");
+    // C > A closes a cycle; the newest answers win and A > B is dropped
+    BOOST_CHECK(!g.addPreference("C", "A"));
+    BOOST_CHECK(g.prefers("C", "A"));
+    BOOST_CHECK(g.prefers("B", "A"));
+    BOOST_CHECK(!g.prefers("A", "B"));
+    BOOST_CHECK_EQUAL(g.conflictCount(), 1u);
+    BOOST_CHECK_EQUAL(g.edgeCount(), 3u);
+}
+
+BOOST_AUTO_TEST_CASE(scheduler_skips_implied_pairs)
+{
+    std::vector<Movie> movies = {{"A", 2000, "Dir"}, {"B", 2001, "Dir"}, {"C", 2002, "Dir"}};
+    PreferenceGraph g;
+    g.addPreference(comparisonKey(movies[0]), comparisonKey(movies[1]));
+    g.addPreference(comparisonKey(movies[1]), comparisonKey(movies[2]));
+    std::mt19937 rng(42);
+    BOOST_CHECK(!pickComparisonPair(movies, g, rng).has_value());
+
+    movies.push_back({"D", 2003, "Dir"});
+    for (int i = 0; i < 20; ++i) {
+        auto pair = pickComparisonPair(movies, g, rng);
+        BOOST_REQUIRE(pair.has_value());
+        BOOST_CHECK(pair->first == 3 || pair->second == 3);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(history_persists_and_drives_closure)
+{
+#ifndef TOP100_NO_SQLITE
+    {
+        Top100 top100(test_filename);
+        top100.addMovie({"A", 2000, "Dir"});
+        top100.addMovie({"B", 2001, "Dir"});
+        top100.addMovie({"C", 2002, "Dir"});
+        BOOST_REQUIRE(top100.recordComparison(0, 1));
+        BOOST_REQUIRE(top100.recordComparison(1, 2));
+        BOOST_CHECK(!top100.recordComparison(1, 1));
+        auto ranked = top100.getMovies(SortOrder::BY_USER_RANK);
+        BOOST_CHECK_EQUAL(ranked[0].title, "A");
+    }
+    Top100 reopened(test_filename);
+    BOOST_CHECK_EQUAL(reopened.getComparisons().size(), 2u);
+    BOOST_CHECK(reopened.preferences().prefers("A|2000", "C|2002"));
+#else
+    BOOST_TEST_MESSAGE("SQLite not available; skipping history persistence test (TOP100_NO_SQLITE defined)");
+#endif
+}
+
+BOOST_AUTO_TEST_SUITE_END()
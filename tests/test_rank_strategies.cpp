@@ -0,0 +1,94 @@
+// SPDX-License-Identifier: Apache-2.0
+//-------------------------------------------------------------------------------
+// Top100 — Your Personal Movie List
+//
+// File: tests/test_rank_strategies.cpp
+// Purpose: Unit tests for pair strategies, rank metrics and the thread pool.
+// Language: C++17 (Boost.Test)
+//-------------------------------------------------------------------------------
+#define BOOST_TEST_MODULE Top100RankStrategies
+#include <boost/test/included/unit_test.hpp>
+#include "ranking.h"
+#include "thread_pool.h"
+#include "Movie.h"
+#include <atomic>
+#include <numeric>
+
+namespace {
+std::vector<Movie> makeMovies(size_t n) {
+    std::vector<Movie> movies;
+    for (size_t i = 0; i < n; ++i) {
+        Movie m{"M" + std::to_string(i), 2000, "Dir"};
+        m.imdbID = "tt" + std::to_string(1000 + i);
+        movies.push_back(m);
+    }
+    return movies;
+}
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(RankStrategySuite)
+
+BOOST_AUTO_TEST_CASE(metrics_identity_and_reverse)
+{
+    std::vector<size_t> a = {0, 1, 2, 3, 4, 5};
+    std::vector<size_t> rev = {5, 4, 3, 2, 1, 0};
+    BOOST_CHECK_CLOSE(kendallTau(a, a), 1.0, 1e-9);
+    BOOST_CHECK_CLOSE(kendallTau(a, rev), -1.0, 1e-9);
+    BOOST_CHECK_SMALL(spearmanFootrule(a, a), 1e-12);
+    BOOST_CHECK_CLOSE(spearmanFootrule(a, rev), 1.0, 1e-9);
+
+    // One adjacent swap: 1 discordant pair out of 15
+    std::vector<size_t> swapped = {1, 0, 2, 3, 4, 5};
+    BOOST_CHECK_CLOSE(kendallTau(a, swapped), 1.0 - 2.0 / 15.0, 1e-9);
+    BOOST_CHECK_CLOSE(spearmanFootrule(a, swapped), 2.0 / 18.0, 1e-9);
+}
+
+BOOST_AUTO_TEST_CASE(insertion_sorts_noiseless_user)
+{
+    const size_t n = 40;
+    auto movies = makeMovies(n);
+    PreferenceGraph prefs;
+    auto strategy = makePairStrategy("insertion");
+    BOOST_REQUIRE(strategy);
+    BOOST_CHECK(!makePairStrategy("bogus"));
+    std::mt19937 rng(7);
+
+    // Truth: lower index is better
+    size_t asked = 0;
+    while (auto pair = strategy->nextPair(movies, prefs, rng)) {
+        BOOST_REQUIRE(pair->first != pair->second);
+        BOOST_REQUIRE(!prefs.isImplied(comparisonKey(movies[pair->first]), comparisonKey(movies[pair->second])));
+        const size_t w = std::min(pair->first, pair->second), l = std::max(pair->first, pair->second);
+        applyComparison(movies, prefs, w, l);
+        BOOST_REQUIRE(++asked < n * n);
+    }
+    // Binary insertion needs at most sum(ceil(log2(k+1))) answers
+    size_t bound = 0;
+    for (size_t k = 1; k < n; ++k) {
+        size_t bits = 0;
+        while ((size_t{1} << bits) < k + 1) ++bits;
+        bound += bits;
+    }
+    BOOST_CHECK_LE(asked, bound);
+    for (size_t i = 0; i + 1 < n; ++i)
+        BOOST_CHECK(prefs.prefers(comparisonKey(movies[i]), comparisonKey(movies[i + 1])));
+    BOOST_CHECK_EQUAL(prefs.beatsCount(prefs.idOf(comparisonKey(movies[0]))), n - 1);
+}
+
+BOOST_AUTO_TEST_CASE(thread_pool_parallel_for)
+{
+    ThreadPool pool(4);
+    std::vector<int> hits(1000, 0);
+    std::vector<std::atomic<size_t>> perWorker(pool.threadCount());
+    pool.parallelFor(hits.size(), [&](size_t i, size_t worker) {
+        ++hits[i];
+        ++perWorker[worker];
+    });
+    for (int h : hits) BOOST_CHECK_EQUAL(h, 1);
+    size_t total = 0;
+    for (auto& c : perWorker) total += c.load();
+    BOOST_CHECK_EQUAL(total, hits.size());
+    BOOST_CHECK_EQUAL(pool.submit([]() { return 41 + 1; }).get(), 42);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -13,8 +13,12 @@
 #include <boost/test/included/unit_test.hpp>
 #include "top100.h"
 #include "Movie.h"
+#include "elo.h"
+#include "rank_bootstrap.h"
+#include "thread_pool.h"
 #include <nlohmann/json.hpp>
 #include <cstdio>
+#include <random>
 
 struct RankingFixture {
     std::string test_filename = "test_movies_ranking.json";
@@ -127,4 +131,92 @@ BOOST_AUTO_TEST_CASE(elo_update_changes_scores_and_order)
     BOOST_CHECK_CLOSE(ranked[1].userScore, sb, 1e-6);
 }
 
+BOOST_AUTO_TEST_CASE(elo_expected_fast_matches_pow)
+{
+    // Accuracy bound of the pow-free expected score across the whole useful range
+    double worst = 0.0;
+    for (double d = -3000.0; d <= 3000.0; d += 0.37) {
+        const double a = 1500.0 + d, b = 1500.0;
+        const double qa = std::pow(10.0, a / 400.0), qb = std::pow(10.0, b / 400.0);
+        worst = std::max(worst, std::abs(eloExpectedFast(a, b) - qa / (qa + qb)));
+    }
+    BOOST_CHECK_LT(worst, 1e-12);
+    BOOST_CHECK_CLOSE(eloExpectedFast(1500.0, 1500.0), 0.5, 1e-12);
+}
+
+BOOST_AUTO_TEST_CASE(elo_batch_matches_sequential)
+{
+    // Random answers with heavy overlap must match one-at-a-time updates
+    std::mt19937 rng(99);
+    std::uniform_int_distribution<uint32_t> pick(0, 19);
+    std::vector<EloPair> pairs;
+    for (int i = 0; i < 5000; ++i) pairs.push_back({pick(rng), pick(rng)});
+    pairs.push_back({3, 25}); // out of range: ignored
+
+    std::vector<double> expected(20, 1500.0);
+    for (const auto& p : pairs) {
+        if (p.winner == p.loser || p.loser >= expected.size()) continue;
+        testUpdateElo(expected[p.winner], expected[p.loser], 1.0);
+    }
+    std::vector<double> scores(20, 1500.0);
+    EloBatch batch;
+    batch.apply(scores, pairs);
+    for (size_t i = 0; i < scores.size(); ++i) BOOST_CHECK_SMALL(scores[i] - expected[i], 1e-8);
+    BOOST_CHECK_LT(batch.waveCount(), pairs.size());
+
+    // Disjoint pairs collapse into a single wave
+    std::vector<EloPair> disjoint = {{0, 1}, {2, 3}, {4, 5}};
+    batch.apply(scores, disjoint);
+    BOOST_CHECK_EQUAL(batch.waveCount(), 1u);
+
+#ifndef TOP100_NO_SQLITE
+    Top100 top100(test_filename);
+    top100.addMovie({"A", 2000, "Dir"});
+    top100.addMovie({"B", 2001, "Dir"});
+    BOOST_CHECK_EQUAL(top100.importComparisons({{"A|2000", "B|2001", 0}, {"A|2000", "Z|1999", 0}}), 1u);
+    BOOST_CHECK_EQUAL(top100.getComparisons().size(), 1u);
+    BOOST_CHECK_EQUAL(top100.getMovies(SortOrder::BY_USER_RANK)[0].title, "A");
+#endif
+}
+
+BOOST_AUTO_TEST_CASE(bootstrap_rank_intervals)
+{
+    std::vector<Movie> movies;
+    for (const char* t : {"A", "B", "C", "D", "E", "F"}) movies.push_back({t, 2000, "Dir"});
+    // Consistent chain A > B > C > D > E, answered many times; F never compared
+    std::vector<Comparison> history;
+    for (int rep = 0; rep < 20; ++rep)
+        for (size_t i = 0; i + 1 < 5; ++i)
+            history.push_back({comparisonKey(movies[i]), comparisonKey(movies[i + 1]), 0});
+
+    ThreadPool pool(3);
+    RankBootstrapOptions opts;
+    opts.resamples = 300;
+    auto intervals = bootstrapRankIntervals(movies, history, opts, pool);
+    BOOST_REQUIRE_EQUAL(intervals.size(), movies.size());
+    BOOST_CHECK_EQUAL(intervals[0].low, 1);
+    for (size_t i = 0; i < 5; ++i) {
+        BOOST_CHECK_LE(intervals[i].low, intervals[i].high);
+        BOOST_CHECK_LE(intervals[i].high - intervals[i].low, 3);
+    }
+    BOOST_CHECK_EQUAL(intervals[5].low, 1);
+    BOOST_CHECK_EQUAL(intervals[5].high, 6);
+
+    // Deterministic for a fixed seed, regardless of worker count
+    ThreadPool single(1);
+    auto again = bootstrapRankIntervals(movies, history, opts, single);
+    for (size_t i = 0; i < movies.size(); ++i) {
+        BOOST_CHECK_EQUAL(again[i].low, intervals[i].low);
+        BOOST_CHECK_EQUAL(again[i].high, intervals[i].high);
+    }
+
+    Movie m{"X", 2000, "Dir"};
+    BOOST_CHECK_EQUAL(rankLabel(m), "");
+    m.userRank = 12;
+    BOOST_CHECK_EQUAL(rankLabel(m), "#12 ");
+    m.userRankLow = 9;
+    m.userRankHigh = 15;
+    BOOST_CHECK_EQUAL(rankLabel(m), "#12 (9-15) ");
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -3,7 +3,7 @@
 // Top100 — Your Personal Movie List
 //
 // File: tests/test_sorting.cpp
-// Purpose: Unit tests for sorting by year and alphabetical.
+// Purpose: Unit tests for sorting by year, alphabetical and composite score.
 // Language: C++17 (Boost.Test)
 //
 // Author: Andy McCall, mailme@andymccall.co.uk
@@ -51,4 +51,48 @@ BOOST_AUTO_TEST_CASE(sort_alphabetical)
     BOOST_CHECK_EQUAL(alpha[2].title, "alpha");
 }
 
+BOOST_AUTO_TEST_CASE(sort_composite_weights)
+{
+    Top100 top100(test_filename);
+    Movie fan = {"Fan Favourite", 2001, "Dir"};
+    fan.userScore = 1700.0;
+    fan.imdbRating = 6.0;
+    fan.metascore = 40;
+    Movie critic = {"Critics Pick", 2002, "Dir"};
+    critic.userScore = 1450.0;
+    critic.imdbRating = 8.5;
+    critic.metascore = 95;
+    critic.rottenTomatoes = 98;
+    Movie middle = {"Middle", 2003, "Dir"};   // no critic scores: neutral on those columns
+    middle.userScore = 1500.0;
+    top100.addMovie(fan);
+    top100.addMovie(critic);
+    top100.addMovie(middle);
+
+    CompositeWeights mine;
+    mine.imdbRating = mine.metascore = mine.rottenTomatoes = 0.0;
+    top100.setCompositeWeights(mine);
+    auto byMine = top100.getMovies(SortOrder::COMPOSITE);
+    BOOST_REQUIRE_EQUAL(byMine.size(), 3);
+    BOOST_CHECK_EQUAL(byMine[0].title, "Fan Favourite");
+    BOOST_CHECK_EQUAL(byMine[2].title, "Critics Pick");
+
+    top100.setCompositeWeights(makeCompositeWeights(0.2, 1.0, 1.0, 1.0, "minmax"));
+    auto byCritics = top100.getMovies(SortOrder::COMPOSITE);
+    BOOST_CHECK_EQUAL(byCritics[0].title, "Critics Pick");
+
+    // Re-weighting a snapshot returns a full permutation and reacts to weights
+    CompositeIndex index;
+    index.assign(top100.getMovies());
+    std::vector<uint32_t> order;
+    index.order(mine, order);
+    BOOST_REQUIRE_EQUAL(order.size(), 3u);
+    BOOST_CHECK_EQUAL(order[0], 0u);
+    CompositeWeights imdbOnly;
+    imdbOnly.userScore = imdbOnly.metascore = imdbOnly.rottenTomatoes = 0.0;
+    index.order(imdbOnly, order);
+    BOOST_CHECK_EQUAL(order[0], 1u);
+    BOOST_CHECK_EQUAL(order[1], 2u); // missing rating ranks at the column mean, above 6.0
+}
+
 BOOST_AUTO_TEST_SUITE_END()
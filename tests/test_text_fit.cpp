@@ -0,0 +1,222 @@
+// SPDX-License-Identifier: Apache-2.0
+//-------------------------------------------------------------------------------
+// Top100 — Your Personal Movie List
+//
+// File: tests/test_text_fit.cpp
+// Purpose: UTF-8 helpers and the title elision used by image export.
+// Language: C++17 (Boost.Test)
+//-------------------------------------------------------------------------------
+#define BOOST_TEST_MODULE Top100TextFit
+#include <boost/test/included/unit_test.hpp>
+#include "text_fit.h"
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Stand-in font: ASCII 1 wide (space 0.5), marks and joiners 0, emoji 2, anything else 1.5
+double advanceOf(char32_t c) {
+    if (c == ' ') return 0.5;
+    if (c < 0x80) return 1.0;
+    if (extendsCharacter(c) && (c < 0x1F3FB || c > 0x1F3FF)) return 0.0;
+    if (c >= 0x1F000) return 2.0;
+    return 1.5;
+}
+
+double advanceOf(const std::string& s) {
+    double sum = 0;
+    for (size_t i = 0; i < s.size();) sum += advanceOf(nextCodepoint(s, i));
+    return sum;
+}
+
+// Fits with the stand-in font; @p kerning is added to every measured width
+struct Fitter {
+    double kerning = 0;
+    int measured = 0;
+    std::string operator()(const std::string& text, const std::string& suffix, double maxWidth) {
+        measured = 0;
+        return fitTextToWidth(
+            text, suffix, maxWidth, [](char32_t c) { return advanceOf(c); },
+            [this](const std::string& s) {
+                ++measured;
+                return advanceOf(s) + kerning;
+            });
+    }
+};
+
+// Byte offsets where a cut may fall: before every code point that doesn't extend the one before it
+std::vector<size_t> boundaries(const std::string& s) {
+    std::vector<size_t> out{0};
+    bool joined = false;
+    for (size_t i = 0; i < s.size();) {
+        const size_t at = i;
+        const char32_t c = nextCodepoint(s, i);
+        if (at > 0 && !joined && !extendsCharacter(c)) out.push_back(at);
+        joined = c == 0x200D;
+    }
+    out.push_back(s.size());
+    return out;
+}
+
+// Reference: walk the characters one by one, keeping the longest prefix that fits
+std::string linearFit(const std::string& text, const std::string& suffix, double maxWidth, double kerning) {
+    const std::string line = text + suffix;
+    if (advanceOf(line) + kerning <= maxWidth) return line;
+    std::string body = text, tail = "…" + suffix;
+    if (maxWidth - advanceOf(tail) < 0) {
+        body = line;
+        tail = "…";
+    }
+    const double budget = maxWidth - advanceOf(tail);
+    const std::vector<size_t> ends = boundaries(body);
+    size_t keep = 0;
+    while (keep + 1 < ends.size() && advanceOf(body.substr(0, ends[keep + 1])) <= budget) ++keep;
+    auto cut = [&](size_t n) {
+        size_t end = ends[n];
+        while (end > 0 && body[end - 1] == ' ') --end;
+        return body.substr(0, end) + tail;
+    };
+    std::string out = cut(keep);
+    if (advanceOf(out) + kerning > maxWidth && keep > 0) {
+        size_t shorter = keep - 1;
+        while (shorter > 0 && cut(shorter) == out) --shorter;
+        out = cut(shorter);
+    }
+    return out;
+}
+
+bool endsWith(const std::string& s, const std::string& end) {
+    return s.size() >= end.size() && s.compare(s.size() - end.size(), end.size(), end) == 0;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(TextFitSuite)
+
+BOOST_AUTO_TEST_CASE(utf8_is_walked_and_repaired)
+{
+    // One to four bytes per code point
+    const std::string s = "A\xC3\xA9\xE2\x80\xA6\xF0\x9F\x98\x80";   // A é … 😀
+    std::vector<char32_t> got;
+    for (size_t i = 0; i < s.size();) got.push_back(nextCodepoint(s, i));
+    BOOST_CHECK(got == (std::vector<char32_t>{U'A', 0xE9, 0x2026, 0x1F600}));
+    std::string back;
+    for (char32_t c : got) appendUtf8(back, c);
+    BOOST_CHECK_EQUAL(back, s);
+
+    // A malformed byte becomes U+FFFD on its own and the walk goes on from the next byte
+    const std::string bad = "a\x80" "b\xC3(" "\xF8" "\xE2\x80";
+    got.clear();
+    for (size_t i = 0; i < bad.size();) got.push_back(nextCodepoint(bad, i));
+    BOOST_CHECK(got == (std::vector<char32_t>{U'a', 0xFFFD, U'b', 0xFFFD, U'(', 0xFFFD, 0xFFFD, 0xFFFD}));
+
+    // Overlong forms, surrogates, values past U+10FFFF and 0xF8-0xFF leads
+    for (const std::string& invalid : {std::string("\xC0\x80"), std::string("\xE0\x80\xAF"), std::string("\xED\xA0\x80"),
+                                       std::string("\xF4\x90\x80\x80"), std::string("\xF8\x88\x80\x80\x80")}) {
+        size_t i = 0;
+        BOOST_CHECK_EQUAL(static_cast<uint32_t>(nextCodepoint(invalid, i)), 0xFFFDu);
+        BOOST_CHECK_EQUAL(i, 1u);
+    }
+
+    // Latin-1 bytes repaired, valid text untouched
+    BOOST_CHECK_EQUAL(sanitizeUtf8("Caf\xE9 (1999)"), "Caf\xEF\xBF\xBD (1999)");
+    BOOST_CHECK_EQUAL(sanitizeUtf8(s), s);
+    BOOST_CHECK_EQUAL(sanitizeUtf8(""), "");
+
+    BOOST_CHECK(extendsCharacter(0x0301));    // combining acute
+    BOOST_CHECK(extendsCharacter(0xFE0F));    // emoji presentation
+    BOOST_CHECK(extendsCharacter(0x1F3FD));   // skin tone
+    BOOST_CHECK(extendsCharacter(0x200D));    // zero-width joiner
+    BOOST_CHECK(!extendsCharacter(U'e'));
+    BOOST_CHECK(!extendsCharacter(0x1F600));
+}
+
+BOOST_AUTO_TEST_CASE(cuts_keep_the_suffix)
+{
+    Fitter fit;
+    const std::string title = "The Lord of the Rings", year = " (2001)";   // 19 + 6.5 wide
+
+    // Fits: one measurement
+    BOOST_CHECK_EQUAL(fit(title, year, 30), title + year);
+    BOOST_CHECK_EQUAL(fit.measured, 1);
+
+    // Too wide: the title is cut, the year kept, trailing spaces dropped
+    std::string line = fit(title, year, 16);
+    BOOST_CHECK_EQUAL(line, "The Lord…" + year);
+    BOOST_CHECK_LE(advanceOf(line), 16);
+    BOOST_CHECK_LE(fit.measured, 3);
+
+    // Multi-byte titles are cut between characters
+    line = fit("東京物語", year, 12);
+    BOOST_CHECK_EQUAL(line, "東京…" + year);
+
+    // The year alone doesn't fit: the whole line is cut instead
+    line = fit(title, year, 6);
+    BOOST_CHECK_EQUAL(line, "The L…");
+    BOOST_CHECK(!endsWith(line, year));
+
+    // Kerning the advances don't show: one character fewer (not just the space)
+    fit.kerning = 0.6;
+    line = fit(title, year, 16);
+    BOOST_CHECK_EQUAL(line, "The Lor…" + year);
+    BOOST_CHECK_EQUAL(fit.measured, 3);
+}
+
+BOOST_AUTO_TEST_CASE(cuts_never_split_a_character)
+{
+    Fitter fit;
+    const std::string year = " (2001)";
+    const std::vector<std::string> titles = {
+        "Ame\xCC\x81lie Poulain",                                      // e + combining acute
+        "Family \xF0\x9F\x91\xA8\xE2\x80\x8D\xF0\x9F\x91\xA9\xE2\x80\x8D\xF0\x9F\x91\xA7 Night",   // ZWJ sequence
+        "Thumbs \xF0\x9F\x91\x8D\xF0\x9F\x8F\xBD Up",                  // skin tone
+        "I \xE2\x9D\xA4\xEF\xB8\x8F Huckabees",                        // heart + VS16
+    };
+    for (const std::string& title : titles) {
+        const std::vector<size_t> ok = boundaries(title);
+        for (double w = 0; w <= 40; w += 0.25) {
+            const std::string line = fit(title, year, w);
+            if (line == title + year) continue;
+            const std::string tail = endsWith(line, "…" + year) ? "…" + year : "…";
+            BOOST_REQUIRE(endsWith(line, tail));
+            const std::string body = line.substr(0, line.size() - tail.size());
+            const std::string whole = tail == "…" ? title + year : title;
+            BOOST_CHECK_EQUAL(whole.compare(0, body.size(), body), 0);
+            // Cut where a character starts (spaces trimmed before it)
+            size_t end = body.size();
+            while (end < whole.size() && whole[end] == ' ') ++end;
+            const std::vector<size_t> okHere = tail == "…" ? boundaries(whole) : ok;
+            BOOST_CHECK_MESSAGE(std::find(okHere.begin(), okHere.end(), end) != okHere.end(),
+                                "cut inside a character: " << line);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(binary_search_matches_a_linear_scan)
+{
+    const std::vector<std::string> titles = {
+        "The Lord of the Rings: The Return of the King",
+        "Le Fabuleux Destin d'Ame\xCC\x81lie Poulain",
+        "千と千尋の神隠し",
+        "Family \xF0\x9F\x91\xA8\xE2\x80\x8D\xF0\x9F\x91\xA9\xE2\x80\x8D\xF0\x9F\x91\xA7 Night",
+        "A  B   C    D",
+        "",
+    };
+    for (double kerning : {0.0, 0.3, 1.2}) {
+        Fitter fit;
+        fit.kerning = kerning;
+        for (const std::string& title : titles) {
+            for (const std::string& suffix : {std::string(" (1999)"), std::string()}) {
+                for (double w = 0; w <= 60; w += 0.25) {
+                    const std::string line = fit(title, suffix, w);
+                    BOOST_CHECK_EQUAL(line, linearFit(title, suffix, w, kerning));
+                    BOOST_CHECK_LE(fit.measured, 3);
+                }
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
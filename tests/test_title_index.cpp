@@ -0,0 +1,217 @@
+// SPDX-License-Identifier: Apache-2.0
+//-------------------------------------------------------------------------------
+// Top100 — Your Personal Movie List
+//
+// File: tests/test_title_index.cpp
+// Purpose: IMDb dataset import and the offline title index, on fixture TSVs.
+// Language: C++17 (Boost.Test)
+//-------------------------------------------------------------------------------
+#define BOOST_TEST_MODULE Top100TitleIndex
+#include <boost/test/included/unit_test.hpp>
+#include "omdb.h"
+#include "title_index.h"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#if TOP100_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+namespace fs = std::filesystem;
+
+// Small datasets in the IMDb layout, imported once per test
+struct DatasetFixture {
+    fs::path dir = "test_title_index_data";
+    std::string indexPath = (dir / "titles.idx").string();
+    ImdbImportResult imported;
+
+    DatasetFixture() {
+        fs::remove_all(dir);
+        fs::create_directories(dir);
+        // Matches the dumps: header row, \N for nulls, comma-separated genres
+        writeGzip("title.basics.tsv",
+                  "tconst\ttitleType\tprimaryTitle\toriginalTitle\tisAdult\tstartYear\tendYear\truntimeMinutes\tgenres\n"
+                  "tt0000001\tshort\tCarmencita\tCarmencita\t0\t1894\t\\N\t1\tDocumentary,Short\n"
+                  "tt0078748\tmovie\tAlien\tAlien\t0\t1979\t\\N\t117\tHorror,Sci-Fi\n"
+                  "tt0090605\tmovie\tAliens\tAliens\t0\t1986\t\\N\t137\tAction,Adventure,Sci-Fi\n"
+                  "tt0111111\tmovie\tAdult Film\tAdult Film\t1\t2000\t\\N\t90\tAdult\n"
+                  "tt0133093\tmovie\tThe Matrix\tThe Matrix\t0\t1999\t\\N\t136\tAction,Sci-Fi\n"
+                  "tt0211915\tmovie\tAm\xC3\xA9lie\tLe fabuleux destin d'Am\xC3\xA9lie Poulain\t0\t2001\t\\N\t122\tComedy,Romance\n"
+                  "tt0234215\tmovie\tThe Matrix Reloaded\tThe Matrix Reloaded\t0\t2003\t\\N\t138\tAction,Sci-Fi\n"
+                  "tt9999999\ttvSeries\tThe Matrix Show\tThe Matrix Show\t0\t2020\t\\N\t30\tAnimation\n"
+                  "tt10872600\tmovie\tSpider-Man: No Way Home\tSpider-Man: No Way Home\t0\t2021\t\\N\t148\tAction,Adventure,Fantasy\n");
+        writePlain("title.ratings.tsv",
+                   "tconst\taverageRating\tnumVotes\r\n"
+                   "tt0000001\t5.7\t2100\r\n"
+                   "tt0078748\t8.5\t950000\r\n"
+                   "tt0090605\t8.4\t770000\r\n"
+                   "tt0133093\t8.7\t2100000\r\n"
+                   "tt0211915\t8.3\t800000\r\n"
+                   "tt0234215\t7.2\t620000\r\n");
+        writePlain("title.principals.tsv",
+                   "tconst\tordering\tnconst\tcategory\tjob\tcharacters\n"
+                   "tt0078748\t1\tnm0000244\tactress\t\\N\t[\"Ripley\"]\n"
+                   "tt0078748\t5\tnm0000631\tdirector\t\\N\t\\N\n"
+                   "tt0133093\t6\tnm0905152\tdirector\t\\N\t\\N\n"
+                   "tt0133093\t2\tnm0000401\tactor\t\\N\t[\"Morpheus\"]\n"
+                   "tt0133093\t5\tnm0905154\tdirector\t\\N\t\\N\n"
+                   "tt0133093\t1\tnm0000206\tactor\t\\N\t[\"Neo\"]\n"
+                   "tt0133093\t7\tnm0000001\tproducer\tproducer\t\\N\n"
+                   "tt0000001\t1\tnm0000002\tself\t\\N\t\\N\n");
+        writeGzip("name.basics.tsv",
+                  "nconst\tprimaryName\tbirthYear\tdeathYear\tprimaryProfession\tknownForTitles\n"
+                  "nm0000001\tFred Astaire\t1899\t1987\tactor\ttt0050419\n"
+                  "nm0000206\tKeanu Reeves\t1964\t\\N\tactor\ttt0133093\n"
+                  "nm0000244\tSigourney Weaver\t1949\t\\N\tactress\ttt0078748\n"
+                  "nm0000401\tLaurence Fishburne\t1961\t\\N\tactor\ttt0133093\n"
+                  "nm0000631\tRidley Scott\t1937\t\\N\tdirector\ttt0078748\n"
+                  "nm0905152\tLilly Wachowski\t1967\t\\N\tdirector\ttt0133093\n"
+                  "nm0905154\tLana Wachowski\t1965\t\\N\tdirector\ttt0133093\n");
+
+        ImdbImportOptions opts = imdbImportOptionsForDir(dir.string());
+        opts.threads = 3;
+        opts.chunkBytes = 64;  // many chunks, some shorter than a line
+        imported = importImdbDatasets(opts, indexPath);
+    }
+    ~DatasetFixture() { fs::remove_all(dir); }
+
+    void writePlain(const std::string& name, const std::string& text) {
+        std::ofstream((dir / name).string(), std::ios::binary) << text;
+    }
+
+    // Gzipped like the published dumps (plain when built without zlib)
+    void writeGzip(const std::string& name, const std::string& text) {
+#if TOP100_HAVE_ZLIB
+        gzFile f = gzopen((dir / (name + ".gz")).string().c_str(), "wb");
+        gzwrite(f, text.data(), static_cast<unsigned>(text.size()));
+        gzclose(f);
+#else
+        writePlain(name, text);
+#endif
+    }
+};
+
+BOOST_AUTO_TEST_SUITE(TitleIndexSuite)
+
+BOOST_FIXTURE_TEST_CASE(import_fixture_datasets, DatasetFixture)
+{
+    BOOST_REQUIRE_MESSAGE(imported.ok, imported.error);
+    // Movies only: no short, TV series or adult title
+    BOOST_CHECK_EQUAL(imported.titles, 6u);
+    BOOST_CHECK_EQUAL(imported.rated, 5u);
+    BOOST_CHECK_EQUAL(imported.credited, 2u);
+
+    auto index = TitleIndex::open(indexPath);
+    BOOST_REQUIRE(index);
+    BOOST_CHECK_EQUAL(index->size(), 6u);
+    BOOST_CHECK_GT(index->builtAt(), 0);
+
+    auto matrix = index->get(" TT0133093 ");
+    BOOST_REQUIRE(matrix);
+    BOOST_CHECK_EQUAL(matrix->title, "The Matrix");
+    BOOST_CHECK_EQUAL(matrix->year, 1999);
+    BOOST_CHECK_EQUAL(matrix->runtimeMinutes, 136);
+    BOOST_CHECK_CLOSE(matrix->imdbRating, 8.7, 1e-9);
+    BOOST_CHECK_EQUAL(matrix->imdbID, "tt0133093");
+    BOOST_CHECK_EQUAL(matrix->source, "imdb");
+    // Credits in billing order; producers are not kept
+    BOOST_CHECK_EQUAL(matrix->director, "Lana Wachowski, Lilly Wachowski");
+    BOOST_REQUIRE_EQUAL(matrix->actors.size(), 2u);
+    BOOST_CHECK_EQUAL(matrix->actors[0], "Keanu Reeves");
+    BOOST_CHECK_EQUAL(matrix->actors[1], "Laurence Fishburne");
+    BOOST_REQUIRE_EQUAL(matrix->genres.size(), 2u);
+    BOOST_CHECK_EQUAL(matrix->genres[1], "Sci-Fi");
+    BOOST_CHECK(matrix->plotFull.empty());
+
+    auto alien = index->get("tt0078748");
+    BOOST_REQUIRE(alien);
+    BOOST_CHECK_EQUAL(alien->director, "Ridley Scott");
+    auto spider = index->get("tt10872600");   // 8-digit ID
+    BOOST_REQUIRE(spider);
+    BOOST_CHECK_EQUAL(spider->imdbID, "tt10872600");
+    BOOST_CHECK_EQUAL(spider->imdbRating, 0.0);
+    BOOST_CHECK(spider->director.empty());
+    BOOST_CHECK(!index->get("tt0000001"));
+    BOOST_CHECK(!index->get("tt0111111"));
+    BOOST_CHECK(!index->get("nm0000206"));
+
+    // Not an index: rejected instead of mapped
+    const std::string junk = (dir / "junk.idx").string();
+    std::ofstream(junk, std::ios::binary) << std::string(200, 'x');
+    BOOST_CHECK(!TitleIndex::open(junk));
+    BOOST_CHECK(!TitleIndex::open((dir / "missing.idx").string()));
+
+    ImdbImportOptions none;
+    BOOST_CHECK(!importImdbDatasets(none, (dir / "none.idx").string()).ok);
+}
+
+BOOST_FIXTURE_TEST_CASE(fuzzy_search_and_paging, DatasetFixture)
+{
+    BOOST_REQUIRE_MESSAGE(imported.ok, imported.error);
+    auto index = TitleIndex::open(indexPath);
+    BOOST_REQUIRE(index);
+
+    // Typos still match
+    OmdbSearchPage page = index->search("matrx");
+    BOOST_REQUIRE_GE(page.results.size(), 2u);
+    BOOST_CHECK_EQUAL(page.results[0].imdbID, "tt0133093");
+    BOOST_CHECK_EQUAL(page.results[1].imdbID, "tt0234215");
+
+    page = index->search("ALIEN");
+    BOOST_REQUIRE_GE(page.results.size(), 2u);
+    BOOST_CHECK_EQUAL(page.results[0].title, "Alien");
+    BOOST_CHECK_EQUAL(page.results[0].year, 1979);
+    BOOST_CHECK_EQUAL(page.results[1].title, "Aliens");
+
+    // Original titles are searchable too
+    page = index->search("fabuleux destin");
+    BOOST_REQUIRE(!page.results.empty());
+    BOOST_CHECK_EQUAL(page.results[0].imdbID, "tt0211915");
+
+    page = index->search("spiderman no way home");
+    BOOST_REQUIRE(!page.results.empty());
+    BOOST_CHECK_EQUAL(page.results[0].imdbID, "tt10872600");
+
+    // Paging is stable and reports the total
+    OmdbSearchPage first = index->search("the matrix", 0, 1);
+    OmdbSearchPage second = index->search("the matrix", 1, 1);
+    BOOST_REQUIRE_EQUAL(first.results.size(), 1u);
+    BOOST_REQUIRE_EQUAL(second.results.size(), 1u);
+    BOOST_CHECK_EQUAL(first.totalResults, second.totalResults);
+    BOOST_CHECK_NE(first.results[0].imdbID, second.results[0].imdbID);
+    BOOST_CHECK(index->search("the matrix", first.totalResults, 10).results.empty());
+
+    BOOST_CHECK(index->search("").results.empty());
+    BOOST_CHECK(index->search("zzzzqqqq").results.empty());
+}
+
+BOOST_FIXTURE_TEST_CASE(omdb_prefers_local_index, DatasetFixture)
+{
+    BOOST_REQUIRE_MESSAGE(imported.ok, imported.error);
+    BOOST_CHECK(omdbLocalIndexModeOf("prefer") == OmdbLocalIndexMode::Prefer);
+    BOOST_CHECK(omdbLocalIndexModeOf("fallback") == OmdbLocalIndexMode::Fallback);
+    BOOST_CHECK(omdbLocalIndexModeOf("") == OmdbLocalIndexMode::Fallback);
+
+    // With hits in the index, no request goes out (the key is not even valid)
+    omdbSetLocalIndex(TitleIndex::open(indexPath), OmdbLocalIndexMode::Prefer);
+    auto hits = omdbSearch("no-key", "the matrix");
+    BOOST_REQUIRE(!hits.empty());
+    BOOST_CHECK_EQUAL(hits[0].imdbID, "tt0133093");
+
+    auto movie = omdbGetById("no-key", "tt0078748");
+    BOOST_REQUIRE(movie);
+    BOOST_CHECK_EQUAL(movie->title, "Alien");
+    BOOST_CHECK_EQUAL(movie->director, "Ridley Scott");
+
+    auto pending = omdbSearchPageAsync("no-key", "aliens", 1);
+    BOOST_REQUIRE(pending.ready());
+    BOOST_CHECK_EQUAL(pending.get().results[0].imdbID, "tt0090605");
+    auto byId = omdbGetByIdAsync("no-key", "tt0133093");
+    BOOST_REQUIRE(byId.ready());
+    BOOST_REQUIRE(byId.get());
+    BOOST_CHECK_EQUAL(byId.get()->year, 1999);
+    omdbSetLocalIndex(nullptr);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
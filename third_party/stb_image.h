@@ -1,18 +1,1830 @@
-// stb_image - v2.28 - public domain image loader - https://github.com/nothings/stb
-// This is a trimmed single-header copy sufficient for JPEG/PNG decode for our exporter.
-// Define STB_IMAGE_IMPLEMENTATION in exactly one .cpp before including this header.
-#ifndef STB_IMAGE_H
-#define STB_IMAGE_H
+/* stb_image.h - image loader with the stb_image API (JPEG, PNG, GIF, BMP from memory)
+
+   This is Top100's bundled decoder. It implements the part of the stb_image API
+   (https://github.com/nothings/stb) that lib/poster_image_stb.cpp uses, with the
+   same names, macros and pixel layout, so the upstream single header can be
+   dropped in its place without touching the caller. It is NOT upstream
+   stb_image: the build leaves it out unless TOP100_STB_IMAGE is ON, until a
+   pinned upstream release (with its own licence) replaces this file.
+
+   Usage, in exactly one C or C++ file:
+
+      #define STB_IMAGE_IMPLEMENTATION
+      #include "stb_image.h"
+
+   Optional macros, as upstream: STB_IMAGE_STATIC (private functions),
+   STBI_ONLY_JPEG / STBI_ONLY_PNG / STBI_ONLY_GIF / STBI_ONLY_BMP and
+   STBI_NO_JPEG / STBI_NO_PNG / STBI_NO_GIF / STBI_NO_BMP (pick formats),
+   STBI_MAX_DIMENSIONS (largest side accepted, default 1 << 24) and
+   STBI_NO_STDIO (accepted; only memory loading exists here).
+
+   Supported:
+      JPEG   baseline and progressive, Huffman coded, 8-bit, any chroma
+             subsampling, restart markers, greyscale, YCbCr, RGB, CMYK and YCCK
+             (Adobe); chroma is upsampled by pixel replication
+      PNG    every colour type and bit depth (16-bit is reduced to 8),
+             palettes, tRNS transparency, Adam7 interlacing
+      GIF    first frame, global and local palettes, transparency, interlacing
+      BMP    1/4/8-bit palettes, 16/24/32-bit and bit fields (no RLE)
+
+   Returned pixels are 8 bits per channel, interleaved, top-left first, with
+   straight (not premultiplied) alpha. Truncated JPEGs decode with the missing
+   data treated as zeros, as upstream does.
+
+   SPDX-License-Identifier: Apache-2.0
+*/
+#ifndef STBI_INCLUDE_STB_IMAGE_H
+#define STBI_INCLUDE_STB_IMAGE_H
+
+#include <stdlib.h>
+
+#define STBI_VERSION 1
+
+enum {
+   STBI_default = 0,   /* only used for desired_channels */
+   STBI_grey = 1,
+   STBI_grey_alpha = 2,
+   STBI_rgb = 3,
+   STBI_rgb_alpha = 4
+};
+
+typedef unsigned char stbi_uc;
+typedef unsigned short stbi_us;
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
-extern unsigned char *stbi_load_from_memory(const unsigned char *buffer, int len, int *x, int *y, int *channels_in_file, int desired_channels);
-extern void stbi_image_free(void *retval_from_stbi_load);
+#ifndef STBIDEF
+#ifdef STB_IMAGE_STATIC
+#if defined(__GNUC__) || defined(__clang__)
+#define STBIDEF static __attribute__((unused))
+#else
+#define STBIDEF static
+#endif
+#else
+#define STBIDEF extern
+#endif
+#endif
+
+/* Decode an image held in memory.
+   x, y:             receive the width and height in pixels
+   channels_in_file: receives the channel count of the image itself (may be NULL)
+   desired_channels: 0 to keep channels_in_file, or 1-4 to convert to that many
+   Returns malloc'd pixels (free with stbi_image_free), or NULL on failure. */
+STBIDEF stbi_uc *stbi_load_from_memory(const stbi_uc *buffer, int len, int *x, int *y, int *channels_in_file,
+                                       int desired_channels);
+
+/* Release pixels returned by stbi_load_from_memory(). */
+STBIDEF void stbi_image_free(void *retval_from_stbi_load);
+
+/* Why the last load on this thread failed. */
+STBIDEF const char *stbi_failure_reason(void);
 
 #ifdef __cplusplus
 }
 #endif
 
-#endif // STB_IMAGE_H
+#endif /* STBI_INCLUDE_STB_IMAGE_H */
+
+#ifdef STB_IMAGE_IMPLEMENTATION
+
+#if defined(STBI_ONLY_JPEG) || defined(STBI_ONLY_PNG) || defined(STBI_ONLY_GIF) || defined(STBI_ONLY_BMP)
+#ifndef STBI_ONLY_JPEG
+#define STBI_NO_JPEG
+#endif
+#ifndef STBI_ONLY_PNG
+#define STBI_NO_PNG
+#endif
+#ifndef STBI_ONLY_GIF
+#define STBI_NO_GIF
+#endif
+#ifndef STBI_ONLY_BMP
+#define STBI_NO_BMP
+#endif
+#endif
+
+#include <limits.h>
+#include <string.h>
+
+#ifndef STBI_MAX_DIMENSIONS
+#define STBI_MAX_DIMENSIONS (1 << 24)
+#endif
+
+#if defined(__cplusplus)
+#define STBI__THREAD_LOCAL thread_local
+#elif defined(_MSC_VER)
+#define STBI__THREAD_LOCAL __declspec(thread)
+#elif defined(__GNUC__) || defined(__clang__)
+#define STBI__THREAD_LOCAL __thread
+#else
+#define STBI__THREAD_LOCAL
+#endif
+
+/* ---------------------------------------------------------------------------
+   Common helpers
+   ------------------------------------------------------------------------- */
+
+static STBI__THREAD_LOCAL const char *stbi__g_failure_reason;
+
+STBIDEF const char *stbi_failure_reason(void)
+{
+   return stbi__g_failure_reason;
+}
+
+static int stbi__err(const char *why)
+{
+   stbi__g_failure_reason = why;
+   return 0;
+}
+
+static stbi_uc *stbi__errpuc(const char *why)
+{
+   stbi__err(why);
+   return NULL;
+}
+
+STBIDEF void stbi_image_free(void *retval_from_stbi_load)
+{
+   free(retval_from_stbi_load);
+}
+
+typedef struct {
+   const stbi_uc *p;
+   const stbi_uc *end;
+} stbi__context;
+
+static int stbi__get8(stbi__context *s)
+{
+   return s->p < s->end ? *s->p++ : 0;
+}
+
+static int stbi__get16be(stbi__context *s)
+{
+   int z = stbi__get8(s);
+   return (z << 8) | stbi__get8(s);
+}
+
+static unsigned stbi__get32be(stbi__context *s)
+{
+   unsigned z = (unsigned)stbi__get16be(s);
+   return (z << 16) | (unsigned)stbi__get16be(s);
+}
+
+static int stbi__get16le(stbi__context *s)
+{
+   int z = stbi__get8(s);
+   return z | (stbi__get8(s) << 8);
+}
+
+static unsigned stbi__get32le(stbi__context *s)
+{
+   unsigned z = (unsigned)stbi__get16le(s);
+   return z | ((unsigned)stbi__get16le(s) << 16);
+}
+
+static void stbi__skip(stbi__context *s, long n)
+{
+   if (n < 0 || n > (long)(s->end - s->p))
+      s->p = s->end;
+   else
+      s->p += n;
+}
+
+static int stbi__remaining(const stbi__context *s)
+{
+   return (int)(s->end - s->p);
+}
+
+/* a*b*c + add fits in an int (all arguments non-negative) */
+static int stbi__mad3_ok(int a, int b, int c, int add)
+{
+   if (a < 0 || b < 0 || c < 0 || add < 0) return 0;
+   if (b && a > INT_MAX / b) return 0;
+   if (c && a * b > INT_MAX / c) return 0;
+   return a * b * c <= INT_MAX - add;
+}
+
+static void *stbi__malloc_mad3(int a, int b, int c, int add)
+{
+   if (!stbi__mad3_ok(a, b, c, add)) return NULL;
+   return malloc((size_t)a * (size_t)b * (size_t)c + (size_t)add);
+}
+
+static int stbi__dimensions_ok(int w, int h)
+{
+   return w > 0 && h > 0 && w <= STBI_MAX_DIMENSIONS && h <= STBI_MAX_DIMENSIONS && stbi__mad3_ok(w, h, 4, 0);
+}
+
+static stbi_uc stbi__grey(int r, int g, int b)
+{
+   return (stbi_uc)((r * 77 + g * 150 + b * 29) >> 8);
+}
+
+/* Convert between 1-4 interleaved channels; frees data */
+static stbi_uc *stbi__convert_format(stbi_uc *data, int img_n, int req_comp, int w, int h)
+{
+   size_t i, n = (size_t)w * (size_t)h;
+   stbi_uc *good;
+   if (req_comp == img_n) return data;
+   good = (stbi_uc *)stbi__malloc_mad3(w, h, req_comp, 0);
+   if (!good) {
+      free(data);
+      return stbi__errpuc("outofmem");
+   }
+   for (i = 0; i < n; ++i) {
+      const stbi_uc *src = data + i * (size_t)img_n;
+      stbi_uc *dst = good + i * (size_t)req_comp;
+      int r, g, b, a = 255;
+      switch (img_n) {
+      case 1: r = g = b = src[0]; break;
+      case 2: r = g = b = src[0]; a = src[1]; break;
+      case 3: r = src[0]; g = src[1]; b = src[2]; break;
+      default: r = src[0]; g = src[1]; b = src[2]; a = src[3]; break;
+      }
+      switch (req_comp) {
+      case 1: dst[0] = img_n <= 2 ? (stbi_uc)r : stbi__grey(r, g, b); break;
+      case 2: dst[0] = img_n <= 2 ? (stbi_uc)r : stbi__grey(r, g, b); dst[1] = (stbi_uc)a; break;
+      case 3: dst[0] = (stbi_uc)r; dst[1] = (stbi_uc)g; dst[2] = (stbi_uc)b; break;
+      default: dst[0] = (stbi_uc)r; dst[1] = (stbi_uc)g; dst[2] = (stbi_uc)b; dst[3] = (stbi_uc)a; break;
+      }
+   }
+   free(data);
+   return good;
+}
+
+/* ---------------------------------------------------------------------------
+   JPEG (ITU T.81): Huffman, baseline and progressive
+   ------------------------------------------------------------------------- */
+#ifndef STBI_NO_JPEG
+
+#define STBI__JPEG_FAST_BITS 9
+
+typedef struct {
+   unsigned short fast[1 << STBI__JPEG_FAST_BITS];   /* symbol index, 0xffff = longer code */
+   stbi_uc size[256];
+   stbi_uc values[256];
+   int maxcode[18];
+   int delta[17];   /* symbol index = code + delta[length] */
+   int present;
+} stbi__jpeg_huffman;
+
+typedef struct {
+   int id, h, v, tq, hd, ha;
+   int dc_pred;
+   int x, y;     /* samples in the component */
+   int bw, bh;   /* blocks stored, padded to whole MCUs */
+   short *coeff; /* bw * bh blocks of 64 coefficients, natural order, not dequantized */
+   stbi_uc *pixels;
+} stbi__jpeg_component;
+
+typedef struct {
+   stbi__context s;
+   stbi__jpeg_huffman huff_dc[4];
+   stbi__jpeg_huffman huff_ac[4];
+   unsigned short dequant[4][64];
+   int frame_seen, progressive;
+   int w, h, ncomp;
+   stbi__jpeg_component comp[4];
+   int hmax, vmax, mcus_x, mcus_y;
+
+   unsigned code_buffer;
+   int code_bits;
+   int nomore;
+   int padding;   /* zero bytes fed since the entropy-coded data ran out */
+   int marker;
+
+   int restart_interval, todo, eob_run;
+   int scan_n, order[4];
+   int spec_start, spec_end, succ_high, succ_low;
+
+   int app14_transform;
+} stbi__jpeg;
+
+/* zigzag position -> natural position; the tail keeps corrupt runs in range */
+static const stbi_uc stbi__jpeg_dezigzag[64 + 16] = {
+   0,  1,  8,  16, 9,  2,  3,  10, 17, 24, 32, 25, 18, 11, 4,  5,
+   12, 19, 26, 33, 40, 48, 41, 34, 27, 20, 13, 6,  7,  14, 21, 28,
+   35, 42, 49, 56, 57, 50, 43, 36, 29, 22, 15, 23, 30, 37, 44, 51,
+   58, 59, 52, 45, 38, 31, 39, 46, 53, 60, 61, 54, 47, 55, 62, 63,
+   63, 63, 63, 63, 63, 63, 63, 63, 63, 63, 63, 63, 63, 63, 63, 63};
+
+static int stbi__jpeg_test(stbi__context *s)
+{
+   return stbi__remaining(s) >= 3 && s->p[0] == 0xff && s->p[1] == 0xd8 && s->p[2] == 0xff;
+}
+
+static int stbi__jpeg_build_huffman(stbi__jpeg_huffman *h, const int *count)
+{
+   int i, l, k = 0, code = 0;
+   for (i = 0; i < (1 << STBI__JPEG_FAST_BITS); ++i) h->fast[i] = 0xffff;
+   for (l = 1; l <= 16; ++l) {
+      h->delta[l] = k - code;
+      for (i = 0; i < count[l - 1]; ++i) {
+         if (code >= (1 << l)) return stbi__err("bad code lengths");
+         h->size[k] = (stbi_uc)l;
+         if (l <= STBI__JPEG_FAST_BITS) {
+            int first = code << (STBI__JPEG_FAST_BITS - l);
+            int m = 1 << (STBI__JPEG_FAST_BITS - l);
+            int j;
+            for (j = 0; j < m; ++j) h->fast[first + j] = (unsigned short)k;
+         }
+         ++code;
+         ++k;
+      }
+      h->maxcode[l] = count[l - 1] ? code - 1 : -1;
+      code <<= 1;
+   }
+   h->maxcode[17] = INT_MAX;
+   h->present = 1;
+   return 1;
+}
+
+static void stbi__jpeg_fill(stbi__jpeg *j)
+{
+   while (j->code_bits <= 24) {
+      unsigned b = 0;
+      if (!j->nomore) {
+         if (j->s.p >= j->s.end) {
+            j->nomore = 1;
+         } else {
+            b = *j->s.p++;
+            if (b == 0xff) {
+               int c = stbi__get8(&j->s);
+               while (c == 0xff) c = stbi__get8(&j->s);
+               if (c != 0) {
+                  j->marker = c;
+                  j->nomore = 1;
+                  b = 0;
+               }
+            }
+         }
+      }
+      if (j->nomore) ++j->padding;
+      j->code_buffer |= b << (24 - j->code_bits);
+      j->code_bits += 8;
+   }
+}
+
+static int stbi__jpeg_getbits(stbi__jpeg *j, int n)
+{
+   unsigned v;
+   if (n == 0) return 0;
+   stbi__jpeg_fill(j);
+   v = j->code_buffer >> (32 - n);
+   j->code_buffer <<= n;
+   j->code_bits -= n;
+   return (int)v;
+}
+
+static int stbi__jpeg_extend(int v, int s)
+{
+   return v < (1 << (s - 1)) ? v - (1 << s) + 1 : v;
+}
+
+static int stbi__jpeg_receive_extend(stbi__jpeg *j, int s)
+{
+   return s ? stbi__jpeg_extend(stbi__jpeg_getbits(j, s), s) : 0;
+}
+
+static int stbi__jpeg_huff_decode(stbi__jpeg *j, const stbi__jpeg_huffman *h)
+{
+   unsigned top;
+   int l, k;
+   stbi__jpeg_fill(j);
+   k = h->fast[j->code_buffer >> (32 - STBI__JPEG_FAST_BITS)];
+   if (k != 0xffff) {
+      int s = h->size[k];
+      j->code_buffer <<= s;
+      j->code_bits -= s;
+      return h->values[k];
+   }
+   top = j->code_buffer >> 16;
+   for (l = STBI__JPEG_FAST_BITS + 1; l <= 16; ++l)
+      if ((int)(top >> (16 - l)) <= h->maxcode[l]) break;
+   if (l > 16) return -1;
+   k = (int)(top >> (16 - l)) + h->delta[l];
+   if (k < 0 || k > 255) return -1;
+   j->code_buffer <<= l;
+   j->code_bits -= l;
+   return h->values[k];
+}
+
+/* Next marker code, skipping anything else; 0 at end of data */
+static int stbi__jpeg_next_marker(stbi__jpeg *j)
+{
+   if (j->marker) {
+      int m = j->marker;
+      j->marker = 0;
+      return m;
+   }
+   while (j->s.p < j->s.end) {
+      if (stbi__get8(&j->s) != 0xff) continue;
+      while (j->s.p < j->s.end && *j->s.p == 0xff) ++j->s.p;
+      if (j->s.p < j->s.end) {
+         int c = *j->s.p++;
+         if (c != 0) return c;
+      }
+   }
+   return 0;
+}
+
+static void stbi__jpeg_reset(stbi__jpeg *j)
+{
+   int i;
+   j->code_buffer = 0;
+   j->code_bits = 0;
+   j->nomore = 0;
+   j->padding = 0;
+   j->marker = 0;
+   j->eob_run = 0;
+   for (i = 0; i < j->ncomp; ++i) j->comp[i].dc_pred = 0;
+   j->todo = j->restart_interval ? j->restart_interval : INT_MAX;
+}
+
+static int stbi__jpeg_decode_block(stbi__jpeg *j, short *blk, stbi__jpeg_component *c)
+{
+   int k, t;
+   t = stbi__jpeg_huff_decode(j, &j->huff_dc[c->hd]);
+   if (t < 0 || t > 15) return stbi__err("bad huffman code");
+   c->dc_pred += stbi__jpeg_receive_extend(j, t);
+   blk[0] = (short)c->dc_pred;
+   k = 1;
+   while (k < 64) {
+      int rs = stbi__jpeg_huff_decode(j, &j->huff_ac[c->ha]);
+      int r, s;
+      if (rs < 0) return stbi__err("bad huffman code");
+      s = rs & 15;
+      r = rs >> 4;
+      if (s == 0) {
+         if (rs != 0xf0) break;   /* end of block */
+         k += 16;
+         continue;
+      }
+      k += r;
+      if (k > 63) return stbi__err("bad AC run");
+      blk[stbi__jpeg_dezigzag[k++]] = (short)stbi__jpeg_receive_extend(j, s);
+   }
+   return 1;
+}
+
+static int stbi__jpeg_decode_block_prog_dc(stbi__jpeg *j, short *blk, stbi__jpeg_component *c)
+{
+   if (j->succ_high == 0) {
+      int t = stbi__jpeg_huff_decode(j, &j->huff_dc[c->hd]);
+      if (t < 0 || t > 15) return stbi__err("bad huffman code");
+      c->dc_pred += stbi__jpeg_receive_extend(j, t);
+      blk[0] = (short)(c->dc_pred * (1 << j->succ_low));
+   } else if (stbi__jpeg_getbits(j, 1)) {
+      blk[0] = (short)(blk[0] | (1 << j->succ_low));
+   }
+   return 1;
+}
+
+static int stbi__jpeg_decode_block_prog_ac(stbi__jpeg *j, short *blk, stbi__jpeg_component *c)
+{
+   const stbi__jpeg_huffman *h = &j->huff_ac[c->ha];
+   int k = j->spec_start;
+   if (j->succ_high == 0) {
+      if (j->eob_run) {
+         --j->eob_run;
+         return 1;
+      }
+      do {
+         int rs = stbi__jpeg_huff_decode(j, h);
+         int r, s;
+         if (rs < 0) return stbi__err("bad huffman code");
+         s = rs & 15;
+         r = rs >> 4;
+         if (s == 0) {
+            if (r < 15) {
+               j->eob_run = (1 << r) - 1;
+               if (r) j->eob_run += stbi__jpeg_getbits(j, r);
+               break;
+            }
+            k += 16;
+         } else {
+            k += r;
+            if (k > j->spec_end) return stbi__err("bad AC run");
+            blk[stbi__jpeg_dezigzag[k++]] = (short)(stbi__jpeg_receive_extend(j, s) * (1 << j->succ_low));
+         }
+      } while (k <= j->spec_end);
+   } else {
+      /* refinement: one more bit for every coefficient already known, and new ones of +-1 */
+      short bit = (short)(1 << j->succ_low);
+      if (j->eob_run) {
+         --j->eob_run;
+         for (; k <= j->spec_end; ++k) {
+            short *p = &blk[stbi__jpeg_dezigzag[k]];
+            if (*p != 0 && stbi__jpeg_getbits(j, 1) && (*p & bit) == 0) *p = (short)(*p > 0 ? *p + bit : *p - bit);
+         }
+      } else {
+         do {
+            int rs = stbi__jpeg_huff_decode(j, h);
+            int r, s;
+            if (rs < 0) return stbi__err("bad huffman code");
+            s = rs & 15;
+            r = rs >> 4;
+            if (s == 0) {
+               if (r < 15) {
+                  j->eob_run = (1 << r) - 1;
+                  if (r) j->eob_run += stbi__jpeg_getbits(j, r);
+                  r = 64;   /* refine the rest of the block, place nothing */
+               }
+            } else {
+               if (s != 1) return stbi__err("bad refinement");
+               s = stbi__jpeg_getbits(j, 1) ? bit : -bit;
+            }
+            while (k <= j->spec_end) {
+               short *p = &blk[stbi__jpeg_dezigzag[k++]];
+               if (*p != 0) {
+                  if (stbi__jpeg_getbits(j, 1) && (*p & bit) == 0) *p = (short)(*p > 0 ? *p + bit : *p - bit);
+               } else {
+                  if (r == 0) {
+                     *p = (short)s;
+                     break;
+                  }
+                  --r;
+               }
+            }
+         } while (k <= j->spec_end);
+      }
+   }
+   return 1;
+}
+
+static int stbi__jpeg_decode_one(stbi__jpeg *j, stbi__jpeg_component *c, int bx, int by)
+{
+   short *blk = c->coeff + ((size_t)by * (size_t)c->bw + (size_t)bx) * 64;
+   if (!j->progressive) return stbi__jpeg_decode_block(j, blk, c);
+   if (j->spec_start == 0) return stbi__jpeg_decode_block_prog_dc(j, blk, c);
+   return stbi__jpeg_decode_block_prog_ac(j, blk, c);
+}
+
+/* After each MCU: at the end of a restart interval, expect RSTn and start over */
+static int stbi__jpeg_after_mcu(stbi__jpeg *j, int *stop)
+{
+   if (j->padding > 4) {
+      /* every buffered bit is padding: the rest of the scan is missing, leave it zero */
+      *stop = 1;
+      return 1;
+   }
+   if (--j->todo > 0) return 1;
+   {
+      int m = stbi__jpeg_next_marker(j);
+      if (m >= 0xd0 && m <= 0xd7) {
+         stbi__jpeg_reset(j);
+      } else {
+         j->marker = m;   /* some other marker: the scan ended early */
+         *stop = 1;
+      }
+   }
+   return 1;
+}
+
+static int stbi__jpeg_decode_scan(stbi__jpeg *j)
+{
+   int stop = 0;
+   stbi__jpeg_reset(j);
+   if (j->scan_n == 1) {
+      /* non-interleaved: every block of the component is its own MCU */
+      stbi__jpeg_component *c = &j->comp[j->order[0]];
+      int w = (c->x + 7) >> 3, h = (c->y + 7) >> 3, bx, by;
+      for (by = 0; by < h && !stop; ++by)
+         for (bx = 0; bx < w && !stop; ++bx) {
+            if (!stbi__jpeg_decode_one(j, c, bx, by)) return 0;
+            if (!stbi__jpeg_after_mcu(j, &stop)) return 0;
+         }
+   } else {
+      int mx, my, i, u, v;
+      for (my = 0; my < j->mcus_y && !stop; ++my)
+         for (mx = 0; mx < j->mcus_x && !stop; ++mx) {
+            for (i = 0; i < j->scan_n; ++i) {
+               stbi__jpeg_component *c = &j->comp[j->order[i]];
+               for (v = 0; v < c->v; ++v)
+                  for (u = 0; u < c->h; ++u)
+                     if (!stbi__jpeg_decode_one(j, c, mx * c->h + u, my * c->v + v)) return 0;
+            }
+            if (!stbi__jpeg_after_mcu(j, &stop)) return 0;
+         }
+   }
+   return 1;
+}
+
+static stbi_uc stbi__clamp_sample(float v)
+{
+   v += 128.5f;
+   if (v <= 0.0f) return 0;
+   if (v >= 255.0f) return 255;
+   return (stbi_uc)(int)v;
+}
+
+/* AAN scale factors: 1 for k = 0, cos(k pi/16) * sqrt(2) otherwise */
+static const float stbi__jpeg_aan[8] = {1.0f,         1.387039845f, 1.306562965f, 1.175875602f,
+                                        1.0f,         0.785694958f, 0.541196100f, 0.275899379f};
+
+/* One 8-point AAN inverse DCT (Arai, Agui, Nakajima) over in[0], in[step], ... */
+static void stbi__jpeg_idct_1d(float *v, int step)
+{
+   float t0 = v[0], t1 = v[2 * step], t2 = v[4 * step], t3 = v[6 * step];
+   float t10 = t0 + t2, t11 = t0 - t2, t13 = t1 + t3, t12 = (t1 - t3) * 1.414213562f - t13;
+   float e0 = t10 + t13, e3 = t10 - t13, e1 = t11 + t12, e2 = t11 - t12;
+   float t4 = v[step], t5 = v[3 * step], t6 = v[5 * step], t7 = v[7 * step];
+   float z13 = t6 + t5, z10 = t6 - t5, z11 = t4 + t7, z12 = t4 - t7;
+   float z5 = (z10 + z12) * 1.847759065f;
+   float o7 = z11 + z13, o11 = (z11 - z13) * 1.414213562f;
+   float o10 = 1.082392200f * z12 - z5, o12 = -2.613125930f * z10 + z5;
+   float o6 = o12 - o7, o5 = o11 - o6, o4 = o10 + o5;
+   v[0] = e0 + o7;
+   v[7 * step] = e0 - o7;
+   v[step] = e1 + o6;
+   v[6 * step] = e1 - o6;
+   v[2 * step] = e2 + o5;
+   v[5 * step] = e2 - o5;
+   v[4 * step] = e3 + o4;
+   v[3 * step] = e3 - o4;
+}
+
+/* Quantization table with the AAN scale factors and the final 1/8 folded in */
+static void stbi__jpeg_scale_quant(const unsigned short *q, float *scaled)
+{
+   int x, y;
+   for (y = 0; y < 8; ++y)
+      for (x = 0; x < 8; ++x) scaled[y * 8 + x] = (float)q[y * 8 + x] * stbi__jpeg_aan[y] * stbi__jpeg_aan[x] * 0.125f;
+}
+
+static void stbi__jpeg_idct_block(const short *blk, const float *q, stbi_uc *out, int stride)
+{
+   float ws[64];
+   int i, x, y, ac = 0;
+   for (i = 1; i < 64; ++i) ac |= blk[i];
+   if (!ac) {
+      stbi_uc dc = stbi__clamp_sample((float)blk[0] * q[0]);
+      for (y = 0; y < 8; ++y) memset(out + y * stride, dc, 8);
+      return;
+   }
+   for (i = 0; i < 64; ++i) ws[i] = (float)blk[i] * q[i];
+   for (x = 0; x < 8; ++x) stbi__jpeg_idct_1d(ws + x, 8);   /* columns */
+   for (y = 0; y < 8; ++y) {                                   /* rows */
+      stbi__jpeg_idct_1d(ws + y * 8, 1);
+      for (x = 0; x < 8; ++x) out[y * stride + x] = stbi__clamp_sample(ws[y * 8 + x]);
+   }
+}
+
+static int stbi__jpeg_read_dqt(stbi__jpeg *j)
+{
+   int len = stbi__get16be(&j->s) - 2;
+   while (len > 0) {
+      int pq = stbi__get8(&j->s), t = pq & 15, k;
+      int sixteen = pq >> 4;
+      if (sixteen > 1 || t > 3) return stbi__err("bad DQT");
+      for (k = 0; k < 64; ++k)
+         j->dequant[t][stbi__jpeg_dezigzag[k]] = (unsigned short)(sixteen ? stbi__get16be(&j->s) : stbi__get8(&j->s));
+      len -= sixteen ? 129 : 65;
+   }
+   return len == 0 ? 1 : stbi__err("bad DQT length");
+}
+
+static int stbi__jpeg_read_dht(stbi__jpeg *j)
+{
+   int len = stbi__get16be(&j->s) - 2;
+   while (len > 0) {
+      int tc = stbi__get8(&j->s), th = tc & 15, count[16], n = 0, i;
+      stbi__jpeg_huffman *h;
+      tc >>= 4;
+      if (tc > 1 || th > 3) return stbi__err("bad DHT");
+      for (i = 0; i < 16; ++i) n += count[i] = stbi__get8(&j->s);
+      if (n > 256) return stbi__err("bad DHT");
+      h = tc ? &j->huff_ac[th] : &j->huff_dc[th];
+      for (i = 0; i < n; ++i) h->values[i] = (stbi_uc)stbi__get8(&j->s);
+      if (!stbi__jpeg_build_huffman(h, count)) return 0;
+      len -= 17 + n;
+   }
+   return len == 0 ? 1 : stbi__err("bad DHT length");
+}
+
+static int stbi__jpeg_read_sof(stbi__jpeg *j)
+{
+   int len = stbi__get16be(&j->s), i;
+   if (j->frame_seen) return stbi__err("multiple frames");
+   if (stbi__get8(&j->s) != 8) return stbi__err("only 8-bit JPEG");
+   j->h = stbi__get16be(&j->s);
+   j->w = stbi__get16be(&j->s);
+   j->ncomp = stbi__get8(&j->s);
+   if (j->h == 0) return stbi__err("no height (DNL)");
+   if (!stbi__dimensions_ok(j->w, j->h)) return stbi__err("bad dimensions");
+   if (j->ncomp != 1 && j->ncomp != 3 && j->ncomp != 4) return stbi__err("bad component count");
+   if (len != 8 + 3 * j->ncomp) return stbi__err("bad SOF length");
+   j->hmax = j->vmax = 1;
+   for (i = 0; i < j->ncomp; ++i) {
+      stbi__jpeg_component *c = &j->comp[i];
+      int hv;
+      c->id = stbi__get8(&j->s);
+      hv = stbi__get8(&j->s);
+      c->h = hv >> 4;
+      c->v = hv & 15;
+      c->tq = stbi__get8(&j->s);
+      if (c->h < 1 || c->h > 4 || c->v < 1 || c->v > 4 || c->tq > 3) return stbi__err("bad component");
+      if (c->h > j->hmax) j->hmax = c->h;
+      if (c->v > j->vmax) j->vmax = c->v;
+   }
+   j->mcus_x = (j->w + 8 * j->hmax - 1) / (8 * j->hmax);
+   j->mcus_y = (j->h + 8 * j->vmax - 1) / (8 * j->vmax);
+   for (i = 0; i < j->ncomp; ++i) {
+      stbi__jpeg_component *c = &j->comp[i];
+      c->x = (j->w * c->h + j->hmax - 1) / j->hmax;
+      c->y = (j->h * c->v + j->vmax - 1) / j->vmax;
+      c->bw = j->mcus_x * c->h;
+      c->bh = j->mcus_y * c->v;
+      if (!stbi__mad3_ok(c->bw * 8, c->bh * 8, 2, 0)) return stbi__err("too large");
+      c->coeff = (short *)calloc((size_t)c->bw * (size_t)c->bh * 64, sizeof(short));
+      if (!c->coeff) return stbi__err("outofmem");
+   }
+   j->frame_seen = 1;
+   return 1;
+}
+
+static int stbi__jpeg_read_sos(stbi__jpeg *j)
+{
+   int len = stbi__get16be(&j->s), i, a;
+   if (!j->frame_seen) return stbi__err("scan before frame");
+   j->scan_n = stbi__get8(&j->s);
+   if (j->scan_n < 1 || j->scan_n > j->ncomp || len != 6 + 2 * j->scan_n) return stbi__err("bad SOS");
+   for (i = 0; i < j->scan_n; ++i) {
+      int id = stbi__get8(&j->s), tables = stbi__get8(&j->s), which;
+      for (which = 0; which < j->ncomp; ++which)
+         if (j->comp[which].id == id) break;
+      if (which == j->ncomp) return stbi__err("bad SOS component");
+      j->comp[which].hd = tables >> 4;
+      j->comp[which].ha = tables & 15;
+      if (j->comp[which].hd > 3 || j->comp[which].ha > 3) return stbi__err("bad SOS tables");
+      j->order[i] = which;
+   }
+   j->spec_start = stbi__get8(&j->s);
+   j->spec_end = stbi__get8(&j->s);
+   a = stbi__get8(&j->s);
+   j->succ_high = a >> 4;
+   j->succ_low = a & 15;
+   if (j->progressive) {
+      if (j->spec_start > 63 || j->spec_end > 63 || j->spec_start > j->spec_end || j->succ_high > 13 ||
+          j->succ_low > 13)
+         return stbi__err("bad progressive scan");
+      if (j->spec_start == 0 && j->spec_end != 0) return stbi__err("bad progressive scan");
+      if (j->spec_start != 0 && j->scan_n != 1) return stbi__err("interleaved AC scan");
+   } else {
+      if (j->spec_start != 0 || j->succ_high != 0 || j->succ_low != 0) return stbi__err("bad baseline scan");
+      j->spec_end = 63;
+   }
+   for (i = 0; i < j->scan_n; ++i) {
+      const stbi__jpeg_component *c = &j->comp[j->order[i]];
+      int needs_dc = j->spec_start == 0 && !(j->progressive && j->succ_high);
+      int needs_ac = j->spec_end != 0;
+      if ((needs_dc && !j->huff_dc[c->hd].present) || (needs_ac && !j->huff_ac[c->ha].present))
+         return stbi__err("missing huffman table");
+   }
+   return 1;
+}
+
+static void stbi__jpeg_free(stbi__jpeg *j)
+{
+   int i;
+   for (i = 0; i < 4; ++i) {
+      free(j->comp[i].coeff);
+      free(j->comp[i].pixels);
+      j->comp[i].coeff = NULL;
+      j->comp[i].pixels = NULL;
+   }
+}
+
+static stbi_uc stbi__blinn_8x8(int x, int y)
+{
+   unsigned t = (unsigned)(x * y + 128);
+   return (stbi_uc)((t + (t >> 8)) >> 8);
+}
+
+static stbi_uc stbi__clamp_fixed(int v)   /* 16.16 fixed point to a byte */
+{
+   if (v < 0) return 0;
+   v >>= 16;
+   return (stbi_uc)(v > 255 ? 255 : v);
+}
+
+static void stbi__ycc_to_rgb(int y, int cb, int cr, stbi_uc *out)
+{
+   int yy = (y << 16) + 32768;
+   cb -= 128;
+   cr -= 128;
+   out[0] = stbi__clamp_fixed(yy + cr * 91881);
+   out[1] = stbi__clamp_fixed(yy - cb * 22554 - cr * 46802);
+   out[2] = stbi__clamp_fixed(yy + cb * 116130);
+}
+
+/* Colour-convert the decoded planes into req_comp channels (0 = the image's own count) */
+static stbi_uc *stbi__jpeg_output(stbi__jpeg *j, int req_comp, int *out_n)
+{
+   int i, x, y, n = j->ncomp == 1 ? 1 : 3, outn = req_comp ? req_comp : n;
+   int rgb = j->ncomp == 3 && (j->app14_transform == 0 ||
+                               (j->comp[0].id == 'R' && j->comp[1].id == 'G' && j->comp[2].id == 'B'));
+   stbi_uc *out, *up, *line;
+   int stride[4];
+
+   for (i = 0; i < j->ncomp; ++i) {
+      stbi__jpeg_component *c = &j->comp[i];
+      float q[64];
+      int bx, by;
+      stbi__jpeg_scale_quant(j->dequant[c->tq], q);
+      stride[i] = c->bw * 8;
+      c->pixels = (stbi_uc *)stbi__malloc_mad3(c->bw * 8, c->bh * 8, 1, 0);
+      if (!c->pixels) return stbi__errpuc("outofmem");
+      for (by = 0; by < c->bh; ++by)
+         for (bx = 0; bx < c->bw; ++bx)
+            stbi__jpeg_idct_block(c->coeff + ((size_t)by * c->bw + bx) * 64, q,
+                                  c->pixels + (size_t)by * 8 * stride[i] + bx * 8, stride[i]);
+   }
+
+   out = (stbi_uc *)stbi__malloc_mad3(j->w, j->h, outn, 0);
+   up = (stbi_uc *)stbi__malloc_mad3(j->w, 4, 1, 0);     /* subsampled components, replicated */
+   line = (stbi_uc *)stbi__malloc_mad3(j->w, 3, 1, 0);   /* one row of RGB or grey */
+   if (!out || !up || !line) {
+      free(out);
+      free(up);
+      free(line);
+      return stbi__errpuc("outofmem");
+   }
+   for (y = 0; y < j->h; ++y) {
+      const stbi_uc *s[4];
+      stbi_uc *dst = out + (size_t)y * (size_t)j->w * (size_t)outn;
+      for (i = 0; i < j->ncomp; ++i) {
+         const stbi__jpeg_component *c = &j->comp[i];
+         const stbi_uc *row = c->pixels + (size_t)(y * c->v / j->vmax) * (size_t)stride[i];
+         if (c->h == j->hmax) {
+            s[i] = row;
+         } else {
+            stbi_uc *u = up + (size_t)i * (size_t)j->w;
+            for (x = 0; x < j->w; ++x) u[x] = row[x * c->h / j->hmax];
+            s[i] = u;
+         }
+      }
+      if (j->ncomp == 1) {
+         memcpy(line, s[0], (size_t)j->w);
+      } else {
+         stbi_uc *d = line;
+         for (x = 0; x < j->w; ++x, d += 3) {
+            if (j->ncomp == 3 && rgb) {
+               d[0] = s[0][x];
+               d[1] = s[1][x];
+               d[2] = s[2][x];
+            } else {
+               stbi__ycc_to_rgb(s[0][x], s[1][x], s[2][x], d);
+            }
+            if (j->ncomp == 4) {
+               int k = s[3][x];
+               if (j->app14_transform == 0) {   /* Adobe CMYK, stored inverted */
+                  d[0] = stbi__blinn_8x8(s[0][x], k);
+                  d[1] = stbi__blinn_8x8(s[1][x], k);
+                  d[2] = stbi__blinn_8x8(s[2][x], k);
+               } else if (j->app14_transform == 2) {   /* YCCK */
+                  d[0] = stbi__blinn_8x8(255 - d[0], k);
+                  d[1] = stbi__blinn_8x8(255 - d[1], k);
+                  d[2] = stbi__blinn_8x8(255 - d[2], k);
+               }
+            }
+         }
+      }
+      if (n == 1) {
+         for (x = 0; x < j->w; ++x, dst += outn) {
+            dst[0] = line[x];
+            if (outn >= 3) dst[1] = dst[2] = line[x];
+            if (outn == 2 || outn == 4) dst[outn - 1] = 255;
+         }
+      } else if (outn == 3) {
+         memcpy(dst, line, (size_t)j->w * 3);
+      } else {
+         const stbi_uc *l = line;
+         for (x = 0; x < j->w; ++x, dst += outn, l += 3) {
+            if (outn <= 2) {
+               dst[0] = stbi__grey(l[0], l[1], l[2]);
+            } else {
+               dst[0] = l[0];
+               dst[1] = l[1];
+               dst[2] = l[2];
+            }
+            if (outn == 2 || outn == 4) dst[outn - 1] = 255;
+         }
+      }
+   }
+   free(up);
+   free(line);
+   *out_n = n;
+   return out;
+}
+
+static stbi_uc *stbi__jpeg_load(stbi__context *s, int *x, int *y, int *comp, int req_comp)
+{
+   stbi__jpeg *j = (stbi__jpeg *)calloc(1, sizeof(stbi__jpeg));
+   stbi_uc *result = NULL;
+   int m, ok = 1, scans = 0;
+   if (!j) return stbi__errpuc("outofmem");
+   j->s = *s;
+   j->app14_transform = -1;
+   j->s.p += 2;   /* SOI */
+   while (ok && (m = stbi__jpeg_next_marker(j)) != 0 && m != 0xd9) {
+      switch (m) {
+      case 0xdb: ok = stbi__jpeg_read_dqt(j); break;
+      case 0xc4: ok = stbi__jpeg_read_dht(j); break;
+      case 0xc0:
+      case 0xc1:
+      case 0xc2:
+         j->progressive = m == 0xc2;
+         ok = stbi__jpeg_read_sof(j);
+         break;
+      case 0xdd:
+         ok = stbi__get16be(&j->s) == 4 || stbi__err("bad DRI");
+         j->restart_interval = stbi__get16be(&j->s);
+         break;
+      case 0xda:
+         ok = stbi__jpeg_read_sos(j) && stbi__jpeg_decode_scan(j);
+         ++scans;
+         break;
+      case 0xee: {   /* APP14: Adobe colour transform */
+         int len = stbi__get16be(&j->s) - 2;
+         if (len >= 12 && stbi__remaining(&j->s) >= 12 && memcmp(j->s.p, "Adobe", 5) == 0) j->app14_transform = j->s.p[11];
+         stbi__skip(&j->s, len);
+         break;
+      }
+      default:
+         if (m >= 0xc3 && m <= 0xcf && m != 0xc8 && m != 0xcc)
+            ok = stbi__err("unsupported JPEG type");   /* lossless, hierarchical, arithmetic */
+         else if (m != 0x01 && !(m >= 0xd0 && m <= 0xd8))
+            stbi__skip(&j->s, stbi__get16be(&j->s) - 2);   /* APPn, COM, ...; TEM, SOI and RSTn carry no length */
+         break;
+      }
+   }
+   if (ok && !scans) ok = stbi__err("no image data");
+   if (ok) {
+      int n;
+      result = stbi__jpeg_output(j, req_comp, &n);
+      if (result) {
+         *x = j->w;
+         *y = j->h;
+         *comp = n;
+      }
+   }
+   stbi__jpeg_free(j);
+   free(j);
+   return result;
+}
+
+#endif /* STBI_NO_JPEG */
+
+/* ---------------------------------------------------------------------------
+   zlib inflate (RFC 1950/1951), for PNG
+   ------------------------------------------------------------------------- */
+#ifndef STBI_NO_PNG
+
+#define STBI__ZFAST_BITS 9
+
+typedef struct {
+   unsigned short fast[1 << STBI__ZFAST_BITS];   /* (length << 9) | symbol, 0 = longer code */
+   unsigned short count[16];
+   unsigned short symbol[288];
+} stbi__zhuffman;
+
+typedef struct {
+   const stbi_uc *p;
+   const stbi_uc *end;
+   unsigned buf;
+   int bits;
+   int overrun;
+   stbi_uc *out;
+   size_t len;
+   size_t cap;
+   size_t limit;
+} stbi__zbuf;
+
+static int stbi__zbuild(stbi__zhuffman *z, const stbi_uc *lengths, int n)
+{
+   int offs[16], next_code[16], i, len, left = 1, code = 0;
+   memset(z, 0, sizeof(*z));
+   for (i = 0; i < n; ++i) ++z->count[lengths[i]];
+   z->count[0] = 0;
+   for (len = 1; len < 16; ++len) {
+      left = (left << 1) - z->count[len];
+      if (left < 0) return stbi__err("bad code lengths");
+   }
+   offs[1] = 0;
+   for (len = 1; len < 15; ++len) offs[len + 1] = offs[len] + z->count[len];
+   for (len = 1; len < 16; ++len) {
+      next_code[len] = code;
+      code = (code + z->count[len]) << 1;
+   }
+   for (i = 0; i < n; ++i) {
+      int l = lengths[i];
+      if (!l) continue;
+      z->symbol[offs[l]++] = (unsigned short)i;
+      if (l <= STBI__ZFAST_BITS) {
+         int c = next_code[l], rev = 0, b, k;
+         for (b = 0; b < l; ++b) rev |= ((c >> b) & 1) << (l - 1 - b);
+         for (k = rev; k < (1 << STBI__ZFAST_BITS); k += 1 << l) z->fast[k] = (unsigned short)((l << 9) | i);
+      }
+      ++next_code[l];
+   }
+   return 1;
+}
+
+static void stbi__zneed(stbi__zbuf *a, int n)
+{
+   while (a->bits < n) {
+      unsigned b = 0;
+      if (a->p < a->end)
+         b = *a->p++;
+      else
+         ++a->overrun;
+      a->buf |= b << a->bits;
+      a->bits += 8;
+   }
+}
+
+static int stbi__zbits(stbi__zbuf *a, int n)
+{
+   int v;
+   if (n == 0) return 0;
+   stbi__zneed(a, n);
+   v = (int)(a->buf & ((1u << n) - 1));
+   a->buf >>= n;
+   a->bits -= n;
+   return v;
+}
+
+static int stbi__zdecode(stbi__zbuf *a, const stbi__zhuffman *z)
+{
+   int f, len, code = 0, first = 0, index = 0;
+   stbi__zneed(a, 16);
+   f = z->fast[a->buf & ((1 << STBI__ZFAST_BITS) - 1)];
+   if (f) {
+      a->buf >>= f >> 9;
+      a->bits -= f >> 9;
+      return f & 511;
+   }
+   for (len = 1; len < 16; ++len) {   /* canonical decode, one bit at a time */
+      int count = z->count[len];
+      code |= (int)(a->buf & 1);
+      a->buf >>= 1;
+      --a->bits;
+      if (code - count < first) return z->symbol[index + (code - first)];
+      index += count;
+      first = (first + count) << 1;
+      code <<= 1;
+      if (a->bits == 0) stbi__zneed(a, 1);
+   }
+   return -1;
+}
+
+static int stbi__zput(stbi__zbuf *a, stbi_uc c)
+{
+   if (a->len == a->cap) {
+      size_t cap = a->cap ? a->cap * 2 : 65536;
+      stbi_uc *grown;
+      if (cap > a->limit) cap = a->limit;
+      if (cap <= a->len) return stbi__err("too much image data");
+      grown = (stbi_uc *)realloc(a->out, cap);
+      if (!grown) return stbi__err("outofmem");
+      a->out = grown;
+      a->cap = cap;
+   }
+   a->out[a->len++] = c;
+   return 1;
+}
+
+static const int stbi__zlength_base[29] = {3,  4,  5,  6,  7,  8,  9,  10, 11,  13,  15,  17,  19,  23, 27,
+                                           31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+static const int stbi__zlength_extra[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2,
+                                            2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+static const int stbi__zdist_base[30] = {1,   2,   3,   4,   5,   7,    9,    13,   17,   25,   33,   49,    65,    97,    129,
+                                         193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+static const int stbi__zdist_extra[30] = {0, 0, 0, 0, 1, 1, 2, 2,  3,  3,  4,  4,  5,  5,  6,
+                                          6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+static int stbi__zblock(stbi__zbuf *a, const stbi__zhuffman *lit, const stbi__zhuffman *dist)
+{
+   for (;;) {
+      int sym = stbi__zdecode(a, lit);
+      if (a->overrun > 4) return stbi__err("truncated zlib data");
+      if (sym < 0) return stbi__err("bad huffman code");
+      if (sym < 256) {
+         if (!stbi__zput(a, (stbi_uc)sym)) return 0;
+      } else if (sym == 256) {
+         return 1;
+      } else {
+         int len, d;
+         size_t from;
+         sym -= 257;
+         if (sym >= 29) return stbi__err("bad length code");
+         len = stbi__zlength_base[sym] + stbi__zbits(a, stbi__zlength_extra[sym]);
+         d = stbi__zdecode(a, dist);
+         if (d < 0 || d >= 30) return stbi__err("bad distance code");
+         d = stbi__zdist_base[d] + stbi__zbits(a, stbi__zdist_extra[d]);
+         if ((size_t)d > a->len) return stbi__err("bad distance");
+         from = a->len - (size_t)d;
+         while (len--)
+            if (!stbi__zput(a, a->out[from++])) return 0;
+      }
+   }
+}
+
+static int stbi__zdynamic(stbi__zbuf *a, stbi__zhuffman *lit, stbi__zhuffman *dist)
+{
+   static const stbi_uc order[19] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+   stbi__zhuffman codes;
+   stbi_uc lens[286 + 32], clens[19];
+   int hlit = stbi__zbits(a, 5) + 257, hdist = stbi__zbits(a, 5) + 1, hclen = stbi__zbits(a, 4) + 4, i, n = 0;
+   if (hlit > 286 || hdist > 30) return stbi__err("bad code lengths");
+   memset(clens, 0, sizeof(clens));
+   for (i = 0; i < hclen; ++i) clens[order[i]] = (stbi_uc)stbi__zbits(a, 3);
+   if (!stbi__zbuild(&codes, clens, 19)) return 0;
+   while (n < hlit + hdist) {
+      int c = stbi__zdecode(a, &codes), rep;
+      stbi_uc fill = 0;
+      if (c < 0 || a->overrun > 4) return stbi__err("bad code lengths");
+      if (c < 16) {
+         lens[n++] = (stbi_uc)c;
+         continue;
+      }
+      if (c == 16) {
+         if (n == 0) return stbi__err("bad code lengths");
+         fill = lens[n - 1];
+         rep = 3 + stbi__zbits(a, 2);
+      } else if (c == 17) {
+         rep = 3 + stbi__zbits(a, 3);
+      } else {
+         rep = 11 + stbi__zbits(a, 7);
+      }
+      if (n + rep > hlit + hdist) return stbi__err("bad code lengths");
+      memset(lens + n, fill, (size_t)rep);
+      n += rep;
+   }
+   if (!lens[256]) return stbi__err("no end-of-block code");
+   return stbi__zbuild(lit, lens, hlit) && stbi__zbuild(dist, lens + hlit, hdist);
+}
+
+/* Inflate a zlib stream; at most limit bytes of output */
+static stbi_uc *stbi__zlib_decode(const stbi_uc *data, size_t len, size_t limit, size_t *outlen)
+{
+   stbi__zbuf a;
+   stbi__zhuffman *lit, *dist;
+   int final, ok = 1;
+   if (len < 2 || (data[0] & 15) != 8 || ((data[0] << 8) | data[1]) % 31 != 0 || (data[1] & 32))
+      return stbi__errpuc("bad zlib header");
+   memset(&a, 0, sizeof(a));
+   a.p = data + 2;
+   a.end = data + len;
+   a.limit = limit;
+   lit = (stbi__zhuffman *)malloc(2 * sizeof(stbi__zhuffman));
+   if (!lit) return stbi__errpuc("outofmem");
+   dist = lit + 1;
+   do {
+      int type;
+      final = stbi__zbits(&a, 1);
+      type = stbi__zbits(&a, 2);
+      if (type == 0) {
+         int n, nn;
+         stbi__zbits(&a, a.bits & 7);
+         n = stbi__zbits(&a, 16);
+         nn = stbi__zbits(&a, 16);
+         if ((n ^ 0xffff) != nn) {
+            ok = stbi__err("bad stored block");
+            break;
+         }
+         while (n > 0 && a.bits > 0 && ok) {
+            ok = stbi__zput(&a, (stbi_uc)stbi__zbits(&a, 8));
+            --n;
+         }
+         if (!ok) break;
+         if ((size_t)n > (size_t)(a.end - a.p)) {
+            ok = stbi__err("truncated zlib data");
+            break;
+         }
+         while (n-- > 0 && ok) ok = stbi__zput(&a, *a.p++);
+      } else if (type == 1) {
+         stbi_uc lens[288 + 32];
+         memset(lens, 8, 144);
+         memset(lens + 144, 9, 112);
+         memset(lens + 256, 7, 24);
+         memset(lens + 280, 8, 8);
+         memset(lens + 288, 5, 32);
+         ok = stbi__zbuild(lit, lens, 288) && stbi__zbuild(dist, lens + 288, 32) && stbi__zblock(&a, lit, dist);
+      } else if (type == 2) {
+         ok = stbi__zdynamic(&a, lit, dist) && stbi__zblock(&a, lit, dist);
+      } else {
+         ok = stbi__err("bad block type");
+      }
+      if (a.overrun > 4) ok = stbi__err("truncated zlib data");
+   } while (ok && !final);
+   free(lit);
+   if (!ok) {
+      free(a.out);
+      return NULL;
+   }
+   *outlen = a.len;
+   return a.out;
+}
+
+/* ---------------------------------------------------------------------------
+   PNG
+   ------------------------------------------------------------------------- */
+
+static int stbi__png_test(stbi__context *s)
+{
+   static const stbi_uc sig[8] = {137, 80, 78, 71, 13, 10, 26, 10};
+   return stbi__remaining(s) >= 8 && memcmp(s->p, sig, 8) == 0;
+}
+
+static int stbi__paeth(int a, int b, int c)
+{
+   int p = a + b - c, pa = abs(p - a), pb = abs(p - b), pc = abs(p - c);
+   if (pa <= pb && pa <= pc) return a;
+   return pb <= pc ? b : c;
+}
+
+static unsigned stbi__png_sample(const stbi_uc *line, int i, int depth)
+{
+   if (depth == 8) return line[i];
+   if (depth == 16) return ((unsigned)line[2 * i] << 8) | line[2 * i + 1];
+   {
+      int bit = i * depth;
+      return (unsigned)(line[bit >> 3] >> (8 - depth - (bit & 7))) & ((1u << depth) - 1);
+   }
+}
+
+static stbi_uc *stbi__png_load(stbi__context *s, int *x, int *y, int *comp)
+{
+   static const int xorig[7] = {0, 4, 0, 2, 0, 1, 0}, yorig[7] = {0, 0, 4, 0, 2, 0, 1};
+   static const int xspc[7] = {8, 8, 4, 4, 2, 2, 1}, yspc[7] = {8, 8, 8, 4, 4, 2, 2};
+   stbi_uc palette[256 * 4], *idat = NULL, *raw = NULL, *out = NULL, *lines = NULL;
+   size_t idat_len = 0, raw_len = 0, pos = 0, need = 0;
+   int w = 0, h = 0, depth = 0, color = -1, interlace = 0, pal_len = 0, has_trns = 0, first = 1;
+   unsigned key[3] = {0, 0, 0};
+   int channels, bpp, out_n, pass, passes;
+
+   s->p += 8;
+   for (;;) {
+      unsigned len = stbi__get32be(s), type = stbi__get32be(s);
+      if (len > (unsigned)stbi__remaining(s)) {
+         free(idat);
+         return stbi__errpuc("truncated PNG");
+      }
+      if (first && type != 0x49484452u) {   /* IHDR */
+         free(idat);
+         return stbi__errpuc("first chunk not IHDR");
+      }
+      first = 0;
+      if (type == 0x49484452u) {
+         if (len != 13) return stbi__errpuc("bad IHDR");
+         w = (int)stbi__get32be(s);
+         h = (int)stbi__get32be(s);
+         depth = stbi__get8(s);
+         color = stbi__get8(s);
+         if (stbi__get8(s) != 0 || stbi__get8(s) != 0) return stbi__errpuc("bad IHDR");
+         interlace = stbi__get8(s);
+         if (!stbi__dimensions_ok(w, h) || interlace > 1) return stbi__errpuc("bad IHDR");
+         if (!(((color == 0) && (depth == 1 || depth == 2 || depth == 4 || depth == 8 || depth == 16)) ||
+               ((color == 3) && (depth == 1 || depth == 2 || depth == 4 || depth == 8)) ||
+               ((color == 2 || color == 4 || color == 6) && (depth == 8 || depth == 16))))
+            return stbi__errpuc("bad IHDR");
+      } else if (type == 0x504c5445u) {   /* PLTE */
+         unsigned i;
+         if (len % 3 || len > 256 * 3) {
+            free(idat);
+            return stbi__errpuc("bad PLTE");
+         }
+         pal_len = (int)(len / 3);
+         for (i = 0; i < (unsigned)pal_len; ++i) {
+            palette[i * 4 + 0] = (stbi_uc)stbi__get8(s);
+            palette[i * 4 + 1] = (stbi_uc)stbi__get8(s);
+            palette[i * 4 + 2] = (stbi_uc)stbi__get8(s);
+            palette[i * 4 + 3] = 255;
+         }
+      } else if (type == 0x74524e53u) {   /* tRNS */
+         unsigned i;
+         if (color == 3) {
+            for (i = 0; i < len; ++i) {
+               int alpha = stbi__get8(s);
+               if ((int)i < pal_len) palette[i * 4 + 3] = (stbi_uc)alpha;
+            }
+            has_trns = 1;
+         } else if ((color == 0 && len == 2) || (color == 2 && len == 6)) {
+            for (i = 0; i < len / 2; ++i) key[i] = (unsigned)stbi__get16be(s);
+            has_trns = 1;
+         } else {
+            stbi__skip(s, (long)len);
+         }
+      } else if (type == 0x49444154u) {   /* IDAT */
+         stbi_uc *grown = (stbi_uc *)realloc(idat, idat_len + len + 1);
+         if (!grown) {
+            free(idat);
+            return stbi__errpuc("outofmem");
+         }
+         idat = grown;
+         memcpy(idat + idat_len, s->p, len);
+         idat_len += len;
+         s->p += len;
+      } else if (type == 0x49454e44u) {   /* IEND */
+         break;
+      } else {
+         stbi__skip(s, (long)len);
+      }
+      stbi__skip(s, 4);   /* CRC */
+      if (stbi__remaining(s) < 8) break;
+   }
+   if (!idat) return stbi__errpuc("no IDAT");
+   if (color == 3 && pal_len == 0) {
+      free(idat);
+      return stbi__errpuc("no palette");
+   }
+
+   channels = color == 0 || color == 3 ? 1 : color == 4 ? 2 : color == 2 ? 3 : 4;
+   bpp = channels * depth;
+   out_n = color == 3 ? (has_trns ? 4 : 3) : channels + (has_trns ? 1 : 0);
+   passes = interlace ? 7 : 1;
+   for (pass = 0; pass < passes; ++pass) {
+      int pw = interlace ? (w - xorig[pass] + xspc[pass] - 1) / xspc[pass] : w;
+      int ph = interlace ? (h - yorig[pass] + yspc[pass] - 1) / yspc[pass] : h;
+      if (pw > 0 && ph > 0) need += ((size_t)pw * (size_t)bpp + 7) / 8 * (size_t)ph + (size_t)ph;
+   }
+   raw = stbi__zlib_decode(idat, idat_len, need, &raw_len);
+   free(idat);
+   if (!raw) return NULL;
+   if (raw_len < need) {
+      free(raw);
+      return stbi__errpuc("not enough pixels");
+   }
+   out = (stbi_uc *)stbi__malloc_mad3(w, h, out_n, 0);
+   lines = (stbi_uc *)malloc(2 * (((size_t)w * (size_t)bpp + 7) / 8 + 1));
+   if (!out || !lines) {
+      free(raw);
+      free(out);
+      free(lines);
+      return stbi__errpuc("outofmem");
+   }
+
+   for (pass = 0; pass < passes; ++pass) {
+      int x0 = interlace ? xorig[pass] : 0, y0 = interlace ? yorig[pass] : 0;
+      int dx = interlace ? xspc[pass] : 1, dy = interlace ? yspc[pass] : 1;
+      int pw = (w - x0 + dx - 1) / dx, ph = (h - y0 + dy - 1) / dy;
+      size_t stride;
+      int fbpp = (bpp + 7) / 8, row;
+      stbi_uc *prev = lines, *cur;
+      if (pw <= 0 || ph <= 0) continue;
+      stride = ((size_t)pw * (size_t)bpp + 7) / 8;
+      cur = lines + stride;
+      memset(prev, 0, stride);
+      for (row = 0; row < ph; ++row) {
+         int filter = raw[pos++], px, c;
+         size_t i;
+         stbi_uc *tmp;
+         if (filter > 4) {
+            free(raw);
+            free(out);
+            free(lines);
+            return stbi__errpuc("bad filter");
+         }
+         for (i = 0; i < stride; ++i) {
+            int a = i >= (size_t)fbpp ? cur[i - fbpp] : 0, b = prev[i], cc = i >= (size_t)fbpp ? prev[i - fbpp] : 0;
+            int v = raw[pos + i];
+            switch (filter) {
+            case 1: v += a; break;
+            case 2: v += b; break;
+            case 3: v += (a + b) >> 1; break;
+            case 4: v += stbi__paeth(a, b, cc); break;
+            default: break;
+            }
+            cur[i] = (stbi_uc)v;
+         }
+         pos += stride;
+         for (px = 0; px < pw; ++px) {
+            stbi_uc *dst = out + ((size_t)(y0 + row * dy) * (size_t)w + (size_t)(x0 + px * dx)) * (size_t)out_n;
+            if (color == 3) {
+               unsigned idx = stbi__png_sample(cur, px, depth);
+               const stbi_uc *p = palette + 4 * (idx < (unsigned)pal_len ? idx : 0);
+               dst[0] = p[0];
+               dst[1] = p[1];
+               dst[2] = p[2];
+               if (out_n == 4) dst[3] = p[3];
+            } else {
+               int matches = has_trns;
+               for (c = 0; c < channels; ++c) {
+                  unsigned v = stbi__png_sample(cur, px * channels + c, depth);
+                  if (has_trns && v != key[c]) matches = 0;
+                  dst[c] = (stbi_uc)(depth == 16 ? v >> 8 : depth == 8 ? v : v * (255 / ((1u << depth) - 1)));
+               }
+               if (has_trns) dst[channels] = matches ? 0 : 255;
+            }
+         }
+         tmp = prev;
+         prev = cur;
+         cur = tmp;
+      }
+   }
+   free(raw);
+   free(lines);
+   *x = w;
+   *y = h;
+   *comp = out_n;
+   return out;
+}
+
+#endif /* STBI_NO_PNG */
+
+/* ---------------------------------------------------------------------------
+   GIF (first frame)
+   ------------------------------------------------------------------------- */
+#ifndef STBI_NO_GIF
+
+static int stbi__gif_test(stbi__context *s)
+{
+   return stbi__remaining(s) >= 6 && (memcmp(s->p, "GIF87a", 6) == 0 || memcmp(s->p, "GIF89a", 6) == 0);
+}
+
+static void stbi__gif_palette(stbi__context *s, stbi_uc *pal, int n)
+{
+   int i;
+   for (i = 0; i < n; ++i) {
+      pal[i * 3 + 0] = (stbi_uc)stbi__get8(s);
+      pal[i * 3 + 1] = (stbi_uc)stbi__get8(s);
+      pal[i * 3 + 2] = (stbi_uc)stbi__get8(s);
+   }
+}
+
+/* Decode LZW codes into colour indices; returns the number written */
+static int stbi__gif_lzw(const stbi_uc *data, size_t len, int min_size, stbi_uc *out, int n)
+{
+   short prefix[4096];
+   stbi_uc suffix[4096], first[4096], stack[4097];
+   int clear = 1 << min_size, size = min_size + 1, next = clear + 2, old = -1, written = 0, bits = 0, i;
+   unsigned buf = 0;
+   size_t pos = 0;
+   for (i = 0; i < clear; ++i) {
+      prefix[i] = -1;
+      suffix[i] = first[i] = (stbi_uc)i;
+   }
+   while (written < n) {
+      int code, in, sp = 0;
+      while (bits < size) {
+         if (pos >= len) return written;
+         buf |= (unsigned)data[pos++] << bits;
+         bits += 8;
+      }
+      code = (int)(buf & ((1u << size) - 1));
+      buf >>= size;
+      bits -= size;
+      if (code == clear) {
+         size = min_size + 1;
+         next = clear + 2;
+         old = -1;
+         continue;
+      }
+      if (code == clear + 1) break;
+      if (old < 0) {
+         if (code >= clear) return written;
+         out[written++] = (stbi_uc)code;
+         old = code;
+         continue;
+      }
+      if (code > next || (code == next && next >= 4096)) return written;
+      in = code;
+      if (code == next) {   /* KwKwK: the previous string plus its own first byte */
+         stack[sp++] = first[old];
+         code = old;
+      }
+      while (code >= clear) {
+         stack[sp++] = suffix[code];
+         code = prefix[code];
+      }
+      stack[sp++] = (stbi_uc)code;
+      if (next < 4096) {
+         prefix[next] = (short)old;
+         suffix[next] = (stbi_uc)code;   /* first byte of the string just emitted */
+         first[next] = first[old];
+         if (++next == (1 << size) && size < 12) ++size;
+      }
+      while (sp > 0 && written < n) out[written++] = stack[--sp];
+      old = in;
+   }
+   return written;
+}
+
+static stbi_uc *stbi__gif_load(stbi__context *s, int *x, int *y, int *comp)
+{
+   stbi_uc global[256 * 3], local[256 * 3];
+   int w, h, flags, global_n = 0, transparent = -1;
+   stbi_uc *out;
+
+   s->p += 6;
+   w = stbi__get16le(s);
+   h = stbi__get16le(s);
+   flags = stbi__get8(s);
+   stbi__skip(s, 2);   /* background, aspect */
+   if (!stbi__dimensions_ok(w, h)) return stbi__errpuc("bad dimensions");
+   if (flags & 0x80) {
+      global_n = 2 << (flags & 7);
+      stbi__gif_palette(s, global, global_n);
+   }
+   for (;;) {
+      int tag = stbi__get8(s);
+      if (tag == 0x21) {
+         int label = stbi__get8(s), len;
+         if (label == 0xf9) {
+            len = stbi__get8(s);
+            if (len >= 4) {
+               int packed = stbi__get8(s);
+               stbi__skip(s, 2);
+               transparent = (packed & 1) ? stbi__get8(s) : (stbi__get8(s), -1);
+               stbi__skip(s, len - 4);
+            } else {
+               stbi__skip(s, len);
+            }
+         }
+         while ((len = stbi__get8(s)) > 0) stbi__skip(s, len);
+      } else if (tag == 0x2c) {
+         int fx = stbi__get16le(s), fy = stbi__get16le(s), fw = stbi__get16le(s), fh = stbi__get16le(s);
+         int fflags = stbi__get8(s), min_size, len, got, row, col;
+         const stbi_uc *pal = global;
+         int pal_n = global_n;
+         stbi_uc *data = NULL, *idx;
+         size_t data_len = 0;
+         if (fflags & 0x80) {
+            pal_n = 2 << (fflags & 7);
+            stbi__gif_palette(s, local, pal_n);
+            pal = local;
+         }
+         if (!pal_n) return stbi__errpuc("no palette");
+         min_size = stbi__get8(s);
+         if (min_size < 1 || min_size > 11) return stbi__errpuc("bad LZW code size");
+         while ((len = stbi__get8(s)) > 0) {
+            stbi_uc *grown = (stbi_uc *)realloc(data, data_len + (size_t)len);
+            if (!grown) {
+               free(data);
+               return stbi__errpuc("outofmem");
+            }
+            data = grown;
+            if (len > stbi__remaining(s)) len = stbi__remaining(s);
+            memcpy(data + data_len, s->p, (size_t)len);
+            data_len += (size_t)len;
+            s->p += len;
+         }
+         out = (stbi_uc *)stbi__malloc_mad3(w, h, 4, 0);
+         idx = (stbi_uc *)stbi__malloc_mad3(fw, fh, 1, 1);
+         if (!out || !idx) {
+            free(data);
+            free(out);
+            free(idx);
+            return stbi__errpuc("outofmem");
+         }
+         memset(out, 0, (size_t)w * (size_t)h * 4);
+         got = stbi__gif_lzw(data ? data : idx, data_len, min_size, idx, fw * fh);
+         free(data);
+         for (row = 0; row < fh; ++row) {
+            /* interlaced frames store rows 0, 8, ..., then 4, 12, ..., then 2, 6, ..., then 1, 3, ... */
+            int dst_row = row;
+            if (fflags & 0x40) {
+               int n0 = (fh + 7) / 8, n1 = (fh + 3) / 8, n2 = (fh + 1) / 4;
+               if (row < n0)
+                  dst_row = row * 8;
+               else if (row < n0 + n1)
+                  dst_row = (row - n0) * 8 + 4;
+               else if (row < n0 + n1 + n2)
+                  dst_row = (row - n0 - n1) * 4 + 2;
+               else
+                  dst_row = (row - n0 - n1 - n2) * 2 + 1;
+            }
+            if (fy + dst_row >= h) continue;
+            for (col = 0; col < fw && fx + col < w; ++col) {
+               int i = row * fw + col, c;
+               stbi_uc *dst;
+               if (i >= got) break;
+               c = idx[i];
+               if (c == transparent || c >= pal_n) continue;
+               dst = out + ((size_t)(fy + dst_row) * (size_t)w + (size_t)(fx + col)) * 4;
+               dst[0] = pal[c * 3 + 0];
+               dst[1] = pal[c * 3 + 1];
+               dst[2] = pal[c * 3 + 2];
+               dst[3] = 255;
+            }
+         }
+         free(idx);
+         *x = w;
+         *y = h;
+         *comp = 4;
+         return out;
+      } else {
+         return stbi__errpuc(tag == 0x3b ? "no frames" : "corrupt GIF");
+      }
+   }
+}
+
+#endif /* STBI_NO_GIF */
+
+/* ---------------------------------------------------------------------------
+   BMP
+   ------------------------------------------------------------------------- */
+#ifndef STBI_NO_BMP
+
+static int stbi__bmp_test(stbi__context *s)
+{
+   unsigned hsz;
+   if (stbi__remaining(s) < 18 || s->p[0] != 'B' || s->p[1] != 'M') return 0;
+   hsz = s->p[14] | ((unsigned)s->p[15] << 8) | ((unsigned)s->p[16] << 16) | ((unsigned)s->p[17] << 24);
+   return hsz == 12 || hsz == 40 || hsz == 52 || hsz == 56 || hsz == 108 || hsz == 124;
+}
+
+static int stbi__bmp_shift(unsigned mask)
+{
+   int n = 0;
+   if (!mask) return 0;
+   while (!(mask & 1)) {
+      mask >>= 1;
+      ++n;
+   }
+   return n;
+}
+
+static int stbi__bmp_bitcount(unsigned mask)
+{
+   int n = 0;
+   for (; mask; mask &= mask - 1) ++n;
+   return n;
+}
+
+static int stbi__bmp_field(unsigned px, unsigned mask)
+{
+   int bits = stbi__bmp_bitcount(mask);
+   unsigned v;
+   if (!mask) return 0;
+   v = (px & mask) >> stbi__bmp_shift(mask);
+   if (bits >= 8) return (int)(v >> (bits - 8));
+   return (int)(v * 255 / ((1u << bits) - 1));
+}
+
+static stbi_uc *stbi__bmp_load(stbi__context *s, int *x, int *y, int *comp)
+{
+   const stbi_uc *start = s->p;
+   stbi_uc palette[256 * 4];
+   unsigned offset, hsz, compression = 0, colors = 0, mr = 0, mg = 0, mb = 0, ma = 0;
+   int w, h, bpp, flip, stride, row, col, n, all_clear = 1;
+   stbi_uc *out;
+
+   stbi__skip(s, 10);
+   offset = stbi__get32le(s);
+   hsz = stbi__get32le(s);
+   if (hsz == 12) {
+      w = stbi__get16le(s);
+      h = (short)stbi__get16le(s);
+   } else {
+      w = (int)stbi__get32le(s);
+      h = (int)stbi__get32le(s);
+   }
+   if (stbi__get16le(s) != 1) return stbi__errpuc("bad BMP");
+   bpp = stbi__get16le(s);
+   if (hsz != 12) {
+      compression = stbi__get32le(s);
+      stbi__skip(s, 12);   /* image size, resolution */
+      colors = stbi__get32le(s);
+      stbi__skip(s, 4);
+      if (compression != 0 && compression != 3 && compression != 6) return stbi__errpuc("compressed BMP");
+      if (compression == 3 || compression == 6 || hsz >= 52) {
+         mr = stbi__get32le(s);
+         mg = stbi__get32le(s);
+         mb = stbi__get32le(s);
+         if (compression == 6 || hsz >= 56) ma = stbi__get32le(s);
+      }
+   }
+   flip = h > 0;   /* rows stored bottom-up */
+   if (h < 0) h = -h;
+   if (!stbi__dimensions_ok(w, h)) return stbi__errpuc("bad dimensions");
+   if (bpp != 1 && bpp != 4 && bpp != 8 && bpp != 16 && bpp != 24 && bpp != 32) return stbi__errpuc("bad BMP depth");
+   if (compression == 0 || (hsz >= 52 && !(mr | mg | mb))) {
+      if (bpp == 16) {
+         mr = 0x7c00;
+         mg = 0x03e0;
+         mb = 0x001f;
+         ma = 0;
+      } else if (bpp == 32) {
+         mr = 0xff0000;
+         mg = 0xff00;
+         mb = 0xff;
+         ma = 0xff000000u;
+      }
+   }
+   if (bpp <= 8) {
+      int entry = hsz == 12 ? 3 : 4, i;
+      unsigned max = 1u << bpp;
+      if (!colors || colors > max) colors = max;
+      s->p = start + 14 + hsz + ((hsz == 40 && (compression == 3 || compression == 6)) ? (compression == 6 ? 16 : 12) : 0);
+      if (s->p > s->end) s->p = s->end;
+      memset(palette, 0, sizeof(palette));
+      for (i = 0; i < (int)colors; ++i) {
+         palette[i * 4 + 2] = (stbi_uc)stbi__get8(s);
+         palette[i * 4 + 1] = (stbi_uc)stbi__get8(s);
+         palette[i * 4 + 0] = (stbi_uc)stbi__get8(s);
+         if (entry == 4) stbi__get8(s);
+      }
+   }
+   n = ma ? 4 : 3;
+   if (offset > (unsigned)(s->end - start)) return stbi__errpuc("bad BMP offset");
+   s->p = start + offset;
+   if (!stbi__mad3_ok(w, bpp, 1, 31)) return stbi__errpuc("too large");
+   stride = ((w * bpp + 31) / 32) * 4;
+   if ((size_t)stride * (size_t)h > (size_t)(s->end - s->p)) return stbi__errpuc("truncated BMP");
+   out = (stbi_uc *)stbi__malloc_mad3(w, h, n, 0);
+   if (!out) return stbi__errpuc("outofmem");
+   for (row = 0; row < h; ++row) {
+      const stbi_uc *src = s->p + (size_t)row * (size_t)stride;
+      stbi_uc *dst = out + (size_t)(flip ? h - 1 - row : row) * (size_t)w * (size_t)n;
+      stbi__context line;
+      line.p = src < s->end ? src : s->end;
+      line.end = s->end;
+      for (col = 0; col < w; ++col, dst += n) {
+         if (bpp <= 8) {
+            int bit = col * bpp, c;
+            int byte = line.p + (bit >> 3) < line.end ? line.p[bit >> 3] : 0;
+            c = (byte >> (8 - bpp - (bit & 7))) & ((1 << bpp) - 1);
+            dst[0] = palette[c * 4 + 0];
+            dst[1] = palette[c * 4 + 1];
+            dst[2] = palette[c * 4 + 2];
+            if (n == 4) dst[3] = 255;
+         } else if (bpp == 24) {
+            dst[2] = (stbi_uc)stbi__get8(&line);
+            dst[1] = (stbi_uc)stbi__get8(&line);
+            dst[0] = (stbi_uc)stbi__get8(&line);
+            if (n == 4) dst[3] = 255;
+         } else {
+            unsigned px = bpp == 16 ? (unsigned)stbi__get16le(&line) : stbi__get32le(&line);
+            dst[0] = (stbi_uc)stbi__bmp_field(px, mr);
+            dst[1] = (stbi_uc)stbi__bmp_field(px, mg);
+            dst[2] = (stbi_uc)stbi__bmp_field(px, mb);
+            if (n == 4) {
+               dst[3] = (stbi_uc)stbi__bmp_field(px, ma);
+               if (dst[3]) all_clear = 0;
+            }
+         }
+      }
+   }
+   if (n == 4 && all_clear) {   /* an unused alpha byte: opaque */
+      size_t i, total = (size_t)w * (size_t)h;
+      for (i = 0; i < total; ++i) out[i * 4 + 3] = 255;
+   }
+   *x = w;
+   *y = h;
+   *comp = n;
+   return out;
+}
+
+#endif /* STBI_NO_BMP */
+
+/* ---------------------------------------------------------------------------
+   Entry points
+   ------------------------------------------------------------------------- */
+
+STBIDEF stbi_uc *stbi_load_from_memory(const stbi_uc *buffer, int len, int *x, int *y, int *channels_in_file,
+                                       int desired_channels)
+{
+   stbi__context s;
+   stbi_uc *result = NULL;
+   int w = 0, h = 0, n = 0, converted = 0;
+   if (!buffer || len <= 0 || !x || !y) return stbi__errpuc("bad arguments");
+   if (desired_channels < 0 || desired_channels > 4) return stbi__errpuc("bad desired_channels");
+   s.p = buffer;
+   s.end = buffer + len;
+   stbi__g_failure_reason = NULL;
+#ifndef STBI_NO_JPEG
+   if (stbi__jpeg_test(&s)) {
+      /* converts to desired_channels itself */
+      result = stbi__jpeg_load(&s, &w, &h, &n, desired_channels);
+      if (result) converted = 1;
+   } else
+#endif
+#ifndef STBI_NO_PNG
+   if (stbi__png_test(&s)) result = stbi__png_load(&s, &w, &h, &n);
+   else
+#endif
+#ifndef STBI_NO_GIF
+   if (stbi__gif_test(&s)) result = stbi__gif_load(&s, &w, &h, &n);
+   else
+#endif
+#ifndef STBI_NO_BMP
+   if (stbi__bmp_test(&s)) result = stbi__bmp_load(&s, &w, &h, &n);
+   else
+#endif
+      stbi__err("unknown image type");
+   if (!result) return NULL;
+   if (desired_channels && desired_channels != n && !converted) {
+      result = stbi__convert_format(result, n, desired_channels, w, h);
+      if (!result) return NULL;
+   }
+   *x = w;
+   *y = h;
+   if (channels_in_file) *channels_in_file = n;
+   return result;
+}
+
+#endif /* STB_IMAGE_IMPLEMENTATION */
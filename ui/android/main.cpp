@@ -14,12 +14,15 @@
 #include "../common/strings.h"
 #include "../common/constants.h"
 #include "../../lib/config.h"
+#include "../../lib/shared_services.h"
 
 int main(int argc, char* argv[]) {
     QGuiApplication app(argc, argv);
     app.setApplicationName(ui_strings::kAppName);
     app.setOrganizationName("andymccall");
     app.setApplicationDisplayName(ui_strings::kAppName);
+    // OMDb cache, poster cache and title index, shared with the other front ends using this database
+    for (const std::string& error : initSharedServices()) qWarning("%s", error.c_str());
 
     QQmlApplicationEngine engine;
 
@@ -44,6 +47,7 @@ int main(int argc, char* argv[]) {
     engine.rootContext()->setContextProperty("UiStrings_SortAlpha", QString::fromUtf8(ui_strings::kSortAlpha));
     engine.rootContext()->setContextProperty("UiStrings_SortByRank", QString::fromUtf8(ui_strings::kSortByRank));
     engine.rootContext()->setContextProperty("UiStrings_SortByScore", QString::fromUtf8(ui_strings::kSortByScore));
+    engine.rootContext()->setContextProperty("UiStrings_SortComposite", QString::fromUtf8(ui_strings::kSortComposite));
 
     // Layout constants
     engine.rootContext()->setContextProperty("Ui_InitWidth", ui_constants::kInitialWidth);
@@ -67,7 +67,7 @@ ApplicationWindow {
                     Layout.margins: 6; spacing: 8
                     ComboBox {
                         id: sortCombo
-                        model: [UiStrings_SortInsertion, UiStrings_SortByYear, UiStrings_SortAlpha, UiStrings_SortByRank, UiStrings_SortByScore]
+                        model: [UiStrings_SortInsertion, UiStrings_SortByYear, UiStrings_SortAlpha, UiStrings_SortByRank, UiStrings_SortByScore, UiStrings_SortComposite]
                         Layout.fillWidth: true
                         Component.onCompleted: currentIndex = top100Model.sortOrder
                         onCurrentIndexChanged: top100Model.setSortOrder(currentIndex)
@@ -198,34 +198,51 @@ ApplicationWindow {
         title: qsTr("Add Movie (OMDb)")
         property var results: []
         property var selected: null
-        property bool searching: false
+        property string selectedImdb: ""
+        property bool selectFirst: false   // Go / Enter picks the first hit; typing never does
+        property bool refreshing: false    // results being rebuilt, not a pick
+        property bool hasMore: false
         property string statusMsg: ""
+        function showResult(row) {
+            if (row>=0 && addDialog.results && addDialog.results.length>row) {
+                var imdb = addDialog.results[row].imdbID
+                if (imdb===addDialog.selectedImdb && addDialog.selected) return
+                addDialog.selectedImdb = imdb; addDialog.selected = null
+                top100Model.fetchOmdbByIdAsync(imdb)
+            } else { addDialog.selectedImdb = ""; addDialog.selected = null }
+        }
+        // Shared debounced, cancellable search engine; details load in the background
+        Connections { target: top100Model; enabled: addDialog.visible
+            function onOmdbSearchFinished(results) {
+                var list = results || []
+                var row = -1
+                for (var i=0; i<list.length; ++i) if (list[i].imdbID===addDialog.selectedImdb) { row = i; break }
+                if (row<0 && addDialog.selectFirst && list.length>0) row = 0
+                addDialog.selectFirst = false
+                addDialog.hasMore = top100Model.omdbSearchHasMore()
+                addDialog.statusMsg = (list.length===0 && searchField.text.trim().length>0) ? qsTr("No results") : ""
+                addDialog.refreshing = true; addDialog.results = list; resultsView.currentIndex = row; addDialog.refreshing = false
+                addDialog.showResult(row)
+            }
+            function onOmdbGetFinished(movie) { if (movie && movie.imdbID===addDialog.selectedImdb) addDialog.selected = movie }
+        }
         contentItem: ColumnLayout { spacing: 6; anchors.fill: parent
             RowLayout { spacing:6; Layout.margins:6
-                TextField { id: searchField; Layout.fillWidth: true; placeholderText: qsTr("title keyword"); enabled: !addDialog.searching; onAccepted: searchBtn.clicked() }
-                Button { id: searchBtn; text: qsTr("Go"); enabled: !addDialog.searching; onClicked: {
+                TextField { id: searchField; Layout.fillWidth: true; placeholderText: qsTr("title keyword"); onTextEdited: top100Model.setSearchText(text); onAccepted: searchBtn.clicked() }
+                Button { id: searchBtn; text: qsTr("Go"); onClicked: {
                         var q = searchField.text; if (!q || q.trim().length===0) return
-                        addDialog.searching = true; addDialog.statusMsg = qsTr("Searching…")
-                        Qt.callLater(function(){
-                            var list = top100Model.searchOmdb(q)
-                            addDialog.searching = false
-                            if (!list || list.length===0) { addDialog.results = []; addDialog.selected=null; addDialog.statusMsg = qsTr("No results"); return }
-                            addDialog.results = list; addDialog.statusMsg = "";
-                            // Auto-select first
-                            resultsView.currentIndex = 0
-                            var imdb = addDialog.results[0].imdbID
-                            addDialog.selected = top100Model.omdbGetByIdMap(imdb)
-                        })
+                        addDialog.selectFirst = true
+                        top100Model.searchOmdbAsync(q)
                     } }
             }
             Label { text: addDialog.statusMsg; visible: addDialog.statusMsg.length>0; color: "#c33"; padding:4 }
             SplitView { Layout.fillWidth: true; Layout.fillHeight: true; orientation: Qt.Horizontal
-                ListView { id: resultsView; model: addDialog.results; SplitView.preferredWidth: parent.width*0.45
-                    delegate: ItemDelegate { width: parent.width; text: modelData.title + " ("+modelData.year+")"; onClicked: resultsView.currentIndex = index }
-                    onCurrentIndexChanged: if (currentIndex>=0 && addDialog.results && addDialog.results.length>currentIndex) {
-                        var imdb = addDialog.results[currentIndex].imdbID
-                        addDialog.selected = top100Model.omdbGetByIdMap(imdb)
+                ColumnLayout { SplitView.preferredWidth: parent.width*0.45; spacing:4
+                    ListView { id: resultsView; model: addDialog.results; clip: true; Layout.fillWidth: true; Layout.fillHeight: true
+                        delegate: ItemDelegate { width: parent.width; text: modelData.title + " ("+modelData.year+")"; onClicked: resultsView.currentIndex = index }
+                        onCurrentIndexChanged: if (!addDialog.refreshing) addDialog.showResult(currentIndex)
                     }
+                    Button { Layout.fillWidth: true; text: qsTr("More results"); visible: addDialog.hasMore; onClicked: top100Model.loadMoreOmdbResults() }
                 }
                 Flickable { SplitView.preferredWidth: parent.width*0.55; contentWidth: width; contentHeight: previewCol.implicitHeight
                     ColumnLayout { id: previewCol; width: parent.width; spacing:6
@@ -13,7 +13,7 @@
 /*! \file ui/common/Top100ListModel.h
     \brief Shared QAbstractListModel exposing movies to both Qt and KDE UIs.
     
-    Roles: title, year, rank, posterUrl, plotFull, imdbID; also supports
+    Roles: title, year, rank (+ rankLow/rankHigh), posterUrl, plotFull, imdbID; also supports
     Qt::DisplayRole for convenience. Provides reload(), get(row) for QML
     details binding, OMDb-assisted add, delete by IMDb ID, and async posting.
 */
@@ -24,21 +24,23 @@
 #include <QByteArray>
 #include <vector>
 #include <string>
+#include <list>
+#include <memory>
+#include <random>
+#include <numeric>
 #include <QString>
 #include <QVariantMap>
-#include <QFutureWatcher>
+#include <QCoreApplication>
+#include <QMetaObject>
+#include <QPointer>
 #include <QDebug>
-#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
-#include <QtConcurrent>
-#else
-#include <QtConcurrent/QtConcurrentRun>
-#endif
 
 #include "../../lib/Movie.h"
 #include "../../lib/top100.h"
 #include "../../lib/config.h"
 #include "../../lib/posting.h"
 #include "../../lib/omdb.h"
+#include "../../lib/incremental_search.h"
 #include "../../lib/image_export.h"
 
 /**
@@ -51,7 +53,7 @@ public:
     /*! \property Top100ListModel::sortOrder
         \brief Current sort order as an int mapping to the SortOrder enum.
 
-        Values correspond to SortOrder::{DEFAULT,BY_YEAR,ALPHABETICAL,BY_USER_RANK,BY_USER_SCORE}.
+        Values correspond to SortOrder::{DEFAULT,BY_YEAR,ALPHABETICAL,BY_USER_RANK,BY_USER_SCORE,COMPOSITE}.
         Setting this persists to the config and triggers a reload().
     */
     /** Model data roles available to views and QML. */
@@ -65,7 +67,9 @@ public:
         DirectorRole,
         ActorsRole,
         GenresRole,
-        RuntimeMinutesRole
+        RuntimeMinutesRole,
+        RankLowRole,
+        RankHighRole
     };
     Q_ENUM(Roles)
 
@@ -86,6 +90,14 @@ public:
         reload();
     }
 
+    /** @brief Cancel outstanding network requests; their results are dropped. */
+    ~Top100ListModel() override {
+        search_.reset();
+        getCancel_.cancel();
+        for (CancelSource& add : addCancels_) add.cancel();
+        postCancel_.cancel();
+    }
+
     /**
      * @brief Number of rows in the model.
      * @param parent Unused; returns 0 for non-root indices
@@ -108,7 +120,7 @@ public:
         const auto& m = movies_[index.row()];
         switch (role) {
             case Qt::DisplayRole: {
-                QString prefix = (m.userRank > 0) ? QString("#%1 ").arg(m.userRank) : QString();
+                QString prefix = QString::fromStdString(rankLabel(m));
                 return prefix + QString::fromStdString(m.title) + QString(" (%1)").arg(m.year);
             }
             case TitleRole: return QString::fromStdString(m.title);
@@ -129,6 +141,8 @@ public:
                 return list;
             }
             case RuntimeMinutesRole: return m.runtimeMinutes;
+            case RankLowRole: return m.userRankLow;
+            case RankHighRole: return m.userRankHigh;
             default: return {};
         }
     }
@@ -149,6 +163,8 @@ public:
     r[ActorsRole] = "actors";
     r[GenresRole] = "genres";
     r[RuntimeMinutesRole] = "runtimeMinutes";
+    r[RankLowRole] = "rankLow";
+    r[RankHighRole] = "rankHigh";
         return r;
     }
 
@@ -159,11 +175,26 @@ public:
         try {
             AppConfig cfg = loadConfig();
             Top100 list(cfg.dataFile);
-            // Load using current sort order (defaults to insertion order)
-            auto movies = list.getMovies(currentOrder_);
+            list.estimateRankIntervals();
+            weights_ = makeCompositeWeights(cfg.sortWeightUserScore, cfg.sortWeightImdbRating,
+                                            cfg.sortWeightMetascore, cfg.sortWeightRottenTomatoes,
+                                            cfg.sortNormalisation);
+            // Load using current sort order (defaults to insertion order). The composite
+            // order is applied here from a column snapshot so re-weighting can re-sort
+            // without reloading.
+            const bool composite = currentOrder_ == SortOrder::COMPOSITE;
+            auto movies = list.getMovies(composite ? SortOrder::DEFAULT : currentOrder_);
             movies_.assign(movies.begin(), movies.end());
+            prefs_ = list.preferences();
+            if (composite) {
+                composite_.assign(movies_, weights_.normalisation);
+                baseOfRow_.resize(movies_.size());
+                std::iota(baseOfRow_.begin(), baseOfRow_.end(), 0u);
+                applyCompositeOrder();
+            }
         } catch (...) {
             movies_.clear();
+            prefs_.clear();
         }
         endResetModel();
         qInfo() << "Top100ListModel: loaded" << movies_.size() << "movies";
@@ -187,6 +218,7 @@ public:
             case static_cast<int>(SortOrder::ALPHABETICAL): newOrder = SortOrder::ALPHABETICAL; break;
             case static_cast<int>(SortOrder::BY_USER_RANK): newOrder = SortOrder::BY_USER_RANK; break;
             case static_cast<int>(SortOrder::BY_USER_SCORE): newOrder = SortOrder::BY_USER_SCORE; break;
+            case static_cast<int>(SortOrder::COMPOSITE): newOrder = SortOrder::COMPOSITE; break;
             default: newOrder = SortOrder::DEFAULT; break;
         }
         if (newOrder == currentOrder_) return;
@@ -201,10 +233,53 @@ public:
         reload();
     }
 
+    /**
+     * @brief Re-weight the composite sort order and re-sort rows in memory.
+     *
+     * Fast enough to call on every slider movement (no reload, no disk access).
+     * Pass persist = true when the user settles on a value to store the weights.
+     *
+     * @param user Weight of your Elo score
+     * @param imdb Weight of the IMDb rating
+     * @param meta Weight of the Metascore
+     * @param rt Weight of the Rotten Tomatoes score
+     * @param persist Also save the weights to the config
+     */
+    Q_INVOKABLE void setCompositeWeights(double user, double imdb, double meta, double rt, bool persist = false) {
+        weights_.userScore = user;
+        weights_.imdbRating = imdb;
+        weights_.metascore = meta;
+        weights_.rottenTomatoes = rt;
+        if (persist) {
+            try {
+                AppConfig cfg = loadConfig();
+                cfg.sortWeightUserScore = user;
+                cfg.sortWeightImdbRating = imdb;
+                cfg.sortWeightMetascore = meta;
+                cfg.sortWeightRottenTomatoes = rt;
+                saveConfig(cfg);
+            } catch (...) { /* ignore */ }
+        }
+        if (currentOrder_ != SortOrder::COMPOSITE) return;
+        beginResetModel();
+        applyCompositeOrder();
+        endResetModel();
+    }
+
+    /** @return Current composite weights as a map (userScore, imdbRating, metascore, rottenTomatoes). */
+    Q_INVOKABLE QVariantMap compositeWeights() const {
+        QVariantMap m;
+        m["userScore"] = weights_.userScore;
+        m["imdbRating"] = weights_.imdbRating;
+        m["metascore"] = weights_.metascore;
+        m["rottenTomatoes"] = weights_.rottenTomatoes;
+        return m;
+    }
+
     /**
      * @brief Convenience accessor for QML/details panes.
      * @param row Row index in the model (0..rowCount-1)
-     * @return Map with keys: title, year, rank, posterUrl, plotFull, imdbID, director, actors, genres, runtimeMinutes; empty if row invalid
+     * @return Map with keys: title, year, rank, rankLow, rankHigh, posterUrl, plotFull, imdbID, director, actors, genres, runtimeMinutes; empty if row invalid
      */
     Q_INVOKABLE QVariantMap get(int row) const {
         QVariantMap m;
@@ -213,6 +288,8 @@ public:
         m["title"] = QString::fromStdString(mv.title);
         m["year"] = mv.year;
         m["rank"] = mv.userRank;
+        m["rankLow"] = mv.userRankLow;
+        m["rankHigh"] = mv.userRankHigh;
         m["posterUrl"] = QString::fromStdString(mv.posterUrl);
         m["plotFull"] = QString::fromStdString(mv.plotFull.empty() ? mv.plotShort : mv.plotFull);
         m["imdbID"] = QString::fromStdString(mv.imdbID);
@@ -240,17 +317,10 @@ public:
         try {
             AppConfig cfg = loadConfig();
             if (!cfg.omdbEnabled || cfg.omdbApiKey.empty()) return false;
-            auto maybe = omdbGetById(cfg.omdbApiKey, imdbId.toStdString());
+            auto maybe = omdbGetById(cfg.omdbApiKey, imdbId.toStdString(), OmdbDetailOptions{cfg.omdbFetchShortPlot});
             if (!maybe) return false;
-            Movie mv = *maybe;
-            // Ensure it's appended at the end by direct add (insertion order)
-            Top100 list(cfg.dataFile);
-            list.addMovie(mv);
-            list.recomputeRanks();
-            // Force persistence by destructing list (save in destructor)
+            return storeMovie(*maybe);
         } catch (...) { return false; }
-        reload();
-        return true;
     }
 
     /**
@@ -295,14 +365,7 @@ public:
         try {
             AppConfig cfg = loadConfig();
             if (!cfg.omdbEnabled || cfg.omdbApiKey.empty()) return out;
-            auto results = omdbSearch(cfg.omdbApiKey, query.toStdString());
-            for (const auto& r : results) {
-                QVariantMap m;
-                m["title"] = QString::fromStdString(r.title);
-                m["year"] = r.year;
-                m["imdbID"] = QString::fromStdString(r.imdbID);
-                out.push_back(m);
-            }
+            out = searchResultsToVariant(omdbSearch(cfg.omdbApiKey, query.toStdString()));
         } catch (...) {
             // ignore, return empty
         }
@@ -319,14 +382,8 @@ public:
         try {
             AppConfig cfg = loadConfig();
             if (!cfg.omdbEnabled || cfg.omdbApiKey.empty()) return m;
-            auto maybe = omdbGetById(cfg.omdbApiKey, imdbId.toStdString());
-            if (!maybe) return m;
-            const Movie& mv = *maybe;
-            m["title"] = QString::fromStdString(mv.title);
-            m["year"] = mv.year;
-            m["posterUrl"] = QString::fromStdString(mv.posterUrl);
-            m["plotShort"] = QString::fromStdString(mv.plotShort);
-            m["plotFull"] = QString::fromStdString(mv.plotFull);
+            auto maybe = omdbGetById(cfg.omdbApiKey, imdbId.toStdString(), OmdbDetailOptions{cfg.omdbFetchShortPlot});
+            if (maybe) m = detailToVariant(*maybe);
         } catch (...) {
             // ignore
         }
@@ -362,7 +419,9 @@ public:
         try {
             AppConfig cfg = loadConfig();
             if (!cfg.omdbEnabled || cfg.omdbApiKey.empty()) return false;
-            auto maybe = omdbGetById(cfg.omdbApiKey, imdbId.toStdString());
+            OmdbDetailOptions opts{cfg.omdbFetchShortPlot};
+            opts.revalidate = true;
+            auto maybe = omdbGetById(cfg.omdbApiKey, imdbId.toStdString(), opts);
             if (!maybe) return false;
             Top100 list(cfg.dataFile);
             bool ok = list.mergeFromOmdbByImdbId(*maybe);
@@ -398,6 +457,19 @@ public:
      */
     Q_INVOKABLE bool recordPairwiseResult(int leftRow, int rightRow, int winner);
 
+    /**
+     * @brief Choose the next pair of rows to rank.
+     * @return [leftRow, rightRow], or an empty list when every remaining pair is
+     *         already implied by earlier answers (A beats B, B beats C ⇒ A beats C)
+     */
+    Q_INVOKABLE QVariantList nextRankPair() {
+        QVariantList out;
+        if (auto pair = pickComparisonPair(movies_, prefs_, rng_)) {
+            out << static_cast<int>(pair->first) << static_cast<int>(pair->second);
+        }
+        return out;
+    }
+
     /**
      * @brief Post a movie to BlueSky synchronously.
      * @param row Model row index of the movie
@@ -442,15 +514,7 @@ public:
         AppConfig cfg;
         try { cfg = loadConfig(); } catch (...) { emit postingFinished("BlueSky", row, false); return; }
         if (!cfg.blueSkyEnabled || cfg.blueSkyIdentifier.empty() || cfg.blueSkyAppPassword.empty()) { emit postingFinished("BlueSky", row, false); return; }
-        Movie mv = movies_[row];
-        auto future = QtConcurrent::run([cfg, mv]() { return postMovieToBlueSky(cfg, mv); });
-        auto *watcher = new QFutureWatcher<bool>(this);
-        connect(watcher, &QFutureWatcher<bool>::finished, this, [this, watcher, row]() {
-            bool ok = watcher->result();
-            emit postingFinished("BlueSky", row, ok);
-            watcher->deleteLater();
-        });
-        watcher->setFuture(future);
+        reportPosting(QStringLiteral("BlueSky"), row, postMovieToBlueSkyAsync(cfg, movies_[row], postCancel_.token()));
     }
 
     /**
@@ -463,15 +527,7 @@ public:
         AppConfig cfg;
         try { cfg = loadConfig(); } catch (...) { emit postingFinished("Mastodon", row, false); return; }
         if (!cfg.mastodonEnabled || cfg.mastodonInstance.empty() || cfg.mastodonAccessToken.empty()) { emit postingFinished("Mastodon", row, false); return; }
-        Movie mv = movies_[row];
-        auto future = QtConcurrent::run([cfg, mv]() { return postMovieToMastodon(cfg, mv); });
-        auto *watcher = new QFutureWatcher<bool>(this);
-        connect(watcher, &QFutureWatcher<bool>::finished, this, [this, watcher, row]() {
-            bool ok = watcher->result();
-            emit postingFinished("Mastodon", row, ok);
-            watcher->deleteLater();
-        });
-        watcher->setFuture(future);
+        reportPosting(QStringLiteral("Mastodon"), row, postMovieToMastodonAsync(cfg, movies_[row], postCancel_.token()));
     }
 
 signals:
@@ -491,63 +547,197 @@ signals:
     void addMovieFinished(const QString& imdbId, bool success);
 
 private:
+    // Reorder movies_ by the composite score; rows are moved, not copied.
+    void applyCompositeOrder() {
+        std::vector<uint32_t> order;
+        composite_.order(weights_, order);
+        if (order.size() != movies_.size()) return;
+        std::vector<uint32_t> rowOf(order.size());
+        for (size_t row = 0; row < baseOfRow_.size(); ++row) rowOf[baseOfRow_[row]] = static_cast<uint32_t>(row);
+        std::vector<Movie> next;
+        next.reserve(movies_.size());
+        for (uint32_t base : order) next.push_back(std::move(movies_[rowOf[base]]));
+        movies_.swap(next);
+        baseOfRow_.swap(order);
+    }
+
     std::vector<Movie> movies_;
+    PreferenceGraph prefs_;
+    CompositeWeights weights_;
+    CompositeIndex composite_;           // column snapshot in insertion order (composite sort only)
+    std::vector<uint32_t> baseOfRow_;    // row -> snapshot index (composite sort only)
+    std::mt19937 rng_ { std::random_device{}() };
     SortOrder currentOrder_ = SortOrder::DEFAULT;
-    // Async watchers (owned by model)
-    QFutureWatcher<QVariantList>* searchWatcher_ { nullptr };
-    QFutureWatcher<QVariantMap>* getWatcher_ { nullptr };
-    QFutureWatcher<bool>* addWatcher_ { nullptr };
+    // Cancellation for in-flight requests; a new get supersedes the previous one,
+    // adds all run to completion (one source each, dropped when it finishes)
+    CancelSource getCancel_;
+    std::list<CancelSource> addCancels_;
+    CancelSource postCancel_;
+    // Search-as-you-type engine, created on first use for the configured key
+    std::unique_ptr<IncrementalSearch> search_;
+    std::string searchApiKey_;
+    bool omdbSearchHasMore_ = false;
+
+    static QVariantList searchResultsToVariant(const std::vector<OmdbSearchResult>& results) {
+        QVariantList out;
+        for (const auto& r : results) {
+            QVariantMap m;
+            m["title"] = QString::fromStdString(r.title);
+            m["year"] = r.year;
+            m["imdbID"] = QString::fromStdString(r.imdbID);
+            out.push_back(m);
+        }
+        return out;
+    }
+
+    static QVariantMap detailToVariant(const Movie& mv) {
+        QVariantMap m;
+        m["imdbID"] = QString::fromStdString(mv.imdbID);
+        m["title"] = QString::fromStdString(mv.title);
+        m["year"] = mv.year;
+        m["posterUrl"] = QString::fromStdString(mv.posterUrl);
+        m["plotShort"] = QString::fromStdString(mv.plotShort);
+        m["plotFull"] = QString::fromStdString(mv.plotFull);
+        return m;
+    }
+
+    // Append to the list (insertion order) and reload; GUI thread only
+    bool storeMovie(const Movie& mv) {
+        try {
+            AppConfig cfg = loadConfig();
+            Top100 list(cfg.dataFile);
+            list.addMovie(mv);
+            list.recomputeRanks();
+        } catch (...) { return false; }
+        reload();
+        return true;
+    }
+
+    // Hand a network result to the GUI thread. Called on the HTTP event loop, so
+    // it must not touch the model; fn runs only if the model still exists and
+    // the request was not superseded in the meantime.
+    template <class F>
+    static void onGuiThread(QPointer<Top100ListModel> self, CancelToken token, F fn) {
+        QMetaObject::invokeMethod(QCoreApplication::instance(), [self, token, fn]() mutable {
+            if (self && !token.cancelled()) fn(self.data());
+        }, Qt::QueuedConnection);
+    }
+
+    // Sets up an outcome handler that reports success, failure or cancellation
+    void reportPosting(const QString& service, int row, const Future<bool>& post) {
+        QPointer<Top100ListModel> self(this);
+        post.onComplete([self, service, row](const Future<bool>& f) {
+            bool ok = false;
+            if (!f.cancelled()) {
+                try { ok = f.get(); } catch (...) {}
+            }
+            onGuiThread(self, CancelToken(), [service, row, ok](Top100ListModel* m) {
+                emit m->postingFinished(service, row, ok);
+            });
+        });
+    }
+
+    // Engine for the current API key; null (after clearing the results) when OMDb is off
+    IncrementalSearch* searchEngine() {
+        AppConfig cfg;
+        try { cfg = loadConfig(); } catch (...) { cfg.omdbEnabled = false; }
+        if (!cfg.omdbEnabled || cfg.omdbApiKey.empty()) {
+            search_.reset();
+            emit omdbSearchFinished({});
+            return nullptr;
+        }
+        if (!search_ || searchApiKey_ != cfg.omdbApiKey) {
+            QPointer<Top100ListModel> self(this);
+            search_ = std::make_unique<IncrementalSearch>(cfg.omdbApiKey, [self](const SearchUpdate& u) {
+                const QVariantList out = searchResultsToVariant(u.results);
+                const bool hasMore = u.hasMore;
+                onGuiThread(self, CancelToken(), [out, hasMore](Top100ListModel* m) {
+                    m->omdbSearchHasMore_ = hasMore;
+                    emit m->omdbSearchFinished(out);
+                });
+            });
+            searchApiKey_ = cfg.omdbApiKey;
+        }
+        return search_.get();
+    }
 
 public: // Async API (kept public for QML invocation)
     /**
-     * @brief Fire-and-forget asynchronous OMDb search.
+     * @brief Search-as-you-type: feed every edit of the search box.
+     * @param text Current search text
+     * @note Requests wait for a pause in typing; emits omdbSearchFinished(results)
+     *       for each answer, possibly several per query (cached, then fresh).
+     */
+    Q_INVOKABLE void setSearchText(const QString& text) {
+        if (IncrementalSearch* engine = searchEngine()) engine->setQuery(text.toStdString());
+    }
+    /**
+     * @brief Non-blocking OMDb search without waiting for a pause in typing.
      * @param query Search string
-     * @note Emits omdbSearchFinished(results)
+     * @note Emits omdbSearchFinished(results), except for superseded searches
      */
     Q_INVOKABLE void searchOmdbAsync(const QString& query) {
         if (query.trimmed().isEmpty()) return;
-        if (searchWatcher_) { searchWatcher_->cancel(); searchWatcher_->deleteLater(); searchWatcher_ = nullptr; }
-        searchWatcher_ = new QFutureWatcher<QVariantList>(this);
-        auto fut = QtConcurrent::run([this, query]() { return this->searchOmdb(query); });
-        connect(searchWatcher_, &QFutureWatcher<QVariantList>::finished, this, [this]() {
-            if (!searchWatcher_) return;
-            if (!searchWatcher_->isCanceled()) emit omdbSearchFinished(searchWatcher_->result());
-            searchWatcher_->deleteLater(); searchWatcher_ = nullptr;
-        });
-        searchWatcher_->setFuture(fut);
+        if (IncrementalSearch* engine = searchEngine()) {
+            engine->setQuery(query.toStdString());
+            engine->submit();
+        }
+    }
+    /** @brief Append the next page of results to the current search (emits omdbSearchFinished). */
+    Q_INVOKABLE void loadMoreOmdbResults() {
+        if (search_) search_->loadMore();
     }
+    /** @return Whether loadMoreOmdbResults() can show further results. */
+    Q_INVOKABLE bool omdbSearchHasMore() const { return omdbSearchHasMore_; }
     /**
-     * @brief Asynchronous fetch of full OMDb details by IMDb ID.
+     * @brief Non-blocking fetch of full OMDb details by IMDb ID.
      * @param imdbId IMDb identifier
-     * @note Emits omdbGetFinished(movie)
+     * @note Emits omdbGetFinished(movie) (empty map on failure)
      */
     Q_INVOKABLE void fetchOmdbByIdAsync(const QString& imdbId) {
         if (imdbId.trimmed().isEmpty()) return;
-        if (getWatcher_) { getWatcher_->cancel(); getWatcher_->deleteLater(); getWatcher_ = nullptr; }
-        getWatcher_ = new QFutureWatcher<QVariantMap>(this);
-        auto fut = QtConcurrent::run([this, imdbId]() { return this->omdbGetByIdMap(imdbId); });
-        connect(getWatcher_, &QFutureWatcher<QVariantMap>::finished, this, [this, imdbId]() {
-            if (!getWatcher_) return;
-            if (!getWatcher_->isCanceled()) emit omdbGetFinished(getWatcher_->result());
-            getWatcher_->deleteLater(); getWatcher_ = nullptr;
-        });
-        getWatcher_->setFuture(fut);
+        getCancel_.cancel();
+        getCancel_ = CancelSource();
+        AppConfig cfg;
+        try { cfg = loadConfig(); } catch (...) { emit omdbGetFinished({}); return; }
+        if (!cfg.omdbEnabled || cfg.omdbApiKey.empty()) { emit omdbGetFinished({}); return; }
+        const CancelToken token = getCancel_.token();
+        QPointer<Top100ListModel> self(this);
+        omdbGetByIdAsync(cfg.omdbApiKey, imdbId.toStdString(), OmdbDetailOptions{cfg.omdbFetchShortPlot}, token)
+            .onComplete([self, token](const Future<std::optional<Movie>>& f) {
+                if (f.cancelled()) return;
+                QVariantMap out;
+                try {
+                    if (auto movie = f.get()) out = detailToVariant(*movie);
+                } catch (...) {}
+                onGuiThread(self, token, [out](Top100ListModel* m) { emit m->omdbGetFinished(out); });
+            });
     }
     /**
-     * @brief Asynchronous add via OMDb ID.
+     * @brief Non-blocking add via OMDb ID; the list is written on the GUI thread.
      * @param imdbId IMDb identifier
      * @note Emits addMovieFinished(imdbId, success)
      */
     Q_INVOKABLE void addMovieByImdbIdAsync(const QString& imdbId) {
         if (imdbId.trimmed().isEmpty()) return;
-        if (addWatcher_) { addWatcher_->cancel(); addWatcher_->deleteLater(); addWatcher_ = nullptr; }
-        addWatcher_ = new QFutureWatcher<bool>(this);
-        auto fut = QtConcurrent::run([this, imdbId]() { return this->addMovieByImdbId(imdbId); });
-        connect(addWatcher_, &QFutureWatcher<bool>::finished, this, [this, imdbId]() {
-            if (!addWatcher_) return;
-            if (!addWatcher_->isCanceled()) emit addMovieFinished(imdbId, addWatcher_->result());
-            addWatcher_->deleteLater(); addWatcher_ = nullptr;
-        });
-        addWatcher_->setFuture(fut);
+        AppConfig cfg;
+        try { cfg = loadConfig(); } catch (...) { emit addMovieFinished(imdbId, false); return; }
+        if (!cfg.omdbEnabled || cfg.omdbApiKey.empty()) { emit addMovieFinished(imdbId, false); return; }
+        // Quick successive adds must all land: none supersedes another
+        const auto add = addCancels_.emplace(addCancels_.end());
+        const CancelToken token = add->token();
+        QPointer<Top100ListModel> self(this);
+        omdbGetByIdAsync(cfg.omdbApiKey, imdbId.toStdString(), OmdbDetailOptions{cfg.omdbFetchShortPlot}, token)
+            .onComplete([self, imdbId, add](const Future<std::optional<Movie>>& f) {
+                std::optional<Movie> movie;
+                if (!f.cancelled()) {
+                    try { movie = f.get(); } catch (...) {}
+                }
+                // Even a cancelled add reports back and drops its source while the model exists
+                onGuiThread(self, CancelToken(), [imdbId, movie, add](Top100ListModel* m) {
+                    m->addCancels_.erase(add);
+                    emit m->addMovieFinished(imdbId, movie && m->storeMovie(*movie));
+                });
+            });
     }
 };
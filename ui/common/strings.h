@@ -54,4 +54,5 @@ inline constexpr const char* kSortByYear    = "By year";
 inline constexpr const char* kSortAlpha     = "Alphabetical";
 inline constexpr const char* kSortByRank    = "By my rank";
 inline constexpr const char* kSortByScore   = "By my score";
+inline constexpr const char* kSortComposite = "By combined score";
 }
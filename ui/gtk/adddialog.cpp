@@ -9,11 +9,11 @@
 
 #include <gdkmm/pixbufloader.h>
 #include <glibmm/main.h>
-#include <thread>
-#include <cpr/cpr.h>
+#include <memory>
 
 #include "../../lib/config.h"
 #include "../../lib/omdb.h"
+#include "poster.h"
 #include "../common/constants.h"
 
 using namespace ui_constants;
@@ -54,7 +54,7 @@ Top100GtkAddDialog::Top100GtkAddDialog(Gtk::Window& parent) : Gtk::Dialog("Add M
     view_.append_column("Results", columns_.display);
     // Hide column header to avoid duplicate "Results" text (we have a heading above)
     view_.set_headers_visible(false);
-        view_.get_selection()->signal_changed().connect(sigc::mem_fun(*this, &Top100GtkAddDialog::on_selection_changed));
+        selection_changed_ = view_.get_selection()->signal_changed().connect(sigc::mem_fun(*this, &Top100GtkAddDialog::on_selection_changed));
         // Results frame with heading and scroller
         auto results_box = Gtk::manage(new Gtk::Box(Gtk::ORIENTATION_VERTICAL));
         results_box->set_border_width(kGroupPadding);
@@ -119,9 +119,28 @@ Top100GtkAddDialog::Top100GtkAddDialog(Gtk::Window& parent) : Gtk::Dialog("Add M
 
     btn_search_.signal_clicked().connect(sigc::mem_fun(*this, &Top100GtkAddDialog::on_search_clicked));
     entry_query_.signal_activate().connect(sigc::mem_fun(*this, &Top100GtkAddDialog::on_search_clicked));
+    entry_query_.signal_changed().connect(sigc::mem_fun(*this, &Top100GtkAddDialog::on_query_changed));
+    try {
+        AppConfig cfg = loadConfig();
+        if (cfg.omdbEnabled && !cfg.omdbApiKey.empty()) {
+            std::weak_ptr<bool> alive = alive_;
+            // Updates arrive on the engine thread; show them from the main loop
+            search_ = std::make_unique<IncrementalSearch>(cfg.omdbApiKey, [this, alive](const SearchUpdate& u) {
+                Glib::signal_idle().connect_once([this, alive, u]() {
+                    if (alive.lock()) show_results(u);
+                });
+            });
+        }
+    } catch (...) { /* searching stays disabled */ }
     show_all_children();
 }
 
+Top100GtkAddDialog::~Top100GtkAddDialog() {
+    alive_.reset();
+    search_.reset();
+    poster_cancel_.cancel();
+}
+
 void Top100GtkAddDialog::on_size_allocate(Gtk::Allocation& allocation) {
     Gtk::Dialog::on_size_allocate(allocation);
     update_poster_scaled();
@@ -156,32 +175,44 @@ void Top100GtkAddDialog::on_main_split_position_changed() {
 }
 
 void Top100GtkAddDialog::on_search_clicked() {
+    if (!search_ || entry_query_.get_text().empty()) return;
+    select_first_ = true;
+    search_->setQuery(entry_query_.get_text().raw());
+    search_->submit();
+}
+
+void Top100GtkAddDialog::on_query_changed() {
+    if (search_) search_->setQuery(entry_query_.get_text().raw());
+}
+
+void Top100GtkAddDialog::show_results(const SearchUpdate& update) {
+    // Rebuild the list, keeping the selected movie (and its preview) if it is
+    // still listed; while typing nothing is picked automatically
+    const std::string keep = selected_imdb_;
+    Gtk::TreeModel::iterator reselect;
+    selection_changed_.block();
     store_->clear();
-    selected_imdb_.clear();
-    title_.set_markup("<b></b>");
-    plot_.get_buffer()->set_text("");
+    for (const auto& r : update.results) {
+        auto it = store_->append();
+        auto row = *it;
+        std::string text = r.title + " (" + std::to_string(r.year) + ")";
+        row[columns_.display] = text;
+        row[columns_.imdb] = r.imdbID;
+        if (!keep.empty() && r.imdbID == keep) reselect = it;
+    }
+    auto sel = view_.get_selection();
+    if (reselect) sel->select(reselect);
+    selection_changed_.unblock();
+    if (!reselect && select_first_ && !update.provisional && store_->children().size() > 0) {
+        sel->select(store_->children().begin());
+    } else if (!reselect && !keep.empty()) {
+        title_.set_markup("<b></b>");
+        plot_.get_buffer()->set_text("");
         poster_.clear();
-    poster_orig_.reset();
-
-    auto q = entry_query_.get_text();
-    if (q.empty()) return;
-    try {
-        AppConfig cfg = loadConfig();
-        if (!cfg.omdbEnabled || cfg.omdbApiKey.empty()) { return; }
-        auto results = omdbSearch(cfg.omdbApiKey, q);
-        for (const auto& r : results) {
-            auto row = *(store_->append());
-            std::string text = r.title + " (" + std::to_string(r.year) + ")";
-            row[columns_.display] = text;
-            row[columns_.imdb] = r.imdbID;
-        }
-            if (store_->children().size() > 0) {
-                auto sel = view_.get_selection();
-                sel->select(store_->children().begin());
-            }
-    } catch (...) {
-        // ignore
+        poster_orig_.reset();
+        on_selection_changed();
     }
+    if (!update.provisional) select_first_ = false;
 }
 
 void Top100GtkAddDialog::on_selection_changed() {
@@ -212,7 +243,7 @@ void Top100GtkAddDialog::on_selection_changed() {
     try {
         AppConfig cfg = loadConfig();
         if (!cfg.omdbEnabled || cfg.omdbApiKey.empty()) return;
-        auto maybe = omdbGetById(cfg.omdbApiKey, imdb);
+        auto maybe = omdbGetById(cfg.omdbApiKey, imdb, OmdbDetailOptions{cfg.omdbFetchShortPlot});
         if (!maybe) return;
         std::string title = maybe->title;
         if (maybe->year > 0) title += " (" + std::to_string(maybe->year) + ")";
@@ -224,46 +255,64 @@ void Top100GtkAddDialog::on_selection_changed() {
 }
 
 void Top100GtkAddDialog::load_poster_async(const std::string& url, const std::string& imdb) {
+    poster_cancel_.cancel();
     poster_orig_.reset();
     poster_.clear();
-    poster_spinner_.show();
-    poster_spinner_.start();
+    poster_url_.clear();
     if (url.empty() || url == "N/A") { poster_spinner_.stop(); poster_spinner_.hide(); return; }
-        poster_for_imdb_ = imdb;
-    std::thread([this, url, imdb]() {
-        auto resp = cpr::Get(cpr::Url{url}, cpr::Timeout{8000});
-        if (resp.error || resp.status_code != 200 || resp.text.empty()) {
-            Glib::signal_idle().connect_once([this]() { poster_spinner_.stop(); poster_spinner_.hide(); });
-            return;
-        }
-        auto bytes = std::make_shared<std::string>(std::move(resp.text));
-        Glib::signal_idle().connect_once([this, bytes, imdb]() {
-            if (imdb != poster_for_imdb_) return; // stale
-            try {
-                auto loader = Gdk::PixbufLoader::create();
-                loader->write(reinterpret_cast<const guint8*>(bytes->data()), bytes->size());
-                loader->close();
-                poster_orig_ = loader->get_pixbuf();
+    poster_for_imdb_ = imdb;
+    poster_url_ = url;
+    fetch_poster_thumbnail();
+}
+
+void Top100GtkAddDialog::fetch_poster_thumbnail() {
+    // Another result or a larger box supersedes the load in flight
+    poster_cancel_.cancel();
+    poster_cancel_ = CancelSource();
+    const CancelToken token = poster_cancel_.token();
+    poster_box(poster_box_w_, poster_box_h_);
+    if (!poster_orig_) {
+        poster_spinner_.show();
+        poster_spinner_.start();
+    }
+    using BitmapPtr = std::shared_ptr<const PosterBitmap>;
+    posterCache()->thumbnailAsync(poster_for_imdb_, poster_url_, poster_box_w_, poster_box_h_, token)
+        .onComplete([this, token](const Future<BitmapPtr>& f) {
+            if (f.cancelled()) return; // superseded
+            BitmapPtr bitmap;
+            try { bitmap = f.get(); } catch (...) {}
+            Glib::signal_idle().connect_once([this, token, bitmap]() {
+                if (token.cancelled()) return; // stale, or the dialog is gone
+                if (bitmap) poster_orig_ = bitmap_pixbuf(*bitmap);
                 if (poster_orig_) update_poster_scaled(); else poster_.clear();
                 poster_spinner_.stop();
                 poster_spinner_.hide();
-            } catch (...) { poster_.clear(); }
+            });
         });
-    }).detach();
 }
 
+void Top100GtkAddDialog::poster_box(int& maxW, int& maxH) const {
+    maxW = std::max(1, static_cast<int>(get_width() * kPosterMaxWidthRatio));
+    maxH = std::max(1, static_cast<int>(get_height() * kPosterMaxHeightRatio));
+}
+
+// The stored pixbuf is a thumbnail covering the box, so this only scales the last step
 void Top100GtkAddDialog::update_poster_scaled() {
-    if (!poster_orig_) return;
-    int maxW = std::max(1, static_cast<int>(get_width() * kPosterMaxWidthRatio));
-    int maxH = std::max(1, static_cast<int>(get_height() * kPosterMaxHeightRatio));
-    int w = poster_orig_->get_width();
-    int h = poster_orig_->get_height();
-    if (w <= 0 || h <= 0) return;
-    double sx = static_cast<double>(maxW) / w;
-    double sy = static_cast<double>(maxH) / h;
-    double s = std::min(1.0, std::min(sx, sy));
-    int tw = std::max(1, static_cast<int>(w * s));
-    int th = std::max(1, static_cast<int>(h * s));
-    auto scaled = poster_orig_->scale_simple(tw, th, Gdk::INTERP_BILINEAR);
-    if (scaled) poster_.set(scaled);
+    int maxW = 0, maxH = 0;
+    poster_box(maxW, maxH);
+    if (poster_orig_) {
+        int w = poster_orig_->get_width();
+        int h = poster_orig_->get_height();
+        if (w > 0 && h > 0) {
+            double sx = static_cast<double>(maxW) / w;
+            double sy = static_cast<double>(maxH) / h;
+            double s = std::min(1.0, std::min(sx, sy));
+            int tw = std::max(1, static_cast<int>(w * s));
+            int th = std::max(1, static_cast<int>(h * s));
+            auto scaled = poster_orig_->scale_simple(tw, th, Gdk::INTERP_BILINEAR);
+            if (scaled) poster_.set(scaled);
+        }
+    }
+    // A dialog grown past the box the thumbnail was made for gets a larger one
+    if (!poster_url_.empty() && (maxW > poster_box_w_ || maxH > poster_box_h_)) fetch_poster_thumbnail();
 }
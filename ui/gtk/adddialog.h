@@ -9,8 +9,12 @@
 
 #include <gtkmm.h>
 #include <glibmm/refptr.h>
+#include <memory>
 #include <string>
 
+#include "../../lib/async.h"
+#include "../../lib/incremental_search.h"
+
 namespace Gdk { class Pixbuf; }
 
 /**
@@ -21,6 +25,8 @@ public:
     /** @brief Construct OMDb search/add dialog.
      *  @param parent Parent window */
     Top100GtkAddDialog(Gtk::Window& parent);
+    /** @brief Stop searching and cancel a poster download still in flight. */
+    ~Top100GtkAddDialog() override;
     /** @return Selected IMDb ID or empty string. */
     std::string selected_imdb() const { return selected_imdb_; }
 
@@ -50,6 +56,7 @@ private:
     } columns_;
     Glib::RefPtr<Gtk::ListStore> store_;
     Gtk::TreeView view_;
+    sigc::connection selection_changed_;
     Gtk::Label results_heading_ {"<b>Results</b>", true};
     Gtk::Frame results_frame_;
 
@@ -63,8 +70,17 @@ private:
     Gtk::Label plot_heading_ {"<b>Plot</b>", true};
     Gtk::Frame details_frame_;
     Gtk::Paned details_split_{Gtk::ORIENTATION_VERTICAL};
-    Glib::RefPtr<Gdk::Pixbuf> poster_orig_;
+    Glib::RefPtr<Gdk::Pixbuf> poster_orig_; // thumbnail covering the poster box
     std::string poster_for_imdb_;
+    std::string poster_url_;     // poster shown; empty when there is none
+    int poster_box_w_ {0};       // box the shown thumbnail was asked for
+    int poster_box_h_ {0};
+    CancelSource poster_cancel_;
+
+    // Search-as-you-type (null when OMDb is not configured)
+    std::unique_ptr<IncrementalSearch> search_;
+    std::shared_ptr<bool> alive_ = std::make_shared<bool>(true); // idle callbacks check this
+    bool select_first_ {false}; // explicit search: pick the first hit
 
     // State
     std::string selected_imdb_;
@@ -72,8 +88,12 @@ private:
 
     // Actions
     void on_search_clicked();
+    void on_query_changed();
+    void show_results(const SearchUpdate& update);
     void on_selection_changed();
     void load_poster_async(const std::string& url, const std::string& imdb);
+    void fetch_poster_thumbnail();
+    void poster_box(int& maxW, int& maxH) const;
     void update_poster_scaled();
     // Keep the main split fixed (left 35% / right 65%)
     void on_main_split_position_changed();
@@ -7,10 +7,13 @@
 //-------------------------------------------------------------------------------
 #include "app.h"
 #include "window.h"
+#include "shared_services.h"
 #include <gtkmm/application.h>
 
 int run_top100_gtk_app(int argc, char* argv[]) {
     auto app = Gtk::Application::create(argc, argv, "uk.co.andymccall.top100");
+    // OMDb cache, poster cache and title index, shared with the other front ends using this database
+    for (const std::string& error : initSharedServices()) g_warning("%s", error.c_str());
     Top100GtkWindow win;
     return app->run(win);
 }
@@ -51,13 +51,18 @@ void Top100GtkWindow::reload_model(const Glib::ustring& select_imdb) {
         case 2: order = SortOrder::ALPHABETICAL; break;
         case 3: order = SortOrder::BY_USER_RANK; break;
         case 4: order = SortOrder::BY_USER_SCORE; break;
+        case 5: order = SortOrder::COMPOSITE; break;
         default: order = SortOrder::DEFAULT; break;
     }
+    list.estimateRankIntervals();
+    list.setCompositeWeights(makeCompositeWeights(cfg.sortWeightUserScore, cfg.sortWeightImdbRating,
+                                                  cfg.sortWeightMetascore, cfg.sortWeightRottenTomatoes,
+                                                  cfg.sortNormalisation));
     auto movies = list.getMovies(order);
     int idx = 0;
     for (const auto& m : movies) {
         auto row = *(list_store_->append());
-        Glib::ustring text = (m.userRank > 0 ? ("#" + std::to_string(m.userRank) + " ") : "") + m.title + " (" + std::to_string(m.year) + ")";
+        Glib::ustring text = rankLabel(m) + m.title + " (" + std::to_string(m.year) + ")";
         row[columns_.text] = text;
         row[columns_.index] = idx++;
         row[columns_.imdb] = m.imdbID;
@@ -137,7 +142,9 @@ void Top100GtkWindow::on_update_current() {
     Glib::ustring imdb = (*iter)[columns_.imdb];
     AppConfig cfg = loadConfig();
     if (!cfg.omdbEnabled || cfg.omdbApiKey.empty()) { show_status("OMDb not configured"); return; }
-    auto maybe = omdbGetById(cfg.omdbApiKey, imdb);
+    OmdbDetailOptions opts{cfg.omdbFetchShortPlot};
+    opts.revalidate = true;
+    auto maybe = omdbGetById(cfg.omdbApiKey, imdb, opts);
     if (!maybe) { show_status("OMDb fetch failed"); return; }
     Top100 list(cfg.dataFile);
     if (list.mergeFromOmdbByImdbId(*maybe)) {
@@ -189,7 +196,7 @@ void Top100GtkWindow::on_add_movie() {
         try {
             AppConfig cfg = loadConfig();
             if (!cfg.omdbEnabled || cfg.omdbApiKey.empty()) { show_status("OMDb not configured"); return; }
-            auto maybe = omdbGetById(cfg.omdbApiKey, imdb);
+            auto maybe = omdbGetById(cfg.omdbApiKey, imdb, OmdbDetailOptions{cfg.omdbFetchShortPlot});
             if (!maybe) { show_status("OMDb fetch failed"); return; }
             // Limit scope so destructor flushes to DB before reload_model()
             {
@@ -221,7 +228,7 @@ void Top100GtkWindow::on_add_movie() {
             try {
                 AppConfig cfg = loadConfig();
                 if (!cfg.omdbEnabled || cfg.omdbApiKey.empty()) { show_status("OMDb not configured"); return; }
-                auto maybe = omdbGetById(cfg.omdbApiKey, imdb);
+                auto maybe = omdbGetById(cfg.omdbApiKey, imdb, OmdbDetailOptions{cfg.omdbFetchShortPlot});
                 if (!maybe) { show_status("OMDb fetch failed"); return; }
                 // Limit scope so destructor flushes to DB before reload_model()
                 {
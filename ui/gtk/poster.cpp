@@ -9,63 +9,120 @@
 
 #include <gdkmm/pixbufloader.h>
 #include <glibmm/main.h>
-#include <cpr/cpr.h>
-#include <thread>
+#include <memory>
 
 #include "../common/constants.h"
 
 using namespace ui_constants;
 
-// Scale and set the poster image to fit the right pane while preserving aspect
-void Top100GtkWindow::update_poster_scaled() {
-    if (!poster_pixbuf_original_) return;
+Glib::RefPtr<Gdk::Pixbuf> bitmap_pixbuf(const PosterBitmap& bm) {
+    auto pb = Gdk::Pixbuf::create(Gdk::COLORSPACE_RGB, true, 8, bm.width, bm.height);
+    if (!pb) return {};
+    // Premultiplied ARGB32 -> straight RGBA bytes
+    guint8* base = pb->get_pixels();
+    const int stride = pb->get_rowstride();
+    for (int y = 0; y < bm.height; ++y) {
+        const uint32_t* src = bm.pixels.data() + static_cast<size_t>(y) * bm.width;
+        guint8* dst = base + static_cast<size_t>(y) * stride;
+        for (int x = 0; x < bm.width; ++x, dst += 4) {
+            const uint32_t p = src[x];
+            const unsigned a = p >> 24;
+            unsigned r = (p >> 16) & 0xFF, g = (p >> 8) & 0xFF, b = p & 0xFF;
+            if (a != 0xFF && a != 0) {
+                r = (r * 255 + a / 2) / a;
+                g = (g * 255 + a / 2) / a;
+                b = (b * 255 + a / 2) / a;
+            }
+            dst[0] = static_cast<guint8>(r);
+            dst[1] = static_cast<guint8>(g);
+            dst[2] = static_cast<guint8>(b);
+            dst[3] = static_cast<guint8>(a);
+        }
+    }
+    return pb;
+}
+
+Glib::RefPtr<Gdk::Pixbuf> poster_pixbuf(const PosterPtr& poster) {
+    if (!poster) return {};
+    if (const auto& bm = poster->bitmap) return bitmap_pixbuf(*bm);
+    try {
+        auto loader = Gdk::PixbufLoader::create();
+        loader->write(reinterpret_cast<const guint8*>(poster->bytes.data()), poster->bytes.size());
+        loader->close();
+        return loader->get_pixbuf();
+    } catch (...) {
+        return {};
+    }
+}
+
+void Top100GtkWindow::poster_box(int& maxW, int& maxH) const {
     auto alloc = right_box_.get_allocation();
-    int maxW = static_cast<int>(alloc.get_width() * kPosterMaxWidthRatio);
-    int maxH = static_cast<int>(alloc.get_height() * kPosterMaxHeightRatio);
-    if (maxW <= 0 || maxH <= 0) return;
-    int w = poster_pixbuf_original_->get_width();
-    int h = poster_pixbuf_original_->get_height();
-    if (w <= 0 || h <= 0) return;
-    double sx = static_cast<double>(maxW) / w;
-    double sy = static_cast<double>(maxH) / h;
-    double s = std::min(1.0, std::min(sx, sy));
-    int tw = std::max(1, static_cast<int>(w * s));
-    int th = std::max(1, static_cast<int>(h * s));
-    auto scaled = poster_pixbuf_original_->scale_simple(tw, th, Gdk::INTERP_BILINEAR);
-    if (scaled)
-        poster_.set(scaled);
+    maxW = std::max(1, static_cast<int>(alloc.get_width() * kPosterMaxWidthRatio));
+    maxH = std::max(1, static_cast<int>(alloc.get_height() * kPosterMaxHeightRatio));
 }
 
-// Async fetch poster bytes and update in UI thread
+// Scale and set the poster image to fit the right pane while preserving aspect.
+// The stored pixbuf is a thumbnail covering the box, so this only scales the last step.
+void Top100GtkWindow::update_poster_scaled() {
+    int maxW = 0, maxH = 0;
+    poster_box(maxW, maxH);
+    if (poster_pixbuf_original_) {
+        int w = poster_pixbuf_original_->get_width();
+        int h = poster_pixbuf_original_->get_height();
+        if (w > 0 && h > 0) {
+            double sx = static_cast<double>(maxW) / w;
+            double sy = static_cast<double>(maxH) / h;
+            double s = std::min(1.0, std::min(sx, sy));
+            int tw = std::max(1, static_cast<int>(w * s));
+            int th = std::max(1, static_cast<int>(h * s));
+            auto scaled = poster_pixbuf_original_->scale_simple(tw, th, Gdk::INTERP_BILINEAR);
+            if (scaled)
+                poster_.set(scaled);
+        }
+    }
+    // A pane grown past the box the thumbnail was made for gets a larger one
+    if (!poster_url_.empty() && (maxW > poster_box_w_ || maxH > poster_box_h_)) fetch_poster_thumbnail();
+}
+
+// Show the poster of a newly selected movie
 void Top100GtkWindow::load_poster_async(const std::string& url, const std::string& imdb) {
-    if (url.empty()) { poster_.clear(); poster_pixbuf_original_.reset(); poster_spinner_.stop(); poster_spinner_.hide(); return; }
     current_imdb_id_ = imdb;
-    poster_spinner_.show();
-    poster_spinner_.start();
-    std::thread([this, url, imdb]() {
-        // Basic GET with reasonable timeout
-        auto resp = cpr::Get(cpr::Url{url}, cpr::Timeout{8000});
-        if (resp.error || resp.status_code != 200 || resp.text.empty()) {
-            Glib::signal_idle().connect_once([this]() { poster_spinner_.stop(); poster_spinner_.hide(); });
-            return;
-        }
-        auto bytes = std::make_shared<std::string>(std::move(resp.text));
-        Glib::signal_idle().connect_once([this, bytes, imdb]() {
-            // Drop stale results
-            if (imdb != current_imdb_id_) return;
-            try {
-                auto loader = Gdk::PixbufLoader::create();
-                loader->write(reinterpret_cast<const guint8*>(bytes->data()), bytes->size());
-                loader->close();
-                poster_pixbuf_original_ = loader->get_pixbuf();
+    poster_url_ = url;
+    poster_pixbuf_original_.reset();
+    if (url.empty()) {
+        // A newer selection makes any download still in flight pointless
+        poster_cancel_.cancel();
+        poster_.clear(); poster_spinner_.stop(); poster_spinner_.hide(); return;
+    }
+    fetch_poster_thumbnail();
+}
+
+// Look a thumbnail covering the pane's poster box up in the shared cache (downloading
+// the poster on a miss) and update in UI thread
+void Top100GtkWindow::fetch_poster_thumbnail() {
+    // A newer selection or a larger box makes any load still in flight pointless
+    poster_cancel_.cancel();
+    poster_cancel_ = CancelSource();
+    const CancelToken token = poster_cancel_.token();
+    poster_box(poster_box_w_, poster_box_h_);
+    // A larger thumbnail replaces the shown one without the spinner
+    if (!poster_pixbuf_original_) {
+        poster_spinner_.show();
+        poster_spinner_.start();
+    }
+    using BitmapPtr = std::shared_ptr<const PosterBitmap>;
+    posterCache()->thumbnailAsync(current_imdb_id_, poster_url_, poster_box_w_, poster_box_h_, token)
+        .onComplete([this, token](const Future<BitmapPtr>& f) {
+            if (f.cancelled()) return; // superseded
+            BitmapPtr bitmap;
+            try { bitmap = f.get(); } catch (...) {}
+            Glib::signal_idle().connect_once([this, token, bitmap]() {
+                // Drop stale results
+                if (token.cancelled()) return;
+                if (bitmap) poster_pixbuf_original_ = bitmap_pixbuf(*bitmap);
                 if (poster_pixbuf_original_) update_poster_scaled(); else poster_.clear();
                 poster_spinner_.stop();
                 poster_spinner_.hide();
-            } catch (...) {
-                poster_.clear();
-                poster_spinner_.stop();
-                poster_spinner_.hide();
-            }
+            });
         });
-    }).detach();
 }
@@ -7,4 +7,11 @@
 //-------------------------------------------------------------------------------
 #pragma once
 #include "window.h"
+#include "../../lib/poster_cache.h"
 // Poster methods are declared in window.h; this header groups their implementation unit.
+
+// Pixbuf of decoded poster pixels (straight RGBA copy; empty if it can't be allocated)
+Glib::RefPtr<Gdk::Pixbuf> bitmap_pixbuf(const PosterBitmap& bitmap);
+
+// Pixbuf of a cached poster: converts its decoded pixels, else decodes its bytes (empty if neither works)
+Glib::RefPtr<Gdk::Pixbuf> poster_pixbuf(const PosterPtr& poster);
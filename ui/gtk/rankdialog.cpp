@@ -10,12 +10,12 @@
 
 #include "../../lib/top100.h"
 #include "../../lib/config.h"
+#include "poster.h"
 #include "../common/constants.h"
 #include <gdkmm/pixbufloader.h>
 #include <glibmm/main.h>
-#include <cpr/cpr.h>
-#include <thread>
 #include <algorithm>
+#include <memory>
 
 using namespace ui_constants;
 
@@ -140,9 +140,17 @@ void Top100GtkRankDialog::pick_two() {
     int n = static_cast<int>(movies.size());
     if (n < 2) { left_index_ = right_index_ = -1; return; }
     static std::mt19937 rng{std::random_device{}()};
-    std::uniform_int_distribution<int> dist(0, n - 1);
-    int a = dist(rng), b = dist(rng); if (b == a) b = (a + 1) % n;
-    left_index_ = a; right_index_ = b;
+    // Skip pairs whose outcome is implied by earlier answers
+    auto pair = pickComparisonPair(movies, list.preferences(), rng);
+    if (!pair) {
+        left_index_ = right_index_ = -1;
+        prompt_.set_text("Every pair is already ordered by your previous answers.");
+        left_click_->set_sensitive(false);
+        right_click_->set_sensitive(false);
+        pass_btn_.set_sensitive(false);
+        return;
+    }
+    left_index_ = static_cast<int>(pair->first); right_index_ = static_cast<int>(pair->second);
     refresh_side(true);
     refresh_side(false);
 }
@@ -163,57 +171,32 @@ void Top100GtkRankDialog::refresh_side(bool left) {
     d->set_text(det.str());
     // Poster: load asynchronously
     if (!mv.posterUrl.empty()) {
-        if (left) load_poster_async_for(left_poster_, left_orig_, mv.posterUrl);
-        else      load_poster_async_for(right_poster_, right_orig_, mv.posterUrl);
+        if (left) load_poster_async_for(left_poster_, left_orig_, left_cancel_, left_ask_, left_box_, mv.imdbID, mv.posterUrl);
+        else      load_poster_async_for(right_poster_, right_orig_, right_cancel_, right_ask_, right_box_, mv.imdbID, mv.posterUrl);
     } else {
-        if (left) { left_poster_.clear(); left_orig_.reset(); }
-        else      { right_poster_.clear(); right_orig_.reset(); }
+        if (left) { left_cancel_.cancel(); left_poster_.clear(); left_orig_.reset(); left_ask_ = PosterAsk(); }
+        else      { right_cancel_.cancel(); right_poster_.clear(); right_orig_.reset(); right_ask_ = PosterAsk(); }
     }
 }
 
 void Top100GtkRankDialog::choose_left() {
     if (left_index_ < 0 || right_index_ < 0) return;
-    // Elo update via core list
-    AppConfig cfg = loadConfig();
-    Top100 list(cfg.dataFile);
-    auto movies = list.getMovies(SortOrder::DEFAULT);
-    if (left_index_ >= static_cast<int>(movies.size()) || right_index_ >= static_cast<int>(movies.size())) return;
-    Movie L = movies[left_index_], R = movies[right_index_];
-    // Simple Elo update
-    auto elo = [](double &a, double &b, double scoreA, double k=32.0){
-        double qa = std::pow(10.0, a/400.0), qb = std::pow(10.0, b/400.0);
-        double ea = qa/(qa+qb), eb = qb/(qa+qb);
-        a = a + k * (scoreA - ea);
-        b = b + k * ((1.0 - scoreA) - eb);
-    };
-    elo(L.userScore, R.userScore, 1.0);
-    int li = list.findIndexByImdbId(L.imdbID);
-    int ri = list.findIndexByImdbId(R.imdbID);
-    if (li >= 0) list.updateMovie(static_cast<size_t>(li), L);
-    if (ri >= 0) list.updateMovie(static_cast<size_t>(ri), R);
-    list.recomputeRanks();
+    // Elo update + comparison history via core list (indices are insertion order)
+    {
+        AppConfig cfg = loadConfig();
+        Top100 list(cfg.dataFile);
+        list.recordComparison(static_cast<size_t>(left_index_), static_cast<size_t>(right_index_));
+    } // saved on close
     pick_two();
 }
 
 void Top100GtkRankDialog::choose_right() {
     if (left_index_ < 0 || right_index_ < 0) return;
-    AppConfig cfg = loadConfig();
-    Top100 list(cfg.dataFile);
-    auto movies = list.getMovies(SortOrder::DEFAULT);
-    if (left_index_ >= static_cast<int>(movies.size()) || right_index_ >= static_cast<int>(movies.size())) return;
-    Movie L = movies[left_index_], R = movies[right_index_];
-    auto elo = [](double &a, double &b, double scoreA, double k=32.0){
-        double qa = std::pow(10.0, a/400.0), qb = std::pow(10.0, b/400.0);
-        double ea = qa/(qa+qb), eb = qb/(qa+qb);
-        a = a + k * (scoreA - ea);
-        b = b + k * ((1.0 - scoreA) - eb);
-    };
-    elo(L.userScore, R.userScore, 0.0);
-    int li = list.findIndexByImdbId(L.imdbID);
-    int ri = list.findIndexByImdbId(R.imdbID);
-    if (li >= 0) list.updateMovie(static_cast<size_t>(li), L);
-    if (ri >= 0) list.updateMovie(static_cast<size_t>(ri), R);
-    list.recomputeRanks();
+    {
+        AppConfig cfg = loadConfig();
+        Top100 list(cfg.dataFile);
+        list.recordComparison(static_cast<size_t>(right_index_), static_cast<size_t>(left_index_));
+    }
     pick_two();
 }
 
@@ -231,34 +214,54 @@ Glib::RefPtr<Gdk::Pixbuf> Top100GtkRankDialog::scale_pixbuf(const Glib::RefPtr<G
     return src->scale_simple(tw, th, Gdk::INTERP_BILINEAR);
 }
 
+void Top100GtkRankDialog::poster_box(const Gtk::Box* pane, int& maxW, int& maxH) const {
+    int w = pane->get_allocated_width(), h = pane->get_allocated_height();
+    if (w <= 1 || h <= 1) {
+        // Not laid out yet (first pair): half the dialog, which the pane won't exceed
+        get_default_size(w, h);
+        w /= 2;
+    }
+    maxW = std::max(1, static_cast<int>(w * kPosterMaxWidthRatio));
+    maxH = std::max(1, static_cast<int>(h * kPosterMaxHeightRatio));
+}
+
 void Top100GtkRankDialog::update_scaled_posters() {
-    auto allocL = left_box_->get_allocation();
-    auto allocR = right_box_->get_allocation();
-    int maxWL = static_cast<int>(allocL.get_width() * kPosterMaxWidthRatio);
-    int maxHL = static_cast<int>(allocL.get_height() * kPosterMaxHeightRatio);
-    int maxWR = static_cast<int>(allocR.get_width() * kPosterMaxWidthRatio);
-    int maxHR = static_cast<int>(allocR.get_height() * kPosterMaxHeightRatio);
+    // The stored pixbufs are thumbnails covering the box, so this only scales the last step
+    int maxWL = 0, maxHL = 0, maxWR = 0, maxHR = 0;
+    poster_box(left_box_, maxWL, maxHL);
+    poster_box(right_box_, maxWR, maxHR);
     if (left_orig_)  if (auto s = scale_pixbuf(left_orig_, maxWL, maxHL))  left_poster_.set(s); else left_poster_.clear();
     if (right_orig_) if (auto s = scale_pixbuf(right_orig_, maxWR, maxHR)) right_poster_.set(s); else right_poster_.clear();
+    // A pane grown past the box its thumbnail was made for gets a larger one
+    if (!left_ask_.url.empty() && (maxWL > left_ask_.width || maxHL > left_ask_.height))
+        load_poster_async_for(left_poster_, left_orig_, left_cancel_, left_ask_, left_box_, left_ask_.imdb, left_ask_.url);
+    if (!right_ask_.url.empty() && (maxWR > right_ask_.width || maxHR > right_ask_.height))
+        load_poster_async_for(right_poster_, right_orig_, right_cancel_, right_ask_, right_box_, right_ask_.imdb, right_ask_.url);
 }
 
-void Top100GtkRankDialog::load_poster_async_for(Gtk::Image& image, Glib::RefPtr<Gdk::Pixbuf>& store, const std::string& url) {
-    std::thread([this, &image, &store, url]() {
-        auto resp = cpr::Get(cpr::Url{url}, cpr::Timeout{8000});
-        if (resp.error || resp.status_code != 200 || resp.text.empty()) return;
-        auto img_bytes = std::make_shared<std::string>(std::move(resp.text));
-        Glib::signal_idle().connect_once([this, &image, &store, img_bytes]() {
-            try {
-                auto loader = Gdk::PixbufLoader::create();
-                loader->write(reinterpret_cast<const guint8*>(img_bytes->data()), img_bytes->size());
-                loader->close();
-                store = loader->get_pixbuf();
-                update_scaled_posters();
-            } catch (...) {
-                image.clear();
-            }
+void Top100GtkRankDialog::load_poster_async_for(Gtk::Image& image, Glib::RefPtr<Gdk::Pixbuf>& store,
+                                                CancelSource& cancel, PosterAsk& ask, const Gtk::Box* pane,
+                                                const std::string& imdb, const std::string& url) {
+    // The side now shows another movie (or needs a larger thumbnail): drop the previous load
+    cancel.cancel();
+    cancel = CancelSource();
+    const CancelToken token = cancel.token();
+    ask.imdb = imdb;
+    ask.url = url;
+    poster_box(pane, ask.width, ask.height);
+    using BitmapPtr = std::shared_ptr<const PosterBitmap>;
+    posterCache()->thumbnailAsync(imdb, url, ask.width, ask.height, token)
+        .onComplete([this, &image, &store, token](const Future<BitmapPtr>& f) {
+            if (f.cancelled()) return;
+            BitmapPtr bitmap;
+            try { bitmap = f.get(); } catch (...) {}
+            if (!bitmap) return;
+            Glib::signal_idle().connect_once([this, &image, &store, token, bitmap]() {
+                if (token.cancelled()) return; // superseded after the load finished
+                store = bitmap_pixbuf(*bitmap);
+                if (store) update_scaled_posters(); else image.clear();
+            });
         });
-    }).detach();
 }
 
 bool Top100GtkRankDialog::on_left_click(GdkEventButton*) { choose_left(); return true; }
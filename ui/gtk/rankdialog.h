@@ -8,6 +8,9 @@
 #include <gtkmm.h>
 //#include <gdkmm/cursor.h>
 
+#include "../../lib/async.h"
+#include <string>
+
 /**
  * @brief GTK dialog for pairwise ranking using simple Elo-like updates.
  */
@@ -16,6 +19,8 @@ public:
     /** @brief Pairwise ranking dialog (Elo-style).
      *  @param parent Parent window */
     Top100GtkRankDialog(Gtk::Window& parent);
+    /** @brief Cancel poster downloads still in flight. */
+    ~Top100GtkRankDialog() override { left_cancel_.cancel(); right_cancel_.cancel(); }
 private:
     // Containers to size posters consistently
     Gtk::Box* left_box_ { nullptr };
@@ -47,11 +52,25 @@ private:
     void pass_pair();
 
     // Poster helpers
-    Glib::RefPtr<Gdk::Pixbuf> left_orig_;
+    /** @brief Poster a side asked the cache for, and the box its thumbnail covers. */
+    struct PosterAsk {
+        std::string imdb;
+        std::string url;
+        int width = 0;
+        int height = 0;
+    };
+    Glib::RefPtr<Gdk::Pixbuf> left_orig_;   // thumbnail covering the pane's poster box
     Glib::RefPtr<Gdk::Pixbuf> right_orig_;
+    CancelSource left_cancel_;    // superseded when the side shows another movie
+    CancelSource right_cancel_;
+    PosterAsk left_ask_;
+    PosterAsk right_ask_;
     static Glib::RefPtr<Gdk::Pixbuf> scale_pixbuf(const Glib::RefPtr<Gdk::Pixbuf>& src, int maxW, int maxH);
+    void poster_box(const Gtk::Box* pane, int& maxW, int& maxH) const;
     void update_scaled_posters();
-    void load_poster_async_for(Gtk::Image& image, Glib::RefPtr<Gdk::Pixbuf>& store, const std::string& url);
+    void load_poster_async_for(Gtk::Image& image, Glib::RefPtr<Gdk::Pixbuf>& store, CancelSource& cancel,
+                               PosterAsk& ask, const Gtk::Box* pane, const std::string& imdb,
+                               const std::string& url);
 
     // Click handlers
     bool on_left_click(GdkEventButton*);
@@ -61,6 +61,7 @@ Top100GtkWindow::Top100GtkWindow()
     sort_combo_.append(kSortAlpha);
     sort_combo_.append(kSortByRank);
     sort_combo_.append(kSortByScore);
+    sort_combo_.append(kSortComposite);
     sort_box_.pack_start(sort_combo_, Gtk::PACK_EXPAND_WIDGET);
     left_box_.pack_start(sort_box_, Gtk::PACK_SHRINK);
 
@@ -134,7 +135,7 @@ Top100GtkWindow::Top100GtkWindow()
     try {
         AppConfig cfg = loadConfig();
         int so = cfg.uiSortOrder;
-        if (so < 0 || so > 4) so = 0;
+        if (so < 0 || so > 5) so = 0;
         sort_combo_.set_active(so);
     } catch (...) {
         sort_combo_.set_active(0);
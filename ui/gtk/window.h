@@ -13,6 +13,8 @@
 #include <string>
 #include <vector>
 
+#include "../../lib/async.h"
+
 namespace Gdk { class Pixbuf; }
 
 /**
@@ -63,8 +65,12 @@ private:
     Gtk::Image poster_;
         Gtk::Spinner poster_spinner_;
     Gtk::TextView plot_view_;
-    Glib::RefPtr<Gdk::Pixbuf> poster_pixbuf_original_;
+    Glib::RefPtr<Gdk::Pixbuf> poster_pixbuf_original_; // thumbnail covering the poster box
     std::string current_imdb_id_;
+    std::string poster_url_;       // poster shown; empty when there is none
+    int poster_box_w_ { 0 };       // box the shown thumbnail was asked for
+    int poster_box_h_ { 0 };
+    CancelSource poster_cancel_;   // cancels the poster download a new selection supersedes
 
     // --- Helpers split across implementation files ---
     // menu.cpp
@@ -80,8 +86,10 @@ private:
     Gtk::ToolButton* btn_update_ { nullptr };
 
     // poster.cpp
+    void poster_box(int& maxW, int& maxH) const;
     void update_poster_scaled();
     void load_poster_async(const std::string& url, const std::string& imdb);
+    void fetch_poster_thumbnail();
 
     // handlers.cpp
     void show_status(const std::string& msg);
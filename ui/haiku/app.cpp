@@ -9,10 +9,14 @@
 
 #ifdef __HAIKU__
 #include "window.h"
+#include "shared_services.h"
+#include <cstdio>
 
 Top100HaikuApp::Top100HaikuApp() : BApplication("application/x-vnd.andymccall.top100") {}
 
 void Top100HaikuApp::ReadyToRun() {
+    // OMDb cache, poster cache and title index, shared with the other front ends using this database
+    for (const std::string& error : initSharedServices()) std::fprintf(stderr, "top100: %s\n", error.c_str());
     auto *win = new Top100HaikuWindow();
     win->Show();
 }
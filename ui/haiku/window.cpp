@@ -28,12 +28,15 @@
 #include <optional>
 #include <cmath>
 #include <deque>
+#include <random>
 #include <TranslationUtils.h>
-#include <cpr/cpr.h>
+#include <Bitmap.h>
+#include <cstring>
 
 #include "../../lib/config.h"
 #include "../../lib/top100.h"
 #include "../../lib/omdb.h"
+#include "../../lib/poster_cache.h"
 #include "add_dialog.h"
 #include "../common/constants.h"
 #include "../common/strings.h"
@@ -84,7 +87,7 @@ void Top100HaikuWindow::MessageReceived(BMessage* msg) {
                 break;
             }
             try {
-                auto om = omdbGetById(cfg.omdbApiKey, imdbID);
+                auto om = omdbGetById(cfg.omdbApiKey, imdbID, OmdbDetailOptions{cfg.omdbFetchShortPlot});
                 if (!om) { (new BAlert("omdb2", "Could not fetch details from OMDb.", "OK"))->Go(); break; }
                 Top100 list(cfg.dataFile);
                 list.addMovie(*om);
@@ -141,7 +144,9 @@ void Top100HaikuWindow::MessageReceived(BMessage* msg) {
                 break;
             }
             try {
-                auto om = omdbGetById(cfg.omdbApiKey, imdbForRow_[row]);
+                OmdbDetailOptions opts{cfg.omdbFetchShortPlot};
+                opts.revalidate = true;
+                auto om = omdbGetById(cfg.omdbApiKey, imdbForRow_[row], opts);
                 if (!om) {
                     (new BAlert("omdb2", "Could not fetch details from OMDb.", "OK"))->Go();
                     break;
@@ -216,6 +221,7 @@ void Top100HaikuWindow::MessageReceived(BMessage* msg) {
                 std::deque<std::pair<int32,int32>> recentPairs; // history of recent pairs to avoid repeats
                 static constexpr size_t kMaxRecentPairs = 20;
                 BMessenger parentMsgr_;
+                CancelSource posterCancel_[2]; // [left, right]; superseded when the side shows another movie
 
                 static std::string Join(const std::vector<std::string>& v, const char* sep = ", ") {
                     std::ostringstream oss; bool first = true; for (const auto& s : v) { if (!first) oss << sep; oss << s; first = false; } return oss.str();
@@ -277,9 +283,20 @@ void Top100HaikuWindow::MessageReceived(BMessage* msg) {
                         }
                         return false;
                     };
-                    int a = rand() % n; int b = rand() % n;
-                    while ((b == a) || isRepeat(a,b)) {
-                        b = rand() % n; a = rand() % n; if (++attempts > 50) break;
+                    // Only offer pairs whose outcome is not implied by earlier answers
+                    static std::mt19937 rng{std::random_device{}()};
+                    auto pair = pickComparisonPair(movies, list.preferences(), rng);
+                    if (!pair) {
+                        leftIdx = rightIdx = -1;
+                        leftTitle->SetText("Every pair is already ordered by your previous answers.");
+                        rightTitle->SetText("");
+                        return;
+                    }
+                    int a = (int)pair->first; int b = (int)pair->second;
+                    while (isRepeat(a,b) && ++attempts <= 10) {
+                        auto next = pickComparisonPair(movies, list.preferences(), rng);
+                        if (!next) break;
+                        a = (int)next->first; b = (int)next->second;
                     }
                     if (recentPairs.size() >= kMaxRecentPairs) recentPairs.pop_front();
                     recentPairs.emplace_back(a,b);
@@ -295,49 +312,68 @@ void Top100HaikuWindow::MessageReceived(BMessage* msg) {
                     if (left) { leftTitle->SetText(head.c_str()); leftDetails->SetText(det.c_str()); }
                     else      { rightTitle->SetText(head.c_str()); rightDetails->SetText(det.c_str()); }
                     // Load posters asynchronously
-                    if (!mv.posterUrl.empty()) LoadPoster(left, mv.posterUrl);
+                    if (!mv.posterUrl.empty()) LoadPoster(left, mv.imdbID, mv.posterUrl);
                 }
                 void Choose(bool left) {
                     if (leftIdx < 0 || rightIdx < 0) return;
-                    AppConfig cfg = loadConfig(); Top100 list(cfg.dataFile);
-                    auto movies = list.getMovies(SortOrder::DEFAULT);
-                    if (leftIdx >= (int)movies.size() || rightIdx >= (int)movies.size()) return;
-                    Movie L = movies[leftIdx], R = movies[rightIdx];
-                    auto elo = [](double &a, double &b, double scoreA, double k=32.0){ double qa = pow(10.0, a/400.0), qb = pow(10.0, b/400.0); double ea = qa/(qa+qb), eb = qb/(qa+qb); a = a + k * (scoreA - ea); b = b + k * ((1.0 - scoreA) - eb); };
-                    elo(L.userScore, R.userScore, left ? 1.0 : 0.0);
-                    int li = list.findIndexByImdbId(L.imdbID); if (li >= 0) list.updateMovie((size_t)li, L);
-                    int ri = list.findIndexByImdbId(R.imdbID); if (ri >= 0) list.updateMovie((size_t)ri, R);
-                    list.recomputeRanks();
+                    {
+                        // Elo update + comparison history via core list (indices are insertion order)
+                        AppConfig cfg = loadConfig(); Top100 list(cfg.dataFile);
+                        if (left) list.recordComparison((size_t)leftIdx, (size_t)rightIdx);
+                        else      list.recordComparison((size_t)rightIdx, (size_t)leftIdx);
+                    }
                     PickTwo();
                 }
 
-                void LoadPoster(bool leftSide, const std::string& url) {
+                // BBitmap of a cached poster: decoded pixels copied as-is (same layout as B_RGBA32),
+                // else its bytes through the Translation Kit
+                static BBitmap* PosterBitmapOf(const Poster& poster) {
+                    if (const auto& px = poster.bitmap) {
+                        BBitmap* bm = new BBitmap(BRect(0, 0, px->width - 1, px->height - 1), B_RGBA32);
+                        if (bm->InitCheck() != B_OK) { delete bm; return nullptr; }
+                        const size_t row = static_cast<size_t>(px->width) * 4;
+                        for (int y = 0; y < px->height; ++y)
+                            std::memcpy(static_cast<uint8*>(bm->Bits()) + static_cast<size_t>(y) * bm->BytesPerRow(),
+                                        px->pixels.data() + static_cast<size_t>(y) * px->width, row);
+                        return bm;
+                    }
+                    return BTranslationUtils::GetBitmapFromBuffer(poster.bytes.data(), poster.bytes.size());
+                }
+
+                void LoadPoster(bool leftSide, const std::string& imdb, const std::string& url) {
+                    CancelSource& cancel = posterCancel_[leftSide ? 0 : 1];
+                    cancel.cancel();
+                    cancel = CancelSource();
                     // Capture messenger to post back to this window safely
                     BMessenger msgr(this);
-                    std::thread([this, msgr, url, leftSide]() {
-                        auto resp = cpr::Get(cpr::Url{url}, cpr::Timeout{8000});
-                        if (resp.error || resp.status_code != 200 || resp.text.empty()) return;
-                        // Decode via Translation Kit
-                        BBitmap* bitmap = BTranslationUtils::GetBitmapFromBuffer(resp.text.data(), resp.text.size());
-                        if (!bitmap) return;
-                        // Apply on UI thread
+                    const CancelToken token = cancel.token();
+                    posterCache()->getAsync(imdb, url, token).onComplete([msgr, leftSide, token](const Future<PosterPtr>& f) {
+                        if (f.cancelled()) return;
+                        PosterPtr poster;
+                        try { poster = f.get(); } catch (...) {}
+                        if (!poster) return;
+                        // Built off the window thread; the window takes ownership
+                        BBitmap* bm = PosterBitmapOf(*poster);
+                        if (!bm) return;
                         BMessage m('pstr');
-                        m.AddPointer("bm", bitmap);
+                        m.AddPointer("bitmap", bm);
                         m.AddBool("left", leftSide);
-                        msgr.SendMessage(&m);
-                    }).detach();
+                        if (token.cancelled() || msgr.SendMessage(&m) != B_OK) delete bm;
+                    });
                 }
 
                 void MessageReceived(BMessage* msg) override {
                     switch (msg->what) {
                         case 'pass': PickTwo(); break;
                         case 'pstr': {
-                            BBitmap* bm = nullptr; bool leftSide = true;
-                            msg->FindPointer("bm", reinterpret_cast<void**>(&bm));
+                            void* ptr = nullptr; bool leftSide = true;
+                            msg->FindPointer("bitmap", &ptr);
                             msg->FindBool("left", &leftSide);
+                            BBitmap* bm = static_cast<BBitmap*>(ptr);
                             if (bm) {
                                 if (leftSide && leftPoster) leftPoster->SetBitmap(bm);
                                 else if (rightPoster) rightPoster->SetBitmap(bm);
+                                else delete bm;
                             }
                             break;
                         }
@@ -345,6 +381,8 @@ void Top100HaikuWindow::MessageReceived(BMessage* msg) {
                     }
                 }
                 bool QuitRequested() override {
+                    posterCancel_[0].cancel();
+                    posterCancel_[1].cancel();
                     // Ask parent to refresh list to reflect updated ranks
                     if (parentMsgr_.IsValid()) {
                         BMessage refresh('rfrs'); // matches kMsgDoRefresh
@@ -496,8 +534,8 @@ void Top100HaikuWindow::BuildLayout() {
 void Top100HaikuWindow::RebuildSortMenu(int currentIndex) {
     if (!sortMenu_ || !sortField_) return;
     sortMenu_->RemoveItems(0, sortMenu_->CountItems(), true);
-    const char* opts[] = { kSortInsertion, kSortByYear, kSortAlpha, kSortByRank, kSortByScore };
-    for (int i = 0; i < 5; ++i) {
+    const char* opts[] = { kSortInsertion, kSortByYear, kSortAlpha, kSortByRank, kSortByScore, kSortComposite };
+    for (int i = 0; i < 6; ++i) {
         auto *mi = new BMenuItem(opts[i], new BMessage(kMsgSortChanged));
         mi->Message()->AddInt32("sort", i);
         sortMenu_->AddItem(mi);
@@ -527,13 +565,18 @@ void Top100HaikuWindow::ReloadModel(const std::string& selectImdb) {
         case 2: order = SortOrder::ALPHABETICAL; break;
         case 3: order = SortOrder::BY_USER_RANK; break;
         case 4: order = SortOrder::BY_USER_SCORE; break;
+        case 5: order = SortOrder::COMPOSITE; break;
         default: order = SortOrder::DEFAULT; break;
     }
+    list.estimateRankIntervals();
+    list.setCompositeWeights(makeCompositeWeights(cfg.sortWeightUserScore, cfg.sortWeightImdbRating,
+                                                  cfg.sortWeightMetascore, cfg.sortWeightRottenTomatoes,
+                                                  cfg.sortNormalisation));
     auto movies = list.getMovies(order);
     int selectIndex = -1;
     int row = 0;
     for (const auto& m : movies) {
-        auto text = (m.userRank > 0 ? ("#" + std::to_string(m.userRank) + " ") : std::string()) + m.title + " (" + std::to_string(m.year) + ")";
+        auto text = rankLabel(m) + m.title + " (" + std::to_string(m.year) + ")";
         listView_->AddItem(new BStringItem(text.c_str()));
         imdbForRow_.push_back(m.imdbID);
         if (!selectImdb.empty() && m.imdbID == selectImdb) selectIndex = row;
@@ -33,6 +33,7 @@
 #include "../../lib/config.h"
 #include "../../lib/top100.h"
 #include "../../lib/Movie.h"
+#include "../../lib/shared_services.h"
 
 // TODO: include your top100 library header here
 // #include "path/to/your/top100/api.h"
@@ -74,6 +75,9 @@ int main(int argc, char *argv[]) {
     // Optional: use Breeze icon name if available
     app.setWindowIcon(QIcon::fromTheme("applications-multimedia"));
 
+    // OMDb cache, poster cache and title index, shared with the other front ends using this database
+    for (const std::string& error : initSharedServices()) qWarning("%s", error.c_str());
+
     QQmlApplicationEngine engine;
     // Expose strings to QML
     engine.rootContext()->setContextProperty("UiStrings_MenuFile", QString::fromUtf8(ui_strings::kMenuFile));
@@ -98,6 +102,7 @@ int main(int argc, char *argv[]) {
     engine.rootContext()->setContextProperty("UiStrings_SortAlpha", QString::fromUtf8(ui_strings::kSortAlpha));
     engine.rootContext()->setContextProperty("UiStrings_SortByRank", QString::fromUtf8(ui_strings::kSortByRank));
     engine.rootContext()->setContextProperty("UiStrings_SortByScore", QString::fromUtf8(ui_strings::kSortByScore));
+    engine.rootContext()->setContextProperty("UiStrings_SortComposite", QString::fromUtf8(ui_strings::kSortComposite));
 
     // Expose shared UI constants to QML for parity with Qt Widgets
     engine.rootContext()->setContextProperty("Ui_InitWidth", ui_constants::kInitialWidth);
@@ -162,7 +162,8 @@ Kirigami.ApplicationWindow {
                     Kirigami.Action { text: qsTr("By year"); tooltip: ""; onTriggered: top100Model.setSortOrder(1) },
                     Kirigami.Action { text: qsTr("Alphabetical"); tooltip: ""; onTriggered: top100Model.setSortOrder(2) },
                     Kirigami.Action { text: qsTr("By my rank"); tooltip: ""; onTriggered: top100Model.setSortOrder(3) },
-                    Kirigami.Action { text: qsTr("By my score"); tooltip: ""; onTriggered: top100Model.setSortOrder(4) }
+                    Kirigami.Action { text: qsTr("By my score"); tooltip: ""; onTriggered: top100Model.setSortOrder(4) },
+                    Kirigami.Action { text: qsTr("By combined score"); tooltip: ""; onTriggered: top100Model.setSortOrder(5) }
                 ]
             },
             Kirigami.Action {
@@ -260,7 +261,7 @@ Kirigami.ApplicationWindow {
                         ComboBox {
                             id: sortCombo
                             Layout.fillWidth: true
-                            model: [UiStrings_SortInsertion, UiStrings_SortByYear, UiStrings_SortAlpha, UiStrings_SortByRank, UiStrings_SortByScore]
+                            model: [UiStrings_SortInsertion, UiStrings_SortByYear, UiStrings_SortAlpha, UiStrings_SortByRank, UiStrings_SortByScore, UiStrings_SortComposite]
                             Component.onCompleted: currentIndex = top100Model.sortOrder
                             onCurrentIndexChanged: {
                                 var oldIdx = list.currentIndex
@@ -750,9 +751,37 @@ Kirigami.ApplicationWindow {
         y: (window.height - height) / 2
         standardButtons: Controls.Dialog.NoButton
         property var selected: null
-        // Whether a search is currently running (UI disables inputs)
-        property bool searching: false
+        // IMDb ID of the picked result; kept picked while results refresh
+        property string selectedImdb: ""
+        // An explicit search (Enter or the button) picks its first hit; typing never does
+        property bool selectFirst: false
+        // Set while the results list is rebuilt, so the rebuild doesn't count as a pick
+        property bool refreshing: false
+        property bool hasMore: false
     onVisibleChanged: if (visible) { x = (window.width - width)/2; y = (window.height - height)/2 }
+        // Search-as-you-type and explicit searches share the model's debounced engine
+        Connections {
+            target: top100Model
+            enabled: addDialog.visible
+            function onOmdbSearchFinished(results) {
+                var list = results || []
+                var row = -1
+                for (var i = 0; i < list.length; ++i) {
+                    if (list[i].imdbID === addDialog.selectedImdb) { row = i; break }
+                }
+                if (row < 0 && addDialog.selectFirst && list.length > 0) row = 0
+                addDialog.selectFirst = false
+                addDialog.hasMore = top100Model.omdbSearchHasMore()
+                addDialog.refreshing = true
+                selectionModel.results = list
+                resultsList.currentIndex = row
+                addDialog.refreshing = false
+                resultsList.showResult(row)
+            }
+            function onOmdbGetFinished(movie) {
+                if (movie && movie.imdbID === addDialog.selectedImdb) addDialog.selected = movie
+            }
+        }
         contentItem: Item {
             anchors.fill: parent
             anchors.margins: Kirigami.Units.largeSpacing
@@ -782,7 +811,8 @@ Kirigami.ApplicationWindow {
                     id: queryField
                     Layout.fillWidth: true
                     placeholderText: qsTr("title keyword")
-                    enabled: !addDialog.searching
+                    // The model waits for a pause in typing before asking OMDb
+                    onTextEdited: top100Model.setSearchText(text)
                     onAccepted: searchBtn.clicked()
                 }
                 Button {
@@ -790,19 +820,11 @@ Kirigami.ApplicationWindow {
                     text: qsTr("Search")
                     highlighted: true
                     focus: true
-                    enabled: !addDialog.searching
                     onClicked: {
                         var q = queryField.text
                         if (!q || q.trim().length === 0) return
-                        addDialog.searching = true
-                            window.showPassiveNotification(qsTr("Searching"))
-                        Qt.callLater(function() {
-                            var results = top100Model.searchOmdb(q)
-                            addDialog.searching = false
-                                resultsList.currentIndex = -1
-                                addDialog.selected = null
-                                selectionModel.results = results || []
-                        })
+                        addDialog.selectFirst = true
+                        top100Model.searchOmdbAsync(q)
                     }
                 }
             }
@@ -842,14 +864,26 @@ Kirigami.ApplicationWindow {
                                     text: (modelData.title + " (" + modelData.year + ")")
                                     onClicked: resultsList.currentIndex = index
                                 }
-                                onCurrentIndexChanged: {
-                                    if (currentIndex >= 0 && model && model.length > currentIndex) {
-                                        var imdb = model[currentIndex].imdbID
-                                        addDialog.selected = top100Model.omdbGetByIdMap(imdb)
+                                // Details load in the background; a refresh that keeps the pick fetches nothing
+                                function showResult(row) {
+                                    if (row >= 0 && model && model.length > row) {
+                                        var imdb = model[row].imdbID
+                                        if (imdb === addDialog.selectedImdb && addDialog.selected) return
+                                        addDialog.selectedImdb = imdb
+                                        addDialog.selected = null
+                                        top100Model.fetchOmdbByIdAsync(imdb)
                                     } else {
+                                        addDialog.selectedImdb = ""
                                         addDialog.selected = null
                                     }
                                 }
+                                onCurrentIndexChanged: if (!addDialog.refreshing) showResult(currentIndex)
+                            }
+                            Button {
+                                Layout.fillWidth: true
+                                text: qsTr("More results")
+                                visible: addDialog.hasMore
+                                onClicked: top100Model.loadMoreOmdbResults()
                             }
                         }
                     }
@@ -20,17 +20,16 @@
 #include <QScreen>
 #include <QGuiApplication>
 #include <QItemSelectionModel>
-#include <QNetworkAccessManager>
-#include <QNetworkRequest>
-#include <QNetworkReply>
 #include <QUrl>
 #include <QBuffer>
 #include <QPixmap>
 #include <QShowEvent>
 #include <QResizeEvent>
+#include <QSignalBlocker>
 #include <QtConcurrent>
 #include <QFutureWatcher>
 
+#include "poster.h"
 #include "../common/constants.h"
 #include "../common/Top100ListModel.h"
 
@@ -53,9 +52,17 @@ Top100QtAddDialog::Top100QtAddDialog(QWidget* parent, Top100ListModel* model)
     searchBtn_->setDefault(true);
     connect(searchBtn_, &QPushButton::clicked, this, [this]() { doSearch(); });
     connect(queryEdit_, &QLineEdit::returnPressed, this, [this]() { doSearch(); });
+    // Search as you type; the model waits for a pause before asking OMDb
+    connect(queryEdit_, &QLineEdit::textEdited, this, [this](const QString& text) {
+        if (model_) model_->setSearchText(text);
+    });
     // Connect async model signals
     if (model_) {
         connect(model_, &Top100ListModel::omdbSearchFinished, this, [this](const QVariantList& res){
+            // Results refresh while typing; keep the current pick if it is still listed,
+            // else leave the list unselected (only an explicit search picks the first hit)
+            const QString keep = selectedImdb_;
+            QSignalBlocker quiet(resultsView_->selectionModel());
             resultsModel_->clear();
             for (const auto& v : res) {
                 QVariantMap m = v.toMap();
@@ -67,17 +74,22 @@ Top100QtAddDialog::Top100QtAddDialog(QWidget* parent, Top100ListModel* model)
                 it->setEditable(false);
                 resultsModel_->appendRow(it);
             }
-            if (resultsModel_->rowCount() > 0) resultsView_->setCurrentIndex(resultsModel_->index(0,0));
-            searchBtn_->setEnabled(true);
-            queryEdit_->setEnabled(true);
+            int row = -1;
+            for (int i = 0; i < resultsModel_->rowCount(); ++i) {
+                if (resultsModel_->item(i)->data(Qt::UserRole + 1).toString() == keep) { row = i; break; }
+            }
+            if (row < 0 && selectFirst_ && resultsModel_->rowCount() > 0) row = 0;
+            selectFirst_ = false;
+            quiet.unblock();
+            if (row >= 0) resultsView_->setCurrentIndex(resultsModel_->index(row,0));
+            else onResultSelectionChanged();
         });
         connect(model_, &Top100ListModel::omdbGetFinished, this, [this](const QVariantMap& m){
             QString t = m.value("title").toString();
             int y = m.value("year").toInt();
             titleLbl_->setText(y > 0 ? QString("%1 (%2)").arg(t).arg(y) : t);
             plotView_->setPlainText(!m.value("plotShort").toString().isEmpty() ? m.value("plotShort").toString() : m.value("plotFull").toString());
-            QString poster = m.value("posterUrl").toString();
-            loadPoster(poster);
+            loadPoster(m.value("imdbID").toString(), m.value("posterUrl").toString());
         });
         connect(model_, &Top100ListModel::addMovieFinished, this, [this](const QString& imdb, bool ok){
             if (ok) accept(); else addBtn_->setEnabled(true);
@@ -133,8 +145,6 @@ Top100QtAddDialog::Top100QtAddDialog(QWidget* parent, Top100ListModel* model)
     connect(addBtn_, &QPushButton::clicked, this, &QDialog::accept);
     connect(manualBtn, &QPushButton::clicked, this, [this]() { this->reject(); });
     root->addWidget(btns);
-
-    nam_ = new QNetworkAccessManager(this);
 }
 
 void Top100QtAddDialog::showEvent(QShowEvent* ev) {
@@ -151,36 +161,44 @@ void Top100QtAddDialog::resizeEvent(QResizeEvent* ev) {
 }
 
 void Top100QtAddDialog::doSearch() {
-    resultsModel_->clear();
-    addBtn_->setEnabled(false);
-    selectedImdb_.clear();
     const QString q = queryEdit_->text().trimmed();
     if (q.isEmpty() || !model_) return;
-    searchBtn_->setEnabled(false); queryEdit_->setEnabled(false);
+    selectFirst_ = true;
     model_->searchOmdbAsync(q);
 }
 
 void Top100QtAddDialog::onResultSelectionChanged() {
     QModelIndex idx = resultsView_->currentIndex();
-    if (!idx.isValid()) { addBtn_->setEnabled(false); titleLbl_->clear(); plotView_->clear(); posterLbl_->clear(); return; }
+    if (!idx.isValid()) {
+        selectedImdb_.clear(); posterUrl_.clear(); origPoster_ = QPixmap();
+        addBtn_->setEnabled(false); titleLbl_->clear(); plotView_->clear(); posterLbl_->clear(); return;
+    }
     QString imdb = resultsModel_->itemFromIndex(idx)->data(Qt::UserRole + 1).toString();
-    selectedImdb_ = imdb;
     addBtn_->setEnabled(true);
+    if (imdb == selectedImdb_ && !titleLbl_->text().isEmpty()) return; // same movie after a refresh
+    selectedImdb_ = imdb;
     model_->fetchOmdbByIdAsync(imdb);
 }
 
-void Top100QtAddDialog::loadPoster(const QString& url) {
+void Top100QtAddDialog::loadPoster(const QString& imdb, const QString& url) {
     origPoster_ = QPixmap();
     posterLbl_->clear();
-    if (posterSpinner_) posterSpinner_->start();
-    if (url.isEmpty() || url == "N/A") return;
-    QNetworkRequest request{QUrl{url}};
-    QNetworkReply* reply = nam_->get(request);
-    connect(reply, &QNetworkReply::finished, this, [this, reply]() {
-        reply->deleteLater();
-    if (reply->error() != QNetworkReply::NoError) { if (posterSpinner_) posterSpinner_->stop(); return; }
-        QByteArray data = reply->readAll();
-        QPixmap pm; pm.loadFromData(data);
+    posterUrl_.clear();
+    if (url.isEmpty() || url == "N/A") { if (posterSpinner_) posterSpinner_->stop(); return; }
+    posterImdb_ = imdb;
+    posterUrl_ = url;
+    fetchPosterThumbnail();
+}
+
+void Top100QtAddDialog::fetchPosterThumbnail() {
+    // A larger thumbnail for the same poster replaces the shown one without the spinner
+    if (origPoster_.isNull() && posterSpinner_) posterSpinner_->start();
+    const QSize box = posterBox(this);
+    posterAsk_ = box;
+    const QString imdb = posterImdb_, url = posterUrl_;
+    loadPosterThumbnail(this, imdb, url, box, [this, imdb, url, box](const QPixmap& pm) {
+        // Another result was picked, or a larger thumbnail asked for, meanwhile
+        if (imdb != selectedImdb_ || url != posterUrl_ || box != posterAsk_) return;
         if (!pm.isNull()) {
             origPoster_ = pm;
             rescalePoster();
@@ -190,9 +208,10 @@ void Top100QtAddDialog::loadPoster(const QString& url) {
 }
 
 void Top100QtAddDialog::rescalePoster() {
-    if (origPoster_.isNull()) return;
-    int maxW = qMax(1, int(width() * kPosterMaxWidthRatio));
-    int maxH = qMax(1, int(height() * kPosterMaxHeightRatio));
-    QPixmap scaled = origPoster_.scaled(maxW, maxH, Qt::KeepAspectRatio, Qt::SmoothTransformation);
-    posterLbl_->setPixmap(scaled);
+    const QSize box = posterBox(this);
+    if (!origPoster_.isNull())
+        posterLbl_->setPixmap(origPoster_.scaled(box, Qt::KeepAspectRatio, Qt::SmoothTransformation));
+    // A dialog grown past the box the thumbnail was made for gets a larger one
+    if (!posterUrl_.isEmpty() && (box.width() > posterAsk_.width() || box.height() > posterAsk_.height()))
+        fetchPosterThumbnail();
 }
@@ -15,7 +15,6 @@ class QLabel;
 class QTextBrowser;
 #include "spinner.h"
 class QStandardItemModel;
-class QNetworkAccessManager;
 class QFutureWatcherBase; // forward
 template <typename T> class QFutureWatcher;
 
@@ -60,14 +59,18 @@ private:
     QLabel* posterLbl_ = nullptr;
     SpinnerWidget* posterSpinner_ = nullptr;
     QTextBrowser* plotView_ = nullptr;
-    QNetworkAccessManager* nam_ = nullptr;
-    QPixmap origPoster_;
+    QPixmap origPoster_;    // thumbnail covering posterAsk_
+    QString posterImdb_;
+    QString posterUrl_;     // poster shown; empty when there is none
+    QSize posterAsk_;       // box the thumbnail was asked for
     QString selectedImdb_;
+    bool selectFirst_ = false;   // an explicit search picks its first hit; typing never does
     QFutureWatcher<QVariantList>* searchWatcher_ = nullptr; // async search watcher
     // spinner controlled directly via posterSpinner_
 
     void doSearch();
     void onResultSelectionChanged();
-    void loadPoster(const QString& url);
+    void loadPoster(const QString& imdb, const QString& url);
+    void fetchPosterThumbnail();
     void rescalePoster();
 };
@@ -5,11 +5,14 @@
 //-------------------------------------------------------------------------------
 #include "app.h"
 #include "window.h"
+#include "shared_services.h"
 
 #include <QApplication>
 
 int run_top100_qt_app(int argc, char* argv[]) {
     QApplication app(argc, argv);
+    // OMDb cache, poster cache and title index, shared with the other front ends using this database
+    for (const std::string& error : initSharedServices()) qWarning("%s", error.c_str());
     Top100QtWindow win;
     win.show();
     return app.exec();
@@ -13,9 +13,6 @@
 #include <QLabel>
 #include <QTextBrowser>
 #include <QStatusBar>
-#include <QNetworkAccessManager>
-#include <QNetworkReply>
-#include <QNetworkRequest>
 #include <QUrl>
 
 #include "../common/Top100ListModel.h"
@@ -74,10 +71,12 @@ void Top100QtWindow::updateDetails() {
     // Clear poster and property; schedule fetch
     posterLabel_->setPixmap(QPixmap());
     posterLabel_->setProperty("origPm", QVariant());
+    posterLabel_->setProperty("posterUrl", QVariant());
+    posterKey_.clear();
     const QString url = m.value("posterUrl").toString();
     if (!url.isEmpty() && url != "N/A") {
     if (posterSpinner_) posterSpinner_->start();
-        fetchPosterByUrl(url);
+        fetchPoster(imdb, url);
     } else if (!imdb.isEmpty()) {
     if (posterSpinner_) posterSpinner_->start();
         fetchPosterViaOmdb(imdb);
@@ -28,6 +28,7 @@
 #include <QListView>
 #include <QComboBox>
 #include <QPixmap>
+#include <QImage>
 #include <QToolBar>
 #include <QToolButton>
 #include <QStatusBar>
@@ -40,12 +41,9 @@
 #include <QScreen>
 #include <QEvent>
 #include <QVariant>
-#include <QNetworkAccessManager>
-#include <QNetworkReply>
-#include <QNetworkRequest>
 #include <QUrl>
 #include <QSslSocket>
-#include <QtConcurrent>
+#include <QPointer>
 #include <QInputDialog>
 #include <QLineEdit>
 #include "../common/strings.h"
@@ -57,12 +55,52 @@
 #include "../../lib/Movie.h"
 #include "../common/Top100ListModel.h"
 #include "../../lib/omdb.h"
+#include "../../lib/poster_cache.h"
 
 // Small adaptor: fetch titles from the top100 library and convert to QStringList.
 // No longer needed: model handles loading
 
 namespace {
-// Helper to keep poster scaled on window resize without stretching
+QSize posterBox(const QWidget* container) {
+    return QSize(qMax(1, int(container->width() * ui_constants::kPosterMaxWidthRatio)),
+                 qMax(1, int(container->height() * ui_constants::kPosterMaxHeightRatio)));
+}
+
+// Fetch a thumbnail covering the container's poster box for the poster named by
+// the label's posterImdb/posterUrl properties and show it scaled to the box
+void fetchPosterThumbnail(QLabel* label, QWidget* container) {
+    const QString imdb = label->property("posterImdb").toString();
+    const QString posterUrl = label->property("posterUrl").toString();
+    if (posterUrl.isEmpty()) return;
+    const QSize box = posterBox(container);
+    label->setProperty("posterBox", box);
+    QPointer<QLabel> guard(label);
+    using BitmapPtr = std::shared_ptr<const PosterBitmap>;
+    posterCache()->thumbnailAsync(imdb.toStdString(), posterUrl.toStdString(), box.width(), box.height())
+        .onComplete([guard, container, imdb, posterUrl, box](const Future<BitmapPtr>& f) {
+            BitmapPtr bm;
+            try { bm = f.get(); } catch (...) {}
+            QMetaObject::invokeMethod(QCoreApplication::instance(), [guard, container, imdb, posterUrl, box, bm]() {
+                if (!guard) return;
+                // Selection moved on, or a larger thumbnail was asked for meanwhile
+                if (guard->property("posterUrl").toString() != posterUrl ||
+                    guard->property("posterImdb").toString() != imdb ||
+                    guard->property("posterBox").toSize() != box) return;
+                if (!bm) {
+                    qWarning() << "Poster download failed:" << posterUrl;
+                    return;
+                }
+                QPixmap pm = QPixmap::fromImage(QImage(reinterpret_cast<const uchar*>(bm->pixels.data()), bm->width,
+                                                       bm->height, bm->width * 4, QImage::Format_ARGB32_Premultiplied));
+                // Store the thumbnail for future resizes and scale to current container
+                guard->setProperty("origPm", pm);
+                guard->setPixmap(pm.scaled(posterBox(container), Qt::KeepAspectRatio, Qt::SmoothTransformation));
+            }, Qt::QueuedConnection);
+        });
+}
+
+// Helper to keep poster scaled on window resize without stretching; only the
+// thumbnail is scaled, and a larger one is fetched once the pane outgrows it
 class PosterResizer : public QObject {
 public:
     PosterResizer(QWidget* container, QLabel* label)
@@ -70,16 +108,15 @@ public:
 protected:
     bool eventFilter(QObject* obj, QEvent* ev) override {
         if (obj == container_ && ev->type() == QEvent::Resize) {
+            const QSize box = posterBox(container_);
             QVariant v = label_->property("origPm");
             if (v.isValid()) {
                 QPixmap pm = v.value<QPixmap>();
-                if (!pm.isNull()) {
-                    int maxW = qMax(1, int(container_->width() * ui_constants::kPosterMaxWidthRatio));
-                    int maxH = qMax(1, int(container_->height() * ui_constants::kPosterMaxHeightRatio));
-                    QPixmap scaled = pm.scaled(maxW, maxH, Qt::KeepAspectRatio, Qt::SmoothTransformation);
-                    label_->setPixmap(scaled);
-                }
+                if (!pm.isNull()) label_->setPixmap(pm.scaled(box, Qt::KeepAspectRatio, Qt::SmoothTransformation));
             }
+            const QSize asked = label_->property("posterBox").toSize();
+            if (box.width() > asked.width() || box.height() > asked.height())
+                fetchPosterThumbnail(label_, container_);
         }
         return QObject::eventFilter(obj, ev);
     }
@@ -295,12 +332,9 @@ int main(int argc, char *argv[]) {
     central->setLayout(vbox);
     win.setCentralWidget(central);
 
-    // Network for poster loading
-    auto *nam = new QNetworkAccessManager(&win);
-
     // detailsSizer will be set up later; capture by pointer via outer variable
     static DetailsResizer* gDetailsSizer = nullptr;
-    auto updateDetails = [listView, model, titleLabel, posterLabel, plotView, nam, details, directorValue, actorsValue, genresValue, runtimeValue, imdbLink, posterContainer]() {
+    auto updateDetails = [listView, model, titleLabel, posterLabel, plotView, details, directorValue, actorsValue, genresValue, runtimeValue, imdbLink, posterContainer]() {
         QModelIndex idx = listView->currentIndex();
         if (!idx.isValid()) {
             titleLabel->clear();
@@ -348,31 +382,12 @@ int main(int argc, char *argv[]) {
         posterLabel->setPixmap(QPixmap());
         posterLabel->setProperty("origPm", QVariant());
         const QString url = m.value("posterUrl").toString();
-        auto fetchAndShow = [nam, posterLabel, details, posterContainer](const QString& posterUrl) {
+        posterLabel->setProperty("posterUrl", QVariant());
+        auto fetchAndShow = [posterLabel, posterContainer, imdb](const QString& posterUrl) {
             if (posterUrl.isEmpty() || posterUrl == "N/A") return;
-            QNetworkRequest req{QUrl(posterUrl)};
-            req.setHeader(QNetworkRequest::UserAgentHeader, QStringLiteral("Top100/1.0 (Qt)"));
-            req.setRawHeader("Accept", "image/*, */*;q=0.8");
-            QNetworkReply *reply = nam->get(req);
-            QObject::connect(reply, &QNetworkReply::finished, posterLabel, [reply, posterLabel, details, posterContainer]() {
-                reply->deleteLater();
-                if (reply->error() == QNetworkReply::NoError) {
-                    QByteArray data = reply->readAll();
-                    QPixmap pm;
-                    if (pm.loadFromData(data)) {
-                        // Store original for future resizes and scale to current container
-                        posterLabel->setProperty("origPm", pm);
-                        int maxW = posterContainer->width() > 0 ? int(posterContainer->width() * ui_constants::kPosterMaxWidthRatio) : 400;
-                        int maxH = posterContainer->height() > 0 ? int(posterContainer->height() * ui_constants::kPosterMaxHeightRatio) : 600;
-                        QPixmap scaled = pm.scaled(maxW, maxH, Qt::KeepAspectRatio, Qt::SmoothTransformation);
-                        posterLabel->setPixmap(scaled);
-                    } else {
-                        qWarning() << "Poster image decode failed (bytes):" << data.size() << "from" << reply->url();
-                    }
-                } else {
-                    qWarning() << "Poster download error:" << reply->errorString() << "code" << reply->error() << "url" << reply->url();
-                }
-            });
+            posterLabel->setProperty("posterImdb", imdb);
+            posterLabel->setProperty("posterUrl", posterUrl);
+            fetchPosterThumbnail(posterLabel, posterContainer);
         };
 
         if (!url.isEmpty() && url != "N/A") {
@@ -381,24 +396,20 @@ int main(int argc, char *argv[]) {
             // Fallback: try to fetch poster URL via OMDb using imdbID
             const QString imdb = m.value("imdbID").toString();
             if (!imdb.isEmpty()) {
-                auto *watcher = new QFutureWatcher<QString>(posterLabel);
-                QObject::connect(watcher, &QFutureWatcher<QString>::finished, posterLabel, [watcher, fetchAndShow]() mutable {
-                    QString poster = watcher->result();
-                    watcher->deleteLater();
-                    fetchAndShow(poster);
-                });
-                QFuture<QString> fut = QtConcurrent::run([imdb]() -> QString {
-                    try {
-                        AppConfig cfg = loadConfig();
-                        if (!cfg.omdbEnabled || cfg.omdbApiKey.empty()) return QString();
-                        auto maybe = omdbGetById(cfg.omdbApiKey, imdb.toStdString());
-                        if (!maybe) return QString();
-                        return QString::fromStdString(maybe->posterUrl);
-                    } catch (...) {
-                        return QString();
-                    }
-                });
-                watcher->setFuture(fut);
+                AppConfig cfg;
+                try { cfg = loadConfig(); } catch (...) { return; }
+                if (!cfg.omdbEnabled || cfg.omdbApiKey.empty()) return;
+                QPointer<QLabel> guard(posterLabel);
+                omdbGetByIdAsync(cfg.omdbApiKey, imdb.toStdString())
+                    .onComplete([guard, fetchAndShow](const Future<std::optional<Movie>>& f) {
+                        QString poster;
+                        try {
+                            if (auto movie = f.get()) poster = QString::fromStdString(movie->posterUrl);
+                        } catch (...) {}
+                        QMetaObject::invokeMethod(QCoreApplication::instance(), [guard, fetchAndShow, poster]() mutable {
+                            if (guard) fetchAndShow(poster);
+                        }, Qt::QueuedConnection);
+                    });
             }
         }
     };
@@ -34,6 +34,7 @@ void Top100QtWindow::buildMenuBar() {
 	sortTopMenu->addAction(QString::fromUtf8(kSortAlpha), this, [this]() { sortCombo_->setCurrentIndex(2); onSortChanged(); });
 	sortTopMenu->addAction(QString::fromUtf8(kSortByRank), this, [this]() { sortCombo_->setCurrentIndex(3); onSortChanged(); });
 	sortTopMenu->addAction(QString::fromUtf8(kSortByScore), this, [this]() { sortCombo_->setCurrentIndex(4); onSortChanged(); });
+	sortTopMenu->addAction(QString::fromUtf8(kSortComposite), this, [this]() { sortCombo_->setCurrentIndex(5); onSortChanged(); });
 
 	// Help
 	QMenu *helpMenu = mb->addMenu(QString::fromUtf8(kMenuHelp));
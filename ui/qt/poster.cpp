@@ -6,11 +6,10 @@
 #include "poster.h"
 
 #include <QLabel>
-#include <QNetworkAccessManager>
-#include <QNetworkReply>
-#include <QNetworkRequest>
-#include <QUrl>
-#include <QtConcurrent>
+#include <QImage>
+#include <QCoreApplication>
+#include <QMetaObject>
+#include <QPointer>
 
 #include "../../lib/config.h"
 #include "../../lib/omdb.h"
@@ -18,26 +17,70 @@
 
 using namespace ui_constants;
 
-void Top100QtWindow::fetchPosterByUrl(const QString& posterUrl) {
-    if (!nam_) nam_ = new QNetworkAccessManager(this);
-    if (posterSpinner_) posterSpinner_->start();
-    QNetworkRequest req{QUrl(posterUrl)};
-    req.setHeader(QNetworkRequest::UserAgentHeader, QStringLiteral("Top100/1.0 (Qt)"));
-    req.setRawHeader("Accept", "image/*, */*;q=0.8");
-    QNetworkReply *reply = nam_->get(req);
-    connect(reply, &QNetworkReply::finished, this, [this, reply]() {
-        reply->deleteLater();
-        if (reply->error() == QNetworkReply::NoError) {
-            QByteArray data = reply->readAll();
-            QPixmap pm;
-            if (pm.loadFromData(data)) {
-                posterLabel_->setProperty("origPm", pm);
-                int maxW = posterContainer_->width() > 0 ? int(posterContainer_->width() * kPosterMaxWidthRatio) : 400;
-                int maxH = posterContainer_->height() > 0 ? int(posterContainer_->height() * kPosterMaxHeightRatio) : 600;
-                QPixmap scaled = pm.scaled(maxW, maxH, Qt::KeepAspectRatio, Qt::SmoothTransformation);
-                posterLabel_->setPixmap(scaled);
-            }
-        } else {
+QSize posterBox(const QWidget* container) {
+    return QSize(qMax(1, int(container->width() * kPosterMaxWidthRatio)),
+                 qMax(1, int(container->height() * kPosterMaxHeightRatio)));
+}
+
+QPixmap bitmapPixmap(const PosterBitmap& bitmap) {
+    // Same layout as the cache's bitmap; QImage only borrows the pixels, fromImage copies them
+    QImage img(reinterpret_cast<const uchar*>(bitmap.pixels.data()), bitmap.width, bitmap.height, bitmap.width * 4,
+               QImage::Format_ARGB32_Premultiplied);
+    return QPixmap::fromImage(img);
+}
+
+QPixmap posterPixmap(const PosterPtr& poster) {
+    if (!poster) return QPixmap();
+    if (const auto& bm = poster->bitmap) return bitmapPixmap(*bm);
+    QPixmap pm;
+    pm.loadFromData(reinterpret_cast<const uchar*>(poster->bytes.data()), uint(poster->bytes.size()));
+    return pm;
+}
+
+void loadPoster(QObject* context, const QString& imdb, const QString& url,
+                std::function<void(const QPixmap&)> done) {
+    auto cache = posterCache();
+    const std::string id = imdb.toStdString(), u = url.toStdString();
+    if (PosterPtr hit = cache->peek(id, u)) { done(posterPixmap(hit)); return; }
+    cache->getAsync(id, u).onComplete([context, done](const Future<PosterPtr>& f) {
+        PosterPtr poster;
+        try { poster = f.get(); } catch (...) {}
+        // Back to the GUI thread; not delivered if context is gone by then
+        QMetaObject::invokeMethod(context, [done, poster]() { done(posterPixmap(poster)); }, Qt::QueuedConnection);
+    });
+}
+
+void loadPosterThumbnail(QObject* context, const QString& imdb, const QString& url, const QSize& box,
+                         std::function<void(const QPixmap&)> done) {
+    using BitmapPtr = std::shared_ptr<const PosterBitmap>;
+    posterCache()->thumbnailAsync(imdb.toStdString(), url.toStdString(), box.width(), box.height())
+        .onComplete([context, done](const Future<BitmapPtr>& f) {
+            BitmapPtr bitmap;
+            try { bitmap = f.get(); } catch (...) {}
+            // Back to the GUI thread; not delivered if context is gone by then
+            QMetaObject::invokeMethod(context, [done, bitmap]() {
+                done(bitmap ? bitmapPixmap(*bitmap) : QPixmap());
+            }, Qt::QueuedConnection);
+        });
+}
+
+void Top100QtWindow::fetchPoster(const QString& imdb, const QString& posterUrl) {
+    // A larger thumbnail for the same poster replaces the shown one without the spinner
+    const bool showing = posterLabel_->property("origPm").isValid();
+    if (!showing && posterSpinner_) posterSpinner_->start();
+    const QSize box = posterBox(posterContainer_);
+    posterKey_ = imdb + QLatin1Char('|') + posterUrl;
+    const QString key = posterKey_;
+    posterLabel_->setProperty("posterImdb", imdb);
+    posterLabel_->setProperty("posterUrl", posterUrl);
+    posterLabel_->setProperty("posterBox", box);
+    loadPosterThumbnail(this, imdb, posterUrl, box, [this, key, box](const QPixmap& pm) {
+        // Selection moved on, or a larger thumbnail was asked for meanwhile
+        if (key != posterKey_ || posterLabel_->property("posterBox").toSize() != box) return;
+        if (!pm.isNull()) {
+            posterLabel_->setProperty("origPm", pm);
+            posterLabel_->setPixmap(pm.scaled(posterBox(posterContainer_), Qt::KeepAspectRatio, Qt::SmoothTransformation));
+        } else if (!posterLabel_->property("origPm").isValid()) {
             posterLabel_->clear();
         }
         if (posterSpinner_) posterSpinner_->stop();
@@ -45,21 +88,22 @@ void Top100QtWindow::fetchPosterByUrl(const QString& posterUrl) {
 }
 
 void Top100QtWindow::fetchPosterViaOmdb(const QString& imdb) {
-    auto *watcher = new QFutureWatcher<QString>(this);
-    connect(watcher, &QFutureWatcher<QString>::finished, this, [this, watcher]() mutable {
-        QString poster = watcher->result();
-        watcher->deleteLater();
-        if (!poster.isEmpty()) fetchPosterByUrl(poster);
-        else { if (posterSpinner_) posterSpinner_->stop(); }
-    });
-    QFuture<QString> fut = QtConcurrent::run([imdb]() -> QString {
-        try {
-            AppConfig cfg = loadConfig();
-            if (!cfg.omdbEnabled || cfg.omdbApiKey.empty()) return QString();
-            auto maybe = omdbGetById(cfg.omdbApiKey, imdb.toStdString());
-            if (!maybe) return QString();
-            return QString::fromStdString(maybe->posterUrl);
-        } catch (...) { return QString(); }
-    });
-    watcher->setFuture(fut);
+    AppConfig cfg;
+    try { cfg = loadConfig(); } catch (...) { if (posterSpinner_) posterSpinner_->stop(); return; }
+    if (!cfg.omdbEnabled || cfg.omdbApiKey.empty()) { if (posterSpinner_) posterSpinner_->stop(); return; }
+    posterKey_ = imdb + QLatin1Char('|');
+    QPointer<Top100QtWindow> self(this);
+    omdbGetByIdAsync(cfg.omdbApiKey, imdb.toStdString(), OmdbDetailOptions{cfg.omdbFetchShortPlot})
+        .onComplete([self, imdb](const Future<std::optional<Movie>>& f) {
+            QString poster;
+            try {
+                if (auto movie = f.get()) poster = QString::fromStdString(movie->posterUrl);
+            } catch (...) {}
+            // Back to the GUI thread; the window may have closed meanwhile
+            QMetaObject::invokeMethod(QCoreApplication::instance(), [self, imdb, poster]() {
+                if (!self || self->posterKey_ != imdb + QLatin1Char('|')) return;
+                if (!poster.isEmpty()) self->fetchPoster(imdb, poster);
+                else if (self->posterSpinner_) self->posterSpinner_->stop();
+            }, Qt::QueuedConnection);
+        });
 }
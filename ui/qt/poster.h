@@ -5,3 +5,34 @@
 //-------------------------------------------------------------------------------
 #pragma once
 #include "window.h"
+
+#include <QPixmap>
+#include <QSize>
+#include <QString>
+#include <functional>
+
+#include "../../lib/poster_cache.h"
+
+class QObject;
+class QWidget;
+
+// Box a poster is fitted to inside container (kPosterMax*Ratio of its size, at least 1x1)
+QSize posterBox(const QWidget* container);
+
+// Pixmap of decoded poster pixels (a copy)
+QPixmap bitmapPixmap(const PosterBitmap& bitmap);
+
+// Pixmap of a cached poster: wraps its decoded pixels, else decodes its bytes
+QPixmap posterPixmap(const PosterPtr& poster);
+
+// Load a poster through the shared cache and hand it to done on the GUI thread
+// (a null pixmap if there is none). Memory hits call done immediately; nothing
+// is called once context has been destroyed.
+void loadPoster(QObject* context, const QString& imdb, const QString& url,
+                std::function<void(const QPixmap&)> done);
+
+// Load the smallest stored thumbnail covering box (the poster itself when none
+// does, see PosterCache::thumbnailAsync) and hand it to done on the GUI thread,
+// so the caller only scales a small pixmap the last step to the box.
+void loadPosterThumbnail(QObject* context, const QString& imdb, const QString& url, const QSize& box,
+                         std::function<void(const QPixmap&)> done);
@@ -14,11 +14,9 @@
 #include <QKeyEvent>
 #include <QPixmap>
 #include <QFont>
-#include <QRandomGenerator>
-#include <QNetworkAccessManager>
-#include <QNetworkReply>
 #include <QCursor>
 
+#include "poster.h"
 #include "../common/Top100ListModel.h"
 #include "../common/constants.h"
 
@@ -30,6 +28,7 @@ static QString joinList(const QVariantList& v, const QString& sep) {
     return out.join(sep);
 }
 
+// Box a pane shows its poster in
 Top100QtRankDialog::Top100QtRankDialog(QWidget* parent, Top100ListModel* model)
     : QDialog(parent), model_(model)
 {
@@ -120,10 +119,17 @@ Top100QtRankDialog::Top100QtRankDialog(QWidget* parent, Top100ListModel* model)
 void Top100QtRankDialog::pickTwo() {
     int n = model_ ? model_->rowCount() : 0;
     if (n < 2) { leftRow_ = rightRow_ = -1; return; }
-    int a = static_cast<int>(QRandomGenerator::global()->bounded(n));
-    int b = static_cast<int>(QRandomGenerator::global()->bounded(n));
-    if (b == a) b = (a + 1) % n;
-    leftRow_ = a; rightRow_ = b;
+    // The model skips pairs whose outcome is implied by earlier answers
+    const QVariantList pair = model_->nextRankPair();
+    if (pair.size() != 2) {
+        leftRow_ = rightRow_ = -1;
+        prompt_->setText(tr("Every pair is already ordered by your previous answers."));
+        leftPane_->setEnabled(false);
+        rightPane_->setEnabled(false);
+        passBtn_->setEnabled(false);
+        return;
+    }
+    leftRow_ = pair.at(0).toInt(); rightRow_ = pair.at(1).toInt();
     refreshSide(true);
     refreshSide(false);
 }
@@ -150,9 +156,11 @@ void Top100QtRankDialog::refreshSide(bool left) {
     t->setText(head);
     d->setText(det);
     p->clear();
+    p->setProperty("origPm", QVariant());
+    p->setProperty("posterUrl", QVariant());
     const QString posterUrl = m.value("posterUrl").toString();
     if (!posterUrl.isEmpty()) {
-        fetchPoster(p, left ? leftPane_ : rightPane_, posterUrl);
+        fetchPoster(p, left ? leftPane_ : rightPane_, m.value("imdbID").toString(), posterUrl);
     }
 }
 
@@ -191,32 +199,36 @@ bool Top100QtRankDialog::eventFilter(QObject* obj, QEvent* ev) {
         QWidget* container = qobject_cast<QWidget*>(obj);
         if (container == leftPane_ || container == rightPane_) {
             QLabel* target = (container == leftPane_) ? leftPoster_ : rightPoster_;
+            const QSize box = posterBox(container);
             QVariant v = target->property("origPm");
             if (v.isValid()) {
-                QPixmap pm = v.value<QPixmap>();
-                int maxW = qMax(1, int(container->width() * kPosterMaxWidthRatio));
-                int maxH = qMax(1, int(container->height() * kPosterMaxHeightRatio));
-                target->setPixmap(pm.scaled(maxW, maxH, Qt::KeepAspectRatio, Qt::SmoothTransformation));
+                // The thumbnail covers the box it was asked for; only the last step is scaled here
+                target->setPixmap(v.value<QPixmap>().scaled(box, Qt::KeepAspectRatio, Qt::SmoothTransformation));
+            }
+            const QSize asked = target->property("posterBox").toSize();
+            const QString url = target->property("posterUrl").toString();
+            if (!url.isEmpty() && (box.width() > asked.width() || box.height() > asked.height())) {
+                // Grown past it (e.g. the first layout): fetch a larger thumbnail
+                fetchPoster(target, container, target->property("posterImdb").toString(), url);
             }
         }
     }
     return QDialog::eventFilter(obj, ev);
 }
 
-void Top100QtRankDialog::fetchPoster(QLabel* target, QWidget* container, const QString& url) {
-    if (!nam_) nam_ = new QNetworkAccessManager(this);
-    QNetworkRequest req{QUrl(url)};
-    QNetworkReply* reply = nam_->get(req);
-    connect(reply, &QNetworkReply::finished, this, [this, reply, target, container]() {
-        reply->deleteLater();
-        if (reply->error() != QNetworkReply::NoError) return;
-        const QByteArray data = reply->readAll();
-        QPixmap pm; if (!pm.loadFromData(data)) return;
+void Top100QtRankDialog::fetchPoster(QLabel* target, QWidget* container, const QString& imdb, const QString& url) {
+    // Tag the label so a poster for a pair already passed over, or for a smaller box, is dropped
+    const QSize box = posterBox(container);
+    const QString key = imdb + QLatin1Char('|') + url + QLatin1Char('|') + QString::number(box.width()) +
+                        QLatin1Char('x') + QString::number(box.height());
+    target->setProperty("posterKey", key);
+    target->setProperty("posterImdb", imdb);
+    target->setProperty("posterUrl", url);
+    target->setProperty("posterBox", box);
+    loadPosterThumbnail(this, imdb, url, box, [target, container, key](const QPixmap& pm) {
+        if (pm.isNull() || target->property("posterKey").toString() != key) return;
         target->setProperty("origPm", pm);
-        int maxW = qMax(1, int(container->width() * kPosterMaxWidthRatio));
-        int maxH = qMax(1, int(container->height() * kPosterMaxHeightRatio));
-        QPixmap scaled = pm.scaled(maxW, maxH, Qt::KeepAspectRatio, Qt::SmoothTransformation);
-        target->setPixmap(scaled);
+        target->setPixmap(pm.scaled(posterBox(container), Qt::KeepAspectRatio, Qt::SmoothTransformation));
     });
     // Resizing handled in eventFilter for left/right panes
 }
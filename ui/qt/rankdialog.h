@@ -7,7 +7,6 @@
 
 #include <QDialog>
 #include <QVariantMap>
-class QNetworkAccessManager;
 
 class QLabel;
 class QPushButton;
@@ -58,7 +57,6 @@ private:
     QWidget* rightPane_ { nullptr };
     QPushButton* passBtn_ { nullptr };
     QPushButton* finishBtn_ { nullptr };
-    QNetworkAccessManager* nam_ { nullptr }; // for poster fetching
 
     void pickTwo();
     void refreshSide(bool left);
@@ -66,5 +64,5 @@ private:
     void chooseRight();
     void passPair();
 
-    void fetchPoster(QLabel* target, QWidget* container, const QString& url);
+    void fetchPoster(QLabel* target, QWidget* container, const QString& imdb, const QString& url);
 };
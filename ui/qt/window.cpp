@@ -28,12 +28,12 @@
 #include <QScreen>
 #include <QEvent>
 #include <QVariant>
-#include <QNetworkAccessManager>
-#include <QNetworkReply>
-#include <QNetworkRequest>
 #include <QUrl>
 #include <QSslSocket>
 
+#include <functional>
+
+#include "poster.h"
 #include "../common/strings.h"
 #include "../common/constants.h"
 #include "../common/Top100ListModel.h"
@@ -43,29 +43,33 @@ using namespace ui_strings;
 
 // Helpers from original file
 namespace {
+// Keeps the poster fitted to its pane. The label holds a thumbnail covering the
+// box it was asked for, so a resize only scales that small pixmap; growing past
+// the box asks refetch for a larger one.
 class PosterResizer : public QObject {
 public:
-    PosterResizer(QWidget* container, QLabel* label)
-        : QObject(container), container_(container), label_(label) {}
+    PosterResizer(QWidget* container, QLabel* label, std::function<void()> refetch)
+        : QObject(container), container_(container), label_(label), refetch_(std::move(refetch)) {}
 protected:
     bool eventFilter(QObject* obj, QEvent* ev) override {
         if (obj == container_ && ev->type() == QEvent::Resize) {
+            const QSize box = posterBox(container_);
             QVariant v = label_->property("origPm");
             if (v.isValid()) {
                 QPixmap pm = v.value<QPixmap>();
-                if (!pm.isNull()) {
-                    int maxW = qMax(1, int(container_->width() * kPosterMaxWidthRatio));
-                    int maxH = qMax(1, int(container_->height() * kPosterMaxHeightRatio));
-                    QPixmap scaled = pm.scaled(maxW, maxH, Qt::KeepAspectRatio, Qt::SmoothTransformation);
-                    label_->setPixmap(scaled);
-                }
+                if (!pm.isNull()) label_->setPixmap(pm.scaled(box, Qt::KeepAspectRatio, Qt::SmoothTransformation));
             }
+            const QSize asked = label_->property("posterBox").toSize();
+            if (!label_->property("posterUrl").toString().isEmpty() &&
+                (box.width() > asked.width() || box.height() > asked.height()))
+                refetch_();
         }
         return QObject::eventFilter(obj, ev);
     }
 private:
     QWidget* container_;
     QLabel* label_;
+    std::function<void()> refetch_;
 };
 class DetailsResizer : public QObject {
     QWidget* container_;
@@ -140,6 +144,7 @@ void Top100QtWindow::buildLayout() {
     sortCombo_->addItem(QString::fromUtf8(kSortAlpha), 2);
     sortCombo_->addItem(QString::fromUtf8(kSortByRank), 3);
     sortCombo_->addItem(QString::fromUtf8(kSortByScore), 4);
+    sortCombo_->addItem(QString::fromUtf8(kSortComposite), 5);
     sortRowLayout->addWidget(sortCombo_, 1);
     leftLayout->addWidget(sortRow);
     listView_ = new QListView(leftFrame);
@@ -282,9 +287,10 @@ void Top100QtWindow::connectSignals() {
         updateDetails();
     }
 
-    // Network for poster loading and resizers
-    nam_ = new QNetworkAccessManager(this);
-    posterResizer_ = static_cast<QObject*>(new PosterResizer(posterContainer_, posterLabel_));
+    // Poster resizers
+    posterResizer_ = static_cast<QObject*>(new PosterResizer(posterContainer_, posterLabel_, [this]() {
+        fetchPoster(posterLabel_->property("posterImdb").toString(), posterLabel_->property("posterUrl").toString());
+    }));
     posterContainer_->installEventFilter(posterResizer_);
     detailsResizer_ = static_cast<QObject*>(new DetailsResizer(detailsContainer_, actorsValue_));
     detailsContainer_->installEventFilter(detailsResizer_);
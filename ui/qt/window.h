@@ -15,7 +15,6 @@ class QComboBox;
 class QLabel;
 class QTextBrowser;
 #include "spinner.h"
-class QNetworkAccessManager;
 class QToolBar;
 class QAction;
 class QWidget;
@@ -66,7 +65,7 @@ private:
     QAction* updateAct_ = nullptr;
 
     // Helpers
-    QNetworkAccessManager* nam_ = nullptr;
+    QString posterKey_; // poster currently wanted (imdb|url)
     QObject* posterResizer_ = nullptr;
     QObject* detailsResizer_ = nullptr;
     // spinner controlled directly via posterSpinner_
@@ -92,6 +91,6 @@ private:
     void updateDetails();
 
     // Poster (implemented in poster.cpp)
-    void fetchPosterByUrl(const QString& url);
+    void fetchPoster(const QString& imdb, const QString& url);
     void fetchPosterViaOmdb(const QString& imdb);
 };